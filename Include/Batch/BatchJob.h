@@ -0,0 +1,156 @@
+#ifndef BATCH_JOB_H_
+#define BATCH_JOB_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+
+#include <common/ProblemDefinition.h>
+#include <common/GridPreferences.h>
+#include <common/MeshSettings.h>
+#include <common/OmniFEMMessage.h>
+#include <common/OS.h>
+#include <common/ProjectFile.h>
+
+#include <UI/GeometryEditor2D.h>
+
+#include <Mesh/meshMaker.h>
+#include <Mesh/MeshCache.h>
+#include <Mesh/GMSH/GModel.h>
+
+#include <Solver/SolverMesh.h>
+#include <Solver/ElectrostaticSolver.h>
+#include <Solver/MagnetostaticSolver.h>
+#include <Solver/HarmonicMagneticSolver.h>
+#include <Solver/TransientMagneticSolver.h>
+#include <Solver/AdaptiveRefinement.h>
+#include <Solver/VTUWriter.h>
+#include <Solver/PVDWriter.h>
+
+
+/**
+ * @class batchJob
+ * @author Phillip
+ * @date 17/10/26
+ * @file BatchJob.h
+ * @brief 	Meshes and solves one .omniFEM file without the user interface. The file is read with the same project reader as
+ * 			the main frame uses to load a file. The geometry is kept in a geometry editor and meshed into a GMSH model that belongs
+ * 			to the job, so nothing here needs a canvas. The mesh is written to the output folder as a .msh file together with
+ * 			any of the mesh formats that are selected in the mesh settings of the file. If the problem is solved, the solution
+ * 			at the nodes is written to a .csv file, and the solution at the nodes and the elements is written to a .vtu file for
+ * 			ParaView. A frequency sweep is written as one .vtu file for each frequency, and the files are listed in a .pvd collection.
+ * 			A transient problem writes every accepted time step as a .vtu file listed in a .pvd collection, the final state as a .csv
+ * 			and a .vtu file, and the hysteresis and the eddy current energies at each step into a _energy.csv file.
+ */
+class batchJob
+{
+private:
+	//! The path to the .omniFEM file
+	std::string p_filePath;
+
+	//! The folder that the outputs are written into
+	std::string p_outputFolder;
+
+	//! The name of the outputs. This is unique within the batch
+	std::string p_name;
+
+	//! The problem that was loaded from the file
+	problemDefinition p_definition;
+
+	//! The geometry that was loaded from the file
+	geometryEditor2D p_editor;
+
+	//! The GMSH model that the geometry is meshed in
+	GModel *p_meshModel = nullptr;
+
+	//! The solver of the electrostatic problem. Null if the problem is not electrostatic or was not solved
+	electrostaticSolver *p_electrostaticSolver = nullptr;
+
+	//! The solver of the magnetostatic problem
+	magnetostaticSolver *p_magnetostaticSolver = nullptr;
+
+	//! The solver of the time-harmonic magnetic problem
+	harmonicMagneticSolver *p_harmonicMagneticSolver = nullptr;
+
+	//! The solver of the transient magnetic problem with hysteresis
+	transientMagneticSolver *p_transientMagneticSolver = nullptr;
+
+	/**
+	 * @brief Writes the solution at each node of the solver mesh into a .csv file. The coordinates are in meters
+	 * @return Returns false if the file could not be written
+	 */
+	bool writeSolution();
+
+	/**
+	 * @brief Writes the potential at the nodes and the fields of the elements into a .vtu file. The arrays are compressed if zlib is available
+	 * @return Returns false if the file could not be written
+	 */
+	bool writeResults();
+
+	/**
+	 * @brief Writes the time, the hysteresis energy and the eddy current energy of each accepted step of the transient solver into a .csv file
+	 * @return Returns false if the file could not be written
+	 */
+	bool writeEnergies();
+
+public:
+	/**
+	 * @brief Creates the job
+	 * @param filePath The path to the .omniFEM file
+	 * @param outputFolder The folder that the outputs are written into. This folder needs to exist
+	 * @param name The name that the outputs are written under. See getOutputNames
+	 */
+	batchJob(std::string filePath, std::string outputFolder, std::string name);
+
+	~batchJob();
+
+	/**
+	 * @brief Reads the problem definition and the geometry from the file
+	 * @return Returns false if the file could not be opened or read
+	 */
+	bool load();
+
+	/**
+	 * @brief 	Solves a magnetic problem in time with the Jiles-Atherton hysteresis model even if this is not selected in the
+	 * 			preferences of the file. Call this after the file is loaded
+	 */
+	void setTransient();
+
+	/**
+	 * @brief Meshes the geometry with the mesh settings of the file and writes the mesh into the output folder
+	 * @return Returns false if no mesh was created
+	 */
+	bool mesh();
+
+	/**
+	 * @brief 	Solves the problem on the mesh. This picks the solver the same way as the Analyze menu of the main frame
+	 * 			(including the adaptive refinement) and writes the solution into the output folder
+	 * @return Returns false if the solver failed
+	 */
+	bool solve();
+
+	/**
+	 * @brief Finds the name of a file without the folder and the .omniFEM extension
+	 * @param filePath The path to the .omniFEM file
+	 * @return Returns the name of the file
+	 */
+	static std::string getOutputName(std::string filePath);
+
+	/**
+	 * @brief 	Finds the names that the outputs of the files of a batch are written under. All of the outputs go into one folder so
+	 * 			the names need to be unique. A file is named after the file alone if no other file in the batch has the same
+	 * 			name. Otherwise the folders of its path are kept with the separators replaced by '_' (caseA/model.omniFEM
+	 * 			becomes caseA_model). A name that is still not unique (the same file listed twice) gets its position in the list
+	 * @param filePaths The paths to the .omniFEM files
+	 * @return Returns one name for each file in the same order
+	 */
+	static std::vector<std::string> getOutputNames(const std::vector<std::string> &filePaths);
+
+	std::string getName()
+	{
+		return p_name;
+	}
+};
+
+#endif
@@ -123,6 +123,18 @@ public:
 		}
 	}
 	
+	/**
+	 * @brief 	Function that will check if the current bounding box overlaps another bounding box.
+	 * 			Two boxes that only share an edge are considered to overlap.
+	 * @param compare The bounding box to check against
+	 * @return Returns true if the two bounding boxes overlap. Otherwise, returns false
+	 */
+	bool intersects(boundingBox compare)
+	{
+		return (compare.getMaxBounds().x >= p_minBounds.x && compare.getMinBounds().x <= p_maxBounds.x && 
+				compare.getMaxBounds().y >= p_minBounds.y && compare.getMinBounds().y <= p_maxBounds.y);
+	}
+	
 	bool operator==(boundingBox compareBox)
 	{
 		if(p_maxBounds == compareBox.getMaxBounds() && p_minBounds == compareBox.getMinBounds())
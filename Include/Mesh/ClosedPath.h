@@ -13,6 +13,7 @@
 #include <common/GeometryProperties/BlockProperty.h>
 
 #include <Mesh/BoundingBox.h>
+#include <Mesh/CompactPolygon.h>
 
 #include <UI/geometryShapes.h>
 
@@ -37,14 +38,14 @@ private:
 	//! The perimeter of the polygon
 	double p_distance = 0;
 	
+	//! The area that is enclosed by the polygon. This does not subtract the area of any holes
+	double p_area = 0;
+	
 	//! The list of edges that make up the polygon
 	std::vector<edgeLineShape*> p_closedPath;
 	
-	//! Vector of simplified edges representing the polygon. This is used in the winding number algorithm 
-	std::vector<simplifiedEdge> p_simplifiedPath;
-	
-	//! If the polygon has any arcs, then this vector will contain all of the boxes that encase each arc. This is used in the PIP algorithm
-	std::vector<arcPolygon> p_arcPolygons;
+	//! The compact form of the polygon that is used in the winding number algorithm. This is created the first time that it is needed
+	compactPolygon p_polygon;
 	
 	//! This is the center of the polygon computing by taking the average of all of the centers of the edges
 	wxRealPoint p_centerPoint = wxPoint(0, 0);
@@ -63,9 +64,6 @@ private:
 	
 	bool p_holesFound = false;
 	
-	//! Boolean that is used to indicate if the orientation of the polygon is CCW (false) or CW (true). Used in the PIP algorithm
-	bool p_reverseWindingResult = false;
-	
 	/**
 	 * @brief This function is used to determine if any holes share a common edge. In GMSH, holes are not allowed to share a common edge
 	 * 			when meshing. Therefor, an algorithm was created that will combine the two holes removing the commone edge.
@@ -104,11 +102,6 @@ private:
 
 public:
 
-	bool operator () (const simplifiedEdge &sedge)
-	{
-		return sedge.getDeleteState();
-	}
-
 	/**
 	 * @brief Constructor that is called in order to add the first edge to the closedPath
 	 * @param firstEdge Reference to the first edge to add in
@@ -194,6 +187,24 @@ public:
 		p_distance += value;
 	}
 	
+	/**
+	 * @brief Sets the area that is enclosed by the polygon
+	 * @param area The area of the polygon without any of the holes removed
+	 */
+	void setArea(double area)
+	{
+		p_area = area;
+	}
+	
+	/**
+	 * @brief Retrieves the area that is enclosed by the polygon
+	 * @return Returns the area of the polygon. This does not subtract the area of any holes
+	 */
+	double getArea()
+	{
+		return p_area;
+	}
+	
 	/**
 	 * @brief This function is used to retrieve a pointer of the list of edges that form the polygon
 	 * @return Returns a pointer to the list of edges forming the polygon
@@ -224,6 +235,7 @@ public:
 		}
 		
 		p_closedPath.push_back(&addEdge);
+		p_polygon.clear();
 		
 		p_boundingBox.addPoint(wxRealPoint(addEdge.getFirstNode()->getCenterXCoordinate(), addEdge.getFirstNode()->getCenterYCoordinate()));
 		p_boundingBox.addPoint(wxRealPoint(addEdge.getSecondNode()->getCenterXCoordinate(), addEdge.getSecondNode()->getCenterYCoordinate()));
@@ -275,6 +287,7 @@ public:
 		}
 		
 		p_closedPath.push_back(addEdge);
+		p_polygon.clear();
 		
 		p_boundingBox.addPoint(wxRealPoint(addEdge->getFirstNode()->getCenterXCoordinate(), addEdge->getFirstNode()->getCenterYCoordinate()));
 		p_boundingBox.addPoint(wxRealPoint(addEdge->getSecondNode()->getCenterXCoordinate(), addEdge->getSecondNode()->getCenterYCoordinate()));
@@ -495,20 +508,35 @@ public:
 	
 	/**
 	 * @brief 	The purpose of this function to to check if a specfied point lies within the path/closed contour.
-	 * 			The function accomplishes this through the use of a modified version of the winding number method.
-	 * 			In this method, the algorithm calculates the number of times that the point wraps around the 
-	 * 			closed path. The current version of this algorithm does not use arc sin or cos. But instead checks to see
-	 * 			if the point is to the left or right of an edge within the closed path. If teh number of times that the point
-	 * 			is to the left of the edges is greater then the number of rights, then this means that the point lies withing the
-	 * 			closed path. Note that in this algorithm arcs are represented by a box that encases the arc. If the point is found
-	 * 			to exist in this box, then a test will be performed to see which side the point lies on the arc which will determine
-	 * 			if the the arc is inside or outside of the polygon.
+	 * 			The function accomplishes this through the use of the winding number method. The algorithm calculates
+	 * 			the number of times that the closed path wraps around the point. The arcs are handled exactly by adding
+	 * 			the circular segment between the arc and its chord to the winding number. The compact form of the polygon
+	 * 			is created the first time that this function is called.
 	 * @param point The point that will be tested to see if it exists inside of the polygon
-	 * @return Returns true if the point lies within the closed path. Otherwise, returns false. If the point lies on an edge
-	 * 			of the polygon, then this function will return true.
+	 * @return Returns true if the point lies within the closed path. Otherwise, returns false.
 	 */
 	bool pointInContour(wxRealPoint point);
 	
+	/**
+	 * @brief 	Checks if many points lie within the closed path at once. This is faster then calling pointInContour for
+	 * 			each point since the points are tested in groups using the vector instructions of the processor.
+	 * @param points The list of points to test
+	 * @param isInside The list that the results will be written to. An entry is true if the corresponding point is inside
+	 */
+	void pointsInContour(std::vector<wxRealPoint> &points, std::vector<bool> &isInside);
+	
+	/**
+	 * @brief Retrieves the compact form of the polygon. This can be used to test points without the closed path
+	 * @return Returns a pointer to the compact polygon
+	 */
+	compactPolygon *getPolygon()
+	{
+		if(p_polygon.isEmpty())
+			p_polygon.build(p_closedPath);
+		
+		return &p_polygon;
+	}
+	
 	/**
 	 * @brief Function that is called that will determine if this polygon is inside of another polygon
 	 * @param compare The top level polygon. This polygon will be checked to see if it is contained inside of the 
@@ -0,0 +1,115 @@
+#ifndef COMPACT_POLYGON_H_
+#define COMPACT_POLYGON_H_
+
+#include <vector>
+#include <cstddef>
+
+#include <UI/geometryShapes.h>
+
+
+/**
+ * @class compactPolygon
+ * @author Phillip
+ * @date 17/10/26
+ * @file CompactPolygon.h
+ * @brief 	This class stores a closed path in a compact form that is used to test if points are inside of the path. The vertices
+ * 			are stored as separate lists of x and y values in the order that the path is traversed. Every edge is represented by its
+ * 			chord. For arcs, the circle is also stored so that the region between the chord and the arc (the circular segment) can be
+ * 			added to or removed from the winding number. This way, the winding number is exact for both lines and arcs and
+ * 			no boxes around the arcs are needed. Since the data is stored as plain lists, many points can be tested at once using
+ * 			the vector instructions of the processor.
+ */
+class compactPolygon
+{
+private:
+	//! The x values of the vertices. The first vertex is repeated at the end so that edge i goes from vertex i to vertex i + 1
+	std::vector<double> p_vertexX;
+
+	//! The y values of the vertices. The first vertex is repeated at the end
+	std::vector<double> p_vertexY;
+
+	//! The x value of the start point of the chord of each arc
+	std::vector<double> p_arcStartX;
+
+	//! The y value of the start point of the chord of each arc
+	std::vector<double> p_arcStartY;
+
+	//! The x component of the chord of each arc. This is the end point minus the start point
+	std::vector<double> p_arcChordX;
+
+	//! The y component of the chord of each arc
+	std::vector<double> p_arcChordY;
+
+	//! The x value of the center of each arc
+	std::vector<double> p_arcCenterX;
+
+	//! The y value of the center of each arc
+	std::vector<double> p_arcCenterY;
+
+	//! The square of the radius of each arc
+	std::vector<double> p_arcRadiusSquared;
+
+	//! This is 1 if the arc is traversed CCW about its center and -1 if the arc is traversed CW
+	std::vector<double> p_arcDirection;
+
+	/**
+	 * @brief Adds the data for an arc that is traversed between two vertices
+	 * @param arc The arc to add
+	 * @param isForward Boolean used to indicate if the arc is traversed from its first node to its second node
+	 */
+	void addArc(arcShape *arc, bool isForward);
+
+	/**
+	 * @brief Computes the winding number of a single point
+	 * @param x The x value of the point
+	 * @param y The y value of the point
+	 * @return Returns the winding number of the polygon about the point
+	 */
+	int scalarWindingNumber(double x, double y) const;
+
+public:
+
+	/**
+	 * @brief 	Creates the compact form of a closed path. The edges need to be in the order that they are connected
+	 * 			but the edges can be in any direction. The orientation of the path does not matter
+	 * @param edges The list of edges that form the closed path
+	 */
+	void build(std::vector<edgeLineShape*> &edges);
+
+	/**
+	 * @brief Removes all of the data so that the polygon needs to be built again
+	 */
+	void clear();
+
+	/**
+	 * @brief Checks if the polygon has been built
+	 * @return Returns true if the polygon does not contain any vertices
+	 */
+	bool isEmpty() const
+	{
+		return p_vertexX.empty();
+	}
+
+	/**
+	 * @brief Computes the winding number of the polygon about a point
+	 * @param x The x value of the point
+	 * @param y The y value of the point
+	 * @return Returns the winding number. This is non-zero if the point is inside of the polygon
+	 */
+	int windingNumber(double x, double y) const
+	{
+		return scalarWindingNumber(x, y);
+	}
+
+	/**
+	 * @brief 	Computes the winding number of the polygon about many points at once. The points are tested in groups
+	 * 			using AVX or SSE2 instructions if the program was compiled with them
+	 * @param x The list of the x values of the points
+	 * @param y The list of the y values of the points
+	 * @param count The number of points
+	 * @param winding The list that the winding number of each point will be written to. This must have room for count values
+	 */
+	void windingNumbers(const double *x, const double *y, size_t count, int *winding) const;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef CONTAINMENT_TREE_H_
+#define CONTAINMENT_TREE_H_
+
+#include <vector>
+#include <algorithm>
+
+#include <Mesh/ClosedPath.h>
+#include <Mesh/BoundingBox.h>
+
+
+/**
+ * @class containmentTree
+ * @author Phillip
+ * @date 17/10/26
+ * @file ContainmentTree.h
+ * @brief 	This class determines which closed paths are inside of which. The bounding boxes of the closed paths are packed into
+ * 			an R-tree so that only the paths whose bounding box contains the bounding box of a path (or a point) need to be tested
+ * 			with the point in polygon algorithm. Since the faces of the geometry do not overlap, the paths that contain a path are
+ * 			nested inside of each other and the one with the smallest area is the parent of the path. The children of a path are the top
+ * 			level holes of the path. The smallest path that contains a point is the face that the point is in.
+ * 			The tree holds the index of each path in the list that the tree was built from. So, the tree needs to be built again if
+ * 			the list changes.
+ */
+class containmentTree
+{
+private:
+	/**
+	 * @brief One node of the R-tree. A leaf points to entries in p_entries and an interior node points to other tree nodes
+	 */
+	struct treeNode
+	{
+		//! The box that encloses all of the children of the node
+		double minX, minY, maxX, maxY;
+
+		//! The index of the first child of the node
+		size_t firstChild;
+
+		//! The number of children of the node
+		size_t numberOfChildren;
+
+		//! Boolean used to indicate if the children are entries instead of tree nodes
+		bool isLeaf;
+	};
+
+	/**
+	 * @brief The bounding box of one of the closed paths
+	 */
+	struct entry
+	{
+		double minX, minY, maxX, maxY;
+
+		//! The index of the closed path in the list
+		size_t index;
+	};
+
+	//! The maximum number of children in one node of the tree
+	static const size_t p_nodeCapacity = 16;
+
+	//! The bounding boxes of the closed paths. These are in the order of the leaves of the tree
+	std::vector<entry> p_entries;
+
+	//! The nodes of the tree. The root is the last node
+	std::vector<treeNode> p_treeNodes;
+
+	//! The closed paths that the tree was built from
+	std::vector<closedPath> *p_paths = nullptr;
+
+	//! The index of the parent path of each path. This is -1 if the path is not inside of any other path
+	std::vector<long> p_parents;
+
+	//! The indices of the paths that are directly inside of each path
+	std::vector<std::vector<size_t>> p_children;
+
+	//! Temporary list used to collect the results of a query
+	std::vector<size_t> p_candidates;
+
+	/**
+	 * @brief 	Orders the boxes of one level of the tree using the sort tile recursive algorithm. The boxes are sorted into vertical slices
+	 * 			by the x coordinate of their center and each slice is then sorted by the y coordinate of the center. This way, boxes that
+	 * 			are next to each other in the list are also close to each other in space
+	 * @param boxes The list that contains the boxes
+	 * @param first The index of the first box of the level
+	 * @param last One past the index of the last box of the level
+	 */
+	template<class boxType>
+	void sortTiles(std::vector<boxType> &boxes, size_t first, size_t last);
+
+	/**
+	 * @brief Creates the nodes of the next level of the tree. Each node encloses up to p_nodeCapacity boxes of the level below
+	 * @param boxes The list that contains the boxes of the level below
+	 * @param first The index of the first box of the level below
+	 * @param last One past the index of the last box of the level below
+	 * @param isLeaf Boolean used to indicate if the boxes are entries
+	 */
+	template<class boxType>
+	void addParentNodes(std::vector<boxType> &boxes, size_t first, size_t last, bool isLeaf);
+
+	/**
+	 * @brief Finds all of the paths whose bounding box contains the box
+	 * @param minX The minimum x value of the box
+	 * @param minY The minimum y value of the box
+	 * @param maxX The maximum x value of the box
+	 * @param maxY The maximum y value of the box
+	 * @param results The list that the indices of the paths will be added to
+	 */
+	void queryContaining(double minX, double minY, double maxX, double maxY, std::vector<size_t> &results);
+
+	/**
+	 * @brief Sorts a list of path indices so that the path with the smallest area is first
+	 * @param indices The list of indices to sort
+	 */
+	void sortByArea(std::vector<size_t> &indices)
+	{
+		std::vector<closedPath> &paths = *p_paths;
+
+		std::sort(indices.begin(), indices.end(), [&paths](size_t first, size_t second)
+		{
+			return paths[first].getArea() < paths[second].getArea();
+		});
+	}
+
+public:
+
+	/**
+	 * @brief Builds the R-tree over the bounding boxes of the paths and finds the parent of each path. The area of
+	 * 			each path must have been set
+	 * @param paths The list of closed paths. The list must not change while the tree is used
+	 */
+	void build(std::vector<closedPath> &paths);
+
+	/**
+	 * @brief Retrieves the index of the path that directly contains a path
+	 * @param index The index of the path
+	 * @return Returns the index of the parent path. Returns -1 if the path is not inside of any other path
+	 */
+	long getParent(size_t index)
+	{
+		return p_parents.at(index);
+	}
+
+	/**
+	 * @brief Retrieves the paths that are directly inside of a path. These are the top level holes of the path
+	 * @param index The index of the path
+	 * @return Returns a pointer to the list of indices of the child paths
+	 */
+	std::vector<size_t> *getChildren(size_t index)
+	{
+		return &p_children.at(index);
+	}
+
+	/**
+	 * @brief 	Finds the face that each point lies in. This is the path with the smallest area that contains the point. The points
+	 * 			are grouped by the paths whose bounding box contains them and each path tests its group with closedPath::pointsInContour
+	 * @param points The points to locate
+	 * @param pathIndices The list that the index of the path of each point will be written to. The index is -1 if the point is
+	 * 			outside of all of the paths
+	 */
+	void findPaths(std::vector<wxRealPoint> &points, std::vector<long> &pathIndices);
+};
+
+#endif
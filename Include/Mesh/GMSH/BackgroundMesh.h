@@ -48,7 +48,9 @@ class backgroundMesh : public simpleFunction<double>
   std::map<MVertex*,MVertex*> _2Dto3D;
   std::map<MVertex*,double> _distance;
   std::map<MVertex*,double> _angles;
-  static backgroundMesh * _current;
+  // each thread meshes its own face, so each thread has its own background
+  // mesh
+  static thread_local backgroundMesh * _current;
   backgroundMesh(GFace *, bool dist = false);
   ~backgroundMesh();
 #if defined(HAVE_ANN)
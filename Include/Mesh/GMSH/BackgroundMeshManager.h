@@ -7,6 +7,7 @@
 #define _BACKGROUND_MESH_MANAGER_H_
 
 #include <map>
+#include <mutex>
 #include "Mesh/GMSH/BGMBase.h"
 
 using namespace std;
@@ -23,8 +24,12 @@ public:
   static void set_use_cross_field(bool b);
 private:
   static bool use_cross_field;
-  static BGMBase *latest2Dbgm;
+  // the latest background mesh is per thread since the faces are meshed
+  // concurrently; the map of background meshes is shared and guarded by the
+  // mutex
+  static thread_local BGMBase *latest2Dbgm;
   static map<GEntity*,BGMBase*> data;
+  static std::mutex dataMutex;
 };
 
 #endif
@@ -38,6 +38,8 @@ struct contextMeshOptions {
   int algoRecombine, recombineAll, recombine3DAll, recombine3DLevel;
   int recombine3DConformity;
   int flexibleTransfinite;
+  // maximum number of threads used to mesh the surfaces (0: OpenMP default)
+  int maxNumThreads2D;
   //-- for recombination test (amaury) --
   int doRecombinationTest, recombinationTestStart;
   int recombinationTestNoGreedyStrat, recombinationTestNewStrat;
@@ -89,10 +91,18 @@ struct contextGeometryOptions {
 class CTX {
  private:
   static CTX *_instance;
+  // a private copy of the options for the current thread; see beginThreadCopy
+  static thread_local CTX *_threadInstance;
  public:
   CTX();
   ~CTX();
   static CTX *instance();
+  // give the calling thread its own copy of the options until endThreadCopy is
+  // called; the mesh algorithms temporarily change some of the options, so
+  // every thread that meshes faces concurrently must work on a copy. The
+  // shared options must not be changed while any thread has a copy.
+  static void beginThreadCopy();
+  static void endThreadCopy();
  public:
   // files on the command line and various file names
 //  std::vector<std::string> files;
@@ -11,6 +11,7 @@
 #include <set>
 #include <map>
 #include <string>
+#include <atomic>
 
 #include "Mesh/GMSH/GVertex.h"
 #include "Mesh/GMSH/GEdge.h"
@@ -55,6 +56,7 @@ class GModel {
   std::set<GVertex*, GEntityLessThan> _chainVertices;
 
   int _readMSH2(const std::string &name);
+  int _readMSH2Fast(const std::string &name);
   int _writeMSH2(const std::string &name, double version=2.2, bool binary=false,
                  bool saveAll=false, bool saveParametric=false,
                  double scalingFactor=1.0, int elementStartNum=0,
@@ -65,9 +67,13 @@ class GModel {
                             bool saveAll=false, bool saveParametric=false,
                             double scalingFactor=1.0);
 
-  // the maximum vertex and element id number in the mesh
-  int _maxVertexNum, _maxElementNum;
+  // the maximum vertex and element id number in the mesh; these are atomic
+  // since the faces are meshed concurrently
+  std::atomic<int> _maxVertexNum, _maxElementNum;
   int _checkPointedMaxVertexNum, _checkPointedMaxElementNum;
+  // the numbering of the mesh vertices that is kept while several writers use
+  // it at once (_frozenIndexAll is -1 when the numbering is not frozen)
+  int _frozenIndexAll, _frozenNumVertices;
  protected:
   // the name of the model
   std::string _name = "None";
@@ -195,6 +201,29 @@ class GModel {
   int getMaxElementNumber(){ return _maxElementNum; }
   void setMaxVertexNumber(int num){ _maxVertexNum = num; }
   void setMaxElementNumber(int num){ _maxElementNum = num; }
+
+  // reserve the next vertex/element num (thread safe)
+  int newVertexNumber(){ return ++_maxVertexNum; }
+  int newElementNumber(){ return ++_maxElementNum; }
+
+  // make sure that the max vertex/element num is at least num (thread safe)
+  void raiseMaxVertexNumber(int num)
+  {
+    int current = _maxVertexNum;
+    while(current < num && !_maxVertexNum.compare_exchange_weak(current, num)){}
+  }
+  void raiseMaxElementNumber(int num)
+  {
+    int current = _maxElementNum;
+    while(current < num && !_maxElementNum.compare_exchange_weak(current, num)){}
+  }
+
+  // give back the vertex num if it is the last one that was reserved (thread
+  // safe)
+  void releaseVertexNumber(int num)
+  {
+    _maxVertexNum.compare_exchange_strong(num, num - 1);
+  }
   void checkPointMaxNumbers()
   {
     _checkPointedMaxVertexNum = _maxVertexNum;
@@ -414,6 +443,13 @@ class GModel {
   // starting at 1
   int indexMeshVertices(bool all, int singlePartition=0, bool renumber=true);
 
+  // index the mesh vertices once and keep the numbering: until the numbering
+  // is released, indexMeshVertices() with the same "all" and no partition
+  // returns the frozen count without touching the vertices, so that the
+  // writers that share this numbering can run concurrently
+  void freezeMeshVertexIndex(bool all);
+  void unfreezeMeshVertexIndex();
+
   // scale the mesh by the given factor
   void scaleMesh(double factor);
 
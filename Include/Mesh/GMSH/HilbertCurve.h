@@ -6,6 +6,21 @@
 #ifndef _HILBERT_CURVE_
 #define _HILBERT_CURVE_
 
+#include <vector>
+
+class MVertex;
+
 void SortHilbert(std::vector<MVertex*>&);
 
+// Orders points of the plane for a bulk insertion in a Delaunay mesh: the
+// points are split in rounds of growing size (BRIO) and each round follows a
+// 2D Hilbert curve, so that the walk from the last inserted point stays short.
+// order receives the indices of the points in the order of insertion.
+void SortHilbert2D(const std::vector<double> &x, const std::vector<double> &y,
+                   std::vector<int> &order);
+// Same for vertices sitting in the XY plane
+void SortHilbert2D(std::vector<MVertex*> &v);
+// Same for vertices of a face, using their parametric coordinates
+void SortHilbertParametric(std::vector<MVertex*> &v);
+
 #endif
@@ -134,17 +134,31 @@ class dofManager : public dofManagerBase{
   std::map<const std::string, linearSystem<dataMat>*> _linearSystems;
 
   std::map<Dof, T> ghostValue;
+
+  // two-pass assembly: the symbolic pass stores, for every element, the
+  // equation number of its dofs (-1 if not an unknown), a pointer to the
+  // fixed value of its fixed dofs and the position of each entry of the
+  // element matrix in the values of the matrix (-1 if the system has no
+  // direct access), so that the numeric pass needs no Dof lookups.
+  // Elements touching a linear constraint keep their Dofs and are assembled
+  // the usual way
+  std::vector<int> _elementOffset, _elementEquation;
+  std::vector<const dataVec*> _elementFixed;
+  std::vector<size_t> _elementEntryOffset;
+  std::vector<int> _elementEntry;
+  std::map<int, std::vector<Dof> > _elementConstrained;
+  bool _patternFinalized;
   public:
   void scatterSolution();
 
  public:
   dofManager(linearSystem<dataMat> *l, bool isParallel=false)
-    :dofManagerBase(isParallel), _current(l)
+    :dofManagerBase(isParallel), _current(l), _patternFinalized(false)
   {
     _linearSystems["A"] = l;
   }
   dofManager(linearSystem<dataMat> *l1, linearSystem<dataMat> *l2)
-    :dofManagerBase(false), _current(l1)
+    :dofManagerBase(false), _current(l1), _patternFinalized(false)
   {
     _linearSystems.insert(std::make_pair("A", l1));
     _linearSystems.insert(std::make_pair("B", l2));
@@ -367,6 +381,130 @@ class dofManager : public dofManagerBase{
     }
   }
 
+  // symbolic pass of the two-pass assembly, for square element matrices
+  // whose rows and columns share the Dofs R. All the Dofs must have been
+  // numbered and fixed before. Returns the index of the element that is
+  // given to assembleElement
+  virtual int insertElementInPattern(const std::vector<Dof> &R)
+  {
+    if (_isParallel && !_parallelFinalized) _parallelFinalize();
+    if (!_current->isAllocated()) _current->allocate(sizeOfR());
+    if (_elementOffset.empty()) _elementOffset.push_back(0);
+    const int iElement = _elementOffset.size() - 1;
+    bool constrained = false;
+    for (unsigned int i = 0; i < R.size(); i++){
+      int num = -1;
+      const dataVec *fixedValue = 0;
+      std::map<Dof, int>::iterator itR = unknown.find(R[i]);
+      if (itR != unknown.end()) num = itR->second;
+      else{
+        typename std::map<Dof, dataVec>::iterator itFixed = fixed.find(R[i]);
+        if (itFixed != fixed.end()) fixedValue = &itFixed->second;
+        else if (constraints.find(R[i]) != constraints.end()) constrained = true;
+      }
+      _elementEquation.push_back(num);
+      _elementFixed.push_back(fixedValue);
+    }
+    _elementOffset.push_back(_elementEquation.size());
+    if (constrained){
+      _elementConstrained[iElement] = R;
+      sparsityDof(R);
+    }
+    else{
+      const int *num = &_elementEquation[_elementOffset[iElement]];
+      for (unsigned int i = 0; i < R.size(); i++){
+        if (num[i] == -1) continue;
+        for (unsigned int j = 0; j < R.size(); j++)
+          if (num[j] != -1) _current->insertInSparsityPattern(num[i], num[j]);
+      }
+    }
+    _patternFinalized = false;
+    return iElement;
+  }
+  // end of the symbolic pass: the matrix is preallocated from the pattern
+  // and the position of each entry of the element matrices is stored
+  virtual void finalizePattern()
+  {
+    _current->preAllocateEntries();
+    const int nbElements = getNumPatternElements();
+    _elementEntryOffset.assign(1, 0);
+    _elementEntry.clear();
+    for (int e = 0; e < nbElements; e++){
+      const int *num = &_elementEquation[0] + _elementOffset[e];
+      const int n = _elementOffset[e + 1] - _elementOffset[e];
+      if (_elementConstrained.find(e) == _elementConstrained.end()){
+        for (int i = 0; i < n; i++)
+          for (int j = 0; j < n; j++)
+            _elementEntry.push_back((num[i] == -1 || num[j] == -1) ? -1 :
+                                    _current->getMatrixPosition(num[i], num[j]));
+      }
+      _elementEntryOffset.push_back(_elementEntry.size());
+    }
+    _patternFinalized = true;
+  }
+  inline int getNumPatternElements() const
+  {
+    return _elementOffset.empty() ? 0 : _elementOffset.size() - 1;
+  }
+  virtual void clearPattern()
+  {
+    _elementOffset.clear();
+    _elementEquation.clear();
+    _elementFixed.clear();
+    _elementEntryOffset.clear();
+    _elementEntry.clear();
+    _elementConstrained.clear();
+    _patternFinalized = false;
+  }
+  // numeric pass: adds the element matrix of element iElement
+  virtual inline void assembleElement(int iElement, const fullMatrix<dataMat> &m)
+  {
+    if (!_patternFinalized) finalizePattern();
+    typename std::map<int, std::vector<Dof> >::iterator itC =
+      _elementConstrained.end();
+    if (!_elementConstrained.empty()) itC = _elementConstrained.find(iElement);
+    if (itC != _elementConstrained.end()){
+      assemble(itC->second, m);
+      return;
+    }
+    const int n = _elementOffset[iElement + 1] - _elementOffset[iElement];
+    const int *num = &_elementEquation[0] + _elementOffset[iElement];
+    const dataVec * const *fixedValue = &_elementFixed[0] + _elementOffset[iElement];
+    const int *entry = &_elementEntry[0] + _elementEntryOffset[iElement];
+    dataMat *values = _current->getMatrixValues();
+    for (int i = 0; i < n; i++){
+      if (num[i] == -1) continue;
+      for (int j = 0; j < n; j++){
+        const int position = entry[i * n + j];
+        if (position != -1)
+          values[position] += m(i, j);
+        else if (num[j] != -1)
+          _current->addToMatrix(num[i], num[j], m(i, j));
+        else if (fixedValue[j]){
+          // tmp = -m(i,j) * fixed value
+          dataVec tmp(*fixedValue[j]);
+          dofTraits<T>::gemm(tmp, m(i, j), *fixedValue[j], -1, 0);
+          _current->addToRightHandSide(num[i], tmp);
+        }
+      }
+    }
+  }
+  // numeric pass: adds the element vector of element iElement
+  virtual inline void assembleElement(int iElement, const fullVector<dataMat> &v)
+  {
+    typename std::map<int, std::vector<Dof> >::iterator itC =
+      _elementConstrained.end();
+    if (!_elementConstrained.empty()) itC = _elementConstrained.find(iElement);
+    if (itC != _elementConstrained.end()){
+      assemble(itC->second, v);
+      return;
+    }
+    const int n = _elementOffset[iElement + 1] - _elementOffset[iElement];
+    const int *num = &_elementEquation[0] + _elementOffset[iElement];
+    for (int i = 0; i < n; i++)
+      if (num[i] != -1) _current->addToRightHandSide(num[i], v(i));
+  }
+
   virtual inline void assemble(const Dof &R, const Dof &C, const dataMat &value)
   {
     if (_isParallel && !_parallelFinalized) _parallelFinalize();
@@ -45,6 +45,11 @@ class linearSystem : public linearSystemBase {
   virtual void getFromRightHandSide(int _row, scalar &val) const = 0;
   virtual void getFromSolution(int _row, scalar &val) const = 0;
   virtual void addToSolution(int _row, const scalar &val) = 0;
+  // direct access to the values of a matrix whose pattern is fixed: the
+  // position of the entry (_row, _col) in getMatrixValues(), or -1 if the
+  // system does not support it or the entry is not in the pattern
+  virtual int getMatrixPosition(int _row, int _col) { return -1; }
+  virtual scalar *getMatrixValues() { return 0; }
 };
 
 #endif
@@ -7,6 +7,8 @@
 #define _LINEAR_SYSTEM_CSR_H_
 
 #include <vector>
+#include <complex>
+#include <algorithm>
 //#include "GmshConfig.h"
 #include "GmshMessage.h"
 #include "Mesh/GMSH/linearSystem.h"
@@ -34,11 +36,15 @@ class linearSystemCSR : public linearSystem<scalar> {
   CSRList_T *_a, *_ai, *_ptr, *_jptr;
   std::vector<scalar> *_b, *_x;
   sparsityPattern _sparsity; // only used for pre-allocation, does not store the sparsity once allocated
+  // incremented whenever the sparsity pattern or its layout changes, so that
+  // data derived from the pattern can tell that it is out of date
+  unsigned long _patternGeneration;
  public:
   int getNNZ() {return CSRList_Nbr(linearSystemCSR<scalar>::_a);}
   int getNbUnk() {return linearSystemCSR<scalar>::_b->size();}
   linearSystemCSR()
-    : sorted(false), _entriesPreAllocated(false), _a(0), _b(0), _x(0) {}
+    : sorted(false), _entriesPreAllocated(false), _a(0), _b(0), _x(0),
+      _patternGeneration(0) {}
   virtual bool isAllocated() const { return _a != 0; }
   virtual void allocate(int) ;
   virtual void clear()
@@ -99,6 +105,7 @@ class linearSystemCSR : public linearSystem<scalar> {
     }
 
     INDEX_TYPE zero = 0;
+    _patternGeneration++;
     CSRList_Add(_a, &val);
     CSRList_Add(_ai, &ic);
     CSRList_Add(_ptr, &zero);
@@ -118,6 +125,28 @@ class linearSystemCSR : public linearSystem<scalar> {
     else ptr[position] = n;
   }
   virtual void getMatrix(INDEX_TYPE*& jptr,INDEX_TYPE*& ai,double*& a);
+  unsigned long getPatternGeneration() const { return _patternGeneration; }
+  // the positions are only available once the entries have been
+  // preallocated from the sparsity pattern; they stay valid as long as no
+  // entry outside of the pattern is added
+  virtual int getMatrixPosition(int il, int ic)
+  {
+    if (!_entriesPreAllocated)
+      preAllocateEntries();
+    if (!_entriesPreAllocated) return -1;
+    const INDEX_TYPE *jptr = (INDEX_TYPE*) _jptr->array;
+    const INDEX_TYPE *ai = (INDEX_TYPE*) _ai->array;
+    const INDEX_TYPE *first = ai + jptr[il], *last = ai + jptr[il + 1];
+    const INDEX_TYPE *it = std::lower_bound(first, last, ic);
+    if (it == last || *it != ic) return -1;
+    return it - ai;
+  }
+  virtual scalar *getMatrixValues()
+  {
+    if (!_entriesPreAllocated)
+      preAllocateEntries();
+    return _a ? (scalar*) _a->array : 0;
+  }
 
   virtual void getFromMatrix (int row, int col, scalar &val) const
   {
@@ -220,4 +249,76 @@ class linearSystemCSRTaucs : public linearSystemCSR<scalar> {
   ;
 };
 
+// A built-in iterative solver working directly on the sorted CSR arrays, so
+// that no external library is needed. The Krylov method is either the
+// preconditioned conjugate gradient (for complex matrices this is the
+// conjugate orthogonal variant, suited to complex symmetric systems) or
+// BiCGStab for non-symmetric matrices. The matrix-vector products and the
+// vector updates are threaded with OpenMP; the triangular solves of the
+// ILU(0) and IC(0) preconditioners are sequential. IC(0) only reads the
+// lower triangle, so it assumes that the matrix is symmetric. The current
+// solution is used as the initial guess.
+template <class scalar>
+class linearSystemCSRIterative : public linearSystemCSR<scalar> {
+ public:
+  enum method { CG, BICGSTAB };
+  enum preconditioner { NONE, JACOBI, ILU0, IC0 };
+ private:
+  double _prec;
+  int _maxIter, _noisy;
+  method _method;
+  preconditioner _preconditioner;
+  int _iterations;
+  double _residual;
+  // values of the incomplete factors on the pattern of the matrix, the
+  // inverse of the diagonal (Jacobi) and the position of the diagonal in
+  // each row
+  std::vector<scalar> _factor, _invDiag;
+  std::vector<INDEX_TYPE> _diagPos;
+  // the generation of the pattern that _diagPos and the factors were
+  // computed on, so that they can be kept when the same pattern is solved
+  // again. 0 if they were never computed
+  unsigned long _setupGeneration;
+  int _setupN;
+  bool _reusePreconditioner, _preconditionerReused;
+  void _getSortedMatrix(INDEX_TYPE *&jptr, INDEX_TYPE *&ai, scalar *&a);
+  bool _setupPreconditioner(int n, const INDEX_TYPE *jptr,
+                            const INDEX_TYPE *ai, const scalar *a);
+  void _applyPreconditioner(int n, const INDEX_TYPE *jptr,
+                            const INDEX_TYPE *ai, const scalar *r,
+                            scalar *z) const;
+  int _solveCG(int n, const INDEX_TYPE *jptr, const INDEX_TYPE *ai,
+               const scalar *a, const scalar *b, scalar *x);
+  int _solveBiCGStab(int n, const INDEX_TYPE *jptr, const INDEX_TYPE *ai,
+                     const scalar *a, const scalar *b, scalar *x);
+ public:
+  linearSystemCSRIterative(method m = CG, preconditioner p = IC0)
+    : _prec(1.e-8), _maxIter(10000), _noisy(0), _method(m),
+      _preconditioner(p), _iterations(0), _residual(0.),
+      _setupGeneration(0), _setupN(0), _reusePreconditioner(false),
+      _preconditionerReused(false) {}
+  virtual ~linearSystemCSRIterative(){}
+  void setPrec(double p){ _prec = p; }
+  void setMaxIterations(int n){ _maxIter = n; }
+  void setNoisy(int n){ _noisy = n; }
+  void setMethod(method m){ _method = m; }
+  void setPreconditioner(preconditioner p){ _preconditioner = p; }
+  // keep the preconditioner of the previous solve instead of rebuilding it
+  // from the current values of the matrix, as long as the sparsity pattern
+  // has not changed. This is meant for sequences of systems with slowly
+  // varying values (Newton iterations, time steps): the Krylov method still
+  // converges on the new matrix, only with a slightly older preconditioner
+  void setReusePreconditioner(bool r){ _reusePreconditioner = r; }
+  // true if the last solve kept the previous preconditioner
+  bool getPreconditionerReused() const { return _preconditionerReused; }
+  // number of iterations and relative residual of the last solve
+  int getNumIterations() const { return _iterations; }
+  double getResidual() const { return _residual; }
+  // 2-norm of b - A x for the current solution, and 2-norm of b
+  double normResidual();
+  double norm2RightHandSide() const;
+  // returns 1 if the relative residual dropped below the tolerance
+  virtual int systemSolve();
+};
+
 #endif
@@ -14,6 +14,9 @@
 #include <list>
 #include <set>
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
 
 class GModel;
 class GFace;
@@ -81,12 +84,18 @@ class MTri3
 {
  protected :
   bool deleted;
+  bool queued;
   double circum_radius;
   MTriangle *base;
   MTri3 *neigh[3];
 
  public :
-  static int radiusNorm; // 2 is euclidian norm, -1 is infinite norm  , 3 quality
+  static thread_local int radiusNorm; // 2 is euclidian norm, -1 is infinite norm  , 3 quality
+  // MTri3 are created and destroyed by the million while a face is meshed,
+  // always by the thread that meshes the face: they are taken from a per
+  // thread pool of fixed size blocks instead of the general heap
+  static void *operator new(std::size_t size);
+  static void operator delete(void *p, std::size_t size);
   bool isDeleted() const { return deleted; }
   void forceRadius(double r) { circum_radius = r; }
   inline double getRadius() const { return circum_radius; }
@@ -115,6 +124,9 @@ class MTri3
     return inCircumCircle(v->x(), v->y());
   }
   inline void setDeleted(bool d){ deleted = d; }
+  // true while the triangle waits in a queue of active triangles
+  inline bool isQueued() const { return queued; }
+  inline void setQueued(bool q){ queued = q; }
   inline bool assertNeigh() const
   {
     if(deleted) return true;
@@ -142,6 +154,49 @@ class compareTri3Ptr
   }
 };
 
+// Priority queue of triangles in the order of compareTri3Ptr, i.e. the
+// triangle with the largest circumradius is on top. It is a binary heap
+// stored in a flat array, so that pushing a triangle does not allocate a
+// tree node. Deleted triangles are not removed from the heap, they are
+// discarded when they reach the top.
+class MTri3Heap
+{
+ private:
+  std::vector<MTri3*> _tris;
+  struct smallerRadius
+  {
+    inline bool operator () (const MTri3 *a, const MTri3 *b) const
+    {
+      compareTri3Ptr comp;
+      return comp(b, a);
+    }
+  };
+ public:
+  typedef std::vector<MTri3*>::iterator iterator;
+  inline iterator begin() { return _tris.begin(); }
+  inline iterator end() { return _tris.end(); }
+  inline bool empty() const { return _tris.empty(); }
+  inline std::size_t size() const { return _tris.size(); }
+  inline void reserve(std::size_t n) { _tris.reserve(n); }
+  inline void swap(MTri3Heap &other) { _tris.swap(other._tris); }
+  inline MTri3 *top() const { return _tris.front(); }
+  inline void push(MTri3 *t)
+  {
+    _tris.push_back(t);
+    std::push_heap(_tris.begin(), _tris.end(), smallerRadius());
+  }
+  inline void pop()
+  {
+    std::pop_heap(_tris.begin(), _tris.end(), smallerRadius());
+    _tris.pop_back();
+  }
+  template <class ITER>
+  inline void insert(ITER beg, ITER end)
+  {
+    for (; beg != end; ++beg) push(*beg);
+  }
+};
+
 void connectTriangles(std::list<MTri3*> &);
 void connectTriangles(std::vector<MTri3*> &);
 void connectTriangles(std::set<MTri3*,compareTri3Ptr> &AllTris);
@@ -0,0 +1,245 @@
+#ifndef MESH_CACHE_H_
+#define MESH_CACHE_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <UI/GeometryEditor2D.h>
+
+#include <common/OmniFEMMessage.h>
+
+#include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/GEntity.h>
+#include <Mesh/GMSH/MElement.h>
+#include <Mesh/GMSH/MVertex.h>
+
+
+//! The arrays that are stored in a mesh cache. Each array starts on a multiple of 64 bytes from the start of the file
+enum cacheSection
+{
+	//! One meshCacheEntity for each vertex, edge and face of the model
+	SECTION_ENTITIES = 0,
+	//! The physical groups of the entities as int32
+	SECTION_PHYSICALS,
+	//! One meshCacheName for each physical group that has a name
+	SECTION_NAMES,
+	//! The characters of the names. The names are not null terminated
+	SECTION_NAME_CHARACTERS,
+	//! The x coordinate of each node as a double
+	SECTION_NODE_X,
+	//! The y coordinate of each node as a double
+	SECTION_NODE_Y,
+	//! The z coordinate of each node as a double
+	SECTION_NODE_Z,
+	//! The GMSH (MSH file) type of each element as int32
+	SECTION_ELEMENT_TYPES,
+	//! Where the nodes of each element start in the connectivity as uint64. This has one more entry than there are elements
+	SECTION_ELEMENT_OFFSETS,
+	//! The nodes of the elements as uint32 in the GMSH order
+	SECTION_CONNECTIVITY,
+	//! The two nodes of each unique edge of the elements as uint32. This is what the canvas draws
+	SECTION_EDGES,
+	NUMBER_OF_SECTIONS
+};
+
+//! The first bytes of a mesh cache
+struct meshCacheHeader
+{
+	//! Always "OFEMMESH"
+	char magic[8];
+
+	//! The version of the layout
+	uint32_t version;
+
+	//! Always 0x01020304 when read on a machine with the same byte order as the one that wrote the file
+	uint32_t byteOrder;
+
+	//! The hash of the geometry that was meshed
+	uint64_t geometryHash;
+
+	//! The number of entries in each of the arrays
+	uint64_t numberOfEntities;
+	uint64_t numberOfPhysicals;
+	uint64_t numberOfNames;
+	uint64_t numberOfNameCharacters;
+	uint64_t numberOfNodes;
+	uint64_t numberOfElements;
+	uint64_t numberOfConnectivity;
+	uint64_t numberOfEdges;
+
+	//! The offset of each section from the start of the file
+	uint64_t sectionOffset[NUMBER_OF_SECTIONS];
+};
+
+//! One vertex, edge or face of the model. The nodes and the elements of an entity are stored one after another
+struct meshCacheEntity
+{
+	int32_t dimension;
+	int32_t tag;
+
+	//! The tags of the vertices at the ends of an edge. 0 if the edge does not have the vertex or if this is not an edge
+	int32_t beginTag;
+	int32_t endTag;
+
+	uint32_t firstNode;
+	uint32_t numberOfNodes;
+	uint32_t firstElement;
+	uint32_t numberOfElements;
+	uint32_t firstPhysical;
+	uint32_t numberOfPhysicals;
+};
+
+//! The name of one physical group. These are the names of the materials and the boundaries that the solvers look up
+struct meshCacheName
+{
+	int32_t dimension;
+	int32_t tag;
+	uint32_t firstCharacter;
+	uint32_t numberOfCharacters;
+};
+
+
+/**
+ * @class meshCache
+ * @author Phillip
+ * @date 17/10/26
+ * @file MeshCache.h
+ * @brief 	The mesh of a project is kept in a binary file next to the .omniFEM file so that the project does not need to be meshed
+ * 			again when it is opened. The file holds the nodes, the elements, the physical groups (with their names, which is how the
+ * 			block labels and the segment properties are found by the solvers) and the unique edges that the canvas draws. Each of
+ * 			these is one contiguous array that starts on a 64 byte boundary so that the file can be memory mapped and read in place
+ * 			without parsing. The file also holds a hash of the geometry that was meshed. If the geometry of the project no longer
+ * 			has the same hash, the mesh is out of date and the file is not used. The file is written in the byte order of the
+ * 			machine that wrote it and is refused on a machine with a different byte order.
+ */
+class meshCache
+{
+private:
+	//! The memory that the file is mapped into. Null if no file is open
+	void *p_mapping = nullptr;
+
+	//! The size of the file in bytes
+	size_t p_mappingSize = 0;
+
+	/**
+	 * @brief Finds where an array starts in the mapped file
+	 * @param section The array that is looked up
+	 * @return Returns a pointer into the mapped file
+	 */
+	template<class T>
+	const T *getSection(cacheSection section) const
+	{
+		return reinterpret_cast<const T*>(static_cast<const char*>(p_mapping) + getHeader()->sectionOffset[section]);
+	}
+
+	/**
+	 * @brief Checks that the header of the mapped file is valid and that all of the arrays are inside of the file
+	 * @return Returns true if the file can be used
+	 */
+	bool isValid() const;
+
+public:
+	meshCache()
+	{
+	}
+
+	//! The cache owns the mapping so it can not be copied
+	meshCache(const meshCache &) = delete;
+	meshCache &operator=(const meshCache &) = delete;
+
+	~meshCache()
+	{
+		close();
+	}
+
+	/**
+	 * @brief Finds the path of the mesh cache of a project
+	 * @param projectPath The path to the .omniFEM file
+	 * @return Returns the path of the project with the extension .omniFEMmesh
+	 */
+	static std::string getCachePath(std::string projectPath);
+
+	/**
+	 * @brief 	Computes the hash of a geometry. This walks the nodes, lines, arcs and block labels and hashes the fields that
+	 * 			are saved in the project so that changing any of them changes the hash
+	 * @param editor The geometry that is hashed
+	 * @return Returns the 64 bit FNV-1a hash of the geometry
+	 */
+	static uint64_t computeGeometryHash(geometryEditor2D &editor);
+
+	/**
+	 * @brief 	Writes the mesh of a model into a cache file. The file is written under a temporary name and then renamed so that
+	 * 			a cache that is being read is never half written
+	 * @param filePath The path of the cache file
+	 * @param model The model that the mesh is in
+	 * @param geometryHash The hash of the geometry that was meshed
+	 * @return Returns false if the file could not be written
+	 */
+	static bool write(std::string filePath, GModel *model, uint64_t geometryHash);
+
+	/**
+	 * @brief Maps a cache file into memory. Any file that was open is closed first
+	 * @param filePath The path of the cache file
+	 * @return Returns false if the file does not exist or is not a valid cache
+	 */
+	bool open(std::string filePath);
+
+	//! Unmaps the file. The pointers that were returned from the cache are no longer valid after this is called
+	void close();
+
+	bool isOpen() const
+	{
+		return p_mapping != nullptr;
+	}
+
+	/**
+	 * @brief Creates the vertices, the edges and the faces of the cached mesh in a model. The entities are discrete entities
+	 * @param model The model that the mesh is created in. The model should not have any entities
+	 * @return Returns false if the cache refers to a node or an entity that does not exist
+	 */
+	bool restore(GModel *model) const;
+
+	const meshCacheHeader *getHeader() const
+	{
+		return static_cast<const meshCacheHeader*>(p_mapping);
+	}
+
+	uint64_t getGeometryHash() const
+	{
+		return getHeader()->geometryHash;
+	}
+
+	size_t getNumberOfNodes() const
+	{
+		return getHeader()->numberOfNodes;
+	}
+
+	size_t getNumberOfElements() const
+	{
+		return getHeader()->numberOfElements;
+	}
+
+	size_t getNumberOfEdges() const
+	{
+		return getHeader()->numberOfEdges;
+	}
+
+	const double *getXCoordinates() const
+	{
+		return getSection<double>(SECTION_NODE_X);
+	}
+
+	const double *getYCoordinates() const
+	{
+		return getSection<double>(SECTION_NODE_Y);
+	}
+
+	//! The two nodes of each edge. Edge i uses the nodes 2 * i and 2 * i + 1
+	const uint32_t *getEdges() const
+	{
+		return getSection<uint32_t>(SECTION_EDGES);
+	}
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef MESH_EXPORTER_H_
+#define MESH_EXPORTER_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <wx/string.h>
+
+#include <common/MeshSettings.h>
+#include <common/OmniFEMMessage.h>
+#include <common/OS.h>
+
+#include <Mesh/GMSH/GModel.h>
+
+
+/**
+ * @class meshExporter
+ * @author Phillip
+ * @date 17/10/26
+ * @file MeshExporter.h
+ * @brief 	Writes the mesh of a GMSH model into all of the file formats that are selected in the mesh settings. Most of the GMSH
+ * 			writers number the mesh vertices in the model before they write, so two of them can not run at once unless they
+ * 			ask for the same numbering. The formats are therefore put into groups by the numbering that they use. The numbering
+ * 			of a group is made once and frozen in the model, and the formats of the group are then written by several threads
+ * 			at once. The formats that make their own numbering are written one after another at the end. The time that each
+ * 			format took is reported to the status window once everything is written.
+ */
+class meshExporter
+{
+private:
+	//! The numbering of the mesh vertices that a writer uses
+	enum exportNumbering
+	{
+		//! The writer does not use the numbering of the vertices
+		NUMBERING_NONE,
+		//! The vertices of the elements that are in a physical group are numbered
+		NUMBERING_PHYSICAL,
+		//! The vertices of all of the elements are numbered
+		NUMBERING_ALL,
+		//! The writer numbers the vertices itself and can not share the model with other writers
+		NUMBERING_OWN
+	};
+
+	//! One file format that is written
+	struct exportTask
+	{
+		//! The name of the format that is shown in the report
+		std::string format;
+
+		//! The path that the file is written to
+		std::string filePath;
+
+		//! The numbering that the writer uses
+		exportNumbering numbering;
+
+		//! Calls the GMSH writer of the format. This returns 0 if the file could not be written
+		std::function<int()> write;
+
+		//! The time in seconds that the writer took
+		double time = 0;
+
+		//! Set to true if the writer was able to write the file
+		bool isWritten = false;
+	};
+
+	//! The model that the mesh is in
+	GModel *p_model;
+
+	//! The formats that are written
+	std::vector<exportTask> p_tasks;
+
+	/**
+	 * @brief Adds a format to the list of formats that are written
+	 * @param format The name of the format that is shown in the report
+	 * @param filePath The path that the file is written to
+	 * @param numbering The numbering of the mesh vertices that the writer uses
+	 * @param write Calls the GMSH writer of the format
+	 */
+	void addFormat(std::string format, std::string filePath, exportNumbering numbering, std::function<int()> write);
+
+	/**
+	 * @brief Writes a group of formats at once. The numbering that the formats use needs to be frozen in the model
+	 * @param group The positions in the task list of the formats that are written
+	 */
+	void writeGroup(const std::vector<int> &group);
+
+public:
+	/**
+	 * @brief Creates the list of formats that are selected in the mesh settings
+	 * @param model The model that the mesh is in
+	 * @param settings The mesh settings that select the formats
+	 * @param basePath The path and name that the files are written to. The extension of each format is added to this
+	 */
+	meshExporter(GModel *model, meshSettings &settings, std::string basePath);
+
+	/**
+	 * @brief Writes all of the formats and reports the time of each format
+	 * @return Returns false if one of the formats could not be written
+	 */
+	bool write();
+
+	/**
+	 * @brief Gets the number of formats that are written
+	 * @return Returns the number of formats that are selected in the mesh settings
+	 */
+	unsigned int getNumberOfFormats()
+	{
+		return p_tasks.size();
+	}
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef PLANAR_GRAPH_H_
+#define PLANAR_GRAPH_H_
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <math.h>
+
+#include <common/plfcolony.h>
+
+#include <Mesh/ClosedPath.h>
+
+#include <UI/geometryShapes.h>
+
+
+/**
+ * @class planarGraph
+ * @author Phillip
+ * @date 17/10/26
+ * @file PlanarGraph.h
+ * @brief 	This class finds all of the faces (closed contours) of the geometry at once. Each line and arc is split into two
+ * 			half-edges, one for each direction. The half-edges leaving a node are sorted by the direction that they leave the node in.
+ * 			For arcs, this is the tangent of the arc at the node. Starting from any half-edge and always turning to the next half-edge
+ * 			clockwise around the node that is reached will trace out the boundary of one face with the face on the left. Every half-edge
+ * 			belongs to exactly one of these loops so all of the faces are found in O(E log E) where the sorting is the most expensive part.
+ * 			Loops that are oriented CCW (positive area) are the faces that are needed for meshing. Loops that are oriented CW are the outside
+ * 			boundaries of the geometry and are not returned. Edges that do not form part of a closed loop (the same face is on both sides of the edge)
+ * 			are removed from the loops.
+ */
+class planarGraph
+{
+private:
+	/**
+	 * @brief One direction of a line or an arc
+	 */
+	struct halfEdge
+	{
+		//! The edge that the half-edge represents
+		edgeLineShape *edge;
+
+		//! The index of the node that the half-edge leaves from
+		unsigned int origin;
+
+		//! The index of the half-edge going in the opposite direction
+		unsigned int twin;
+
+		//! The index of the next half-edge around the face that is to the left of this half-edge
+		unsigned int next;
+
+		//! Boolean used to indicate if the half-edge goes from the first node to the second node of the edge
+		bool isForward;
+
+		//! The angle (in radians) that the half-edge leaves the origin at
+		double angle;
+
+		//! The curvature of the half-edge. Positive if the half-edge turns left. This is used when two half-edges leave at the same angle
+		double curvature;
+	};
+
+	//! The nodes of the geometry. The index of the node in this vector is used by the half-edges
+	std::vector<node*> p_nodes;
+
+	//! All of the half-edges. The two half-edges of one edge are always next to each other
+	std::vector<halfEdge> p_halfEdges;
+
+	//! The loops of half-edges that form the faces of the geometry. Each loop is in CCW order
+	std::vector<std::vector<unsigned int>> p_faces;
+
+	//! The area of each of the faces
+	std::vector<double> p_faceAreas;
+
+	//! The number of edges that were removed because they did not form part of a closed loop
+	unsigned long p_numberOfOpenEdges = 0;
+
+	/**
+	 * @brief Adds the two half-edges of an edge to the graph. This will also compute the direction that the half-edges leave the nodes at
+	 * @param edge The edge that is to be added
+	 * @param nodeIndex The map of the nodes that have already been added to the graph
+	 */
+	void addEdge(edgeLineShape *edge, std::unordered_map<node*, unsigned int> &nodeIndex);
+
+	/**
+	 * @brief Sorts the half-edges around each node and links each half-edge to the next half-edge around its face
+	 */
+	void linkHalfEdges();
+
+	/**
+	 * @brief Traces out all of the loops of half-edges. Edges that have the same loop on both sides are removed and loops that
+	 * 			touch themselves at a node are split. Only the loops that have a positive area are stored as faces
+	 */
+	void traceFaces();
+
+	/**
+	 * @brief Computes the signed area of a loop of half-edges. For arcs, the area between the chord and the arc is included
+	 * @param loop The loop of half-edges
+	 * @return Returns the area. This is positive if the loop is CCW and negative if the loop is CW
+	 */
+	double getSignedArea(const std::vector<unsigned int> &loop);
+
+public:
+
+	/**
+	 * @brief 	Builds the half-edge structure from the lines and arcs of the geometry and finds all of the faces.
+	 * 			Hidden lines and arcs are not included
+	 * @param lineList The list of lines in the geometry
+	 * @param arcList The list of arcs in the geometry
+	 */
+	void build(plf::colony<edgeLineShape> &lineList, plf::colony<arcShape> &arcList);
+
+	/**
+	 * @brief Retrieves the number of faces that were found
+	 * @return Returns the number of faces
+	 */
+	size_t getNumberOfFaces()
+	{
+		return p_faces.size();
+	}
+
+	/**
+	 * @brief Retrieves the area of one of the faces. The area does not subtract any holes
+	 * @param index The index of the face
+	 * @return Returns the area of the face
+	 */
+	double getFaceArea(size_t index)
+	{
+		return p_faceAreas.at(index);
+	}
+
+	/**
+	 * @brief Creates a closed path for one of the faces. The edges of the closed path are in order around the face
+	 * @param index The index of the face
+	 * @return Returns the closed path of the face
+	 */
+	closedPath getFacePath(size_t index);
+
+	/**
+	 * @brief Retrieves the number of edges that were not part of any closed loop
+	 * @return Returns the number of lines and arcs that do not form a closed contour
+	 */
+	unsigned long getNumberOfOpenEdges()
+	{
+		return p_numberOfOpenEdges;
+	}
+};
+
+#endif
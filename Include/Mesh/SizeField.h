@@ -0,0 +1,103 @@
+#ifndef SIZE_FIELD_H_
+#define SIZE_FIELD_H_
+
+#include <vector>
+
+#include <Mesh/GMSH/Field.h>
+#include <Mesh/GMSH/GEntity.h>
+
+
+/**
+ * @class sizeField
+ * @author Phillip
+ * @date 17/10/26
+ * @file SizeField.h
+ * @brief 	A GMSH background field that gives the element size from the values at the nodes of an earlier mesh. The field keeps its own
+ * 			copy of the triangles of the earlier mesh (quadrilaterals are split into two triangles and only the corner nodes of high order
+ * 			elements are used) so it stays valid after GMSH deletes the mesh that it came from. The value at each node is the inverse of the
+ * 			element size (the density) where a density of 0 means that the field does not limit the size there. The density is interpolated
+ * 			linearly over the triangles so a node that needs small elements next to a node without a limit grades the size over one of the
+ * 			earlier elements. The triangles are put in a uniform grid of buckets so that finding the triangle at a point only looks at the
+ * 			triangles of one bucket. The field is read only once it is created so the faces can be meshed by several threads at once.
+ */
+class sizeField : public Field
+{
+private:
+	//! The x coordinate of each node in the units of the geometry
+	std::vector<double> p_x;
+
+	//! The y coordinate of each node in the units of the geometry
+	std::vector<double> p_y;
+
+	//! The inverse of the element size at each node. 0 if the size is not limited at the node
+	std::vector<double> p_density;
+
+	//! The nodes of the triangles. Triangle i uses the nodes from 3 * i to 3 * i + 2
+	std::vector<int> p_triangles;
+
+	//! The triangles of bucket b are p_bucketTriangles[p_bucketOffset[b]] to p_bucketTriangles[p_bucketOffset[b + 1] - 1]
+	std::vector<int> p_bucketOffset;
+
+	//! The triangles that overlap each bucket
+	std::vector<int> p_bucketTriangles;
+
+	//! The lower left corner of the grid of buckets
+	double p_minimumX = 0, p_minimumY = 0;
+
+	//! The inverse of the width and the height of one bucket
+	double p_inverseBucketWidth = 1, p_inverseBucketHeight = 1;
+
+	//! The number of buckets along x and along y
+	int p_numberOfColumns = 0, p_numberOfRows = 0;
+
+	/**
+	 * @brief Finds the bucket that a point is in. Points outside of the grid are moved to the closest bucket
+	 * @param x The x coordinate of the point
+	 * @param y The y coordinate of the point
+	 * @param column Returns the column of the bucket
+	 * @param row Returns the row of the bucket
+	 */
+	void getBucket(double x, double y, int &column, int &row) const;
+
+public:
+	/**
+	 * @brief Creates the field and sorts the triangles into the buckets
+	 * @param x The x coordinate of each node in the units of the geometry
+	 * @param y The y coordinate of each node in the units of the geometry
+	 * @param density The inverse of the element size at each node. 0 if the size is not limited at the node
+	 * @param triangles The nodes of the triangles. Triangle i uses the nodes from 3 * i to 3 * i + 2
+	 */
+	sizeField(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &density, const std::vector<int> &triangles);
+
+	/**
+	 * @brief Interpolates the density at a point. Points that are outside of all of the triangles take the value of the closest
+	 * triangle of the bucket that they are in
+	 * @param x The x coordinate of the point
+	 * @param y The y coordinate of the point
+	 * @return Returns the inverse of the element size at the point. 0 if the size is not limited
+	 */
+	double getDensity(double x, double y) const;
+
+	/**
+	 * @brief The function that GMSH calls for the size of the elements at a point
+	 * @return Returns the element size at the point. MAX_LC if the size is not limited
+	 */
+	virtual double operator()(double x, double y, double z, GEntity *ge = 0)
+	{
+		const double density = getDensity(x, y);
+
+		return (density > 0) ? 1.0 / density : MAX_LC;
+	}
+
+	virtual const char *getName()
+	{
+		return "Adaptive";
+	}
+
+	virtual std::string getDescription()
+	{
+		return "The element size that the adaptive refinement found from the error of the solution";
+	}
+};
+
+#endif
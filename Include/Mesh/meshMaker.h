@@ -8,7 +8,7 @@
 #include <iterator>
 
 #include <UI/geometryShapes.h>
-#include <UI/ModelDefinition/ModelDefinition.h>
+#include <UI/GeometryEditor2D.h>
 
 #include <common/plfcolony.h>
 #include <common/Vector.h>
@@ -21,9 +21,13 @@
 
 #include <Mesh/ClosedPath.h>
 #include <Mesh/BoundingBox.h>
+#include <Mesh/PlanarGraph.h>
+#include <Mesh/ContainmentTree.h>
+#include <Mesh/MeshExporter.h>
 
 #include <Mesh/GMSH/Gmsh.h>
 #include <Mesh/GMSH/Context.h>
+#include <Mesh/GMSH/GEntity.h>
 #include <Mesh/GMSH/GVertex.h>
 #include <Mesh/GMSH/GEdge.h>
 #include <Mesh/GMSH/GFace.h>
@@ -51,6 +55,9 @@ private:
 	//! The master list of all of te closed contours found in the geometry
 	std::vector<closedPath> p_closedContourPaths;
 	
+	//! The tree used to find which closed contours are inside of which and which contour a block label is in
+	containmentTree p_containmentTree;
+	
 	//! Pointer to the global nodal list
 	plf::colony<node> *p_nodeList;
 	
@@ -75,86 +82,64 @@ private:
 	//! A pointer to the GMSH model
 	GModel *p_meshModel;
 	
-	//! This is the total number of lines within the geometry. This is the number of lines and arcs
-	unsigned long p_numberofLines = 0;
-	
-	//! A counter to keep track of the number of visited edges during the findContour algorithm.
-	unsigned long p_numberVisited = 0;
-	
 	//! A number to specify the number of block labels that the program used. Used to check if there are any forgotten labels
 	unsigned int p_blockLabelsUsed = 0;
 	
 	/**
-	 * @brief 	This algorithm is called in order to find 1 closed contour. If the first parameter is null, then the algorithm
-	 * 			will start at the first avaiable edge in the lineList as the starting edge. If none exists, then the algorithm will look in the 
-	 * 			arc list for the starting edge. The algorithm will then run a modified version of the Dijkstra's algorithm where the 
-	 * 			program will look for the shortest path to loop back on itself. If the second parameter is not null, then the 
-	 * 			algorithm will look for the shortest path that encompasses a point.
-	 * @param startingEdge Parameter that specifies which edge to start with. If null, the algorithm will look in the lineList for the starting edge
-	 * @param point Parameter that specifies a point that the closed contour will need to encompass around. If null, then find the shortest path.
-	 * @return Returns a closed contour path of the shortest distance to loop back on itself. Will return a path of 0 distance if no path could be found.
-	 */
-	closedPath findContour(edgeLineShape *startingEdge = nullptr, rectangleShape *point = nullptr);
-	
-	/**
-	 * @brief This function will take a edge segment and find all of the banches that are connected to that edge and return as a vector
-	 * @param currentSegment The line segment that the program will find the connected branches to
-	 * @param pathVector The path list that contains the currentSegment
-	 * @return Returns a vector containing all of the connected branches to the segment
+	 * @brief 	This algorithm is called in order to find all of the closed contours (faces) within the geometry. The lines and arcs
+	 * 			are put into a planar graph and all of the smallest faces are traced out of the graph at once. The faces are stored
+	 * 			in the master list of closed paths
 	 */
-	std::vector<edgeLineShape*> getConnectedPaths(std::vector<edgeLineShape*>::reference currentSegment, std::vector<edgeLineShape*> *pathVector);
+	void findContours();
 	
 	/**
 	 * @brief This algorithm will take a vector of closed paths and convert the closed path into the GMSH geometry face.
 	 * If the parameter is null, then the function will operate on the master list of the closed paths. This function will always
 	 * operate on the mesh model in order to add faces to GMSH. This function will add in the closed path, the holes, and set the mesh 
-	 * settings of the face. For an edge that is shared by 2 or more faces, this algorithm will create duplicates of the edge
-	 * in order to ensure that the edge has the correct mesh size setting for the corresponding face. If the closed path does
-	 * not have an assigned mesh size to it, then the closed path will not be converted into the GMSH geometry.
+	 * settings of the face. An edge that is shared by 2 or more faces is only created once so that the mesh is conforming
+	 * across the faces. The edge takes on the finest mesh size of the faces. The material (and circuit) of the face is added
+	 * as a physical group of the face. If the closed path does not have an assigned mesh size to it, then the closed path 
+	 * will not be converted into the GMSH geometry.
 	 * @param pathContour A pointer to the list that the algorithm will operate on. If null, the algorithm will default to the master list.
 	 */
 	void createGMSHGeometry(std::vector<closedPath> *pathContour = nullptr);
 	
 	/**
-	 * @brief Algorithm that is ran in order to locate the holes of a closed contour. This alogorithm will first 
-	 * locate all of the holes and then find the top level holes belonging to the closed contour. This is a requirement
-	 * imposed by GMSH. Additionally, there holes are unable to share a common edge. If a common edge exists, then the
-	 * algorithm will create a new hole with the common edge removed. This algorithm will operate on the pathContour
-	 * pointer.
-	 * @param pathContour Pointer pointing to the closed path to operate on. If null, algorithm will operate on the master list.
+	 * @brief Returns the GMSH edge of a line or arc. If the edge was already created for another face, the same GEdge is returned
+	 * and the mesh size of the GEdge is lowered if the face needs a finer mesh. Otherwise, the GEdge is created and the boundary
+	 * and conductor of the segment are added as physical groups of the GEdge
+	 * @param edge The line or arc of the geometry
+	 * @param property The block property of the face that the edge is being added to
+	 * @param createdEdges The edges that have already been created
+	 * @return Returns the GEdge of the line or arc
 	 */
-	void holeDetection(std::vector<closedPath> *pathContour = nullptr);
+	GEdge *getGMSHEdge(edgeLineShape *edge, blockProperty *property, std::map<edgeLineShape*, GEdge*> &createdEdges);
 	
 	/**
-	 * @brief This algorithm will run in order to detect the block label that belongs to the closed path. 
-	 * If more then one block label is inside of the closed path, the algorithm will determine which block labels are 
-	 * in the holes and locate the first block label outside of the holes. Once detected, it will assign the 
-	 * mesh settings of the block label to the closed path. THe algorithm will operate on the pathContour pointer.
-	 * @param pathContour Pointer pointing to the closed path to operate on. If null, algorithm will operate on the master list.
+	 * @brief Adds a GMSH entity to the physical group with the given name. The group is created if it does not exist yet.
+	 * The groups are what the solvers use in order to find the material, boundary condition, nodal property, and conductor
+	 * of the mesh elements
+	 * @param entity The GMSH vertex, edge, or face
+	 * @param name The name of the group
 	 */
-	void assignBlockLabel(std::vector<closedPath> *pathContour = nullptr);
+	void addPhysicalGroup(GEntity *entity, std::string name);
 	
 	/**
-	 * @brief Function that is used in order to check if a closed path is actually a closed path
-	 * @param pathEdges Vector of the edge list that will be checked
-	 * @return Returns true if the last element in the vector is connected to the first element forming a closed path. Otherwise, returns false
+	 * @brief Algorithm that is ran in order to locate the holes of the closed contours in the master list. The containment
+	 * tree is built over the master list and the paths that are directly inside of a closed contour become the top level 
+	 * holes of the contour. This is a requirement imposed by GMSH. Additionally, there holes are unable to share a common edge. 
+	 * If a common edge exists, then the algorithm will create a new hole with the common edge removed.
 	 */
-	bool isClosedPath(std::vector<edgeLineShape*> pathEdges)
-	{
-		edgeLineShape beginEdge = *(*pathEdges.begin());
-		edgeLineShape lastEdge = *(*pathEdges.rbegin());
-		
-		if(pathEdges.size() > 1)
-		{
-			if(beginEdge.getFirstNodeID() == lastEdge.getFirstNodeID() || beginEdge.getFirstNodeID() == lastEdge.getSecondNodeID() ||
-				beginEdge.getSecondNodeID() == lastEdge.getFirstNodeID() || beginEdge.getSecondNodeID() == lastEdge.getSecondNodeID())
-				return true;
-			else
-				return false;
-		}
-		else
-			return false;
-	}
+	void holeDetection();
+	
+	/**
+	 * @brief This algorithm will run in order to detect the closed contour that each block label belongs to. The containment
+	 * tree is used to find the smallest closed contour that contains the label. Since the contours are the faces of the geometry,
+	 * this is the contour that the label is in. The mesh settings of the first label found in a contour are assigned to the contour. 
+	 * Any other labels in the same contour and any labels outside of the geometry are reported to the user. The
+	 * holeDetection function must be called first in order to build the containment tree.
+	 */
+	void assignBlockLabel();
 	
 	/**
 	 * @brief This function will take two paths and determine if there are any common edges between the two paths. If so,
@@ -199,20 +184,20 @@ private:
 public:
 	
 	/**
-	 * @brief The constructor for the class
+	 * @brief 	The constructor for the class. The mesher only needs the geometry and the GMSH model so that the mesh can
+	 * 			be created without the canvas (for example, by the batch program)
 	 * @param definition Reference to the problem defintion class needed for the settings, name, and save file path
-	 * @param model Pointer to the model definition needed for the mesh model, node list, line list, arc list, and block label list
+	 * @param editor The geometry editor that holds the node list, line list, arc list, and block label list
+	 * @param meshModel Pointer to the GMSH model that the mesh is created in. This should not contain any geometry yet
 	 */
-	meshMaker(problemDefinition &definition, modelDefinition *model)
+	meshMaker(problemDefinition &definition, geometryEditor2D &editor, GModel *meshModel)
 	{
-		p_meshModel = model->getMeshModel();
-		
-		p_nodeList = model->getModelNodeList();
-		p_blockLabelList = model->getModelBlockList();
-		p_lineList = model->getModelLineList();
-		p_arcList = model->getModelArcList();
+		p_meshModel = meshModel;
 		
-		p_numberofLines = p_lineList->size() + p_arcList->size();
+		p_nodeList = editor.getNodeList();
+		p_blockLabelList = editor.getBlockLabelList();
+		p_lineList = editor.getLineList();
+		p_arcList = editor.getArcList();
 		
 		p_settings = definition.getMeshSettingsPointer();
 		p_simulationName = definition.getName();
@@ -229,6 +214,48 @@ public:
 	 */
 	void mesh();
 	
+	/**
+	 * @brief The conductors share a namespace with the boundary conditions and the nodal properties in the physical groups
+	 * of the mesh. So, the name of the group of a conductor is prefixed in order to keep the two apart
+	 * @param conductorName The name of the conductor
+	 * @return Returns the name of the physical group of the conductor
+	 */
+	static std::string getConductorGroupName(std::string conductorName)
+	{
+		return "Conductor: " + conductorName;
+	}
+	
+	/**
+	 * @brief Same as the conductor, the circuits are prefixed in order to keep the circuit apart from the material of a face
+	 * @param circuitName The name of the circuit
+	 * @return Returns the name of the physical group of the circuit
+	 */
+	static std::string getCircuitGroupName(std::string circuitName)
+	{
+		return "Circuit: " + circuitName;
+	}
+	
+	/**
+	 * @brief The number of turns and the direction of magnetization belong to the block label and not to the material. So, these
+	 * are passed on to the solvers as physical groups of the face as well. All of the faces with the same value share the group
+	 * @param numberOfTurns The number of turns of the coil of the block label
+	 * @return Returns the name of the physical group of the number of turns
+	 */
+	static std::string getTurnsGroupName(double numberOfTurns)
+	{
+		return "Turns: " + std::to_string(numberOfTurns);
+	}
+	
+	/**
+	 * @brief Same as the number of turns but for the direction of magnetization of the block label
+	 * @param magnetization The direction of magnetization in degrees
+	 * @return Returns the name of the physical group of the direction of magnetization
+	 */
+	static std::string getMagnetizationGroupName(std::string magnetization)
+	{
+		return "Magnetization: " + magnetization;
+	}
+	
 	~meshMaker()
 	{
 		//free(p_nodeList);
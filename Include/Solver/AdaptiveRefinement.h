@@ -0,0 +1,112 @@
+#ifndef ADAPTIVE_REFINEMENT_H_
+#define ADAPTIVE_REFINEMENT_H_
+
+#include <vector>
+
+#include <common/ProblemDefinition.h>
+#include <common/MeshSettings.h>
+#include <common/OmniFEMMessage.h>
+#include <common/OS.h>
+
+#include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/Field.h>
+#include <Mesh/SizeField.h>
+
+#include <Solver/SolverMesh.h>
+#include <Solver/ErrorEstimator.h>
+#include <Solver/ElectrostaticSolver.h>
+#include <Solver/MagnetostaticSolver.h>
+
+
+/**
+ * @class adaptiveRefinement
+ * @author Phillip
+ * @date 17/10/26
+ * @file AdaptiveRefinement.h
+ * @brief 	Solves the problem, estimates the error of each element, and remeshes the geometry until the error is below the tolerance of the
+ * 			mesh settings. The error is measured in the energy norm with the Zienkiewicz-Zhu estimator. The error is spread evenly over the
+ * 			elements of the final mesh: each element is allowed tolerance^2 * (energy + error) / (number of elements). Elements with more error than
+ * 			that get a smaller size from the convergence rate of the element (the error goes down with the size to the power of the element order).
+ * 			The sizes are passed to GMSH as a background field on the nodes of the mesh that was solved. The field of one pass is kept in the
+ * 			next pass so only the elements that need it are made smaller and the rest of the geometry keeps the sizes of the mesh that the user
+ * 			created. Faces without any refinement (and with edges that are not refined) are meshed the same way as before.
+ */
+class adaptiveRefinement
+{
+private:
+	//! The smallest factor that the size of an element is multiplied by in one pass
+	const double p_maximumReduction = 0.25;
+
+	//! The problem that is solved
+	problemDefinition *p_definition;
+
+	//! The GMSH model that holds the geometry and the mesh
+	GModel *p_model;
+
+	//! The relative error in the energy norm that the refinement stops at
+	double p_tolerance;
+
+	//! The largest number of solves
+	unsigned int p_maximumPasses;
+
+	//! The size field of the last refinement. This is owned by the field manager of the GMSH model. Null if the mesh was not refined yet
+	sizeField *p_field = nullptr;
+
+	//! The estimated relative error of each pass
+	std::vector<double> p_relativeErrors;
+
+	//! The number of elements of each pass
+	std::vector<int> p_numberOfElements;
+
+	/**
+	 * @brief Runs the loop of solving, estimating, and remeshing
+	 * @param scale The factor that converts the units of the geometry into meters
+	 * @return Returns the solver of the last pass. Null if a solve failed
+	 */
+	template<class solverType>
+	solverType *run(double scale);
+
+	/**
+	 * @brief Finds the new element sizes from the error of each element and sets them as the background field of the GMSH model
+	 * @param mesh The mesh that was solved
+	 * @param estimator The estimator that holds the error of each element of the mesh
+	 * @param scale The factor that converts the units of the geometry into meters
+	 * @return Returns false if none of the elements need to be refined
+	 */
+	bool refine(solverMesh *mesh, const errorEstimator &estimator, double scale);
+
+	//! Deletes the mesh of the GMSH model and meshes the geometry again with the background field
+	void remesh();
+
+public:
+	/**
+	 * @brief Creates the refinement. The tolerance and the number of passes come from the mesh settings of the problem
+	 * @param definition The problem definition that holds the materials, boundary conditions, preferences, and mesh settings
+	 * @param model The GMSH model that has been meshed by the meshMaker
+	 */
+	adaptiveRefinement(problemDefinition &definition, GModel *model);
+
+	/**
+	 * @brief Runs the refinement for an electrostatic problem
+	 * @return Returns the solver of the final mesh. The caller owns the solver. Null if a solve failed
+	 */
+	electrostaticSolver *solveElectrostatic();
+
+	/**
+	 * @brief Runs the refinement for a magnetostatic problem
+	 * @return Returns the solver of the final mesh. The caller owns the solver. Null if a solve failed
+	 */
+	magnetostaticSolver *solveMagnetostatic();
+
+	const std::vector<double> &getRelativeErrors() const
+	{
+		return p_relativeErrors;
+	}
+
+	const std::vector<int> &getNumberOfElements() const
+	{
+		return p_numberOfElements;
+	}
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef BH_CURVE_H_
+#define BH_CURVE_H_
+
+#include <vector>
+#include <algorithm>
+#include <math.h>
+
+#include <common/JilesAthertonParameters.h>
+
+
+/**
+ * @class bhCurve
+ * @author Phillip
+ * @date 17/10/26
+ * @file BHCurve.h
+ * @brief 	The B-H curve of a nonlinear magnetic material in the form that the Newton-Raphson solver needs. The 2D magnetostatic
+ * 			problem is written in terms of the reluctivity nu(B^2) = H / B and its derivative with respect to B^2 at every
+ * 			Gauss point of every Newton iteration. Evaluating the curve has to be cheap. So, the points of the B-H curve are first
+ * 			joined by a monotone cubic (Fritsch-Carlson) so that H always increases with B. The relative reluctivity mu0 * nu is then
+ * 			sampled on a uniform grid in B^2. A lookup is one multiplication to find the interval and one linear interpolation. Inside of
+ * 			each interval, the reluctivity is linear in B^2 so the derivative that is returned is the exact derivative of the value that
+ * 			is returned. This keeps the Jacobian of the Newton-Raphson consistent with the residual. The samples are limited such that
+ * 			nu + 2 B^2 dnu/dB^2 stays positive. This is the slope dH/dB of the sampled curve, which keeps the Jacobian positive definite.
+ * 			Past the last point of the curve, the material is taken to be saturated (dB/dH = mu0).
+ */
+class bhCurve
+{
+private:
+	//! The permeability of free space in H/m
+	const double p_vacuumPermeability = 4e-7 * M_PI;
+
+	//! The number of intervals of the table in B^2
+	static const int p_tableSize = 2048;
+
+	//! The relative reluctivity at the samples. Sample k is at B^2 = k * p_step
+	std::vector<double> p_reluctivity;
+
+	//! The spacing of the samples in B^2 (T^2)
+	double p_step = 1;
+
+	//! The inverse of the spacing of the samples in B^2
+	double p_inverseStep = 1;
+
+	//! The largest B^2 of the table
+	double p_maximumFluxSquared = 1;
+
+	//! The flux density at the end of the table (T)
+	double p_maximumFlux = 1;
+
+	//! mu0 * H - B at the end of the table (T). Past the end, the relative reluctivity is 1 + p_saturationOffset / B
+	double p_saturationOffset = 0;
+
+	/**
+	 * @brief Evaluates the monotone cubic through the points of the B-H curve
+	 * @param flux The points of the curve. The flux density B in T
+	 * @param field The points of the curve. The field intensity H in A/m
+	 * @param slope The slope dH/dB at the points
+	 * @param value The flux density where the curve is evaluated
+	 * @param derivative Returns the slope dH/dB at the flux density
+	 * @return Returns the field intensity at the flux density
+	 */
+	static double evaluateCubic(const std::vector<double> &flux, const std::vector<double> &field, const std::vector<double> &slope, double value, double &derivative);
+
+public:
+	/**
+	 * @brief Creates the curve from points of the B-H curve. The points do not need to start at the origin. Points where B
+	 * or H does not increase are skipped
+	 * @param flux The flux density B of the points in T
+	 * @param field The field intensity H of the points in A/m
+	 */
+	bhCurve(const std::vector<double> &flux, const std::vector<double> &field);
+
+	/**
+	 * @brief Samples the anhysteretic magnetization curve of the Jiles-Atherton model. This is the curve that the hysteresis loops
+	 * close around: M = Ms * L((H + alpha * M) / a) where L is the Langevin function. The X parameters of the model are used. The fill
+	 * factor mixes the material with air for laminations that are in the plane of the problem: B = mu0 * (H + fillFactor * M)
+	 * @param parameters The Jiles-Atherton parameters of the material
+	 * @param fillFactor The fraction of the region that is filled by the material
+	 * @param flux Returns the flux density of the points in T
+	 * @param field Returns the field intensity of the points in A/m
+	 * @return Returns false if the parameters do not describe a curve (Ms or a are not positive)
+	 */
+	static bool getAnhystereticCurve(jilesAthertonParameters &parameters, double fillFactor, std::vector<double> &flux, std::vector<double> &field);
+
+	/**
+	 * @brief Looks up the relative reluctivity (mu0 * nu) and its derivative
+	 * @param fluxSquared The square of the flux density in T^2
+	 * @param reluctivity Returns mu0 * nu
+	 * @param derivative Returns the derivative of mu0 * nu with respect to B^2
+	 */
+	void evaluate(double fluxSquared, double &reluctivity, double &derivative) const
+	{
+		if(fluxSquared < p_maximumFluxSquared)
+		{
+			const double position = fluxSquared * p_inverseStep;
+			const int index = std::min((int)position, p_tableSize - 1);
+			const double lower = p_reluctivity[index];
+			const double difference = p_reluctivity[index + 1] - lower;
+
+			reluctivity = lower + (position - index) * difference;
+			derivative = difference * p_inverseStep;
+		}
+		else
+		{
+			const double flux = sqrt(fluxSquared);
+
+			reluctivity = 1.0 + p_saturationOffset / flux;
+			derivative = -0.5 * p_saturationOffset / (flux * fluxSquared);
+		}
+	}
+
+	/**
+	 * @brief Retrieves the relative permeability of the material at zero field
+	 * @return Returns the initial relative permeability
+	 */
+	double getInitialPermeability() const
+	{
+		return 1.0 / p_reluctivity[0];
+	}
+};
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef COLORED_ASSEMBLY_H_
+#define COLORED_ASSEMBLY_H_
+
+#include <vector>
+#include <algorithm>
+
+#include <Mesh/GMSH/dofManager.h>
+
+#include <Solver/SolverMesh.h>
+#include <Solver/PotentialConstraints.h>
+
+
+/**
+ * @class coloredAssembly
+ * @author Phillip
+ * @date 17/10/26
+ * @file ColoredAssembly.h
+ * @brief 	Drives the assembly of the elements of the faces of a solver mesh into a dofManager. The symbolic pass inserts every element into
+ * 			the sparsity pattern once. The numeric pass goes through the colors of each block one after the other and splits the elements
+ * 			of a color into batches that are computed on different threads. No two elements of the same color share a node so the threads
+ * 			never add into the same row of the matrix. The elements that touch a tied node add into the row of the node that they are tied to.
+ * 			That node can be shared with an element of the same color so these elements are assembled on one thread after the colors.
+ * 			The solver only has to compute the element matrices and add them in.
+ */
+class coloredAssembly
+{
+private:
+	//! The mesh that is assembled
+	solverMesh *p_mesh;
+
+	//! The number of elements that one thread computes at a time
+	int p_batchSize;
+
+	//! The index of the first element of each block in the sparsity pattern
+	std::vector<int> p_blockStart;
+
+	//! The block and the index within the block of the elements that touch a tied node
+	std::vector<std::pair<int, int>> p_tiedElements;
+
+	//! Set to true for each element of the sparsity pattern that touches a tied node
+	std::vector<bool> p_isTiedElement;
+
+public:
+	/**
+	 * @brief Creates the assembly driver
+	 * @param mesh The mesh that is assembled
+	 * @param batchSize The number of elements that one thread computes at a time
+	 */
+	coloredAssembly(solverMesh *mesh, int batchSize) : p_mesh(mesh), p_batchSize(batchSize)
+	{
+	}
+
+	/**
+	 * @brief Symbolic pass. Inserts each element of the faces into the sparsity pattern. The elements of each block are inserted in
+	 * the order of the block so the element e of block b is at getBlockStart(b) + e in the pattern. The pattern is not finalized so
+	 * that the solver can insert more elements after the faces
+	 * @param dofs The dofManager. The constraints must already be applied
+	 * @param constraints The constraints of the unknowns. These are used to find the elements that touch a tied node
+	 * @param regionDofs If not empty, the elements of region r also couple to Dof(regionDofs[r], 1) when regionDofs[r] is not -1
+	 */
+	template<class T> void createPattern(dofManager<T> &dofs, potentialConstraints &constraints, const std::vector<int> &regionDofs = std::vector<int>())
+	{
+		std::vector<solverMesh::elementBlock> &blocks = *p_mesh->getElementBlocks();
+		std::vector<Dof> R;
+
+		p_blockStart.assign(blocks.size(), 0);
+		p_tiedElements.clear();
+		p_isTiedElement.clear();
+
+		for(unsigned int b = 0; b < blocks.size(); b++)
+		{
+			const int n = blocks[b].numberOfNodes;
+			const int numberOfElements = blocks[b].regions.size();
+
+			p_blockStart[b] = dofs.getNumPatternElements();
+
+			for(int e = 0; e < numberOfElements; e++)
+			{
+				bool isTied = false;
+
+				R.clear();
+
+				for(int i = 0; i < n; i++)
+				{
+					const int node = blocks[b].nodes[e * n + i];
+
+					R.push_back(Dof(node, 0));
+					isTied = isTied || constraints.isTied(node);
+				}
+
+				if(!regionDofs.empty() && regionDofs[blocks[b].regions[e]] != -1)
+					R.push_back(Dof(regionDofs[blocks[b].regions[e]], 1));
+
+				dofs.insertElementInPattern(R);
+				p_isTiedElement.push_back(isTied);
+
+				if(isTied)
+					p_tiedElements.push_back(std::make_pair(b, e));
+			}
+		}
+	}
+
+	/**
+	 * @brief Numeric pass. The elements are computed in batches and added in one at a time. The matrices and vectors of a batch are
+	 * stored with a stride of the number of nodes of the element plus the extra size
+	 * @param extraSize The number of unknowns of an element besides its nodes
+	 * @param allowParallel Set to false to assemble every color on one thread
+	 * @param compute Computes a run of elements of a block: compute(block, blockIndex, first, count, buffer, matrices, vectors). The
+	 * buffer is scratch space that belongs to the thread
+	 * @param assemble Adds one element: assemble(block, element, patternIndex, matrix, vector)
+	 */
+	template<class T, class ComputeFunction, class AssembleFunction>
+	void assemble(int extraSize, bool allowParallel, ComputeFunction compute, AssembleFunction assemble)
+	{
+		std::vector<solverMesh::elementBlock> &blocks = *p_mesh->getElementBlocks();
+
+		for(unsigned int b = 0; b < blocks.size(); b++)
+		{
+			const solverMesh::elementBlock &block = blocks[b];
+			const int stride = block.numberOfNodes + extraSize;
+
+			for(unsigned int color = 0; color + 1 < block.colorOffset.size(); color++)
+			{
+				const int colorStart = block.colorOffset[color];
+				const int colorEnd = block.colorOffset[color + 1];
+				const int numberOfBatches = (colorEnd - colorStart + p_batchSize - 1) / p_batchSize;
+				const bool isParallel = allowParallel && ((int)color != block.serialColor);
+
+#if defined(_OPENMP)
+#pragma omp parallel if(isParallel)
+#endif
+				{
+					std::vector<double> buffer;
+					std::vector<T> matrices(p_batchSize * stride * stride);
+					std::vector<T> vectors(p_batchSize * stride);
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+					for(int batch = 0; batch < numberOfBatches; batch++)
+					{
+						const int first = colorStart + batch * p_batchSize;
+						const int count = std::min(p_batchSize, colorEnd - first);
+
+						compute(block, (int)b, first, count, buffer, &matrices[0], &vectors[0]);
+
+						for(int e = 0; e < count; e++)
+						{
+							const int patternIndex = p_blockStart[b] + first + e;
+
+							if(p_isTiedElement[patternIndex])
+								continue;
+
+							assemble(block, first + e, patternIndex, &matrices[e * stride * stride], &vectors[e * stride]);
+						}
+					}
+				}
+			}
+		}
+
+		std::vector<double> buffer;
+
+		for(auto elementIterator = p_tiedElements.begin(); elementIterator != p_tiedElements.end(); elementIterator++)
+		{
+			const solverMesh::elementBlock &block = blocks[elementIterator->first];
+			const int stride = block.numberOfNodes + extraSize;
+			std::vector<T> matrix(stride * stride);
+			std::vector<T> vector(stride);
+
+			compute(block, elementIterator->first, elementIterator->second, 1, buffer, &matrix[0], &vector[0]);
+			assemble(block, elementIterator->second, p_blockStart[elementIterator->first] + elementIterator->second, &matrix[0], &vector[0]);
+		}
+	}
+
+	/**
+	 * @brief Retrieves where the elements of a block start in the sparsity pattern. This is also where the elements of the block start
+	 * in the arrays of the results of the elements
+	 * @param block The index of the block
+	 * @return Returns the index of the first element of the block
+	 */
+	int getBlockStart(int block) const
+	{
+		return p_blockStart[block];
+	}
+};
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef ELECTROSTATIC_SOLVER_H_
+#define ELECTROSTATIC_SOLVER_H_
+
+#include <vector>
+#include <string>
+#include <map>
+
+#include <common/ProblemDefinition.h>
+#include <common/ElectroStaticMaterial.h>
+#include <common/ElectricalBoundary.h>
+#include <common/ConductorProperty.h>
+#include <common/NodalProperty.h>
+#include <common/ElectrostaticPreference.h>
+#include <common/OmniFEMMessage.h>
+#include <common/OS.h>
+
+#include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/dofManager.h>
+#include <Mesh/GMSH/linearSystemCSR.h>
+
+#include <Solver/SolverMesh.h>
+#include <Solver/ElementKernels.h>
+#include <Solver/PotentialConstraints.h>
+
+
+/**
+ * @class electrostaticSolver
+ * @author Phillip
+ * @date 17/10/26
+ * @file ElectrostaticSolver.h
+ * @brief 	Solves the planar or axisymmetric electrostatic problem -div(epsilon grad(V)) = rho on the mesh that was created
+ * 			by the meshMaker. The equation is divided through by the permittivity of free space so that the matrix is in terms
+ * 			of the relative permittivity. The materials, boundary conditions, nodal properties, and conductors are found through the
+ * 			physical groups that the meshMaker assigns to the GMSH entities. The matrix is assembled with the two pass assembly of the
+ * 			dofManager. The elements of each color of the mesh are assembled by all of the threads at once. The system is solved
+ * 			with the conjugate gradient method of linearSystemCSRIterative.
+ * 			Conductors with a fixed voltage fix all of their nodes. Conductors with a total charge tie all of their nodes to one extra unknown
+ * 			which is the voltage of the conductor. The charge is the source of that unknown. Periodic and anti-periodic boundaries tie the nodes
+ * 			of the two edges of the boundary together. Mixed boundaries are not supported yet.
+ */
+class electrostaticSolver
+{
+private:
+	//! The permittivity of free space in F/m
+	const double p_vacuumPermittivity = 8.8541878128e-12;
+
+	//! The number of elements that one thread computes at a time
+	static const int p_batchSize = 64;
+
+	//! The GMSH model that holds the mesh
+	GModel *p_model;
+
+	//! The mesh that the solver operates on. This is created when the solver is ran
+	solverMesh *p_mesh = nullptr;
+
+	//! The materials of the problem
+	std::vector<electrostaticMaterial> p_materials;
+
+	//! The boundary conditions of the problem
+	std::vector<electricalBoundary> p_boundaries;
+
+	//! The conductors of the problem
+	std::vector<conductorProperty> p_conductors;
+
+	//! The nodal properties of the problem
+	std::vector<nodalProperty> p_nodalProperties;
+
+	//! The preferences of the problem. This is the problem type, units, depth, and precision
+	electroStaticPreference p_preferences;
+
+	//! The voltage at each node of the mesh
+	std::vector<double> p_potential;
+
+	//! The voltage of each conductor. For conductors with a fixed voltage, this is the fixed voltage
+	std::vector<double> p_conductorVoltage;
+
+	//! The relative permittivity in x of each face of the last solve
+	std::vector<double> p_regionPermittivityX;
+
+	//! The relative permittivity in y of each face of the last solve
+	std::vector<double> p_regionPermittivityY;
+
+	/**
+	 * @brief Computes the element matrices and vectors of a run of elements of a block. The first order triangles use the
+	 * batched closed form kernel. All other elements use the quadrature kernel
+	 * @param block The block that the elements belong to
+	 * @param first The index of the first element
+	 * @param count The number of elements
+	 * @param kernel The quadrature kernel of the block
+	 * @param regionEpsilonX The relative permittivity in the x direction of each region
+	 * @param regionEpsilonY The relative permittivity in the y direction of each region
+	 * @param regionSource The source of each region
+	 * @param axisymmetric Set to true if the problem is axisymmetric
+	 * @param buffer Scratch space. This is resized as needed
+	 * @param matrices The element matrices. The matrix of element e is stored at e * n * n where n is the number of nodes of the element
+	 * @param vectors The element vectors. The vector of element e is stored at e * n
+	 */
+	void computeElements(const solverMesh::elementBlock &block, int first, int count, const elementKernel &kernel, const std::vector<double> &regionEpsilonX,
+						 const std::vector<double> &regionEpsilonY, const std::vector<double> &regionSource, bool axisymmetric, std::vector<double> &buffer,
+						 double *matrices, double *vectors);
+
+	/**
+	 * @brief Finds the index of a conductor from the name of a physical group
+	 * @param groupName The name of the physical group
+	 * @return Returns the index of the conductor or -1 if the group is not a conductor
+	 */
+	int findConductor(const std::string &groupName);
+
+public:
+	/**
+	 * @brief Creates the solver. The properties of the problem are copied so that the solver can be ran on its own
+	 * @param definition The problem definition that holds the materials, boundary conditions, and preferences
+	 * @param model The GMSH model that has been meshed
+	 */
+	electrostaticSolver(problemDefinition &definition, GModel *model);
+
+	~electrostaticSolver()
+	{
+		delete p_mesh;
+	}
+
+	/**
+	 * @brief Runs the solver. The time that each step takes is reported to the solver status window
+	 * @return Returns true if the linear solver converged
+	 */
+	bool solve();
+
+	/**
+	 * @brief Retrieves the voltage of the nodes of the mesh. The order of the nodes is the order of the solver mesh
+	 * @return Returns a pointer to the voltages
+	 */
+	std::vector<double> *getPotential()
+	{
+		return &p_potential;
+	}
+
+	/**
+	 * @brief Retrieves the voltage of the conductors. The order is the same as the conductor list of the problem definition
+	 * @return Returns a pointer to the voltages
+	 */
+	std::vector<double> *getConductorVoltage()
+	{
+		return &p_conductorVoltage;
+	}
+
+	/**
+	 * @brief Retrieves what the error estimator needs to measure the solution in the energy norm
+	 * @param unknown Returns the voltage at each node
+	 * @param coefficientX Returns the relative permittivity in x of each element. The elements are in the order of the blocks of the mesh
+	 * @param coefficientY Returns the relative permittivity in y of each element
+	 * @return Returns the power of r that the energy density is weighted by. 1 for axisymmetric problems and 0 for planar problems
+	 */
+	int getEnergyNorm(std::vector<double> &unknown, std::vector<double> &coefficientX, std::vector<double> &coefficientY);
+
+	/**
+	 * @brief Retrieves the mesh that was solved
+	 * @return Returns the mesh. Null if the solver was not ran yet
+	 */
+	solverMesh *getMesh()
+	{
+		return p_mesh;
+	}
+};
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef ELEMENT_KERNELS_H_
+#define ELEMENT_KERNELS_H_
+
+#include <vector>
+
+#include <Mesh/GMSH/GmshDefines.h>
+#include <Mesh/GMSH/ElementType.h>
+#include <Mesh/GMSH/GaussIntegration.h>
+#include <Mesh/GMSH/BasisFactory.h>
+#include <Mesh/GMSH/nodalBasis.h>
+
+
+/**
+ * @class elementKernel
+ * @author Phillip
+ * @date 17/10/26
+ * @file ElementKernels.h
+ * @brief 	Computes the element matrices and vectors of the scalar potential equation -div(k grad(u)) = s that both the electrostatic
+ * 			and the magnetostatic problems reduce to in 2D. The shape functions and their derivatives are taken from the GMSH nodal basis of the
+ * 			element type and are evaluated at the Gauss points once when the kernel is created. Computing an element is then only
+ * 			arithmetic on contiguous arrays. This works for the triangles, the quadrilaterals, and the lines of any order. For axisymmetric
+ * 			problems, x is the radius and the integrand is weighted by r (the factor of 2 pi is left out).
+ */
+class elementKernel
+{
+private:
+	//! The GMSH type of the element
+	int p_type;
+
+	//! The dimension of the element. 1 for lines and 2 for triangles and quadrilaterals
+	int p_dimension;
+
+	//! The number of nodes of the element
+	int p_numberOfNodes;
+
+	//! The number of Gauss points
+	int p_numberOfPoints;
+
+	//! The weight of each Gauss point in the reference element
+	std::vector<double> p_weights;
+
+	//! The value of the shape functions at the Gauss points. The value of shape function i at point q is at q * numberOfNodes + i
+	std::vector<double> p_shape;
+
+	//! The derivative of the shape functions with respect to u at the Gauss points. Same layout as the shape functions
+	std::vector<double> p_gradientU;
+
+	//! The derivative of the shape functions with respect to v at the Gauss points. Same layout as the shape functions
+	std::vector<double> p_gradientV;
+
+public:
+	/**
+	 * @brief Creates the kernel for an element type. The Gauss rule is picked so that the stiffness of a straight sided
+	 * element is integrated exactly
+	 * @param type The GMSH type of the element (MSH_TRI_3, MSH_QUA_9, MSH_LIN_3, ...)
+	 * @param axisymmetric Set to true if the problem is axisymmetric. This raises the order of the Gauss rule by one for the r weighting
+	 * @param mass Set to true if the kernel integrates the product of two shape functions (a mass matrix) instead of the product of two gradients
+	 */
+	elementKernel(int type, bool axisymmetric, bool mass = false);
+
+	int getType() const
+	{
+		return p_type;
+	}
+
+	int getNumberOfNodes() const
+	{
+		return p_numberOfNodes;
+	}
+
+	int getNumberOfPoints() const
+	{
+		return p_numberOfPoints;
+	}
+
+	/**
+	 * @brief Retrieves the value of the shape functions at a Gauss point
+	 * @param point The index of the Gauss point
+	 * @return Returns a pointer to the value of the first shape function
+	 */
+	const double *getShapeFunctions(int point) const
+	{
+		return &p_shape[point * p_numberOfNodes];
+	}
+
+	/**
+	 * @brief Computes the gradients of the shape functions at a Gauss point of a triangle or a quadrilateral. This is for the
+	 * problems that need more at each Gauss point than the fixed coefficients of the diffusion (such as a nonlinear material)
+	 * @param point The index of the Gauss point
+	 * @param x The x (or r) coordinates of the nodes of the element
+	 * @param y The y (or z) coordinates of the nodes of the element
+	 * @param gradientX Returns the derivative of each shape function with respect to x
+	 * @param gradientY Returns the derivative of each shape function with respect to y
+	 * @param r Returns the x (or r) coordinate of the Gauss point
+	 * @return Returns the weight of the Gauss point times the area of the element in the reference element (the determinant of the Jacobian)
+	 */
+	double mapGradients(int point, const double *x, const double *y, double *gradientX, double *gradientY, double &r) const;
+
+	/**
+	 * @brief Maps a Gauss point of a line element onto the line
+	 * @param point The index of the Gauss point
+	 * @param x The x (or r) coordinates of the nodes of the line
+	 * @param y The y (or z) coordinates of the nodes of the line
+	 * @param r Returns the x (or r) coordinate of the Gauss point
+	 * @return Returns the weight of the Gauss point times the length of the line in the reference element
+	 */
+	double mapLine(int point, const double *x, const double *y, double &r) const;
+
+	/**
+	 * @brief Computes the element matrix and the element vector of -div(k grad(u)) = s for a triangle or a quadrilateral
+	 * @param x The x (or r) coordinates of the nodes of the element
+	 * @param y The y (or z) coordinates of the nodes of the element
+	 * @param kx The coefficient in the x direction
+	 * @param ky The coefficient in the y direction
+	 * @param source The source term s. This is constant over the element
+	 * @param axisymmetric Set to true to weight the integral by r
+	 * @param matrix The element matrix. The matrix is stored column by column and is numberOfNodes by numberOfNodes
+	 * @param vector The element vector. May be null if the source is not needed
+	 */
+	void diffusion(const double *x, const double *y, double kx, double ky, double source, bool axisymmetric, double *matrix, double *vector) const;
+
+	/**
+	 * @brief Computes the element vector of a source that is spread over a line element (such as a surface charge)
+	 * @param x The x (or r) coordinates of the nodes of the line
+	 * @param y The y (or z) coordinates of the nodes of the line
+	 * @param source The source per unit length. This is constant over the line
+	 * @param axisymmetric Set to true to weight the integral by r
+	 * @param vector The element vector
+	 */
+	void lineLoad(const double *x, const double *y, double source, bool axisymmetric, double *vector) const;
+};
+
+/**
+ * @brief Computes the element matrices and vectors of -div(k grad(u)) = s for a batch of first order triangles. The gradients
+ * of the shape functions are constant over the triangle so the integrals have a closed form. The data is laid out
+ * as a structure of arrays so that the loop over the triangles of the batch can be vectorized by the compiler.
+ * For axisymmetric problems, the r weighting is integrated exactly through the centroid of the triangle.
+ * @param count The number of triangles in the batch
+ * @param x The x (or r) coordinates. The coordinate of node i of triangle e is at i * count + e
+ * @param y The y (or z) coordinates. Same layout as x
+ * @param kx The coefficient in the x direction of each triangle
+ * @param ky The coefficient in the y direction of each triangle
+ * @param source The source term of each triangle
+ * @param axisymmetric Set to true to weight the integral by r
+ * @param matrix The element matrices. Entry (i, j) of triangle e is at (j * 3 + i) * count + e
+ * @param vector The element vectors. Entry i of triangle e is at i * count + e
+ */
+void triangleDiffusionBatch(int count, const double *x, const double *y, const double *kx, const double *ky, const double *source, bool axisymmetric, double *matrix, double *vector);
+
+#endif
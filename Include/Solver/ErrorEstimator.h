@@ -0,0 +1,105 @@
+#ifndef ERROR_ESTIMATOR_H_
+#define ERROR_ESTIMATOR_H_
+
+#include <vector>
+#include <math.h>
+
+#include <Mesh/GMSH/GmshDefines.h>
+#include <Mesh/GMSH/ElementType.h>
+#include <Mesh/GMSH/BasisFactory.h>
+#include <Mesh/GMSH/nodalBasis.h>
+
+#include <Solver/SolverMesh.h>
+#include <Solver/ElementKernels.h>
+
+
+/**
+ * @class errorEstimator
+ * @author Phillip
+ * @date 17/10/26
+ * @file ErrorEstimator.h
+ * @brief 	Estimates the error of a solution of -div(k grad(u)) = s in the energy norm with the Zienkiewicz-Zhu estimator. The gradient
+ * 			of the finite element solution jumps from one element to the next. A smoother gradient is recovered by averaging the gradients
+ * 			of the elements around each node (weighted by the area of the elements) and interpolating the nodal values with the shape functions
+ * 			of the element. The error of each element is the energy norm of the difference between the two gradients. The gradient is only
+ * 			averaged over the elements of the same face so that the jump of the gradient across two materials is not counted as an error.
+ * 			Both the averaging and the integration of the error are done by all of the threads. The averaging goes one color of the mesh
+ * 			at a time since the elements of one color do not share a node.
+ */
+class errorEstimator
+{
+private:
+	//! The mesh that the solution is on
+	solverMesh *p_mesh;
+
+	//! The energy density is weighted by r to the power of this for axisymmetric problems. 0 for planar problems
+	int p_radialExponent;
+
+	//! The estimated error in the energy norm squared of each element. The elements are in the order of the blocks of the mesh
+	std::vector<double> p_elementError;
+
+	//! The energy norm squared of the solution of each element
+	std::vector<double> p_elementEnergy;
+
+	//! The area of each element in m^2
+	std::vector<double> p_elementArea;
+
+	//! The sum of the energy norm squared of the solution
+	double p_energy = 0;
+
+	//! The sum of the estimated error in the energy norm squared
+	double p_error = 0;
+
+public:
+	/**
+	 * @brief Creates the estimator
+	 * @param mesh The mesh that the solution is on
+	 * @param radialExponent For axisymmetric problems, the energy density is multiplied by r to the power of this. This is 1 for the
+	 * electrostatic problem and -1 for the magnetic problem where the unknown is r times the vector potential. 0 for planar problems
+	 */
+	errorEstimator(solverMesh *mesh, int radialExponent);
+
+	/**
+	 * @brief Estimates the error of each element
+	 * @param unknown The solution at each node of the mesh
+	 * @param coefficientX The coefficient of the x derivative of each element. The elements are in the order of the blocks of the mesh
+	 * @param coefficientY The coefficient of the y derivative of each element
+	 */
+	void estimate(const std::vector<double> &unknown, const std::vector<double> &coefficientX, const std::vector<double> &coefficientY);
+
+	/**
+	 * @brief Retrieves the estimated error relative to the energy norm of the solution
+	 * @return Returns sqrt(e / (E + e)) where E is the energy norm of the solution squared and e is the estimated error squared
+	 */
+	double getRelativeError() const
+	{
+		return (p_energy + p_error > 0) ? sqrt(p_error / (p_energy + p_error)) : 0.0;
+	}
+
+	double getEnergy() const
+	{
+		return p_energy;
+	}
+
+	double getError() const
+	{
+		return p_error;
+	}
+
+	const std::vector<double> &getElementErrors() const
+	{
+		return p_elementError;
+	}
+
+	const std::vector<double> &getElementEnergies() const
+	{
+		return p_elementEnergy;
+	}
+
+	const std::vector<double> &getElementAreas() const
+	{
+		return p_elementArea;
+	}
+};
+
+#endif
@@ -0,0 +1,306 @@
+#ifndef HARMONIC_MAGNETIC_SOLVER_H_
+#define HARMONIC_MAGNETIC_SOLVER_H_
+
+#include <vector>
+#include <string>
+#include <map>
+#include <complex>
+
+#include <common/ProblemDefinition.h>
+#include <common/MagneticMaterial.h>
+#include <common/MagneticBoundary.h>
+#include <common/CircuitProperty.h>
+#include <common/NodalProperty.h>
+#include <common/MagneticPreference.h>
+#include <common/OmniFEMMessage.h>
+#include <common/OS.h>
+
+#include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/dofManager.h>
+#include <Mesh/GMSH/linearSystemCSR.h>
+
+#include <Solver/SolverMesh.h>
+#include <Solver/ElementKernels.h>
+#include <Solver/PotentialConstraints.h>
+#include <Solver/MagneticConditions.h>
+#include <Solver/MagneticRegions.h>
+#include <Solver/ColoredAssembly.h>
+#include <Solver/BHCurve.h>
+
+
+/**
+ * @class harmonicMagneticSolver
+ * @author Phillip
+ * @date 17/10/26
+ * @file HarmonicMagneticSolver.h
+ * @brief 	Solves the planar or axisymmetric time harmonic (eddy current) magnetic problem curl(nu curl(A)) + j w sigma A = J on the mesh
+ * 			that was created by the meshMaker. The unknowns are the phasors of the same potential as the magnetostaticSolver (A for planar
+ * 			problems and r times A for axisymmetric problems). The system is complex symmetric. It is assembled as complex numbers straight
+ * 			into the complex CSR storage of the linear system and solved with the conjugate orthogonal conjugate gradient.
+ * 			The matrix is split into the parts that do not depend on the frequency (the stiffness of the plain materials and the sources), the
+ * 			eddy current part that is proportional to the frequency, the surface impedance of the small skin depth boundaries that is proportional
+ * 			to the square root of the frequency, and the stiffness of the regions whose permeability depends on the frequency (laminations
+ * 			in the plane of the problem and stranded wire). The sparsity pattern and the first three parts are built once. For each frequency
+ * 			of a sweep, the three parts are summed with the right factors and only the elements of the frequency dependent regions are
+ * 			computed again. The solution of the last frequency is the initial guess of the next one and the incomplete factors are kept
+ * 			for as long as the number of iterations stays low.
+ * 			A solid conductor of a circuit (one turn, not stranded) carries the current of the circuit through an extra unknown: the voltage
+ * 			gradient along the conductor. This lets the eddy currents redistribute the current over the conductor. All of the conductors of
+ * 			a parallel circuit share one voltage gradient. Conductors that are not part of a circuit carry the eddy currents of a conductor without an applied
+ * 			voltage. Stranded conductors and the blocks with more than one turn carry a uniform current density.
+ * 			Materials are linear. Nonlinear materials use the initial permeability of their anhysteretic curve. The hysteresis lag angle makes
+ * 			the permeability complex.
+ */
+class harmonicMagneticSolver
+{
+public:
+	/**
+	 * @brief How the permeability of a region changes with the frequency
+	 */
+	enum class frequencyModel
+	{
+		NONE,/*!< The permeability does not depend on the frequency */
+		LAMINATION,/*!< Laminations in the plane of the problem. The eddy currents in each lamination push the flux to the surface of the lamination */
+		STRANDS/*!< Stranded wire. The eddy currents in each strand push the flux out of the strand (proximity effect) */
+	};
+
+	/**
+	 * @brief The coefficients of the equation on one face of the mesh
+	 */
+	struct regionLaw
+	{
+		//! The coefficient of the x derivative of the potential. This is the relative reluctivity in the y direction
+		std::complex<double> reluctivityXX = 1;
+
+		//! The coefficient of the y derivative of the potential. This is the relative reluctivity in the x direction
+		std::complex<double> reluctivityYY = 1;
+
+		//! The current density times the permeability of free space (T/m)
+		std::complex<double> source = 0;
+
+		//! The conductivity times the permeability of free space (s/m^2). This is zero for regions that do not carry eddy currents
+		double conductivity = 0;
+
+		//! The voltage gradient unknown of the region. -1 if the voltage gradient is zero
+		int conductor = -1;
+
+		//! How the permeability depends on the frequency
+		frequencyModel model = frequencyModel::NONE;
+
+		//! The complex relative permeability of the material in x. This is used by the frequency dependent models
+		std::complex<double> permeabilityX = 1;
+
+		//! The complex relative permeability of the material in y
+		std::complex<double> permeabilityY = 1;
+
+		//! The fill factor of the laminations or the strands
+		double fillFactor = 1;
+
+		//! The thickness of a lamination or the radius of a strand (m)
+		double thickness = 0;
+
+		//! The conductivity of the laminations or the strands (S/m)
+		double materialConductivity = 0;
+	};
+
+private:
+	//! The permeability of free space in H/m
+	const double p_vacuumPermeability = 4e-7 * M_PI;
+
+	//! The number of elements that one thread computes at a time
+	static const int p_batchSize = 64;
+
+	//! The GMSH model that holds the mesh
+	GModel *p_model;
+
+	//! The mesh that the solver operates on. This is created when the solver is ran
+	solverMesh *p_mesh = nullptr;
+
+	//! The materials of the problem
+	std::vector<magneticMaterial> p_materials;
+
+	//! The boundary conditions of the problem
+	std::vector<magneticBoundary> p_boundaries;
+
+	//! The circuits of the problem
+	std::vector<circuitProperty> p_circuits;
+
+	//! The nodal properties of the problem
+	std::vector<nodalProperty> p_nodalProperties;
+
+	//! The preferences of the problem. This is the problem type, units, frequency, and precision
+	magneticPreference p_preferences;
+
+	//! The frequencies that were solved (Hz)
+	std::vector<double> p_frequencies;
+
+	//! The phasor of the vector potential at each node of the mesh (Wb/m) for each frequency. For axisymmetric problems, this is the phi component
+	std::vector<std::vector<std::complex<double>>> p_potential;
+
+	//! The phasor of the x (or r) component of the flux density of each element (T) for each frequency. The elements are in the order of the blocks of the mesh
+	std::vector<std::vector<std::complex<double>>> p_fluxDensityX;
+
+	//! The phasor of the y (or z) component of the flux density of each element (T) for each frequency
+	std::vector<std::vector<std::complex<double>>> p_fluxDensityY;
+
+	//! The phasor of the current density of each element, averaged over the element (A/m^2) for each frequency. This is the source and the eddy currents
+	std::vector<std::vector<std::complex<double>>> p_currentDensity;
+
+	/**
+	 * @brief The parts of the element matrices
+	 */
+	enum class elementPart
+	{
+		STATIC,/*!< The stiffness of the regions whose permeability does not depend on the frequency and the sources */
+		EDDY,/*!< The eddy currents. This part is multiplied by j w */
+		DEPENDENT/*!< The stiffness of the regions whose permeability depends on the frequency */
+	};
+
+	/**
+	 * @brief Computes one part of the element matrices and the element vectors of a run of elements of a block
+	 * @param block The block that the elements belong to
+	 * @param first The index of the first element
+	 * @param count The number of elements
+	 * @param kernel The quadrature kernel of the block for the stiffness
+	 * @param massKernel The quadrature kernel of the block for the eddy currents
+	 * @param laws The coefficients of each region
+	 * @param part The part that is computed
+	 * @param axisymmetric Set to true if the problem is axisymmetric
+	 * @param buffer Scratch space. This is resized as needed
+	 * @param matrices The element matrices. The matrix of element e is stored at e * (n + 1) * (n + 1) where n is the number of nodes of
+	 * the element. The elements of a conductor have one more row and column for the voltage gradient
+	 * @param vectors The element vectors. The vector of element e is stored at e * (n + 1)
+	 */
+	void computeElements(const solverMesh::elementBlock &block, int first, int count, const elementKernel &kernel, const elementKernel &massKernel,
+						 const std::vector<regionLaw> &laws, elementPart part, bool axisymmetric, std::vector<double> &buffer,
+						 std::complex<double> *matrices, std::complex<double> *vectors);
+
+	/**
+	 * @brief Computes the flux density and the current density of the elements of a block from the solution
+	 * @param block The block
+	 * @param kernel The quadrature kernel of the block. This should be the kernel for the eddy currents
+	 * @param laws The coefficients of each region
+	 * @param solution The value of the unknown at each node
+	 * @param voltages The value of each voltage gradient unknown
+	 * @param frequency The frequency in Hz
+	 * @param axisymmetric Set to true if the problem is axisymmetric
+	 * @param fluxX Returns the average flux density in x of each element of the block
+	 * @param fluxY Returns the average flux density in y of each element of the block
+	 * @param current Returns the average current density of each element of the block
+	 */
+	void computeResults(const solverMesh::elementBlock &block, const elementKernel &kernel, const std::vector<regionLaw> &laws,
+						const std::vector<std::complex<double>> &solution, const std::vector<std::complex<double>> &voltages, double frequency,
+						bool axisymmetric, std::complex<double> *fluxX, std::complex<double> *fluxY, std::complex<double> *current);
+
+	/**
+	 * @brief Finds the coefficients of each face of the mesh from the physical groups of the face. This also numbers the voltage gradient
+	 * unknowns of the solid conductors
+	 * @param laws Returns the coefficients of each region
+	 * @param conductorCurrents Returns the current of each voltage gradient unknown (A)
+	 */
+	void createRegionLaws(std::vector<regionLaw> &laws, std::vector<double> &conductorCurrents);
+
+	/**
+	 * @brief Updates the reluctivity of the regions whose permeability depends on the frequency
+	 * @param laws The coefficients of each region
+	 * @param frequency The frequency in Hz
+	 */
+	void updateRegionLaws(std::vector<regionLaw> &laws, double frequency);
+
+	/**
+	 * @brief Computes the ratio J2(z) / J0(z) of the Bessel functions of the first kind for a complex argument. The ratios
+	 * J(n) / J(n - 1) are found by the backward recurrence, which is stable for any argument
+	 * @param z The argument
+	 * @return Returns J2(z) / J0(z)
+	 */
+	static std::complex<double> getBesselRatio(std::complex<double> z);
+
+public:
+	/**
+	 * @brief Creates the solver. The properties of the problem are copied so that the solver can be ran on its own
+	 * @param definition The problem definition that holds the materials, boundary conditions, and preferences
+	 * @param model The GMSH model that has been meshed
+	 */
+	harmonicMagneticSolver(problemDefinition &definition, GModel *model);
+
+	~harmonicMagneticSolver()
+	{
+		delete p_mesh;
+	}
+
+	/**
+	 * @brief Runs the solver at the frequency of the preferences. The time that each step takes is reported to the solver status window
+	 * @return Returns true if the linear solver converged
+	 */
+	bool solve()
+	{
+		return solve(std::vector<double>(1, p_preferences.getFrequency()));
+	}
+
+	/**
+	 * @brief Runs the solver at each frequency of a sweep. The results of every frequency are kept
+	 * @param frequencies The frequencies in Hz. These must be larger than zero
+	 * @return Returns true if the linear solver converged at every frequency
+	 */
+	bool solve(const std::vector<double> &frequencies);
+
+	/**
+	 * @brief Retrieves the frequencies that were solved
+	 * @return Returns the frequencies in Hz
+	 */
+	const std::vector<double> &getFrequencies() const
+	{
+		return p_frequencies;
+	}
+
+	/**
+	 * @brief Retrieves the phasor of the vector potential of the nodes of the mesh. The order of the nodes is the order of the solver mesh
+	 * @param frequency The index of the frequency in the sweep
+	 * @return Returns a pointer to the vector potential
+	 */
+	std::vector<std::complex<double>> *getPotential(unsigned int frequency = 0)
+	{
+		return &p_potential[frequency];
+	}
+
+	/**
+	 * @brief Retrieves the phasor of the x (or r) component of the flux density of the elements
+	 * @param frequency The index of the frequency in the sweep
+	 * @return Returns a pointer to the flux density
+	 */
+	std::vector<std::complex<double>> *getFluxDensityX(unsigned int frequency = 0)
+	{
+		return &p_fluxDensityX[frequency];
+	}
+
+	/**
+	 * @brief Retrieves the phasor of the y (or z) component of the flux density of the elements
+	 * @param frequency The index of the frequency in the sweep
+	 * @return Returns a pointer to the flux density
+	 */
+	std::vector<std::complex<double>> *getFluxDensityY(unsigned int frequency = 0)
+	{
+		return &p_fluxDensityY[frequency];
+	}
+
+	/**
+	 * @brief Retrieves the phasor of the current density of the elements
+	 * @param frequency The index of the frequency in the sweep
+	 * @return Returns a pointer to the current density
+	 */
+	std::vector<std::complex<double>> *getCurrentDensity(unsigned int frequency = 0)
+	{
+		return &p_currentDensity[frequency];
+	}
+
+	/**
+	 * @brief Retrieves the mesh that was solved
+	 * @return Returns the mesh. Null if the solver was not ran yet
+	 */
+	solverMesh *getMesh()
+	{
+		return p_mesh;
+	}
+};
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef JILES_ATHERTON_MODEL_H_
+#define JILES_ATHERTON_MODEL_H_
+
+#include <vector>
+#include <math.h>
+
+#include <common/JilesAthertonParameters.h>
+
+
+/**
+ * @class jilesAthertonModel
+ * @author Phillip
+ * @date 17/10/26
+ * @file JilesAthertonModel.h
+ * @brief 	The hysteresis state of one material at all of the quadrature points where it is used. The finite element solution
+ * 			gives the flux density B so the inverse form of the Jiles-Atherton model is used: the flux density is the input and
+ * 			the field intensity H and the slope dH/dB are the output. The x and y components each follow the scalar model with
+ * 			the same parameters. These are the X parameters of the material. The Y (anisotropy) parameters are ignored.
+ * 			The state is stored as a structure of arrays. There is one array per quantity and the points are next to each other
+ * 			in each array. The update of the model is the same short sequence of operations on every point without branches
+ * 			so that the compiler vectorizes the loop over the points. The update always starts from the state of the last accepted
+ * 			time step (the committed state) and writes the trial state. The Newton-Raphson iterations of a time step can call the
+ * 			update as many times as needed. The trial state becomes the committed state once the time step is accepted.
+ * 			The step in the flux density is split into a fixed number of sub-steps that are integrated with the explicit Euler
+ * 			method.
+ */
+class jilesAthertonModel
+{
+private:
+	//! The permeability of free space in H/m
+	const double p_vacuumPermeability = 4e-7 * M_PI;
+
+	//! The number of sub-steps of the integration of the model over one step of the flux density
+	static const int p_numberOfSubsteps = 8;
+
+	//! The smallest relative reluctivity that is given to the Newton-Raphson method
+	const double p_minimumReluctivity = 1e-6;
+
+	//! The interdomain coupling alpha
+	double p_coupling;
+
+	//! The domain wall density a (A/m)
+	double p_domainDensity;
+
+	//! The saturation magnetization Ms (A/m)
+	double p_saturation;
+
+	//! The pinning k (A/m)
+	double p_pinning;
+
+	//! The reversibility c
+	double p_reversibility;
+
+	//! The fraction of the region that is filled by the material. B = mu0 * (H + fill factor * M)
+	double p_fillFactor;
+
+	//! The flux density of the committed state (T)
+	std::vector<double> p_fluxX, p_fluxY;
+
+	//! The field intensity of the committed state (A/m)
+	std::vector<double> p_fieldX, p_fieldY;
+
+	//! The magnetization of the committed state (A/m)
+	std::vector<double> p_magnetizationX, p_magnetizationY;
+
+	//! The irreversible magnetization of the committed state (A/m)
+	std::vector<double> p_irreversibleX, p_irreversibleY;
+
+	//! The flux density of the trial state. This is written by the solver before the update (T)
+	std::vector<double> p_trialFluxX, p_trialFluxY;
+
+	//! The field intensity of the trial state (A/m)
+	std::vector<double> p_trialFieldX, p_trialFieldY;
+
+	//! The magnetization of the trial state (A/m)
+	std::vector<double> p_trialMagnetizationX, p_trialMagnetizationY;
+
+	//! The irreversible magnetization of the trial state (A/m)
+	std::vector<double> p_trialIrreversibleX, p_trialIrreversibleY;
+
+	//! The relative differential reluctivity mu0 * dH/dB of the trial state
+	std::vector<double> p_reluctivityX, p_reluctivityY;
+
+	/**
+	 * @brief Integrates the model of one component from the committed state to the trial flux density
+	 * @param flux The committed flux density
+	 * @param field The committed field intensity
+	 * @param magnetization The committed magnetization
+	 * @param irreversible The committed irreversible magnetization
+	 * @param trialFlux The trial flux density
+	 * @param trialField Returns the trial field intensity
+	 * @param trialMagnetization Returns the trial magnetization
+	 * @param trialIrreversible Returns the trial irreversible magnetization
+	 * @param reluctivity Returns mu0 * dH/dB at the trial state
+	 */
+	void updateComponent(const double *flux, const double *field, const double *magnetization, const double *irreversible, const double *trialFlux,
+						 double *trialField, double *trialMagnetization, double *trialIrreversible, double *reluctivity);
+
+public:
+	/**
+	 * @brief Creates the model of a material. All of the points start out demagnetized
+	 * @param parameters The Jiles-Atherton parameters of the material. The X parameters are used for both components
+	 * @param fillFactor The fraction of the region that is filled by the material
+	 */
+	jilesAthertonModel(jilesAthertonParameters &parameters, double fillFactor);
+
+	/**
+	 * @brief Checks if the parameters describe a hysteresis loop
+	 * @param parameters The Jiles-Atherton parameters
+	 * @return Returns true if Ms, a, and k are positive
+	 */
+	static bool isValid(jilesAthertonParameters &parameters)
+	{
+		return (parameters.getSaturationMagnetization() > 0 && parameters.getAParam() > 0 && parameters.getKParam() > 0);
+	}
+
+	/**
+	 * @brief Sets the number of quadrature points and demagnetizes all of them
+	 * @param numberOfPoints The number of points
+	 */
+	void resize(int numberOfPoints);
+
+	int getNumberOfPoints() const
+	{
+		return p_fluxX.size();
+	}
+
+	/**
+	 * @brief Computes the trial state from the committed state and the trial flux density. The points are split over the threads
+	 * and each thread runs the vectorized kernel over its points
+	 */
+	void update();
+
+	//! Makes the trial state the committed state. This is called once the time step is accepted
+	void commit();
+
+	/**
+	 * @brief Computes the work that was done on the material between the committed state and the trial state. The field intensity
+	 * is taken to change linearly over the step
+	 * @param weights The weight of each point (the volume that the point stands for)
+	 * @return Returns the sum of the weight times the integral of H dB over the points
+	 */
+	double getWork(const double *weights) const;
+
+	//! Retrieves the array that the solver writes the trial flux density in x into
+	double *getTrialFluxX()
+	{
+		return p_trialFluxX.data();
+	}
+
+	//! Retrieves the array that the solver writes the trial flux density in y into
+	double *getTrialFluxY()
+	{
+		return p_trialFluxY.data();
+	}
+
+	const double *getTrialFieldX() const
+	{
+		return p_trialFieldX.data();
+	}
+
+	const double *getTrialFieldY() const
+	{
+		return p_trialFieldY.data();
+	}
+
+	const double *getReluctivityX() const
+	{
+		return p_reluctivityX.data();
+	}
+
+	const double *getReluctivityY() const
+	{
+		return p_reluctivityY.data();
+	}
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef MAGNETIC_CONDITIONS_H_
+#define MAGNETIC_CONDITIONS_H_
+
+#include <vector>
+#include <string>
+#include <map>
+
+#include <common/MagneticBoundary.h>
+#include <common/NodalProperty.h>
+#include <common/OmniFEMMessage.h>
+
+#include <Solver/SolverMesh.h>
+#include <Solver/PotentialConstraints.h>
+
+
+/**
+ * @class magneticConditions
+ * @author Phillip
+ * @date 17/10/26
+ * @file MagneticConditions.h
+ * @brief 	Reads the boundary conditions and the nodal properties of a magnetic problem off of the physical groups of the solver mesh.
+ * 			The magnetostatic, time harmonic, and transient solvers all find the prescribed potentials, the point currents, and the periodic
+ * 			edges the same way. Each solver then decides what it does with them. The prescribed potentials are kept as values of the
+ * 			unknown of the solver. For axisymmetric problems, this is r times the potential. The nodes on the axis of an axisymmetric problem
+ * 			are prescribed to zero.
+ */
+class magneticConditions
+{
+public:
+	/**
+	 * @brief A node whose potential is prescribed
+	 */
+	struct fixedPotential
+	{
+		//! The node
+		int node;
+
+		//! The value of the unknown at the node. For axisymmetric problems, this is r times the potential
+		double value;
+
+		//! The phase of the value in degrees. This is only used by time harmonic problems
+		double phase;
+	};
+
+private:
+	//! The mesh that the conditions were read from
+	solverMesh *p_mesh;
+
+	//! The prescribed potentials in the order that they were found
+	std::vector<fixedPotential> p_fixedValues;
+
+	//! The point currents of the nodal properties (A). Each entry is the node and the current
+	std::vector<std::pair<int, double>> p_pointCurrents;
+
+	//! The edges of the small skin depth boundaries along with their boundary condition
+	std::vector<std::pair<const solverMesh::edgeSegment*, magneticBoundary>> p_skinDepthEdges;
+
+	//! The edges of each periodic (or anti-periodic) boundary
+	std::map<std::string, std::vector<const solverMesh::edgeSegment*>> p_periodicEdges;
+
+	//! The sign of each periodic boundary. 1 for periodic and -1 for anti-periodic
+	std::map<std::string, double> p_periodicSign;
+
+	//! Set to true if at least one edge has a mixed or strategic dual image boundary
+	bool p_hasUnsupportedBoundary = false;
+
+public:
+	/**
+	 * @brief Reads the boundary conditions and the nodal properties off of the mesh
+	 * @param mesh The solver mesh
+	 * @param boundaries The boundary conditions of the problem
+	 * @param nodalProperties The nodal properties of the problem
+	 * @param axisymmetric Set to true if the problem is axisymmetric
+	 * @param scale The factor that converts the units of the geometry into meters
+	 */
+	magneticConditions(solverMesh *mesh, std::vector<magneticBoundary> &boundaries, std::vector<nodalProperty> &nodalProperties, bool axisymmetric, double scale);
+
+	/**
+	 * @brief Fixes the prescribed potentials in the constraints. The phase is left out
+	 * @param constraints The constraints of the unknowns
+	 */
+	void fixValues(potentialConstraints &constraints);
+
+	/**
+	 * @brief Ties the nodes of the two edges of each periodic boundary. A boundary that does not have exactly two edges or whose edges
+	 * do not have the same number of nodes is skipped with a warning
+	 * @param constraints The constraints of the unknowns
+	 */
+	void tiePeriodicEdges(potentialConstraints &constraints);
+
+	const std::vector<fixedPotential> &getFixedValues() const
+	{
+		return p_fixedValues;
+	}
+
+	const std::vector<std::pair<int, double>> &getPointCurrents() const
+	{
+		return p_pointCurrents;
+	}
+
+	const std::vector<std::pair<const solverMesh::edgeSegment*, magneticBoundary>> &getSkinDepthEdges() const
+	{
+		return p_skinDepthEdges;
+	}
+
+	/**
+	 * @brief Checks if the problem has a boundary condition that none of the magnetic solvers support yet
+	 * @return Returns true if at least one edge has a mixed or strategic dual image boundary
+	 */
+	bool hasUnsupportedBoundary() const
+	{
+		return p_hasUnsupportedBoundary;
+	}
+};
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef MAGNETIC_REGIONS_H_
+#define MAGNETIC_REGIONS_H_
+
+#include <vector>
+
+#include <common/enums.h>
+#include <common/MagneticMaterial.h>
+#include <common/CircuitProperty.h>
+#include <common/OmniFEMMessage.h>
+
+#include <Solver/SolverMesh.h>
+
+
+/**
+ * @class magneticRegions
+ * @author Phillip
+ * @date 17/10/26
+ * @file MagneticRegions.h
+ * @brief 	Reads the material, the circuit, the number of turns, and the direction of magnetization of each face of the solver mesh off of
+ * 			its physical groups. A face takes the first group that matches the name of a material. The magnetic solvers build the laws of
+ * 			their regions from these. This class also holds the parts of the laws that the solvers have in common: the fill factor and
+ * 			the mixing of the permeability of laminated materials and the split of the current of a circuit over its blocks.
+ */
+class magneticRegions
+{
+private:
+	//! The mesh that the regions were read from
+	solverMesh *p_mesh;
+
+	//! The circuits of the problem
+	std::vector<circuitProperty> p_circuits;
+
+	//! The index of the material of each region. -1 if the region does not have a material
+	std::vector<int> p_material;
+
+	//! The index of the circuit of each region. -1 if the region is not part of a circuit
+	std::vector<int> p_circuit;
+
+	//! The number of turns of each region
+	std::vector<double> p_turns;
+
+	//! The direction of magnetization of each region in degrees
+	std::vector<double> p_magnetization;
+
+public:
+	/**
+	 * @brief Reads the physical groups of the faces of the mesh. A warning is given if a face does not have a material or if the
+	 * direction of magnetization of a face is an expression
+	 * @param mesh The solver mesh
+	 * @param materials The materials of the problem
+	 * @param circuits The circuits of the problem
+	 */
+	magneticRegions(solverMesh *mesh, std::vector<magneticMaterial> &materials, std::vector<circuitProperty> &circuits);
+
+	/**
+	 * @brief Computes the current density that the circuits impose on each region. A series circuit carries its current through every
+	 * turn of every block. A parallel circuit splits its current between its blocks. If the conductivity of each region is given and
+	 * all of the blocks of a circuit have one, the split is weighted by the conductivity. Otherwise, the current is spread evenly over
+	 * the area of the blocks
+	 * @param factor The factor that multiplies the current density. This is the permeability of free space for the magnetic solvers
+	 * @param conductivity The conductivity of each region. Leave this empty to spread the current of the parallel circuits evenly
+	 * @return Returns the current density times the factor of each region. This is zero for the regions that are not part of a circuit
+	 * or do not have an area
+	 */
+	std::vector<double> getCircuitSources(double factor, const std::vector<double> &conductivity = std::vector<double>());
+
+	int getMaterial(int region) const
+	{
+		return p_material[region];
+	}
+
+	int getCircuit(int region) const
+	{
+		return p_circuit[region];
+	}
+
+	double getTurns(int region) const
+	{
+		return p_turns[region];
+	}
+
+	double getMagnetization(int region) const
+	{
+		return p_magnetization[region];
+	}
+
+	/**
+	 * @brief Checks if the material is laminated
+	 * @param attribute The special attribute of the material
+	 * @return Returns true for laminations in the plane or parallel to the x or the y axis
+	 */
+	static bool isLaminated(lamWireEnum attribute)
+	{
+		return (attribute == LAMINATED_IN_PLANE || attribute == LAMINATED_PARALLEL_X_OR_R_AXISYMMETRIC || attribute == LAMINATED_PARALLEL_Y_OR_Z_AXISYMMETRIC);
+	}
+
+	/**
+	 * @brief Retrieves the fill factor of the laminations of a material
+	 * @param material The material
+	 * @return Returns the fill factor of a laminated material. Returns 1 if the material is not laminated or the fill factor is not
+	 * between 0 and 1
+	 */
+	static double getFillFactor(magneticMaterial &material);
+
+	/**
+	 * @brief Mixes the permeability of the iron of a laminated material with the air between the laminations. Along the laminations,
+	 * the iron and the air are side by side. Across the laminations, the flux passes through one after the other. Materials that are
+	 * not laminated are left as they are
+	 * @param attribute The special attribute of the material
+	 * @param fillFactor The fill factor of the laminations
+	 * @param permeabilityX The relative permeability in the x direction. This is replaced with the mixed permeability
+	 * @param permeabilityY The relative permeability in the y direction. This is replaced with the mixed permeability
+	 */
+	template<class T> static void mixLaminations(lamWireEnum attribute, double fillFactor, T &permeabilityX, T &permeabilityY)
+	{
+		switch(attribute)
+		{
+			case LAMINATED_IN_PLANE:
+				permeabilityX = fillFactor * permeabilityX + (1 - fillFactor);
+				permeabilityY = fillFactor * permeabilityY + (1 - fillFactor);
+				break;
+			case LAMINATED_PARALLEL_X_OR_R_AXISYMMETRIC:
+				permeabilityX = fillFactor * permeabilityX + (1 - fillFactor);
+				permeabilityY = 1.0 / (fillFactor / permeabilityY + (1 - fillFactor));
+				break;
+			case LAMINATED_PARALLEL_Y_OR_Z_AXISYMMETRIC:
+				permeabilityX = 1.0 / (fillFactor / permeabilityX + (1 - fillFactor));
+				permeabilityY = fillFactor * permeabilityY + (1 - fillFactor);
+				break;
+			default:
+				break;
+		}
+	}
+
+	/**
+	 * @brief Computes the reluctivity of a linear material. The laminations are mixed in
+	 * @param material The material
+	 * @param fillFactor The fill factor of the laminations
+	 * @param reluctivityXX Returns the coefficient of the x derivative of the potential. This is the relative reluctivity in the y direction
+	 * @param reluctivityYY Returns the coefficient of the y derivative of the potential. This is the relative reluctivity in the x direction
+	 */
+	static void getReluctivity(magneticMaterial &material, double fillFactor, double &reluctivityXX, double &reluctivityYY);
+};
+
+#endif
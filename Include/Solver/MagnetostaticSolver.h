@@ -0,0 +1,241 @@
+#ifndef MAGNETOSTATIC_SOLVER_H_
+#define MAGNETOSTATIC_SOLVER_H_
+
+#include <vector>
+#include <string>
+#include <map>
+
+#include <common/ProblemDefinition.h>
+#include <common/MagneticMaterial.h>
+#include <common/MagneticBoundary.h>
+#include <common/CircuitProperty.h>
+#include <common/NodalProperty.h>
+#include <common/MagneticPreference.h>
+#include <common/OmniFEMMessage.h>
+#include <common/OS.h>
+
+#include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/dofManager.h>
+#include <Mesh/GMSH/linearSystemCSR.h>
+
+#include <Solver/SolverMesh.h>
+#include <Solver/ElementKernels.h>
+#include <Solver/PotentialConstraints.h>
+#include <Solver/MagneticConditions.h>
+#include <Solver/MagneticRegions.h>
+#include <Solver/ColoredAssembly.h>
+#include <Solver/BHCurve.h>
+
+
+/**
+ * @class magnetostaticSolver
+ * @author Phillip
+ * @date 17/10/26
+ * @file MagnetostaticSolver.h
+ * @brief 	Solves the planar or axisymmetric magnetostatic problem curl(nu curl(A)) = J on the mesh that was created by the meshMaker.
+ * 			For planar problems, the unknown is the z component of the vector potential. For axisymmetric problems, the unknown is r times
+ * 			the phi component of the vector potential (the flux function). This turns the problem into the same scalar equation as the planar
+ * 			problem with a weight of 1 / r. The equation is multiplied through by the permeability of free space so that the coefficients are
+ * 			the relative reluctivity.
+ * 			Linear materials use the relative permeability in x and y (with the laminations mixed in through the fill factor). Nonlinear materials
+ * 			use the anhysteretic curve of their Jiles-Atherton parameters, sampled into a bhCurve once per solve. The nonlinear problem is
+ * 			solved with the Newton-Raphson method. Each iteration assembles the Jacobian and the right hand side (the Jacobian times the current
+ * 			solution minus the residual) through the numeric pass of the dofManager so the sparsity pattern is only built once. The incomplete
+ * 			Cholesky factors of the conjugate gradient are kept from one iteration to the next for as long as the number of iterations that the
+ * 			conjugate gradient needs stays low. The step is shortened (backtracking line search) when the residual goes up.
+ * 			The sources are the current density of the materials, the circuits (the current of a series circuit times the number of turns of the block
+ * 			label over the area of the block, the current of a parallel circuit is spread over all of its blocks), the coercivity of permanent magnets in the
+ * 			direction of magnetization of the block label, and the point currents of the nodal properties.
+ * 			Prescribed A, periodic, and anti-periodic boundaries are supported. The small skin depth, mixed, and strategic dual image boundaries
+ * 			are not supported yet.
+ */
+class magnetostaticSolver
+{
+public:
+	/**
+	 * @brief The coefficients of the equation on one face of the mesh
+	 */
+	struct regionLaw
+	{
+		//! The B-H curve of a nonlinear material. Null for linear materials
+		const bhCurve *curve = nullptr;
+
+		//! The coefficient of the x derivative of the potential. This is the relative reluctivity in the y direction
+		double reluctivityXX = 1;
+
+		//! The coefficient of the y derivative of the potential. This is the relative reluctivity in the x direction
+		double reluctivityYY = 1;
+
+		//! The current density times the permeability of free space (T/m)
+		double source = 0;
+
+		//! The coercivity of the magnet in the x direction times the permeability of free space (T)
+		double magnetX = 0;
+
+		//! The coercivity of the magnet in the y direction times the permeability of free space (T)
+		double magnetY = 0;
+	};
+
+private:
+	//! The permeability of free space in H/m
+	const double p_vacuumPermeability = 4e-7 * M_PI;
+
+	//! The number of elements that one thread computes at a time
+	static const int p_batchSize = 64;
+
+	//! The largest number of Newton-Raphson iterations
+	static const int p_maximumNewtonIterations = 50;
+
+	//! The largest number of times that one Newton-Raphson step is shortened
+	static const int p_maximumStepReductions = 10;
+
+	//! The GMSH model that holds the mesh
+	GModel *p_model;
+
+	//! The mesh that the solver operates on. This is created when the solver is ran
+	solverMesh *p_mesh = nullptr;
+
+	//! The materials of the problem
+	std::vector<magneticMaterial> p_materials;
+
+	//! The boundary conditions of the problem
+	std::vector<magneticBoundary> p_boundaries;
+
+	//! The circuits of the problem
+	std::vector<circuitProperty> p_circuits;
+
+	//! The nodal properties of the problem
+	std::vector<nodalProperty> p_nodalProperties;
+
+	//! The preferences of the problem. This is the problem type, units, depth, and precision
+	magneticPreference p_preferences;
+
+	//! The B-H curves of the nonlinear materials. Each entry belongs to the material at the same index. Null for linear materials
+	std::vector<bhCurve*> p_curves;
+
+	//! The vector potential at each node of the mesh (Wb/m). For axisymmetric problems, this is the phi component
+	std::vector<double> p_potential;
+
+	//! The x (or r) component of the flux density of each element, averaged over the element (T). The elements are in the order of the blocks of the mesh
+	std::vector<double> p_fluxDensityX;
+
+	//! The y (or z) component of the flux density of each element, averaged over the element (T)
+	std::vector<double> p_fluxDensityY;
+
+	//! The number of Newton-Raphson iterations of the last solve
+	int p_numberOfNewtonIterations = 0;
+
+	//! The coefficients of each face of the last solve. The curves of the nonlinear laws belong to p_curves
+	std::vector<regionLaw> p_laws;
+
+	/**
+	 * @brief Computes the element matrices (the Jacobian) and the element vectors (the Jacobian times the current solution minus the residual)
+	 * of a run of elements of a block. The first order triangles use a batched closed form kernel. All other elements are integrated with
+	 * the quadrature kernel.
+	 * @param block The block that the elements belong to
+	 * @param first The index of the first element
+	 * @param count The number of elements
+	 * @param kernel The quadrature kernel of the block
+	 * @param laws The coefficients of each region
+	 * @param solution The current value of the unknown at each node
+	 * @param axisymmetric Set to true if the problem is axisymmetric
+	 * @param buffer Scratch space. This is resized as needed
+	 * @param matrices The element matrices. The matrix of element e is stored at e * n * n where n is the number of nodes of the element
+	 * @param vectors The element vectors. The vector of element e is stored at e * n
+	 * @param fluxX If not null, returns the average flux density in x of each element
+	 * @param fluxY If not null, returns the average flux density in y of each element
+	 */
+	void computeElements(const solverMesh::elementBlock &block, int first, int count, const elementKernel &kernel, const std::vector<regionLaw> &laws,
+						 const std::vector<double> &solution, bool axisymmetric, std::vector<double> &buffer, double *matrices, double *vectors,
+						 double *fluxX, double *fluxY);
+
+	/**
+	 * @brief Finds the coefficients of each face of the mesh from the physical groups of the face. This builds the B-H curves of the
+	 * nonlinear materials and finds the current density of the circuits
+	 * @param laws Returns the coefficients of each region
+	 * @return Returns true if at least one of the regions is nonlinear
+	 */
+	bool createRegionLaws(std::vector<regionLaw> &laws);
+
+	//! Deletes the B-H curves
+	void clearCurves()
+	{
+		for(auto curveIterator = p_curves.begin(); curveIterator != p_curves.end(); curveIterator++)
+			delete *curveIterator;
+
+		p_curves.clear();
+	}
+
+public:
+	/**
+	 * @brief Creates the solver. The properties of the problem are copied so that the solver can be ran on its own
+	 * @param definition The problem definition that holds the materials, boundary conditions, and preferences
+	 * @param model The GMSH model that has been meshed
+	 */
+	magnetostaticSolver(problemDefinition &definition, GModel *model);
+
+	~magnetostaticSolver()
+	{
+		clearCurves();
+		delete p_mesh;
+	}
+
+	/**
+	 * @brief Runs the solver. The time that each step takes is reported to the solver status window
+	 * @return Returns true if the Newton-Raphson iterations and the linear solver converged
+	 */
+	bool solve();
+
+	/**
+	 * @brief Retrieves the vector potential of the nodes of the mesh. The order of the nodes is the order of the solver mesh
+	 * @return Returns a pointer to the vector potential
+	 */
+	std::vector<double> *getPotential()
+	{
+		return &p_potential;
+	}
+
+	/**
+	 * @brief Retrieves the x (or r) component of the flux density of the elements
+	 * @return Returns a pointer to the flux density
+	 */
+	std::vector<double> *getFluxDensityX()
+	{
+		return &p_fluxDensityX;
+	}
+
+	/**
+	 * @brief Retrieves the y (or z) component of the flux density of the elements
+	 * @return Returns a pointer to the flux density
+	 */
+	std::vector<double> *getFluxDensityY()
+	{
+		return &p_fluxDensityY;
+	}
+
+	int getNumberOfNewtonIterations()
+	{
+		return p_numberOfNewtonIterations;
+	}
+
+	/**
+	 * @brief Retrieves what the error estimator needs to measure the solution in the energy norm. Nonlinear materials use the reluctivity
+	 * at the average flux density of the element
+	 * @param unknown Returns the unknown at each node. For axisymmetric problems, this is r times the vector potential
+	 * @param coefficientX Returns the relative reluctivity that multiplies the x derivative of each element. The elements are in the order of the blocks of the mesh
+	 * @param coefficientY Returns the relative reluctivity that multiplies the y derivative of each element
+	 * @return Returns the power of r that the energy density is weighted by. -1 for axisymmetric problems and 0 for planar problems
+	 */
+	int getEnergyNorm(std::vector<double> &unknown, std::vector<double> &coefficientX, std::vector<double> &coefficientY);
+
+	/**
+	 * @brief Retrieves the mesh that was solved
+	 * @return Returns the mesh. Null if the solver was not ran yet
+	 */
+	solverMesh *getMesh()
+	{
+		return p_mesh;
+	}
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef PVD_WRITER_H_
+#define PVD_WRITER_H_
+
+#include <string>
+#include <vector>
+
+#include <common/OmniFEMMessage.h>
+
+
+/**
+ * @class pvdWriter
+ * @author Phillip
+ * @date 17/10/26
+ * @file PVDWriter.h
+ * @brief 	Writes a ParaView collection (.pvd) file that lists the .vtu files of a series, such as the steps of a transient
+ * 			solution or the frequencies of a sweep. ParaView opens the collection as one data set with a time slider. The
+ * 			collection only holds the names of the files, so it is written again after each file is added. This keeps the
+ * 			collection valid while a long run is still going.
+ */
+class pvdWriter
+{
+private:
+	//! One file of the series
+	struct step
+	{
+		//! The time (or the frequency) of the file
+		double time;
+
+		//! The path of the .vtu file relative to the collection
+		std::string filePath;
+	};
+
+	//! The path of the .pvd file
+	std::string p_filePath;
+
+	//! The files of the series in the order that they were added
+	std::vector<step> p_steps;
+
+public:
+	/**
+	 * @brief Creates the collection
+	 * @param filePath The path of the .pvd file
+	 */
+	pvdWriter(std::string filePath)
+	{
+		p_filePath = filePath;
+	}
+
+	/**
+	 * @brief Adds a file to the collection and writes the collection
+	 * @param time The time (or the frequency) of the file
+	 * @param vtuFilePath The path of the .vtu file. The folder is removed if it is the folder of the collection
+	 * @return Returns false if the collection could not be written
+	 */
+	bool addStep(double time, std::string vtuFilePath);
+
+	/**
+	 * @brief Writes the collection
+	 * @return Returns false if the file could not be written
+	 */
+	bool write();
+
+	/**
+	 * @brief Finds the path of the .vtu file of a step of a series
+	 * @param basePath The path and name of the series without an extension
+	 * @param index The index of the step
+	 * @return Returns the path with the index of the step and the .vtu extension added
+	 */
+	static std::string getStepPath(std::string basePath, unsigned int index);
+};
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef POTENTIAL_CONSTRAINTS_H_
+#define POTENTIAL_CONSTRAINTS_H_
+
+#include <vector>
+
+#include <Mesh/GMSH/dofManager.h>
+
+
+/**
+ * @class potentialConstraints
+ * @author Phillip
+ * @date 17/10/26
+ * @file PotentialConstraints.h
+ * @brief 	Collects the constraints on the potential of the unknowns before the unknowns are numbered. An unknown can be fixed
+ * 			to a value or tied to another unknown with u_slave = sign * u_master where the sign is +1 (conductors and periodic boundaries)
+ * 			or -1 (anti-periodic boundaries). The ties are kept in a disjoint set forest so that chains of ties (such as a corner node
+ * 			that is on two periodic boundaries) always end at one unknown that is either numbered or fixed. This is needed since the
+ * 			dofManager does not follow a constraint that points to another constrained unknown.
+ */
+class potentialConstraints
+{
+private:
+	//! The unknown that each unknown is tied to. An unknown that is not tied to anything is its own parent
+	std::vector<int> p_parent;
+
+	//! The sign of the tie between the unknown and its parent
+	std::vector<double> p_sign;
+
+	//! Set to true for the unknowns that have a fixed value
+	std::vector<bool> p_isFixed;
+
+	//! The value of the fixed unknowns
+	std::vector<double> p_value;
+
+	//! The number of ties and fixed values that contradict an earlier one. These are ignored
+	unsigned int p_numberOfConflicts = 0;
+
+public:
+	/**
+	 * @brief Creates the constraints
+	 * @param numberOfUnknowns The number of unknowns. The unknowns are numbered from 0
+	 */
+	potentialConstraints(int numberOfUnknowns) : p_parent(numberOfUnknowns), p_sign(numberOfUnknowns, 1.0), p_isFixed(numberOfUnknowns, false), p_value(numberOfUnknowns, 0)
+	{
+		for(int i = 0; i < numberOfUnknowns; i++)
+			p_parent[i] = i;
+	}
+
+	/**
+	 * @brief Finds the unknown at the end of the chain of ties of an unknown
+	 * @param unknown The unknown
+	 * @param sign Returns the sign such that u_unknown = sign * u_root
+	 * @return Returns the root of the unknown
+	 */
+	int findRoot(int unknown, double &sign);
+
+	/**
+	 * @brief Fixes the value of an unknown. The value is moved to the root of the unknown
+	 * @param unknown The unknown
+	 * @param value The value of the unknown
+	 */
+	void fix(int unknown, double value);
+
+	/**
+	 * @brief Ties two unknowns together such that u_slave = sign * u_master
+	 * @param slave The unknown that follows the master
+	 * @param master The unknown that is followed
+	 * @param sign Either 1 or -1
+	 */
+	void tie(int slave, int master, double sign);
+
+	/**
+	 * @brief Ties the nodes of two edges of a periodic (or anti-periodic) boundary. The nodes are paired in order along the edges.
+	 * The two edges are either a translation or a rotation about the origin of each other but the direction that the edges go is
+	 * not known. So, both directions are tried and the direction where the pairs of nodes are the most consistent is kept
+	 * @param firstEdge The ordered nodes of the first edge
+	 * @param secondEdge The ordered nodes of the second edge
+	 * @param x The x coordinate of all of the nodes
+	 * @param y The y coordinate of all of the nodes
+	 * @param sign 1 for periodic and -1 for anti-periodic
+	 * @return Returns false if the edges do not have the same number of nodes. In which case, nothing is tied
+	 */
+	bool tieEdges(const std::vector<int> &firstEdge, const std::vector<int> &secondEdge, const double *x, const double *y, double sign);
+
+	/**
+	 * @brief Checks if an unknown has a fixed value after all of the ties
+	 * @param unknown The unknown
+	 * @return Returns true if the root of the unknown is fixed
+	 */
+	bool isFixed(int unknown)
+	{
+		double sign;
+		return p_isFixed[findRoot(unknown, sign)];
+	}
+
+	/**
+	 * @brief Checks if an unknown is tied to another unknown that is not fixed
+	 * @param unknown The unknown
+	 * @return Returns true if the dofManager will see the unknown as a linear constraint
+	 */
+	bool isTied(int unknown)
+	{
+		double sign;
+		int root = findRoot(unknown, sign);
+		return root != unknown && !p_isFixed[root];
+	}
+
+	/**
+	 * @brief Checks if any of the unknowns have a fixed value
+	 * @return Returns true if there is at least one fixed unknown
+	 */
+	bool hasFixedValue()
+	{
+		for(unsigned int i = 0; i < p_isFixed.size(); i++)
+		{
+			if(p_isFixed[i])
+				return true;
+		}
+
+		return false;
+	}
+
+	unsigned int getNumberOfConflicts()
+	{
+		return p_numberOfConflicts;
+	}
+
+	/**
+	 * @brief Passes the constraints to the dofManager. Each unknown becomes the Dof(unknown, 0). Fixed unknowns are fixed,
+	 * tied unknowns become a linear constraint on their root, and the rest of the unknowns are numbered
+	 * @param dofs The dofManager
+	 * @param isUsed Only the unknowns that are set to true (and the roots that they are tied to) are passed on. Unknowns that 
+	 * are not part of any element would otherwise leave an empty row in the matrix
+	 */
+	template<class T> void apply(dofManager<T> &dofs, const std::vector<bool> &isUsed)
+	{
+		std::vector<bool> isPassed(isUsed);
+		double sign;
+
+		for(unsigned int i = 0; i < p_parent.size(); i++)
+		{
+			if(isUsed[i])
+				isPassed[findRoot(i, sign)] = true;
+		}
+
+		for(unsigned int i = 0; i < p_parent.size(); i++)
+		{
+			int root = findRoot(i, sign);
+
+			if(!isPassed[i])
+				continue;
+
+			if(p_isFixed[root])
+				dofs.fixDof(Dof(i, 0), (T)(sign * p_value[root]));
+			else if(root != (int)i)
+			{
+				DofAffineConstraint<T> constraint;
+
+				constraint.linear.push_back(std::make_pair(Dof(root, 0), (T)sign));
+				constraint.shift = 0;
+				dofs.setLinearConstraint(Dof(i, 0), constraint);
+			}
+			else
+				dofs.numberDof(Dof(i, 0));
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef SOLVER_MESH_H_
+#define SOLVER_MESH_H_
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+#include <common/enums.h>
+
+#include <Mesh/GMSH/GmshDefines.h>
+#include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/GVertex.h>
+#include <Mesh/GMSH/GEdge.h>
+#include <Mesh/GMSH/GFace.h>
+#include <Mesh/GMSH/MVertex.h>
+#include <Mesh/GMSH/MElement.h>
+#include <Mesh/GMSH/MLine.h>
+
+
+/**
+ * @class solverMesh
+ * @author Phillip
+ * @date 17/10/26
+ * @file SolverMesh.h
+ * @brief 	The mesh that the solvers operate on. The GMSH model is made out of entities that each own their vertices and elements.
+ * 			The solvers need flat arrays that can be looped over quickly. So, this class copies the GMSH mesh into flat arrays once.
+ * 			The nodes are numbered from 0 and the coordinates are converted into meters. The elements of the faces are grouped into blocks
+ * 			of the same element type. The elements of each block are colored so that no two elements of the same color share a node.
+ * 			The elements of one color can be assembled at the same time by different threads without any locking. The elements of each block
+ * 			are stored sorted by their color. The physical groups (material, boundary condition, nodal property, conductor) of the GMSH entities
+ * 			are kept by name. Nothing points back into the GMSH model so the mesh (and the results on it) stay valid after the
+ * 			GMSH model is deleted.
+ */
+class solverMesh
+{
+public:
+	/**
+	 * @brief All of the elements of one type within the faces
+	 */
+	struct elementBlock
+	{
+		//! The GMSH type of the elements (MSH_TRI_3, MSH_QUA_9, ...)
+		int type;
+
+		//! The polynomial order of the elements
+		int order;
+
+		//! The number of nodes of each element
+		int numberOfNodes;
+
+		//! The nodes of the elements. Element i uses the nodes from i * numberOfNodes to (i + 1) * numberOfNodes - 1
+		std::vector<int> nodes;
+
+		//! The index of the face (region) that each element belongs to
+		std::vector<int> regions;
+
+		//! The elements of color c are from colorOffset[c] to colorOffset[c + 1] - 1
+		std::vector<int> colorOffset;
+
+		//! The color that holds the elements that could not be given a color. These elements must be assembled by one thread. -1 if there are none
+		int serialColor = -1;
+	};
+
+	/**
+	 * @brief A face of the geometry. Each element belongs to one region
+	 */
+	struct region
+	{
+		//! The names of the physical groups of the face. This is the material and the circuit
+		std::vector<std::string> groups;
+	};
+
+	/**
+	 * @brief A line or arc of the geometry that is part of at least one physical group
+	 */
+	struct edgeSegment
+	{
+		//! The GMSH type of the line elements (MSH_LIN_2, MSH_LIN_3, ...)
+		int type;
+
+		//! The number of nodes of each line element
+		int numberOfNodes;
+
+		//! The nodes of the line elements. This follows the same layout as the element block
+		std::vector<int> nodes;
+
+		//! All of the nodes of the edge ordered from the start of the edge to the end of the edge
+		std::vector<int> orderedNodes;
+
+		//! The names of the physical groups of the edge. This is the boundary condition and the conductor
+		std::vector<std::string> groups;
+	};
+
+	/**
+	 * @brief A node of the geometry that is part of at least one physical group
+	 */
+	struct pointNode
+	{
+		//! The index of the node
+		int node;
+
+		//! The names of the physical groups of the node. This is the nodal property and the conductor
+		std::vector<std::string> groups;
+	};
+
+private:
+	//! The x (or r) coordinate of each node in meters
+	std::vector<double> p_x;
+
+	//! The y (or z) coordinate of each node in meters
+	std::vector<double> p_y;
+
+	//! The elements of the faces grouped by type
+	std::vector<elementBlock> p_blocks;
+
+	//! The faces of the mesh
+	std::vector<region> p_regions;
+
+	//! The edges that are part of a physical group
+	std::vector<edgeSegment> p_edges;
+
+	//! The nodes that are part of a physical group
+	std::vector<pointNode> p_points;
+
+	/**
+	 * @brief Gives each element of the block a color such that no two elements of the same color share a node. The colors are
+	 * found with a greedy algorithm where each node keeps a bit mask of the colors of the elements around it. The elements are
+	 * then sorted by color. A stable sort is used so that the elements keep the ordering from the mesher within each color.
+	 * @param block The block that will be colored
+	 */
+	void colorBlock(elementBlock &block);
+
+	/**
+	 * @brief Retrieves the names of the physical groups of a GMSH entity
+	 * @param model The GMSH model that the entity belongs to
+	 * @param entity The entity
+	 * @return Returns the names of the groups
+	 */
+	std::vector<std::string> getGroupNames(GModel *model, GEntity *entity);
+
+public:
+	/**
+	 * @brief Copies the mesh out of the GMSH model
+	 * @param model The GMSH model that has been meshed
+	 * @param scale The factor that converts the units of the geometry into meters
+	 */
+	solverMesh(GModel *model, double scale);
+
+	/**
+	 * @brief Retrieves the factor that converts a length in the units that the user drew the geometry in into meters
+	 * @param unit The units of the geometry
+	 * @return Returns the length of one unit in meters
+	 */
+	static double getUnitScale(unitLengthEnum unit)
+	{
+		switch(unit)
+		{
+			case unitLengthEnum::INCHES:
+				return 0.0254;
+			case unitLengthEnum::MILLIMETERS:
+				return 1e-3;
+			case unitLengthEnum::CENTIMETERS:
+				return 1e-2;
+			case unitLengthEnum::MILS:
+				return 2.54e-5;
+			case unitLengthEnum::MICROMETERS:
+				return 1e-6;
+			default:
+				return 1.0;
+		}
+	}
+
+	/**
+	 * @brief Retrieves the number of nodes of the mesh
+	 * @return Returns the number of nodes
+	 */
+	int getNumberOfNodes() const
+	{
+		return p_x.size();
+	}
+
+	/**
+	 * @brief Retrieves the x (or r) coordinates of the nodes
+	 * @return Returns a pointer to the first coordinate
+	 */
+	const double *getXCoordinates() const
+	{
+		return p_x.data();
+	}
+
+	/**
+	 * @brief Retrieves the y (or z) coordinates of the nodes
+	 * @return Returns a pointer to the first coordinate
+	 */
+	const double *getYCoordinates() const
+	{
+		return p_y.data();
+	}
+
+	/**
+	 * @brief Retrieves the total number of elements of all of the blocks
+	 * @return Returns the number of elements
+	 */
+	int getNumberOfElements() const;
+
+	/**
+	 * @brief Retrieves the largest number of colors that any of the blocks need
+	 * @return Returns the number of colors
+	 */
+	int getNumberOfColors() const;
+
+	/**
+	 * @brief Computes the area of each face of the mesh
+	 * @return Returns the area of each region in m^2
+	 */
+	std::vector<double> getRegionAreas() const;
+
+	/**
+	 * @brief Finds the nodes that belong to at least one element of the faces. The center of an arc is a vertex of the GMSH model
+	 * but not part of the mesh
+	 * @return Returns true for each node that is used by an element
+	 */
+	std::vector<bool> getUsedNodes() const;
+
+	std::vector<elementBlock> *getElementBlocks()
+	{
+		return &p_blocks;
+	}
+
+	std::vector<region> *getRegions()
+	{
+		return &p_regions;
+	}
+
+	std::vector<edgeSegment> *getEdges()
+	{
+		return &p_edges;
+	}
+
+	std::vector<pointNode> *getPoints()
+	{
+		return &p_points;
+	}
+};
+
+#endif
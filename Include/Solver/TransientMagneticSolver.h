@@ -0,0 +1,374 @@
+#ifndef TRANSIENT_MAGNETIC_SOLVER_H_
+#define TRANSIENT_MAGNETIC_SOLVER_H_
+
+#include <vector>
+#include <string>
+#include <map>
+
+#include <common/ProblemDefinition.h>
+#include <common/MagneticMaterial.h>
+#include <common/MagneticBoundary.h>
+#include <common/CircuitProperty.h>
+#include <common/NodalProperty.h>
+#include <common/MagneticPreference.h>
+#include <common/OmniFEMMessage.h>
+#include <common/OS.h>
+
+#include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/dofManager.h>
+#include <Mesh/GMSH/linearSystemCSR.h>
+
+#include <Solver/SolverMesh.h>
+#include <Solver/ElementKernels.h>
+#include <Solver/PotentialConstraints.h>
+#include <Solver/MagneticConditions.h>
+#include <Solver/MagneticRegions.h>
+#include <Solver/ColoredAssembly.h>
+#include <Solver/JilesAthertonModel.h>
+#include <Solver/VTUWriter.h>
+#include <Solver/PVDWriter.h>
+
+
+/**
+ * @class transientMagneticSolver
+ * @author Phillip
+ * @date 17/10/26
+ * @file TransientMagneticSolver.h
+ * @brief 	Steps the planar or axisymmetric magnetic problem curl(H(B)) + sigma dA/dt = J through time with hysteresis. The unknown is the same
+ * 			potential as the magnetostaticSolver. The sources (current densities, circuits, point currents, and prescribed potentials) follow
+ * 			sin(2 pi f t) where f is the frequency of the preferences. Permanent magnets are constant.
+ * 			Nonlinear materials follow the Jiles-Atherton model. Each material has one jilesAthertonModel that holds the state of all of the
+ * 			quadrature points of the material. Only the X parameters of the model are used, so the materials are isotropic. Linear materials
+ * 			use their relative permeability.
+ * 			The solver is picked by the Analyze menu and the batch program when the transient option of the magnetic preferences is set
+ * 			(or with the -t option of the batch program).
+ * 			The time derivative uses the backward Euler method. Each time step is solved with the Newton-Raphson method using the differential
+ * 			reluctivity of the model (the same assembly, line search, and reuse of the incomplete Cholesky factors as the magnetostaticSolver).
+ * 			The size of the time step is picked from an estimate of the local error: the difference between the solution and the linear
+ * 			extrapolation of the last two steps. Steps with a large error or where the Newton-Raphson method fails are rejected and
+ * 			repeated with a smaller step.
+ * 			The losses are the work done on the hysteretic materials (the integral of H dB) and the resistive loss of the eddy currents,
+ * 			averaged over the last period. Eddy currents flow in the conducting regions that are not part of a circuit. The blocks of a circuit
+ * 			carry a uniform current density. For planar problems, the energies and losses are per meter of depth.
+ */
+class transientMagneticSolver
+{
+public:
+	/**
+	 * @brief The coefficients of the equation on one face of the mesh
+	 */
+	struct regionLaw
+	{
+		//! The hysteresis model of the material. Null for linear materials
+		jilesAthertonModel *model = nullptr;
+
+		//! The coefficient of the x derivative of the potential for linear materials. This is the relative reluctivity in the y direction
+		double reluctivityXX = 1;
+
+		//! The coefficient of the y derivative of the potential for linear materials. This is the relative reluctivity in the x direction
+		double reluctivityYY = 1;
+
+		//! The amplitude of the current density times the permeability of free space (T/m)
+		double source = 0;
+
+		//! The coercivity of the magnet in the x direction times the permeability of free space (T)
+		double magnetX = 0;
+
+		//! The coercivity of the magnet in the y direction times the permeability of free space (T)
+		double magnetY = 0;
+
+		//! The conductivity times the permeability of free space (s/m^2). This is zero for regions that do not carry eddy currents
+		double conductivity = 0;
+
+		//! The conductivity in S/m
+		double materialConductivity = 0;
+	};
+
+private:
+	//! The permeability of free space in H/m
+	const double p_vacuumPermeability = 4e-7 * M_PI;
+
+	//! The number of elements that one thread computes at a time
+	static const int p_batchSize = 64;
+
+	//! The largest number of Newton-Raphson iterations of one time step
+	static const int p_maximumNewtonIterations = 30;
+
+	//! The largest number of times that one Newton-Raphson step is shortened
+	static const int p_maximumStepReductions = 10;
+
+	//! The largest number of time steps
+	static const int p_maximumTimeSteps = 100000;
+
+	//! The GMSH model that holds the mesh
+	GModel *p_model;
+
+	//! The mesh that the solver operates on. This is created when the solver is ran
+	solverMesh *p_mesh = nullptr;
+
+	//! The materials of the problem
+	std::vector<magneticMaterial> p_materials;
+
+	//! The boundary conditions of the problem
+	std::vector<magneticBoundary> p_boundaries;
+
+	//! The circuits of the problem
+	std::vector<circuitProperty> p_circuits;
+
+	//! The nodal properties of the problem
+	std::vector<nodalProperty> p_nodalProperties;
+
+	//! The preferences of the problem. This is the problem type, units, frequency, and precision
+	magneticPreference p_preferences;
+
+	//! The hysteresis models of the materials. Each entry belongs to the material at the same index. Null for linear materials
+	std::vector<jilesAthertonModel*> p_hysteresisModels;
+
+	//! The volume of each quadrature point of each hysteresis model (m^3, or m^2 for planar problems)
+	std::vector<std::vector<double>> p_pointWeights;
+
+	//! The first quadrature point of each element in the hysteresis model of its material. -1 for the elements of linear materials
+	std::vector<int> p_elementPoint;
+
+	//! The time of each accepted step (s). The first entry is the start at 0
+	std::vector<double> p_times;
+
+	//! The work done on the hysteretic materials from the start up to each accepted step (J)
+	std::vector<double> p_hysteresisEnergy;
+
+	//! The energy lost to the eddy currents from the start up to each accepted step (J)
+	std::vector<double> p_eddyCurrentEnergy;
+
+	//! The vector potential at each node of the mesh at the end of the run (Wb/m). For axisymmetric problems, this is the phi component
+	std::vector<double> p_potential;
+
+	//! The x (or r) component of the flux density of each element at the end of the run, averaged over the element (T)
+	std::vector<double> p_fluxDensityX;
+
+	//! The y (or z) component of the flux density of each element at the end of the run, averaged over the element (T)
+	std::vector<double> p_fluxDensityY;
+
+	//! The number of time steps that were rejected
+	int p_numberOfRejectedSteps = 0;
+
+	//! The path and name (without an extension) that the potential of each accepted step is written to. Empty if the steps are not written
+	std::string p_seriesPath;
+
+	//! Set to true to compress the .vtu files of the steps
+	bool p_isSeriesCompressed = true;
+
+	/**
+	 * @brief Computes the flux density at the quadrature points of the hysteretic elements of a block and writes it into the trial
+	 * state of the hysteresis models
+	 * @param block The block of the elements
+	 * @param blockStart The index of the first element of the block in the mesh
+	 * @param kernel The quadrature kernel of the block
+	 * @param laws The coefficients of each region
+	 * @param solution The value of the unknown at each node
+	 * @param axisymmetric Set to true if the problem is axisymmetric
+	 */
+	void computeTrialFlux(const solverMesh::elementBlock &block, int blockStart, const elementKernel &kernel, const std::vector<regionLaw> &laws,
+						  const std::vector<double> &solution, bool axisymmetric);
+
+	/**
+	 * @brief Computes the element matrices (the Jacobian of the time step) and the element vectors (the Jacobian times the current
+	 * solution minus the residual) of a run of elements of a block
+	 * @param block The block that the elements belong to
+	 * @param blockStart The index of the first element of the block in the mesh
+	 * @param first The index of the first element
+	 * @param count The number of elements
+	 * @param kernel The quadrature kernel of the block
+	 * @param massKernel The quadrature kernel of the eddy current term
+	 * @param laws The coefficients of each region
+	 * @param solution The current value of the unknown at each node
+	 * @param previousSolution The value of the unknown at the last accepted time step
+	 * @param inverseStep One over the size of the time step (1/s)
+	 * @param waveform The value of the waveform of the sources at the end of the time step
+	 * @param axisymmetric Set to true if the problem is axisymmetric
+	 * @param buffer Scratch space. This is resized as needed
+	 * @param matrices The element matrices. The matrix of element e is stored at e * n * n where n is the number of nodes of the element
+	 * @param vectors The element vectors. The vector of element e is stored at e * n
+	 */
+	void computeElements(const solverMesh::elementBlock &block, int blockStart, int first, int count, const elementKernel &kernel, const elementKernel &massKernel,
+						 const std::vector<regionLaw> &laws, const std::vector<double> &solution, const std::vector<double> &previousSolution,
+						 double inverseStep, double waveform, bool axisymmetric, std::vector<double> &buffer, double *matrices, double *vectors);
+
+	/**
+	 * @brief Computes the energy that the eddy currents dissipate over a time step
+	 * @param laws The coefficients of each region
+	 * @param solution The value of the unknown at each node at the end of the step
+	 * @param previousSolution The value of the unknown at each node at the start of the step
+	 * @param step The size of the time step (s)
+	 * @param axisymmetric Set to true if the problem is axisymmetric
+	 * @return Returns the energy in J (J/m for planar problems)
+	 */
+	double getEddyCurrentEnergy(const std::vector<regionLaw> &laws, const std::vector<double> &solution, const std::vector<double> &previousSolution,
+								double step, bool axisymmetric);
+
+	/**
+	 * @brief Finds the coefficients of each face of the mesh from the physical groups of the face. This creates the hysteresis
+	 * models of the nonlinear materials and finds the current density of the circuits
+	 * @param laws Returns the coefficients of each region
+	 */
+	void createRegionLaws(std::vector<regionLaw> &laws);
+
+	/**
+	 * @brief Gives each hysteretic element its quadrature points in the model of its material and finds the volume of each point
+	 * @param laws The coefficients of each region
+	 * @param axisymmetric Set to true if the problem is axisymmetric
+	 */
+	void createQuadraturePoints(const std::vector<regionLaw> &laws, bool axisymmetric);
+
+	/**
+	 * @brief Finds the average power over the last period of the excitation from the accumulated energy
+	 * @param energy The energy at each accepted step
+	 * @return Returns the power in W (W/m for planar problems)
+	 */
+	double getAveragePower(const std::vector<double> &energy);
+
+	/**
+	 * @brief Finds the average flux density of each element from the unknown at the nodes
+	 * @param solution The value of the unknown at each node
+	 * @param axisymmetric Set to true if the problem is axisymmetric
+	 */
+	void computeFluxDensity(const std::vector<double> &solution, bool axisymmetric);
+
+	/**
+	 * @brief 	Writes the potential at the nodes and the flux density of the elements of an accepted step into a .vtu file and adds the
+	 * 			file to the collection of the series
+	 * @param collection The collection of the series
+	 * @param solution The value of the unknown at each node
+	 * @param axisymmetric Set to true if the problem is axisymmetric
+	 * @return Returns false if the file could not be written
+	 */
+	bool writeStep(pvdWriter &collection, const std::vector<double> &solution, bool axisymmetric);
+
+	//! Deletes the hysteresis models
+	void clearModels()
+	{
+		for(auto modelIterator = p_hysteresisModels.begin(); modelIterator != p_hysteresisModels.end(); modelIterator++)
+			delete *modelIterator;
+
+		p_hysteresisModels.clear();
+	}
+
+public:
+	/**
+	 * @brief Creates the solver. The properties of the problem are copied so that the solver can be ran on its own
+	 * @param definition The problem definition that holds the materials, boundary conditions, and preferences
+	 * @param model The GMSH model that has been meshed
+	 */
+	transientMagneticSolver(problemDefinition &definition, GModel *model);
+
+	~transientMagneticSolver()
+	{
+		clearModels();
+		delete p_mesh;
+	}
+
+	/**
+	 * @brief Runs the solver from a demagnetized state at t = 0. The time that each step takes is reported to the solver status window
+	 * @param numberOfPeriods The number of periods of the excitation to run for
+	 * @param stepsPerPeriod The number of time steps per period that the first step is sized for. This is also the smallest number of
+	 * steps per period that the step controller allows
+	 * @param tolerance The largest local error of a time step relative to the largest potential
+	 * @return Returns true if all of the time steps converged
+	 */
+	bool solve(int numberOfPeriods = 2, int stepsPerPeriod = 40, double tolerance = 1e-3);
+
+	/**
+	 * @brief 	Writes the potential of every accepted step (and of the start at t = 0) while the solver runs. Each step is written
+	 * 			into its own .vtu file and the files are listed in a .pvd collection that ParaView opens as a time series
+	 * @param basePath The path and name of the series without an extension. The collection is basePath.pvd
+	 * @param compress Set to true to compress the .vtu files
+	 */
+	void setSeriesOutput(std::string basePath, bool compress = true)
+	{
+		p_seriesPath = basePath;
+		p_isSeriesCompressed = compress;
+	}
+
+	std::vector<double> *getTimes()
+	{
+		return &p_times;
+	}
+
+	/**
+	 * @brief Retrieves the work done on the hysteretic materials up to each accepted step. Over a full period, this is the hysteresis loss
+	 * @return Returns a pointer to the energies in J (J/m for planar problems)
+	 */
+	std::vector<double> *getHysteresisEnergy()
+	{
+		return &p_hysteresisEnergy;
+	}
+
+	/**
+	 * @brief Retrieves the energy dissipated by the eddy currents up to each accepted step
+	 * @return Returns a pointer to the energies in J (J/m for planar problems)
+	 */
+	std::vector<double> *getEddyCurrentEnergy()
+	{
+		return &p_eddyCurrentEnergy;
+	}
+
+	/**
+	 * @brief Retrieves the hysteresis loss averaged over the last period
+	 * @return Returns the loss in W (W/m for planar problems)
+	 */
+	double getHysteresisLoss()
+	{
+		return getAveragePower(p_hysteresisEnergy);
+	}
+
+	/**
+	 * @brief Retrieves the eddy current loss averaged over the last period
+	 * @return Returns the loss in W (W/m for planar problems)
+	 */
+	double getEddyCurrentLoss()
+	{
+		return getAveragePower(p_eddyCurrentEnergy);
+	}
+
+	/**
+	 * @brief Retrieves the vector potential of the nodes of the mesh at the end of the run. The order of the nodes is the order of the solver mesh
+	 * @return Returns a pointer to the vector potential
+	 */
+	std::vector<double> *getPotential()
+	{
+		return &p_potential;
+	}
+
+	/**
+	 * @brief Retrieves the x (or r) component of the flux density of the elements at the end of the run
+	 * @return Returns a pointer to the flux density
+	 */
+	std::vector<double> *getFluxDensityX()
+	{
+		return &p_fluxDensityX;
+	}
+
+	/**
+	 * @brief Retrieves the y (or z) component of the flux density of the elements at the end of the run
+	 * @return Returns a pointer to the flux density
+	 */
+	std::vector<double> *getFluxDensityY()
+	{
+		return &p_fluxDensityY;
+	}
+
+	int getNumberOfRejectedSteps()
+	{
+		return p_numberOfRejectedSteps;
+	}
+
+	/**
+	 * @brief Retrieves the mesh that was solved
+	 * @return Returns the mesh. Null if the solver was not ran yet
+	 */
+	solverMesh *getMesh()
+	{
+		return p_mesh;
+	}
+};
+
+#endif
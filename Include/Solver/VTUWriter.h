@@ -0,0 +1,218 @@
+#ifndef VTU_WRITER_H_
+#define VTU_WRITER_H_
+
+#include <string>
+#include <vector>
+#include <complex>
+#include <functional>
+#include <stdint.h>
+#include <cstdio>
+
+#include <common/OmniFEMMessage.h>
+
+#include <Solver/SolverMesh.h>
+
+
+/**
+ * @class vtuWriter
+ * @author Phillip
+ * @date 17/10/26
+ * @file VTUWriter.h
+ * @brief 	Writes a solver mesh and the solution on it into a VTK XML unstructured grid (.vtu) file that can be opened in ParaView.
+ * 			All of the arrays are stored in the appended data section at the end of the file, either as raw bytes or as base64.
+ * 			The arrays are never formatted value by value. The coordinates and the connectivity are copied out of the flat arrays
+ * 			of the solver mesh in large chunks. The chunks are filled (and encoded) by several threads and written in order.
+ * 			When the program is built with zlib (HAVE_LIBZ), the arrays can also be compressed. Each chunk is then compressed on
+ * 			its own by the threads, which is the block layout of the vtkZLibDataCompressor. The fields are added before the
+ * 			file is written and are only referenced, so they need to exist until write is called. The point data is in the
+ * 			order of the nodes of the solver mesh and the cell data is in the order of the elements of the blocks of the solver mesh.
+ */
+class vtuWriter
+{
+private:
+	//! One component of a field. The value of entry i is values[i * stride]
+	struct fieldComponent
+	{
+		const double *values;
+
+		int stride;
+	};
+
+	//! A field that is attached to the points or the cells
+	struct field
+	{
+		//! The name that ParaView shows
+		std::string name;
+
+		//! The components of the field. Vectors always have 3 components in the file, the missing ones are written as 0
+		std::vector<fieldComponent> components;
+
+		//! The number of components that are written. This is 1 for scalars and 3 for vectors
+		int numberOfComponents;
+	};
+
+	//! One array of the appended data section
+	struct dataArray
+	{
+		//! The name of the array. Empty for the coordinates of the points
+		std::string name;
+
+		//! The VTK type of the values (Float64, Int64, Int32 or UInt8)
+		std::string type;
+
+		//! The size of one value in bytes
+		size_t valueSize;
+
+		int numberOfComponents;
+
+		//! The total number of values (the number of tuples times the number of components)
+		size_t numberOfValues;
+
+		//! Copies count values starting from the value first into the buffer
+		std::function<void(size_t first, size_t count, char *buffer)> fill;
+
+		//! The header of the compressed array: the number of blocks, the block size, the size of the last block and the size of each compressed block
+		std::vector<uint64_t> compressedHeader;
+
+		//! The compressed blocks one after another
+		std::vector<std::string> compressedBlocks;
+
+		//! The offset of the array from the start of the appended data
+		uint64_t offset = 0;
+	};
+
+	//! The number of values in one chunk. This is a multiple of 3 so that the base64 encoding of one chunk does not need padding
+	static const size_t p_chunkSize = 3 * 32768;
+
+	//! The mesh that is written
+	solverMesh *p_mesh;
+
+	//! Set to true to encode the appended data as base64 instead of raw bytes
+	bool p_isBase64;
+
+	//! Set to true to compress the arrays. This is ignored if the program is built without zlib
+	bool p_isCompressed;
+
+	//! The fields at the nodes
+	std::vector<field> p_pointData;
+
+	//! The fields of the elements
+	std::vector<field> p_cellData;
+
+	/**
+	 * @brief Compresses each chunk of an array and stores the blocks and the header in the array
+	 * @param array The array that is compressed
+	 */
+	void compressArray(dataArray &array);
+
+	/**
+	 * @brief Computes the number of bytes that an array takes up in the appended data section
+	 * @param array The array. This needs to be compressed first if the arrays are compressed
+	 * @return Returns the number of bytes including the header of the array
+	 */
+	uint64_t getStoredSize(const dataArray &array) const;
+
+	/**
+	 * @brief Writes the header and the data of an array into the appended data section. The chunks are filled by several threads at once
+	 * @param file The file that is written to
+	 * @param array The array that is written
+	 * @return Returns false if the file could not be written
+	 */
+	bool writeArray(FILE *file, dataArray &array);
+
+	/**
+	 * @brief Creates the array of a field
+	 * @param data The field
+	 * @param numberOfTuples The number of nodes or the number of elements
+	 * @param tupleMap Converts the index of a tuple in the file into the index of the value of the field
+	 * @return Returns the array that holds the field
+	 */
+	dataArray getFieldArray(const field &data, size_t numberOfTuples, std::function<size_t(size_t)> tupleMap);
+
+	/**
+	 * @brief Encodes bytes as base64 and adds them to the end of a string
+	 * @param data The bytes
+	 * @param size The number of bytes
+	 * @param output The string that the characters are added to
+	 */
+	static void encodeBase64(const unsigned char *data, size_t size, std::string &output);
+
+public:
+	/**
+	 * @brief Creates the writer
+	 * @param mesh The mesh that is written. The coordinates are written in meters
+	 * @param base64 Set to true to encode the appended data as base64. Raw data is smaller and faster to write
+	 * @param compress Set to true to compress the arrays with zlib
+	 */
+	vtuWriter(solverMesh *mesh, bool base64 = false, bool compress = false);
+
+	/**
+	 * @brief Adds a scalar field at the nodes
+	 * @param name The name of the field
+	 * @param values The value at each node. Entry i is the value at the node at values[i * stride]
+	 * @param stride The distance between two values
+	 */
+	void addPointData(std::string name, const double *values, int stride = 1);
+
+	/**
+	 * @brief Adds a vector field at the nodes. The z component is written as 0
+	 * @param name The name of the field
+	 * @param valuesX The x (or r) component at each node
+	 * @param valuesY The y (or z) component at each node
+	 * @param stride The distance between two values
+	 */
+	void addPointVector(std::string name, const double *valuesX, const double *valuesY, int stride = 1);
+
+	/**
+	 * @brief Adds a scalar field of the elements
+	 * @param name The name of the field
+	 * @param values The value of each element in the order of the blocks of the solver mesh
+	 * @param stride The distance between two values
+	 */
+	void addCellData(std::string name, const double *values, int stride = 1);
+
+	/**
+	 * @brief Adds a vector field of the elements. The z component is written as 0
+	 * @param name The name of the field
+	 * @param valuesX The x (or r) component of each element
+	 * @param valuesY The y (or z) component of each element
+	 * @param stride The distance between two values
+	 */
+	void addCellVector(std::string name, const double *valuesX, const double *valuesY, int stride = 1);
+
+	/**
+	 * @brief Adds the real and the imaginary parts of a phasor at the nodes as two scalar fields
+	 * @param name The name of the field. The fields are called name_real and name_imaginary
+	 * @param values The phasor at each node
+	 */
+	void addPointData(std::string name, const std::vector<std::complex<double>> &values);
+
+	/**
+	 * @brief Adds the real and the imaginary parts of a phasor of the elements as two scalar fields
+	 * @param name The name of the field. The fields are called name_real and name_imaginary
+	 * @param values The phasor of each element
+	 */
+	void addCellData(std::string name, const std::vector<std::complex<double>> &values);
+
+	/**
+	 * @brief Writes the file. The index of the region of each element is always written as the cell data "region"
+	 * @param filePath The path of the .vtu file
+	 * @return Returns false if the file could not be written
+	 */
+	bool write(std::string filePath);
+
+	/**
+	 * @brief Finds the VTK cell type of a GMSH element type
+	 * @param mshType The GMSH type of the element (MSH_TRI_3, MSH_QUA_9, ...)
+	 * @return Returns the VTK cell type. Returns 0 for the elements that VTK does not have with the same node ordering
+	 */
+	static int getVTKType(int mshType);
+
+	/**
+	 * @brief Checks if the arrays can be compressed
+	 * @return Returns true if the program was built with zlib
+	 */
+	static bool canCompress();
+};
+
+#endif
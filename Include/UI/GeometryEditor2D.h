@@ -3,11 +3,15 @@
 
 #include <math.h>
 #include <vector>
+#include <unordered_map>
 
 #include <common/Vector.h>
 #include <common/plfcolony.h>
 
 #include <UI/geometryShapes.h>
+#include <UI/SpatialGrid.h>
+
+#include <Mesh/BoundingBox.h>
 
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
@@ -25,6 +29,7 @@ class geometryEditor2D
 {
 private:
 	friend class boost::serialization::access;
+	friend class projectFile;
 	
 	template<class Archive>
 	void save(Archive &ar, const unsigned int version) const
@@ -89,7 +94,7 @@ private:
 		for(std::vector<blockLabel>::iterator labelIterator = loadLabels.begin(); labelIterator != loadLabels.end(); labelIterator++)
 			_blockLabelList.insert(*labelIterator);
 			
-		
+		invalidateSpatialIndex();
 	}
 	BOOST_SERIALIZATION_SPLIT_MEMBER()
     /*
@@ -209,6 +214,162 @@ private:
 	unsigned long _nodeNumber = 0;
 	
 	unsigned long p_arcNumber = 0;
+	
+	//! The spatial index for the nodes. Used to quickly find the nodes that are close to a point
+	spatialGrid<node> p_nodeGrid;
+	
+	//! The spatial index for the block labels
+	spatialGrid<blockLabel> p_blockLabelGrid;
+	
+	//! The spatial index for the lines. Each line is stored by the bounding box of the two endpoints
+	spatialGrid<edgeLineShape> p_lineGrid;
+	
+	//! The spatial index for the arcs. Each arc is stored by the bounding box of the circle that the arc lies on
+	spatialGrid<arcShape> p_arcGrid;
+	
+	//! The total number of geometry pieces contained in the spatial index when the index was last rebuilt
+	size_t p_spatialIndexSizeAtRebuild = 0;
+	
+	//! The bounding box of all of the nodes. This is used in computing the default tolerance for lines and arcs
+	boundingBox p_nodeExtent;
+	
+	//! The nodes that were moved through moveNode since the last time that checkIntersections was called
+	std::vector<node*> p_movedNodes;
+	
+	//! The block labels that were moved through moveBlockLabel since the last time that checkIntersections was called
+	std::vector<blockLabel*> p_movedLabels;
+	
+	//! The lines that changed shape since the last time that checkIntersections was called. These are the lines connected to a moved node
+	std::vector<edgeLineShape*> p_movedLines;
+	
+	//! The arcs that changed shape since the last time that checkIntersections was called
+	std::vector<arcShape*> p_movedArcs;
+	
+	/**
+	 * @brief Computes the bounding box of a line
+	 * @param lineSegment The line that the bounding box will be computed for
+	 * @return Returns the bounding box of the two endpoints of the line
+	 */
+	boundingBox getBoundingBox(edgeLineShape &lineSegment);
+	
+	/**
+	 * @brief 	Computes the bounding box of an arc. In order to keep this fast, the bounding box 
+	 * 			is taken to be the box around the entire circle that the arc lies on.
+	 * @param arcSegment The arc that the bounding box will be computed for
+	 * @return Returns the bounding box of the circle that the arc lies on
+	 */
+	boundingBox getBoundingBox(arcShape &arcSegment);
+	
+	/**
+	 * @brief Adds the node to the spatial index. If the node already exists in the index, the entry is updated
+	 * @param nodeToIndex The node that is to be added
+	 */
+	void indexNode(node &nodeToIndex)
+	{
+		p_nodeGrid.insert(&nodeToIndex, boundingBox(nodeToIndex.getCenter()));
+		
+		if(p_nodeGrid.size() == 1)
+			p_nodeExtent = boundingBox(nodeToIndex.getCenter());
+		else
+			p_nodeExtent.addPoint(nodeToIndex.getCenter());
+	}
+	
+	/**
+	 * @brief Adds the block label to the spatial index. If the label already exists in the index, the entry is updated
+	 * @param labelToIndex The block label that is to be added
+	 */
+	void indexBlockLabel(blockLabel &labelToIndex)
+	{
+		p_blockLabelGrid.insert(&labelToIndex, boundingBox(labelToIndex.getCenter()));
+	}
+	
+	/**
+	 * @brief 	Adds the line to the spatial index. If the line already exists in the index, the entry is updated.
+	 * 			This function needs to be called whenever one of the endpoints of the line is changed
+	 * @param lineToIndex The line that is to be added
+	 */
+	void indexLine(edgeLineShape &lineToIndex)
+	{
+		p_lineGrid.insert(&lineToIndex, getBoundingBox(lineToIndex));
+	}
+	
+	/**
+	 * @brief 	Adds the arc to the spatial index. If the arc already exists in the index, the entry is updated.
+	 * 			This function needs to be called after the arc has been calculated
+	 * @param arcToIndex The arc that is to be added
+	 */
+	void indexArc(arcShape &arcToIndex)
+	{
+		p_arcGrid.insert(&arcToIndex, getBoundingBox(arcToIndex));
+	}
+	
+	/**
+	 * @brief 	Function that is called before the spatial index is queried. This function will rebuild the index
+	 * 			if the index is invalid, if the number of geometry pieces in the index does not match the colonies
+	 * 			(this occurs when something was erased from one of the lists outside of this class), or if the 
+	 * 			number of geometry pieces has more then doubled since the last time the index was built. The last
+	 * 			case is needed so that the size of the cells keeps up with the model.
+	 */
+	void ensureSpatialIndex();
+	
+	/**
+	 * @brief Function that will clear the spatial index and add every node, block label, line, and arc back into it.
+	 */
+	void rebuildSpatialIndex();
+	
+	/**
+	 * @brief 	Checks if the spatial index matches the colonies. This is false if the index was invalidated or
+	 * 			if geometry was erased from one of the lists outside of this class
+	 * @return Returns true if every geometry piece is in the index
+	 */
+	bool spatialIndexIsCurrent()
+	{
+		if(!p_nodeGrid.isValid() || !p_blockLabelGrid.isValid() || !p_lineGrid.isValid() || !p_arcGrid.isValid())
+			return false;
+		
+		return (p_nodeGrid.size() == _nodeList.size() && p_blockLabelGrid.size() == _blockLabelList.size() && p_lineGrid.size() == _lineList.size() && p_arcGrid.size() == _arcList.size());
+	}
+	
+	/**
+	 * @brief 	Finds the nodes that lie within the tolerance of the bounding box of any of the lines or arcs. This is
+	 * 			used by checkIntersections to find the nodes that a moved line or arc could now be on top of
+	 * @param lines The lines to search around
+	 * @param arcs The arcs to search around
+	 * @param tolerance The distance that the bounding boxes are grown by
+	 * @param foundNodes The list that the nodes will be added to
+	 */
+	void findNodesNear(std::vector<edgeLineShape*> &lines, std::vector<arcShape*> &arcs, double tolerance, std::vector<node*> &foundNodes);
+	
+	/**
+	 * @brief 	Computes the default tolerance used in the addLine and addArc functions. This is a small
+	 * 			fraction of the diagonal of the box around all of the nodes
+	 * @return Returns the default tolerance
+	 */
+	double getDefaultTolerance()
+	{
+		if(_nodeList.size() < 2)
+			return 1.0e-08;
+		
+		ensureSpatialIndex();
+		
+		return sqrt(pow(p_nodeExtent.getMaxBounds().x - p_nodeExtent.getMinBounds().x, 2) + pow(p_nodeExtent.getMaxBounds().y - p_nodeExtent.getMinBounds().y, 2)) * 1.0e-06;
+	}
+
+	/**
+	 * @brief 	Breaks a line into two lines at the node. The original line will end at the node and a
+	 * 			new line is created that starts at the node. Both lines are updated in the spatial index.
+	 * @param lineSegment The line that is being broken
+	 * @param splitNode The node that lies on the line
+	 */
+	void splitLineAtNode(edgeLineShape &lineSegment, node &splitNode);
+
+	/**
+	 * @brief 	Breaks an arc into two arcs at the node. The original arc will end at the node and a
+	 * 			new arc is created that starts at the node. Both arcs are updated in the spatial index.
+	 * @param arcSegment The arc that is being broken
+	 * @param splitNode The node that lies on the arc
+	 */
+	void splitArcAtNode(arcShape &arcSegment, node &splitNode);
     
     //! Function that will get the intersection X, Y point of two lines crossing each other
     /*!
@@ -449,6 +610,7 @@ public:
         newNode.setCenter(xPoint, yPoint);
         newNode.setDraggingState(true);
         _lastNodeAdded = _nodeList.insert(newNode);
+        indexNode(*_lastNodeAdded);
     }
     
     //! Function that is called to add a block label to the block label list
@@ -479,6 +641,7 @@ public:
         newLabel.setCenter(xPoint, yPoint);
         newLabel.setDraggingState(true);
         _lastBlockLabelAdded = _blockLabelList.insert(newLabel);
+        indexBlockLabel(*_lastBlockLabelAdded);
     }
     
     //! Function that is called in order to add a line to the line list
@@ -632,6 +795,10 @@ public:
         nodes/lines/arcs. This function will check all geometry (or the selected geometry) if any intersections. If there are intersections,
         then the function will place a node at the intersections. As for block labels, the function will check to see if after a move, there
         are any block labels ontop of a geometry piece, if so, this function will return true.
+        Only the pairs of geometry pieces whose bounding boxes share a cell of the spatial index are tested against each other.
+        If the geometry was moved through moveNode and moveBlockLabel, only the moved geometry (and the geometry that it now
+        touches) is checked. Otherwise, all of the geometry is checked.
+        The intersection points are collected first and the nodes are added once all of the pairs have been tested.
         \param editedGeometry Arguement that is used to specify what geometry needs to be checked for intersections
         \param tolerance This is the value that is used for if any nodes need to be created at intersection points. This value is passed into the addNode function
         \return Returns True if there are any block labels ontop of another geometry shape. Otherwise, returns False.
@@ -657,35 +824,257 @@ public:
 	 * 			after the data structure is loaded, then the addresses of all of nodes will change once the 
 	 * 			data structure is copied. Therefor, it is necessary to call this function which will rebuild
 	 * 			all of the node addresses contained within the arcs/lines once the data structure is copied.
-	 * 			The function will loop through the entire node list and compare the node with the node ID saved
-	 * 			in the arcs and lines. If there is a match for either the first or second node, the function 
-	 * 			will then set the address of the first/second node of the arc/line to the matched node.
+	 * 			The nodes are looked up by the node ID saved in the arcs and lines. The lookup table is built
+	 * 			once so that the time does not grow with the number of nodes times the number of lines.
 	 */
 	void rebuildDataStructure()
 	{
+		std::unordered_map<unsigned long, node*> nodeTable;
+		
+		nodeTable.reserve(_nodeList.size());
+		
 		for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); nodeIterator++)
+			nodeTable[nodeIterator->getNodeID()] = &(*nodeIterator);
+		
+		for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); lineIterator++)
 		{
-			for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); lineIterator++)
-			{
-				if(nodeIterator->getNodeID() == lineIterator->getFirstNodeID())
-					lineIterator->setFirstNode(*nodeIterator);
-				else if(nodeIterator->getNodeID() == lineIterator->getSecondNodeID())
-					lineIterator->setSecondNode(*nodeIterator);
-			}
+			std::unordered_map<unsigned long, node*>::iterator firstNode = nodeTable.find(lineIterator->getFirstNodeID());
+			std::unordered_map<unsigned long, node*>::iterator secondNode = nodeTable.find(lineIterator->getSecondNodeID());
+			
+			if(firstNode != nodeTable.end())
+				lineIterator->setFirstNode(*firstNode->second);
 			
-			for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); arcIterator++)
-			{
-				if(nodeIterator->getNodeID() == arcIterator->getFirstNodeID())
-					arcIterator->setFirstNode(*nodeIterator);
-				else if(nodeIterator->getNodeID() == arcIterator->getSecondNodeID())
-					arcIterator->setSecondNode(*nodeIterator);
-			}
+			if(secondNode != nodeTable.end())
+				lineIterator->setSecondNode(*secondNode->second);
 		}
 		
+		for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); arcIterator++)
+		{
+			std::unordered_map<unsigned long, node*>::iterator firstNode = nodeTable.find(arcIterator->getFirstNodeID());
+			std::unordered_map<unsigned long, node*>::iterator secondNode = nodeTable.find(arcIterator->getSecondNodeID());
+			
+			if(firstNode != nodeTable.end())
+				arcIterator->setFirstNode(*firstNode->second);
+			
+			if(secondNode != nodeTable.end())
+				arcIterator->setSecondNode(*secondNode->second);
+		}
+		
+		_lastArcAdded = _arcList.begin();
+		_lastBlockLabelAdded = _blockLabelList.begin();
+		_lastLineAdded = _lineList.begin();
+		_lastNodeAdded = _nodeList.begin();
+		
+		invalidateSpatialIndex();
+	}
+	
+	/**
+	 * @brief 	Function that is called in order to mark the spatial index as out of date. This function needs to be
+	 * 			called whenever geometry is changed outside of this class without going through moveNode or
+	 * 			moveBlockLabel. The index will be rebuilt the next time that the index is needed. Geometry is
+	 * 			erased through eraseNode, eraseBlockLabel, eraseLine and eraseArc instead.
+	 */
+	void invalidateSpatialIndex()
+	{
+		p_nodeGrid.clear();
+		p_blockLabelGrid.clear();
+		p_lineGrid.clear();
+		p_arcGrid.clear();
+		
+		// checkIntersections will look at all of the geometry anyways
+		p_movedNodes.clear();
+		p_movedLabels.clear();
+		p_movedLines.clear();
+		p_movedArcs.clear();
+	}
+	
+	/**
+	 * @brief 	Removes all of the geometry from the editor and resets the node and arc numbering. This is called before
+	 * 			a project is read into the editor so that the project does not need to be read into a copy first.
+	 */
+	void clear()
+	{
+		_nodeList.clear();
+		_lineList.clear();
+		_arcList.clear();
+		_blockLabelList.clear();
+
+		_nodeNumber = 0;
+		p_arcNumber = 0;
+		resetIndexs();
+
 		_lastArcAdded = _arcList.begin();
 		_lastBlockLabelAdded = _blockLabelList.begin();
 		_lastLineAdded = _lineList.begin();
 		_lastNodeAdded = _nodeList.begin();
+
+		invalidateSpatialIndex();
+	}
+	
+	/**
+	 * @brief 	Moves a node to a new position. The lines and arcs that are connected to the node are updated along
+	 * 			with the spatial index. The node and the connected lines and arcs are remembered so that the next call to
+	 * 			checkIntersections only has to look at the geometry that was moved instead of the entire model.
+	 * @param movedNode The node that is to be moved
+	 * @param xPoint The new x coordinate of the node
+	 * @param yPoint The new y coordinate of the node
+	 */
+	void moveNode(node &movedNode, double xPoint, double yPoint);
+	
+	/**
+	 * @brief Moves a block label to a new position and updates the spatial index. See moveNode
+	 * @param movedLabel The block label that is to be moved
+	 * @param xPoint The new x coordinate of the block label
+	 * @param yPoint The new y coordinate of the block label
+	 */
+	void moveBlockLabel(blockLabel &movedLabel, double xPoint, double yPoint)
+	{
+		ensureSpatialIndex();
+		
+		movedLabel.setCenter(xPoint, yPoint);
+		indexBlockLabel(movedLabel);
+		p_movedLabels.push_back(&movedLabel);
+	}
+	
+	/**
+	 * @brief 	Updates the entry of the node in the spatial index. This function needs to be called after
+	 * 			a single node is moved outside of this class (for example, when a node is being dragged)
+	 * @param movedNode The node that was moved
+	 */
+	void updateSpatialIndex(node &movedNode)
+	{
+		if(p_nodeGrid.contains(&movedNode))
+			indexNode(movedNode);
+	}
+	
+	/**
+	 * @brief 	Updates the entry of the block label in the spatial index. This function needs to be called after
+	 * 			a single block label is moved outside of this class (for example, when a label is being dragged)
+	 * @param movedLabel The block label that was moved
+	 */
+	void updateSpatialIndex(blockLabel &movedLabel)
+	{
+		if(p_blockLabelGrid.contains(&movedLabel))
+			indexBlockLabel(movedLabel);
+	}
+	
+	/**
+	 * @brief 	Erases the node from the node list and from the spatial index. Geometry that is erased outside of this
+	 * 			class needs to go through these functions. Erasing from the colony directly leaves the index out of
+	 * 			date and the whole index is rebuilt on the next query.
+	 * @param nodeToErase The node that is to be erased
+	 * @return Returns the iterator to the node that follows the erased node
+	 */
+	plf::colony<node>::iterator eraseNode(plf::colony<node>::iterator nodeToErase)
+	{
+		bool isLastNodeAdded = (nodeToErase == _lastNodeAdded);
+		
+		p_nodeGrid.remove(&(*nodeToErase));
+		plf::colony<node>::iterator nextNode = _nodeList.erase(nodeToErase);
+		
+		if(isLastNodeAdded)
+			_lastNodeAdded = _nodeList.begin();
+		
+		return nextNode;
+	}
+	
+	/**
+	 * @brief Erases the block label from the block label list and from the spatial index. See eraseNode
+	 * @param labelToErase The block label that is to be erased
+	 * @return Returns the iterator to the block label that follows the erased label
+	 */
+	plf::colony<blockLabel>::iterator eraseBlockLabel(plf::colony<blockLabel>::iterator labelToErase)
+	{
+		bool isLastLabelAdded = (labelToErase == _lastBlockLabelAdded);
+		
+		p_blockLabelGrid.remove(&(*labelToErase));
+		plf::colony<blockLabel>::iterator nextLabel = _blockLabelList.erase(labelToErase);
+		
+		if(isLastLabelAdded)
+			_lastBlockLabelAdded = _blockLabelList.begin();
+		
+		return nextLabel;
+	}
+	
+	/**
+	 * @brief Erases the line from the line list and from the spatial index. See eraseNode
+	 * @param lineToErase The line that is to be erased
+	 * @return Returns the iterator to the line that follows the erased line
+	 */
+	plf::colony<edgeLineShape>::iterator eraseLine(plf::colony<edgeLineShape>::iterator lineToErase)
+	{
+		bool isLastLineAdded = (lineToErase == _lastLineAdded);
+		
+		p_lineGrid.remove(&(*lineToErase));
+		plf::colony<edgeLineShape>::iterator nextLine = _lineList.erase(lineToErase);
+		
+		if(isLastLineAdded)
+			_lastLineAdded = _lineList.begin();
+		
+		return nextLine;
+	}
+	
+	/**
+	 * @brief Erases the arc from the arc list and from the spatial index. See eraseNode
+	 * @param arcToErase The arc that is to be erased
+	 * @return Returns the iterator to the arc that follows the erased arc
+	 */
+	plf::colony<arcShape>::iterator eraseArc(plf::colony<arcShape>::iterator arcToErase)
+	{
+		bool isLastArcAdded = (arcToErase == _lastArcAdded);
+		
+		p_arcGrid.remove(&(*arcToErase));
+		plf::colony<arcShape>::iterator nextArc = _arcList.erase(arcToErase);
+		
+		if(isLastArcAdded)
+			_lastArcAdded = _arcList.begin();
+		
+		return nextArc;
+	}
+	
+	/**
+	 * @brief 	Finds all of the nodes that could be inside of the box. The list can contain nodes that are
+	 * 			slightly outside of the box so the caller needs to check the nodes if an exact answer is needed
+	 * @param searchBox The box to search
+	 * @param foundNodes The list that the nodes will be added to
+	 */
+	void queryNodes(boundingBox searchBox, std::vector<node*> &foundNodes)
+	{
+		ensureSpatialIndex();
+		p_nodeGrid.query(searchBox, foundNodes);
+	}
+	
+	/**
+	 * @brief Finds all of the block labels that could be inside of the box. See queryNodes for more details
+	 * @param searchBox The box to search
+	 * @param foundLabels The list that the block labels will be added to
+	 */
+	void queryBlockLabels(boundingBox searchBox, std::vector<blockLabel*> &foundLabels)
+	{
+		ensureSpatialIndex();
+		p_blockLabelGrid.query(searchBox, foundLabels);
+	}
+	
+	/**
+	 * @brief Finds all of the lines whose bounding box could overlap the box. See queryNodes for more details
+	 * @param searchBox The box to search
+	 * @param foundLines The list that the lines will be added to
+	 */
+	void queryLines(boundingBox searchBox, std::vector<edgeLineShape*> &foundLines)
+	{
+		ensureSpatialIndex();
+		p_lineGrid.query(searchBox, foundLines);
+	}
+	
+	/**
+	 * @brief Finds all of the arcs whose bounding box could overlap the box. See queryNodes for more details
+	 * @param searchBox The box to search
+	 * @param foundArcs The list that the arcs will be added to
+	 */
+	void queryArcs(boundingBox searchBox, std::vector<arcShape*> &foundArcs)
+	{
+		ensureSpatialIndex();
+		p_arcGrid.query(searchBox, foundArcs);
 	}
 };
 
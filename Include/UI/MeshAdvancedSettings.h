@@ -23,8 +23,8 @@
  * @brief This class handles all of the additional settings that the user can select or edit that should be
  * 			more hidden from the the main view. These settings apply directly to the mesh settings. This
  * 			class handles the selection of the different file formats to save the mesh in, the directory
- * 			location of the mesh saved files, the number of mesh passes, the llyod smoothing steps, and
- * 			the global mesh size factor setting.
+ * 			location of the mesh saved files, the number of mesh passes, the llyod smoothing steps,
+ * 			the global mesh size factor setting, and the adaptive refinement.
  */
 class meshAdvanced : public wxDialog
 {
@@ -41,6 +41,15 @@ private:
 	//! Text box that is used to set the Global Mesh Factor Scaling number
 	wxTextCtrl *p_factorTextCtrl = new wxTextCtrl();
 	
+	//! Check box used to indicate that the mesh should be refined from the error of the solution during the analysis
+	wxCheckBox *p_adaptiveCheckBox = new wxCheckBox();
+	
+	//! Text box used to set the relative energy error that the adaptive refinement stops at
+	wxTextCtrl *p_adaptiveToleranceTextCtrl = new wxTextCtrl();
+	
+	//! Text box used to set the largest number of solves of the adaptive refinement
+	wxTextCtrl *p_adaptivePassesTextCtrl = new wxTextCtrl();
+	
 	//! Text box used to indicate the local of the directory to save the mesh file to
 	wxTextCtrl *p_meshFileDirectory = new wxTextCtrl();
 	
@@ -0,0 +1,392 @@
+#ifndef GEOMETRYRENDERER_H_
+#define GEOMETRYRENDERER_H_
+
+#include <vector>
+#include <unordered_map>
+#include <math.h>
+
+#include <glew.h>
+
+#include <common/plfcolony.h>
+
+#include <UI/geometryShapes.h>
+#include <UI/GeometryEditor2D.h>
+
+#include <Mesh/BoundingBox.h>
+
+/**
+ * @struct renderVertex
+ * @author Phillip
+ * @date 17/10/26
+ * @file GeometryRenderer.h
+ * @brief 	The layout of one vertex that is stored in the vertex buffers. The position and the color
+ * 			are interleaved so that a change to a geometry piece only touches one range of the buffer.
+ */
+struct renderVertex
+{
+	//! The x-coordinate of the vertex
+	GLfloat x;
+
+	//! The y-coordinate of the vertex
+	GLfloat y;
+
+	//! The color of the vertex stored as red, green, blue, alpha
+	GLubyte color[4];
+};
+
+/**
+ * @class vertexBatch
+ * @author Phillip
+ * @date 17/10/26
+ * @file GeometryRenderer.h
+ * @brief 	This class keeps a copy of the vertices on the CPU side along with the vertex buffer on the
+ * 			graphics card. Vertices are written into the batch every frame but only the range of vertices
+ * 			that actually changed is sent to the graphics card. If vertex buffers are not supported, the
+ * 			batch will draw straight from the CPU side copy using client side vertex arrays.
+ */
+class vertexBatch
+{
+private:
+	//! The CPU side copy of the vertices
+	std::vector<renderVertex> p_vertices;
+
+	//! The ID of the vertex buffer. This is 0 if the buffer has not been created
+	GLuint p_bufferID = 0;
+
+	//! The number of vertices that the vertex buffer can hold
+	size_t p_bufferCapacity = 0;
+
+	//! The first vertex that has changed since the last upload
+	size_t p_dirtyBegin = 0;
+
+	//! One past the last vertex that has changed since the last upload
+	size_t p_dirtyEnd = 0;
+
+public:
+
+	/**
+	 * @brief 	Checks if vertex buffers can be used. The first time that this function is called, glewInit
+	 * 			will be called. So, an OpenGL context must be current
+	 * @return Returns true if vertex buffers are supported. Otherwise, client side vertex arrays need to be used
+	 */
+	static bool isBufferSupported()
+	{
+		static bool isInitialized = false;
+		static bool useBuffers = false;
+
+		if(!isInitialized)
+		{
+			GLenum error = glewInit();
+			useBuffers = (error == GLEW_OK && GLEW_VERSION_1_5);
+			isInitialized = true;
+		}
+
+		return useBuffers;
+	}
+
+	/**
+	 * @brief Sets the number of vertices in the batch. Any new vertices are marked as changed
+	 * @param numberOfVertices The number of vertices that the batch will hold
+	 */
+	void resize(size_t numberOfVertices)
+	{
+		if(numberOfVertices > p_vertices.size())
+			markDirty(p_vertices.size(), numberOfVertices);
+
+		p_vertices.resize(numberOfVertices);
+	}
+
+	/**
+	 * @brief Writes a vertex into the batch. If the vertex is the same as what is stored, nothing is marked as changed
+	 * @param index The index of the vertex. The batch must already be large enough to hold the index
+	 * @param xPoint The x-coordinate of the vertex
+	 * @param yPoint The y-coordinate of the vertex
+	 * @param color The color of the vertex as red, green, blue, alpha
+	 */
+	void setVertex(size_t index, double xPoint, double yPoint, const GLubyte color[4])
+	{
+		renderVertex &vertex = p_vertices[index];
+
+		if(vertex.x != (GLfloat)xPoint || vertex.y != (GLfloat)yPoint || vertex.color[0] != color[0] || vertex.color[1] != color[1] || vertex.color[2] != color[2] || vertex.color[3] != color[3])
+		{
+			vertex.x = (GLfloat)xPoint;
+			vertex.y = (GLfloat)yPoint;
+			vertex.color[0] = color[0];
+			vertex.color[1] = color[1];
+			vertex.color[2] = color[2];
+			vertex.color[3] = color[3];
+			markDirty(index, index + 1);
+		}
+	}
+
+	/**
+	 * @brief Marks a range of vertices as needing to be sent to the graphics card
+	 * @param begin The first vertex of the range
+	 * @param end One past the last vertex of the range
+	 */
+	void markDirty(size_t begin, size_t end)
+	{
+		if(p_dirtyBegin == p_dirtyEnd)
+		{
+			p_dirtyBegin = begin;
+			p_dirtyEnd = end;
+		}
+		else
+		{
+			if(begin < p_dirtyBegin)
+				p_dirtyBegin = begin;
+			if(end > p_dirtyEnd)
+				p_dirtyEnd = end;
+		}
+	}
+
+	/**
+	 * @brief Retrieves the number of vertices in the batch
+	 * @return Returns the number of vertices
+	 */
+	size_t size()
+	{
+		return p_vertices.size();
+	}
+
+	/**
+	 * @brief 	Sends the changed range of vertices to the vertex buffer. If the buffer is too small,
+	 * 			the whole batch is sent. This function should be called before bind
+	 * @param useBuffers Set to true if vertex buffers are supported
+	 */
+	void upload(bool useBuffers);
+
+	/**
+	 * @brief 	Sets the vertex and color pointers to the batch. After this function is called, the
+	 * 			vertices can be drawn with glDrawArrays or glDrawElements
+	 * @param useBuffers Set to true if vertex buffers are supported
+	 * @param useColors Set to true to use the color stored with each vertex. Otherwise, the current color is used
+	 */
+	void bind(bool useBuffers, bool useColors);
+
+	//! Deletes the vertex buffer. The OpenGL context that created the buffer must be current
+	void releaseBuffer();
+};
+
+/**
+ * @class geometryRenderer
+ * @author Phillip
+ * @date 17/10/26
+ * @file GeometryRenderer.h
+ * @brief 	This class is responsible for drawing the nodes, lines, arcs, and block labels of the
+ * 			geometry editor. Before, each geometry piece was drawn using its own draw function which
+ * 			would call glBegin/glEnd for every piece (and compute a cos/sin for every segment of every arc).
+ * 			This class keeps the vertices of every geometry piece in a vertex buffer and draws each type
+ * 			of geometry piece with one call.
+ * 			Every frame, the spatial index of the editor is used to find the geometry pieces that are inside
+ * 			of the view. Only these pieces are compared against what is stored in the vertex buffer and only
+ * 			these pieces are drawn. So, the cost of drawing depends on what can be seen and not the size of the model.
+ * 			Each geometry piece is given a slot in the vertex buffer the first time that it is seen. If the piece
+ * 			changes, only the vertices of the slot are sent to the graphics card.
+ * 			The number of segments that an arc is drawn with is picked so that the arc is never more then half
+ * 			of a pixel away from the true arc. When zoomed out, nodes and block labels that would be drawn on
+ * 			top of each other are collapsed into one point.
+ * 			Only OpenGL 2.1 functionality is used. If vertex buffers are not available, the vertices
+ * 			are drawn from client side vertex arrays.
+ */
+class geometryRenderer
+{
+private:
+
+	/**
+	 * @struct edgeRecord
+	 * @brief 	Stores the state of a line or arc at the time that it was last written into the batch.
+	 * 			If nothing in the record changed, then the vertices of the edge do not need to be computed again
+	 */
+	struct edgeRecord
+	{
+		//! The coordinates of the first node, second node, and the center of the edge
+		double coordinates[6];
+
+		//! The arc angle. This is 0 for lines
+		double arcAngle;
+
+		//! The number of segments that the edge is drawn with
+		unsigned int numSegments;
+
+		//! The select state of the edge
+		bool isSelected;
+
+		//! The hidden state of the edge
+		bool isHidden;
+
+		//! The index of the first vertex of the slot for the edge in the batch
+		size_t offset;
+
+		//! The number of vertices that the slot can hold
+		size_t capacity;
+	};
+
+	/**
+	 * @brief 	The size of a node or block label on the screen in pixels. When zoomed out, all of the
+	 * 			nodes/labels that lie in the same square of this size are drawn as one point
+	 */
+	static constexpr double p_pointSize = 6.0;
+
+	/**
+	 * @brief 	The max number of segments that an arc can be drawn with. This is to keep a very large
+	 * 			arc from filling up the batch when zoomed in
+	 */
+	static const unsigned int p_maxArcSegments = 1024;
+
+	//! Boolean used to indicate if vertex buffers are supported by the OpenGL context
+	bool p_useBuffers = false;
+
+	//! The size of one pixel in the coordinates of the geometry
+	double p_pixelSize = 0;
+
+	//! The batch that contains the vertices for the nodes
+	vertexBatch p_nodeBatch;
+
+	//! The batch that contains the vertices for the block labels
+	vertexBatch p_blockLabelBatch;
+
+	//! The batch that contains the vertices for the lines. Each line is stored as 2 vertices
+	vertexBatch p_lineBatch;
+
+	//! The batch that contains the vertices for the arcs. Each segment of an arc is stored as 2 vertices
+	vertexBatch p_arcBatch;
+
+	//! The slot of each node in the node batch
+	std::unordered_map<node*, size_t> p_nodeSlots;
+
+	//! The slot of each block label in the block label batch
+	std::unordered_map<blockLabel*, size_t> p_blockLabelSlots;
+
+	//! The record of each line. The offset of the record is the slot in the line batch
+	std::unordered_map<edgeLineShape*, edgeRecord> p_lineRecords;
+
+	//! The record of each arc. The offset of the record is the slot in the arc batch
+	std::unordered_map<arcShape*, edgeRecord> p_arcRecords;
+
+	//! The vertex indices of the nodes that are drawn this frame
+	std::vector<GLuint> p_nodeIndices;
+
+	//! The vertex indices of the block labels that are drawn this frame
+	std::vector<GLuint> p_blockLabelIndices;
+
+	//! The vertex indices of the lines that are drawn this frame and are not hidden
+	std::vector<GLuint> p_solidLineIndices;
+
+	//! The vertex indices of the lines that are drawn this frame and are hidden. These are drawn with a stipple
+	std::vector<GLuint> p_hiddenLineIndices;
+
+	//! The vertex indices of the arcs that are drawn this frame and are not hidden
+	std::vector<GLuint> p_solidArcIndices;
+
+	//! The vertex indices of the arcs that are drawn this frame and are hidden. These are drawn with a stipple
+	std::vector<GLuint> p_hiddenArcIndices;
+
+	//! The nodes that were found in the view. This is kept between frames in order to save on memory allocation
+	std::vector<node*> p_nodesInView;
+
+	//! The block labels that were found in the view
+	std::vector<blockLabel*> p_blockLabelsInView;
+
+	//! The lines that were found in the view
+	std::vector<edgeLineShape*> p_linesInView;
+
+	//! The arcs that were found in the view
+	std::vector<arcShape*> p_arcsInView;
+
+	//! Map from the square on the screen to the position in the index list of the point drawn for that square
+	std::unordered_map<long long, size_t> p_clusterMap;
+
+	/**
+	 * @brief Fills the record of the edge with the current state of the edge
+	 * @param edge The line or arc
+	 * @param record The record that will be filled
+	 */
+	void fillRecord(edgeLineShape &edge, edgeRecord &record);
+
+	/**
+	 * @brief Compares two records. The offset and capacity are not compared
+	 * @param first The first record
+	 * @param second The second record
+	 * @return Returns true if the edges described by the records will be drawn the same
+	 */
+	bool isSameRecord(const edgeRecord &first, const edgeRecord &second);
+
+	/**
+	 * @brief Computes the number of segments needed so that the arc is within half of a pixel of the true arc
+	 * @param radius The radius of the arc
+	 * @param arcAngle The arc angle in degrees
+	 * @return Returns the number of segments. This is always a power of 2 so that the arc is not tessellated again for every small zoom
+	 */
+	unsigned int getNumberOfArcSegments(double radius, double arcAngle);
+
+	/**
+	 * @brief 	Writes the vertices of the points that are in the view into the batch and adds the points to the index list.
+	 * 			If there are many points on the screen, the points that lie in the same square of the screen are collapsed into one
+	 * @param pointList The points that were found in the view
+	 * @param viewBox The bounds of the view
+	 * @param slots The slot of each point in the batch
+	 * @param batch The batch that the vertices are written to
+	 * @param indices The index list of the points that will be drawn
+	 * @param defaultColor The color of the point when the point is not selected
+	 */
+	template<class pointType>
+	void updatePoints(std::vector<pointType*> &pointList, boundingBox &viewBox, std::unordered_map<pointType*, size_t> &slots, vertexBatch &batch, std::vector<GLuint> &indices, const GLubyte defaultColor[4]);
+
+	//! Updates the line batch and the line indices from the lines in the view
+	void updateLines(boundingBox &viewBox);
+
+	//! Updates the arc batch and the arc indices from the arcs in the view. Only arcs that changed are tessellated again
+	void updateArcs(boundingBox &viewBox);
+
+	/**
+	 * @brief 	Clears out the slots of the batches if there are a lot more slots then there are geometry pieces.
+	 * 			This occurs after a lot of geometry has been deleted
+	 * @param editor The geometry editor that contains the geometry
+	 */
+	void compactSlots(geometryEditor2D &editor);
+
+	/**
+	 * @brief Draws the indexed vertices of a batch as points. The point is drawn as a colored point with a white point on top
+	 * @param batch The batch that is to be drawn
+	 * @param indices The vertex indices of the points
+	 */
+	void drawPoints(vertexBatch &batch, std::vector<GLuint> &indices);
+
+	/**
+	 * @brief Draws the edges of a batch as lines. The hidden edges are drawn with a stipple
+	 * @param batch The batch that is to be drawn
+	 * @param solidIndices The vertex indices of the edges that are not hidden
+	 * @param hiddenIndices The vertex indices of the edges that are hidden
+	 */
+	void drawEdges(vertexBatch &batch, std::vector<GLuint> &solidIndices, std::vector<GLuint> &hiddenIndices);
+
+public:
+
+	/**
+	 * @brief 	Draws all of the lines, arcs, nodes, and block labels of the editor that are inside of the view
+	 * 			in this order. The OpenGL context that the geometry is drawn on must be current. The text for the block
+	 * 			labels is not drawn. See getBlockLabelsInView for the labels that need text.
+	 * @param editor The geometry editor that contains the geometry
+	 * @param viewBox The bounds of the view in the coordinates of the geometry
+	 * @param pixelSize The size of one pixel in the coordinates of the geometry
+	 */
+	void draw(geometryEditor2D &editor, boundingBox viewBox, double pixelSize);
+
+	/**
+	 * @brief Retrieves the block labels that were inside of the view the last time that the geometry was drawn
+	 * @return Returns the list of block labels that were drawn
+	 */
+	std::vector<blockLabel*> *getBlockLabelsInView()
+	{
+		return &p_blockLabelsInView;
+	}
+
+	//! Forces every vertex to be computed and sent to the graphics card again on the next draw
+	void invalidate();
+
+	//! Deletes all of the vertex buffers. The OpenGL context that created the buffers must be current
+	void releaseBuffers();
+};
+
+#endif
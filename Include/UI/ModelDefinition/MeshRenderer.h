@@ -0,0 +1,97 @@
+#ifndef MESHRENDERER_H_
+#define MESHRENDERER_H_
+
+#include <vector>
+
+#include <glew.h>
+
+#include <UI/ModelDefinition/GeometryRenderer.h>
+
+#include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/GEntity.h>
+#include <Mesh/GMSH/MElement.h>
+#include <Mesh/GMSH/MVertex.h>
+
+/**
+ * @class meshRenderer
+ * @author Phillip
+ * @date 17/10/26
+ * @file MeshRenderer.h
+ * @brief 	This class is responsible for drawing the edges of the mesh on top of the geometry.
+ * 			Before, the canvas would loop through every element of the mesh on every frame and draw each
+ * 			edge with glVertex2d which made the canvas unusable for large meshes. This class will
+ * 			collect the edges of the mesh once, remove any edge that is shared between two elements,
+ * 			and store the result in a vertex buffer and an index buffer. The edges are then drawn with one call.
+ * 			The stored edges are kept until the invalidate function is called or until a different mesh is drawn.
+ * 			So, the owner of the mesh needs to call invalidate whenever the mesh is changed.
+ */
+class meshRenderer
+{
+private:
+
+	//! The mesh that the stored edges were built from
+	GModel *p_mesh = nullptr;
+
+	//! Boolean used to indicate if the stored edges match the mesh
+	bool p_isValid = false;
+
+	//! The vertices of the mesh. The color stored in the batch is not used
+	vertexBatch p_vertexBatch;
+
+	//! The pairs of vertex indices that make up each unique edge of the mesh
+	std::vector<GLuint> p_edgeIndices;
+
+	//! The ID of the index buffer. This is 0 if the buffer has not been created
+	GLuint p_indexBufferID = 0;
+
+	//! Boolean used to indicate if the edge indices need to be sent to the index buffer
+	bool p_indicesNeedUpload = true;
+
+	/**
+	 * @brief Collects the unique edges of every element in the mesh into the vertex batch and the edge indices
+	 * @param mesh The mesh that the edges will be collected from
+	 */
+	void build(GModel *mesh);
+
+public:
+
+	/**
+	 * @brief 	Draws the edges of the mesh using the current color and line width. If the mesh is different from
+	 * 			the mesh that was last drawn or if the renderer was invalidated, the edges are collected again.
+	 * 			The OpenGL context that the mesh is drawn on must be current
+	 * @param mesh The mesh that is to be drawn
+	 */
+	void draw(GModel *mesh);
+
+	/**
+	 * @brief 	Stores edges that were already collected (for example, from a mesh cache) so that the edges do not need to be
+	 * 			collected from the elements of the mesh. The stored edges are used until the renderer is invalidated
+	 * @param mesh The mesh that the edges belong to
+	 * @param xCoordinates The x coordinate of each vertex
+	 * @param yCoordinates The y coordinate of each vertex
+	 * @param numberOfVertices The number of vertices
+	 * @param edgeIndices The two vertices of each edge
+	 * @param numberOfEdges The number of edges
+	 */
+	void setEdges(GModel *mesh, const double *xCoordinates, const double *yCoordinates, size_t numberOfVertices, const GLuint *edgeIndices, size_t numberOfEdges);
+
+	//! Marks the stored edges as out of date. This needs to be called whenever the mesh is changed or deleted
+	void invalidate()
+	{
+		p_isValid = false;
+	}
+
+	/**
+	 * @brief Retrieves the number of unique edges that are stored
+	 * @return Returns the number of edges that will be drawn
+	 */
+	size_t getNumberOfEdges()
+	{
+		return p_edgeIndices.size() / 2;
+	}
+
+	//! Deletes the vertex and index buffers. The OpenGL context that created the buffers must be current
+	void releaseBuffers();
+};
+
+#endif
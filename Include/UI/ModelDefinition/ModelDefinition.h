@@ -31,6 +31,8 @@
 #include <UI/GeometryDialog/EditGroupDialog.h>
 
 #include <UI/ModelDefinition/OGLFT.h>
+#include <UI/ModelDefinition/GeometryRenderer.h>
+#include <UI/ModelDefinition/MeshRenderer.h>
 
 #include <UI/geometryShapes.h>
 #include <UI/GeometryEditor2D.h>
@@ -40,6 +42,8 @@
 #include <Mesh/GMSH/GEntity.h>
 #include <Mesh/GMSH/MVertex.h>
 
+#include <Mesh/MeshCache.h>
+
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 
@@ -299,11 +303,15 @@ private:
     //! The variable that contains all of the related functions for font render
     /*!
         The instance of the font rendering engine OGLFT. This handles all of the importing of the fonts and the 
-        actual rendering of the font. For documentation regarding the OGLFT library, refer to the following link:
+        actual rendering of the font. The glyph atlas caches every glyph in one texture so that the names of all of
+        the block labels are drawn with a single call. For documentation regarding the OGLFT library, refer to the following link:
          
         http://oglft.sourceforge.net/
     */ 
-    OGLFT::Grayscale *_fontRender;
+    OGLFT::GlyphAtlas *_fontRender;
+    
+    //! The renderer that draws the nodes, lines, arcs, and block labels from vertex buffers
+    geometryRenderer p_geometryRenderer;
 	
 	//! This is the variable that will contain the mesh for the geometry
 	/*!
@@ -312,6 +320,15 @@ private:
 		in the Mesh folder. This variable will only store the mesh so that it can be drawn
 	*/ 
 	GModel *p_modelMesh = new GModel();
+	
+	//! The renderer that draws the edges of the mesh from a vertex buffer. This needs to be invalidated whenever p_modelMesh changes
+	meshRenderer p_meshRenderer;
+	
+	//! The hash of the geometry that p_modelMesh was made from. This is stored in the mesh cache when the project is saved
+	uint64_t p_meshGeometryHash = 0;
+	
+	//! Boolean used to indicate if p_modelMesh was read from the mesh cache. The entities of a restored mesh can not be meshed again
+	bool p_isMeshRestored = false;
     
     //! A function that converts the x pixel coordinate into a cartesian/polar coordinate
     /*!
@@ -634,9 +651,13 @@ public:
 		_doMirrorLine = false;
 		_doSelectionWindow = false;
 		_doZoomWindow = false;
-		delete(_fontRender);
 		_endPoint = wxRealPoint(0.0, 0.0);
 		_startPoint = wxRealPoint(0.0, 0.0);
+		this->SetCurrent(*_geometryContext);// The vertex buffers belong to the context so they need to be deleted before the context is
+		p_geometryRenderer.releaseBuffers();
+		p_meshRenderer.releaseBuffers();
+		_fontRender->releaseTexture();
+		delete(_fontRender);
 		delete(_geometryContext);
 	}
 	
@@ -1020,7 +1041,16 @@ public:
 	{
 		return _editor.getArcList();
 	}
-	
+
+	/**
+	 * @brief Function that is used to retrieve the geometry editor that holds all of the geometry of the model
+	 * @return Returns a pointer pointing to the geometry editor
+	 */
+	geometryEditor2D *getGeometryEditor()
+	{
+		return &_editor;
+	}
+
 	/**
 	 * @brief 	Function that rerieves the data structures that are crucial for the operation of the class.
 	 * 			These data structures are required in order to save the class apprioately. It was discovered
@@ -1044,7 +1074,22 @@ public:
 		otherParam.push_back(_cameraX);
 		otherParam.push_back(_cameraY);
 	}
-	
+
+	/**
+	 * @brief 	Function that retrieves the grid preferences and the window placement variables without copying the
+	 * 			geometry. This is used when the geometry is saved straight from the editor (see getGeometryEditor)
+	 * @param gridParam Variable used to store the gridPreferences class into
+	 * @param otherParam A vector containing the following doubles: the zoom factor (x and y) and camera displacement (x and y)
+	 */
+	void getParameters(gridPreferences &gridParam, std::vector<double> &otherParam)
+	{
+		gridParam = _preferences;
+		otherParam.push_back(_zoomX);
+		otherParam.push_back(_zoomY);
+		otherParam.push_back(_cameraX);
+		otherParam.push_back(_cameraY);
+	}
+
 	/**
 	 * @brief 	Function that is used to set the gridPreferences, geometryEditor2D, window placement variables.
 	 * 			This is mainly used when a user needs to load the data back into the data structure. This function
@@ -1056,7 +1101,6 @@ public:
 	 */
 	void setParameters(gridPreferences &gridParam, geometryEditor2D &editorParam, std::vector<double> &otherParam)
 	{
-		_preferences = gridParam;
 		_editor = editorParam;
 		/*
 		 * This is required and must be done after the program copies the editor data structure.
@@ -1065,6 +1109,19 @@ public:
 		 * different block of memory.
 		 */ 
 		_editor.rebuildDataStructure();
+		setParameters(gridParam, otherParam);
+	}
+	
+	/**
+	 * @brief 	Sets the gridPreferences and the window placement variables without touching the geometry. This is used
+	 * 			when a project was read straight into the editor of the model (see getGeometryEditor)
+	 * @param gridParam 	Variable that contains what the grdiPreferences of the class should be
+	 * @param otherParam 	A vector containing the following doubles: the zoom factor (x and y) and camera displacement (x and y)
+	 * 						that needs to be loaded back into this class
+	 */
+	void setParameters(gridPreferences &gridParam, std::vector<double> &otherParam)
+	{
+		_preferences = gridParam;
 		_zoomX = otherParam.at(0);
 		_zoomY = otherParam.at(1);
 		_cameraX = otherParam.at(2);
@@ -1075,20 +1132,28 @@ public:
 	}
 	
 	/**
-	 * @brief 	This function is called when the program is ready to set the mesh for drawing and storing
-	 * 			The function will check if the mesh is valid and if so, set a boolean to true
-	 * 			in order to allow the program to draw the mesh. 
-	 * @param mesh The mesh that is to be set and drawn
+	 * @brief 	This function is called when a project is opened and the mesh of the project is found in the mesh cache.
+	 * 			The current mesh is replaced with the mesh of the cache and the edges that the cache stores are drawn
+	 * 			without collecting them from the elements again.
+	 * @param cache The mesh cache that is open. The hash of the cache should be checked against the geometry before this is called
+	 * @return Returns true if the mesh was restored
 	 */
-	void setAndDrawMesh(GModel mesh)
+	bool setAndDrawMesh(meshCache &cache)
 	{
-		if(mesh.getNumMeshVertices() > 0)
+		deleteMesh();
+		
+		if(!cache.isOpen() || !cache.restore(p_modelMesh) || p_modelMesh->getNumMeshVertices() == 0)
 		{
-			//p_modelMesh = mesh;
-			p_drawMesh = true;
+			deleteMesh();
+			return false;
 		}
-		else
-			p_drawMesh = false;
+		
+		p_meshRenderer.setEdges(p_modelMesh, cache.getXCoordinates(), cache.getYCoordinates(), cache.getNumberOfNodes(), cache.getEdges(), cache.getNumberOfEdges());
+		p_meshGeometryHash = cache.getGeometryHash();
+		p_isMeshRestored = true;
+		p_drawMesh = true;
+		
+		return true;
 	}
 	
 	GModel *getMeshModel()
@@ -1098,14 +1163,31 @@ public:
 	
 	bool checkModelIsValid()
 	{
+		// This is called after the mesher is finished so the mesh has most likely changed
+		p_meshRenderer.invalidate();
+		p_isMeshRestored = false;
+		
 		if(p_modelMesh && p_modelMesh->getNumMeshVertices() > 0)
+		{
+			p_meshGeometryHash = meshCache::computeGeometryHash(_editor);
 			p_drawMesh = true;
+		}
 		else
 			p_drawMesh = false;
 			
 		return p_drawMesh;
 	}
 	
+	uint64_t getMeshGeometryHash()
+	{
+		return p_meshGeometryHash;
+	}
+	
+	bool isMeshRestored()
+	{
+		return p_isMeshRestored;
+	}
+	
 	/**
 	 * @brief 	Function that is called in order to completely delete everything in the GModel
 	 * 			This will reset the mesh in order for the mesh to be drawn again. This function is called whenever
@@ -1113,12 +1195,14 @@ public:
 	 */
 	void deleteMesh()
 	{
+		p_meshRenderer.invalidate();
 		if(p_modelMesh)
 		{
 			delete p_modelMesh;
 			p_modelMesh = new GModel();
 		}
 		p_drawMesh = false;
+		p_isMeshRestored = false;
 	}
 	
 	void toggleMesh()
@@ -2122,5 +2122,122 @@ namespace OGLFT {
     GLubyte* invertPixmap ( const FT_Bitmap& bitmap, int* width, int* height );
     void bindTexture ( FT_Face face, FT_UInt glyph_index );
   };
+  //! Render many strings from a single texture of cached glyphs.
+  /*!
+   * This style is not part of the original OGLFT library. The raster styles
+   * draw every glyph of every string with \c glDrawPixels (or \c glBitmap)
+   * which is fine for a few strings but becomes the bottleneck when a
+   * large number of short strings need to be drawn every frame.
+   *
+   * GlyphAtlas rasterizes each (latin1) character in anti-aliased mode the
+   * first time that it is seen and packs the image into one alpha texture.
+   * Strings are queued with add() and all of the queued strings are then
+   * drawn with draw() as textured quads in a single call. The anchor of each
+   * string is given in MODELVIEW coordinates and the glyphs are placed in
+   * window pixels so that the text keeps the same size at any zoom level.
+   *
+   * The texture is created in the OpenGL context that is current when draw()
+   * is first called. Call releaseTexture() with that context current before
+   * the context is destroyed.
+   */
+  class GlyphAtlas {
+  private:
+    //! The position of a glyph inside of the atlas and how it is placed
+    //! relative to the pen.
+    struct GlyphData {
+      bool cached_;	//!< Has the glyph been rasterized into the atlas yet?
+      int x_, y_;	//!< Top left corner of the glyph image in the atlas
+      int width_, rows_;	//!< Size of the glyph image in pixels
+      int left_, top_;	//!< Offset from the pen to the top left of the image
+      int advance_;	//!< Distance the pen moves in pixels
+    };
+
+    //! One queued string. The characters are stored in text_.
+    struct StringData {
+      GLdouble x_, y_;	//!< Anchor of the string in MODELVIEW coordinates
+      GLfloat dx_, dy_;	//!< Pixel offset of the string from the anchor
+      size_t begin_, end_;	//!< Range of the characters in text_
+    };
+
+    //! The FreeType face.
+    FT_Face face_;
+    //! Did the font load OK?
+    bool valid_;
+    //! The metrics of each latin1 character.
+    GlyphData glyphs_[256];
+    //! The atlas image. This is kept so that the texture can be rebuilt
+    //! when the atlas needs to grow.
+    std::vector<GLubyte> pixels_;
+    //! Size of the atlas in pixels.
+    int atlas_width_, atlas_height_;
+    //! Position of the next glyph on the current shelf of the atlas.
+    int shelf_x_, shelf_y_, shelf_height_;
+    //! The texture object. This is 0 until the first draw.
+    GLuint texture_;
+    //! Does the texture need to be sent to OpenGL again?
+    bool texture_dirty_;
+    //! The color of the text.
+    GLfloat foreground_color_[4];
+    //! The strings that will be drawn on the next call to draw().
+    std::vector<StringData> strings_;
+    //! The characters of all of the queued strings.
+    std::vector<unsigned char> text_;
+    //! The interleaved x, y, s, t vertices of the quads that are drawn.
+    std::vector<GLfloat> vertices_;
+
+    void init ( float point_size, FT_UInt resolution );
+    bool cacheGlyph ( unsigned char c );
+    void growAtlas ( void );
+    void uploadTexture ( void );
+
+  public:
+    /*!
+     * \param filename the filename which contains the font face.
+     * \param point_size the point size of the font. Defaults to 12.
+     * \param resolution the pixel density of the display in dots per inch (DPI).
+     * Defaults to 100 DPI.
+     */
+    GlyphAtlas ( const char* filename, float point_size = 12,
+		 FT_UInt resolution = 100 );
+    /*!
+     * Closes the face. The texture must have been released with
+     * releaseTexture() while its context was current.
+     */
+    ~GlyphAtlas ( void );
+    /*!
+     * \return true if the font was loaded.
+     */
+    bool isValid ( void ) const { return valid_; }
+    /*!
+     * Set the color of the text.
+     */
+    void setForegroundColor ( GLfloat red, GLfloat green, GLfloat blue,
+			      GLfloat alpha = 1 );
+    /*!
+     * Queue a string to be drawn on the next call to draw().
+     * \param x the X position of the anchor in MODELVIEW coordinates.
+     * \param y the Y position of the anchor in MODELVIEW coordinates.
+     * \param s the (latin1) string.
+     * \param dx horizontal offset of the string origin from the anchor in pixels.
+     * \param dy vertical offset of the string origin from the anchor in pixels.
+     */
+    void add ( GLdouble x, GLdouble y, const char* s, GLfloat dx = 0,
+	       GLfloat dy = 0 );
+    /*!
+     * \return the number of strings that are queued.
+     */
+    size_t queued ( void ) const { return strings_.size(); }
+    /*!
+     * Draw all of the queued strings with one call and clear the queue.
+     * The current MODELVIEW and PROJECTION matrices and the viewport are
+     * used to place the anchors. The OpenGL state is restored afterwards.
+     */
+    void draw ( void );
+    /*!
+     * Delete the texture. The context that the texture was created in
+     * must be current.
+     */
+    void releaseTexture ( void );
+  };
 } // Close OGLFT namespace
 #endif /* OGLFT_H */
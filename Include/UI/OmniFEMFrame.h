@@ -43,6 +43,12 @@
 #include "common/OmniFEMMessage.h"
 #include <common/ProblemDefinition.h>
 
+#include <Solver/ElectrostaticSolver.h>
+#include <Solver/MagnetostaticSolver.h>
+#include <Solver/HarmonicMagneticSolver.h>
+#include <Solver/TransientMagneticSolver.h>
+#include <Solver/AdaptiveRefinement.h>
+
 
 // For documenting code, see: https://www.stack.nl/~dimitri/doxygen/manual/docblocks.html
 
@@ -91,6 +97,10 @@ public:
 	
 	~OmniFEMMainFrame()
 	{
+		delete _electrostaticSolver;
+		delete _magnetostaticSolver;
+		delete _harmonicMagneticSolver;
+		delete _transientMagneticSolver;
 		delete OmniFEMMsg::instance();
 	}
 private:
@@ -127,6 +137,18 @@ private:
         and the materials
     */ 
     problemDefinition _problemDefinition;
+	
+	//! The solver of the last electrostatic analysis. This holds the results. Null if the mesh was not analyzed yet
+	electrostaticSolver *_electrostaticSolver = nullptr;
+	
+	//! The solver of the last magnetostatic analysis. This holds the results. Null if the mesh was not analyzed yet
+	magnetostaticSolver *_magnetostaticSolver = nullptr;
+	
+	//! The solver of the last time harmonic magnetic analysis. This holds the results. Null if the mesh was not analyzed yet
+	harmonicMagneticSolver *_harmonicMagneticSolver = nullptr;
+	
+	//! The solver of the last transient magnetic analysis with hysteresis. This holds the results. Null if the mesh was not analyzed yet
+	transientMagneticSolver *_transientMagneticSolver = nullptr;
     
     //! Boolean used to indicate if the user would like to display the status menu
     bool _displayStatusMenu = true;
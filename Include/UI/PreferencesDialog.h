@@ -72,6 +72,15 @@ private:
     //! The text box for setting the AC frequency. Units are in Hz
     wxTextCtrl *_frequencyTextCtrl = new wxTextCtrl();
     
+    //! The check box for solving the problem in time with the Jiles-Atherton hysteresis model
+    wxCheckBox *_transientCheckBox = new wxCheckBox();
+    
+    //! The text box for setting the number of periods of the transient problem
+    wxTextCtrl *_transientPeriodsTextCtrl = new wxTextCtrl();
+    
+    //! The text box for setting the number of time steps per period of the transient problem
+    wxTextCtrl *_transientStepsTextCtrl = new wxTextCtrl();
+    
     //! The text box for setting the depth of the problem
     /*!
         The units for the depth are the units that are selected in the
@@ -103,6 +112,13 @@ private:
      */
     void onComboBox(wxCommandEvent &event);
     
+    /**
+     * @brief   Event Procedure that is called when the user checks or unchecks the transient check box.
+     *          The periods and the steps per period can only be edited for a transient problem
+     * @param event Standard object in order to route the event procedure to the proper function
+     */
+    void onTransientCheck(wxCommandEvent &event);
+    
 public:
 
     //! Constructor for the class
@@ -0,0 +1,344 @@
+#ifndef SPATIAL_GRID_H_
+#define SPATIAL_GRID_H_
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+
+#include <Mesh/BoundingBox.h>
+
+/**
+ * @class spatialGrid
+ * @author Phillip
+ * @date 17/10/26
+ * @file SpatialGrid.h
+ * @brief 	This class is a uniform hash grid that is used to quickly find all of the geometry
+ * 			pieces that are near a point or a box. Before, the geometry editor would have to loop through
+ * 			the entire node/line/arc/label list for every node that is placed which becomes very slow for
+ * 			large models. The grid only stores the address of the geometry piece along with the bounding box
+ * 			of the geometry piece at the time that it was added. Since the plf::colony never moves an object
+ * 			in memory, the addresses are valid until the object is erased. It is up to the owner of the
+ * 			grid to remove (or re-add) an object when the object is erased or changes shape.
+ * 			Any query will return a list of candidates. The candidates are guaranteed to contain every
+ * 			object whose bounding box overlaps the query box but the list can contain objects that
+ * 			do not actually overlap. So, the caller still needs to perform the exact test.
+ * 			One important note is that copying the grid will not copy the contents. Instead, the copy
+ * 			will be marked as invalid since the addresses would point to the objects of another colony.
+ */
+template<class T>
+class spatialGrid
+{
+private:
+
+	//! Structure used to store the range of cells that an object was added to
+	struct cellRange
+	{
+		long minX;
+		long minY;
+		long maxX;
+		long maxY;
+		bool isOversized;
+	};
+
+	/**
+	 * @brief 	If an object spans more then this number of cells in either direction, then the object
+	 * 			is placed in the oversized list instead of the cells. This keeps a very long line from
+	 * 			filling up the grid.
+	 */
+	static const long p_maxCellSpan = 64;
+
+	//! The width and height of each cell
+	double p_cellSize = 1.0;
+
+	//! The map of all of the cells that contain at least one object. The key is formed from the x and y index of the cell
+	std::unordered_map<long long, std::vector<T*>> p_cells;
+
+	//! Map storing the cells that each object was placed in. This is needed in order to remove an object
+	std::unordered_map<T*, cellRange> p_entries;
+
+	//! List of objects that are too large to be stored in the cells. These are returned with every query
+	std::vector<T*> p_oversized;
+
+	//! Boolean used to indicate if the contents of the grid can be trusted
+	bool p_isValid = false;
+
+	/**
+	 * @brief Computes the index of the cell that the coordinate lies in
+	 * @param coordinate The x or y coordinate
+	 * @return Returns the index of the cell
+	 */
+	long getCellIndex(double coordinate) const
+	{
+		return (long)floor(coordinate / p_cellSize);
+	}
+
+	/**
+	 * @brief Combines the x and y index of a cell into one key for the cell map
+	 * @param xIndex The x index of the cell
+	 * @param yIndex The y index of the cell
+	 * @return Returns the key of the cell
+	 */
+	long long getCellKey(long xIndex, long yIndex) const
+	{
+		return ((long long)xIndex << 32) ^ ((long long)yIndex & 0xFFFFFFFFLL);
+	}
+
+	/**
+	 * @brief Computes the range of cells that the box covers
+	 * @param box The box that will be converted into a cell range
+	 * @return Returns the range of cells that the box covers
+	 */
+	cellRange getCellRange(boundingBox box) const
+	{
+		cellRange range;
+
+		range.minX = getCellIndex(box.getMinBounds().x);
+		range.minY = getCellIndex(box.getMinBounds().y);
+		range.maxX = getCellIndex(box.getMaxBounds().x);
+		range.maxY = getCellIndex(box.getMaxBounds().y);
+		range.isOversized = ((range.maxX - range.minX) > p_maxCellSpan) || ((range.maxY - range.minY) > p_maxCellSpan);
+
+		return range;
+	}
+
+	/**
+	 * @brief Removes the address of the object from the list
+	 * @param list The list that the object will be removed from
+	 * @param object The address of the object to remove
+	 */
+	void removeFromList(std::vector<T*> &list, T *object)
+	{
+		typename std::vector<T*>::iterator foundIterator = std::find(list.begin(), list.end(), object);
+
+		if(foundIterator != list.end())
+		{
+			*foundIterator = list.back();
+			list.pop_back();
+		}
+	}
+
+public:
+
+	//! The constructor for the class
+	spatialGrid()
+	{
+
+	}
+
+	/**
+	 * @brief 	The copy constructor. The contents of the grid are not copied since the addresses stored
+	 * 			would be pointing to the objects of another colony. The new grid is marked invalid so that
+	 * 			the owner knows to rebuild it.
+	 * @param grid The grid that is being copied
+	 */
+	spatialGrid(const spatialGrid &grid)
+	{
+		p_cellSize = grid.p_cellSize;
+	}
+
+	/**
+	 * @brief Assignment operator. See the documentation for the copy constructor for how the contents are handled
+	 * @param grid The grid that is being copied
+	 * @return Returns the invalidated grid
+	 */
+	spatialGrid &operator=(const spatialGrid &grid)
+	{
+		if(this != &grid)
+		{
+			clear();
+			p_cellSize = grid.p_cellSize;
+			p_isValid = false;
+		}
+
+		return *this;
+	}
+
+	/**
+	 * @brief Removes all of the objects from the grid and sets the size of each cell
+	 * @param cellSize The width and height of each cell. If the size is not a positive number, the size is set to 1
+	 */
+	void reset(double cellSize)
+	{
+		clear();
+
+		if(cellSize > 0 && std::isfinite(cellSize))
+			p_cellSize = cellSize;
+		else
+			p_cellSize = 1.0;
+
+		p_isValid = true;
+	}
+
+	//! Removes all of the objects from the grid. The grid will be marked as invalid
+	void clear()
+	{
+		p_cells.clear();
+		p_entries.clear();
+		p_oversized.clear();
+		p_isValid = false;
+	}
+
+	/**
+	 * @brief Adds an object into the grid. If the object already exists in the grid, it will first be removed. So,
+	 * 			this function can also be used to update the object after the object has moved.
+	 * @param object The address of the object
+	 * @param box The bounding box of the object
+	 */
+	void insert(T *object, boundingBox box)
+	{
+		if(p_entries.count(object) > 0)
+			remove(object);
+
+		cellRange range = getCellRange(box);
+
+		if(range.isOversized)
+			p_oversized.push_back(object);
+		else
+		{
+			for(long i = range.minX; i <= range.maxX; i++)
+			{
+				for(long j = range.minY; j <= range.maxY; j++)
+					p_cells[getCellKey(i, j)].push_back(object);
+			}
+		}
+
+		p_entries[object] = range;
+	}
+
+	/**
+	 * @brief Removes an object from the grid. If the object is not in the grid, nothing happens
+	 * @param object The address of the object to remove
+	 */
+	void remove(T *object)
+	{
+		typename std::unordered_map<T*, cellRange>::iterator entryIterator = p_entries.find(object);
+
+		if(entryIterator == p_entries.end())
+			return;
+
+		cellRange range = entryIterator->second;
+
+		if(range.isOversized)
+			removeFromList(p_oversized, object);
+		else
+		{
+			for(long i = range.minX; i <= range.maxX; i++)
+			{
+				for(long j = range.minY; j <= range.maxY; j++)
+				{
+					typename std::unordered_map<long long, std::vector<T*>>::iterator cellIterator = p_cells.find(getCellKey(i, j));
+
+					if(cellIterator != p_cells.end())
+					{
+						removeFromList(cellIterator->second, object);
+						if(cellIterator->second.empty())
+							p_cells.erase(cellIterator);
+					}
+				}
+			}
+		}
+
+		p_entries.erase(entryIterator);
+	}
+
+	/**
+	 * @brief 	Finds all of the objects whose bounding box could overlap the box. The results are appended
+	 * 			to the list and each object appears only once.
+	 * @param box The box that is being searched
+	 * @param foundList The list that the candidates will be added to
+	 */
+	void query(boundingBox box, std::vector<T*> &foundList) const
+	{
+		cellRange range = getCellRange(box);
+		size_t startSize = foundList.size();
+		double numberOfCells = ((double)(range.maxX - range.minX) + 1.0) * ((double)(range.maxY - range.minY) + 1.0);
+
+		if(numberOfCells > (double)p_cells.size())
+		{
+			// The box covers more cells then what are occupied. In this case, it is faster to check each occupied cell
+			for(typename std::unordered_map<long long, std::vector<T*>>::const_iterator cellIterator = p_cells.begin(); cellIterator != p_cells.end(); cellIterator++)
+			{
+				for(typename std::vector<T*>::const_iterator objectIterator = cellIterator->second.begin(); objectIterator != cellIterator->second.end(); objectIterator++)
+				{
+					const cellRange &objectRange = p_entries.find(*objectIterator)->second;
+					if(objectRange.maxX >= range.minX && objectRange.minX <= range.maxX && objectRange.maxY >= range.minY && objectRange.minY <= range.maxY)
+						foundList.push_back(*objectIterator);
+				}
+			}
+		}
+		else
+		{
+			for(long i = range.minX; i <= range.maxX; i++)
+			{
+				for(long j = range.minY; j <= range.maxY; j++)
+				{
+					typename std::unordered_map<long long, std::vector<T*>>::const_iterator cellIterator = p_cells.find(getCellKey(i, j));
+
+					if(cellIterator != p_cells.end())
+						foundList.insert(foundList.end(), cellIterator->second.begin(), cellIterator->second.end());
+				}
+			}
+		}
+
+		foundList.insert(foundList.end(), p_oversized.begin(), p_oversized.end());
+
+		// An object that spans multiple cells will be found more then once
+		std::sort(foundList.begin() + startSize, foundList.end());
+		foundList.erase(std::unique(foundList.begin() + startSize, foundList.end()), foundList.end());
+	}
+
+	/**
+	 * @brief Finds all of the objects whose bounding box could be within a distance of a point
+	 * @param xPoint The x-coordinate of the point
+	 * @param yPoint The y-coordinate of the point
+	 * @param distance The search distance from the point
+	 * @param foundList The list that the candidates will be added to
+	 */
+	void query(double xPoint, double yPoint, double distance, std::vector<T*> &foundList) const
+	{
+		boundingBox searchBox(wxRealPoint(xPoint - fabs(distance), yPoint - fabs(distance)));
+		searchBox.addPoint(wxRealPoint(xPoint + fabs(distance), yPoint + fabs(distance)));
+
+		query(searchBox, foundList);
+	}
+
+	/**
+	 * @brief Retrieves the number of objects stored in the grid
+	 * @return Returns the number of objects in the grid
+	 */
+	size_t size() const
+	{
+		return p_entries.size();
+	}
+
+	/**
+	 * @brief Checks if the object is in the grid
+	 * @param object The address of the object
+	 * @return Returns true if the object is in the grid
+	 */
+	bool contains(T *object) const
+	{
+		return (p_entries.count(object) > 0);
+	}
+
+	/**
+	 * @brief Retrieves the valid state of the grid. A grid is invalid after it is copied or cleared
+	 * @return Returns true if the contents of the grid can be used
+	 */
+	bool isValid() const
+	{
+		return p_isValid;
+	}
+
+	/**
+	 * @brief Retrieves the size of each cell
+	 * @return Returns the width and height of each cell
+	 */
+	double getCellSize() const
+	{
+		return p_cellSize;
+	}
+};
+
+#endif
@@ -3,9 +3,6 @@
 
 #include <math.h>
 
-#include <glew.h>
-#include <freeglut.h>
-
 #include <wx/wx.h>
 
 #include <common/Vector.h>
@@ -14,8 +11,6 @@
 #include <common/GeometryProperties/NodeSettings.h>
 #include <common/GeometryProperties/SegmentProperties.h>
 
-#include <UI/ModelDefinition/OGLFT.h>
-
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 
@@ -266,15 +261,6 @@ public:
         _isDragging = state;
     }
 	
-	/**
-	 * @brief 	This is the draw function for hte rectangle object. Note that for a generic retangle objecy
-	 * 			nothing is drawn.
-	 */
-	virtual void draw()
-    {
-        
-    }
-    
     bool operator==(const rectangleShape &a_node)
     {
         if(xCenterCoordinate == a_node.getCenterXCoordinate() && yCenterCoordinate == a_node.getCenterYCoordinate())
@@ -300,7 +286,7 @@ public:
  * @date 18/06/17
  * @file geometryShapes.h
  * @brief   This is the object that is used for nodes. This handles any specific node
- *          items such as the nodal property and the draw method for the node
+ *          items such as the nodal property of the node
  */
 class node : public rectangleShape
 {
@@ -367,36 +353,6 @@ public:
 		return p_GModelTagNumber;
 	}
     
-	/**
-	 * @brief This function is called when the program needs to draw the object on the 
-     *          glCanvas. To make a node, the program draws a white point on top of a 
-     *          block point. When the user selects the node, the black is turned to
-     *          red.
-	 */
-	void draw()
-    {
-        glPointSize(6.0);
-		
-        glBegin(GL_POINTS);
-        
-			if(_isSelected)
-				glColor3d(1.0, 0.0, 0.0);
-			else
-				glColor3d(0.0, 0.0, 0.0);
-            
-            glVertex2d(xCenterCoordinate, yCenterCoordinate);
-        glEnd();
-    
-        glColor3d(1.0, 1.0, 1.0);
-        glPointSize(4.25);
-    
-        glBegin(GL_POINTS);
-            glVertex2d(xCenterCoordinate, yCenterCoordinate);
-        glEnd();
-        
-        glColor3d(0.0, 0.0, 0.0);
-    }
-    
     /**
      * @brief Sets the nodal settings of the node
      * @param setting The settings that the node should become
@@ -443,9 +399,8 @@ public:
  * @date 24/06/17
  * @file geometryShapes.h
  * @brief Class that is used to handle the geometry shape of a block label.
- * 			This class stores the property of the block label and handles 
- * 			the drawing of the block label and the drawing of the text that
- * 			is associated with the block label
+ * 			This class stores the property of the block label. The block label
+ * 			and its text are drawn by the geometry renderer of the canvas
  */
 class blockLabel : public rectangleShape
 {
@@ -469,33 +424,6 @@ private:
 	
 public:
 
-	/**
-	 * @brief	This is the draw method for the block label. This will
-	 * 			create it similiar to the node geometry class; however,
-	 * 			the bottom point is colored blue as default. When selected,
-	 * 			it will change colors to red.
-	 */
-    void draw()
-    {
-        glPointSize(6.0);
-        
-        if(_isSelected)
-            glColor3d(1.0, 0.0, 0.0);
-        else
-            glColor3d(0.0, 0.0, 1.0);
-    
-        glBegin(GL_POINTS);
-            glVertex2d(xCenterCoordinate, yCenterCoordinate);
-        glEnd();
-    
-        glColor3d(1.0, 1.0, 1.0);
-        glPointSize(4.25);
-    
-        glBegin(GL_POINTS);
-            glVertex2d(xCenterCoordinate, yCenterCoordinate);
-        glEnd();
-    }
-	
 	/**
 	 * @brief Sets the state of the is used variable. Setting the variable will indicate if the
 	 * 		label has been used by the mesher
@@ -515,37 +443,6 @@ public:
 		return p_isUsed;
 	}
     
-	/**
-	 * @brief 	Draws the text for the block label onto the screen. The text that is drawn is the material
-	 * 			associated with the block label
-	 * @param textRender 	A pointer to the OGLFT object that needs to be used
-	 * 						for drawing the text
-	 * @param factor		This is a constant that determines the distance as to
-	 * 						where the text is drawn on the screen. A factor to how much 
-	 * 						of an offset the text needs to be drawn at from the center 
-	 * 						point of the block label.
-	 */
-    void drawBlockName(OGLFT::Grayscale *textRender, double factor)
-    {
-        double offset = 0.02 * factor;
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        textRender->draw(xCenterCoordinate + offset, yCenterCoordinate + offset, _property.getMaterialName().c_str());
-    }
-    
-	/**
-	 * @brief Draws the circuit name that is associated with the block label onto the screen
-	 * @param textRender A pointer to hte OGLFT object that is to be used for drawing the text
-	 * @param factor	This is a constant that detemines how far of an offset that the 
-	 * 					text should be drawn from the center of the block label
-	 */
-    void drawCircuitName(OGLFT::Grayscale *textRender, double factor)
-    {
-        double offset = 0.02 * factor;
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        if(_property.getCircuitName() != "None")
-            textRender->draw(xCenterCoordinate + offset, yCenterCoordinate - offset, _property.getCircuitName().c_str());
-    }
-	
 	/**
 	 * @brief Retrieves the block property that is associated with the block label
 	 * @return A pointer pointing to the block property for the block label
@@ -751,6 +648,7 @@ class edgeLineShape : public geometry2D
 {
 private:
 	friend class boost::serialization::access;
+	friend class projectFile;
 	template<class Archive>
 	void serialize(Archive &ar, const unsigned int version)
 	{
@@ -979,32 +877,6 @@ public:
         return _secondNode;
     }
     
-	/**
-	 * @brief This is the draw method for the line segment. This differs from the arc segment class since this 
-	 * 			is a straight line. The defualt color is black. If the line is selected, then the line
-	 * 			will change colors to red
-	 */
-    void draw()
-    {			
-        if(_property.getHiddenState())
-        {
-            glEnable(GL_LINE_STIPPLE);
-            glLineStipple(1, 0b0001100011000110);
-        }
-  
-        glLineWidth(2.0);
-        glBegin(GL_LINES);
-            if(_isSelected)
-                glColor3f(1.0f, 0.0f, 0.0f);
-            else
-                glColor3f(0.0f, 0.0f, 0.0f);
-            glVertex2d(_firstNode->getCenterXCoordinate(), _firstNode->getCenterYCoordinate());
-            glVertex2d(_secondNode->getCenterXCoordinate(), _secondNode->getCenterYCoordinate());
-        glEnd();
-        glLineWidth(0.5);
-        glDisable(GL_LINE_STIPPLE);
-    }
-    
 	/**
 	 * @brief Retrieves the segment properties of the line segment
 	 * @return Returns the segment property object that is associated with the line segment
@@ -1159,6 +1031,7 @@ class arcShape : public edgeLineShape
 {
 private:
 	friend class boost::serialization::access;
+	friend class projectFile;
 	
 	template<class Archive>
 	void serialize(Archive &ar, const unsigned int version)
@@ -1241,43 +1114,6 @@ public:
         return _numSegments;
     }
     
-    /**
-     * @brief The function that is called in order to draw the arc on the screen
-	 * This function will call the necessary OpenGL functions in order to draw the 
-	 * arc on the OpenGL canvas
-     */
-    void draw()
-    {
-        if(_isSelected)
-            glColor3d(1.0, 0.0, 0.0);
-        else
-            glColor3d(0.0, 0.0, 0.0);
-			
-		if(p_distance == 0)
-			calculateDistance();
-        
-        if(_property.getHiddenState())
-        {
-            glEnable(GL_LINE_STIPPLE);
-            glLineStipple(1, 0b0001100011000110);
-        }
-        
-        double angle = -(_arcAngle / (double)_numSegments);
-        
-        glBegin(GL_LINE_STRIP);
-            glVertex2d(_firstNode->getCenterXCoordinate(), _firstNode->getCenterYCoordinate());
-            for(int i = 1; i <= (_numSegments - 1); i++)
-            {
-                double xPoint = (_firstNode->getCenterXCoordinate() - xCenterCoordinate) * cos(i * angle * PI / 180.0) + (_firstNode->getCenterYCoordinate() - yCenterCoordinate) * sin(i * angle * PI / 180.0) + xCenterCoordinate;
-                double yPoint = -(_firstNode->getCenterXCoordinate() - xCenterCoordinate) * sin(i * angle * PI / 180.0) + (_firstNode->getCenterYCoordinate() - yCenterCoordinate) * cos(i * angle * PI / 180.0) + yCenterCoordinate;
-                glVertex2d(xPoint, yPoint);
-            }
-            glVertex2d(_secondNode->getCenterXCoordinate(), _secondNode->getCenterYCoordinate());
-        glEnd();
-  
-        glDisable(GL_LINE_STIPPLE); 
-    }	
-
     /*! \brief  
 		See this forum post: http://mymathforum.com/algebra/21368-find-equation-circle-given-two-points-arc-angle.html
       
@@ -8,6 +8,7 @@
 
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
+#include <boost/serialization/version.hpp>
 
 //! Class that is used to handle all of the prefences of simulation for magnetostatic simulations
 /*! 
@@ -76,6 +77,20 @@ private:
     //! Variable that stores any user comments about the simulation problem
     wxString _comments = wxString("Add comments here");
 	
+	//! Set to true to solve the problem in time with the Jiles-Atherton hysteresis model instead of as a harmonic problem
+	/*!
+		The sources and the prescribed potentials follow sin(2 * pi * f * t) where f is the frequency
+		of the problem. Only the X-axis parameters of the Jiles-Atherton model are used. The materials
+		are solved as isotropic and the Y-axis (anisotropy) parameters are ignored.
+	*/
+	bool _transient = false;
+	
+	//! The number of periods that the transient problem is solved for. The losses are averaged over the last period
+	unsigned int _transientPeriods = 2;
+	
+	//! The number of time steps per period that the transient solver starts with. The step size adapts from there
+	unsigned int _transientStepsPerPeriod = 40;
+	
 	template<class Archive>
 	void serialize(Archive &ar, const unsigned int version)
 	{
@@ -90,6 +105,13 @@ private:
 		std::string comments = _comments.ToStdString();
 		ar & comments;
 		_comments = wxString(comments);
+		
+		if(version >= 1)
+		{
+			ar & _transient;
+			ar & _transientPeriods;
+			ar & _transientStepsPerPeriod;
+		}
 	}
     
 public:
@@ -259,6 +281,61 @@ public:
         return _comments;
     }
     
+	//! Sets if the problem is solved in time with the Jiles-Atherton hysteresis model
+	/*!
+		\sa _transient
+		\param transient Set to true to solve the problem in time
+	*/
+	void setTransient(bool transient)
+	{
+		_transient = transient;
+	}
+	
+	//! Checks if the problem is solved in time with the Jiles-Atherton hysteresis model
+	/*!
+		\return Returns true if the problem is a transient problem
+	*/
+	bool isTransient()
+	{
+		return _transient;
+	}
+	
+	//! Sets the number of periods that the transient problem is solved for
+	/*!
+		\param periods The number of periods. The losses are averaged over the last one
+	*/
+	void setTransientPeriods(unsigned int periods)
+	{
+		_transientPeriods = periods;
+	}
+	
+	//! Retrieves the number of periods that the transient problem is solved for
+	/*!
+		\return Returns the number of periods
+	*/
+	unsigned int getTransientPeriods()
+	{
+		return _transientPeriods;
+	}
+	
+	//! Sets the number of time steps per period that the transient solver starts with
+	/*!
+		\param steps The number of steps per period
+	*/
+	void setTransientStepsPerPeriod(unsigned int steps)
+	{
+		_transientStepsPerPeriod = steps;
+	}
+	
+	//! Retrieves the number of time steps per period that the transient solver starts with
+	/*!
+		\return Returns the number of steps per period
+	*/
+	unsigned int getTransientStepsPerPeriod()
+	{
+		return _transientStepsPerPeriod;
+	}
+    
     //! Function that checks if the simulation type is axisymmetric
     /*!
         \return Returns true if the problem is an axisymetic.
@@ -285,7 +362,13 @@ public:
 		_probType = PLANAR;
 		_acSolver = SUCCAPPROX;
 		_comments = wxString("Add comments here");
+		_transient = false;
+		_transientPeriods = 2;
+		_transientStepsPerPeriod = 40;
 	}
 };
 
+//! Version 1 added the settings of the transient solver
+BOOST_CLASS_VERSION(magneticPreference, 1)
+
 #endif
\ No newline at end of file
@@ -148,6 +148,15 @@ private:
 	//! Property used to specify the number of smoothing steps for Blossom algorithm 
 	unsigned int p_llyodSmoothingSteps = 5;
 	
+	//! Boolean used to indicate if the mesh should be refined from the error of the solution when the problem is analyzed
+	bool p_adaptiveRefinement = false;
+	
+	//! The relative error in the energy norm that the adaptive refinement stops at
+	double p_adaptiveTolerance = 0.05;
+	
+	//! The largest number of times that the problem is solved during the adaptive refinement
+	unsigned int p_adaptivePasses = 5;
+	
 //---- Section is for structured meshes	
 
 public:
@@ -437,6 +446,49 @@ public:
 		return p_llyodSmoothingSteps;
 	}
 	
+	/**
+	 * @brief Function that is used to set the adaptive refinement state. When set, the analysis solves the problem, estimates the
+	 * 			error of each element, and refines the mesh where the error is large until the error is small enough
+	 * @param state Set to true to refine the mesh during the analysis. Otherwise, set to false.
+	 */
+	void setAdaptiveRefinementState(bool state)
+	{
+		p_adaptiveRefinement = state;
+	}
+	
+	bool getAdaptiveRefinementState()
+	{
+		return p_adaptiveRefinement;
+	}
+	
+	/**
+	 * @brief Function that is used to set the relative error in the energy norm that the adaptive refinement stops at
+	 * @param value The relative error. 0.05 stops once the error is estimated to be below 5 % of the energy norm of the solution
+	 */
+	void setAdaptiveTolerance(double value)
+	{
+		p_adaptiveTolerance = value;
+	}
+	
+	double getAdaptiveTolerance()
+	{
+		return p_adaptiveTolerance;
+	}
+	
+	/**
+	 * @brief Function that is used to set the largest number of times that the problem is solved during the adaptive refinement
+	 * @param value The number of passes. This includes the solve on the mesh that the user created
+	 */
+	void setAdaptivePasses(unsigned int value)
+	{
+		p_adaptivePasses = value;
+	}
+	
+	unsigned int getAdaptivePasses()
+	{
+		return p_adaptivePasses;
+	}
+	
 	/**
 	 * @brief Function that is used to set the save as VTK State
 	 * @param state Set to true to save the mesh as a VTK file. Otherwise, set to false.
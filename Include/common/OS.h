@@ -13,6 +13,8 @@
 #define __linux__
 
 FILE *Fopen(const char* f, const char *mode);
+FILE *FopenBuffered(const char* f, const char *mode);
+int Fclose(FILE *fp);
 const char *GetEnvironmentVar(const char *var);
 void SetEnvironmentVar(const char *var, const char *val);
 double GetTimeInSeconds();
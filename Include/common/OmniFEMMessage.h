@@ -2,9 +2,15 @@
 #define OMNIFEMMESSAGE_H_
 
 #include <vector>
+#include <mutex>
+#include <iostream>
 
 #include <wx/wx.h>
+#include <wx/thread.h>
+
+#ifndef OMNIFEM_HEADLESS
 #include <UI/StatusWindow.h>
+#endif
 
 
 
@@ -24,7 +30,8 @@ enum Status_Windows
  * @brief This class is the main messaging class for Omni-FEM. It handles the creation of log windows,
  * dispalying messages to the log windows, and logging any outputs to a file. Omni-FEM handles this
  * through a deteched method where the main program access this class through a static pointer within 
- * the messaging class.
+ * the messaging class. When Omni-FEM is built with OMNIFEM_HEADLESS (the batch program), there are no windows
+ * and the messages are written to the standard output instead.
  */
 class OmniFEMMsg
 {
@@ -34,18 +41,35 @@ private:
 	
 	bool p_logMessage = false;
 	
+#ifndef OMNIFEM_HEADLESS
 	std::vector<statusWindow*> p_statusWindows;
+#endif
+	
+	//! The messages that were sent from threads other then the main thread. Only the main thread is allowed to update the windows
+	std::vector<wxString> p_queuedMessages;
+	
+	//! The mutex that guards the list of queued messages
+	std::mutex p_queueMutex;
+	
+	/**
+	 * @brief 	Displays a message in all of the status windows that are shown. If this function is called from a thread
+	 * 			other then the main thread, the message is queued until the main thread displays it
+	 * @param message The message to display
+	 */
+	void displayMessage(wxString message);
 	
 public:
 	
 
 	OmniFEMMsg()
 	{
+#ifndef OMNIFEM_HEADLESS
 		// Create the three different windows
 		p_statusWindows.push_back(new statusWindow("Log Status Window", false, false));
 		p_statusWindows.push_back(new statusWindow("Mesh Status Window", true, false));
 		p_statusWindows[1]->setProgressBarOneTitle("Mesh Progress");
 		p_statusWindows.push_back(new statusWindow("Solver Status Window", true, true));
+#endif
 	}
 	
 	void instanceSetLogStatus(bool state)
@@ -59,10 +83,12 @@ public:
 	}
 	
 	
+#ifndef OMNIFEM_HEADLESS
 	std::vector<statusWindow*> getStatusWindows()
 	{
 		return p_statusWindows;
 	}
+#endif
 	
 	void MsgFatal(std::string message);
 	void wxMsgFatal(wxString message);
@@ -79,6 +105,12 @@ public:
 	void MsgStatus(std::string message);
 	void wxMsgStatus(wxString message);
 	
+	/**
+	 * @brief Displays all of the messages that were queued by other threads. This needs to be called from the main thread
+	 */
+	void flushMessages();
+	
+#ifndef OMNIFEM_HEADLESS
 	void displayWindow(Status_Windows displayWindowNum)
 	{
 		instance()->getStatusWindows()[(int)displayWindowNum]->displayWindow();
@@ -86,6 +118,9 @@ public:
 	
 	void incrementProgressBar(unsigned int value, Status_Windows window, int progressBar)
 	{
+		if(!wxIsMainThread())
+			return;
+		
 		if(progressBar == 1)
 			instance()->getStatusWindows()[(int)window]->incrementProgressBarOne(value);
 		else if(progressBar == 2)
@@ -94,6 +129,9 @@ public:
 	
 	void setProgressBarValue(unsigned int value, Status_Windows window, int progressBar)
 	{
+		if(!wxIsMainThread())
+			return;
+		
 		if(progressBar == 1)
 			instance()->getStatusWindows()[(int)window]->updateProgressBarOne(value);
 		else if(progressBar == 2)
@@ -102,12 +140,33 @@ public:
 	
 	void resetProgressBar(Status_Windows window, bool resetBarOne, bool resetBarTwo = false)
 	{
+		if(!wxIsMainThread())
+			return;
+		
 		if(resetBarOne)
 			instance()->getStatusWindows()[(int)window]->resetProgressBarOne();
 		
 		if(resetBarTwo)
 			instance()->getStatusWindows()[(int)window]->resetProgressBarTwo();
 	}
+#else
+	// There are no windows or progress bars without the user interface
+	void displayWindow(Status_Windows displayWindowNum)
+	{
+	}
+	
+	void incrementProgressBar(unsigned int value, Status_Windows window, int progressBar)
+	{
+	}
+	
+	void setProgressBarValue(unsigned int value, Status_Windows window, int progressBar)
+	{
+	}
+	
+	void resetProgressBar(Status_Windows window, bool resetBarOne, bool resetBarTwo = false)
+	{
+	}
+#endif
 	
 	static OmniFEMMsg *instance()
 	{
@@ -0,0 +1,218 @@
+#ifndef PROJECT_FILE_H_
+#define PROJECT_FILE_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+
+#include <common/ProblemDefinition.h>
+#include <common/GridPreferences.h>
+#include <common/OmniFEMMessage.h>
+
+#include <UI/GeometryEditor2D.h>
+
+
+//! The kinds of chunks in a project file. A reader skips the chunks that it does not know
+enum projectChunkType
+{
+	//! The problem definition, the grid preferences and the view of the canvas as a boost text archive
+	CHUNK_SETTINGS = 1,
+	/*! The names that the shapes refer to. Where each name starts as uint64 (with one more entry than there are names)
+		followed by the characters on the next 64 byte boundary. The names are not null terminated */
+	CHUNK_STRINGS,
+	CHUNK_NODES,
+	CHUNK_LINES,
+	CHUNK_ARCS,
+	CHUNK_LABELS
+};
+
+//! The columns of the nodes chunk. The names are stored as uint32 indices into the strings chunk
+enum projectNodeColumn
+{
+	NODE_X = 0,
+	NODE_Y,
+	NODE_ID,
+	NODE_PROBLEM,
+	NODE_NODAL_PROPERTY,
+	NODE_CONDUCTOR,
+	NODE_GROUP,
+	NUMBER_OF_NODE_COLUMNS
+};
+
+//! The columns of the lines chunk. The arcs chunk starts with the same columns
+enum projectEdgeColumn
+{
+	EDGE_X = 0,
+	EDGE_Y,
+	EDGE_DISTANCE,
+	EDGE_X_MID,
+	EDGE_Y_MID,
+	//! The IDs of the nodes at the ends of the edge as uint64
+	EDGE_FIRST_NODE,
+	EDGE_SECOND_NODE,
+	EDGE_PROBLEM,
+	EDGE_BOUNDARY,
+	EDGE_MESH_AUTO,
+	EDGE_ELEMENT_SIZE,
+	EDGE_CONDUCTOR,
+	EDGE_HIDDEN,
+	EDGE_GROUP,
+	NUMBER_OF_EDGE_COLUMNS
+};
+
+//! The columns of the arcs chunk that come after the columns of the lines
+enum projectArcColumn
+{
+	ARC_NUMBER_OF_SEGMENTS = NUMBER_OF_EDGE_COLUMNS,
+	ARC_ANGLE,
+	ARC_RADIUS,
+	ARC_COUNTER_CLOCKWISE,
+	ARC_ID,
+	NUMBER_OF_ARC_COLUMNS
+};
+
+//! The columns of the block labels chunk
+enum projectLabelColumn
+{
+	LABEL_X = 0,
+	LABEL_Y,
+	LABEL_MESH_SIZE_TYPE,
+	LABEL_MATERIAL,
+	LABEL_CIRCUIT,
+	LABEL_MESH_AUTO,
+	LABEL_TURNS,
+	LABEL_MAGNETIZATION,
+	LABEL_GROUP,
+	LABEL_EXTERNAL,
+	LABEL_DEFAULT,
+	LABEL_MESH_SIZE,
+	NUMBER_OF_LABEL_COLUMNS
+};
+
+//! The first bytes of a project file. The table of the chunks follows the header
+struct projectFileHeader
+{
+	//! Always "OFEMPROJ"
+	char magic[8];
+
+	//! The version of the layout. A file with a newer version is not read
+	uint32_t version;
+
+	//! Always 0x01020304 when read on a machine with the same byte order as the one that wrote the file
+	uint32_t byteOrder;
+
+	uint64_t numberOfChunks;
+};
+
+//! One entry of the table of the chunks
+struct projectFileChunk
+{
+	//! One of projectChunkType
+	uint32_t type;
+
+	//! The version of the columns of the chunk. A newer version may only add columns after the known ones
+	uint32_t version;
+
+	//! The number of entries. This is the number of bytes for the settings chunk
+	uint64_t count;
+
+	//! The offset of the chunk from the start of the file
+	uint64_t offset;
+
+	//! The size of the chunk in bytes
+	uint64_t size;
+};
+
+
+/**
+ * @class projectFile
+ * @author Phillip
+ * @date 17/10/26
+ * @file ProjectFile.h
+ * @brief 	Reads and writes the .omniFEM project files. The file is a header, a table of chunks and the chunks. The nodes, the
+ * 			lines, the arcs and the block labels are each a chunk that stores every saved field as its own column (one array
+ * 			per field). Each column starts on a 64 byte boundary and is written straight from the colonies of the geometry
+ * 			editor. The names of the properties are stored once in a string table and the shapes refer to them by index.
+ * 			The file is read with a single memory map. The only fixups are the lookups of the names and of the nodes at the
+ * 			ends of the lines and the arcs, which are found through their IDs. The problem definition, the grid preferences and
+ * 			the view are small and change often, so they are kept as a boost text archive in the settings chunk.
+ * 			Projects that were saved before the binary format are boost text archives. These do not start with the magic
+ * 			and are read through the old archive so that they can be written back in the binary format.
+ */
+class projectFile
+{
+private:
+	/**
+	 * @brief Reads a project that was saved as a boost text archive
+	 * @param filePath The path of the project
+	 * @param definition Stores the problem definition
+	 * @param preferences Stores the grid preferences
+	 * @param editor Stores the geometry. The editor should be empty
+	 * @param view Stores the zoom factor (x and y) and the camera displacement (x and y)
+	 * @return Returns false if the project could not be read
+	 */
+	static bool readTextArchive(std::string filePath, problemDefinition &definition, gridPreferences &preferences, geometryEditor2D &editor, std::vector<double> &view);
+
+	/**
+	 * @brief Reads a project that was saved in the binary format
+	 * @param filePath The path of the project
+	 * @param definition Stores the problem definition
+	 * @param preferences Stores the grid preferences
+	 * @param editor Stores the geometry. The editor should be empty. The lines and the arcs point to the nodes of the editor
+	 * @param view Stores the zoom factor (x and y) and the camera displacement (x and y)
+	 * @return Returns false if the file is not a valid project
+	 */
+	static bool readBinary(std::string filePath, problemDefinition &definition, gridPreferences &preferences, geometryEditor2D &editor, std::vector<double> &view);
+
+	/**
+	 * @brief Sets the fields that the lines and the arcs have in common from the columns of a chunk
+	 * @param edge The line or the arc
+	 * @param columns Where each column of the chunk starts in the mapped file
+	 * @param index The index of the edge in the chunk
+	 * @param names The names of the string table
+	 * @param nodeTable The nodes of the editor by their ID
+	 * @return Returns false if the edge refers to a name or a node that does not exist
+	 */
+	static bool setEdgeFields(edgeLineShape &edge, const std::vector<const char*> &columns, uint64_t index, const std::vector<std::string> &names, const std::unordered_map<unsigned long, node*> &nodeTable);
+
+public:
+	/**
+	 * @brief Checks if a file is a project in the binary format
+	 * @param filePath The path of the file
+	 * @return Returns true if the file starts with the magic of the binary format
+	 */
+	static bool isBinary(std::string filePath);
+
+	/**
+	 * @brief 	Writes a project in the binary format. The file is written under a temporary name and then renamed so that
+	 * 			the old project is kept if the file can not be written
+	 * @param filePath The path of the project
+	 * @param definition The problem definition
+	 * @param preferences The grid preferences
+	 * @param editor The geometry
+	 * @param view The zoom factor (x and y) and the camera displacement (x and y)
+	 * @return Returns false if the file could not be written
+	 */
+	static bool write(std::string filePath, problemDefinition &definition, gridPreferences &preferences, geometryEditor2D &editor, std::vector<double> &view);
+
+	/**
+	 * @brief Reads a project in either the binary format or as an old text archive
+	 * @param filePath The path of the project
+	 * @param definition Stores the problem definition
+	 * @param preferences Stores the grid preferences
+	 * @param editor Stores the geometry. The editor should be empty
+	 * @param view Stores the zoom factor (x and y) and the camera displacement (x and y)
+	 * @return Returns false if the project could not be read. The reason is reported as an error
+	 */
+	static bool read(std::string filePath, problemDefinition &definition, gridPreferences &preferences, geometryEditor2D &editor, std::vector<double> &view);
+
+	/**
+	 * @brief Converts a project that was saved as a text archive into the binary format in place
+	 * @param filePath The path of the project
+	 * @return Returns false if the project could not be read or written. A project that is already binary is left as it is
+	 */
+	static bool convert(std::string filePath);
+};
+
+#endif
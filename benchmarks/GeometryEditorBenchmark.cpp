@@ -0,0 +1,187 @@
+/*
+	Times how long geometryEditor2D takes to add a node and a line once the model is large. The nodes are placed on a
+	jittered grid so that none of them are rejected, then lines are drawn between neighbouring nodes. Every insert is
+	timed on its own. The mean over all of the inserts and the median and the 99th percentile of the last 10% are printed,
+	the last 10% being the inserts that run against a nearly full model.
+
+	Last, nodes are dragged onto the full model the same way that the canvas does it: a drag node is added on the mouse
+	down, moved with the mouse and on the release it is erased and added again with addNode. Only the release is timed.
+
+	Then, the first node of a line is moved the same way that a translation of the selection does it and
+	checkIntersections is called. The move and the check are timed together.
+
+	Only the geometry editor is needed. The editor uses wxRealPoint, so wxBase is linked, but nothing is drawn and no
+	display is needed. From the root of the repository:
+
+		g++ -O2 -std=c++11 -DOMNIFEM_HEADLESS $(wx-config --cxxflags --unicode=yes) -I. -IInclude \
+			benchmarks/GeometryEditorBenchmark.cpp src/UI/Geometry/GeometryEditor2D.cpp src/common/Vector.cpp \
+			$(wx-config --libs base) -lboost_serialization -o GeometryEditorBenchmark
+
+	Usage: GeometryEditorBenchmark [number of nodes] [number of lines] [number of drags] [number of moves]
+*/
+
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include <stdlib.h>
+#include <math.h>
+
+#include <UI/GeometryEditor2D.h>
+
+
+
+/**
+ * @brief Prints the mean over all of the inserts and the median and 99th percentile of the last 10%
+ * @param name What was inserted
+ * @param times The time of each insert in microseconds in the order that the inserts were made
+ * @param added The number of inserts that the editor accepted
+ */
+static void printTimes(std::string name, std::vector<double> times, unsigned long added)
+{
+	if(times.empty())
+		return;
+
+	double total = 0;
+
+	for(auto timeIterator = times.begin(); timeIterator != times.end(); timeIterator++)
+		total += *timeIterator;
+
+	std::vector<double> lastTimes(times.begin() + times.size() * 9 / 10, times.end());
+
+	std::sort(lastTimes.begin(), lastTimes.end());
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << name << ": " << times.size() << " inserts (" << added << " added) in " << total / 1e6 << " s\n";
+	std::cout << "\tMean: " << total / times.size() << " us\n";
+	std::cout << "\tLast 10%: median " << lastTimes[lastTimes.size() / 2] << " us, 99th percentile "
+			  << lastTimes[std::min(lastTimes.size() - 1, lastTimes.size() * 99 / 100)] << " us" << std::endl;
+}
+
+
+
+int main(int argc, char **argv)
+{
+	unsigned long numberOfNodes = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 100000;
+	unsigned long numberOfLines = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 20000;
+	unsigned long numberOfDrags = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 1000;
+	unsigned long numberOfMoves = (argc > 4) ? strtoul(argv[4], nullptr, 10) : 1000;
+	unsigned long side = (unsigned long)ceil(sqrt((double)numberOfNodes));
+	unsigned long added = 0;
+	geometryEditor2D editor;
+	std::vector<double> times;
+
+	if(numberOfNodes == 0)
+	{
+		std::cout << "Usage: GeometryEditorBenchmark [number of nodes] [number of lines] [number of drags] [number of moves]\n";
+		return 1;
+	}
+
+	srand(1);
+
+	times.reserve(numberOfNodes);
+
+	for(unsigned long i = 0; i < numberOfNodes; i++)
+	{
+		double xPoint = (i % side) + (rand() % 100) * 0.001;
+		double yPoint = (i / side) + (rand() % 100) * 0.001;
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		if(editor.addNode(xPoint, yPoint, 0.01))
+			added++;
+
+		times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count());
+	}
+
+	printTimes("Nodes", times, added);
+
+	/* The nodes are in the colony in the order that they were added. Joining the nodes of each row in pairs gives short
+	 * lines that do not cross each other */
+	std::vector<node*> nodes;
+
+	for(plf::colony<node>::iterator nodeIterator = editor.getNodeList()->begin(); nodeIterator != editor.getNodeList()->end(); nodeIterator++)
+		nodes.push_back(&(*nodeIterator));
+
+	times.clear();
+	added = 0;
+
+	for(unsigned long i = 0; i + 1 < nodes.size() && times.size() < numberOfLines; i++)
+	{
+		if((i % side) % 2 == 1 || (i % side) + 1 == side)
+			continue;
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		if(editor.addLine(nodes[i], nodes[i + 1], 0))
+			added++;
+
+		times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count());
+	}
+
+	printTimes("Lines", times, added);
+
+	// The nodes are dropped in the middle of the cells of the grid, away from the other nodes and the lines
+	unsigned long numberOfRows = (numberOfNodes + side - 1) / side;
+
+	times.clear();
+	added = 0;
+
+	for(unsigned long i = 0; i < numberOfDrags; i++)
+	{
+		double xPoint = (rand() % side) + 0.5;
+		double yPoint = (rand() % numberOfRows) + 0.5;
+
+		editor.addDragNode(xPoint - 0.2, yPoint - 0.2);
+		editor.getLastNodeAdd()->setCenter(xPoint - 0.1, yPoint - 0.1);
+		editor.updateSpatialIndex(*editor.getLastNodeAdd());
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		editor.eraseNode(editor.getLastNodeAdd());
+
+		if(editor.addNode(xPoint, yPoint, 0.01))
+			added++;
+
+		times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count());
+	}
+
+	printTimes("Drag releases", times, added);
+
+	/* The node is moved up and back down by a third of a cell. This keeps the line clear of the other lines and of the nodes
+	 * that were dropped in the middle of the cells */
+	std::vector<edgeLineShape*> lines;
+
+	for(plf::colony<edgeLineShape>::iterator lineIterator = editor.getLineList()->begin(); lineIterator != editor.getLineList()->end(); lineIterator++)
+		lines.push_back(&(*lineIterator));
+
+	node *movedNode = nullptr;
+
+	times.clear();
+
+	for(unsigned long i = 0; i < numberOfMoves && !lines.empty(); i++)
+	{
+		double verticalShift = 0.3;
+
+		if(i % 2 == 0)
+			movedNode = lines[rand() % lines.size()]->getFirstNode();
+		else
+			verticalShift = -0.3;
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		editor.moveNode(*movedNode, movedNode->getCenterXCoordinate(), movedNode->getCenterYCoordinate() + verticalShift);
+		editor.checkIntersections(EditGeometry::EDIT_ALL, 0.01);
+
+		times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count());
+	}
+
+	printTimes("Moves", times, times.size());
+
+	std::cout << editor.getNodeList()->size() << " nodes, " << editor.getLineList()->size() << " lines" << std::endl;
+
+	return 0;
+}
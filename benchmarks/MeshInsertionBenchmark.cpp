@@ -0,0 +1,121 @@
+/*
+	Times the point insertion of the 2D mesher (Bowyer-Watson or frontal Delaunay) on one square face. The element
+	size sets the number of triangles: 0.0016 gives about one million. The face is meshed a few times and the fastest
+	and the median run are printed together with the number of triangles per second.
+
+	The program only needs the objects of the batch program (OMNIFEM_HEADLESS, so no display). Build the
+	Omni-FEM-Batch project in release and then, from the root of the repository:
+
+		g++ -O2 -fopenmp -std=c++11 -DOMNIFEM_HEADLESS $(wx-config --cxxflags --unicode=yes) -I. -IInclude -IInclude/Mesh/GMSH \
+			benchmarks/MeshInsertionBenchmark.cpp $(ls Release-Batch/*.o | grep -v OmniFEMBatch) \
+			$(wx-config --libs base) -lboost_serialization -llapack -lz -o MeshInsertionBenchmark
+
+	Usage: MeshInsertionBenchmark [element size] [delaunay|frontal] [runs]
+*/
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+#include <stdlib.h>
+
+#include <common/OS.h>
+
+#include <Mesh/GMSH/Gmsh.h>
+#include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/GFace.h>
+#include <Mesh/GMSH/Context.h>
+#include <Mesh/GMSH/GmshDefines.h>
+
+
+
+/**
+ * @brief Meshes a unit square
+ * @param elementSize The size of the elements
+ * @param algorithm The 2D algorithm of GMSH
+ * @param numberOfTriangles Stores the number of triangles of the mesh
+ * @return Returns the time that the mesher took in seconds
+ */
+static double meshSquare(double elementSize, int algorithm, unsigned long &numberOfTriangles)
+{
+	GModel *model = new GModel();
+
+	model->setFactory("Gmsh");
+
+	GVertex *corners[4] = {model->addVertex(0, 0, 0, elementSize), model->addVertex(1, 0, 0, elementSize),
+						   model->addVertex(1, 1, 0, elementSize), model->addVertex(0, 1, 0, elementSize)};
+	std::vector<std::vector<GEdge*>> loop(1);
+
+	for(int i = 0; i < 4; i++)
+		loop[0].push_back(model->addLine(corners[i], corners[(i + 1) % 4]));
+
+	GFace *square = model->addPlanarFace(loop);
+
+	// The size of the elements then only comes from the corners
+	for(GModel::eiter edgeIterator = model->firstEdge(); edgeIterator != model->lastEdge(); edgeIterator++)
+		(*edgeIterator)->meshAttributes.meshSize = 1;
+
+	square->meshAttributes.meshSize = 1;
+
+	CTX::instance()->lc = sqrt(2.0);
+	CTX::instance()->mesh.lcFromPoints = 1;
+	CTX::instance()->mesh.lcFromCurvature = 0;
+	CTX::instance()->mesh.lcExtendFromBoundary = 1;
+	CTX::instance()->mesh.lcFactor = 1;
+	CTX::instance()->mesh.lcMin = 0;
+	CTX::instance()->mesh.lcMax = elementSize;
+	CTX::instance()->mesh.algo2d = algorithm;
+
+	double startTime = TimeOfDay();
+
+	model->mesh(2);
+
+	double meshTime = TimeOfDay() - startTime;
+
+	numberOfTriangles = 0;
+
+	for(GModel::fiter faceIterator = model->firstFace(); faceIterator != model->lastFace(); faceIterator++)
+		numberOfTriangles += (*faceIterator)->triangles.size();
+
+	delete model;
+
+	return meshTime;
+}
+
+
+
+int main(int argc, char **argv)
+{
+	double elementSize = (argc > 1) ? atof(argv[1]) : 0.0016;
+	std::string algorithmName = (argc > 2) ? argv[2] : "delaunay";
+	int numberOfRuns = (argc > 3) ? std::max(atoi(argv[3]), 1) : 3;
+	int algorithm = (algorithmName == "frontal") ? ALGO_2D_FRONTAL : ALGO_2D_DELAUNAY;
+	std::vector<double> times;
+	unsigned long numberOfTriangles = 0;
+
+	if(elementSize <= 0 || (algorithmName != "frontal" && algorithmName != "delaunay"))
+	{
+		std::cout << "Usage: MeshInsertionBenchmark [element size] [delaunay|frontal] [runs]\n";
+		return 1;
+	}
+
+	GmshInitialize();
+
+	for(int i = 0; i < numberOfRuns; i++)
+	{
+		times.push_back(meshSquare(elementSize, algorithm, numberOfTriangles));
+		std::cout << "Run " << i + 1 << ": " << numberOfTriangles << " triangles in " << times.back() << " s" << std::endl;
+	}
+
+	std::sort(times.begin(), times.end());
+
+	std::cout << algorithmName << ", element size " << elementSize << ", " << numberOfTriangles << " triangles\n";
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "Fastest: " << times.front() << " s (" << std::setprecision(0) << numberOfTriangles / times.front() << " triangles/s)\n";
+	std::cout << std::setprecision(3) << "Median: " << times[times.size() / 2] << " s (" << std::setprecision(0)
+			  << numberOfTriangles / times[times.size() / 2] << " triangles/s)" << std::endl;
+
+	return 0;
+}
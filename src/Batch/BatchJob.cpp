@@ -0,0 +1,394 @@
+#include <Batch/BatchJob.h>
+
+#include <iomanip>
+#include <algorithm>
+
+
+
+batchJob::batchJob(std::string filePath, std::string outputFolder, std::string name)
+{
+	p_filePath = filePath;
+	p_outputFolder = outputFolder;
+	p_name = name;
+}
+
+
+
+std::string batchJob::getOutputName(std::string filePath)
+{
+	size_t nameStart = filePath.find_last_of("/\\");
+	std::string name = (nameStart == std::string::npos) ? filePath : filePath.substr(nameStart + 1);
+
+	if(name.size() > 8 && name.substr(name.size() - 8) == ".omniFEM")
+		name.erase(name.size() - 8);
+
+	return name;
+}
+
+
+
+std::vector<std::string> batchJob::getOutputNames(const std::vector<std::string> &filePaths)
+{
+	std::vector<std::string> names(filePaths.size());
+	std::map<std::string, int> nameCount;
+
+	for(size_t i = 0; i < filePaths.size(); i++)
+	{
+		names[i] = getOutputName(filePaths[i]);
+		nameCount[names[i]]++;
+	}
+
+	for(size_t i = 0; i < filePaths.size(); i++)
+	{
+		if(nameCount[names[i]] < 2)
+			continue;
+
+		std::string name = filePaths[i];
+
+		if(name.size() > 8 && name.substr(name.size() - 8) == ".omniFEM")
+			name.erase(name.size() - 8);
+
+		// The leading "/", "./" and "../" of the path would only add separators and dots to the front of the name
+		size_t nameStart = name.find_first_not_of("./\\");
+
+		name = (nameStart == std::string::npos) ? std::string() : name.substr(nameStart);
+		std::replace(name.begin(), name.end(), '/', '_');
+		std::replace(name.begin(), name.end(), '\\', '_');
+		std::replace(name.begin(), name.end(), ':', '_');
+
+		names[i] = name;
+	}
+
+	nameCount.clear();
+
+	for(size_t i = 0; i < names.size(); i++)
+		nameCount[names[i]]++;
+
+	for(size_t i = 0; i < names.size(); i++)
+	{
+		if(nameCount[names[i]] > 1)
+			names[i] += "_" + std::to_string(i + 1);
+	}
+
+	return names;
+}
+
+
+
+batchJob::~batchJob()
+{
+	delete p_electrostaticSolver;
+	delete p_magnetostaticSolver;
+	delete p_harmonicMagneticSolver;
+	delete p_transientMagneticSolver;
+	delete p_meshModel;
+}
+
+
+
+bool batchJob::load()
+{
+	gridPreferences tempPreferences;
+	std::vector<double> tempSomething;
+
+	// The editor is not copied after it is loaded so the lines and the arcs already point to its nodes
+	if(!projectFile::read(p_filePath, p_definition, tempPreferences, p_editor, tempSomething))
+		return false;
+
+	/* The variants of a parametric study are usually copies of the same file, so the outputs are named after the file
+	 * and not after the name of the simulation that is stored in the file
+	 */
+	p_definition.setName(wxString(p_name));
+	p_definition.setSaveFilePath(wxString(p_outputFolder));
+	p_definition.getMeshSettingsPointer()->setDirString(wxString(p_outputFolder));
+
+	return true;
+}
+
+
+
+void batchJob::setTransient()
+{
+	magneticPreference preferences = p_definition.getMagneticPreference();
+
+	preferences.setTransient(true);
+	p_definition.setPreferences(preferences);
+}
+
+
+
+bool batchJob::mesh()
+{
+	if(p_editor.getBlockLabelList()->size() == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("Need to have at least 1 block label in the geometry");
+		return false;
+	}
+
+	double startTime = TimeOfDay();
+
+	delete p_meshModel;
+	p_meshModel = new GModel();
+
+	meshMaker mesher(p_definition, p_editor, p_meshModel);
+	mesher.mesh();
+
+	if(p_meshModel->getNumMeshVertices() == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("No mesh was created for " + p_filePath);
+		return false;
+	}
+
+	p_meshModel->writeMSH(p_outputFolder + "/" + p_name + ".msh", 2.2, false, true);
+	meshCache::write(meshCache::getCachePath(p_outputFolder + "/" + p_name), p_meshModel, meshCache::computeGeometryHash(p_editor));
+
+	OmniFEMMsg::instance()->MsgStatus("Meshed " + p_name + " in " + std::to_string(TimeOfDay() - startTime) + " s");
+
+	return true;
+}
+
+
+
+bool batchJob::solve()
+{
+	const bool isAdaptive = p_definition.getMeshSettingsPointer()->getAdaptiveRefinementState();
+	double startTime = TimeOfDay();
+	bool solved = false;
+
+	if(!p_meshModel)
+		return false;
+
+	if(p_definition.getPhysicsProblem() == physicProblems::PROB_ELECTROSTATIC)
+	{
+		if(isAdaptive)
+		{
+			adaptiveRefinement refinement(p_definition, p_meshModel);
+			p_electrostaticSolver = refinement.solveElectrostatic();
+			solved = (p_electrostaticSolver != nullptr);
+		}
+		else
+		{
+			p_electrostaticSolver = new electrostaticSolver(p_definition, p_meshModel);
+			solved = p_electrostaticSolver->solve();
+		}
+	}
+	else if(p_definition.getMagneticPreference().isTransient())
+	{
+		magneticPreference preferences = p_definition.getMagneticPreference();
+
+		if(isAdaptive)
+			OmniFEMMsg::instance()->MsgWarning("The adaptive refinement is only available for static problems. The problem is solved on the current mesh");
+
+		if(preferences.getFrequency() <= 0)
+		{
+			OmniFEMMsg::instance()->MsgError("A transient problem needs a frequency greater than 0");
+			return false;
+		}
+
+		p_transientMagneticSolver = new transientMagneticSolver(p_definition, p_meshModel);
+		p_transientMagneticSolver->setSeriesOutput(p_outputFolder + "/" + p_name + "_transient", vtuWriter::canCompress());
+		solved = p_transientMagneticSolver->solve(preferences.getTransientPeriods(), preferences.getTransientStepsPerPeriod());
+
+		if(solved)
+		{
+			std::string unit = preferences.isAxistmmetric() ? " W" : " W/m";
+			OmniFEMMsg::instance()->MsgStatus("Hysteresis loss: " + std::to_string(p_transientMagneticSolver->getHysteresisLoss()) + unit);
+			OmniFEMMsg::instance()->MsgStatus("Eddy current loss: " + std::to_string(p_transientMagneticSolver->getEddyCurrentLoss()) + unit);
+		}
+	}
+	else if(p_definition.getMagneticPreference().getFrequency() != 0)
+	{
+		if(isAdaptive)
+			OmniFEMMsg::instance()->MsgWarning("The adaptive refinement is only available for static problems. The problem is solved on the current mesh");
+
+		p_harmonicMagneticSolver = new harmonicMagneticSolver(p_definition, p_meshModel);
+		solved = p_harmonicMagneticSolver->solve();
+	}
+	else
+	{
+		if(isAdaptive)
+		{
+			adaptiveRefinement refinement(p_definition, p_meshModel);
+			p_magnetostaticSolver = refinement.solveMagnetostatic();
+			solved = (p_magnetostaticSolver != nullptr);
+		}
+		else
+		{
+			p_magnetostaticSolver = new magnetostaticSolver(p_definition, p_meshModel);
+			solved = p_magnetostaticSolver->solve();
+		}
+	}
+
+	if(!solved)
+	{
+		OmniFEMMsg::instance()->MsgError("The solver failed for " + p_filePath);
+		return false;
+	}
+
+	// The adaptive refinement replaced the mesh that was written after meshing
+	if(isAdaptive)
+		p_meshModel->writeMSH(p_outputFolder + "/" + p_name + ".msh", 2.2, false, true);
+
+	OmniFEMMsg::instance()->MsgStatus("Solved " + p_name + " in " + std::to_string(TimeOfDay() - startTime) + " s");
+
+	bool isSolutionWritten = writeSolution();
+
+	if(p_transientMagneticSolver && !writeEnergies())
+		isSolutionWritten = false;
+
+	return writeResults() && isSolutionWritten;
+}
+
+
+
+bool batchJob::writeSolution()
+{
+	std::string filePath = p_outputFolder + "/" + p_name + ".csv";
+	std::ofstream solutionFile(filePath);
+	solverMesh *mesh = nullptr;
+
+	if(!solutionFile.is_open())
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to write " + filePath);
+		return false;
+	}
+
+	if(p_electrostaticSolver)
+		mesh = p_electrostaticSolver->getMesh();
+	else if(p_magnetostaticSolver)
+		mesh = p_magnetostaticSolver->getMesh();
+	else if(p_harmonicMagneticSolver)
+		mesh = p_harmonicMagneticSolver->getMesh();
+	else if(p_transientMagneticSolver)
+		mesh = p_transientMagneticSolver->getMesh();
+
+	const double *x = mesh->getXCoordinates();
+	const double *y = mesh->getYCoordinates();
+
+	solutionFile << std::setprecision(12);
+
+	if(p_electrostaticSolver)
+	{
+		const std::vector<double> &potential = *p_electrostaticSolver->getPotential();
+
+		solutionFile << "x,y,V\n";
+
+		for(int i = 0; i < mesh->getNumberOfNodes(); i++)
+			solutionFile << x[i] << "," << y[i] << "," << potential[i] << "\n";
+	}
+	else if(p_magnetostaticSolver)
+	{
+		const std::vector<double> &potential = *p_magnetostaticSolver->getPotential();
+
+		solutionFile << "x,y,A\n";
+
+		for(int i = 0; i < mesh->getNumberOfNodes(); i++)
+			solutionFile << x[i] << "," << y[i] << "," << potential[i] << "\n";
+	}
+	else if(p_transientMagneticSolver)
+	{
+		const std::vector<double> &potential = *p_transientMagneticSolver->getPotential();
+
+		// The potential at the last accepted step. The steps before it are in the .pvd collection
+		solutionFile << "x,y,A\n";
+
+		for(int i = 0; i < mesh->getNumberOfNodes(); i++)
+			solutionFile << x[i] << "," << y[i] << "," << potential[i] << "\n";
+	}
+	else
+	{
+		const std::vector<std::complex<double>> &potential = *p_harmonicMagneticSolver->getPotential();
+
+		solutionFile << "x,y,A real,A imaginary\n";
+
+		for(int i = 0; i < mesh->getNumberOfNodes(); i++)
+			solutionFile << x[i] << "," << y[i] << "," << potential[i].real() << "," << potential[i].imag() << "\n";
+	}
+
+	return solutionFile.good();
+}
+
+
+
+bool batchJob::writeResults()
+{
+	const std::string basePath = p_outputFolder + "/" + p_name;
+
+	if(p_electrostaticSolver)
+	{
+		vtuWriter writer(p_electrostaticSolver->getMesh(), false, vtuWriter::canCompress());
+
+		writer.addPointData("V", p_electrostaticSolver->getPotential()->data());
+
+		return writer.write(basePath + ".vtu");
+	}
+	else if(p_magnetostaticSolver)
+	{
+		vtuWriter writer(p_magnetostaticSolver->getMesh(), false, vtuWriter::canCompress());
+
+		writer.addPointData("A", p_magnetostaticSolver->getPotential()->data());
+		writer.addCellVector("B", p_magnetostaticSolver->getFluxDensityX()->data(), p_magnetostaticSolver->getFluxDensityY()->data());
+
+		return writer.write(basePath + ".vtu");
+	}
+	else if(p_transientMagneticSolver)
+	{
+		vtuWriter writer(p_transientMagneticSolver->getMesh(), false, vtuWriter::canCompress());
+
+		writer.addPointData("A", p_transientMagneticSolver->getPotential()->data());
+		writer.addCellVector("B", p_transientMagneticSolver->getFluxDensityX()->data(), p_transientMagneticSolver->getFluxDensityY()->data());
+
+		return writer.write(basePath + ".vtu");
+	}
+
+	const std::vector<double> &frequencies = p_harmonicMagneticSolver->getFrequencies();
+	pvdWriter collection(basePath + ".pvd");
+
+	// The frequency takes the place of the time in the collection of a sweep
+	for(unsigned int i = 0; i < frequencies.size(); i++)
+	{
+		vtuWriter writer(p_harmonicMagneticSolver->getMesh(), false, vtuWriter::canCompress());
+		const std::string filePath = (frequencies.size() == 1) ? basePath + ".vtu" : pvdWriter::getStepPath(basePath, i);
+		const double *fluxDensityX = reinterpret_cast<const double*>(p_harmonicMagneticSolver->getFluxDensityX(i)->data());
+		const double *fluxDensityY = reinterpret_cast<const double*>(p_harmonicMagneticSolver->getFluxDensityY(i)->data());
+
+		writer.addPointData("A", *p_harmonicMagneticSolver->getPotential(i));
+		writer.addCellVector("B_real", fluxDensityX, fluxDensityY, 2);
+		writer.addCellVector("B_imaginary", fluxDensityX + 1, fluxDensityY + 1, 2);
+		writer.addCellData("J", *p_harmonicMagneticSolver->getCurrentDensity(i));
+
+		if(!writer.write(filePath))
+			return false;
+
+		if(frequencies.size() > 1 && !collection.addStep(frequencies[i], filePath))
+			return false;
+	}
+
+	return true;
+}
+
+
+
+bool batchJob::writeEnergies()
+{
+	std::string filePath = p_outputFolder + "/" + p_name + "_energy.csv";
+	std::ofstream energyFile(filePath);
+
+	if(!energyFile.is_open())
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to write " + filePath);
+		return false;
+	}
+
+	const std::vector<double> &times = *p_transientMagneticSolver->getTimes();
+	const std::vector<double> &hysteresisEnergies = *p_transientMagneticSolver->getHysteresisEnergy();
+	const std::vector<double> &eddyCurrentEnergies = *p_transientMagneticSolver->getEddyCurrentEnergy();
+
+	energyFile << std::setprecision(12);
+	energyFile << "t,hysteresis energy,eddy current energy\n";
+
+	for(size_t i = 0; i < times.size(); i++)
+		energyFile << times[i] << "," << hysteresisEnergies[i] << "," << eddyCurrentEnergies[i] << "\n";
+
+	return energyFile.good();
+}
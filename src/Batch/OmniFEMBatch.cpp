@@ -0,0 +1,323 @@
+/*
+	This file contains the entry point of the batch program. The batch program meshes (and optionally solves) a list of
+	.omniFEM files without a display. GMSH keeps its options and models in global state, so the files cannot be meshed
+	by several threads of one process. Instead, each file is ran in a child process and up to the given number of child
+	processes run at once. The output of each child is written to a log file next to its outputs so that one file that
+	crashes or fails does not stop the rest of the batch.
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <algorithm>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <wx/init.h>
+#include <wx/dir.h>
+
+#include <Batch/BatchJob.h>
+
+
+//! The exit codes of the child processes
+enum batchExitCode
+{
+	BATCH_SUCCESS = 0,
+	BATCH_LOAD_FAILED,
+	BATCH_MESH_FAILED,
+	BATCH_SOLVE_FAILED
+};
+
+
+
+static void printUsage()
+{
+	std::cout << "Usage: Omni-FEM-Batch [options] file.omniFEM ...\n"
+				 "Options:\n"
+				 "  -o <folder>  Folder that the outputs are written into (default: the current folder)\n"
+				 "  -j <number>  Number of files that are ran at once (default: the number of cores)\n"
+				 "  -l <file>    Text file with one .omniFEM file on each line\n"
+				 "  -m           Only mesh the files. The problems are not solved\n"
+				 "  -t           Solve the magnetic problems in time with the Jiles-Atherton hysteresis model. The periods and the\n"
+				 "               steps per period are taken from the preferences of each file\n"
+				 "  -c           Convert the files that were saved as text archives into the binary format. Nothing is meshed\n"
+				 "  -h           Show this message\n";
+}
+
+
+
+/**
+ * @brief Runs one file. This is called in the child process
+ * @param filePath The path to the .omniFEM file
+ * @param outputFolder The folder that the outputs are written into
+ * @param name The name that the outputs are written under
+ * @param isMeshOnly Set to true to skip the solve
+ * @param isTransient Set to true to solve the magnetic problems in time with hysteresis
+ * @return Returns one of the batch exit codes
+ */
+static int runFile(std::string filePath, std::string outputFolder, std::string name, bool isMeshOnly, bool isTransient)
+{
+	batchJob job(filePath, outputFolder, name);
+
+	if(!job.load())
+		return BATCH_LOAD_FAILED;
+
+	if(isTransient)
+		job.setTransient();
+
+	if(!job.mesh())
+		return BATCH_MESH_FAILED;
+
+	if(!isMeshOnly && !job.solve())
+		return BATCH_SOLVE_FAILED;
+
+	return BATCH_SUCCESS;
+}
+
+
+
+/**
+ * @brief Quotes a field of the summary so that commas and quotes in the paths do not split the row
+ * @param field The text of the field
+ * @return Returns the field in double quotes with each quote inside it doubled
+ */
+static std::string getQuotedField(std::string field)
+{
+	std::string quotedField = "\"";
+
+	for(size_t i = 0; i < field.size(); i++)
+	{
+		if(field[i] == '"')
+			quotedField += '"';
+
+		quotedField += field[i];
+	}
+
+	return quotedField + "\"";
+}
+
+
+
+static std::string getStatusName(int status)
+{
+	if(WIFSIGNALED(status))
+		return "CRASHED (signal " + std::to_string(WTERMSIG(status)) + ")";
+
+	switch(WEXITSTATUS(status))
+	{
+		case BATCH_SUCCESS:
+			return "OK";
+		case BATCH_LOAD_FAILED:
+			return "LOAD FAILED";
+		case BATCH_MESH_FAILED:
+			return "MESH FAILED";
+		case BATCH_SOLVE_FAILED:
+			return "SOLVE FAILED";
+		default:
+			return "FAILED";
+	}
+}
+
+
+
+int main(int argc, char **argv)
+{
+	std::vector<std::string> files;
+	std::string outputFolder = ".";
+	unsigned int numberOfJobs = std::max(std::thread::hardware_concurrency(), 1u);
+	bool isMeshOnly = false;
+	bool isConvertOnly = false;
+	bool isTransient = false;
+
+	for(int i = 1; i < argc; i++)
+	{
+		std::string argument(argv[i]);
+
+		if(argument == "-o" && i + 1 < argc)
+			outputFolder = argv[++i];
+		else if(argument == "-j" && i + 1 < argc)
+			numberOfJobs = std::max(atoi(argv[++i]), 1);
+		else if(argument == "-l" && i + 1 < argc)
+		{
+			std::ifstream listFile(argv[++i]);
+			std::string line;
+
+			if(!listFile.is_open())
+			{
+				std::cerr << "Unable to open the list " << argv[i] << "\n";
+				return 1;
+			}
+
+			while(std::getline(listFile, line))
+			{
+				if(!line.empty() && line[0] != '#')
+					files.push_back(line);
+			}
+		}
+		else if(argument == "-m")
+			isMeshOnly = true;
+		else if(argument == "-c")
+			isConvertOnly = true;
+		else if(argument == "-t")
+			isTransient = true;
+		else if(argument == "-h" || argument[0] == '-')
+		{
+			printUsage();
+			return (argument == "-h") ? 0 : 1;
+		}
+		else
+			files.push_back(argument);
+	}
+
+	if(files.empty())
+	{
+		printUsage();
+		return 1;
+	}
+
+	wxInitializer initializer;
+
+	if(!initializer.IsOk())
+	{
+		std::cerr << "Unable to initialize wxWidgets\n";
+		return 1;
+	}
+
+	if(isConvertOnly)
+	{
+		int numberOfFailed = 0;
+
+		for(size_t i = 0; i < files.size(); i++)
+		{
+			const bool wasBinary = projectFile::isBinary(files[i]);
+			const bool isConverted = projectFile::convert(files[i]);
+
+			if(!isConverted)
+				numberOfFailed++;
+
+			std::cout << files[i] << ": " << (!isConverted ? "FAILED" : (wasBinary ? "already binary" : "converted")) << std::endl;
+		}
+
+		return (numberOfFailed == 0) ? 0 : 1;
+	}
+
+	if(!wxDir::Exists(outputFolder) && !wxDir::Make(outputFolder, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL))
+	{
+		std::cerr << "Unable to create the output folder " << outputFolder << "\n";
+		return 1;
+	}
+
+	numberOfJobs = std::min(numberOfJobs, (unsigned int)files.size());
+
+	// The cores are split between the files that run at once. Each file uses its share for the threads of the mesher and the solvers
+	const int threadsPerJob = std::max((int)std::thread::hardware_concurrency() / (int)numberOfJobs, 1);
+	const std::vector<std::string> outputNames = batchJob::getOutputNames(files);
+	std::map<pid_t, size_t> runningJobs;
+	std::vector<std::string> jobResult(files.size(), "NOT RAN");
+	std::vector<double> jobTime(files.size(), 0.0);
+	size_t nextFile = 0;
+	size_t numberOfFinished = 0;
+	int numberOfFailed = 0;
+
+	std::cout << "Running " << files.size() << " file(s), " << numberOfJobs << " at a time with " << threadsPerJob << " thread(s) each" << std::endl;
+
+	while(numberOfFinished < files.size())
+	{
+		while(nextFile < files.size() && runningJobs.size() < numberOfJobs)
+		{
+			// The buffers are flushed so that the child does not write the output of the parent a second time
+			std::cout.flush();
+			fflush(stdout);
+
+			pid_t processID = fork();
+
+			if(processID == 0)
+			{
+				std::string logPath = outputFolder + "/" + outputNames[nextFile] + ".log";
+
+				// The errors share the file (and the position in the file) of the output so that the two are in order
+				if(!freopen(logPath.c_str(), "w", stdout) || dup2(fileno(stdout), fileno(stderr)) < 0)
+					_exit(BATCH_LOAD_FAILED);
+
+				setvbuf(stdout, nullptr, _IOLBF, BUFSIZ);
+
+#if defined(_OPENMP)
+				omp_set_num_threads(threadsPerJob);
+#endif
+
+				int exitCode = runFile(files[nextFile], outputFolder, outputNames[nextFile], isMeshOnly, isTransient);
+
+				std::cout.flush();
+				fflush(stdout);
+				_exit(exitCode);
+			}
+			else if(processID < 0)
+			{
+				// Wait for one of the running files to finish before trying again
+				if(!runningJobs.empty())
+					break;
+
+				jobResult[nextFile] = "NOT STARTED";
+				numberOfFinished++;
+				numberOfFailed++;
+				std::cout << "[" << numberOfFinished << "/" << files.size() << "] " << jobResult[nextFile] << " " << files[nextFile] << std::endl;
+			}
+			else
+			{
+				runningJobs[processID] = nextFile;
+				jobTime[nextFile] = TimeOfDay();
+			}
+
+			nextFile++;
+		}
+
+		if(runningJobs.empty())
+			continue;
+
+		int status = 0;
+		pid_t finishedID = wait(&status);
+
+		if(finishedID < 0)
+			break;
+
+		std::map<pid_t, size_t>::iterator jobIterator = runningJobs.find(finishedID);
+
+		if(jobIterator == runningJobs.end())
+			continue;
+
+		const size_t finishedFile = jobIterator->second;
+
+		runningJobs.erase(jobIterator);
+		jobResult[finishedFile] = getStatusName(status);
+		jobTime[finishedFile] = TimeOfDay() - jobTime[finishedFile];
+		numberOfFinished++;
+
+		if(!WIFEXITED(status) || WEXITSTATUS(status) != BATCH_SUCCESS)
+			numberOfFailed++;
+
+		std::cout << "[" << numberOfFinished << "/" << files.size() << "] " << jobResult[finishedFile] << " " << files[finishedFile] << " (" << jobTime[finishedFile] << " s)" << std::endl;
+	}
+
+	// The summary is a table that can be read back by a script after a large run
+	std::ofstream summaryFile(outputFolder + "/batch_summary.csv");
+
+	summaryFile << "file,output,status,seconds\n";
+
+	for(size_t i = 0; i < files.size(); i++)
+		summaryFile << getQuotedField(files[i]) << "," << getQuotedField(outputNames[i]) << "," << jobResult[i] << "," << jobTime[i] << "\n";
+
+	std::cout << files.size() - numberOfFailed << " of " << files.size() << " file(s) finished" << std::endl;
+
+	return (numberOfFailed == 0) ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+#include <Mesh/CompactPolygon.h>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+
+void compactPolygon::addArc(arcShape *arc, bool isForward)
+{
+	node *startNode = isForward ? arc->getFirstNode() : arc->getSecondNode();
+	node *endNode = isForward ? arc->getSecondNode() : arc->getFirstNode();
+
+	p_arcStartX.push_back(startNode->getCenterXCoordinate());
+	p_arcStartY.push_back(startNode->getCenterYCoordinate());
+	p_arcChordX.push_back(endNode->getCenterXCoordinate() - startNode->getCenterXCoordinate());
+	p_arcChordY.push_back(endNode->getCenterYCoordinate() - startNode->getCenterYCoordinate());
+	p_arcCenterX.push_back(arc->getCenterXCoordinate());
+	p_arcCenterY.push_back(arc->getCenterYCoordinate());
+	p_arcRadiusSquared.push_back(arc->getRadius() * arc->getRadius());
+
+	// The arc goes CCW about its center from the first node to the second node
+	p_arcDirection.push_back(isForward ? 1.0 : -1.0);
+}
+
+
+
+void compactPolygon::build(std::vector<edgeLineShape*> &edges)
+{
+	clear();
+
+	if(edges.size() == 0)
+		return;
+
+	/* The path is walked starting from the node of the first edge that is not shared with the second edge.
+	 * After that, each edge starts at the node where the previous edge ended
+	 */
+	node *currentNode = edges[0]->getFirstNode();
+
+	if(edges.size() > 1)
+	{
+		node *secondNode = edges[0]->getSecondNode();
+
+		if(!(*secondNode == *edges[1]->getFirstNode() || *secondNode == *edges[1]->getSecondNode()))
+			currentNode = secondNode;
+	}
+
+	p_vertexX.reserve(edges.size() + 1);
+	p_vertexY.reserve(edges.size() + 1);
+
+	for(std::vector<edgeLineShape*>::iterator edgeIterator = edges.begin(); edgeIterator != edges.end(); ++edgeIterator)
+	{
+		bool isForward = (*(*edgeIterator)->getFirstNode() == *currentNode);
+
+		p_vertexX.push_back(currentNode->getCenterXCoordinate());
+		p_vertexY.push_back(currentNode->getCenterYCoordinate());
+
+		if((*edgeIterator)->isArc() && static_cast<arcShape*>(*edgeIterator)->getRadius() > 0)
+			addArc(static_cast<arcShape*>(*edgeIterator), isForward);
+
+		currentNode = isForward ? (*edgeIterator)->getSecondNode() : (*edgeIterator)->getFirstNode();
+	}
+
+	p_vertexX.push_back(p_vertexX.front());
+	p_vertexY.push_back(p_vertexY.front());
+}
+
+
+
+void compactPolygon::clear()
+{
+	p_vertexX.clear();
+	p_vertexY.clear();
+	p_arcStartX.clear();
+	p_arcStartY.clear();
+	p_arcChordX.clear();
+	p_arcChordY.clear();
+	p_arcCenterX.clear();
+	p_arcCenterY.clear();
+	p_arcRadiusSquared.clear();
+	p_arcDirection.clear();
+}
+
+
+
+int compactPolygon::scalarWindingNumber(double x, double y) const
+{
+	int winding = 0;
+
+	if(p_vertexX.empty())
+		return 0;
+
+	// The winding number of the polygon formed by the chords
+	for(size_t i = 0; i < p_vertexX.size() - 1; i++)
+	{
+		double isLeft = (p_vertexX[i + 1] - p_vertexX[i]) * (y - p_vertexY[i]) - (x - p_vertexX[i]) * (p_vertexY[i + 1] - p_vertexY[i]);
+
+		if(p_vertexY[i] <= y)
+		{
+			if(p_vertexY[i + 1] > y && isLeft > 0)
+				winding++;
+		}
+		else if(p_vertexY[i + 1] <= y && isLeft < 0)
+			winding--;
+	}
+
+	/* The arc and its chord form a closed loop around the circular segment. A point inside of the segment
+	 * is inside of the circle and on the same side of the chord as the arc. For an arc traversed CCW, this is to the right
+	 */
+	for(size_t i = 0; i < p_arcDirection.size(); i++)
+	{
+		double centerDistanceX = x - p_arcCenterX[i];
+		double centerDistanceY = y - p_arcCenterY[i];
+
+		if(centerDistanceX * centerDistanceX + centerDistanceY * centerDistanceY < p_arcRadiusSquared[i])
+		{
+			double side = p_arcDirection[i] * (p_arcChordX[i] * (y - p_arcStartY[i]) - (x - p_arcStartX[i]) * p_arcChordY[i]);
+
+			if(side < 0)
+				winding += (int)p_arcDirection[i];
+		}
+	}
+
+	return winding;
+}
+
+
+
+void compactPolygon::windingNumbers(const double *x, const double *y, size_t count, int *winding) const
+{
+	size_t i = 0;
+
+	if(p_vertexX.empty())
+	{
+		for(; i < count; i++)
+			winding[i] = 0;
+
+		return;
+	}
+
+	/* The kernels below are the same as scalarWindingNumber except that a group of points is tested against each edge
+	 * at once. The winding numbers are accumulated as doubles using the masks from the comparisons
+	 */
+#if defined(__AVX__)
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d one = _mm256_set1_pd(1.0);
+
+	for(; i + 4 <= count; i += 4)
+	{
+		__m256d pointX = _mm256_loadu_pd(x + i);
+		__m256d pointY = _mm256_loadu_pd(y + i);
+		__m256d windingSum = zero;
+		double result[4];
+
+		for(size_t j = 0; j < p_vertexX.size() - 1; j++)
+		{
+			__m256d startX = _mm256_set1_pd(p_vertexX[j]);
+			__m256d startY = _mm256_set1_pd(p_vertexY[j]);
+			__m256d endY = _mm256_set1_pd(p_vertexY[j + 1]);
+			__m256d isLeft = _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(p_vertexX[j + 1] - p_vertexX[j]), _mm256_sub_pd(pointY, startY)),
+											_mm256_mul_pd(_mm256_sub_pd(pointX, startX), _mm256_set1_pd(p_vertexY[j + 1] - p_vertexY[j])));
+
+			__m256d upward = _mm256_and_pd(_mm256_cmp_pd(startY, pointY, _CMP_LE_OQ), _mm256_cmp_pd(endY, pointY, _CMP_GT_OQ));
+			__m256d downward = _mm256_and_pd(_mm256_cmp_pd(startY, pointY, _CMP_GT_OQ), _mm256_cmp_pd(endY, pointY, _CMP_LE_OQ));
+
+			upward = _mm256_and_pd(upward, _mm256_cmp_pd(isLeft, zero, _CMP_GT_OQ));
+			downward = _mm256_and_pd(downward, _mm256_cmp_pd(isLeft, zero, _CMP_LT_OQ));
+
+			windingSum = _mm256_add_pd(windingSum, _mm256_and_pd(upward, one));
+			windingSum = _mm256_sub_pd(windingSum, _mm256_and_pd(downward, one));
+		}
+
+		for(size_t j = 0; j < p_arcDirection.size(); j++)
+		{
+			__m256d centerDistanceX = _mm256_sub_pd(pointX, _mm256_set1_pd(p_arcCenterX[j]));
+			__m256d centerDistanceY = _mm256_sub_pd(pointY, _mm256_set1_pd(p_arcCenterY[j]));
+			__m256d distanceSquared = _mm256_add_pd(_mm256_mul_pd(centerDistanceX, centerDistanceX), _mm256_mul_pd(centerDistanceY, centerDistanceY));
+			__m256d direction = _mm256_set1_pd(p_arcDirection[j]);
+			__m256d side = _mm256_mul_pd(direction, _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(p_arcChordX[j]), _mm256_sub_pd(pointY, _mm256_set1_pd(p_arcStartY[j]))),
+																	_mm256_mul_pd(_mm256_sub_pd(pointX, _mm256_set1_pd(p_arcStartX[j])), _mm256_set1_pd(p_arcChordY[j]))));
+			__m256d inSegment = _mm256_and_pd(_mm256_cmp_pd(distanceSquared, _mm256_set1_pd(p_arcRadiusSquared[j]), _CMP_LT_OQ), _mm256_cmp_pd(side, zero, _CMP_LT_OQ));
+
+			windingSum = _mm256_add_pd(windingSum, _mm256_and_pd(inSegment, direction));
+		}
+
+		_mm256_storeu_pd(result, windingSum);
+
+		for(int k = 0; k < 4; k++)
+			winding[i + k] = (int)result[k];
+	}
+#elif defined(__SSE2__)
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d one = _mm_set1_pd(1.0);
+
+	for(; i + 2 <= count; i += 2)
+	{
+		__m128d pointX = _mm_loadu_pd(x + i);
+		__m128d pointY = _mm_loadu_pd(y + i);
+		__m128d windingSum = zero;
+		double result[2];
+
+		for(size_t j = 0; j < p_vertexX.size() - 1; j++)
+		{
+			__m128d startX = _mm_set1_pd(p_vertexX[j]);
+			__m128d startY = _mm_set1_pd(p_vertexY[j]);
+			__m128d endY = _mm_set1_pd(p_vertexY[j + 1]);
+			__m128d isLeft = _mm_sub_pd(_mm_mul_pd(_mm_set1_pd(p_vertexX[j + 1] - p_vertexX[j]), _mm_sub_pd(pointY, startY)),
+										_mm_mul_pd(_mm_sub_pd(pointX, startX), _mm_set1_pd(p_vertexY[j + 1] - p_vertexY[j])));
+
+			__m128d upward = _mm_and_pd(_mm_cmple_pd(startY, pointY), _mm_cmpgt_pd(endY, pointY));
+			__m128d downward = _mm_and_pd(_mm_cmpgt_pd(startY, pointY), _mm_cmple_pd(endY, pointY));
+
+			upward = _mm_and_pd(upward, _mm_cmpgt_pd(isLeft, zero));
+			downward = _mm_and_pd(downward, _mm_cmplt_pd(isLeft, zero));
+
+			windingSum = _mm_add_pd(windingSum, _mm_and_pd(upward, one));
+			windingSum = _mm_sub_pd(windingSum, _mm_and_pd(downward, one));
+		}
+
+		for(size_t j = 0; j < p_arcDirection.size(); j++)
+		{
+			__m128d centerDistanceX = _mm_sub_pd(pointX, _mm_set1_pd(p_arcCenterX[j]));
+			__m128d centerDistanceY = _mm_sub_pd(pointY, _mm_set1_pd(p_arcCenterY[j]));
+			__m128d distanceSquared = _mm_add_pd(_mm_mul_pd(centerDistanceX, centerDistanceX), _mm_mul_pd(centerDistanceY, centerDistanceY));
+			__m128d direction = _mm_set1_pd(p_arcDirection[j]);
+			__m128d side = _mm_mul_pd(direction, _mm_sub_pd(_mm_mul_pd(_mm_set1_pd(p_arcChordX[j]), _mm_sub_pd(pointY, _mm_set1_pd(p_arcStartY[j]))),
+															_mm_mul_pd(_mm_sub_pd(pointX, _mm_set1_pd(p_arcStartX[j])), _mm_set1_pd(p_arcChordY[j]))));
+			__m128d inSegment = _mm_and_pd(_mm_cmplt_pd(distanceSquared, _mm_set1_pd(p_arcRadiusSquared[j])), _mm_cmplt_pd(side, zero));
+
+			windingSum = _mm_add_pd(windingSum, _mm_and_pd(inSegment, direction));
+		}
+
+		_mm_storeu_pd(result, windingSum);
+
+		winding[i] = (int)result[0];
+		winding[i + 1] = (int)result[1];
+	}
+#endif
+
+	// Any points that are left over are tested one at a time
+	for(; i < count; i++)
+		winding[i] = scalarWindingNumber(x[i], y[i]);
+}
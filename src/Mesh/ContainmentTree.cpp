@@ -0,0 +1,221 @@
+#include <Mesh/ContainmentTree.h>
+
+
+
+template<class boxType>
+void containmentTree::sortTiles(std::vector<boxType> &boxes, size_t first, size_t last)
+{
+	size_t numberOfBoxes = last - first;
+	size_t numberOfNodes = (numberOfBoxes + p_nodeCapacity - 1) / p_nodeCapacity;
+	size_t numberOfSlices = (size_t)ceil(sqrt((double)numberOfNodes));
+	size_t sliceSize = numberOfSlices * p_nodeCapacity;
+
+	std::sort(boxes.begin() + first, boxes.begin() + last, [](const boxType &firstBox, const boxType &secondBox)
+	{
+		return (firstBox.minX + firstBox.maxX) < (secondBox.minX + secondBox.maxX);
+	});
+
+	for(size_t sliceStart = first; sliceStart < last; sliceStart += sliceSize)
+	{
+		size_t sliceEnd = std::min(sliceStart + sliceSize, last);
+
+		std::sort(boxes.begin() + sliceStart, boxes.begin() + sliceEnd, [](const boxType &firstBox, const boxType &secondBox)
+		{
+			return (firstBox.minY + firstBox.maxY) < (secondBox.minY + secondBox.maxY);
+		});
+	}
+}
+
+
+
+template<class boxType>
+void containmentTree::addParentNodes(std::vector<boxType> &boxes, size_t first, size_t last, bool isLeaf)
+{
+	for(size_t groupStart = first; groupStart < last; groupStart += p_nodeCapacity)
+	{
+		size_t groupEnd = std::min(groupStart + p_nodeCapacity, last);
+		treeNode newNode;
+
+		newNode.minX = boxes[groupStart].minX;
+		newNode.minY = boxes[groupStart].minY;
+		newNode.maxX = boxes[groupStart].maxX;
+		newNode.maxY = boxes[groupStart].maxY;
+
+		for(size_t i = groupStart + 1; i < groupEnd; i++)
+		{
+			newNode.minX = std::min(newNode.minX, boxes[i].minX);
+			newNode.minY = std::min(newNode.minY, boxes[i].minY);
+			newNode.maxX = std::max(newNode.maxX, boxes[i].maxX);
+			newNode.maxY = std::max(newNode.maxY, boxes[i].maxY);
+		}
+
+		newNode.firstChild = groupStart;
+		newNode.numberOfChildren = groupEnd - groupStart;
+		newNode.isLeaf = isLeaf;
+
+		p_treeNodes.push_back(newNode);
+	}
+}
+
+
+
+void containmentTree::queryContaining(double minX, double minY, double maxX, double maxY, std::vector<size_t> &results)
+{
+	std::vector<size_t> nodeStack;
+
+	if(p_treeNodes.size() == 0)
+		return;
+
+	nodeStack.push_back(p_treeNodes.size() - 1);
+
+	/* Since the box of a node encloses all of its children, if the box of the node does not contain
+	 * the query box, then none of the children can contain it either
+	 */
+	while(!nodeStack.empty())
+	{
+		treeNode &currentNode = p_treeNodes[nodeStack.back()];
+		nodeStack.pop_back();
+
+		if(currentNode.minX > minX || currentNode.minY > minY || currentNode.maxX < maxX || currentNode.maxY < maxY)
+			continue;
+
+		for(size_t i = currentNode.firstChild; i < currentNode.firstChild + currentNode.numberOfChildren; i++)
+		{
+			if(currentNode.isLeaf)
+			{
+				entry &pathEntry = p_entries[i];
+
+				if(pathEntry.minX <= minX && pathEntry.minY <= minY && pathEntry.maxX >= maxX && pathEntry.maxY >= maxY)
+					results.push_back(pathEntry.index);
+			}
+			else
+				nodeStack.push_back(i);
+		}
+	}
+}
+
+
+
+void containmentTree::build(std::vector<closedPath> &paths)
+{
+	p_paths = &paths;
+
+	p_entries.clear();
+	p_treeNodes.clear();
+	p_parents.assign(paths.size(), -1);
+	p_children.assign(paths.size(), std::vector<size_t>());
+
+	if(paths.size() == 0)
+		return;
+
+	p_entries.reserve(paths.size());
+
+	for(size_t i = 0; i < paths.size(); i++)
+	{
+		boundingBox pathBox = paths[i].getBoundingBox();
+		entry pathEntry;
+
+		pathEntry.minX = pathBox.getMinBounds().x;
+		pathEntry.minY = pathBox.getMinBounds().y;
+		pathEntry.maxX = pathBox.getMaxBounds().x;
+		pathEntry.maxY = pathBox.getMaxBounds().y;
+		pathEntry.index = i;
+
+		p_entries.push_back(pathEntry);
+	}
+
+	// The tree is packed from the bottom up. Each level is appended to the list of tree nodes so the root ends up last
+	sortTiles(p_entries, 0, p_entries.size());
+	addParentNodes(p_entries, 0, p_entries.size(), true);
+
+	size_t levelStart = 0;
+
+	while(p_treeNodes.size() - levelStart > 1)
+	{
+		size_t levelEnd = p_treeNodes.size();
+
+		sortTiles(p_treeNodes, levelStart, levelEnd);
+		addParentNodes(p_treeNodes, levelStart, levelEnd, false);
+
+		levelStart = levelEnd;
+	}
+
+	/* The paths that contain a path are nested inside of each other. By testing the candidates from the smallest area
+	 * to the largest, the first path that contains the path is the parent
+	 */
+	for(size_t i = 0; i < paths.size(); i++)
+	{
+		boundingBox pathBox = paths[i].getBoundingBox();
+
+		p_candidates.clear();
+		queryContaining(pathBox.getMinBounds().x, pathBox.getMinBounds().y, pathBox.getMaxBounds().x, pathBox.getMaxBounds().y, p_candidates);
+
+		p_candidates.erase(std::remove_if(p_candidates.begin(), p_candidates.end(), [&paths, i](size_t candidate)
+		{
+			return (candidate == i || paths[candidate].getArea() <= paths[i].getArea());
+		}), p_candidates.end());
+
+		sortByArea(p_candidates);
+
+		for(std::vector<size_t>::iterator candidateIterator = p_candidates.begin(); candidateIterator != p_candidates.end(); ++candidateIterator)
+		{
+			if(paths[i].isInside(paths[*candidateIterator]))
+			{
+				p_parents[i] = (long)*candidateIterator;
+				p_children[*candidateIterator].push_back(i);
+				break;
+			}
+		}
+	}
+}
+
+
+
+void containmentTree::findPaths(std::vector<wxRealPoint> &points, std::vector<long> &pathIndices)
+{
+	std::vector<std::vector<size_t>> pointsOfPath;
+	std::vector<wxRealPoint> pathPoints;
+	std::vector<bool> isInside;
+
+	pathIndices.assign(points.size(), -1);
+
+	if(!p_paths)
+		return;
+
+	std::vector<closedPath> &paths = *p_paths;
+
+	pointsOfPath.resize(paths.size());
+
+	for(size_t i = 0; i < points.size(); i++)
+	{
+		p_candidates.clear();
+		queryContaining(points[i].x, points[i].y, points[i].x, points[i].y, p_candidates);
+
+		for(std::vector<size_t>::iterator candidateIterator = p_candidates.begin(); candidateIterator != p_candidates.end(); ++candidateIterator)
+			pointsOfPath[*candidateIterator].push_back(i);
+	}
+
+	/* Each path tests all of the points inside of its bounding box in one call so that the points are tested in groups.
+	 * A point can be inside of several nested paths and the one with the smallest area is the face that the point is in
+	 */
+	for(size_t i = 0; i < paths.size(); i++)
+	{
+		if(pointsOfPath[i].empty())
+			continue;
+
+		pathPoints.clear();
+
+		for(std::vector<size_t>::iterator pointIterator = pointsOfPath[i].begin(); pointIterator != pointsOfPath[i].end(); ++pointIterator)
+			pathPoints.push_back(points[*pointIterator]);
+
+		paths[i].pointsInContour(pathPoints, isInside);
+
+		for(size_t j = 0; j < pathPoints.size(); j++)
+		{
+			long &foundPath = pathIndices[pointsOfPath[i][j]];
+
+			if(isInside[j] && (foundPath < 0 || paths[i].getArea() < paths[foundPath].getArea()))
+				foundPath = (long)i;
+		}
+	}
+}
@@ -716,4 +716,4 @@ MElement *backgroundMesh::getMeshElementByCoord(double u, double v, double w, bo
   return _octree->find(u,v,w, 2, strict);
 }
 
-backgroundMesh* backgroundMesh::_current = 0;
+thread_local backgroundMesh* backgroundMesh::_current = 0;
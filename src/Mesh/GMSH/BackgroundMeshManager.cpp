@@ -12,11 +12,13 @@
 //#include "Mesh/GMSH/BackgroundMesh3D.h"
 
 map<GEntity*,BGMBase*> BGMManager::data = map<GEntity*,BGMBase*>();
-BGMBase* BGMManager::latest2Dbgm = NULL;
+thread_local BGMBase* BGMManager::latest2Dbgm = NULL;
+std::mutex BGMManager::dataMutex;
 bool BGMManager::use_cross_field = true;
 
 void BGMManager::set_use_cross_field(bool b)
 {
+  std::lock_guard<std::mutex> lock(dataMutex);
   if (b && (BGMManager::use_cross_field==false)){// need to change...
     data.clear();
   }
@@ -45,18 +47,26 @@ BGMBase* BGMManager::get(GRegion* gf)
 
 BGMBase* BGMManager::get(GFace* gf)
 {
-  map<GEntity*,BGMBase*>::iterator itfind = data.find(gf);
-  if (itfind!=data.end()){
-    latest2Dbgm = itfind->second;
-    return itfind->second;
+  {
+    std::lock_guard<std::mutex> lock(dataMutex);
+    map<GEntity*,BGMBase*>::iterator itfind = data.find(gf);
+    if (itfind!=data.end()){
+      latest2Dbgm = itfind->second;
+      return itfind->second;
+    }
   }
 
+  // a face is only meshed by one thread, so the background mesh can be built
+  // outside of the lock
   BGMBase *bgm;
   if (use_cross_field)
     bgm = new frameFieldBackgroundMesh2D(gf);
   else
     bgm = new backgroundMesh2D(gf);
-  data.insert(make_pair(gf,bgm));
+  {
+    std::lock_guard<std::mutex> lock(dataMutex);
+    data.insert(make_pair(gf,bgm));
+  }
   latest2Dbgm = bgm;
   return bgm;
 }
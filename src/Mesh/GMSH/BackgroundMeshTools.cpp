@@ -284,7 +284,7 @@ double BGM_MeshSize(GEntity *ge, double U, double V,
   double l5 = ge->getMeshSize();
 
   // take the minimum, then constrain by lcMin and lcMax
-  double lc = std::min(std::min(std::min(std::min(l1, l2), l3), l4), l5);
+  double lc = std::min(std::min(std::min(l1, l2), l3), l5);
   lc = std::max(lc, CTX::instance()->mesh.lcMin);
   lc = std::min(lc, CTX::instance()->mesh.lcMax);
 
@@ -296,7 +296,14 @@ double BGM_MeshSize(GEntity *ge, double U, double V,
   
  // double meshSize = ge->meshAttributes.meshSize;
 
-  return (lc * CTX::instance()->mesh.lcFactor * ge->meshAttributes.meshSize);
+  lc *= CTX::instance()->mesh.lcFactor * ge->meshAttributes.meshSize;
+
+  // The background field is an absolute size (the adaptive refinement sets it
+  // from the error of the solution) so it is not scaled by the entity
+  if(l4 < MAX_LC)
+    lc = std::min(lc, std::max(l4, CTX::instance()->mesh.lcMin));
+
+  return lc;
 //	return lc * ge->meshAttributes.meshSize;
 	
 //	return lc * CTX::instance()->mesh.lcFactor;
@@ -12,8 +12,14 @@
 #include "Mesh/GMSH/CondNumBasis.h"
 #include "Mesh/GMSH/JacobianBasis.h"
 #include <map>
+#include <mutex>
 #include <cstddef>
 
+// the bases are created on demand while the faces are meshed concurrently; the
+// constructors of some bases ask the factory for other bases so the mutex is
+// recursive
+static std::recursive_mutex basisMutex;
+
 std::map<int, nodalBasis*> BasisFactory::fs;
 std::map<int, CondNumBasis*> BasisFactory::cs;
 std::map<FuncSpaceData, JacobianBasis*> BasisFactory::js;
@@ -22,6 +28,7 @@ std::map<FuncSpaceData, GradientBasis*> BasisFactory::gs;
 
 const nodalBasis* BasisFactory::getNodalBasis(int tag)
 {
+  std::lock_guard<std::recursive_mutex> lock(basisMutex);
   // If the Basis has already been built, return it.
   std::map<int, nodalBasis*>::const_iterator it = fs.find(tag);
   if (it != fs.end()) {
@@ -57,21 +64,17 @@ const nodalBasis* BasisFactory::getNodalBasis(int tag)
 
   std::pair<std::map<int, nodalBasis*>::const_iterator, bool> inserted;
 
-#if defined(_OPENMP)
-//  #pragma omp critical
-#endif
-    {
-      inserted = fs.insert(std::make_pair(tag, F));
+  inserted = fs.insert(std::make_pair(tag, F));
 
-      if (!inserted.second)
-        delete F;
-    }
+  if (!inserted.second)
+    delete F;
 
   return inserted.first->second;
 }
 
 const JacobianBasis* BasisFactory::getJacobianBasis(FuncSpaceData fsd)
 {
+  std::lock_guard<std::recursive_mutex> lock(basisMutex);
   FuncSpaceData data = fsd.getForNonSerendipitySpace();
 
   std::map<FuncSpaceData, JacobianBasis*>::const_iterator it = js.find(data);
@@ -103,6 +106,7 @@ const JacobianBasis* BasisFactory::getJacobianBasis(int tag)
 
 const CondNumBasis* BasisFactory::getCondNumBasis(int tag, int cnOrder)
 {
+  std::lock_guard<std::recursive_mutex> lock(basisMutex);
   std::map<int, CondNumBasis*>::const_iterator it = cs.find(tag);
   if (it != cs.end()) return it->second;
 
@@ -113,6 +117,7 @@ const CondNumBasis* BasisFactory::getCondNumBasis(int tag, int cnOrder)
 
 const GradientBasis* BasisFactory::getGradientBasis(FuncSpaceData data)
 {
+  std::lock_guard<std::recursive_mutex> lock(basisMutex);
   std::map<FuncSpaceData, GradientBasis*>::const_iterator it = gs.find(data);
   if (it != gs.end()) return it->second;
 
@@ -133,6 +138,7 @@ const GradientBasis* BasisFactory::getGradientBasis(int tag)
 
 const bezierBasis* BasisFactory::getBezierBasis(FuncSpaceData fsd)
 {
+  std::lock_guard<std::recursive_mutex> lock(basisMutex);
   FuncSpaceData data = fsd.getForPrimaryElement();
 
   std::map<FuncSpaceData, bezierBasis*>::const_iterator it = bs.find(data);
@@ -156,6 +162,7 @@ const bezierBasis* BasisFactory::getBezierBasis(int tag)
 
 void BasisFactory::clearAll()
 {
+  std::lock_guard<std::recursive_mutex> lock(basisMutex);
   std::map<int, nodalBasis*>::iterator itF = fs.begin();
   while (itF != fs.end()) {
     delete itF->second;
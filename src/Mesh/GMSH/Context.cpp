@@ -112,6 +112,7 @@ CTX::CTX()
   mesh.preserveNumberingMsh2 = 1;
   mesh.ignorePeriodicity= 1;
   mesh.lightLines = 2;
+  mesh.maxNumThreads2D = 0;
 }
 
 CTX::~CTX()
@@ -120,13 +121,27 @@ CTX::~CTX()
 }
 
 CTX *CTX::_instance = NULL;
+thread_local CTX *CTX::_threadInstance = NULL;
 
 CTX *CTX::instance()
 {
+  if(_threadInstance) return _threadInstance;
   if(!_instance) _instance = new CTX();
   return _instance;
 }
 
+void CTX::beginThreadCopy()
+{
+  if(!_instance) _instance = new CTX();
+  if(!_threadInstance) _threadInstance = new CTX(*_instance);
+}
+
+void CTX::endThreadCopy()
+{
+  delete _threadInstance;
+  _threadInstance = NULL;
+}
+
 /*
 unsigned int CTX::packColor(int R, int G, int B, int A)
 {
@@ -70,6 +70,7 @@ int GModel::_current = -1;
 GModel::GModel(std::string name)
   : _maxVertexNum(0), _maxElementNum(0),
     _checkPointedMaxVertexNum(0), _checkPointedMaxElementNum(0),
+    _frozenIndexAll(-1), _frozenNumVertices(0),
     _name(name), _visible(1), _octree(0), _geo_internals(0),
     _occ_internals(0), /*_acis_internals(0), _fm_internals(0),*/
     _factory(0), _fields(0), _currentMeshEntity(0),
@@ -254,6 +255,7 @@ void GModel::deleteMesh()
   for(viter it = firstVertex(); it != lastVertex();++it)
     (*it)->deleteMesh();
   destroyMeshCaches();
+  _frozenIndexAll = -1;
 }
 
 bool GModel::empty() const
@@ -1365,6 +1367,13 @@ void GModel::removeInvisibleElements()
 
 int GModel::indexMeshVertices(bool all, int singlePartition, bool renumber)
 {
+  if(_frozenIndexAll >= 0){
+    if(_frozenIndexAll == (all ? 1 : 0) && singlePartition <= 0 && renumber)
+      return _frozenNumVertices;
+    // a different numbering is asked for, so the frozen one is lost
+    _frozenIndexAll = -1;
+  }
+
   std::vector<GEntity*> entities;
   getEntities(entities);
 
@@ -1414,6 +1423,18 @@ int GModel::indexMeshVertices(bool all, int singlePartition, bool renumber)
   return numVertices;
 }
 
+void GModel::freezeMeshVertexIndex(bool all)
+{
+  _frozenIndexAll = -1;
+  _frozenNumVertices = indexMeshVertices(all);
+  _frozenIndexAll = all ? 1 : 0;
+}
+
+void GModel::unfreezeMeshVertexIndex()
+{
+  _frozenIndexAll = -1;
+}
+
 void GModel::scaleMesh(double factor)
 {
   std::vector<GEntity*> entities;
@@ -1478,6 +1499,7 @@ void GModel::storeChain(int dim,
 template<class T>
 static void _addElements(std::vector<T*> &dst, const std::vector<MElement*> &src)
 {
+  dst.reserve(dst.size() + src.size());
   for(unsigned int i = 0; i < src.size(); i++) dst.push_back((T*)src[i]);
 }
 
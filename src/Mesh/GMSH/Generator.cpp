@@ -5,6 +5,7 @@
 
 #include <stdlib.h>
 #include <stack>
+#include <atomic>
 //#include "GmshConfig.h"
 #include "Mesh/GMSH/Numeric.h"
 #include "Mesh/GMSH/Context.h"
@@ -440,6 +441,8 @@ static void Mesh2D(GModel *m)
   if(TooManyElements(m, 2)) return;
   OmniFEMMsg::instance()->MsgStatus("Meshing 2D...");
   double t1 = Cpu();
+  double w1 = TimeOfDay();
+  int numThreadsUsed = 1;
 
   for(GModel::fiter it = m->firstFace(); it != m->lastFace(); ++it)
     (*it)->meshStatistics.status = GFace::PENDING;
@@ -458,55 +461,71 @@ static void Mesh2D(GModel *m)
 	OmniFEMMsg::instance()->resetProgressBar(Status_Windows::MESH_STATUS_WINDOW, true);
 	
     int nIter = 0, nTot = m->getNumFaces();
+    int numThreads = CTX::instance()->mesh.maxNumThreads2D;
+#if defined(_OPENMP)
+    if(numThreads <= 0) numThreads = omp_get_max_threads();
+#else
+    numThreads = 1;
+#endif
+    numThreadsUsed = numThreads;
     while(1){
       int nPending = 0;
+      std::atomic<int> nDone(0);
       std::vector<GFace*> temp;
       temp.insert(temp.begin(), f.begin(), f.end());
-//#if defined(_OPENMP)
-//#pragma omp parallel for schedule (dynamic)
-//#endif
-      for(size_t K = 0 ; K < temp.size() ; K++){
-        if (temp[K]->meshStatistics.status == GFace::PENDING){
-          backgroundMesh::current()->unset();
-//	   meshGFace mesher(true);
-          temp[K]->mesh(true);
+      // the faces are independent, so they are meshed concurrently; each thread
+      // works on its own copy of the options and has its own background mesh
+#if defined(_OPENMP)
+#pragma omp parallel num_threads(numThreads) reduction(+:nPending)
+#endif
+      {
+        bool isMainThread = true;
+#if defined(_OPENMP)
+        isMainThread = (omp_get_thread_num() == 0);
+#endif
+        CTX::beginThreadCopy();
+#if defined(_OPENMP)
+#pragma omp for schedule (dynamic)
+#endif
+        for(size_t K = 0 ; K < temp.size() ; K++){
+          if (temp[K]->meshStatistics.status == GFace::PENDING){
+            backgroundMesh::unset();
+            temp[K]->mesh(true);
 #if defined(HAVE_BFGS)
-          if(CTX::instance()->mesh.optimizeLloyd){
-            if (temp[K]->geomType()==GEntity::CompoundSurface ||
-                temp[K]->geomType()==GEntity::Plane ||
-                temp[K]->geomType()==GEntity::RuledSurface) {
-              if (temp[K]->meshAttributes.method != MESH_TRANSFINITE &&
-                  !temp[K]->meshAttributes.extrude) {
-                smoothing smm(CTX::instance()->mesh.optimizeLloyd, 6);
-                //m->writeMSH("beforeLLoyd.msh");
-                smm.optimize_face(temp[K]);
-                int rec = ((CTX::instance()->mesh.recombineAll ||
-                            temp[K]->meshAttributes.recombine) &&
-                           !CTX::instance()->mesh.recombine3DAll);
-                //m->writeMSH("afterLLoyd.msh");
-                if (rec) recombineIntoQuads(temp[K]);
-                //m->writeMSH("afterRecombine.msh");
+            if(CTX::instance()->mesh.optimizeLloyd){
+              if (temp[K]->geomType()==GEntity::CompoundSurface ||
+                  temp[K]->geomType()==GEntity::Plane ||
+                  temp[K]->geomType()==GEntity::RuledSurface) {
+                if (temp[K]->meshAttributes.method != MESH_TRANSFINITE &&
+                    !temp[K]->meshAttributes.extrude) {
+                  smoothing smm(CTX::instance()->mesh.optimizeLloyd, 6);
+                  smm.optimize_face(temp[K]);
+                  int rec = ((CTX::instance()->mesh.recombineAll ||
+                              temp[K]->meshAttributes.recombine) &&
+                             !CTX::instance()->mesh.recombine3DAll);
+                  if (rec) recombineIntoQuads(temp[K]);
+                }
               }
             }
-          }
 #endif
-//#if defined(_OPENMP)
-//#pragma omp critical
-//#endif
-          {
             nPending++;
           }
+          nDone++;
+          // only the main thread is allowed to update the status window
+          if(!nIter && isMainThread)
+          {
+            unsigned int value = (unsigned int)(((double)nDone / (double)nTot) * 100);
+            OmniFEMMsg::instance()->setProgressBarValue(value, Status_Windows::MESH_STATUS_WINDOW, 1);
+          }
         }
-		if(!nIter)
-		{
-			unsigned int value = (unsigned int)(((double)nPending / (double)nTot) * 100);
-			OmniFEMMsg::instance()->setProgressBarValue(value, Status_Windows::MESH_STATUS_WINDOW, 1);
-			OmniFEMMsg::instance()->MsgStatus("Meshing 2D...");
-		}
+        backgroundMesh::unset();
+        CTX::endThreadCopy();
       }
-//#if defined(_OPENMP)
-//#pragma omp master
-//#endif
+      // messages from the other threads are held until the main thread can
+      // display them
+      OmniFEMMsg::instance()->flushMessages();
+      // compound surfaces are built from the other faces, so they are meshed
+      // afterwards by the main thread
       for(std::set<GFace*, GEntityLessThan>::iterator it = cf.begin();
           it != cf.end(); ++it){
         if ((*it)->meshStatistics.status == GFace::PENDING){
@@ -550,8 +569,10 @@ static void Mesh2D(GModel *m)
   // collapseSmallEdges(*m);
 
   double t2 = Cpu();
-  CTX::instance()->meshTimer[1] = t2 - t1;
-  OmniFEMMsg::instance()->MsgStatus("Done meshing 2D (" + std::to_string(CTX::instance()->meshTimer[1]) + " s)");
+  double w2 = TimeOfDay();
+  CTX::instance()->meshTimer[1] = w2 - w1;
+  OmniFEMMsg::instance()->MsgStatus("Done meshing 2D (" + std::to_string(CTX::instance()->meshTimer[1]) + " s wall, " + 
+									std::to_string(t2 - t1) + " s CPU, " + std::to_string(numThreadsUsed) + " thread(s))");
 
 	PrintMesh2dStatistics(m);
 }
@@ -3,6 +3,7 @@
 // See the LICENSE.txt file for license information. Please report all
 // bugs and problems to the public mailing list <gmsh@onelab.info>.
 
+#include <algorithm>
 #include "Mesh/GMSH/SBoundingBox3d.h"
 #include "Mesh/GMSH/MVertex.h"
 #include "Mesh/GMSH/HilbertCurve.h"
@@ -274,3 +275,111 @@ void SortHilbert (std::vector<MVertex*>& v)
   //HilbertSort h;
   h.Apply(v);
 }
+
+// Number of bits per coordinate of the grid the 2D Hilbert curve runs on
+static const int HILBERT_2D_BITS = 16;
+
+// Index of the cell (x, y) along the Hilbert curve
+static unsigned long long hilbertIndex2D(unsigned int x, unsigned int y)
+{
+  const unsigned int n = 1u << HILBERT_2D_BITS;
+  unsigned long long d = 0;
+  for (unsigned int s = n / 2; s > 0; s /= 2){
+    unsigned int rx = (x & s) > 0;
+    unsigned int ry = (y & s) > 0;
+    d += (unsigned long long)s * s * ((3 * rx) ^ ry);
+    // rotate the quadrant so that the curve enters it at the origin
+    if (ry == 0){
+      if (rx == 1){
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      unsigned int t = x;
+      x = y;
+      y = t;
+    }
+  }
+  return d;
+}
+
+struct hilbertKeyLess
+{
+  const std::vector<unsigned long long> &keys;
+  hilbertKeyLess(const std::vector<unsigned long long> &k) : keys(k) {}
+  bool operator () (int a, int b) const
+  {
+    if (keys[a] != keys[b]) return keys[a] < keys[b];
+    return a < b;
+  }
+};
+
+void SortHilbert2D(const std::vector<double> &x, const std::vector<double> &y,
+                   std::vector<int> &order)
+{
+  const int n = (int)x.size();
+  order.resize(n);
+  if (!n) return;
+
+  double xmin = x[0], xmax = x[0], ymin = y[0], ymax = y[0];
+  for (int i = 1; i < n; i++){
+    xmin = std::min(xmin, x[i]); xmax = std::max(xmax, x[i]);
+    ymin = std::min(ymin, y[i]); ymax = std::max(ymax, y[i]);
+  }
+  // same scale on both axes so that the curve is not stretched
+  const double size = std::max(xmax - xmin, ymax - ymin);
+  const double scale = size > 0 ? ((1u << HILBERT_2D_BITS) - 1) / size : 0;
+
+  std::vector<unsigned long long> keys(n);
+  for (int i = 0; i < n; i++)
+    keys[i] = hilbertIndex2D((unsigned int)((x[i] - xmin) * scale),
+                             (unsigned int)((y[i] - ymin) * scale));
+
+  // The rounds are drawn at random, with a fixed seed so that the mesh does
+  // not change from one run to the next. Taking them from the input order
+  // would make the first rounds a single patch of the boundary, for example.
+  for (int i = 0; i < n; i++) order[i] = i;
+  unsigned int seed = 12345u;
+  for (int i = n - 1; i > 0; i--){
+    seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+    std::swap(order[i], order[seed % (unsigned int)(i + 1)]);
+  }
+
+  // Last round is the last 7/8 of the points, the round before is 7/8 of the
+  // remaining points, and so on until there are too few points left
+  const int threshold = 64;
+  const double ratio = 0.125;
+  int end = n;
+  while (end > 0){
+    int begin = end >= threshold ? (int)(end * ratio) : 0;
+    std::sort(order.begin() + begin, order.begin() + end, hilbertKeyLess(keys));
+    end = begin;
+  }
+}
+
+void SortHilbert2D(std::vector<MVertex*> &v)
+{
+  std::vector<double> x(v.size()), y(v.size());
+  for (size_t i = 0; i < v.size(); i++){
+    x[i] = v[i]->x();
+    y[i] = v[i]->y();
+  }
+  std::vector<int> order;
+  SortHilbert2D(x, y, order);
+  std::vector<MVertex*> sorted(v.size());
+  for (size_t i = 0; i < v.size(); i++) sorted[i] = v[order[i]];
+  v.swap(sorted);
+}
+
+void SortHilbertParametric(std::vector<MVertex*> &v)
+{
+  std::vector<double> u(v.size()), w(v.size());
+  for (size_t i = 0; i < v.size(); i++){
+    v[i]->getParameter(0, u[i]);
+    v[i]->getParameter(1, w[i]);
+  }
+  std::vector<int> order;
+  SortHilbert2D(u, w, order);
+  std::vector<MVertex*> sorted(v.size());
+  for (size_t i = 0; i < v.size(); i++) sorted[i] = v[order[i]];
+  v.swap(sorted);
+}
@@ -41,22 +41,16 @@ double MElement::_isInsideTolerance = 1.e-6;
 
 MElement::MElement(int num, int part) : _visible(1)
 {
-//if defined(_OPENMP)
-//  #pragma omp critical
-//#endif
-  {
-    // we should make GModel a mandatory argument to the constructor
-    GModel *m = GModel::current();
-    if(num){
-      _num = num;
-      m->setMaxElementNumber(std::max(m->getMaxElementNumber(), _num));
-    }
-    else{
-      m->setMaxElementNumber(m->getMaxElementNumber() + 1);
-      _num = m->getMaxElementNumber();
-    }
-    _partition = (short)part;
+  // we should make GModel a mandatory argument to the constructor
+  GModel *m = GModel::current();
+  if(num){
+    _num = num;
+    m->raiseMaxElementNumber(_num);
+  }
+  else{
+    _num = m->newElementNumber();
   }
+  _partition = (short)part;
 }
 
 void MElement::setTolerance(const double tol)
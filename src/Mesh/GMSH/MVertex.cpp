@@ -29,42 +29,28 @@ double angle3Vertices(const MVertex *p1, const MVertex *p2, const MVertex *p3)
 MVertex::MVertex(double x, double y, double z, GEntity *ge, int num)
   : _visible(1), _order(1), _x(x), _y(y), _z(z), _ge(ge)
 {
-#if defined(_OPENMP)
-//#pragma omp critical
-#endif
-  {
-    // we should make GModel a mandatory argument to the constructor
-    GModel *m = GModel::current();
-    if(num){
-      _num = num;
-      m->setMaxVertexNumber(std::max(m->getMaxVertexNumber(), _num));
-    }
-    else{
-      m->setMaxVertexNumber(m->getMaxVertexNumber() + 1);
-      _num = m->getMaxVertexNumber();
-    }
-    _index = num;
+  // we should make GModel a mandatory argument to the constructor
+  GModel *m = GModel::current();
+  if(num){
+    _num = num;
+    m->raiseMaxVertexNumber(_num);
   }
+  else{
+    _num = m->newVertexNumber();
+  }
+  _index = num;
 }
 
 void MVertex::deleteLast()
 {
-  GModel *m = GModel::current();
-  if(_num == m->getMaxVertexNumber())
-    m->setMaxVertexNumber(m->getMaxVertexNumber() - 1);
+  GModel::current()->releaseVertexNumber(_num);
   delete this;
 }
 
 void MVertex::forceNum(int num)
 {
-#if defined(_OPENMP)
-//#pragma omp critical
-#endif
-  {
-    _num = num;
-    GModel::current()->setMaxVertexNumber
-      (std::max(GModel::current()->getMaxVertexNumber(), _num));
-  }
+  _num = num;
+  GModel::current()->raiseMaxVertexNumber(_num);
 }
 
 void MVertex::writeMSH(FILE *fp, bool binary, bool saveParametric, double scalingFactor)
@@ -7,11 +7,16 @@
 #include <stdio.h>
 #include <string.h>
 #include <complex>
+#include <algorithm>
 //#include "GmshConfig.h"
 #include "Mesh/GMSH/GmshMessage.h"
 #include "Mesh/GMSH/linearSystemCSR.h"
 #include "common/OS.h"
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 #define SWAP(a, b)  temp = (a); (a) = (b); (b) = temp;
 #define SWAPI(a, b) tempi = (a); (a) = (b); (b) = tempi;
 
@@ -130,6 +135,7 @@ void linearSystemCSR<double>::preAllocateEntries ()
   }
   _entriesPreAllocated = true;
   sorted = true;
+  _patternGeneration++;
   _sparsity.clear();
   // we do this after _sparsity.clear so that the peak memory usage is reduced
   CSRList_Resize_strict (_a, nnz);
@@ -173,6 +179,7 @@ void linearSystemCSR<std::complex<double> >::preAllocateEntries ()
   }
   _entriesPreAllocated = true;
   sorted = true;
+  _patternGeneration++;
   _sparsity.clear();
   // we do this after _sparsity.clear so that the peak memory usage is reduced
   CSRList_Resize_strict (_a, nnz);
@@ -185,6 +192,9 @@ void linearSystemCSR<std::complex<double> >::preAllocateEntries ()
 template<>
 void linearSystemCSR<double>::allocate(int nbRows)
 {
+  // the new arrays hold no entries yet, whatever the previous pattern was
+  _patternGeneration++;
+  _entriesPreAllocated = false;
   if(_a) {
     CSRList_Delete(_a);
     CSRList_Delete(_ai);
@@ -223,6 +233,9 @@ void linearSystemCSR<double>::allocate(int nbRows)
 template<>
 void linearSystemCSR<std::complex<double> >::allocate(int nbRows)
 {
+  // the new arrays hold no entries yet, whatever the previous pattern was
+  _patternGeneration++;
+  _entriesPreAllocated = false;
   if(_a) {
     CSRList_Delete(_a);
     CSRList_Delete(_ai);
@@ -418,9 +431,11 @@ void linearSystemCSR<double>::getMatrix(INDEX_TYPE*& jptr,INDEX_TYPE*& ai,double
   jptr = (INDEX_TYPE*) _jptr->array;
   ai = (INDEX_TYPE*) _ai->array;
   a = ( double * ) _a->array;
-  if (!sorted)
+  if (!sorted){
     sortColumns_(_b->size(), CSRList_Nbr(_a), (INDEX_TYPE *) _ptr->array, jptr,
                  ai, a);
+    _patternGeneration++;
+  }
   sorted = true;
 }
 
@@ -430,12 +445,486 @@ void linearSystemCSR<std::complex<double> >::getMatrix(INDEX_TYPE*& jptr,INDEX_T
   jptr = (INDEX_TYPE*) _jptr->array;
   ai = (INDEX_TYPE*) _ai->array;
   a = ( double  * ) _a->array;
-  if (!sorted)
+  if (!sorted){
     sortColumns_(_b->size(), CSRList_Nbr(_a), (INDEX_TYPE *) _ptr->array, jptr,
                  ai, (std::complex<double> *)a);
+    _patternGeneration++;
+  }
   sorted = true;
 }
 
+// Kernels of the built-in iterative solver. The loops are only threaded for
+// vectors that are long enough to pay for the parallel region.
+#define CSR_PARALLEL_THRESHOLD 4096
+
+static inline double conjugate(double v){ return v; }
+static inline std::complex<double> conjugate(const std::complex<double> &v)
+{
+  return std::conj(v);
+}
+
+// a pivot of IC(0) is unusable if it is not positive (real case) or zero
+// (complex symmetric case)
+static inline bool badPivot(double v){ return !(v > 0.); }
+static inline bool badPivot(const std::complex<double> &v)
+{
+  return std::abs(v) == 0.;
+}
+
+// sum of term(i) for i in [0, n); the partial sums of the threads are added
+// in a fixed order, so the result only depends on the number of threads
+template <class scalar, class TERM>
+static scalar parallelSum(int n, const TERM &term)
+{
+  std::vector<scalar> partial(1, scalar());
+#if defined(_OPENMP)
+  partial.assign(omp_get_max_threads(), scalar());
+#pragma omp parallel if(n > CSR_PARALLEL_THRESHOLD)
+  {
+    scalar local = scalar();
+#pragma omp for schedule(static)
+    for(int i = 0; i < n; i++) local += term(i);
+    partial[omp_get_thread_num()] = local;
+  }
+#else
+  for(int i = 0; i < n; i++) partial[0] += term(i);
+#endif
+  scalar sum = scalar();
+  for(unsigned int k = 0; k < partial.size(); k++) sum += partial[k];
+  return sum;
+}
+
+// x^T y, without conjugation
+template <class scalar>
+static scalar dotu(int n, const scalar *x, const scalar *y)
+{
+  return parallelSum<scalar>(n, [x, y](int i){ return x[i] * y[i]; });
+}
+
+// x^H y
+template <class scalar>
+static scalar dotc(int n, const scalar *x, const scalar *y)
+{
+  return parallelSum<scalar>(n, [x, y](int i){ return conjugate(x[i]) * y[i]; });
+}
+
+template <class scalar>
+static double norm2(int n, const scalar *x)
+{
+  return sqrt(parallelSum<double>
+              (n, [x](int i){ return std::norm(x[i]); }));
+}
+
+// y = A x
+template <class scalar>
+static void spmv(int n, const INDEX_TYPE *jptr, const INDEX_TYPE *ai,
+                 const scalar *a, const scalar *x, scalar *y)
+{
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(n > CSR_PARALLEL_THRESHOLD)
+#endif
+  for(int i = 0; i < n; i++){
+    scalar s = scalar();
+    for(INDEX_TYPE k = jptr[i]; k < jptr[i + 1]; k++) s += a[k] * x[ai[k]];
+    y[i] = s;
+  }
+}
+
+// y = x + alpha y
+template <class scalar>
+static void xpay(int n, const scalar *x, scalar alpha, scalar *y)
+{
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(n > CSR_PARALLEL_THRESHOLD)
+#endif
+  for(int i = 0; i < n; i++) y[i] = x[i] + alpha * y[i];
+}
+
+// y += alpha x
+template <class scalar>
+static void axpy(int n, scalar alpha, const scalar *x, scalar *y)
+{
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(n > CSR_PARALLEL_THRESHOLD)
+#endif
+  for(int i = 0; i < n; i++) y[i] += alpha * x[i];
+}
+
+// r = b - A x and returns |r| / normB
+template <class scalar>
+static double trueResidual(int n, const INDEX_TYPE *jptr, const INDEX_TYPE *ai,
+                           const scalar *a, const scalar *b, const scalar *x,
+                           scalar *r, double normB)
+{
+  spmv(n, jptr, ai, a, x, r);
+  for(int i = 0; i < n; i++) r[i] = b[i] - r[i];
+  return norm2(n, r) / normB;
+}
+
+template <class scalar>
+void linearSystemCSRIterative<scalar>::_getSortedMatrix
+(INDEX_TYPE *&jptr, INDEX_TYPE *&ai, scalar *&a)
+{
+  double *values;
+  this->getMatrix(jptr, ai, values);
+  a = (scalar*)values;
+}
+
+template <class scalar>
+bool linearSystemCSRIterative<scalar>::_setupPreconditioner
+(int n, const INDEX_TYPE *jptr, const INDEX_TYPE *ai, const scalar *a)
+{
+  _factor.clear();
+  _invDiag.clear();
+  _setupN = 0;
+  if(_preconditioner == NONE) return true;
+
+  // the diagonal positions only depend on the pattern
+  if((int)_diagPos.size() != n ||
+     _setupGeneration != this->getPatternGeneration()){
+    _diagPos.assign(n, -1);
+    for(int i = 0; i < n; i++){
+      for(INDEX_TYPE k = jptr[i]; k < jptr[i + 1]; k++){
+        if(ai[k] == i){
+          _diagPos[i] = k;
+          break;
+        }
+      }
+    }
+    _setupGeneration = this->getPatternGeneration();
+  }
+  _setupN = n;
+
+  if(_preconditioner == JACOBI){
+    _invDiag.resize(n);
+    for(int i = 0; i < n; i++){
+      scalar d = (_diagPos[i] < 0) ? scalar() : a[_diagPos[i]];
+      _invDiag[i] = (d == scalar()) ? scalar(1.) : scalar(1.) / d;
+    }
+    return true;
+  }
+
+  for(int i = 0; i < n; i++){
+    if(_diagPos[i] < 0){
+      Msg::Error("Row %d has no diagonal entry, the incomplete factorization "
+                 "is not possible", i);
+      return false;
+    }
+  }
+
+  const INDEX_TYPE nnz = jptr[n];
+  _factor.assign(a, a + nnz);
+  scalar *f = &_factor[0];
+
+  if(_preconditioner == ILU0){
+    // IKJ variant of ILU(0): L (unit diagonal) and U are stored in place
+    std::vector<INDEX_TYPE> position(n, -1);
+    for(int i = 0; i < n; i++){
+      for(INDEX_TYPE k = jptr[i]; k < jptr[i + 1]; k++) position[ai[k]] = k;
+      for(INDEX_TYPE k = jptr[i]; k < _diagPos[i]; k++){
+        const int col = ai[k];
+        f[k] /= f[_diagPos[col]];
+        for(INDEX_TYPE m = _diagPos[col] + 1; m < jptr[col + 1]; m++){
+          if(position[ai[m]] >= 0) f[position[ai[m]]] -= f[k] * f[m];
+        }
+      }
+      for(INDEX_TYPE k = jptr[i]; k < jptr[i + 1]; k++) position[ai[k]] = -1;
+      if(f[_diagPos[i]] == scalar()){
+        Msg::Error("Zero pivot in row %d of the ILU(0) factorization", i);
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // IC(0): L L^T with L on the lower triangle of the pattern. The sum over
+  // the common columns of rows i and j is a merge of two sorted rows
+  bool modified = false;
+  for(int i = 0; i < n; i++){
+    for(INDEX_TYPE k = jptr[i]; k <= _diagPos[i]; k++){
+      const int j = ai[k];
+      scalar s = a[k];
+      INDEX_TYPE p = jptr[i], q = jptr[j];
+      while(p < k && q < _diagPos[j]){
+        if(ai[p] < ai[q]) p++;
+        else if(ai[p] > ai[q]) q++;
+        else s -= f[p++] * f[q++];
+      }
+      if(j < i){
+        f[k] = s / f[_diagPos[j]];
+      }
+      else{
+        if(badPivot(s)){
+          // keep the factorization going with the magnitude of the diagonal
+          s = std::abs(a[k]) > 0. ? scalar(std::abs(a[k])) : scalar(1.);
+          modified = true;
+        }
+        f[k] = sqrt(s);
+      }
+    }
+  }
+  if(modified)
+    Msg::Warning("IC(0) broke down, some pivots were replaced by the diagonal; "
+                 "the matrix may not be symmetric positive definite");
+  return true;
+}
+
+template <class scalar>
+void linearSystemCSRIterative<scalar>::_applyPreconditioner
+(int n, const INDEX_TYPE *jptr, const INDEX_TYPE *ai, const scalar *r,
+ scalar *z) const
+{
+  if(_preconditioner == NONE){
+    std::copy(r, r + n, z);
+  }
+  else if(_preconditioner == JACOBI){
+    const scalar *d = &_invDiag[0];
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(n > CSR_PARALLEL_THRESHOLD)
+#endif
+    for(int i = 0; i < n; i++) z[i] = d[i] * r[i];
+  }
+  else if(_preconditioner == ILU0){
+    const scalar *f = &_factor[0];
+    for(int i = 0; i < n; i++){
+      scalar s = r[i];
+      for(INDEX_TYPE k = jptr[i]; k < _diagPos[i]; k++) s -= f[k] * z[ai[k]];
+      z[i] = s;
+    }
+    for(int i = n - 1; i >= 0; i--){
+      scalar s = z[i];
+      for(INDEX_TYPE k = _diagPos[i] + 1; k < jptr[i + 1]; k++)
+        s -= f[k] * z[ai[k]];
+      z[i] = s / f[_diagPos[i]];
+    }
+  }
+  else{
+    // L y = r by rows, then L^T z = y by columns of L^T (rows of L)
+    const scalar *f = &_factor[0];
+    for(int i = 0; i < n; i++){
+      scalar s = r[i];
+      for(INDEX_TYPE k = jptr[i]; k < _diagPos[i]; k++) s -= f[k] * z[ai[k]];
+      z[i] = s / f[_diagPos[i]];
+    }
+    for(int i = n - 1; i >= 0; i--){
+      z[i] /= f[_diagPos[i]];
+      for(INDEX_TYPE k = jptr[i]; k < _diagPos[i]; k++) z[ai[k]] -= f[k] * z[i];
+    }
+  }
+}
+
+template <class scalar>
+int linearSystemCSRIterative<scalar>::_solveCG
+(int n, const INDEX_TYPE *jptr, const INDEX_TYPE *ai, const scalar *a,
+ const scalar *b, scalar *x)
+{
+  std::vector<scalar> r(n), z(n), p(n), q(n);
+  const double normB = norm2(n, b);
+
+  _residual = trueResidual(n, jptr, ai, a, b, x, &r[0], normB);
+  if(_residual <= _prec) return 1;
+  double lastTrueResidual = _residual;
+
+  _applyPreconditioner(n, jptr, ai, &r[0], &z[0]);
+  p = z;
+  scalar rho = dotu(n, &r[0], &z[0]);
+
+  for(_iterations = 1; _iterations <= _maxIter; _iterations++){
+    spmv(n, jptr, ai, a, &p[0], &q[0]);
+    const scalar pq = dotu(n, &p[0], &q[0]);
+    if(pq == scalar()){
+      Msg::Error("CG broke down after %d iterations", _iterations);
+      return 0;
+    }
+    const scalar alpha = rho / pq;
+    axpy(n, alpha, &p[0], x);
+    axpy(n, -alpha, &q[0], &r[0]);
+
+    _residual = norm2(n, &r[0]) / normB;
+    if(_noisy) Msg::Info("CG iteration %d residual %g", _iterations, _residual);
+    if(_residual <= _prec){
+      // the recursively updated residual drifts away from the true one, so
+      // convergence is confirmed before stopping and CG restarts otherwise
+      _residual = trueResidual(n, jptr, ai, a, b, x, &r[0], normB);
+      if(_residual <= _prec) return 1;
+      // below the attainable accuracy the restarts stop making progress
+      if(_residual > 0.5 * lastTrueResidual){
+        Msg::Warning("CG stagnated at residual %g after %d iterations",
+                     _residual, _iterations);
+        return 0;
+      }
+      lastTrueResidual = _residual;
+      _applyPreconditioner(n, jptr, ai, &r[0], &z[0]);
+      p = z;
+      rho = dotu(n, &r[0], &z[0]);
+      continue;
+    }
+
+    _applyPreconditioner(n, jptr, ai, &r[0], &z[0]);
+    const scalar rhoNew = dotu(n, &r[0], &z[0]);
+    xpay(n, &z[0], rhoNew / rho, &p[0]);
+    rho = rhoNew;
+  }
+  _iterations = _maxIter;
+  return 0;
+}
+
+template <class scalar>
+int linearSystemCSRIterative<scalar>::_solveBiCGStab
+(int n, const INDEX_TYPE *jptr, const INDEX_TYPE *ai, const scalar *a,
+ const scalar *b, scalar *x)
+{
+  std::vector<scalar> r(n), rHat(n), p(n, scalar()), v(n, scalar()), s(n), t(n);
+  std::vector<scalar> pHat(n), sHat(n);
+  const double normB = norm2(n, b);
+
+  _residual = trueResidual(n, jptr, ai, a, b, x, &r[0], normB);
+  if(_residual <= _prec) return 1;
+
+  rHat = r;
+  scalar rho(1.), alpha(1.), omega(1.);
+  double lastTrueResidual = _residual;
+  bool stagnated = false;
+  // confirms convergence with the true residual; BiCGStab restarts from it
+  // if the recursively updated residual has drifted
+  auto converged = [&]() -> bool {
+    _residual = trueResidual(n, jptr, ai, a, b, x, &r[0], normB);
+    if(_residual <= _prec) return true;
+    if(_residual > 0.5 * lastTrueResidual){
+      stagnated = true;
+      return false;
+    }
+    lastTrueResidual = _residual;
+    rHat = r;
+    rho = alpha = omega = scalar(1.);
+    std::fill(p.begin(), p.end(), scalar());
+    std::fill(v.begin(), v.end(), scalar());
+    return false;
+  };
+
+  for(_iterations = 1; _iterations <= _maxIter; _iterations++){
+    const scalar rhoNew = dotc(n, &rHat[0], &r[0]);
+    if(rhoNew == scalar() || omega == scalar()){
+      Msg::Error("BiCGStab broke down after %d iterations", _iterations);
+      return 0;
+    }
+    const scalar beta = (rhoNew / rho) * (alpha / omega);
+    rho = rhoNew;
+    // p = r + beta (p - omega v)
+    axpy(n, -omega, &v[0], &p[0]);
+    xpay(n, &r[0], beta, &p[0]);
+
+    _applyPreconditioner(n, jptr, ai, &p[0], &pHat[0]);
+    spmv(n, jptr, ai, a, &pHat[0], &v[0]);
+    const scalar rv = dotc(n, &rHat[0], &v[0]);
+    if(rv == scalar()){
+      Msg::Error("BiCGStab broke down after %d iterations", _iterations);
+      return 0;
+    }
+    alpha = rho / rv;
+    s = r;
+    axpy(n, -alpha, &v[0], &s[0]);
+    axpy(n, alpha, &pHat[0], x);
+
+    _residual = norm2(n, &s[0]) / normB;
+    if(_residual <= _prec){
+      if(converged()) return 1;
+      if(stagnated) break;
+      continue;
+    }
+
+    _applyPreconditioner(n, jptr, ai, &s[0], &sHat[0]);
+    spmv(n, jptr, ai, a, &sHat[0], &t[0]);
+    const double tt = std::real(dotc(n, &t[0], &t[0]));
+    omega = (tt > 0.) ? dotc(n, &t[0], &s[0]) / tt : scalar();
+    axpy(n, omega, &sHat[0], x);
+    r = s;
+    axpy(n, -omega, &t[0], &r[0]);
+
+    _residual = norm2(n, &r[0]) / normB;
+    if(_noisy)
+      Msg::Info("BiCGStab iteration %d residual %g", _iterations, _residual);
+    if(_residual <= _prec && converged()) return 1;
+    if(stagnated) break;
+  }
+  if(stagnated){
+    Msg::Warning("BiCGStab stagnated at residual %g after %d iterations",
+                 _residual, _iterations);
+    return 0;
+  }
+  _iterations = _maxIter;
+  return 0;
+}
+
+template <class scalar>
+int linearSystemCSRIterative<scalar>::systemSolve()
+{
+  _iterations = 0;
+  _residual = 0.;
+  if(!this->_a || !this->_b || this->_b->empty()) return 1;
+
+  const int n = this->_b->size();
+  std::vector<scalar> &b = *this->_b;
+  std::vector<scalar> &x = *this->_x;
+
+  if(norm2(n, &b[0]) == 0.){
+    this->zeroSolution();
+    return 1;
+  }
+
+  INDEX_TYPE *jptr, *ai;
+  scalar *a;
+  _getSortedMatrix(jptr, ai, a);
+
+  double t1 = Cpu();
+  _preconditionerReused = _reusePreconditioner && _setupN == n &&
+    _setupGeneration == this->getPatternGeneration();
+  if(!_preconditionerReused && !_setupPreconditioner(n, jptr, ai, a)){
+    _setupN = 0;
+    return 0;
+  }
+  double t2 = Cpu();
+
+  int converged = (_method == CG) ?
+    _solveCG(n, jptr, ai, a, &b[0], &x[0]) :
+    _solveBiCGStab(n, jptr, ai, a, &b[0], &x[0]);
+  double t3 = Cpu();
+
+  const char *name = (_method == CG) ? "CG" : "BiCGStab";
+  if(converged)
+    Msg::Debug("%s has solved %d unknowns in %d iterations (setup %g s, "
+               "solve %g s)", name, n, _iterations, t2 - t1, t3 - t2);
+  else
+    Msg::Warning("%s did not converge on %d unknowns: relative residual %g "
+                 "after %d iterations", name, n, _residual, _iterations);
+  return converged;
+}
+
+template <class scalar>
+double linearSystemCSRIterative<scalar>::normResidual()
+{
+  if(!this->_a || !this->_b || this->_b->empty()) return 0.;
+
+  const int n = this->_b->size();
+  INDEX_TYPE *jptr, *ai;
+  scalar *a;
+  _getSortedMatrix(jptr, ai, a);
+
+  std::vector<scalar> r(n);
+  return trueResidual(n, jptr, ai, a, &(*this->_b)[0], &(*this->_x)[0],
+                      &r[0], 1.);
+}
+
+template <class scalar>
+double linearSystemCSRIterative<scalar>::norm2RightHandSide() const
+{
+  if(!this->_b || this->_b->empty()) return 0.;
+  return norm2((int)this->_b->size(), &(*this->_b)[0]);
+}
+
+template class linearSystemCSRIterative<double>;
+template class linearSystemCSRIterative<std::complex<double> >;
+
 #if defined(HAVE_GMM)
 
 #include "gmm.h"
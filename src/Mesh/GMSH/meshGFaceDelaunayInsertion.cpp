@@ -28,11 +28,106 @@
 #include "Mesh/GMSH/intersectCurveSurface.h"
 #include "Mesh/GMSH/HilbertCurve.h"
 
-static double LIMIT_ = 0.5 * sqrt(2.0) * 1;
-static int  N_GLOBAL_SEARCH;
-static int  N_SEARCH;
-static double DT_INSERT_VERTEX;
-int MTri3::radiusNorm = 2;
+// these are per thread since the faces are meshed concurrently
+static thread_local double LIMIT_ = 0.5 * sqrt(2.0) * 1;
+static thread_local int  N_GLOBAL_SEARCH;
+static thread_local int  N_SEARCH;
+static thread_local double DT_INSERT_VERTEX;
+thread_local int MTri3::radiusNorm = 2;
+
+// Pool of fixed size blocks for the MTri3. The blocks are carved out of large
+// chunks and recycled through a free list, the chunks are given back when the
+// thread ends. Since a face is meshed by a single thread, a MTri3 is always
+// deleted by the thread that created it.
+class MTri3Pool
+{
+ private:
+  struct freeBlock { freeBlock *next; };
+  std::vector<char*> _chunks;
+  freeBlock *_free;
+  static const std::size_t _blockSize =
+    sizeof(MTri3) > sizeof(freeBlock) ? sizeof(MTri3) : sizeof(freeBlock);
+  static const std::size_t _blocksPerChunk = 4096;
+  void grow()
+  {
+    char *chunk = new char[_blocksPerChunk * _blockSize];
+    _chunks.push_back(chunk);
+    for (std::size_t i = _blocksPerChunk; i > 0; i--)
+      release(chunk + (i - 1) * _blockSize);
+  }
+ public:
+  MTri3Pool() : _free(0) {}
+  ~MTri3Pool()
+  {
+    for (unsigned int i = 0; i < _chunks.size(); i++) delete [] _chunks[i];
+  }
+  inline void *allocate()
+  {
+    if (!_free) grow();
+    freeBlock *b = _free;
+    _free = b->next;
+    return b;
+  }
+  inline void release(void *p)
+  {
+    freeBlock *b = static_cast<freeBlock*>(p);
+    b->next = _free;
+    _free = b;
+  }
+};
+
+static thread_local MTri3Pool MTRI3_POOL;
+
+void *MTri3::operator new(std::size_t size)
+{
+  if (size != sizeof(MTri3)) return ::operator new(size);
+  return MTRI3_POOL.allocate();
+}
+
+void MTri3::operator delete(void *p, std::size_t size)
+{
+  if (!p) return;
+  if (size != sizeof(MTri3)) ::operator delete(p);
+  else MTRI3_POOL.release(p);
+}
+
+// The MTriangle created during the insertion either end up in the GFace,
+// which deletes them with the mesh, or die in a cavity. The storage of the
+// ones that die is reused for the next MTriangle created by the thread and is
+// given back to the heap when the face is done.
+static thread_local std::vector<void*> SPARE_TRIANGLES;
+
+static MTriangle *newTriangle(MVertex *v0, MVertex *v1, MVertex *v2)
+{
+  if (SPARE_TRIANGLES.empty()) return new MTriangle(v0, v1, v2);
+  void *p = SPARE_TRIANGLES.back();
+  SPARE_TRIANGLES.pop_back();
+  return new (p) MTriangle(v0, v1, v2);
+}
+
+static void deleteTriangle(MTriangle *t)
+{
+  if (t->getTypeForMSH() != MSH_TRI_3){
+    delete t;
+    return;
+  }
+  t->~MTriangle();
+  SPARE_TRIANGLES.push_back(t);
+}
+
+static void releaseSpareTriangles()
+{
+  for (unsigned int i = 0; i < SPARE_TRIANGLES.size(); i++)
+    ::operator delete(SPARE_TRIANGLES[i]);
+  std::vector<void*>().swap(SPARE_TRIANGLES);
+}
+
+// Scratch buffers for the cavities, reused from one insertion to the next
+static thread_local std::vector<edgeXface> SHELL;
+static thread_local std::vector<MTri3*> CAVITY;
+static thread_local std::vector<MTri3*> NEW_CAVITY;
+static thread_local std::vector<MTri3*> NEW_TRIS;
+static thread_local std::vector<edgeXface> CONN;
 
 template <class ITERATOR>
 void _printTris(char *name, ITERATOR it,  ITERATOR end, bidimMeshData * data)
@@ -300,7 +395,7 @@ int inCircumCircleAniso(GFace *gf, MTriangle *base,
 }
 
 MTri3::MTri3(MTriangle *t, double lc, SMetric3 *metric, bidimMeshData * data, GFace *gf)
-  : deleted(false), base(t)
+  : deleted(false), queued(false), base(t)
 {
   neigh[0] = neigh[1] = neigh[2] = 0;
   double center[3];
@@ -481,8 +576,8 @@ int inCircumCircleXY(MTriangle *t, MVertex *v)
 }
 
 
-void recurFindCavityTangentPlane(std::list<edgeXface> &shell,
-				 std::list<MTri3*> &cavity,
+void recurFindCavityTangentPlane(std::vector<edgeXface> &shell,
+				 std::vector<MTri3*> &cavity,
 				 MTri3 *t,
 				 SPoint3 &p, SVector3 &t1, SVector3 &t2)
 {
@@ -520,8 +615,8 @@ static void computeTangentPlane (GFace *gf, double center[2], SPoint3 &p, SVecto
 }
 
 bool findCavityTangentPlane(GFace *gf, double *center,
-			    std::list<edgeXface> &shell,
-			    std::list<MTri3*> &cavity,
+			    std::vector<edgeXface> &shell,
+			    std::vector<MTri3*> &cavity,
 			    MTri3 *t)
 {
   return false;
@@ -533,7 +628,7 @@ bool findCavityTangentPlane(GFace *gf, double *center,
   recurFindCavityTangentPlane(shell, cavity, t, p, t1, t2);
   //  double AMIN = 1;
   double DMAX = 0.0;
-  for (std::list<MTri3*>::iterator i=cavity.begin();i!=cavity.end();i++){
+  for (std::vector<MTri3*>::iterator i=cavity.begin();i!=cavity.end();i++){
     t = *i;
     SPoint3 b = t->tri()->getFace(0).barycenter();
     //    SVector3 n = t->tri()->getFace(0).normal();
@@ -545,7 +640,7 @@ bool findCavityTangentPlane(GFace *gf, double *center,
   }
   if (DMAX > 30 || cavity.size() < 2){
     //printf("%d elements in the cavity DMAX %g\n",cavity.size(),DMAX);
-    for (std::list<MTri3*>::iterator i=cavity.begin();i!=cavity.end();i++){
+    for (std::vector<MTri3*>::iterator i=cavity.begin();i!=cavity.end();i++){
       t = *i;
       t->setDeleted(false);
     }
@@ -579,7 +674,7 @@ void recurFindCavity(std::vector<edgeXface> &shell, std::vector<MTri3*> &cavity,
   }
 }
 
-void recurFindCavity(std::list<edgeXface> &shell, std::list<MTri3*> &cavity,
+void recurFindCavity(std::vector<edgeXface> &shell, std::vector<MTri3*> &cavity,
                      double *v, double *param, MTri3 *t,  bidimMeshData & data)
 {
   t->setDeleted(true);
@@ -602,7 +697,7 @@ void recurFindCavity(std::list<edgeXface> &shell, std::list<MTri3*> &cavity,
 }
 
 void recurFindCavityAniso(GFace *gf,
-                          std::list<edgeXface> &shell, std::list<MTri3*> &cavity,
+                          std::vector<edgeXface> &shell, std::vector<MTri3*> &cavity,
                           double *metric, double *param,  MTri3 *t, bidimMeshData & data)
 {
   t->setDeleted(true);
@@ -695,11 +790,67 @@ inline double getSurfUV(MTriangle *t, bidimMeshData & data)
   return s * 0.5;
 }
 
-bool insertVertexB (std::list<edgeXface> &shell,
-		    std::list<MTri3*> &cavity,
+// Adds the new triangles of a cavity to the container of all the triangles
+template <class CONTAINER, class ITER>
+static inline void addTriangles(CONTAINER &allTets, ITER beg, ITER end)
+{
+  allTets.insert(beg, end);
+}
+
+template <class ITER>
+static inline void addTriangles(std::vector<MTri3*> &allTets, ITER beg, ITER end)
+{
+  allTets.insert(allTets.end(), beg, end);
+}
+
+// Adds a triangle to the active triangles, once
+static inline void addActive(std::set<MTri3*, compareTri3Ptr> &activeTets, MTri3 *t)
+{
+  if (activeTets.find(t) == activeTets.end())
+    activeTets.insert(t);
+}
+
+static inline void addActive(MTri3Heap &activeTets, MTri3 *t)
+{
+  if (!t->isQueued()){
+    t->setQueued(true);
+    activeTets.push(t);
+  }
+}
+
+// Changes the radius of a triangle that could not be refined. A sorted
+// container needs the triangle to be taken out and put back.
+static void forceRadius(std::set<MTri3*, compareTri3Ptr> &allTets, MTri3 *t, double r)
+{
+  std::set<MTri3*, compareTri3Ptr>::iterator it = allTets.find(t);
+  if (it == allTets.end()){
+    t->forceRadius(r);
+    return;
+  }
+  allTets.erase(it);
+  t->forceRadius(r);
+  allTets.insert(t);
+}
+
+static void forceRadius(MTri3Heap &allTets, MTri3 *t, double r)
+{
+  // the triangle that is refined is the one on top of the heap
+  allTets.pop();
+  t->forceRadius(r);
+  allTets.push(t);
+}
+
+static void forceRadius(std::vector<MTri3*> &allTets, MTri3 *t, double r)
+{
+  t->forceRadius(r);
+}
+
+template <class CONTAINER, class ACTIVE>
+static bool insertVertexB (std::vector<edgeXface> &shell,
+		    std::vector<MTri3*> &cavity,
 		    bool force, GFace *gf, MVertex *v, double *param , MTri3 *t,
-		    std::set<MTri3*, compareTri3Ptr> &allTets,
-		    std::set<MTri3*, compareTri3Ptr> *activeTets,
+		    CONTAINER &allTets,
+		    ACTIVE *activeTets,
 		    bidimMeshData & data,
 		    double *metric,
 		    MTri3 **oneNewTriangle)
@@ -707,27 +858,27 @@ bool insertVertexB (std::list<edgeXface> &shell,
   if (cavity.size() == 1) return false;
   if (shell.size() != cavity.size() + 2) return false;
 
-  std::list<MTri3*> new_cavity;
-  std::vector<edgeXface> conn;
+  std::vector<MTri3*> &new_cavity = NEW_CAVITY;
+  std::vector<MTri3*> &newTris = NEW_TRIS;
+  new_cavity.clear();
+  newTris.clear();
 
   // check that volume is conserved
   double newVolume = 0;
   double oldVolume = 0;
 
-  std::list<MTri3*>::iterator ittet = cavity.begin();
-  std::list<MTri3*>::iterator ittete = cavity.end();
+  std::vector<MTri3*>::iterator ittet = cavity.begin();
+  std::vector<MTri3*>::iterator ittete = cavity.end();
   while(ittet != ittete){
     oldVolume += fabs(getSurfUV((*ittet)->tri(),data));
     ++ittet;
   }
 
-  MTri3 **newTris = new MTri3*[shell.size()];
-  int k = 0;
-  std::list<edgeXface>::iterator it = shell.begin();
+  std::vector<edgeXface>::iterator it = shell.begin();
 
   bool onePointIsTooClose = false;
   while (it != shell.end()){
-    MTriangle *t = new MTriangle(it->v[0], it->v[1], v);
+    MTriangle *t = newTriangle(it->v[0], it->v[1], v);
     int index0 = data.getIndex (t->getVertex(0));
     int index1 = data.getIndex (t->getVertex(1));
     int index2 = data.getIndex (t->getVertex(2));
@@ -753,7 +904,7 @@ bool insertVertexB (std::list<edgeXface> &shell,
       //      printf("%12.5E %12.5E %12.5E %12.5E \n",d1,d2,LL,cosv);
     }
 
-    newTris[k++] = t4;
+    newTris.push_back(t4);
     // all new triangles are pushed front in order to be able to
     // destroy them if the cavity is not star shaped around the new
     // vertex.
@@ -769,48 +920,35 @@ bool insertVertexB (std::list<edgeXface> &shell,
 
 
   if (fabs(oldVolume - newVolume) < 1.e-12 * oldVolume && !onePointIsTooClose){
-    connectTris(new_cavity.begin(), new_cavity.end(),conn);
-    //    printf("%d %d\n",shell.size(),cavity.size());
-    // 30 % of the time is spent here !!!
-    allTets.insert(newTris, newTris + shell.size());
+    connectTris(new_cavity.begin(), new_cavity.end(), CONN);
+    addTriangles(allTets, newTris.begin(), newTris.end());
     if (activeTets){
-      for (std::list<MTri3*>::iterator i = new_cavity.begin(); i != new_cavity.end(); ++i){
+      for (std::vector<MTri3*>::iterator i = new_cavity.begin(); i != new_cavity.end(); ++i){
         int active_edge;
-        if(isActive(*i, LIMIT_, active_edge) && (*i)->getRadius() > LIMIT_){
-          if ((*activeTets).find(*i) == (*activeTets).end())
-            (*activeTets).insert(*i);
-        }
+        if(isActive(*i, LIMIT_, active_edge) && (*i)->getRadius() > LIMIT_)
+          addActive(*activeTets, *i);
       }
     }
-    delete [] newTris;
     return true;
   }
 
   // The cavity is NOT star shaped
   else{
-
-    //    printf("(%g %g) %22.15E %22.15E %d %d %d %d %d\n",v->x(),v->y(),oldVolume,  newVolume, shell.size(), onePointIsTooClose, cavity.size(), new_cavity.size(),allTets.size());
-    //    printf("12.5E 12.5E 12.5E 12.5E 12.5E\n",d1,d2,LL,cosv);
-
     ittet = cavity.begin();
     ittete = cavity.end();
     while(ittet != ittete){
       (*ittet)->setDeleted(false);
       ++ittet;
     }
-    //    _printTris("cavity.pos", cavity.begin(), cavity.end(), Us, Vs, false);
-    //    _printTris("new_cavity.pos", new_cavity.begin(), new_cavity.end(), Us, Vs, false);
-    //    _printTris("newTris.pos", &newTris[0], newTris+shell.size(), Us, Vs, false);
-    //    _printTris("allTris.pos", allTets.begin(),allTets.end(), Us, Vs, false);
-    for (unsigned int i = 0; i < shell.size(); i++) {delete newTris[i]->tri(), delete newTris[i];}
-    delete [] newTris;
-    //    throw;
-    //    double t2 = Cpu();
-    //    DT_INSERT_VERTEX += t2-t1;
+    for (unsigned int i = 0; i < newTris.size(); i++) {
+      deleteTriangle(newTris[i]->tri());
+      delete newTris[i];
+    }
     return false;
   }
 }
 
+
 bool insertVertex(bool force, GFace *gf, MVertex *v, double *param , MTri3 *t,
                   std::set<MTri3*, compareTri3Ptr> &allTets,
                   std::set<MTri3*, compareTri3Ptr> *activeTets,
@@ -818,8 +956,8 @@ bool insertVertex(bool force, GFace *gf, MVertex *v, double *param , MTri3 *t,
                   double *metric,
 		  MTri3 **oneNewTriangle)
 {
-  std::list<edgeXface> shell;
-  std::list<MTri3*> cavity;
+  std::vector<edgeXface> shell;
+  std::vector<MTri3*> cavity;
 
   if (!metric){
     double p[3] = {v->x(), v->y(), v->z()};
@@ -891,8 +1029,9 @@ static MTri3* search4Triangle (MTri3 *t, MVertex *v, int maxx, int &ITER) {
   return 0;
 }
 
+template <class CONTAINER>
 static MTri3* search4Triangle (MTri3 *t, double pt[2], bidimMeshData & data,
-			       std::set<MTri3*,compareTri3Ptr> &AllTris, double uv[2], bool force = false) {
+			       CONTAINER &AllTris, double uv[2], bool force = false) {
 
   //  bool inside = t->inCircumCircle(pt);
   bool inside =  invMapUV(t->tri(), pt, data, uv, 1.e-8);
@@ -932,7 +1071,7 @@ static MTri3* search4Triangle (MTri3 *t, double pt[2], bidimMeshData & data,
   if (!force)return 0; // FIXME: removing this leads to horrible performance
 
   N_GLOBAL_SEARCH ++ ;
-  for(std::set<MTri3*,compareTri3Ptr>::iterator itx = AllTris.begin();
+  for(typename CONTAINER::iterator itx = AllTris.begin();
       itx != AllTris.end();++itx){
     if (!(*itx)->isDeleted()){
       inside = invMapUV((*itx)->tri(), pt, data, uv, 1.e-8);
@@ -948,36 +1087,32 @@ static MTri3* search4Triangle (MTri3 *t, double pt[2], bidimMeshData & data,
 
 ///*********************
 
+// Tries to insert a point in order to refine the triangle worst. AllTris holds
+// all the triangles of the face and ActiveTris the triangles of the front.
+template <class CONTAINER, class ACTIVE>
 static bool insertAPoint(GFace *gf,
-			 std::set<MTri3*,compareTri3Ptr>::iterator it,
+			 MTri3 *worst,
                          double center[2],
 			 double metric[3],
 			 bidimMeshData & data,
-                         std::set<MTri3*,compareTri3Ptr> &AllTris,
-                         std::set<MTri3*,compareTri3Ptr> *ActiveTris = 0,
-                         MTri3 *worst = 0,
-			 MTri3 **oneNewTriangle = 0)
+                         CONTAINER &AllTris,
+                         ACTIVE *ActiveTris,
+			 MTri3 **oneNewTriangle)
 {
-  if (worst){
-    it = AllTris.find(worst);
-    if (worst != *it){
-      Msg::Error("Could not insert point");
-      return false;
-    }
-  }
-  else worst = *it;
-
   MTri3 *ptin = 0;
-  std::list<edgeXface> shell;
-  std::list<MTri3*> cavity;
+  std::vector<edgeXface> &shell = SHELL;
+  std::vector<MTri3*> &cavity = CAVITY;
   double uv[2];
 
+  shell.clear();
+  cavity.clear();
+
   // TEST
   // if the point is able to break the bad triangle "worst"
   if (inCircumCircleAniso(gf, worst->tri(), center, metric, data)){
     if (!findCavityTangentPlane(gf,center,shell, cavity, worst))
       recurFindCavityAniso(gf, shell, cavity, metric, center, worst, data);
-    for (std::list<MTri3*>::iterator itc = cavity.begin(); itc != cavity.end(); ++itc){
+    for (std::vector<MTri3*>::iterator itc = cavity.begin(); itc != cavity.end(); ++itc){
       if (invMapUV((*itc)->tri(), center, data, uv, 1.e-8)) {
 	ptin = *itc;
 	break;
@@ -1025,11 +1160,9 @@ static bool insertAPoint(GFace *gf,
 		 center[0], center[1], p.succeeded() );
             printf("Point %g %g cannot be inserted because %d",
       	     center[0], center[1], p.succeeded() );
-      AllTris.erase(it);
-      worst->forceRadius(-1);
-      AllTris.insert(worst);
+      forceRadius(AllTris, worst, -1);
       delete v;
-      for (std::list<MTri3*>::iterator itc = cavity.begin(); itc != cavity.end(); ++itc)(*itc)->setDeleted(false);
+      for (std::vector<MTri3*>::iterator itc = cavity.begin(); itc != cavity.end(); ++itc)(*itc)->setDeleted(false);
       return false;
     }
     else {
@@ -1042,14 +1175,46 @@ static bool insertAPoint(GFace *gf,
   }
   else {
     //    MTriangle *base = worst->tri();
-    for (std::list<MTri3*>::iterator itc = cavity.begin(); itc != cavity.end(); ++itc)(*itc)->setDeleted(false);
-    AllTris.erase(it);
-    worst->forceRadius(0);
-    AllTris.insert(worst);
+    for (std::vector<MTri3*>::iterator itc = cavity.begin(); itc != cavity.end(); ++itc)(*itc)->setDeleted(false);
+    forceRadius(AllTris, worst, 0);
     return false;
   }
 }
 
+template <class CONTAINER>
+static bool insertAPoint(GFace *gf,
+			 MTri3 *worst,
+                         double center[2],
+			 double metric[3],
+			 bidimMeshData & data,
+                         CONTAINER &AllTris,
+			 MTri3 **oneNewTriangle = 0)
+{
+  return insertAPoint(gf, worst, center, metric, data, AllTris,
+                      (std::set<MTri3*,compareTri3Ptr>*)0, oneNewTriangle);
+}
+
+// Moves the triangles left by the insertion back into a sorted set for the
+// optimization passes. The deleted triangles are freed on the way.
+template <class CONTAINER>
+static void toSortedSet(CONTAINER &tris, std::set<MTri3*,compareTri3Ptr> &AllTris)
+{
+  std::vector<MTri3*> alive;
+  alive.reserve(tris.size());
+  for (typename CONTAINER::iterator it = tris.begin(); it != tris.end(); ++it){
+    if ((*it)->isDeleted()){
+      deleteTriangle((*it)->tri());
+      delete *it;
+    }
+    else alive.push_back(*it);
+  }
+  CONTAINER().swap(tris);
+  std::sort(alive.begin(), alive.end(), compareTri3Ptr());
+  for (unsigned int i = 0; i < alive.size(); i++)
+    AllTris.insert(AllTris.end(), alive[i]);
+}
+
+
 void bowyerWatson(GFace *gf, int MAXPNT,
 		  std::map<MVertex* , MVertex*>* equivalence,
 		  std::map<MVertex*, SPoint2> * parametricCoordinates)
@@ -1069,6 +1234,12 @@ void bowyerWatson(GFace *gf, int MAXPNT,
     return;
   }
 
+  // the worst triangle is taken from a heap during the insertion
+  MTri3Heap TriHeap;
+  TriHeap.reserve(4 * AllTris.size());
+  TriHeap.insert(AllTris.begin(), AllTris.end());
+  AllTris.clear();
+
   int ITER = 0;
   int NBDELETED = 0;
   //  double DT1 = 0 , DT2=0, DT3=0;
@@ -1078,12 +1249,12 @@ void bowyerWatson(GFace *gf, int MAXPNT,
     //      sprintf(name,"del2d%d-ITER%4d.pos",gf->tag(),ITER);
     //      _printTris (name, AllTris, Us,Vs,false);
     //    }
-    MTri3 *worst = *AllTris.begin();
+    MTri3 *worst = TriHeap.top();
     if (worst->isDeleted()){
       //      double t1 = Cpu();
-      delete worst->tri();
+      deleteTriangle(worst->tri());
       delete worst;
-      AllTris.erase(AllTris.begin());
+      TriHeap.pop();
       NBDELETED ++;
       //      DT1 += (Cpu() - t1);
     }
@@ -1112,9 +1283,10 @@ void bowyerWatson(GFace *gf, int MAXPNT,
       circumCenterMetric(worst->tri(), metric, DATA, center, r2);
       //      DT2 += (Cpu() - t2) ;
       //      double t3 = Cpu() ;
-      insertAPoint(gf, AllTris.begin(), center, metric, DATA, AllTris);
+      insertAPoint(gf, worst, center, metric, DATA, TriHeap);
     }
   }
+  toSortedSet(TriHeap, AllTris);
   nbSwaps = edgeSwapPass(gf, AllTris, SWCR_QUAL, DATA);
   //  printf("%12.5E %12.5E %12.5E %12.5E %12.5E\n",DT1,DT2,DT3,__DT1,__DT2);
   //  printf("%12.5E \n",__DT2);
@@ -1130,6 +1302,7 @@ void bowyerWatson(GFace *gf, int MAXPNT,
   }
 #endif
   transferDataStructure(gf, AllTris, DATA);
+  releaseSpareTriangles();
 }
 
 /*
@@ -1361,7 +1534,7 @@ void bowyerWatsonFrontal(GFace *gf,
 			 std::map<MVertex*, SPoint2> * parametricCoordinates)
 {
   std::set<MTri3*,compareTri3Ptr> AllTris;
-  std::set<MTri3*,compareTri3Ptr> ActiveTris;
+  MTri3Heap ActiveTris;
   bidimMeshData DATA(equivalence,parametricCoordinates);
 
   buildMeshGenerationDataStructures(gf, AllTris, DATA);
@@ -1370,13 +1543,17 @@ void bowyerWatsonFrontal(GFace *gf,
   int nbSwaps = edgeSwapPass(gf, AllTris, SWCR_DEL, DATA);
   Msg::Debug("Delaunization of the initial mesh done (%d swaps)", nbSwaps);
 
+  // the insertion does not need the triangles to be sorted, only the
+  // active ones
+  std::vector<MTri3*> TriList(AllTris.begin(), AllTris.end());
+  TriList.reserve(4 * TriList.size());
+  AllTris.clear();
+
   int ITER = 0, active_edge;
   // compute active triangle
-  std::set<MTri3*,compareTri3Ptr>::iterator it = AllTris.begin();
-  for ( ; it!=AllTris.end();++it){
-    if(isActive(*it,LIMIT_,active_edge))
-      ActiveTris.insert(*it);
-    else if ((*it)->getRadius() < LIMIT_)break;
+  for (unsigned int i = 0; i < TriList.size(); i++){
+    if(TriList[i]->getRadius() > LIMIT_ && isActive(TriList[i],LIMIT_,active_edge))
+      addActive(ActiveTris, TriList[i]);
   }
 
   // insert points
@@ -1392,9 +1569,10 @@ void bowyerWatsonFrontal(GFace *gf,
       _printTris (name, ActiveTris.begin(), ActiveTris.end(), &DATA);
       }
     */
-    if (!ActiveTris.size())break;
-    MTri3 *worst = (*ActiveTris.begin());
-    ActiveTris.erase(ActiveTris.begin());
+    if (ActiveTris.empty())break;
+    MTri3 *worst = ActiveTris.top();
+    ActiveTris.pop();
+    worst->setQueued(false);
 
     if (!worst->isDeleted() && isActive(worst, LIMIT_, active_edge) &&
         worst->getRadius() > LIMIT_){
@@ -1407,14 +1585,15 @@ void bowyerWatsonFrontal(GFace *gf,
       double newPoint[2], metric[3];
   //    optimalPointFrontal(gf,worst,active_edge,Us,Vs,vSizes,vSizesBGM,newPoint,metric);
       if (optimalPointFrontalB (gf,worst,active_edge,DATA,newPoint,metric)){
-	insertAPoint(gf, AllTris.end(), newPoint, metric, DATA, AllTris, &ActiveTris, worst);
+	insertAPoint(gf, worst, newPoint, metric, DATA, TriList, &ActiveTris, 0);
       }
     }    
   }
-
+  toSortedSet(TriList, AllTris);
   nbSwaps = edgeSwapPass(gf, AllTris, SWCR_QUAL, DATA);
   
   transferDataStructure(gf, AllTris, DATA);
+  releaseSpareTriangles();
   //  removeThreeTrianglesNodes(gf);
 
   // in case of boundary layer meshing
@@ -1668,7 +1847,7 @@ void bowyerWatsonFrontalLayers(GFace *gf, bool quad,
         else optimalPointFrontalB (gf,worst,active_edge,DATA,newPoint,metric);
 
         //	printf("start INSERT A POINT %g %g \n",newPoint[0],newPoint[1]);
-        insertAPoint(gf, AllTris.end(), newPoint, 0, DATA, AllTris, &ActiveTris, worst);
+        insertAPoint(gf, worst, newPoint, 0, DATA, AllTris, &ActiveTris, 0);
         //  else if (!worst->isDeleted() && worst->getRadius() > LIMIT_){
         //    ActiveTrisNotInFront.insert(worst);
         //  }
@@ -1751,7 +1930,8 @@ void bowyerWatsonParallelograms(GFace *gf,
     Msg::Debug("Delaunization of the initial mesh done (%d swaps)", nbSwaps);
 
     //std::sort(packed.begin(), packed.end(), MVertexLessThanLexicographic());
-    SortHilbert(packed);
+    // the points are located by walking in the parametric plane
+    SortHilbertParametric(packed);
 
     //  printf("staring to insert points\n");
     N_GLOBAL_SEARCH = 0;
@@ -1775,7 +1955,7 @@ void bowyerWatsonParallelograms(GFace *gf,
         //      buildMetric(gf, newPoint, metrics[i], metric);
         buildMetric(gf, newPoint, metric);
 
-        bool success = insertAPoint(gf, AllTris.begin(), newPoint, metric, DATA , AllTris, 0, oneNewTriangle, &oneNewTriangle);
+        bool success = insertAPoint(gf, oneNewTriangle ? oneNewTriangle : *AllTris.begin(), newPoint, metric, DATA , AllTris, &oneNewTriangle);
         if (!success) oneNewTriangle = 0;
         //      if (!success)printf("success %d %d\n",success,AllTris.size());
         i++;
@@ -1870,7 +2050,7 @@ void bowyerWatsonParallelogramsConstrained(GFace *gf,
       //      buildMetric(gf, newPoint, metrics[i], metric);
       buildMetric(gf, newPoint, metric);
 
-      bool success = insertAPoint(gf, AllTris.begin(), newPoint, metric, DATA , AllTris, 0, oneNewTriangle, &oneNewTriangle);
+      bool success = insertAPoint(gf, oneNewTriangle ? oneNewTriangle : *AllTris.begin(), newPoint, metric, DATA , AllTris, &oneNewTriangle);
       if (!success) oneNewTriangle = 0;
 	//      if (!success)printf("success %d %d\n",success,AllTris.size());
       i++;
@@ -2000,7 +2180,7 @@ void bowyerWatsonParallelogramsConstrained(GFace *gf,
     double t1 = Cpu();
 	
 	OmniFEMMsg::instance()->MsgInfo("Delaunay 2D SORTING");
-    if(hilbertSort) SortHilbert(v);
+    if(hilbertSort) SortHilbert2D(v);
 
     double ta=0,tb=0,tc=0,td=0,T;
 
@@ -0,0 +1,631 @@
+#include <Mesh/MeshCache.h>
+
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <Mesh/GMSH/GVertex.h>
+#include <Mesh/GMSH/GEdge.h>
+#include <Mesh/GMSH/GFace.h>
+#include <Mesh/GMSH/discreteVertex.h>
+#include <Mesh/GMSH/discreteEdge.h>
+#include <Mesh/GMSH/discreteFace.h>
+#include <Mesh/GMSH/MPoint.h>
+#include <Mesh/GMSH/MLine.h>
+#include <Mesh/GMSH/MTriangle.h>
+#include <Mesh/GMSH/MQuadrangle.h>
+
+
+//! The version of the layout that is written. A cache with a different version is ignored
+static const uint32_t cacheVersion = 2;
+
+//! The alignment of the arrays in the file
+static const uint64_t cacheAlignment = 64;
+
+
+
+static uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + cacheAlignment - 1) / cacheAlignment * cacheAlignment;
+}
+
+
+
+/**
+ * @brief Writes an array into the file at its offset. The space between the end of the last array and the offset is filled with zeros
+ * @param cacheFile The file that is written
+ * @param offset The offset of the array from the start of the file
+ * @param data The array
+ */
+template<class T>
+static void writeSection(std::ofstream &cacheFile, uint64_t offset, const std::vector<T> &data)
+{
+	const char padding[cacheAlignment] = {0};
+	const uint64_t position = cacheFile.tellp();
+
+	cacheFile.write(padding, offset - position);
+
+	if(!data.empty())
+		cacheFile.write(reinterpret_cast<const char*>(&data[0]), data.size() * sizeof(T));
+}
+
+
+
+/**
+ * @brief Adds the bytes of a value to a FNV-1a hash
+ * @param hash The hash that is updated
+ * @param value The value. This must be a plain type without padding
+ */
+template<class T>
+static void hashValue(uint64_t &hash, T value)
+{
+	const unsigned char *bytes = reinterpret_cast<const unsigned char*>(&value);
+
+	for(size_t i = 0; i < sizeof(T); i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+}
+
+
+
+/**
+ * @brief Adds a string and its length to a FNV-1a hash
+ * @param hash The hash that is updated
+ * @param value The string
+ */
+static void hashString(uint64_t &hash, const std::string &value)
+{
+	hashValue(hash, (uint64_t)value.size());
+
+	for(std::string::const_iterator characterIterator = value.begin(); characterIterator != value.end(); characterIterator++)
+	{
+		hash ^= (unsigned char)*characterIterator;
+		hash *= 1099511628211ULL;
+	}
+}
+
+
+
+/**
+ * @brief Adds the fields of a line or of the line part of an arc to a FNV-1a hash
+ * @param hash The hash that is updated
+ * @param edge The line
+ */
+static void hashEdge(uint64_t &hash, edgeLineShape &edge)
+{
+	segmentProperty *property = edge.getSegmentProperty();
+
+	hashValue(hash, edge.getCenterXCoordinate());
+	hashValue(hash, edge.getCenterYCoordinate());
+	hashValue(hash, (uint64_t)edge.getFirstNodeID());
+	hashValue(hash, (uint64_t)edge.getSecondNodeID());
+	hashValue(hash, (int32_t)property->getPhysicsProblem());
+	hashString(hash, property->getBoundaryName());
+	hashString(hash, property->getConductorName());
+	hashValue(hash, (uint8_t)property->getMeshAutoState());
+	hashValue(hash, property->getElementSizeAlongLine());
+	hashValue(hash, (uint8_t)property->getHiddenState());
+	hashValue(hash, (uint32_t)property->getGroupNumber());
+}
+
+
+
+std::string meshCache::getCachePath(std::string projectPath)
+{
+	if(projectPath.size() > 8 && projectPath.substr(projectPath.size() - 8) == ".omniFEM")
+		return projectPath + "mesh";
+
+	return projectPath + ".omniFEMmesh";
+}
+
+
+
+uint64_t meshCache::computeGeometryHash(geometryEditor2D &editor)
+{
+	uint64_t hash = 14695981039346656037ULL;
+
+	hashValue(hash, (uint64_t)editor.getNodeList()->size());
+	hashValue(hash, (uint64_t)editor.getLineList()->size());
+	hashValue(hash, (uint64_t)editor.getArcList()->size());
+	hashValue(hash, (uint64_t)editor.getBlockLabelList()->size());
+
+	for(plf::colony<node>::iterator nodeIterator = editor.getNodeList()->begin(); nodeIterator != editor.getNodeList()->end(); ++nodeIterator)
+	{
+		nodeSetting *setting = nodeIterator->getNodeSetting();
+
+		hashValue(hash, nodeIterator->getCenterXCoordinate());
+		hashValue(hash, nodeIterator->getCenterYCoordinate());
+		hashValue(hash, (uint64_t)nodeIterator->getNodeID());
+		hashValue(hash, (int32_t)setting->getPhysicsProblem());
+		hashString(hash, setting->getNodalPropertyName());
+		hashString(hash, setting->getConductorPropertyName());
+		hashValue(hash, (uint32_t)setting->getGroupNumber());
+	}
+
+	for(plf::colony<edgeLineShape>::iterator lineIterator = editor.getLineList()->begin(); lineIterator != editor.getLineList()->end(); ++lineIterator)
+		hashEdge(hash, *lineIterator);
+
+	for(plf::colony<arcShape>::iterator arcIterator = editor.getArcList()->begin(); arcIterator != editor.getArcList()->end(); ++arcIterator)
+	{
+		hashEdge(hash, *arcIterator);
+		hashValue(hash, (uint64_t)arcIterator->getArcID());
+		hashValue(hash, (uint32_t)arcIterator->getnumSegments());
+		hashValue(hash, arcIterator->getArcAngle());
+		hashValue(hash, arcIterator->getRadius());
+	}
+
+	for(plf::colony<blockLabel>::iterator labelIterator = editor.getBlockLabelList()->begin(); labelIterator != editor.getBlockLabelList()->end(); ++labelIterator)
+	{
+		blockProperty *property = labelIterator->getProperty();
+
+		hashValue(hash, labelIterator->getCenterXCoordinate());
+		hashValue(hash, labelIterator->getCenterYCoordinate());
+		hashValue(hash, (int32_t)property->getMeshsizeType());
+		hashString(hash, property->getMaterialName());
+		hashString(hash, property->getCircuitName());
+		hashValue(hash, (uint8_t)property->getAutoMeshState());
+		hashValue(hash, property->getNumberOfTurns());
+		hashString(hash, property->getMagnetization().ToStdString());
+		hashValue(hash, (uint32_t)property->getGroupNumber());
+		hashValue(hash, (uint8_t)property->getIsExternalState());
+		hashValue(hash, (uint8_t)property->getDefaultState());
+		hashValue(hash, property->getMeshSize());
+	}
+
+	return hash;
+}
+
+
+
+bool meshCache::write(std::string filePath, GModel *model, uint64_t geometryHash)
+{
+	std::vector<GEntity*> entities;
+	std::vector<meshCacheEntity> cacheEntities;
+	std::vector<int32_t> physicals;
+	std::vector<meshCacheName> names;
+	std::vector<char> nameCharacters;
+	std::vector<double> x, y, z;
+	std::vector<int32_t> elementTypes;
+	std::vector<uint64_t> elementOffsets(1, 0);
+	std::vector<uint32_t> connectivity;
+	std::vector<unsigned long long> edgeKeys;
+	std::vector<uint32_t> edges;
+
+	/* The vertices are numbered from 1 in the order of the entities and of the vertices of each entity. So the nodes of the
+	 * cache are in the same order and the node of a vertex is its index minus 1
+	 */
+	model->indexMeshVertices(true);
+	model->getEntities(entities);
+
+	x.reserve(model->getNumMeshVertices());
+	y.reserve(model->getNumMeshVertices());
+	z.reserve(model->getNumMeshVertices());
+
+	for(std::vector<GEntity*>::iterator entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		GEntity *entity = *entityIterator;
+		meshCacheEntity cacheEntity;
+
+		if(entity->dim() > 2)
+			continue;
+
+		cacheEntity.dimension = entity->dim();
+		cacheEntity.tag = entity->tag();
+		cacheEntity.beginTag = 0;
+		cacheEntity.endTag = 0;
+		cacheEntity.firstNode = x.size();
+		cacheEntity.firstElement = elementTypes.size();
+		cacheEntity.firstPhysical = physicals.size();
+
+		if(entity->dim() == 1)
+		{
+			GEdge *edge = static_cast<GEdge*>(entity);
+
+			if(edge->getBeginVertex())
+				cacheEntity.beginTag = edge->getBeginVertex()->tag();
+
+			if(edge->getEndVertex())
+				cacheEntity.endTag = edge->getEndVertex()->tag();
+		}
+
+		for(std::vector<MVertex*>::iterator vertexIterator = entity->mesh_vertices.begin(); vertexIterator != entity->mesh_vertices.end(); vertexIterator++)
+		{
+			// Vertices that are not used by any element are not numbered
+			if((*vertexIterator)->getIndex() <= 0)
+				continue;
+
+			x.push_back((*vertexIterator)->x());
+			y.push_back((*vertexIterator)->y());
+			z.push_back((*vertexIterator)->z());
+		}
+
+		for(unsigned int i = 0; i < entity->getNumMeshElements(); i++)
+		{
+			MElement *element = entity->getMeshElement(i);
+			const int numberOfCorners = element->getNumPrimaryVertices();
+			const size_t firstNode = connectivity.size();
+
+			for(int j = 0; j < element->getNumVertices(); j++)
+			{
+				if(element->getVertex(j)->getIndex() <= 0)
+				{
+					OmniFEMMsg::instance()->MsgError("Unable to write the mesh cache. An element uses a node that is not in the mesh");
+					return false;
+				}
+
+				connectivity.push_back(element->getVertex(j)->getIndex() - 1);
+			}
+
+			elementTypes.push_back(element->getTypeForMSH());
+			elementOffsets.push_back(connectivity.size());
+
+			// The edges are found the same way as the mesh renderer finds them. Only the corners of high order elements are used
+			if(numberOfCorners < 2 || numberOfCorners > 8)
+				continue;
+
+			const int numberOfEdges = (numberOfCorners == 2) ? 1 : numberOfCorners;
+
+			for(int j = 0; j < numberOfEdges; j++)
+			{
+				unsigned long long firstIndex = connectivity[firstNode + j];
+				unsigned long long secondIndex = connectivity[firstNode + (j + 1) % numberOfCorners];
+
+				if(firstIndex > secondIndex)
+					std::swap(firstIndex, secondIndex);
+
+				edgeKeys.push_back((firstIndex << 32) | secondIndex);
+			}
+		}
+
+		for(std::vector<int>::iterator physicalIterator = entity->physicals.begin(); physicalIterator != entity->physicals.end(); physicalIterator++)
+			physicals.push_back(*physicalIterator);
+
+		cacheEntity.numberOfNodes = x.size() - cacheEntity.firstNode;
+		cacheEntity.numberOfElements = elementTypes.size() - cacheEntity.firstElement;
+		cacheEntity.numberOfPhysicals = physicals.size() - cacheEntity.firstPhysical;
+		cacheEntities.push_back(cacheEntity);
+	}
+
+	std::sort(edgeKeys.begin(), edgeKeys.end());
+	edgeKeys.erase(std::unique(edgeKeys.begin(), edgeKeys.end()), edgeKeys.end());
+
+	edges.reserve(2 * edgeKeys.size());
+
+	for(std::vector<unsigned long long>::iterator keyIterator = edgeKeys.begin(); keyIterator != edgeKeys.end(); keyIterator++)
+	{
+		edges.push_back((uint32_t)(*keyIterator >> 32));
+		edges.push_back((uint32_t)(*keyIterator & 0xFFFFFFFFULL));
+	}
+
+	for(GModel::piter nameIterator = model->firstPhysicalName(); nameIterator != model->lastPhysicalName(); nameIterator++)
+	{
+		meshCacheName name;
+
+		name.dimension = nameIterator->first.first;
+		name.tag = nameIterator->first.second;
+		name.firstCharacter = nameCharacters.size();
+		name.numberOfCharacters = nameIterator->second.size();
+		nameCharacters.insert(nameCharacters.end(), nameIterator->second.begin(), nameIterator->second.end());
+		names.push_back(name);
+	}
+
+	meshCacheHeader header;
+	const uint64_t sectionSize[NUMBER_OF_SECTIONS] = {
+		cacheEntities.size() * sizeof(meshCacheEntity),
+		physicals.size() * sizeof(int32_t),
+		names.size() * sizeof(meshCacheName),
+		nameCharacters.size(),
+		x.size() * sizeof(double),
+		y.size() * sizeof(double),
+		z.size() * sizeof(double),
+		elementTypes.size() * sizeof(int32_t),
+		elementOffsets.size() * sizeof(uint64_t),
+		connectivity.size() * sizeof(uint32_t),
+		edges.size() * sizeof(uint32_t)
+	};
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "OFEMMESH", 8);
+	header.version = cacheVersion;
+	header.byteOrder = 0x01020304;
+	header.geometryHash = geometryHash;
+	header.numberOfEntities = cacheEntities.size();
+	header.numberOfPhysicals = physicals.size();
+	header.numberOfNames = names.size();
+	header.numberOfNameCharacters = nameCharacters.size();
+	header.numberOfNodes = x.size();
+	header.numberOfElements = elementTypes.size();
+	header.numberOfConnectivity = connectivity.size();
+	header.numberOfEdges = edgeKeys.size();
+
+	uint64_t offset = alignOffset(sizeof(meshCacheHeader));
+
+	for(int i = 0; i < NUMBER_OF_SECTIONS; i++)
+	{
+		header.sectionOffset[i] = offset;
+		offset = alignOffset(offset + sectionSize[i]);
+	}
+
+	// The cache is written under a different name so that a reader never maps a file that is only partly written
+	const std::string temporaryPath = filePath + ".tmp";
+	std::ofstream cacheFile(temporaryPath, std::ios::binary | std::ios::trunc);
+
+	if(!cacheFile.is_open())
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to write the mesh cache " + filePath);
+		return false;
+	}
+
+	cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	writeSection(cacheFile, header.sectionOffset[SECTION_ENTITIES], cacheEntities);
+	writeSection(cacheFile, header.sectionOffset[SECTION_PHYSICALS], physicals);
+	writeSection(cacheFile, header.sectionOffset[SECTION_NAMES], names);
+	writeSection(cacheFile, header.sectionOffset[SECTION_NAME_CHARACTERS], nameCharacters);
+	writeSection(cacheFile, header.sectionOffset[SECTION_NODE_X], x);
+	writeSection(cacheFile, header.sectionOffset[SECTION_NODE_Y], y);
+	writeSection(cacheFile, header.sectionOffset[SECTION_NODE_Z], z);
+	writeSection(cacheFile, header.sectionOffset[SECTION_ELEMENT_TYPES], elementTypes);
+	writeSection(cacheFile, header.sectionOffset[SECTION_ELEMENT_OFFSETS], elementOffsets);
+	writeSection(cacheFile, header.sectionOffset[SECTION_CONNECTIVITY], connectivity);
+	writeSection(cacheFile, header.sectionOffset[SECTION_EDGES], edges);
+
+	// The file is padded to the end of the last section so that every section is inside of the file
+	writeSection(cacheFile, offset, std::vector<char>());
+	cacheFile.close();
+
+	if(!cacheFile || std::rename(temporaryPath.c_str(), filePath.c_str()) != 0)
+	{
+		std::remove(temporaryPath.c_str());
+		OmniFEMMsg::instance()->MsgError("Unable to write the mesh cache " + filePath);
+		return false;
+	}
+
+	return true;
+}
+
+
+
+bool meshCache::open(std::string filePath)
+{
+	struct stat fileStatus;
+	int fileDescriptor;
+
+	close();
+
+	fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+
+	if(fileDescriptor < 0)
+		return false;
+
+	if(fstat(fileDescriptor, &fileStatus) != 0 || (size_t)fileStatus.st_size < sizeof(meshCacheHeader))
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+
+	void *mapping = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+	// The mapping stays valid after the file is closed
+	::close(fileDescriptor);
+
+	if(mapping == MAP_FAILED)
+		return false;
+
+	p_mapping = mapping;
+	p_mappingSize = fileStatus.st_size;
+
+	if(!isValid())
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+
+
+void meshCache::close()
+{
+	if(p_mapping)
+		munmap(p_mapping, p_mappingSize);
+
+	p_mapping = nullptr;
+	p_mappingSize = 0;
+}
+
+
+
+bool meshCache::isValid() const
+{
+	const meshCacheHeader *header = getHeader();
+	const uint64_t sectionSize[NUMBER_OF_SECTIONS] = {
+		header->numberOfEntities * sizeof(meshCacheEntity),
+		header->numberOfPhysicals * sizeof(int32_t),
+		header->numberOfNames * sizeof(meshCacheName),
+		header->numberOfNameCharacters,
+		header->numberOfNodes * sizeof(double),
+		header->numberOfNodes * sizeof(double),
+		header->numberOfNodes * sizeof(double),
+		header->numberOfElements * sizeof(int32_t),
+		(header->numberOfElements + 1) * sizeof(uint64_t),
+		header->numberOfConnectivity * sizeof(uint32_t),
+		2 * header->numberOfEdges * sizeof(uint32_t)
+	};
+
+	if(memcmp(header->magic, "OFEMMESH", 8) != 0 || header->version != cacheVersion || header->byteOrder != 0x01020304)
+		return false;
+
+	// The counts are limited so that the sizes above can not overflow
+	if(header->numberOfNodes > UINT32_MAX || header->numberOfElements > UINT32_MAX || header->numberOfEntities > UINT32_MAX ||
+		header->numberOfPhysicals > UINT32_MAX || header->numberOfNames > UINT32_MAX || header->numberOfNameCharacters > UINT32_MAX ||
+		header->numberOfConnectivity > UINT32_MAX || header->numberOfEdges > UINT32_MAX)
+		return false;
+
+	for(int i = 0; i < NUMBER_OF_SECTIONS; i++)
+	{
+		if(header->sectionOffset[i] % cacheAlignment != 0 || header->sectionOffset[i] > p_mappingSize || sectionSize[i] > p_mappingSize - header->sectionOffset[i])
+			return false;
+	}
+
+	const meshCacheEntity *entities = getSection<meshCacheEntity>(SECTION_ENTITIES);
+	const meshCacheName *names = getSection<meshCacheName>(SECTION_NAMES);
+	const uint64_t *elementOffsets = getSection<uint64_t>(SECTION_ELEMENT_OFFSETS);
+	const uint32_t *edges = getEdges();
+
+	for(uint64_t i = 0; i < header->numberOfEntities; i++)
+	{
+		if((uint64_t)entities[i].firstNode + entities[i].numberOfNodes > header->numberOfNodes ||
+			(uint64_t)entities[i].firstElement + entities[i].numberOfElements > header->numberOfElements ||
+			(uint64_t)entities[i].firstPhysical + entities[i].numberOfPhysicals > header->numberOfPhysicals ||
+			entities[i].dimension < 0 || entities[i].dimension > 2)
+			return false;
+	}
+
+	for(uint64_t i = 0; i < header->numberOfNames; i++)
+	{
+		if((uint64_t)names[i].firstCharacter + names[i].numberOfCharacters > header->numberOfNameCharacters)
+			return false;
+	}
+
+	if(elementOffsets[0] != 0 || elementOffsets[header->numberOfElements] != header->numberOfConnectivity)
+		return false;
+
+	for(uint64_t i = 0; i < header->numberOfElements; i++)
+	{
+		if(elementOffsets[i + 1] < elementOffsets[i])
+			return false;
+	}
+
+	// The edges are drawn straight from the cache so a bad node would be read outside of the vertex buffer
+	for(uint64_t i = 0; i < 2 * header->numberOfEdges; i++)
+	{
+		if(edges[i] >= header->numberOfNodes)
+			return false;
+	}
+
+	return true;
+}
+
+
+
+bool meshCache::restore(GModel *model) const
+{
+	const meshCacheHeader *header = getHeader();
+	const meshCacheEntity *entities = getSection<meshCacheEntity>(SECTION_ENTITIES);
+	const int32_t *physicals = getSection<int32_t>(SECTION_PHYSICALS);
+	const meshCacheName *names = getSection<meshCacheName>(SECTION_NAMES);
+	const char *nameCharacters = getSection<char>(SECTION_NAME_CHARACTERS);
+	const double *x = getSection<double>(SECTION_NODE_X);
+	const double *y = getSection<double>(SECTION_NODE_Y);
+	const double *z = getSection<double>(SECTION_NODE_Z);
+	const int32_t *elementTypes = getSection<int32_t>(SECTION_ELEMENT_TYPES);
+	const uint64_t *elementOffsets = getSection<uint64_t>(SECTION_ELEMENT_OFFSETS);
+	const uint32_t *connectivity = getSection<uint32_t>(SECTION_CONNECTIVITY);
+	std::vector<MVertex*> nodes(header->numberOfNodes, nullptr);
+	std::vector<GEntity*> modelEntities(header->numberOfEntities, nullptr);
+	std::vector<MVertex*> elementNodes;
+	MElementFactory elementFactory;
+
+	// The vertices take their numbers from the current model
+	GModel::setCurrent(model);
+
+	// The vertices of the model are created first since the edges need the vertices at their ends
+	for(int dimension = 0; dimension <= 2; dimension++)
+	{
+		for(uint64_t i = 0; i < header->numberOfEntities; i++)
+		{
+			const meshCacheEntity &cacheEntity = entities[i];
+			GEntity *entity = nullptr;
+
+			if(cacheEntity.dimension != dimension)
+				continue;
+
+			if(dimension == 0 && !model->getVertexByTag(cacheEntity.tag))
+			{
+				discreteVertex *vertex = new discreteVertex(model, cacheEntity.tag);
+				model->add(vertex);
+				entity = vertex;
+			}
+			else if(dimension == 1 && !model->getEdgeByTag(cacheEntity.tag))
+			{
+				discreteEdge *edge = new discreteEdge(model, cacheEntity.tag, model->getVertexByTag(cacheEntity.beginTag), model->getVertexByTag(cacheEntity.endTag));
+				model->add(edge);
+				entity = edge;
+			}
+			else if(dimension == 2 && !model->getFaceByTag(cacheEntity.tag))
+			{
+				discreteFace *face = new discreteFace(model, cacheEntity.tag);
+				model->add(face);
+				entity = face;
+			}
+
+			// Two entities with the same tag
+			if(!entity)
+				return false;
+
+			modelEntities[i] = entity;
+			entity->mesh_vertices.reserve(cacheEntity.numberOfNodes);
+
+			for(uint32_t j = cacheEntity.firstNode; j < cacheEntity.firstNode + cacheEntity.numberOfNodes; j++)
+			{
+				nodes[j] = new MVertex(x[j], y[j], z[j], entity, j + 1);
+				entity->mesh_vertices.push_back(nodes[j]);
+			}
+
+			for(uint32_t j = cacheEntity.firstPhysical; j < cacheEntity.firstPhysical + cacheEntity.numberOfPhysicals; j++)
+				entity->physicals.push_back(physicals[j]);
+		}
+	}
+
+	for(uint64_t i = 0; i < header->numberOfEntities; i++)
+	{
+		const meshCacheEntity &cacheEntity = entities[i];
+		GEntity *entity = modelEntities[i];
+
+		for(uint32_t j = cacheEntity.firstElement; j < cacheEntity.firstElement + cacheEntity.numberOfElements; j++)
+		{
+			elementNodes.clear();
+
+			for(uint64_t k = elementOffsets[j]; k < elementOffsets[j + 1]; k++)
+			{
+				if(connectivity[k] >= header->numberOfNodes || !nodes[connectivity[k]])
+					return false;
+
+				elementNodes.push_back(nodes[connectivity[k]]);
+			}
+
+			MElement *element = elementFactory.create(elementTypes[j], elementNodes);
+
+			if(!element)
+				return false;
+
+			if(element->getType() == TYPE_PNT && entity->dim() == 0)
+				static_cast<GVertex*>(entity)->points.push_back(static_cast<MPoint*>(element));
+			else if(element->getType() == TYPE_LIN && entity->dim() == 1)
+				static_cast<GEdge*>(entity)->lines.push_back(static_cast<MLine*>(element));
+			else if(element->getType() == TYPE_TRI && entity->dim() == 2)
+				static_cast<GFace*>(entity)->triangles.push_back(static_cast<MTriangle*>(element));
+			else if(element->getType() == TYPE_QUA && entity->dim() == 2)
+				static_cast<GFace*>(entity)->quadrangles.push_back(static_cast<MQuadrangle*>(element));
+			else
+			{
+				delete element;
+				return false;
+			}
+		}
+	}
+
+	for(uint64_t i = 0; i < header->numberOfNames; i++)
+		model->setPhysicalName(std::string(nameCharacters + names[i].firstCharacter, names[i].numberOfCharacters), names[i].dimension, names[i].tag);
+
+	return true;
+}
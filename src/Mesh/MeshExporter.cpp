@@ -0,0 +1,173 @@
+#include <Mesh/MeshExporter.h>
+
+#include <sstream>
+#include <iomanip>
+
+
+
+meshExporter::meshExporter(GModel *model, meshSettings &settings, std::string basePath)
+{
+	p_model = model;
+
+	/* The writers that are asked to only save the physical groups save all of the elements when the model has no
+	 * physical groups, so they use the same numbering as the writers that save all of the elements
+	 */
+	const exportNumbering physicalNumbering = p_model->noPhysicalGroups() ? NUMBERING_ALL : NUMBERING_PHYSICAL;
+
+	if(settings.getSaveVTKState())
+		addFormat("VTK", basePath + ".vtk", physicalNumbering, [=](){ return model->writeVTK(basePath + ".vtk"); });
+
+	if(settings.getSaveBDFState())
+		addFormat("BDF", basePath + ".bdf", physicalNumbering, [=](){ return model->writeBDF(basePath + ".bdf"); });
+
+	// The CELUM writer numbers the vertices of each face itself
+	if(settings.getSaveCELUMState())
+		addFormat("CELUM", basePath + ".celum", NUMBERING_OWN, [=](){ return model->writeCELUM(basePath + ".celum", false, 1.0); });
+
+	if(settings.getSaveDIFFPACKSate())
+		addFormat("DIFFPACK", basePath + ".diff", physicalNumbering, [=](){ return model->writeDIFF(basePath + ".diff", false, false, 1.0); });
+
+	if(settings.getSaveGEOState())
+		addFormat("GEO", basePath + ".geo", NUMBERING_NONE, [=](){ return model->writeGEO(basePath + ".geo", true, false); });
+
+	if(settings.getSaveINPState())
+		addFormat("INP", basePath + ".inp", physicalNumbering, [=](){ return model->writeINP(basePath + ".inp", false, false, 1.0); });
+
+	if(settings.getSaveIR3State())
+		addFormat("IR3", basePath + ".ir3", NUMBERING_ALL, [=](){ return model->writeIR3(basePath + ".ir3", 0, true, 1.0); });
+
+	if(settings.getSaveMAILState())
+		addFormat("MAIL", basePath + ".mail", NUMBERING_ALL, [=](){ return model->writeMAIL(basePath + ".mail", true, 1.0); });
+
+	if(settings.getSaveMESHState())
+		addFormat("MESH", basePath + ".mesh", physicalNumbering, [=](){ return model->writeMESH(basePath + ".mesh", 1, false, 1.0); });
+
+	if(settings.getSaveP3DState())
+		addFormat("P3D", basePath + ".p3d", NUMBERING_NONE, [=](){ return model->writeP3D(basePath + ".p3d", false, 1.0); });
+
+	// Each partition is numbered on its own
+	if(settings.getSavePartitionedMeshState())
+		addFormat("Partitioned MSH", basePath + ".mesh_*", NUMBERING_OWN, [=](){ return model->writePartitionedMSH(basePath + ".mesh", 2.2, false, false, false, 1.0); });
+
+	if(settings.getSavePLY2State())
+		addFormat("PLY2", basePath + ".ply2", NUMBERING_ALL, [=](){ return model->writePLY2(basePath + ".ply2"); });
+
+	if(settings.getSaveSTLState())
+		addFormat("STL", basePath + ".stl", NUMBERING_NONE, [=](){ return model->writeSTL(basePath + ".stl", false, false, 1.0); });
+
+	if(settings.getSaveTochnogState())
+		addFormat("TOCHNOG", basePath + ".toc", physicalNumbering, [=](){ return model->writeTOCHNOG(basePath + ".toc", false, false, 1.0); });
+
+	if(settings.getSaveSU2State())
+		addFormat("SU2", basePath + ".su2", NUMBERING_ALL, [=](){ return model->writeSU2(basePath + ".su2", true, 1.0); });
+
+	if(settings.getSaveUNVState())
+		addFormat("UNV", basePath + ".unv", physicalNumbering, [=](){ return model->writeUNV(basePath + ".unv", false, false, 1.0); });
+
+	if(settings.getSaveVRMLState())
+		addFormat("VRML", basePath + ".vrml", NUMBERING_ALL, [=](){ return model->writeVRML(basePath + ".vrml", true, 1.0); });
+}
+
+
+
+void meshExporter::addFormat(std::string format, std::string filePath, exportNumbering numbering, std::function<int()> write)
+{
+	exportTask newTask;
+
+	newTask.format = format;
+	newTask.filePath = filePath;
+	newTask.numbering = numbering;
+	newTask.write = write;
+
+	p_tasks.push_back(newTask);
+}
+
+
+
+void meshExporter::writeGroup(const std::vector<int> &group)
+{
+	if(group.empty())
+		return;
+
+	// The writers only read the model, so each thread takes the next format once it is done with its last one
+	#pragma omp parallel for schedule(dynamic, 1)
+	for(int i = 0; i < (int)group.size(); i++)
+	{
+		exportTask &task = p_tasks[group[i]];
+		double startTime = TimeOfDay();
+
+		task.isWritten = (task.write() != 0);
+		task.time = TimeOfDay() - startTime;
+	}
+}
+
+
+
+bool meshExporter::write()
+{
+	if(p_tasks.empty())
+		return true;
+
+	double startTime = TimeOfDay();
+	std::vector<int> physicalGroup, allGroup, ownGroup;
+	bool isWritten = true;
+
+	// The formats that do not use the numbering are written alongside the first group so that they do not wait on their own
+	for(unsigned int i = 0; i < p_tasks.size(); i++)
+	{
+		if(p_tasks[i].numbering == NUMBERING_ALL)
+			allGroup.push_back(i);
+		else if(p_tasks[i].numbering == NUMBERING_OWN)
+			ownGroup.push_back(i);
+		else
+			physicalGroup.push_back(i);
+	}
+
+	if(!physicalGroup.empty())
+	{
+		p_model->freezeMeshVertexIndex(false);
+		writeGroup(physicalGroup);
+	}
+
+	if(!allGroup.empty())
+	{
+		p_model->freezeMeshVertexIndex(true);
+		writeGroup(allGroup);
+	}
+
+	p_model->unfreezeMeshVertexIndex();
+
+	for(std::vector<int>::iterator taskIterator = ownGroup.begin(); taskIterator != ownGroup.end(); taskIterator++)
+	{
+		exportTask &task = p_tasks[*taskIterator];
+		double taskTime = TimeOfDay();
+
+		task.isWritten = (task.write() != 0);
+		task.time = TimeOfDay() - taskTime;
+	}
+
+	std::ostringstream report;
+	double totalTaskTime = 0;
+
+	report << std::fixed << std::setprecision(3);
+	report << "Mesh export:";
+
+	for(std::vector<exportTask>::iterator taskIterator = p_tasks.begin(); taskIterator != p_tasks.end(); taskIterator++)
+	{
+		report << "\n    " << taskIterator->format << ": " << taskIterator->time << " s";
+		totalTaskTime += taskIterator->time;
+
+		if(!taskIterator->isWritten)
+		{
+			report << " (failed)";
+			isWritten = false;
+			OmniFEMMsg::instance()->MsgError("Unable to write " + taskIterator->filePath);
+		}
+	}
+
+	report << "\n    Total: " << TimeOfDay() - startTime << " s (" << totalTaskTime << " s if written one after another)";
+
+	OmniFEMMsg::instance()->MsgInfo(report.str());
+
+	return isWritten;
+}
@@ -0,0 +1,295 @@
+#include <Mesh/PlanarGraph.h>
+
+
+
+void planarGraph::addEdge(edgeLineShape *edge, std::unordered_map<node*, unsigned int> &nodeIndex)
+{
+	halfEdge forward;
+	halfEdge backward;
+	node *edgeNodes[2] = {edge->getFirstNode(), edge->getSecondNode()};
+	unsigned int nodeIndices[2];
+
+	for(int i = 0; i < 2; i++)
+	{
+		std::unordered_map<node*, unsigned int>::iterator foundNode = nodeIndex.find(edgeNodes[i]);
+
+		if(foundNode == nodeIndex.end())
+		{
+			nodeIndices[i] = p_nodes.size();
+			nodeIndex[edgeNodes[i]] = nodeIndices[i];
+			p_nodes.push_back(edgeNodes[i]);
+		}
+		else
+			nodeIndices[i] = foundNode->second;
+	}
+
+	forward.edge = edge;
+	forward.origin = nodeIndices[0];
+	forward.twin = p_halfEdges.size() + 1;
+	forward.next = 0;
+	forward.isForward = true;
+
+	backward.edge = edge;
+	backward.origin = nodeIndices[1];
+	backward.twin = p_halfEdges.size();
+	backward.next = 0;
+	backward.isForward = false;
+
+	double xFirst = edgeNodes[0]->getCenterXCoordinate();
+	double yFirst = edgeNodes[0]->getCenterYCoordinate();
+	double xSecond = edgeNodes[1]->getCenterXCoordinate();
+	double ySecond = edgeNodes[1]->getCenterYCoordinate();
+
+	if(edge->isArc() && static_cast<arcShape*>(edge)->getRadius() > 0)
+	{
+		/* The arc goes CCW about its center from the first node to the second node. So, the tangent of the forward half-edge
+		 * is the radius rotated by 90 degrees CCW and the tangent of the backward half-edge is the radius rotated by 90 degrees CW
+		 */
+		double radius = static_cast<arcShape*>(edge)->getRadius();
+
+		forward.angle = atan2(xFirst - edge->getCenterXCoordinate(), edge->getCenterYCoordinate() - yFirst);
+		forward.curvature = 1.0 / radius;
+
+		backward.angle = atan2(edge->getCenterXCoordinate() - xSecond, ySecond - edge->getCenterYCoordinate());
+		backward.curvature = -1.0 / radius;
+	}
+	else
+	{
+		forward.angle = atan2(ySecond - yFirst, xSecond - xFirst);
+		forward.curvature = 0;
+
+		backward.angle = atan2(yFirst - ySecond, xFirst - xSecond);
+		backward.curvature = 0;
+	}
+
+	p_halfEdges.push_back(forward);
+	p_halfEdges.push_back(backward);
+}
+
+
+
+void planarGraph::linkHalfEdges()
+{
+	std::vector<unsigned int> sortedHalfEdges(p_halfEdges.size());
+	const double angleTolerance = 1e-9;
+
+	for(unsigned int i = 0; i < sortedHalfEdges.size(); i++)
+		sortedHalfEdges[i] = i;
+
+	/* All of the half-edges are sorted at once. They are grouped by the node that they leave from and then sorted CCW around the node.
+	 * If two half-edges leave in the same direction, the one that turns more to the left is further CCW
+	 */
+	std::sort(sortedHalfEdges.begin(), sortedHalfEdges.end(), [this, angleTolerance](unsigned int first, unsigned int second)
+	{
+		const halfEdge &firstEdge = p_halfEdges[first];
+		const halfEdge &secondEdge = p_halfEdges[second];
+
+		if(firstEdge.origin != secondEdge.origin)
+			return firstEdge.origin < secondEdge.origin;
+
+		if(fabs(firstEdge.angle - secondEdge.angle) > angleTolerance)
+			return firstEdge.angle < secondEdge.angle;
+
+		return firstEdge.curvature < secondEdge.curvature;
+	});
+
+	std::vector<unsigned int> position(p_halfEdges.size());
+	std::vector<unsigned int> groupStart(p_halfEdges.size());
+	std::vector<unsigned int> groupSize(p_halfEdges.size());
+
+	for(unsigned int i = 0; i < sortedHalfEdges.size();)
+	{
+		unsigned int j = i;
+
+		while(j < sortedHalfEdges.size() && p_halfEdges[sortedHalfEdges[j]].origin == p_halfEdges[sortedHalfEdges[i]].origin)
+			j++;
+
+		for(unsigned int k = i; k < j; k++)
+		{
+			position[sortedHalfEdges[k]] = k;
+			groupStart[sortedHalfEdges[k]] = i;
+			groupSize[sortedHalfEdges[k]] = j - i;
+		}
+
+		i = j;
+	}
+
+	/* The half-edge that comes after a half-edge around a face is the half-edge that is directly CW from the twin
+	 * around the node that the half-edge ends at. This keeps the face on the left side
+	 */
+	for(unsigned int i = 0; i < p_halfEdges.size(); i++)
+	{
+		unsigned int twin = p_halfEdges[i].twin;
+		unsigned int offset = position[twin] - groupStart[twin];
+
+		offset = (offset + groupSize[twin] - 1) % groupSize[twin];
+
+		p_halfEdges[i].next = sortedHalfEdges[groupStart[twin] + offset];
+	}
+}
+
+
+
+void planarGraph::traceFaces()
+{
+	std::vector<unsigned int> loopID(p_halfEdges.size(), p_halfEdges.size());
+	std::vector<unsigned int> loop;
+	std::vector<unsigned int> cleanLoop;
+	std::vector<unsigned int> loopStack;
+	std::unordered_map<unsigned int, size_t> stackPosition;
+
+	// Each loop is identified by the first half-edge that was traced in the loop
+	for(unsigned int start = 0; start < p_halfEdges.size(); start++)
+	{
+		if(loopID[start] != p_halfEdges.size())
+			continue;
+
+		loop.clear();
+
+		unsigned int current = start;
+
+		do
+		{
+			loopID[current] = start;
+			loop.push_back(current);
+			current = p_halfEdges[current].next;
+		} while(current != start && loopID[current] == p_halfEdges.size());
+
+		/* If both half-edges of an edge are in the same loop, then the edge is either dangling or is the only
+		 * connection between two parts of the geometry. Either way, the edge does not bound a face
+		 */
+		cleanLoop.clear();
+
+		for(std::vector<unsigned int>::iterator halfEdgeIterator = loop.begin(); halfEdgeIterator != loop.end(); ++halfEdgeIterator)
+		{
+			if(loopID[p_halfEdges[*halfEdgeIterator].twin] != start)
+				cleanLoop.push_back(*halfEdgeIterator);
+			else if(p_halfEdges[*halfEdgeIterator].isForward)
+				p_numberOfOpenEdges++;
+		}
+
+		/* With the edges removed, the loop may pass through the same node more then once. Each time that a node
+		 * is reached again, the half-edges since the last visit form a loop of their own
+		 */
+		loopStack.clear();
+		stackPosition.clear();
+
+		for(size_t i = 0; i <= cleanLoop.size(); i++)
+		{
+			unsigned int origin;
+
+			if(i < cleanLoop.size())
+				origin = p_halfEdges[cleanLoop[i]].origin;
+			else if(!loopStack.empty())
+				origin = p_halfEdges[loopStack[0]].origin;
+			else
+				break;
+
+			std::unordered_map<unsigned int, size_t>::iterator foundNode = stackPosition.find(origin);
+
+			if(foundNode != stackPosition.end())
+			{
+				std::vector<unsigned int> subLoop(loopStack.begin() + foundNode->second, loopStack.end());
+
+				for(std::vector<unsigned int>::iterator halfEdgeIterator = subLoop.begin(); halfEdgeIterator != subLoop.end(); ++halfEdgeIterator)
+					stackPosition.erase(p_halfEdges[*halfEdgeIterator].origin);
+
+				loopStack.resize(foundNode->second);
+
+				double area = getSignedArea(subLoop);
+
+				if(area > 0)
+				{
+					p_faces.push_back(subLoop);
+					p_faceAreas.push_back(area);
+				}
+			}
+
+			if(i < cleanLoop.size())
+			{
+				stackPosition[origin] = loopStack.size();
+				loopStack.push_back(cleanLoop[i]);
+			}
+		}
+	}
+}
+
+
+
+double planarGraph::getSignedArea(const std::vector<unsigned int> &loop)
+{
+	double area = 0;
+
+	for(std::vector<unsigned int>::const_iterator halfEdgeIterator = loop.begin(); halfEdgeIterator != loop.end(); ++halfEdgeIterator)
+	{
+		const halfEdge &currentEdge = p_halfEdges[*halfEdgeIterator];
+		node *startNode = p_nodes[currentEdge.origin];
+		node *endNode = p_nodes[p_halfEdges[currentEdge.twin].origin];
+
+		area += 0.5 * (startNode->getCenterXCoordinate() * endNode->getCenterYCoordinate() - endNode->getCenterXCoordinate() * startNode->getCenterYCoordinate());
+
+		if(currentEdge.curvature != 0)
+		{
+			// The area between the chord and the arc is added when going CCW about the arc's center and subtracted otherwise
+			arcShape *arc = static_cast<arcShape*>(currentEdge.edge);
+			double arcAngle = fabs(arc->getArcAngle()) * PI / 180.0;
+			double segmentArea = 0.5 * arc->getRadius() * arc->getRadius() * (arcAngle - sin(arcAngle));
+
+			if(currentEdge.isForward)
+				area += segmentArea;
+			else
+				area -= segmentArea;
+		}
+	}
+
+	return area;
+}
+
+
+
+void planarGraph::build(plf::colony<edgeLineShape> &lineList, plf::colony<arcShape> &arcList)
+{
+	std::unordered_map<node*, unsigned int> nodeIndex;
+
+	p_nodes.clear();
+	p_halfEdges.clear();
+	p_faces.clear();
+	p_faceAreas.clear();
+	p_numberOfOpenEdges = 0;
+
+	p_halfEdges.reserve(2 * (lineList.size() + arcList.size()));
+
+	for(plf::colony<edgeLineShape>::iterator lineIterator = lineList.begin(); lineIterator != lineList.end(); ++lineIterator)
+	{
+		if(!lineIterator->getSegmentProperty()->getHiddenState())
+			addEdge(&(*lineIterator), nodeIndex);
+	}
+
+	for(plf::colony<arcShape>::iterator arcIterator = arcList.begin(); arcIterator != arcList.end(); ++arcIterator)
+	{
+		if(!arcIterator->getSegmentProperty()->getHiddenState())
+			addEdge(&(*arcIterator), nodeIndex);
+	}
+
+	if(p_halfEdges.size() == 0)
+		return;
+
+	linkHalfEdges();
+
+	traceFaces();
+}
+
+
+
+closedPath planarGraph::getFacePath(size_t index)
+{
+	std::vector<unsigned int> &face = p_faces.at(index);
+	closedPath facePath(p_halfEdges[face[0]].edge);
+
+	for(size_t i = 1; i < face.size(); i++)
+		facePath.addEdgeToPath(p_halfEdges[face[i]].edge);
+
+	facePath.setArea(p_faceAreas.at(index));
+
+	return facePath;
+}
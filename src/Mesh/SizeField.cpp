@@ -0,0 +1,150 @@
+#include <Mesh/SizeField.h>
+
+#include <math.h>
+#include <algorithm>
+
+
+
+sizeField::sizeField(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &density, const std::vector<int> &triangles)
+{
+	const int numberOfTriangles = triangles.size() / 3;
+
+	p_x = x;
+	p_y = y;
+	p_density = density;
+	p_triangles = triangles;
+
+	if(numberOfTriangles == 0)
+		return;
+
+	double maximumX = p_x[p_triangles[0]];
+	double maximumY = p_y[p_triangles[0]];
+
+	p_minimumX = maximumX;
+	p_minimumY = maximumY;
+
+	for(auto nodeIterator = p_triangles.begin(); nodeIterator != p_triangles.end(); nodeIterator++)
+	{
+		p_minimumX = std::min(p_minimumX, p_x[*nodeIterator]);
+		p_minimumY = std::min(p_minimumY, p_y[*nodeIterator]);
+		maximumX = std::max(maximumX, p_x[*nodeIterator]);
+		maximumY = std::max(maximumY, p_y[*nodeIterator]);
+	}
+
+	/* About two triangles per bucket. The grid keeps the aspect ratio of the bounding box so that the buckets are close to square */
+	const double width = std::max(maximumX - p_minimumX, 1e-12);
+	const double height = std::max(maximumY - p_minimumY, 1e-12);
+	const double bucketSize = sqrt(2.0 * width * height / numberOfTriangles);
+
+	p_numberOfColumns = std::max(1, std::min(4096, (int)(width / bucketSize)));
+	p_numberOfRows = std::max(1, std::min(4096, (int)(height / bucketSize)));
+	p_inverseBucketWidth = p_numberOfColumns / width;
+	p_inverseBucketHeight = p_numberOfRows / height;
+
+	/* Counting sort of the triangles into the buckets of their bounding box. The first pass counts, the second pass fills */
+	p_bucketOffset.assign(p_numberOfColumns * p_numberOfRows + 1, 0);
+
+	for(int pass = 0; pass < 2; pass++)
+	{
+		for(int t = 0; t < numberOfTriangles; t++)
+		{
+			const int *nodes = &p_triangles[3 * t];
+			int firstColumn, firstRow, lastColumn, lastRow;
+
+			getBucket(std::min(std::min(p_x[nodes[0]], p_x[nodes[1]]), p_x[nodes[2]]), std::min(std::min(p_y[nodes[0]], p_y[nodes[1]]), p_y[nodes[2]]), firstColumn, firstRow);
+			getBucket(std::max(std::max(p_x[nodes[0]], p_x[nodes[1]]), p_x[nodes[2]]), std::max(std::max(p_y[nodes[0]], p_y[nodes[1]]), p_y[nodes[2]]), lastColumn, lastRow);
+
+			for(int row = firstRow; row <= lastRow; row++)
+			{
+				for(int column = firstColumn; column <= lastColumn; column++)
+				{
+					if(pass == 0)
+						p_bucketOffset[row * p_numberOfColumns + column + 1]++;
+					else
+						p_bucketTriangles[p_bucketOffset[row * p_numberOfColumns + column]++] = t;
+				}
+			}
+		}
+
+		if(pass == 0)
+		{
+			for(unsigned int b = 1; b < p_bucketOffset.size(); b++)
+				p_bucketOffset[b] += p_bucketOffset[b - 1];
+
+			p_bucketTriangles.resize(p_bucketOffset.back());
+		}
+		else
+		{
+			// The fill pass moved each offset to the start of the next bucket
+			for(unsigned int b = p_bucketOffset.size() - 1; b > 0; b--)
+				p_bucketOffset[b] = p_bucketOffset[b - 1];
+
+			p_bucketOffset[0] = 0;
+		}
+	}
+}
+
+
+
+void sizeField::getBucket(double x, double y, int &column, int &row) const
+{
+	column = std::min(std::max((int)floor((x - p_minimumX) * p_inverseBucketWidth), 0), p_numberOfColumns - 1);
+	row = std::min(std::max((int)floor((y - p_minimumY) * p_inverseBucketHeight), 0), p_numberOfRows - 1);
+}
+
+
+
+double sizeField::getDensity(double x, double y) const
+{
+	if(p_bucketOffset.empty())
+		return 0;
+
+	int column, row;
+
+	getBucket(x, y, column, row);
+
+	const int bucket = row * p_numberOfColumns + column;
+	double bestDensity = 0;
+	double bestDistance = -1e300;
+
+	/* The barycentric coordinates of the point are found in each triangle of the bucket. The point is inside of the triangle when the
+	 * smallest of them is not negative. Otherwise, the triangle where the smallest coordinate is the closest to 0 is used with the
+	 * coordinates clamped onto the triangle. This covers the points that are on the curved edges of the geometry
+	 */
+	for(int i = p_bucketOffset[bucket]; i < p_bucketOffset[bucket + 1]; i++)
+	{
+		const int *nodes = &p_triangles[3 * p_bucketTriangles[i]];
+		const double x0 = p_x[nodes[0]], y0 = p_y[nodes[0]];
+		const double determinant = (p_x[nodes[1]] - x0) * (p_y[nodes[2]] - y0) - (p_x[nodes[2]] - x0) * (p_y[nodes[1]] - y0);
+
+		if(determinant == 0)
+			continue;
+
+		const double first = ((x - x0) * (p_y[nodes[2]] - y0) - (p_x[nodes[2]] - x0) * (y - y0)) / determinant;
+		const double second = ((p_x[nodes[1]] - x0) * (y - y0) - (x - x0) * (p_y[nodes[1]] - y0)) / determinant;
+		const double weights[3] = {1.0 - first - second, first, second};
+		const double distance = std::min(std::min(weights[0], weights[1]), weights[2]);
+
+		if(distance <= bestDistance)
+			continue;
+
+		double sum = 0;
+		double density = 0;
+
+		for(int j = 0; j < 3; j++)
+		{
+			const double weight = std::max(weights[j], 0.0);
+
+			sum += weight;
+			density += weight * p_density[nodes[j]];
+		}
+
+		bestDistance = distance;
+		bestDensity = density / sum;
+
+		if(distance >= 0)
+			break;
+	}
+
+	return bestDensity;
+}
@@ -322,7 +322,7 @@ int GModel::readBDF(const std::string &name)
 int GModel::writeBDF(const std::string &name, int format, int elementTagType,
                      bool saveAll, double scalingFactor)
 {
-  FILE *fp = fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -354,6 +354,6 @@ int GModel::writeBDF(const std::string &name, int format, int elementTagType,
 
   fprintf(fp, "ENDDATA\n");
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
@@ -18,17 +18,17 @@ int GModel::writeCELUM(const std::string &name, bool saveAll,
                        double scalingFactor)
 {
   std::string namef = name + "_f";
-  FILE *fpf = fopen(namef.c_str(), "w");
+  FILE *fpf = FopenBuffered(namef.c_str(), "w");
   if(!fpf){
     Msg::Error("Unable to open file '%s'", namef.c_str());
     return 0;
   }
 
   std::string names = name + "_s";
-  FILE *fps = fopen(names.c_str(), "w");
+  FILE *fps = FopenBuffered(names.c_str(), "w");
   if(!fps){
     Msg::Error("Unable to open file '%s'", names.c_str());
-    fclose(fpf);
+    Fclose(fpf);
     return 0;
   }
 
@@ -118,7 +118,7 @@ int GModel::writeCELUM(const std::string &name, bool saveAll,
     }
   }
 
-  fclose(fpf);
-  fclose(fps);
+  Fclose(fpf);
+  Fclose(fps);
   return 1;
 }
@@ -367,7 +367,7 @@ int GModel::writeDIFF(const std::string &name, bool binary, bool saveAll,
     return 0;
   }
 
-  FILE *fp = fopen(name.c_str(), binary ? "wb" : "w");
+  FILE *fp = FopenBuffered(name.c_str(), binary ? "wb" : "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -494,6 +494,6 @@ int GModel::writeDIFF(const std::string &name, bool binary, bool saveAll,
   }
   fprintf(fp, "\n");
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
@@ -1560,7 +1560,7 @@ static bool skipVertex(GVertex *gv)
 
 int GModel::writeGEO(const std::string &name, bool printLabels, bool onlyPhysicals)
 {
-  FILE *fp = fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Could not open file '%s'", name.c_str());
     return 0;
@@ -1615,7 +1615,7 @@ int GModel::writeGEO(const std::string &name, bool printLabels, bool onlyPhysica
   if(getFields()->getBackgroundField() > 0)
     fprintf(fp, "Background Field = %i;\n", getFields()->getBackgroundField());
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
 
@@ -48,7 +48,7 @@ static std::string physicalName(GModel *m, int dim, int num)
 int GModel::writeINP(const std::string &name, bool saveAll, bool saveGroupsOfNodes,
                      double scalingFactor)
 {
-  FILE *fp = fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -135,6 +135,6 @@ int GModel::writeINP(const std::string &name, bool saveAll, bool saveGroupsOfNod
     }
   }
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
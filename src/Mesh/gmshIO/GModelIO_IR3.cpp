@@ -10,7 +10,7 @@
 int GModel::writeIR3(const std::string &name, int elementTagType,
                      bool saveAll, double scalingFactor)
 {
-  FILE *fp = fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -64,7 +64,7 @@ int GModel::writeIR3(const std::string &name, int elementTagType,
            numPhys ? (*it)->physicals[0] : 0);
   }*/
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
 
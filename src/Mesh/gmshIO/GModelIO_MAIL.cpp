@@ -12,7 +12,7 @@ int GModel::writeMAIL(const std::string &name, bool saveAll, double scalingFacto
   // CEA triangulation (.mail format) for Eric Darrigrand. Note that
   // we currently don't save the edges of the triangulation (the last
   // part of the file).
-  FILE *fp = fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -57,6 +57,6 @@ int GModel::writeMAIL(const std::string &name, bool saveAll, double scalingFacto
     }
   }
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
@@ -166,7 +166,7 @@ int GModel::readMESH(const std::string &name)
 int GModel::writeMESH(const std::string &name, int elementTagType,
                       bool saveAll, double scalingFactor)
 {
-  FILE *fp = fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -280,6 +280,6 @@ int GModel::writeMESH(const std::string &name, int elementTagType,
 
   fprintf(fp, " End\n");
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
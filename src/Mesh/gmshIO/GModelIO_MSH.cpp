@@ -477,7 +477,9 @@ int GModel::readMSH(const std::string &name)
   fclose(fp);
 
   return postpro ? 2 : 1;*/
-    return 1;
+
+  // the MSH 3 reader above is disabled, so the files are read as MSH 2 files
+  return _readMSH2(name);
 }
 
 static void writeMSHPhysicals(FILE *fp, GEntity *ge)
@@ -639,9 +641,9 @@ int GModel::writeMSH(const std::string &name, double version, bool binary,
 
   FILE *fp;
   if(multipleView)
-    fp = std::fopen(name.c_str(), binary ? "ab" : "a");
+    fp = FopenBuffered(name.c_str(), binary ? "ab" : "a");
   else
-    fp = std::fopen(name.c_str(), binary ? "wb" : "w");
+    fp = FopenBuffered(name.c_str(), binary ? "wb" : "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -737,7 +739,7 @@ int GModel::writeMSH(const std::string &name, double version, bool binary,
   //save periodic nodes
   writeMSHPeriodicNodes(fp, entities, renumber);
 
-  fclose(fp);
+  Fclose(fp);
 
   return 1;
 }
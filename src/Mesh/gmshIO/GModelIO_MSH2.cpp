@@ -10,6 +10,7 @@
 #include <sstream>
 #include <cassert>
 #include <iomanip>
+#include <algorithm>
 #include "Mesh/GMSH/GModel.h"
 #include "common/OS.h"
 #include "Mesh/GMSH/GmshDefines.h"
@@ -26,6 +27,10 @@
 #include "Mesh/GMSH/GmshMessage.h"
 #include "Mesh/GMSH/Context.h"
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 
 #define FAST_ELEMENTS 1
 
@@ -181,8 +186,607 @@ static void getDomains(int dom1Num, int dom2Num, int type,
 
 #endif
 
+// The fast reader parses the $Nodes and $Elements sections of ASCII files in
+// chunks of whole lines on several threads, and reads the blocks of binary
+// files straight from memory. The mesh vertices and the elements are then
+// created in parallel. Files that use anything that only the reader below
+// knows about (parametric nodes, parents, domains, ghost cells, polygons,
+// sparse or unordered numbering, post-processing data...) are left to it.
+
+// The smallest number of bytes that is given to a thread
+static const size_t minChunkSizeMSH2 = 1 << 20;
+
+static inline const char *skipSpacesMSH2(const char *p, const char *end)
+{
+  while(p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+  return p;
+}
+
+// true if only blanks are left before the end of the line
+static inline bool atEndOfLineMSH2(const char *&p, const char *end)
+{
+  while(p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+  if(p < end && *p != '\n') return false;
+  if(p < end) p++;
+  return true;
+}
+
+static inline bool parseIntMSH2(const char *&p, const char *end, int &value)
+{
+  while(p < end && (*p == ' ' || *p == '\t')) p++;
+  bool negative = false;
+  if(p < end && (*p == '-' || *p == '+')){
+    negative = (*p == '-');
+    p++;
+  }
+  if(p >= end || *p < '0' || *p > '9') return false;
+  long long v = 0;
+  while(p < end && *p >= '0' && *p <= '9'){
+    v = v * 10 + (*p - '0');
+    if(v > 2147483647LL) return false;
+    p++;
+  }
+  value = (int)(negative ? -v : v);
+  return true;
+}
+
+// Decimal numbers whose digits fit in 53 bits and that have a small exponent are
+// converted exactly with one multiplication or division (all of the factors are
+// exact doubles); everything else goes through strtod. The buffer must be null
+// terminated so that strtod stops at the end of the file
+static inline bool parseDoubleMSH2(const char *&p, const char *end, double &value)
+{
+  static const double powersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+    1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  while(p < end && (*p == ' ' || *p == '\t')) p++;
+  const char *start = p;
+  bool negative = false;
+  if(p < end && (*p == '-' || *p == '+')){
+    negative = (*p == '-');
+    p++;
+  }
+  unsigned long long mantissa = 0;
+  int numDigits = 0, exponent = 0;
+  bool hasDigits = false, isExact = true;
+  while(p < end && *p >= '0' && *p <= '9'){
+    hasDigits = true;
+    if(numDigits < 19){
+      mantissa = mantissa * 10 + (*p - '0');
+      if(mantissa) numDigits++;
+    }
+    else{
+      isExact = false;
+    }
+    p++;
+  }
+  if(p < end && *p == '.'){
+    p++;
+    while(p < end && *p >= '0' && *p <= '9'){
+      hasDigits = true;
+      if(numDigits < 19){
+        mantissa = mantissa * 10 + (*p - '0');
+        if(mantissa) numDigits++;
+        exponent--;
+      }
+      else if(*p != '0'){
+        isExact = false;
+      }
+      p++;
+    }
+  }
+  if(hasDigits && p < end && (*p == 'e' || *p == 'E')){
+    const char *q = p + 1;
+    int exponentValue;
+    if(parseIntMSH2(q, end, exponentValue)){
+      exponent += exponentValue;
+      p = q;
+    }
+    else{
+      isExact = false;
+    }
+  }
+  if(hasDigits && isExact && mantissa <= (1ULL << 53) &&
+     exponent >= -22 && exponent <= 22){
+    value = (double)mantissa;
+    if(exponent < 0) value /= powersOfTen[-exponent];
+    else value *= powersOfTen[exponent];
+    if(negative) value = -value;
+    return true;
+  }
+  char *stop;
+  value = strtod(start, &stop);
+  if(stop == start || stop > end) return false;
+  p = stop;
+  return true;
+}
+
+// Finds the line that starts with the given tag, for example "$EndNodes"
+static const char *findSectionEndMSH2(const char *p, const char *end, const char *tag)
+{
+  size_t length = strlen(tag);
+  while(p < end){
+    const char *q = (const char*)memchr(p, '$', end - p);
+    if(!q) return 0;
+    if((q == p || q[-1] == '\n') && (size_t)(end - q) >= length &&
+       !strncmp(q, tag, length))
+      return q;
+    p = q + 1;
+  }
+  return 0;
+}
+
+static const char *nextLineMSH2(const char *p, const char *end)
+{
+  const char *q = (const char*)memchr(p, '\n', end - p);
+  return q ? q + 1 : end;
+}
+
+// Splits a block of text into pieces that end on a line break
+static void splitLinesMSH2(const char *begin, const char *end,
+                           std::vector<const char*> &bounds)
+{
+  size_t size = end - begin;
+  int numChunks = 1;
+#if defined(_OPENMP)
+  numChunks = 4 * omp_get_max_threads();
+#endif
+  numChunks = std::max(1, std::min(numChunks, (int)(size / minChunkSizeMSH2)));
+  bounds.clear();
+  bounds.push_back(begin);
+  for(int i = 1; i < numChunks; i++){
+    const char *q = nextLineMSH2(begin + size / numChunks * i, end);
+    if(q > bounds.back() && q < end) bounds.push_back(q);
+  }
+  bounds.push_back(end);
+}
+
+// The nodes read by one thread
+struct nodeChunkMSH2 {
+  std::vector<int> tags;
+  std::vector<double> xyz;
+};
+
+// The elements read by one thread. Each element is stored as its number, MSH
+// type, physical tag, elementary tag and partition, followed by its nodes
+struct elementChunkMSH2 {
+  std::vector<int> data;
+  int numElements;
+  bool ordered;
+  elementChunkMSH2() : numElements(0), ordered(true) {}
+};
+
+// Reads the tags of an element the same way as the reader below, and returns
+// false for the tags that the fast reader does not handle
+static bool getElementTagsMSH2(double version, bool binary, int numTags,
+                               const int *tags, int &physical, int &elementary,
+                               int &partition)
+{
+  physical = (numTags > 0) ? tags[0] : 0;
+  elementary = (numTags > 1) ? tags[1] : 0;
+  partition = 0;
+  if(version < 2.2){
+    if(numTags > 3) return false; // parent
+    if(numTags > 2) partition = tags[2];
+    return true;
+  }
+  if(numTags <= 2) return true;
+  // in binary files a third tag is the parent, in ASCII files it is ignored
+  if(numTags == 3) return !binary || tags[2] == 0;
+  // one partition and no ghosts, parent or domains
+  if(numTags == 4 && tags[2] == 1){
+    partition = tags[3];
+    return true;
+  }
+  return false;
+}
+
+static void parseNodesMSH2(const char *p, const char *end, nodeChunkMSH2 &chunk,
+                           bool &failed)
+{
+  while(true){
+    p = skipSpacesMSH2(p, end);
+    if(p >= end) break;
+    int tag;
+    double xyz[3];
+    if(!parseIntMSH2(p, end, tag) || !parseDoubleMSH2(p, end, xyz[0]) ||
+       !parseDoubleMSH2(p, end, xyz[1]) || !parseDoubleMSH2(p, end, xyz[2]) ||
+       !atEndOfLineMSH2(p, end)){
+      failed = true;
+      return;
+    }
+    chunk.tags.push_back(tag);
+    chunk.xyz.insert(chunk.xyz.end(), xyz, xyz + 3);
+  }
+}
+
+static void parseElementsMSH2(const char *p, const char *end, double version,
+                              elementChunkMSH2 &chunk, bool &failed)
+{
+  int tags[8], lastNum = 0;
+  while(true){
+    p = skipSpacesMSH2(p, end);
+    if(p >= end) break;
+    int num, type, numTags, physical, elementary, partition;
+    if(!parseIntMSH2(p, end, num) || !parseIntMSH2(p, end, type) ||
+       !parseIntMSH2(p, end, numTags) || numTags < 0 || numTags > 8){
+      failed = true;
+      return;
+    }
+    for(int i = 0; i < numTags; i++){
+      if(!parseIntMSH2(p, end, tags[i])){
+        failed = true;
+        return;
+      }
+    }
+    int numVertices = MElement::getInfoMSH(type);
+    if(!numVertices || !getElementTagsMSH2(version, false, numTags, tags, physical,
+                                           elementary, partition)){
+      failed = true;
+      return;
+    }
+    int record[5] = {num, type, physical, elementary, partition};
+    chunk.data.insert(chunk.data.end(), record, record + 5);
+    for(int i = 0; i < numVertices; i++){
+      int vertex;
+      if(!parseIntMSH2(p, end, vertex)){
+        failed = true;
+        return;
+      }
+      chunk.data.push_back(vertex);
+    }
+    if(!atEndOfLineMSH2(p, end)){
+      failed = true;
+      return;
+    }
+    if(chunk.numElements && num <= lastNum) chunk.ordered = false;
+    lastNum = num;
+    chunk.numElements++;
+  }
+}
+
+int GModel::_readMSH2Fast(const std::string &name)
+{
+  FILE *fp = std::fopen(name.c_str(), "rb");
+  if(!fp){
+    Msg::Error("Unable to open file '%s'", name.c_str());
+    return 0;
+  }
+
+  // the whole file is read at once. The extra null character stops strtod
+  std::vector<char> buffer;
+  if(!fseek(fp, 0, SEEK_END)){
+    long size = ftell(fp);
+    if(size > 0){
+      buffer.resize(size + 1, '\0');
+      rewind(fp);
+      if(fread(&buffer[0], 1, size, fp) != (size_t)size) buffer.clear();
+    }
+  }
+  fclose(fp);
+  if(buffer.empty()) return -1;
+
+  const char *p = &buffer[0];
+  const char *end = p + buffer.size() - 1;
+  double version = 0.;
+  bool binary = false, hasNodes = false, hasElements = false;
+  int numVertices = 0, numElements = 0;
+  std::vector<std::pair<std::pair<int, int>, std::string> > names;
+  std::vector<nodeChunkMSH2> nodeChunks;
+  std::vector<elementChunkMSH2> elementChunks;
+  std::vector<const char*> bounds;
+
+  while(p < end){
+    if(*p != '$'){
+      p = nextLineMSH2(p, end);
+      continue;
+    }
+    const char *section = p;
+    p = nextLineMSH2(p, end);
+
+    if(!strncmp(section, "$MeshFormat", 11)){
+      int format, size;
+      if(sscanf(std::string(p, nextLineMSH2(p, end)).c_str(), "%lf %d %d",
+                &version, &format, &size) != 3) return -1;
+      // MSH 1 and MSH 3 files and binary files with swapped bytes are left to
+      // the other readers
+      if(version < 2.0 || version >= 3.0 || size != (int)sizeof(double)) return -1;
+      p = nextLineMSH2(p, end);
+      if(format){
+        int one;
+        if(end - p < (long)sizeof(int)) return -1;
+        memcpy(&one, p, sizeof(int));
+        if(one != 1) return -1;
+        binary = true;
+        p += sizeof(int);
+      }
+    }
+    else if(!strncmp(section, "$PhysicalNames", 14)){
+      // the names of MSH 2.0 files do not have a dimension
+      int numNames;
+      if(version <= 2.0 || !parseIntMSH2(p, end, numNames)) return -1;
+      p = nextLineMSH2(p, end);
+      for(int i = 0; i < numNames; i++){
+        int dim, num;
+        const char *line = nextLineMSH2(p, end);
+        if(!parseIntMSH2(p, end, dim) || !parseIntMSH2(p, end, num)) return -1;
+        std::string str(p, line);
+        std::string physicalName = ExtractDoubleQuotedString(str.c_str(), 256);
+        if(physicalName.size())
+          names.push_back(std::make_pair(std::make_pair(dim, num), physicalName));
+        p = line;
+      }
+    }
+    else if(!strncmp(section, "$Nodes", 6)){
+      if(hasNodes || !parseIntMSH2(p, end, numVertices) || numVertices < 0) return -1;
+      p = nextLineMSH2(p, end);
+      hasNodes = true;
+      if(binary){
+        const size_t recordSize = sizeof(int) + 3 * sizeof(double);
+        if((size_t)(end - p) < numVertices * recordSize) return -1;
+        nodeChunks.resize(1);
+        nodeChunks[0].tags.resize(numVertices);
+        nodeChunks[0].xyz.resize(3 * numVertices);
+        for(int i = 0; i < numVertices; i++, p += recordSize){
+          memcpy(&nodeChunks[0].tags[i], p, sizeof(int));
+          memcpy(&nodeChunks[0].xyz[3 * i], p + sizeof(int), 3 * sizeof(double));
+        }
+      }
+      else{
+        const char *sectionEnd = findSectionEndMSH2(p, end, "$EndNodes");
+        if(!sectionEnd) return -1;
+        splitLinesMSH2(p, sectionEnd, bounds);
+        nodeChunks.resize(bounds.size() - 1);
+        bool failed = false;
+#pragma omp parallel for schedule(dynamic, 1)
+        for(int i = 0; i < (int)nodeChunks.size(); i++){
+          bool chunkFailed = false;
+          parseNodesMSH2(bounds[i], bounds[i + 1], nodeChunks[i], chunkFailed);
+          if(chunkFailed){
+#pragma omp critical
+            failed = true;
+          }
+        }
+        if(failed) return -1;
+        p = sectionEnd;
+      }
+    }
+    else if(!strncmp(section, "$Elements", 9)){
+      if(hasElements || !hasNodes || !parseIntMSH2(p, end, numElements) ||
+         numElements < 0) return -1;
+      p = nextLineMSH2(p, end);
+      hasElements = true;
+      if(binary){
+        elementChunks.resize(1);
+        elementChunkMSH2 &chunk = elementChunks[0];
+        int lastNum = 0;
+        while(chunk.numElements < numElements){
+          int header[3];
+          if((size_t)(end - p) < sizeof(header)) return -1;
+          memcpy(header, p, sizeof(header));
+          p += sizeof(header);
+          int type = header[0], numElms = header[1], numTags = header[2];
+          int numNodes = MElement::getInfoMSH(type);
+          if(!numNodes || numElms < 0 || numTags < 0 || numTags > 8 ||
+             numElms > numElements - chunk.numElements) return -1;
+          size_t n = 1 + numTags + numNodes;
+          if((size_t)(end - p) < numElms * n * sizeof(int)) return -1;
+          std::vector<int> data(n);
+          for(int i = 0; i < numElms; i++, p += n * sizeof(int)){
+            memcpy(&data[0], p, n * sizeof(int));
+            int physical, elementary, partition;
+            if(!getElementTagsMSH2(version, true, numTags, &data[1], physical,
+                                   elementary, partition)) return -1;
+            int record[5] = {data[0], type, physical, elementary, partition};
+            chunk.data.insert(chunk.data.end(), record, record + 5);
+            chunk.data.insert(chunk.data.end(), data.begin() + 1 + numTags, data.end());
+            if(chunk.numElements && data[0] <= lastNum) chunk.ordered = false;
+            lastNum = data[0];
+            chunk.numElements++;
+          }
+        }
+      }
+      else{
+        const char *sectionEnd = findSectionEndMSH2(p, end, "$EndElements");
+        if(!sectionEnd) return -1;
+        splitLinesMSH2(p, sectionEnd, bounds);
+        elementChunks.resize(bounds.size() - 1);
+        bool failed = false;
+#pragma omp parallel for schedule(dynamic, 1)
+        for(int i = 0; i < (int)elementChunks.size(); i++){
+          bool chunkFailed = false;
+          parseElementsMSH2(bounds[i], bounds[i + 1], version, elementChunks[i],
+                            chunkFailed);
+          if(chunkFailed){
+#pragma omp critical
+            failed = true;
+          }
+        }
+        if(failed) return -1;
+        p = sectionEnd;
+      }
+    }
+    else if(!strncmp(section, "$End", 4)){
+      continue;
+    }
+    else if(!strncmp(section, "$Comments", 9)){
+      p = findSectionEndMSH2(p, end, "$EndComments");
+      if(!p) return -1;
+    }
+    else{
+      // $ParametricNodes, $Periodic, $NodeData, $ElementData, MSH 1 sections...
+      return -1;
+    }
+  }
+
+  if(version == 0. || !hasNodes || !hasElements) return -1;
+
+  // the vertex numbering must be dense, as written by Gmsh, and the element
+  // numbers must increase so that the elements end up in the same order as
+  // with the reader below
+  int minVertex = numVertices + 1, maxVertex = -1, numRead = 0;
+  for(unsigned int i = 0; i < nodeChunks.size(); i++){
+    for(unsigned int j = 0; j < nodeChunks[i].tags.size(); j++){
+      minVertex = std::min(minVertex, nodeChunks[i].tags[j]);
+      maxVertex = std::max(maxVertex, nodeChunks[i].tags[j]);
+    }
+    numRead += nodeChunks[i].tags.size();
+  }
+  if(numRead != numVertices) return -1;
+  if(numVertices && !((minVertex == 1 && maxVertex == numVertices) ||
+                      (minVertex == 0 && maxVertex == numVertices - 1))) return -1;
+  std::vector<char> isUsed(numVertices + 1, 0);
+  for(unsigned int i = 0; i < nodeChunks.size(); i++){
+    for(unsigned int j = 0; j < nodeChunks[i].tags.size(); j++){
+      if(isUsed[nodeChunks[i].tags[j]]) return -1;
+      isUsed[nodeChunks[i].tags[j]] = 1;
+    }
+  }
+
+  numRead = 0;
+  int lastNum = 0;
+  for(unsigned int i = 0; i < elementChunks.size(); i++){
+    const elementChunkMSH2 &chunk = elementChunks[i];
+    if(!chunk.numElements) continue;
+    if(!chunk.ordered || (numRead && chunk.data[0] <= lastNum)) return -1;
+    size_t position = 0;
+    for(int j = 0; j < chunk.numElements; j++){
+      int n = MElement::getInfoMSH(chunk.data[position + 1]);
+      for(int k = 0; k < n; k++){
+        int vertex = chunk.data[position + 5 + k];
+        if(vertex < minVertex || vertex > maxVertex) return -1;
+      }
+      lastNum = chunk.data[position];
+      position += 5 + n;
+    }
+    numRead += chunk.numElements;
+  }
+  if(numRead != numElements) return -1;
+
+  // nothing has been changed in the model up to here
+  Msg::Info("%d vertices", numVertices);
+  Msg::Info("%d elements", numElements);
+
+  for(unsigned int i = 0; i < names.size(); i++)
+    setPhysicalName(names[i].second, names[i].first.first, names[i].first.second);
+
+  std::vector<MVertex*> vertexVector(numVertices + 1, (MVertex*)0);
+
+#pragma omp parallel for schedule(dynamic, 1)
+  for(int i = 0; i < (int)nodeChunks.size(); i++){
+    nodeChunkMSH2 &chunk = nodeChunks[i];
+    for(unsigned int j = 0; j < chunk.tags.size(); j++)
+      vertexVector[chunk.tags[j]] =
+        new MVertex(chunk.xyz[3 * j], chunk.xyz[3 * j + 1], chunk.xyz[3 * j + 2],
+                    0, chunk.tags[j]);
+    std::vector<int>().swap(chunk.tags);
+    std::vector<double>().swap(chunk.xyz);
+  }
+
+  std::vector<std::vector<MElement*> > createdElements(elementChunks.size());
+  bool failed = false;
+
+#pragma omp parallel for schedule(dynamic, 1)
+  for(int i = 0; i < (int)elementChunks.size(); i++){
+    const elementChunkMSH2 &chunk = elementChunks[i];
+    MElementFactory factory;
+    std::vector<MVertex*> vertices;
+    size_t position = 0;
+    createdElements[i].resize(chunk.numElements, (MElement*)0);
+    for(int j = 0; j < chunk.numElements; j++){
+      const int *record = &chunk.data[position];
+      int n = MElement::getInfoMSH(record[1]);
+      position += 5 + n;
+      if(CTX::instance()->mesh.ignorePartBound && record[3] < 0) continue;
+      vertices.resize(n);
+      for(int k = 0; k < n; k++) vertices[k] = vertexVector[record[5 + k]];
+      createdElements[i][j] = factory.create(record[1], vertices, record[0], record[4]);
+      if(!createdElements[i][j]){
+#pragma omp critical
+        failed = true;
+      }
+    }
+  }
+  if(failed) Msg::Error("Unknown type of element in file '%s'", name.c_str());
+
+  // the elements are stored by type and elementary entity. The vectors are
+  // sized before they are filled
+  std::map<int, std::vector<MElement*> > elements[10];
+  std::map<int, std::map<int, std::string> > physicals[4];
+  for(int pass = 0; pass < 2; pass++){
+    std::map<std::pair<int, int>, size_t> sizes;
+    std::map<std::pair<int, int>, size_t>::iterator lastSize = sizes.end();
+    int lastDim = -1, lastReg = 0, lastPhysical = 0;
+    for(unsigned int i = 0; i < elementChunks.size(); i++){
+      const elementChunkMSH2 &chunk = elementChunks[i];
+      size_t position = 0;
+      for(int j = 0; j < chunk.numElements; j++){
+        const int *record = &chunk.data[position];
+        MElement *e = createdElements[i][j];
+        position += 5 + MElement::getInfoMSH(record[1]);
+        if(!e) continue;
+        int physical = record[2], reg = record[3];
+        if(CTX::instance()->mesh.switchElementTags) std::swap(physical, reg);
+        int index;
+        switch(e->getType()){
+        case TYPE_PNT : index = 0; break;
+        case TYPE_LIN : index = 1; break;
+        case TYPE_TRI : index = 2; break;
+        case TYPE_QUA : index = 3; break;
+        case TYPE_TET : index = 4; break;
+        case TYPE_HEX : index = 5; break;
+        case TYPE_PRI : index = 6; break;
+        case TYPE_PYR : index = 7; break;
+        case TYPE_POLYG : index = 8; break;
+        case TYPE_POLYH : index = 9; break;
+        default : index = -1; break;
+        }
+        if(index < 0) continue;
+        if(pass == 0){
+          if(lastSize == sizes.end() || lastSize->first != std::make_pair(index, reg))
+            lastSize = sizes.insert(std::make_pair(std::make_pair(index, reg), 0)).first;
+          lastSize->second++;
+          continue;
+        }
+        elements[index][reg].push_back(e);
+        int dim = e->getDim();
+        if(physical && (dim != lastDim || reg != lastReg || physical != lastPhysical)){
+          if(!physicals[dim][reg].count(physical))
+            physicals[dim][reg][physical] = "unnamed";
+          lastDim = dim;
+          lastReg = reg;
+          lastPhysical = physical;
+        }
+        if(record[4]) meshPartitions.insert(record[4]);
+      }
+    }
+    if(pass == 0){
+      for(lastSize = sizes.begin(); lastSize != sizes.end(); ++lastSize)
+        elements[lastSize->first.first][lastSize->first.second].reserve(lastSize->second);
+    }
+  }
+
+  for(int i = 0; i < (int)(sizeof(elements) / sizeof(elements[0])); i++)
+    _storeElementsInEntities(elements[i]);
+  _associateEntityWithMeshVertices();
+  _storeVerticesInEntities(vertexVector);
+  for(int i = 0; i < 4; i++)
+    _storePhysicalTagsInEntities(i, physicals[i]);
+  _createGeometryOfDiscreteEntities();
+
+  if(!CTX::instance()->mesh.ignorePeriodicity) alignPeriodicBoundaries();
+
+  return 1;
+}
+
 int GModel::_readMSH2(const std::string &name)
 {
+  // most files are read by the fast reader, which gives up (and returns -1)
+  // before it changes the model if the file uses something it does not handle
+  int status = _readMSH2Fast(name);
+  if(status >= 0) return status;
+
   FILE *fp = std::fopen(name.c_str(), "rb");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
@@ -873,6 +1477,218 @@ static int getNumElementsMSH(GModel *m, bool saveAll, int saveSinglePartition)
   return n;
 }
 
+// The fast writer formats the nodes and the elements in chunks on several
+// threads and writes the chunks in order. In binary files the elements of a
+// chunk are written in blocks of elements of the same type, instead of one
+// block per element. It is used for the elements when none of them has a
+// parent, a domain, ghost cells or a partition to save on its own.
+
+// The number of nodes or elements that are formatted by a thread at once
+static const size_t chunkSizeMSH2 = 1 << 14;
+
+static inline void appendIntMSH2(std::string &buffer, int value)
+{
+  char digits[12];
+  int n = 0;
+  unsigned int v = (value < 0) ? -(unsigned int)value : value;
+  do {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while(v);
+  if(value < 0) buffer.push_back('-');
+  while(n) buffer.push_back(digits[--n]);
+}
+
+static inline void appendDoubleMSH2(std::string &buffer, double value)
+{
+  char str[32];
+  int n = snprintf(str, sizeof(str), "%.16g", value);
+  buffer.append(str, n);
+}
+
+template<class T>
+static inline void appendBinaryMSH2(std::string &buffer, const T *data, size_t n)
+{
+  buffer.append((const char*)data, n * sizeof(T));
+}
+
+// Formats the items [0, numItems) in chunks, on several threads, and writes the
+// chunks to the file in order. Only a few chunks are kept in memory at once
+template<class F>
+static void writeChunksMSH2(FILE *fp, size_t numItems, F format)
+{
+  int numThreads = 1;
+#if defined(_OPENMP)
+  numThreads = omp_get_max_threads();
+#endif
+  std::vector<std::string> buffers(2 * numThreads);
+  const size_t itemsPerPass = chunkSizeMSH2 * buffers.size();
+
+  for(size_t first = 0; first < numItems; first += itemsPerPass){
+    int numChunks = (int)((std::min(itemsPerPass, numItems - first) +
+                           chunkSizeMSH2 - 1) / chunkSizeMSH2);
+#pragma omp parallel for schedule(dynamic, 1)
+    for(int i = 0; i < numChunks; i++){
+      size_t begin = first + i * chunkSizeMSH2;
+      size_t end = std::min(begin + chunkSizeMSH2, numItems);
+      buffers[i].clear();
+      format(buffers[i], begin, end);
+    }
+    for(int i = 0; i < numChunks; i++)
+      fwrite(buffers[i].data(), 1, buffers[i].size(), fp);
+  }
+}
+
+static void writeNodesMSH2Fast(FILE *fp, std::vector<GEntity*> &entities,
+                               bool binary, double scalingFactor)
+{
+  std::vector<MVertex*> vertices;
+  for(unsigned int i = 0; i < entities.size(); i++)
+    for(unsigned int j = 0; j < entities[i]->mesh_vertices.size(); j++)
+      if(entities[i]->mesh_vertices[j]->getIndex() >= 0)
+        vertices.push_back(entities[i]->mesh_vertices[j]);
+
+  writeChunksMSH2(fp, vertices.size(), [&](std::string &buffer, size_t begin, size_t end){
+    buffer.reserve((end - begin) * (binary ? 28 : 72));
+    for(size_t i = begin; i < end; i++){
+      MVertex *v = vertices[i];
+      int index = v->getIndex();
+      double xyz[3] = {v->x() * scalingFactor, v->y() * scalingFactor,
+                       v->z() * scalingFactor};
+      if(binary){
+        appendBinaryMSH2(buffer, &index, 1);
+        appendBinaryMSH2(buffer, xyz, 3);
+      }
+      else{
+        appendIntMSH2(buffer, index);
+        for(int k = 0; k < 3; k++){
+          buffer.push_back(' ');
+          appendDoubleMSH2(buffer, xyz[k]);
+        }
+        buffer.push_back('\n');
+      }
+    }
+  });
+}
+
+// One element that is written, with the tags of its entity
+struct elementItemMSH2 {
+  MElement *element;
+  int elementary;
+  const std::vector<int> *physicals;
+};
+
+template<class T>
+static bool addElementItemsMSH2(std::vector<elementItemMSH2> &items,
+                                std::vector<T*> &elements, GEntity *ge)
+{
+  for(unsigned int i = 0; i < elements.size(); i++){
+    MElement *e = elements[i];
+    int type = e->getTypeForMSH();
+    if(!type || type == MSH_POLYG_ || type == MSH_POLYH_ || type == MSH_POLYG_B ||
+       type == MSH_TRI_B || type == MSH_LIN_B || type == MSH_LIN_C ||
+       e->getParent() || e->getDomain(0))
+      return false;
+    elementItemMSH2 item = {e, ge->tag(), &ge->physicals};
+    items.push_back(item);
+  }
+  return true;
+}
+
+// Lists the elements in the order of the writer below, or returns false if one
+// of them needs the writer below
+static bool getElementItemsMSH2(GModel *m, std::vector<elementItemMSH2> &items)
+{
+  if(m->getGhostCells().size() || CTX::instance()->mesh.preserveNumberingMsh2)
+    return false;
+  for(GModel::fiter it = m->firstFace(); it != m->lastFace(); ++it)
+    if((*it)->polygons.size()) return false;
+  for(GModel::viter it = m->firstVertex(); it != m->lastVertex(); ++it)
+    if(!addElementItemsMSH2(items, (*it)->points, *it)) return false;
+  for(GModel::eiter it = m->firstEdge(); it != m->lastEdge(); ++it)
+    if(!addElementItemsMSH2(items, (*it)->lines, *it)) return false;
+  for(GModel::fiter it = m->firstFace(); it != m->lastFace(); ++it)
+    if(!addElementItemsMSH2(items, (*it)->triangles, *it)) return false;
+  for(GModel::fiter it = m->firstFace(); it != m->lastFace(); ++it)
+    if(!addElementItemsMSH2(items, (*it)->quadrangles, *it)) return false;
+  return true;
+}
+
+static void writeElementsMSH2Fast(FILE *fp, std::vector<elementItemMSH2> &items,
+                                  bool saveAll, bool binary, int &num)
+{
+  // the number of the first line of each element, which is written once for
+  // each physical group of its entity
+  std::vector<int> firstNum(items.size());
+  for(unsigned int i = 0; i < items.size(); i++){
+    firstNum[i] = num + 1;
+    num += saveAll ? 1 : items[i].physicals->size();
+  }
+
+  writeChunksMSH2(fp, items.size(), [&](std::string &buffer, size_t begin, size_t end){
+    std::vector<int> verts, block;
+    int blockType = 0, blockTags = 0, blockCount = 0;
+    for(size_t i = begin; i < end; i++){
+      MElement *e = items[i].element;
+      int type = e->getTypeForMSH();
+      int partition = e->getPartition();
+      int numTags = partition ? 4 : 2;
+      int n = saveAll ? 1 : items[i].physicals->size();
+      for(int j = 0; j < n; j++){
+        int physical = saveAll ? 0 : (*items[i].physicals)[j];
+        if(physical < 0) e->reverse();
+        e->getVerticesIdForMSH(verts);
+        if(physical < 0) e->reverse();
+        if(!binary){
+          appendIntMSH2(buffer, firstNum[i] + j);
+          buffer.push_back(' ');
+          appendIntMSH2(buffer, type);
+          buffer.push_back(' ');
+          appendIntMSH2(buffer, numTags);
+          buffer.push_back(' ');
+          appendIntMSH2(buffer, abs(physical));
+          buffer.push_back(' ');
+          appendIntMSH2(buffer, items[i].elementary);
+          if(partition){
+            buffer.append(" 1 ");
+            appendIntMSH2(buffer, partition);
+          }
+          for(unsigned int k = 0; k < verts.size(); k++){
+            buffer.push_back(' ');
+            appendIntMSH2(buffer, verts[k]);
+          }
+          buffer.push_back('\n');
+        }
+        else{
+          if(blockCount && (type != blockType || numTags != blockTags)){
+            int header[3] = {blockType, blockCount, blockTags};
+            appendBinaryMSH2(buffer, header, 3);
+            appendBinaryMSH2(buffer, &block[0], block.size());
+            block.clear();
+            blockCount = 0;
+          }
+          blockType = type;
+          blockTags = numTags;
+          blockCount++;
+          block.push_back(firstNum[i] + j);
+          block.push_back(abs(physical));
+          block.push_back(items[i].elementary);
+          if(partition){
+            block.push_back(1);
+            block.push_back(partition);
+          }
+          block.insert(block.end(), verts.begin(), verts.end());
+        }
+      }
+    }
+    if(blockCount){
+      int header[3] = {blockType, blockCount, blockTags};
+      appendBinaryMSH2(buffer, header, 3);
+      appendBinaryMSH2(buffer, &block[0], block.size());
+    }
+  });
+}
+
 int GModel::_writeMSH2(const std::string &name, double version, bool binary,
                        bool saveAll, bool saveParametric, double scalingFactor,
                        int elementStartNum, int saveSinglePartition, bool multipleView,
@@ -880,9 +1696,9 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
 {
   FILE *fp;
   if(multipleView)
-    fp = std::fopen(name.c_str(), binary ? "ab" : "a");
+    fp = FopenBuffered(name.c_str(), binary ? "ab" : "a");
   else
-    fp = std::fopen(name.c_str(), binary ? "wb" : "w");
+    fp = FopenBuffered(name.c_str(), binary ? "wb" : "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -942,10 +1758,14 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
 
   std::vector<GEntity*> entities;
   getEntities(entities);
-  for(unsigned int i = 0; i < entities.size(); i++)
-    for(unsigned int j = 0; j < entities[i]->mesh_vertices.size(); j++)
-      entities[i]->mesh_vertices[j]->writeMSH2(fp, binary, saveParametric,
-                                               scalingFactor);
+  if(saveParametric){
+    for(unsigned int i = 0; i < entities.size(); i++)
+      for(unsigned int j = 0; j < entities[i]->mesh_vertices.size(); j++)
+        entities[i]->mesh_vertices[j]->writeMSH2(fp, binary, saveParametric,
+                                                 scalingFactor);
+  }
+  else
+    writeNodesMSH2Fast(fp, entities, binary, scalingFactor);
 
   if(binary) fprintf(fp, "\n");
 
@@ -966,113 +1786,121 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
 
   _elementIndexCache.clear();
 
-  //parents
-  if (!CTX::instance()->mesh.saveTri){
-   for(viter it = firstVertex(); it != lastVertex(); ++it)
-     for(unsigned int i = 0; i < (*it)->points.size(); i++)
-       if((*it)->points[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->points[i]->getParent(),
-                         saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
-   for(eiter it = firstEdge(); it != lastEdge(); ++it)
-     for(unsigned int i = 0; i < (*it)->lines.size(); i++)
-       if((*it)->lines[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->lines[i]->getParent(),
-                         saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
-   for(fiter it = firstFace(); it != lastFace(); ++it)
-     for(unsigned int i = 0; i < (*it)->triangles.size(); i++)
-       if((*it)->triangles[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->triangles[i]->getParent(),
-                         saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
-  /* for(riter it = firstRegion(); it != lastRegion(); ++it)
-     for(unsigned int i = 0; i < (*it)->tetrahedra.size(); i++)
-       if((*it)->tetrahedra[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->tetrahedra[i]->getParent(),
-                         saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);*/
-   for(fiter it = firstFace(); it != lastFace(); ++it)
-     for(unsigned int i = 0; i < (*it)->polygons.size(); i++)
-       if((*it)->polygons[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->polygons[i]->getParent(),
-                         saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
-  /* for(riter it = firstRegion(); it != lastRegion(); ++it)
-     for(unsigned int i = 0; i < (*it)->polyhedra.size(); i++)
-       if((*it)->polyhedra[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->polyhedra[i]->getParent(),
-                         saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);*/
+  // the element index cache is only needed by the elements that have a parent
+  // or a domain, which are left to the writer below
+  std::vector<elementItemMSH2> items;
+  if(version >= 2.0 && !saveSinglePartition && getElementItemsMSH2(this, items)){
+    writeElementsMSH2Fast(fp, items, saveAll, binary, num);
   }
-  // points
-  for(viter it = firstVertex(); it != lastVertex(); ++it)
-    writeElementsMSH(fp, this, (*it)->points, saveAll, saveSinglePartition,
-                     version, binary, num, (*it)->tag(), (*it)->physicals);
-  // lines
-  for(eiter it = firstEdge(); it != lastEdge(); ++it)
-    writeElementsMSH(fp, this, (*it)->lines, saveAll, saveSinglePartition,
-                     version, binary, num, (*it)->tag(), (*it)->physicals);
-  // triangles
-  for(fiter it = firstFace(); it != lastFace(); ++it)
-    writeElementsMSH(fp, this, (*it)->triangles, saveAll, saveSinglePartition,
-                     version, binary, num, (*it)->tag(), (*it)->physicals);
-
-  // quads
-  for(fiter it = firstFace(); it != lastFace(); ++it)
-    writeElementsMSH(fp, this, (*it)->quadrangles, saveAll, saveSinglePartition,
-                     version, binary, num, (*it)->tag(), (*it)->physicals);
-  // polygons
-  for(fiter it = firstFace(); it != lastFace(); it++)
-    writeElementsMSH(fp, this, (*it)->polygons, saveAll, saveSinglePartition,
-                     version, binary, num, (*it)->tag(), (*it)->physicals);
-  // tets
- // for(riter it = firstRegion(); it != lastRegion(); ++it)
-  //  writeElementsMSH(fp, this, (*it)->tetrahedra, saveAll, saveSinglePartition,
-  //                   version, binary, num, (*it)->tag(), (*it)->physicals);
-
-  // hexas
-//  for(riter it = firstRegion(); it != lastRegion(); ++it)
- //   writeElementsMSH(fp, this, (*it)->hexahedra, saveAll, saveSinglePartition,
- //                    version, binary, num, (*it)->tag(), (*it)->physicals);
-
-  // prisms
- // for(riter it = firstRegion(); it != lastRegion(); ++it)
-//    writeElementsMSH(fp, this, (*it)->prisms, saveAll, saveSinglePartition,
- //                    version, binary, num, (*it)->tag(), (*it)->physicals);
-
-  // pyramids
- // for(riter it = firstRegion(); it != lastRegion(); ++it)
- //   writeElementsMSH(fp, this, (*it)->pyramids, saveAll, saveSinglePartition,
- //                    version, binary, num, (*it)->tag(), (*it)->physicals);
-
-  // polyhedra
-//  for(riter it = firstRegion(); it != lastRegion(); ++it)
- //   writeElementsMSH(fp, this, (*it)->polyhedra, saveAll, saveSinglePartition,
- //                    version, binary, num, (*it)->tag(), (*it)->physicals);
-
-  // level set faces
-  for(fiter it = firstFace(); it != lastFace(); ++it) {
-    for(unsigned int i = 0; i < (*it)->triangles.size(); i++) {
-      MTriangle *t = (*it)->triangles[i];
-      if(t->getDomain(0))
-        writeElementMSH(fp, this, t, saveAll, version, binary, num,
-                        (*it)->tag(), (*it)->physicals, 0,
-                        getMeshElementIndex(t->getDomain(0)),
-                        getMeshElementIndex(t->getDomain(1)));
+  else{
+    //parents
+    if (!CTX::instance()->mesh.saveTri){
+     for(viter it = firstVertex(); it != lastVertex(); ++it)
+       for(unsigned int i = 0; i < (*it)->points.size(); i++)
+         if((*it)->points[i]->ownsParent())
+           writeElementMSH(fp, this, (*it)->points[i]->getParent(),
+                           saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
+     for(eiter it = firstEdge(); it != lastEdge(); ++it)
+       for(unsigned int i = 0; i < (*it)->lines.size(); i++)
+         if((*it)->lines[i]->ownsParent())
+           writeElementMSH(fp, this, (*it)->lines[i]->getParent(),
+                           saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
+     for(fiter it = firstFace(); it != lastFace(); ++it)
+       for(unsigned int i = 0; i < (*it)->triangles.size(); i++)
+         if((*it)->triangles[i]->ownsParent())
+           writeElementMSH(fp, this, (*it)->triangles[i]->getParent(),
+                           saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
+    /* for(riter it = firstRegion(); it != lastRegion(); ++it)
+       for(unsigned int i = 0; i < (*it)->tetrahedra.size(); i++)
+         if((*it)->tetrahedra[i]->ownsParent())
+           writeElementMSH(fp, this, (*it)->tetrahedra[i]->getParent(),
+                           saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);*/
+     for(fiter it = firstFace(); it != lastFace(); ++it)
+       for(unsigned int i = 0; i < (*it)->polygons.size(); i++)
+         if((*it)->polygons[i]->ownsParent())
+           writeElementMSH(fp, this, (*it)->polygons[i]->getParent(),
+                           saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
+    /* for(riter it = firstRegion(); it != lastRegion(); ++it)
+       for(unsigned int i = 0; i < (*it)->polyhedra.size(); i++)
+         if((*it)->polyhedra[i]->ownsParent())
+           writeElementMSH(fp, this, (*it)->polyhedra[i]->getParent(),
+                           saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);*/
     }
-    for(unsigned int i = 0; i < (*it)->polygons.size(); i++) {
-      MPolygon *p = (*it)->polygons[i];
-      if(p->getDomain(0))
-        writeElementMSH(fp, this, p, saveAll, version, binary, num,
-                        (*it)->tag(), (*it)->physicals, 0,
-                        getMeshElementIndex(p->getDomain(0)),
-                        getMeshElementIndex(p->getDomain(1)));
+    // points
+    for(viter it = firstVertex(); it != lastVertex(); ++it)
+      writeElementsMSH(fp, this, (*it)->points, saveAll, saveSinglePartition,
+                       version, binary, num, (*it)->tag(), (*it)->physicals);
+    // lines
+    for(eiter it = firstEdge(); it != lastEdge(); ++it)
+      writeElementsMSH(fp, this, (*it)->lines, saveAll, saveSinglePartition,
+                       version, binary, num, (*it)->tag(), (*it)->physicals);
+    // triangles
+    for(fiter it = firstFace(); it != lastFace(); ++it)
+      writeElementsMSH(fp, this, (*it)->triangles, saveAll, saveSinglePartition,
+                       version, binary, num, (*it)->tag(), (*it)->physicals);
+
+    // quads
+    for(fiter it = firstFace(); it != lastFace(); ++it)
+      writeElementsMSH(fp, this, (*it)->quadrangles, saveAll, saveSinglePartition,
+                       version, binary, num, (*it)->tag(), (*it)->physicals);
+    // polygons
+    for(fiter it = firstFace(); it != lastFace(); it++)
+      writeElementsMSH(fp, this, (*it)->polygons, saveAll, saveSinglePartition,
+                       version, binary, num, (*it)->tag(), (*it)->physicals);
+    // tets
+   // for(riter it = firstRegion(); it != lastRegion(); ++it)
+    //  writeElementsMSH(fp, this, (*it)->tetrahedra, saveAll, saveSinglePartition,
+    //                   version, binary, num, (*it)->tag(), (*it)->physicals);
+
+    // hexas
+  //  for(riter it = firstRegion(); it != lastRegion(); ++it)
+   //   writeElementsMSH(fp, this, (*it)->hexahedra, saveAll, saveSinglePartition,
+   //                    version, binary, num, (*it)->tag(), (*it)->physicals);
+
+    // prisms
+   // for(riter it = firstRegion(); it != lastRegion(); ++it)
+  //    writeElementsMSH(fp, this, (*it)->prisms, saveAll, saveSinglePartition,
+   //                    version, binary, num, (*it)->tag(), (*it)->physicals);
+
+    // pyramids
+   // for(riter it = firstRegion(); it != lastRegion(); ++it)
+   //   writeElementsMSH(fp, this, (*it)->pyramids, saveAll, saveSinglePartition,
+   //                    version, binary, num, (*it)->tag(), (*it)->physicals);
+
+    // polyhedra
+  //  for(riter it = firstRegion(); it != lastRegion(); ++it)
+   //   writeElementsMSH(fp, this, (*it)->polyhedra, saveAll, saveSinglePartition,
+   //                    version, binary, num, (*it)->tag(), (*it)->physicals);
+
+    // level set faces
+    for(fiter it = firstFace(); it != lastFace(); ++it) {
+      for(unsigned int i = 0; i < (*it)->triangles.size(); i++) {
+        MTriangle *t = (*it)->triangles[i];
+        if(t->getDomain(0))
+          writeElementMSH(fp, this, t, saveAll, version, binary, num,
+                          (*it)->tag(), (*it)->physicals, 0,
+                          getMeshElementIndex(t->getDomain(0)),
+                          getMeshElementIndex(t->getDomain(1)));
+      }
+      for(unsigned int i = 0; i < (*it)->polygons.size(); i++) {
+        MPolygon *p = (*it)->polygons[i];
+        if(p->getDomain(0))
+          writeElementMSH(fp, this, p, saveAll, version, binary, num,
+                          (*it)->tag(), (*it)->physicals, 0,
+                          getMeshElementIndex(p->getDomain(0)),
+                          getMeshElementIndex(p->getDomain(1)));
+      }
     }
-  }
-  //level set lines
-  for(eiter it = firstEdge(); it != lastEdge(); ++it) {
-    for(unsigned int i = 0; i < (*it)->lines.size(); i++) {
-      MLine *l = (*it)->lines[i];
-      if(l->getDomain(0))
-        writeElementMSH(fp, this, l, saveAll, version, binary, num,
-                        (*it)->tag(), (*it)->physicals, 0,
-                        getMeshElementIndex(l->getDomain(0)),
-                        getMeshElementIndex(l->getDomain(1)));
+    //level set lines
+    for(eiter it = firstEdge(); it != lastEdge(); ++it) {
+      for(unsigned int i = 0; i < (*it)->lines.size(); i++) {
+        MLine *l = (*it)->lines[i];
+        if(l->getDomain(0))
+          writeElementMSH(fp, this, l, saveAll, version, binary, num,
+                          (*it)->tag(), (*it)->physicals, 0,
+                          getMeshElementIndex(l->getDomain(0)),
+                          getMeshElementIndex(l->getDomain(1)));
+      }
     }
   }
 
@@ -1087,7 +1915,7 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
 
   writeMSHPeriodicNodes (fp, entities, renumberVertices);
 
-  fclose(fp);
+  Fclose(fp);
 
   return 1;
 }
@@ -110,7 +110,7 @@ int GModel::readP3D(const std::string &name)
 
 int GModel::writeP3D(const std::string &name, bool saveAll, double scalingFactor)
 {
-  FILE *fp = fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -133,7 +133,7 @@ int GModel::writeP3D(const std::string &name, bool saveAll, double scalingFactor
 
   if(faces.empty() && regions.empty()){
     Msg::Warning("No structured grids to save");
-    fclose(fp);
+    Fclose(fp);
     return 0;
   }
 
@@ -182,7 +182,7 @@ int GModel::writeP3D(const std::string &name, bool saveAll, double scalingFactor
     }
   }*/
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
 
@@ -239,7 +239,7 @@ int GModel::readPLY2(const std::string &name)
 
 int GModel::writePLY2(const std::string &name)
 {
-  FILE *fp = Fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -265,7 +265,7 @@ int GModel::writePLY2(const std::string &name)
         (*it)->triangles[i]->writePLY2(fp);
   }
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
 
@@ -186,7 +186,7 @@ int GModel::readSTL(const std::string &name, double tolerance)
 int GModel::writeSTL(const std::string &name, bool binary, bool saveAll,
                      double scalingFactor)
 {
-  FILE *fp = Fopen(name.c_str(), binary ? "wb" : "w");
+  FILE *fp = FopenBuffered(name.c_str(), binary ? "wb" : "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -222,7 +222,7 @@ int GModel::writeSTL(const std::string &name, bool binary, bool saveAll,
   if(!binary)
     fprintf(fp, "endsolid Created by Gmsh\n");
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
 
@@ -25,7 +25,7 @@ static std::string physicalName(GModel *m, int dim, int num)
 
 int GModel::writeSU2(const std::string &name, bool saveAll, double scalingFactor)
 {
-  FILE *fp = Fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -34,7 +34,7 @@ int GModel::writeSU2(const std::string &name, bool saveAll, double scalingFactor
   int ndime = getDim();
   if(ndime != 2 && ndime != 3){
     Msg::Error("SU2 mesh output valid only for 2D or 3D models (not %dD)", ndime);
-    fclose(fp);
+    Fclose(fp);
     return 0;
   }
 
@@ -104,6 +104,6 @@ int GModel::writeSU2(const std::string &name, bool saveAll, double scalingFactor
     }
   }
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
@@ -48,7 +48,7 @@ static std::string physicalName(GModel *m, int dim, int num)
 int GModel::writeTOCHNOG(const std::string &name, bool saveAll, bool saveGroupsOfNodes,
                          double scalingFactor)
 {
-  FILE *fp = Fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -179,6 +179,6 @@ int GModel::writeTOCHNOG(const std::string &name, bool saveAll, bool saveGroupsO
     }
   }
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
@@ -179,7 +179,7 @@ static std::string physicalName(GModel *m, int dim, int num)
 int GModel::writeUNV(const std::string &name, bool saveAll, bool saveGroupsOfNodes,
                      double scalingFactor)
 {
-  FILE *fp = Fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -276,6 +276,6 @@ int GModel::writeUNV(const std::string &name, bool saveAll, bool saveGroupsOfNod
   }
   fprintf(fp, "%6d\n", -1);
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
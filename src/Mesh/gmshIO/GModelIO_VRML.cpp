@@ -190,7 +190,7 @@ int GModel::readVRML(const std::string &name)
 
 int GModel::writeVRML(const std::string &name, bool saveAll, double scalingFactor)
 {
-  FILE *fp = fopen(name.c_str(), "w");
+  FILE *fp = FopenBuffered(name.c_str(), "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -242,6 +242,6 @@ int GModel::writeVRML(const std::string &name, bool saveAll, double scalingFacto
     }
   }
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
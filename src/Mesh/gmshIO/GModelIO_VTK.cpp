@@ -18,7 +18,7 @@
 int GModel::writeVTK(const std::string &name, bool binary, bool saveAll,
                      double scalingFactor, bool bigEndian)
 {
-  FILE *fp = fopen(name.c_str(), binary ? "wb" : "w");
+  FILE *fp = FopenBuffered(name.c_str(), binary ? "wb" : "w");
   if(!fp){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
@@ -100,7 +100,7 @@ int GModel::writeVTK(const std::string &name, bool binary, bool saveAll,
     }
   }
 
-  fclose(fp);
+  Fclose(fp);
   return 1;
 }
 
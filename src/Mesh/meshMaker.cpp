@@ -1,246 +1,28 @@
 #include <Mesh/meshMaker.h>
 
-closedPath meshMaker::findContour(edgeLineShape *startingEdge, rectangleShape *point)
+void meshMaker::findContours()
 {
-	closedPath foundPath;
-	std::vector<closedPath> pathsVector;
+	planarGraph geometryGraph;
 	
-	// Find the first line segment that is not visited
-	if(startingEdge == nullptr)
-	{
-		bool lineIsFound = false; // Boolean used to indicate if a line or arc was found.
-		for(plf::colony<edgeLineShape>::iterator lineIterator = p_lineList->begin(); lineIterator != p_lineList->end(); lineIterator++)
-		{
-			if(!lineIterator->getVisitedStatus() && !lineIterator->getSegmentProperty()->getHiddenState())
-			{
-				pathsVector.push_back(closedPath(*lineIterator));
-				lineIsFound = true;
-				break;
-			}
-			else if(lineIterator->getSegmentProperty()->getHiddenState())
-			{
-				lineIterator->setVisitedStatus(true);
-				p_numberVisited++;
-			}
-		}
-		
-		if(!lineIsFound)
-		{
-			for(plf::colony<arcShape>::iterator arcIterator = p_arcList->begin(); arcIterator != p_arcList->end(); arcIterator++)
-			{
-				if(!arcIterator->getVisitedStatus() && !arcIterator->getSegmentProperty()->getHiddenState())
-				{
-					pathsVector.push_back(closedPath(*arcIterator));
-					lineIsFound = true;
-					break;
-				}
-				else if(arcIterator->getSegmentProperty()->getHiddenState())
-				{
-					arcIterator->setVisitedStatus(true);
-					p_numberVisited++;
-				}
-			}
-		}
-	}
-	else
-		pathsVector.push_back(closedPath(startingEdge));
-	
-	while(pathsVector.size() != 0)
-	{
-		for(std::vector<closedPath>::iterator pathIterator = pathsVector.begin(); pathIterator != pathsVector.end();)
-		{
-			if(foundPath.getDistance() == 0 || pathIterator->getDistance() < foundPath.getDistance())
-			{
-				bool closedContourFound = false;
-				bool branchInPaths = false;
-				
-				std::vector<edgeLineShape*> branches = getConnectedPaths(pathIterator->getClosedPath()->back(), pathIterator->getClosedPath());
-				
-				if(branches.size() == 0)
-				{
-					// This means that we have an error in the path
-					// usually caused by a path not forming a closed loop
-					// This occurs if the path has no branches attached to it
-					if(pathsVector.size() > 1)
-					{
-						pathsVector.erase(pathIterator);
-						break;
-					}
-					else
-					{
-						return pathsVector.at(0);
-					}
-				}
-				
-				// Test to see if a closed contour is found
-				// A closed contour occurs when one of the branches 
-				// is the beginning edge of the closed path
-				for(auto branchIterator = branches.begin(); branchIterator != branches.end(); branchIterator++)
-				{
-					if(**branchIterator == **(pathIterator->getClosedPath()->begin()))
-					{
-						closedContourFound = true;
-						break;
-					}
-					else if(**branchIterator == *(pathIterator->getClosedPath()->back()))
-					{
-						branches.erase(branchIterator);
-						branchIterator = branches.begin();
-					}
-				}
-				
-				/* This will test if any branch loops back to the path where the loop is connected to a segment after the 
-				 * begining segment of the path.
-				 * On the start, this for loop will skip the first edge in the closed path becuase that is the 
-				 * trivial solution
-				 */ 
-				for(auto pathEdgeIterator = ++(pathIterator->getClosedPath()->begin()); pathEdgeIterator != pathIterator->getClosedPath()->end(); pathEdgeIterator++)
-				{
-					for(auto branchIterator = branches.begin(); branchIterator != branches.end();branchIterator++)
-					{
-						if(**pathEdgeIterator == **branchIterator)
-						{
-							// This means that the path has looped back on itself
-							branchInPaths = true;
-							break;
-						}
-					}
-					
-					if(branchInPaths)
-						break;
-				}
-				
-				if(branchInPaths)
-				{
-					pathsVector.erase(pathIterator);
-					break;
-				}
-				else if(closedContourFound || branches.size() == 0)
-				{
-					// If found, we are going to test if the 
-					// found contour's distance is less then the current found path
-					// distance
-					if(point == nullptr && (pathIterator->getDistance() < foundPath.getDistance() || foundPath.getDistance() == 0))
-					{
-						foundPath = *pathIterator;
-					}
-					else if(pathIterator->pointInContour(point->getCenter()) && (pathIterator->getDistance() < foundPath.getDistance() || foundPath.getDistance() == 0))
-					{
-						foundPath = *pathIterator;
-					}
-
-					pathsVector.erase(pathIterator);
-					break;
-				}
-				else
-				{
-
-					// If the size of the branches is greater then 1, then we found some additional possible paths
-					// Create another closed path object and add them to the paths vector as possible
-					// solutions to finding the shortest path.
-					if(branches.size() > 1)
-					{
-						closedPath masterPath = *pathIterator;
-						
-						pathIterator->addEdgeToPath(*branches.begin());
-						branches.erase(branches.begin());
-						
-						while(branches.size() != 0)
-						{
-							closedPath addedPath = masterPath;
-							
-							addedPath.addEdgeToPath(*branches.begin());
-							pathsVector.push_back(addedPath);
-							branches.erase(branches.begin());
-						}
-						break;
-					}
-					else if(branches.size() == 1)
-					{
-						// Otherwise, add the one branch to the current path
-						pathIterator->addEdgeToPath(*branches.begin());
-						branches.clear();
-					}
-					
-					pathIterator++;
-					continue;
-				}
-			}
-			else
-			{
-				// Since the path is no the shortest path,
-				// remove the path from the vector
-				pathsVector.erase(pathIterator);
-				break;
-			}
-		}
-	}
-	
-	return foundPath;
-}
-
-
-std::vector<edgeLineShape*> meshMaker::getConnectedPaths(std::vector<edgeLineShape*>::reference currentSegment, std::vector<edgeLineShape*> *pathVector)
-{
-	std::vector<edgeLineShape*> returnList;
-	node *branchNode;
-	std::vector<edgeLineShape*>::iterator previousAddedSegment;
+	geometryGraph.build(*p_lineList, *p_arcList);
 	
-	edgeLineShape *previouseSegmentPointer;
-	edgeLineShape *currentSegmentPointer = currentSegment; // This part may not be necessary but it helps with the thinking
+	/* Edges that do not form part of a closed contour are removed by the planar graph.
+	 * In this case, the edges are skipped and the rest of the geometry is still meshed
+	 */
+	if(geometryGraph.getNumberOfOpenEdges() > 0)
+		OmniFEMMsg::instance()->MsgError("Open Path Found. Skipping " + std::to_string(geometryGraph.getNumberOfOpenEdges()) + " edge(s) that do not form a closed path");
 	
-	int pathSize = pathVector->size();
+	p_closedContourPaths.reserve(p_closedContourPaths.size() + geometryGraph.getNumberOfFaces());
 	
-	if(pathVector->size() >= 2)
-		previousAddedSegment = pathVector->end() - 2;
-	else
-		previousAddedSegment = pathVector->begin();
-		
-	previouseSegmentPointer = *previousAddedSegment;
-	
-	// Determines what node we should be looking at
-	if(pathVector->size() >= 2)
+	for(size_t i = 0; i < geometryGraph.getNumberOfFaces(); i++)
 	{
-		// FInd out which node is connected to the back
-		if((*(currentSegmentPointer->getFirstNode()) == *(previouseSegmentPointer->getFirstNode())) || (*(currentSegmentPointer->getFirstNode()) == *(previouseSegmentPointer->getSecondNode())))
-			branchNode = currentSegmentPointer->getSecondNode();
-		else
-			branchNode = currentSegmentPointer->getFirstNode();
-	}
-	else
-		branchNode = currentSegmentPointer->getFirstNode();// This is the case for the very first segment added
-	
-	//Find all of the lines that are connected to the segment
-	for(plf::colony<edgeLineShape>::iterator lineIterator = p_lineList->begin(); lineIterator != p_lineList->end(); lineIterator++)
-	{
-		// Perform check to make sure that the segment and the previously added segment are not included
-		// Perform check to make sure that the segment is not hidden
-		if(*lineIterator == *currentSegmentPointer || (pathVector->size() > 1 && (*lineIterator == *previouseSegmentPointer)) && !lineIterator->getSegmentProperty()->getHiddenState())
-			continue;
+		closedPath contourPath = geometryGraph.getFacePath(i);
 		
-		// Checks to see if the first node on the line has already been scanned through for branches.
-		// If so, then we need to move on to the second node.
-		// If both of the nodes for the segment have already been visited then we can go ahead and
-		// skip that segment
-		if(((*branchNode == *lineIterator->getFirstNode()) || (*branchNode == *lineIterator->getSecondNode())) && !lineIterator->getSegmentProperty()->getHiddenState())
-		{
-			returnList.push_back(&(*lineIterator));
-		}
-	}
-	
-	// Find all of the arcs connected to the segment
-	for(plf::colony<arcShape>::iterator arcIterator = p_arcList->begin(); arcIterator != p_arcList->end(); arcIterator++)
-	{
-		if((arcIterator->getArcID() == currentSegmentPointer->getArcID()) || (pathVector->size() > 1 && arcIterator->getSegmentProperty()->getHiddenState()))
-			continue;
-			
-		if((*branchNode == *arcIterator->getFirstNode()) || (*branchNode == *arcIterator->getSecondNode()))
-		{
-			returnList.push_back(&(*arcIterator));
-		}
+		for(std::vector<edgeLineShape*>::iterator edgeIterator = contourPath.getClosedPath()->begin(); edgeIterator != contourPath.getClosedPath()->end(); edgeIterator++)
+			(*edgeIterator)->setVisitedStatus(true);
+		
+		p_closedContourPaths.push_back(contourPath);
 	}
-	
-	return returnList;
 }
 
 
@@ -265,6 +47,12 @@ void meshMaker::mesh()
 	{
 		GVertex *temp = p_meshModel->addVertex(nodeIterator->getCenterXCoordinate(), nodeIterator->getCenterYCoordinate(), 0.0, 1.0);
 		nodeIterator->setGModalTagNumber(temp->tag());
+		
+		if(nodeIterator->getNodeSetting()->getNodalPropertyName() != "None")
+			addPhysicalGroup(temp, nodeIterator->getNodeSetting()->getNodalPropertyName());
+			
+		if(nodeIterator->getNodeSetting()->getConductorPropertyName() != "None")
+			addPhysicalGroup(temp, getConductorGroupName(nodeIterator->getNodeSetting()->getConductorPropertyName()));
 	}
 	
 	SBoundingBox3d modelBox = p_meshModel->bounds();
@@ -394,47 +182,7 @@ void meshMaker::mesh()
 	OmniFEMMsg::instance()->MsgStatus("Creating GMSH Geometry from Omni-FEM geometry");
 	OmniFEMMsg::instance()->MsgStatus("Finding contours");
 	
-	while(p_numberVisited < p_numberofLines)
-	{
-		closedPath contourPath = findContour();
-		
-		for(std::vector<edgeLineShape*>::iterator edgeIterator = contourPath.getClosedPath()->begin(); edgeIterator != contourPath.getClosedPath()->end(); edgeIterator++)
-		{
-			if(!(*edgeIterator)->getVisitedStatus())
-			{
-				(*edgeIterator)->setVisitedStatus(true);
-				p_numberVisited++;
-			}
-		}
-		
-		/* All empty paths indicate that there was an error. This error usually results from
-		 * the path not being a closed path.
-		 * In this case, we skip the path and move on to the next one
-		 */ 
-		if(isClosedPath(*contourPath.getClosedPath()) && contourPath.getClosedPath()->size() != 0)
-		{
-			// If we have a closed path then we need to locate all of the block labels within that path
-			// Later, we will determine the top level block label belonging to that contour
-			for(auto blockIterator = p_blockLabelList->begin(); blockIterator != p_blockLabelList->end(); blockIterator++)
-			{
-				// First, check to see if the point is in the bounding box
-				if(contourPath.pointInBoundingBox(blockIterator->getCenter()))
-				{
-					// Then check if the point is within the contour
-					if(contourPath.pointInContour(blockIterator->getCenter()))
-					{
-						contourPath.addBlockLabel(*blockIterator);
-					}
-				}
-			}
-			
-			p_closedContourPaths.push_back(contourPath);// The path will only be pushed to the master list if it is a closed path
-		}
-		else
-		{
-			OmniFEMMsg::instance()->MsgError("Open Path Found. Skipping and moving to the next path");
-		}
-	}
+	findContours();
 	
 	if(p_closedContourPaths.size() > 0)
 	{
@@ -461,91 +209,6 @@ void meshMaker::mesh()
 		
 	//	createGMSHGeometry();
 		
-		if(p_blockLabelsUsed < p_blockLabelList->size())
-		{
-			std::vector<closedPath> additionalPaths;
-			
-			for(auto blockIterator = p_blockLabelList->begin(); blockIterator != p_blockLabelList->end(); blockIterator++)
-			{
-				if(!blockIterator->getUsedState())
-				{
-					// Speed here could be improved upon?
-					closedPath foundPath;
-					edgeLineShape *startEdge = nullptr;
-					bool existsInGeometry = false;
-					std::multimap<double, edgeLineShape*> sortedEdges;
-					
-					for(auto closedPathIterator = p_closedContourPaths.begin(); closedPathIterator != p_closedContourPaths.end(); closedPathIterator++)
-					{
-						closedPath tempPath = *closedPathIterator;
-						if(tempPath.pointInContour(blockIterator->getCenter()))
-						{
-							existsInGeometry = true;
-							break;
-						}
-					}
-					
-					if(existsInGeometry)
-					{
-						/* This next section will organize all of the edges of the geometry in asending order based on the 
-						 * distance of the block label to the midpoint of the edge
-						 */ 
-						for(auto lineIterator = p_lineList->begin(); lineIterator != p_lineList->end(); lineIterator++)
-						{
-							double distance = blockIterator->getDistance(lineIterator->getMidPoint());
-							
-							sortedEdges.insert(std::pair<double, edgeLineShape*>(distance, &(*lineIterator)));
-						}
-						
-						for(auto arcIterator = p_arcList->begin(); arcIterator != p_arcList->end(); arcIterator++)
-						{
-							double distance = blockIterator->getDistance(arcIterator->getMidPoint());
-							
-							sortedEdges.insert(std::pair<double, edgeLineShape*>(distance, &(*arcIterator)));
-						}
-					
-						for(auto mapIterator = sortedEdges.begin(); mapIterator != sortedEdges.end(); mapIterator++)
-						{
-							closedPath possiblePath = findContour((*mapIterator).second, &(*blockIterator));
-							
-							if(possiblePath.getDistance() > 0)
-							{
-								// THe first valid path found will be the path that encompasses the label
-								foundPath = possiblePath;
-								break;
-							}
-						}
-						
-						// Since we found a path that encompasses the label, set the property of that path to the label
-						if(foundPath.getDistance() > 0)
-						{
-							foundPath.setProperty(blockIterator->getProperty());
-							additionalPaths.push_back(foundPath);
-						}
-					}
-					else
-					{
-						OmniFEMMsg::instance()->MsgWarning("Block Label outside of geoemtry found");
-					}
-					
-					p_blockLabelsUsed++;
-					blockIterator->setUsedState(true);
-				}
-			}
-			
-			if(additionalPaths.size() > 0)
-			{
-				holeDetection(&additionalPaths);
-				
-		//		createGMSHGeometry(&additionalPaths);
-				
-				p_closedContourPaths.reserve(p_closedContourPaths.size() + additionalPaths.size());
-				
-				p_closedContourPaths.insert(p_closedContourPaths.end(), additionalPaths.begin(), additionalPaths.end());
-			}
-		}
-		
-		
 		for(auto pathIterator = p_closedContourPaths.begin(); pathIterator != p_closedContourPaths.end();)
 		{
 			unsigned int iteratorDistance = 0;
@@ -606,64 +269,19 @@ void meshMaker::mesh()
 		
 		// Next set any output mesh options
 		// such as different files to output the mesh. Be it VTK or some other format
-		OmniFEMMsg::instance()->MsgStatus("Saving Mesh file");
-		
 		wxDir validDir;
 		
 		if(p_settings->getDirString() != wxString("") && validDir.Open(p_settings->getDirString()))
 		{
 			validDir.Close();
 			
-			if(p_settings->getSaveVTKState())
-				p_meshModel->writeVTK(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".vtk");
+			meshExporter exporter(p_meshModel, *p_settings, p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString());
 			
-			if(p_settings->getSaveBDFState())
-				p_meshModel->writeBDF(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".bdf"); // double check this one
-			
-			if(p_settings->getSaveCELUMState())
-				p_meshModel->writeCELUM(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".celum", false, 1.0);
-				
-			if(p_settings->getSaveDIFFPACKSate())
-				p_meshModel->writeDIFF(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".diff", false, false, 1.0);
-				
-			if(p_settings->getSaveGEOState())
-				p_meshModel->writeGEO(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".geo", true, false);
-				
-			if(p_settings->getSaveINPState())
-				p_meshModel->writeINP(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".inp", false, false, 1.0);
-			
-			if(p_settings->getSaveIR3State())
-				p_meshModel->writeIR3(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".ir3", 0, true, 1.0);
-				
-			if(p_settings->getSaveMAILState())
-				p_meshModel->writeMAIL(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".mail", true, 1.0);
-				
-			if(p_settings->getSaveMESHState())
-				p_meshModel->writeMESH(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".mesh", 1, false, 1.0);
-		
-			if(p_settings->getSaveP3DState())
-				p_meshModel->writeP3D(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".p3d", false, 1.0);
-
-			if(p_settings->getSavePartitionedMeshState())
-				p_meshModel->writePartitionedMSH(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".mesh", 2.2, false, false, false, 1.0);
-				
-			if(p_settings->getSavePLY2State())
-				p_meshModel->writePLY2(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".ply2");
-				
-			if(p_settings->getSaveSTLState())
-				p_meshModel->writeSTL(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".stl", false, false, 1.0);
-				
-			if(p_settings->getSaveTochnogState())
-				p_meshModel->writeTOCHNOG(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".toc", false, false, 1.0);
-				
-			if(p_settings->getSaveSU2State())
-				p_meshModel->writeSU2(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".su2", true, 1.0);
-				
-			if(p_settings->getSaveUNVState())
-				p_meshModel->writeUNV(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".unv", false, false, 1.0);
-				
-			if(p_settings->getSaveVRMLState())
-				p_meshModel->writeVRML(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".vrml", true, 1.0);
+			if(exporter.getNumberOfFormats() > 0)
+			{
+				OmniFEMMsg::instance()->MsgStatus("Saving Mesh file");
+				exporter.write();
+			}
 		}
 	}
 	else
@@ -706,6 +324,7 @@ void meshMaker::createGMSHGeometry(std::vector<closedPath> *pathContour)
 	// pathContour has not already been created
 	std::vector<closedPath> *pathToOperate = nullptr;
 	std::vector<GFace*> addedFaces;
+	std::map<edgeLineShape*, GEdge*> createdEdges;
 	
 	if(pathContour == nullptr)
 		pathToOperate = &p_closedContourPaths;
@@ -725,120 +344,37 @@ void meshMaker::createGMSHGeometry(std::vector<closedPath> *pathContour)
 		{
 		// We first must add in the actual path of the contour to the line loop
 			for(auto lineIterator = pathIterator->getClosedPath()->begin(); lineIterator != pathIterator->getClosedPath()->end(); lineIterator++)
-			{
-				GEdge *addedEdge = nullptr;
-				
-				GVertex *firstNode = p_meshModel->getVertexByTag((*lineIterator)->getFirstNode()->getGModalTagNumber());
-				GVertex *secondNode = p_meshModel->getVertexByTag((*lineIterator)->getSecondNode()->getGModalTagNumber());
-				
-				if((*lineIterator)->isArc())
-				{
-					GVertex *temp = p_meshModel->addVertex((*lineIterator)->getCenterXCoordinate(), (*lineIterator)->getCenterYCoordinate(), 0.0, 1.0);
-					addedEdge = p_meshModel->addCircleArcCenter(firstNode, temp, secondNode);
-				}
-				else
-				{
-					addedEdge = p_meshModel->addLine(firstNode, secondNode);
-				}
-				
-				// Add in the mesh settings of the line
-				if(pathIterator->getProperty()->getMeshsizeType() != meshSize::MESH_NONE_)
-				{
-					if((*lineIterator)->getSegmentProperty()->getMeshAutoState())
-					{
-						// If the mesh spacing is set to auto for the line, then the mesh size of the GEdge will inherit the
-						// mesh size specified by the user in the block label
-						if(!pathIterator->getProperty()->getAutoMeshState())
-						{
-							addedEdge->meshAttributes.meshSize = pathIterator->getProperty()->getMeshSize();
-						}
-						else
-						{
-							std::string temp = pathIterator->getProperty()->getMaterialName();
-							std::transform(temp.begin(), temp.end(), temp.begin(), ::tolower);
-							
-							if(temp == "air")
-								addedEdge->meshAttributes.meshSize = 0.25;
-							else
-								addedEdge->meshAttributes.meshSize = 0.1;
-						}
-					}
-					else if(!(*lineIterator)->getSegmentProperty()->getMeshAutoState())
-					{
-						// In this case, the user has specificially specified that they need the line's mesh size set to a specific value
-						addedEdge->meshAttributes.meshSize = (*lineIterator)->getSegmentProperty()->getElementSizeAlongLine();
-					}
-				}
-				
-				addLineVector.push_back(addedEdge);
-			}
-			
-			
-			
-			// Next we need to set the mesh size of the GEdges here
+				addLineVector.push_back(getGMSHEdge(*lineIterator, pathIterator->getProperty(), createdEdges));
 			
 			lineLoop.push_back(addLineVector);
 			
 			// IF there are any holes, add them to the lineloop vector here
-			if(pathIterator->getHoles()->size() > 0)
+			for(auto holeIterator = pathIterator->getHoles()->begin(); holeIterator != pathIterator->getHoles()->end(); holeIterator++)
 			{
-				for(auto holeIterator = pathIterator->getHoles()->begin(); holeIterator != pathIterator->getHoles()->end(); holeIterator++)
-				{
-					addLineVector.clear();
-					for(auto lineIterator = holeIterator->getClosedPath()->begin(); lineIterator != holeIterator->getClosedPath()->end(); lineIterator++)
-					{
-						GVertex *firstNode = p_meshModel->getVertexByTag((*lineIterator)->getFirstNode()->getGModalTagNumber());
-						GVertex *secondNode = p_meshModel->getVertexByTag((*lineIterator)->getSecondNode()->getGModalTagNumber());
-						
-						GEdge *addedEdge = nullptr;
-						
-						if((*lineIterator)->isArc())
-						{
-							GVertex *temp = p_meshModel->addVertex((*lineIterator)->getCenterXCoordinate(), (*lineIterator)->getCenterYCoordinate(), 0.0, 1.0);
-							addedEdge = p_meshModel->addCircleArcCenter(firstNode, temp, secondNode);
-						}
-						else
-						{
-							addedEdge = p_meshModel->addLine(firstNode, secondNode);
-						}
-						
-						if(pathIterator->getProperty()->getMeshsizeType() != meshSize::MESH_NONE_)
-						{
-							if((*lineIterator)->getSegmentProperty()->getMeshAutoState())
-							{
-								// If the mesh spacing is set to auto for the line, then the mesh size of the GEdge will inherit the
-								// mesh size specified by the user in the block label
-								if(!pathIterator->getProperty()->getAutoMeshState())
-								{
-									addedEdge->meshAttributes.meshSize = pathIterator->getProperty()->getMeshSize();
-								}
-								else
-								{
-									std::string temp = pathIterator->getProperty()->getMaterialName();
-									std::transform(temp.begin(), temp.end(), temp.begin(), ::tolower);
-									
-									if(temp == "air")
-										addedEdge->meshAttributes.meshSize = 0.25;
-									else
-										addedEdge->meshAttributes.meshSize = 0.1;
-								}
-							}
-							else if(!(*lineIterator)->getSegmentProperty()->getMeshAutoState())
-							{
-								// In this case, the user has specificially specified that they need the line's mesh size set to a specific value
-								addedEdge->meshAttributes.meshSize = (*lineIterator)->getSegmentProperty()->getElementSizeAlongLine();
-							}
-						}
+				addLineVector.clear();
 				
-						addLineVector.push_back(addedEdge);
-					}
-					lineLoop.push_back(addLineVector);
-				}
+				for(auto lineIterator = holeIterator->getClosedPath()->begin(); lineIterator != holeIterator->getClosedPath()->end(); lineIterator++)
+					addLineVector.push_back(getGMSHEdge(*lineIterator, pathIterator->getProperty(), createdEdges));
+					
+				lineLoop.push_back(addLineVector);
 			}
 			
 			GFace *addedFace = p_meshModel->addPlanarFace(lineLoop);
 			addedFace->meshAttributes.method = 2;
 			addedFace->meshAttributes.transfiniteArrangement = 0;
+			
+			// The solvers find the material (and the circuit) of each element through the physical groups of the face
+			addPhysicalGroup(addedFace, pathIterator->getProperty()->getMaterialName());
+			
+			if(pathIterator->getProperty()->getCircuitName() != "None")
+			{
+				addPhysicalGroup(addedFace, getCircuitGroupName(pathIterator->getProperty()->getCircuitName()));
+				addPhysicalGroup(addedFace, getTurnsGroupName(pathIterator->getProperty()->getNumberOfTurns()));
+			}
+			
+			if(!pathIterator->getProperty()->getMagnetization().IsEmpty())
+				addPhysicalGroup(addedFace, getMagnetizationGroupName(pathIterator->getProperty()->getMagnetization().ToStdString()));
+			
 			addedFaces.push_back(addedFace);
 		}
 	}
@@ -888,6 +424,84 @@ void meshMaker::createGMSHGeometry(std::vector<closedPath> *pathContour)
 
 
 
+GEdge *meshMaker::getGMSHEdge(edgeLineShape *edge, blockProperty *property, std::map<edgeLineShape*, GEdge*> &createdEdges)
+{
+	double edgeMeshSize;
+	GEdge *addedEdge = nullptr;
+	std::map<edgeLineShape*, GEdge*>::iterator foundEdge = createdEdges.find(edge);
+	
+	if(edge->getSegmentProperty()->getMeshAutoState())
+	{
+		// If the mesh spacing is set to auto for the line, then the mesh size of the GEdge will inherit the
+		// mesh size specified by the user in the block label
+		if(!property->getAutoMeshState())
+			edgeMeshSize = property->getMeshSize();
+		else
+		{
+			std::string temp = property->getMaterialName();
+			std::transform(temp.begin(), temp.end(), temp.begin(), ::tolower);
+			
+			if(temp == "air")
+				edgeMeshSize = 0.25;
+			else
+				edgeMeshSize = 0.1;
+		}
+	}
+	else
+	{
+		// In this case, the user has specificially specified that they need the line's mesh size set to a specific value
+		edgeMeshSize = edge->getSegmentProperty()->getElementSizeAlongLine();
+	}
+	
+	if(foundEdge != createdEdges.end())
+	{
+		// The edge is shared with a face that was already created. The finest of the two mesh sizes is kept
+		addedEdge = foundEdge->second;
+		addedEdge->meshAttributes.meshSize = std::min(addedEdge->meshAttributes.meshSize, edgeMeshSize);
+		return addedEdge;
+	}
+	
+	GVertex *firstNode = p_meshModel->getVertexByTag(edge->getFirstNode()->getGModalTagNumber());
+	GVertex *secondNode = p_meshModel->getVertexByTag(edge->getSecondNode()->getGModalTagNumber());
+	
+	if(edge->isArc())
+	{
+		GVertex *temp = p_meshModel->addVertex(edge->getCenterXCoordinate(), edge->getCenterYCoordinate(), 0.0, 1.0);
+		addedEdge = p_meshModel->addCircleArcCenter(firstNode, temp, secondNode);
+	}
+	else
+	{
+		addedEdge = p_meshModel->addLine(firstNode, secondNode);
+	}
+	
+	addedEdge->meshAttributes.meshSize = edgeMeshSize;
+	
+	if(edge->getSegmentProperty()->getBoundaryName() != "None")
+		addPhysicalGroup(addedEdge, edge->getSegmentProperty()->getBoundaryName());
+		
+	if(edge->getSegmentProperty()->getConductorName() != "None")
+		addPhysicalGroup(addedEdge, getConductorGroupName(edge->getSegmentProperty()->getConductorName()));
+	
+	createdEdges[edge] = addedEdge;
+	
+	return addedEdge;
+}
+
+
+
+void meshMaker::addPhysicalGroup(GEntity *entity, std::string name)
+{
+	/* The number of a new group is one more than the number of groups so far. This is never in use
+	 * since all of the groups are created here. If the name is already in use, the existing number is returned
+	 */
+	int groupNumber = p_meshModel->setPhysicalName(name, entity->dim(), p_meshModel->numPhysicalNames() + 1);
+	
+	if(std::find(entity->physicals.begin(), entity->physicals.end(), groupNumber) == entity->physicals.end())
+		entity->addPhysicalEntity(groupNumber);
+}
+
+
+
 closedPath meshMaker::recreatePath(closedPath &path, closedPath holeIterator, std::vector<edgeLineShape*> commonEdges)
 {
 	std::vector<edgeLineShape*> newEdgesForPath;
@@ -1002,175 +616,68 @@ closedPath meshMaker::recreatePath(closedPath &path, closedPath holeIterator, st
 
 
 
-void meshMaker::holeDetection(std::vector<closedPath> *pathContour)
+void meshMaker::holeDetection()
 {
-	std::vector<closedPath> *pathToOperate = nullptr;
-	bool isFinished = false;
-	
-	if(pathContour == nullptr)
-		pathToOperate = &p_closedContourPaths;
-	else
-		pathToOperate = pathContour;
+	std::vector<std::vector<closedPath>> holeList(p_closedContourPaths.size());
 	
+	p_containmentTree.build(p_closedContourPaths);
 	
-	// First, we need to loop through every single closed path and check the bounding box
-	// against all the other closed paths to see if it is a possible hole
-	for(auto pathIterator = pathToOperate->begin(); pathIterator != pathToOperate->end();)
+	/* The children of a path in the tree are the paths directly inside of the path, which are the top level holes.
+	 * The holes are copied before any path is given holes of its own so that the copies stay small
+	 */
+	for(size_t i = 0; i < p_closedContourPaths.size(); i++)
 	{
-		bool resetPath = false;
+		std::vector<size_t> *children = p_containmentTree.getChildren(i);
 		
-		if(!pathIterator->getHolesFoundState())
-		{
-			for(auto holeIterator = p_closedContourPaths.begin(); holeIterator != p_closedContourPaths.end(); holeIterator++)
-			{
-				// Check to see if the "hole" is a hole to the path
-				if(holeIterator->isInside(*pathIterator) /*&& holeIterator->getBoundingBox() != pathIterator->getBoundingBox()*/)
-				{
-					pathIterator->addHole(*holeIterator);
-				}
-			}
-			
-			if(!resetPath)
-				pathIterator->setHolesFound();
-		}
-		
-		if(resetPath)
-			pathIterator = pathToOperate->begin();
-		else
-			pathIterator++;
+		for(std::vector<size_t>::iterator childIterator = children->begin(); childIterator != children->end(); ++childIterator)
+			holeList[i].push_back(p_closedContourPaths[*childIterator]);
 	}
 	
-	// Now, we need to find the top level holes
-	for(auto pathIterator = pathToOperate->begin(); pathIterator != pathToOperate->end(); pathIterator++)
+	for(size_t i = 0; i < p_closedContourPaths.size(); i++)
 	{
-		if(pathIterator->getHoles()->size() > 1)
-		{
-			bool isFinished = false;
-			
-			while(!isFinished)
-			{
-				for(auto topLevelIterator = pathIterator->getHoles()->begin(); topLevelIterator != pathIterator->getHoles()->end();)
-				{
-					bool resetIterator = false;
-					
-					for(auto holeIterator = pathIterator->getHoles()->begin(); holeIterator != pathIterator->getHoles()->end();)
-					{
-						if(holeIterator->getBoundingBox() == topLevelIterator->getBoundingBox())
-						{
-							holeIterator++;
-							continue;
-						}
-						
-						// If the hole is inside of the top level contour, delete the hole and restart the process
-						if(holeIterator->isInside(*topLevelIterator))
-						{
-							pathIterator->getHoles()->erase(holeIterator);
-							resetIterator = true;
-							break;
-						}
-						else if(topLevelIterator->isInside(*holeIterator))
-						{
-							// If the top level is actually inside of the hole,
-							// then we need to delete the top level and restart the process
-							pathIterator->getHoles()->erase(topLevelIterator);
-							resetIterator = true;
-							break;
-						}
-						else// If the hole is not even inside of the top level but inside of the closed contour, skip and continue on
-							holeIterator++;
-					}
-					
-					if(resetIterator)
-						break;
-					else
-						topLevelIterator++;
-					
-					if(topLevelIterator == pathIterator->getHoles()->end())
-						isFinished = true;
-				}
-			}
-		}
+		for(auto holeIterator = holeList[i].begin(); holeIterator != holeList[i].end(); holeIterator++)
+			p_closedContourPaths[i].addHole(*holeIterator);
+		
+		p_closedContourPaths[i].setHolesFound();
 		
 		// Need to combine any closed paths holes with a common edge here
-		if(pathIterator->getHoles()->size() > 0)
-			pathIterator->combineHoles();
+		if(p_closedContourPaths[i].getHoles()->size() > 0)
+			p_closedContourPaths[i].combineHoles();
 	}
 }
 
 
 
-void meshMaker::assignBlockLabel(std::vector<closedPath> *pathContour)
+void meshMaker::assignBlockLabel()
 {
-	std::vector<closedPath> *pathToOperate = nullptr;
-	bool labelInHole = false;
+	std::vector<plf::colony<blockLabel>::iterator> labels;
+	std::vector<wxRealPoint> labelPoints;
+	std::vector<long> pathIndices;
 	
-	if(pathContour == nullptr)
-		pathToOperate = &p_closedContourPaths;
-	else
-		pathToOperate = pathContour;
+	for(auto blockIterator = p_blockLabelList->begin(); blockIterator != p_blockLabelList->end(); blockIterator++)
+	{
+		if(blockIterator->getUsedState())
+			continue;
 		
-	for(auto pathIterator = pathToOperate->begin(); pathIterator != pathToOperate->end(); pathIterator++)
+		labels.push_back(blockIterator);
+		labelPoints.push_back(blockIterator->getCenter());
+	}
+	
+	// All of the labels are located at once so that each contour tests its labels as one group
+	p_containmentTree.findPaths(labelPoints, pathIndices);
+	
+	for(size_t i = 0; i < labels.size(); i++)
 	{
-		blockLabel *setLabel = nullptr;
+		long pathIndex = pathIndices[i];
 		
-		if(pathIterator->getBlockLabelList()->size() > 1)
-		{
-			for(auto propertyIterator = pathIterator->getBlockLabelList()->begin(); propertyIterator != pathIterator->getBlockLabelList()->end(); propertyIterator++)
-			{
-				/* First, if there is more then 1 block label in the polygon, then it is quite possible we have some holes.
-				 * In which case, we will need to check if the label is in the one of the holes
-				 */ 
-				bool isInHole = false;
-				
-				if(!(*propertyIterator)->getUsedState())
-				{
-					for(auto holeIterator = pathIterator->getHoles()->begin(); holeIterator != pathIterator->getHoles()->end(); holeIterator++)
-					{
-						if(holeIterator->pointInContour((*propertyIterator)->getCenter()))
-						{
-							// If a label is found in a hole, then we need to move onto the next label
-							isInHole = true;
-							break;
-						}
-					}
-				}
-				
-				if(!isInHole && !(*propertyIterator)->getUsedState())
-				{
-					// If the label is not in any of the holes, then we found the top level label
-					// With the top level label found, we can stop looping through all of the labels
-					setLabel = *propertyIterator;
-					break;
-				}
-			}
-		}
-		else if(pathIterator->getBlockLabelList()->size() == 1)
-		{
-			
-			for(auto holeIterator = pathIterator->getHoles()->begin(); holeIterator != pathIterator->getHoles()->end(); holeIterator++)
-			{
-				if(holeIterator->pointInContour(pathIterator->getBlockLabelList()->at(0)->getCenter()))
-				{
-					labelInHole = true;
-					pathIterator->clearBlockLabelList();
-					break;
-				}
-			}
-			
-			if(!labelInHole)
-				setLabel = pathIterator->getBlockLabelList()->at(0);
-		}
+		if(pathIndex < 0)
+			OmniFEMMsg::instance()->MsgWarning("Block Label outside of geoemtry found");
+		else if(!p_closedContourPaths[pathIndex].getProperty())
+			p_closedContourPaths[pathIndex].setProperty(labels[i]->getProperty());
 		else
-		{
-			continue;
-		}
+			OmniFEMMsg::instance()->MsgWarning("More then one block label found in the same region. Only one label will be used");
 		
-		if(!labelInHole)
-		{
-			setLabel->setUsedState(true);
-			p_blockLabelsUsed++;
-			pathIterator->setProperty(setLabel->getProperty());
-			pathIterator->clearBlockLabelList();
-		}
+		p_blockLabelsUsed++;
+		labels[i]->setUsedState(true);
 	}
 }
\ No newline at end of file
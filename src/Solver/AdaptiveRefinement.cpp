@@ -0,0 +1,218 @@
+#include <Solver/AdaptiveRefinement.h>
+
+#include <math.h>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+#include <Mesh/GMSH/Context.h>
+
+
+
+adaptiveRefinement::adaptiveRefinement(problemDefinition &definition, GModel *model)
+{
+	p_definition = &definition;
+	p_model = model;
+	p_tolerance = definition.getMeshSettingsPointer()->getAdaptiveTolerance();
+	p_maximumPasses = std::max(definition.getMeshSettingsPointer()->getAdaptivePasses(), 1u);
+
+	if(p_tolerance <= 0)
+		p_tolerance = 0.05;
+}
+
+
+
+bool adaptiveRefinement::refine(solverMesh *mesh, const errorEstimator &estimator, double scale)
+{
+	const int numberOfNodes = mesh->getNumberOfNodes();
+	const double *x = mesh->getXCoordinates();
+	const double *y = mesh->getYCoordinates();
+	const std::vector<double> &errors = estimator.getElementErrors();
+	const std::vector<double> &areas = estimator.getElementAreas();
+	const double permissibleError = p_tolerance * p_tolerance * (estimator.getEnergy() + estimator.getError()) / std::max((int)errors.size(), 1);
+	const bool isSubdivided = (CTX::instance()->mesh.algoSubdivide == 1);
+	std::vector<double> modelX(numberOfNodes), modelY(numberOfNodes), density(numberOfNodes, 0.0);
+	std::vector<int> triangles;
+	int element = 0;
+	int numberOfRefined = 0;
+
+	for(int i = 0; i < numberOfNodes; i++)
+	{
+		modelX[i] = x[i] / scale;
+		modelY[i] = y[i] / scale;
+	}
+
+	// The sizes of the earlier passes are kept
+	if(p_field)
+	{
+		for(int i = 0; i < numberOfNodes; i++)
+			density[i] = p_field->getDensity(modelX[i], modelY[i]);
+	}
+
+	for(auto blockIterator = mesh->getElementBlocks()->begin(); blockIterator != mesh->getElementBlocks()->end(); blockIterator++)
+	{
+		const int n = blockIterator->numberOfNodes;
+		const bool isQuadrilateral = (ElementType::ParentTypeFromTag(blockIterator->type) == TYPE_QUA);
+
+		for(unsigned int e = 0; e < blockIterator->regions.size(); e++, element++)
+		{
+			const int *nodes = &blockIterator->nodes[e * n];
+
+			triangles.push_back(nodes[0]);
+			triangles.push_back(nodes[1]);
+			triangles.push_back(nodes[2]);
+
+			if(isQuadrilateral)
+			{
+				triangles.push_back(nodes[0]);
+				triangles.push_back(nodes[2]);
+				triangles.push_back(nodes[3]);
+			}
+
+			if(errors[element] <= permissibleError)
+				continue;
+
+			/* The size that GMSH is given is the edge of the triangles. When GMSH splits each triangle into three quadrilaterals,
+			 * one triangle of size h has the area of three of the quadrilaterals
+			 */
+			double size;
+
+			if(!isQuadrilateral)
+				size = sqrt(4.0 * areas[element] / sqrt(3.0));
+			else if(isSubdivided)
+				size = sqrt(4.0 * sqrt(3.0) * areas[element]);
+			else
+				size = sqrt(areas[element]);
+
+			// The error of the element goes down with the size to the power of the order of the element
+			const double reduction = std::max(pow(errors[element] / permissibleError, -0.5 / blockIterator->order), p_maximumReduction);
+			const double targetDensity = scale / (size * reduction);
+
+			for(int i = 0; i < n; i++)
+				density[nodes[i]] = std::max(density[nodes[i]], targetDensity);
+
+			numberOfRefined++;
+		}
+	}
+
+	if(numberOfRefined == 0)
+		return false;
+
+	OmniFEMMsg::instance()->MsgStatus("Refining " + std::to_string(numberOfRefined) + " of " + std::to_string(errors.size()) + " elements");
+
+	/* The field manager deletes the fields that it holds so the field of the last pass is deleted here. The new field is
+	 * made from the densities that were read out of the old field above
+	 */
+	FieldManager *fields = p_model->getFields();
+
+	fields->reset();
+	p_field = new sizeField(modelX, modelY, density, triangles);
+	fields->setBackgroundField(p_field);
+
+	return true;
+}
+
+
+
+void adaptiveRefinement::remesh()
+{
+	OmniFEMMsg::instance()->MsgStatus("Meshing GMSH geometry");
+
+	p_model->deleteMesh();
+	p_model->mesh(2);
+
+	if(p_model->getNumMeshVertices() > 0)
+		p_model->indexMeshVertices(true);
+}
+
+
+
+template<class solverType>
+solverType *adaptiveRefinement::run(double scale)
+{
+	solverType *solver = nullptr;
+
+	p_relativeErrors.clear();
+	p_numberOfElements.clear();
+
+	for(unsigned int pass = 1; ; pass++)
+	{
+		OmniFEMMsg::instance()->MsgStatus("Adaptive refinement pass " + std::to_string(pass) + " of at most " + std::to_string(p_maximumPasses));
+
+		delete solver;
+		solver = new solverType(*p_definition, p_model);
+
+		if(!solver->solve())
+		{
+			delete solver;
+			solver = nullptr;
+			break;
+		}
+
+		double startTime = TimeOfDay();
+		std::vector<double> unknown, coefficientX, coefficientY;
+		const int radialExponent = solver->getEnergyNorm(unknown, coefficientX, coefficientY);
+		errorEstimator estimator(solver->getMesh(), radialExponent);
+
+		estimator.estimate(unknown, coefficientX, coefficientY);
+
+		double estimateTime = TimeOfDay();
+		const double relativeError = estimator.getRelativeError();
+		std::ostringstream report;
+
+		p_relativeErrors.push_back(relativeError);
+		p_numberOfElements.push_back(solver->getMesh()->getNumberOfElements());
+
+		report << std::fixed << std::setprecision(3);
+		report << "Adaptive pass " << pass << ": " << p_numberOfElements.back() << " elements, relative energy error " << 100.0 * relativeError << " % (tolerance " << 100.0 * p_tolerance << " %)\n";
+		report << "Error estimate: " << estimateTime - startTime << " s";
+
+		if(relativeError <= p_tolerance)
+		{
+			OmniFEMMsg::instance()->MsgInfo(report.str());
+			OmniFEMMsg::instance()->MsgStatus("The adaptive refinement reached the tolerance");
+			break;
+		}
+
+		if(pass >= p_maximumPasses)
+		{
+			OmniFEMMsg::instance()->MsgInfo(report.str());
+			OmniFEMMsg::instance()->MsgWarning("The adaptive refinement stopped after " + std::to_string(pass) + " solves without reaching the tolerance");
+			break;
+		}
+
+		if(!refine(solver->getMesh(), estimator, scale))
+		{
+			OmniFEMMsg::instance()->MsgInfo(report.str());
+			break;
+		}
+
+		remesh();
+
+		report << "\nRemesh: " << TimeOfDay() - estimateTime << " s";
+		OmniFEMMsg::instance()->MsgInfo(report.str());
+	}
+
+	/* The mesh stays as it is but the field is removed so that meshing the same model again does not pick it up. The field
+	 * holds no more than a copy of the values
+	 */
+	p_model->getFields()->reset();
+	p_model->getFields()->setBackgroundFieldId(-1);
+	p_field = nullptr;
+
+	return solver;
+}
+
+
+
+electrostaticSolver *adaptiveRefinement::solveElectrostatic()
+{
+	return run<electrostaticSolver>(solverMesh::getUnitScale(p_definition->getElectricalPreferences().getUnitLength()));
+}
+
+
+
+magnetostaticSolver *adaptiveRefinement::solveMagnetostatic()
+{
+	return run<magnetostaticSolver>(solverMesh::getUnitScale(p_definition->getMagneticPreference().getUnitLength()));
+}
@@ -0,0 +1,159 @@
+#include <Solver/BHCurve.h>
+
+#include <algorithm>
+
+
+const int bhCurve::p_tableSize;
+
+
+
+double bhCurve::evaluateCubic(const std::vector<double> &flux, const std::vector<double> &field, const std::vector<double> &slope, double value, double &derivative)
+{
+	const int interval = std::min<int>(std::upper_bound(flux.begin(), flux.end(), value) - flux.begin(), flux.size() - 1) - 1;
+	const double width = flux[interval + 1] - flux[interval];
+	const double t = (value - flux[interval]) / width;
+	const double t2 = t * t;
+	const double t3 = t2 * t;
+
+	// The cubic Hermite basis on the interval
+	const double h00 = 2 * t3 - 3 * t2 + 1;
+	const double h10 = t3 - 2 * t2 + t;
+	const double h01 = -2 * t3 + 3 * t2;
+	const double h11 = t3 - t2;
+
+	derivative = ((6 * t2 - 6 * t) * field[interval] + (3 * t2 - 4 * t + 1) * width * slope[interval]
+				+ (-6 * t2 + 6 * t) * field[interval + 1] + (3 * t2 - 2 * t) * width * slope[interval + 1]) / width;
+
+	return h00 * field[interval] + h10 * width * slope[interval] + h01 * field[interval + 1] + h11 * width * slope[interval + 1];
+}
+
+
+
+bhCurve::bhCurve(const std::vector<double> &flux, const std::vector<double> &field)
+{
+	std::vector<double> curveFlux(1, 0.0);
+	std::vector<double> curveField(1, 0.0);
+
+	for(unsigned int i = 0; i < flux.size() && i < field.size(); i++)
+	{
+		if(flux[i] > curveFlux.back() && field[i] > curveField.back())
+		{
+			curveFlux.push_back(flux[i]);
+			curveField.push_back(field[i]);
+		}
+	}
+
+	// Without any points, the material is air
+	if(curveFlux.size() < 2)
+	{
+		curveFlux.push_back(1.0);
+		curveField.push_back(1.0 / p_vacuumPermeability);
+	}
+
+	const int numberOfPoints = curveFlux.size();
+	std::vector<double> secant(numberOfPoints - 1);
+	std::vector<double> slope(numberOfPoints);
+
+	for(int i = 0; i < numberOfPoints - 1; i++)
+		secant[i] = (curveField[i + 1] - curveField[i]) / (curveFlux[i + 1] - curveFlux[i]);
+
+	slope[0] = secant[0];
+	slope[numberOfPoints - 1] = secant[numberOfPoints - 2];
+
+	for(int i = 1; i < numberOfPoints - 1; i++)
+		slope[i] = 0.5 * (secant[i - 1] + secant[i]);
+
+	// Fritsch-Carlson: the slopes are limited so that the cubic does not overshoot between the points
+	for(int i = 0; i < numberOfPoints - 1; i++)
+	{
+		const double alpha = slope[i] / secant[i];
+		const double beta = slope[i + 1] / secant[i];
+		const double length = alpha * alpha + beta * beta;
+
+		if(length > 9)
+		{
+			const double tau = 3.0 / sqrt(length);
+
+			slope[i] = tau * alpha * secant[i];
+			slope[i + 1] = tau * beta * secant[i];
+		}
+	}
+
+	p_maximumFlux = curveFlux.back();
+	p_maximumFluxSquared = p_maximumFlux * p_maximumFlux;
+	p_step = p_maximumFluxSquared / p_tableSize;
+	p_inverseStep = 1.0 / p_step;
+	p_reluctivity.resize(p_tableSize + 1);
+
+	p_reluctivity[0] = p_vacuumPermeability * slope[0];
+
+	for(int k = 1; k <= p_tableSize; k++)
+	{
+		const double sampleFlux = sqrt(k * p_step);
+		double derivative;
+
+		p_reluctivity[k] = p_vacuumPermeability * evaluateCubic(curveFlux, curveField, slope, sampleFlux, derivative) / sampleFlux;
+
+		/* The slope dH/dB of the sampled curve is nu + 2 B^2 dnu/dB^2. Over the interval, this is the smallest at the end of the
+		 * interval when the reluctivity goes down. Keeping it positive there keeps it positive over the whole interval
+		 */
+		const double smallest = p_reluctivity[k - 1] * (2.0 * k) / (2.0 * k + 1.0) * (1.0 + 1e-9);
+
+		if(p_reluctivity[k] < smallest)
+			p_reluctivity[k] = smallest;
+	}
+
+	p_saturationOffset = (p_reluctivity[p_tableSize] - 1.0) * p_maximumFlux;
+
+	// The end of the table joins the saturated material. Past the end, dH/dB = 1 / mu0
+	if(p_saturationOffset < 0)
+		p_saturationOffset = 0;
+}
+
+
+
+bool bhCurve::getAnhystereticCurve(jilesAthertonParameters &parameters, double fillFactor, std::vector<double> &flux, std::vector<double> &field)
+{
+	const double vacuumPermeability = 4e-7 * M_PI;
+	const double saturation = parameters.getSaturationMagnetization();
+	const double domainDensity = parameters.getAParam();
+	const double coupling = parameters.getAlpha();
+	const int numberOfPoints = 200;
+
+	flux.clear();
+	field.clear();
+
+	if(saturation <= 0 || domainDensity <= 0)
+		return false;
+
+	if(fillFactor <= 0 || fillFactor > 1)
+		fillFactor = 1;
+
+	/* The field is sampled on a logarithmic scale from far below the knee of the curve to the point where the magnetization
+	 * is within 0.1% of the saturation
+	 */
+	for(int i = 0; i < numberOfPoints; i++)
+	{
+		const double H = domainDensity * pow(10.0, -3.0 + 6.0 * i / (numberOfPoints - 1));
+		double lower = 0;
+		double upper = saturation;
+
+		// The magnetization is found by bisection since the fixed point iteration does not converge for a large alpha
+		for(int iteration = 0; iteration < 60; iteration++)
+		{
+			const double M = 0.5 * (lower + upper);
+			const double x = (H + coupling * M) / domainDensity;
+			const double langevin = (x < 1e-4) ? x / 3.0 - x * x * x / 45.0 : 1.0 / tanh(x) - 1.0 / x;
+
+			if(saturation * langevin > M)
+				lower = M;
+			else
+				upper = M;
+		}
+
+		field.push_back(H);
+		flux.push_back(vacuumPermeability * (H + fillFactor * 0.5 * (lower + upper)));
+	}
+
+	return true;
+}
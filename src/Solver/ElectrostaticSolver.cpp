@@ -0,0 +1,532 @@
+#include <Solver/ElectrostaticSolver.h>
+
+#include <math.h>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <Mesh/meshMaker.h>
+
+
+const int electrostaticSolver::p_batchSize;
+
+
+
+electrostaticSolver::electrostaticSolver(problemDefinition &definition, GModel *model)
+{
+	p_model = model;
+
+	p_materials = *definition.getElectricalMaterialList();
+	p_boundaries = *definition.getElectricalBoundaryList();
+	p_conductors = *definition.getConductorList();
+	p_nodalProperties = *definition.getNodalPropertyList();
+	p_preferences = definition.getElectricalPreferences();
+}
+
+
+
+int electrostaticSolver::findConductor(const std::string &groupName)
+{
+	for(unsigned int i = 0; i < p_conductors.size(); i++)
+	{
+		if(groupName == meshMaker::getConductorGroupName(p_conductors[i].getName()))
+			return i;
+	}
+
+	return -1;
+}
+
+
+
+void electrostaticSolver::computeElements(const solverMesh::elementBlock &block, int first, int count, const elementKernel &kernel, const std::vector<double> &regionEpsilonX,
+										  const std::vector<double> &regionEpsilonY, const std::vector<double> &regionSource, bool axisymmetric, std::vector<double> &buffer,
+										  double *matrices, double *vectors)
+{
+	const int n = block.numberOfNodes;
+	const int *nodes = &block.nodes[first * n];
+	const int *regions = &block.regions[first];
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+
+	if(block.type == MSH_TRI_3)
+	{
+		/* The coordinates and the coefficients are gathered into a structure of arrays so that
+		 * the closed form kernel can work on all of the triangles of the batch at once
+		 */
+		buffer.resize(count * (3 + 3 + 3 + 9 + 3));
+
+		double *batchX = &buffer[0];
+		double *batchY = batchX + 3 * count;
+		double *batchCoefficients = batchY + 3 * count;
+		double *batchMatrix = batchCoefficients + 3 * count;
+		double *batchVector = batchMatrix + 9 * count;
+
+		for(int e = 0; e < count; e++)
+		{
+			for(int i = 0; i < 3; i++)
+			{
+				batchX[i * count + e] = x[nodes[e * 3 + i]];
+				batchY[i * count + e] = y[nodes[e * 3 + i]];
+			}
+
+			batchCoefficients[e] = regionEpsilonX[regions[e]];
+			batchCoefficients[count + e] = regionEpsilonY[regions[e]];
+			batchCoefficients[2 * count + e] = regionSource[regions[e]];
+		}
+
+		triangleDiffusionBatch(count, batchX, batchY, batchCoefficients, batchCoefficients + count, batchCoefficients + 2 * count, axisymmetric, batchMatrix, batchVector);
+
+		for(int e = 0; e < count; e++)
+		{
+			for(int i = 0; i < 9; i++)
+				matrices[e * 9 + i] = batchMatrix[i * count + e];
+
+			for(int i = 0; i < 3; i++)
+				vectors[e * 3 + i] = batchVector[i * count + e];
+		}
+	}
+	else
+	{
+		buffer.resize(2 * n);
+
+		for(int e = 0; e < count; e++)
+		{
+			for(int i = 0; i < n; i++)
+			{
+				buffer[i] = x[nodes[e * n + i]];
+				buffer[n + i] = y[nodes[e * n + i]];
+			}
+
+			kernel.diffusion(&buffer[0], &buffer[n], regionEpsilonX[regions[e]], regionEpsilonY[regions[e]], regionSource[regions[e]], axisymmetric, &matrices[e * n * n], &vectors[e * n]);
+		}
+	}
+}
+
+
+
+int electrostaticSolver::getEnergyNorm(std::vector<double> &unknown, std::vector<double> &coefficientX, std::vector<double> &coefficientY)
+{
+	unknown = p_potential;
+	coefficientX.clear();
+	coefficientY.clear();
+
+	for(auto blockIterator = p_mesh->getElementBlocks()->begin(); blockIterator != p_mesh->getElementBlocks()->end(); blockIterator++)
+	{
+		for(auto regionIterator = blockIterator->regions.begin(); regionIterator != blockIterator->regions.end(); regionIterator++)
+		{
+			coefficientX.push_back(p_regionPermittivityX[*regionIterator]);
+			coefficientY.push_back(p_regionPermittivityY[*regionIterator]);
+		}
+	}
+
+	return (p_preferences.getProblemType() == problemTypeEnum::AXISYMMETRIC) ? 1 : 0;
+}
+
+
+
+bool electrostaticSolver::solve()
+{
+	const bool axisymmetric = (p_preferences.getProblemType() == problemTypeEnum::AXISYMMETRIC);
+	const double scale = solverMesh::getUnitScale(p_preferences.getUnitLength());
+	double depth = p_preferences.getDepth() * scale;
+	double startTime = TimeOfDay();
+	int numberOfThreads = 1;
+
+#if defined(_OPENMP)
+	numberOfThreads = omp_get_max_threads();
+#endif
+
+	if(depth <= 0)
+		depth = 1.0;
+
+	OmniFEMMsg::instance()->MsgStatus("Reading the mesh");
+
+	delete p_mesh;
+	p_mesh = new solverMesh(p_model, scale);
+
+	const int numberOfNodes = p_mesh->getNumberOfNodes();
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+	std::vector<solverMesh::elementBlock> &blocks = *p_mesh->getElementBlocks();
+
+	if(p_mesh->getNumberOfElements() == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("The mesh does not have any elements. Create the mesh before running the solver");
+		return false;
+	}
+
+	double meshTime = TimeOfDay();
+
+	/* The material of each face. The equation is divided through by the permittivity of free space
+	 * so the coefficients are the relative permittivity and the source is rho / epsilon0
+	 */
+	std::vector<solverMesh::region> &regions = *p_mesh->getRegions();
+	std::vector<double> regionEpsilonX(regions.size(), 1.0);
+	std::vector<double> regionEpsilonY(regions.size(), 1.0);
+	std::vector<double> regionSource(regions.size(), 0.0);
+	bool missingMaterial = false;
+
+	for(unsigned int r = 0; r < regions.size(); r++)
+	{
+		bool foundMaterial = false;
+
+		for(auto groupIterator = regions[r].groups.begin(); groupIterator != regions[r].groups.end() && !foundMaterial; groupIterator++)
+		{
+			for(auto materialIterator = p_materials.begin(); materialIterator != p_materials.end(); materialIterator++)
+			{
+				if(materialIterator->getName() == *groupIterator)
+				{
+					regionEpsilonX[r] = materialIterator->getEpsilonX();
+					regionEpsilonY[r] = materialIterator->getEpsilonY();
+					regionSource[r] = materialIterator->getChargeDensity() / p_vacuumPermittivity;
+					foundMaterial = true;
+					break;
+				}
+			}
+		}
+
+		if(!foundMaterial)
+			missingMaterial = true;
+	}
+
+	if(missingMaterial)
+		OmniFEMMsg::instance()->MsgWarning("At least one face does not have an electrostatic material. These faces are solved as a vacuum");
+
+	p_regionPermittivityX = regionEpsilonX;
+	p_regionPermittivityY = regionEpsilonY;
+
+	/* The unknowns are the voltage of each node and then the voltage of each conductor that has a total charge */
+	std::vector<int> conductorUnknown(p_conductors.size(), -1);
+	int numberOfUnknowns = numberOfNodes;
+
+	for(unsigned int i = 0; i < p_conductors.size(); i++)
+	{
+		if(p_conductors[i].getIsTotalChargeState())
+			conductorUnknown[i] = numberOfUnknowns++;
+	}
+
+	potentialConstraints constraints(numberOfUnknowns);
+	std::vector<std::pair<int, double>> pointCharges;
+	std::vector<std::pair<solverMesh::edgeSegment*, double>> surfaceCharges;
+	std::map<std::string, std::vector<solverMesh::edgeSegment*>> periodicEdges;
+	std::map<std::string, double> periodicSign;
+	bool hasMixedBoundary = false;
+
+	for(auto pointIterator = p_mesh->getPoints()->begin(); pointIterator != p_mesh->getPoints()->end(); pointIterator++)
+	{
+		for(auto groupIterator = pointIterator->groups.begin(); groupIterator != pointIterator->groups.end(); groupIterator++)
+		{
+			int conductor = findConductor(*groupIterator);
+
+			if(conductor != -1)
+			{
+				if(p_conductors[conductor].getIsTotalChargeState())
+					constraints.tie(pointIterator->node, conductorUnknown[conductor], 1.0);
+				else
+					constraints.fix(pointIterator->node, p_conductors[conductor].getValue());
+
+				continue;
+			}
+
+			for(auto nodalIterator = p_nodalProperties.begin(); nodalIterator != p_nodalProperties.end(); nodalIterator++)
+			{
+				if(nodalIterator->getName() != *groupIterator)
+					continue;
+
+				// A point charge in C/m. For axisymmetric problems, this is a ring of charge at the radius of the node
+				if(nodalIterator->getState())
+					constraints.fix(pointIterator->node, nodalIterator->getValue());
+				else
+					pointCharges.push_back(std::make_pair(pointIterator->node, nodalIterator->getValue() / p_vacuumPermittivity * (axisymmetric ? x[pointIterator->node] : 1.0)));
+			}
+		}
+	}
+
+	for(auto edgeIterator = p_mesh->getEdges()->begin(); edgeIterator != p_mesh->getEdges()->end(); edgeIterator++)
+	{
+		for(auto groupIterator = edgeIterator->groups.begin(); groupIterator != edgeIterator->groups.end(); groupIterator++)
+		{
+			int conductor = findConductor(*groupIterator);
+
+			if(conductor != -1)
+			{
+				for(auto nodeIterator = edgeIterator->orderedNodes.begin(); nodeIterator != edgeIterator->orderedNodes.end(); nodeIterator++)
+				{
+					if(p_conductors[conductor].getIsTotalChargeState())
+						constraints.tie(*nodeIterator, conductorUnknown[conductor], 1.0);
+					else
+						constraints.fix(*nodeIterator, p_conductors[conductor].getValue());
+				}
+
+				continue;
+			}
+
+			for(auto boundaryIterator = p_boundaries.begin(); boundaryIterator != p_boundaries.end(); boundaryIterator++)
+			{
+				if(boundaryIterator->getBoundaryName() != *groupIterator)
+					continue;
+
+				switch(boundaryIterator->getBC())
+				{
+					case bcEnumElectroStatic::FIXED_VOLTAGE:
+						for(auto nodeIterator = edgeIterator->orderedNodes.begin(); nodeIterator != edgeIterator->orderedNodes.end(); nodeIterator++)
+							constraints.fix(*nodeIterator, boundaryIterator->getVoltage());
+						break;
+					case bcEnumElectroStatic::SURFACE_CHARGE_DENSITY:
+						surfaceCharges.push_back(std::make_pair(&(*edgeIterator), boundaryIterator->getSigma() / p_vacuumPermittivity));
+						break;
+					case bcEnumElectroStatic::E_STATIC_PERIODIC:
+					case bcEnumElectroStatic::E_STATIC_ANTIPERIODIC:
+						periodicEdges[*groupIterator].push_back(&(*edgeIterator));
+						periodicSign[*groupIterator] = (boundaryIterator->getBC() == bcEnumElectroStatic::E_STATIC_PERIODIC) ? 1.0 : -1.0;
+						break;
+					default:
+						hasMixedBoundary = true;
+						break;
+				}
+			}
+		}
+	}
+
+	if(hasMixedBoundary)
+		OmniFEMMsg::instance()->MsgWarning("Mixed boundary conditions are not supported by the solver yet. These edges are treated as a zero surface charge");
+
+	for(auto periodicIterator = periodicEdges.begin(); periodicIterator != periodicEdges.end(); periodicIterator++)
+	{
+		if(periodicIterator->second.size() != 2)
+		{
+			OmniFEMMsg::instance()->MsgWarning("The periodic boundary " + periodicIterator->first + " must be assigned to exactly two edges. The boundary is skipped");
+			continue;
+		}
+
+		if(!constraints.tieEdges(periodicIterator->second[0]->orderedNodes, periodicIterator->second[1]->orderedNodes, x, y, periodicSign[periodicIterator->first]))
+			OmniFEMMsg::instance()->MsgWarning("The two edges of the periodic boundary " + periodicIterator->first + " do not have the same number of nodes. Set the same element size on both edges. The boundary is skipped");
+	}
+
+	if(constraints.getNumberOfConflicts() > 0)
+		OmniFEMMsg::instance()->MsgWarning(std::to_string(constraints.getNumberOfConflicts()) + " node(s) have conflicting voltages. The first voltage that was found is used");
+
+	if(!constraints.hasFixedValue())
+	{
+		OmniFEMMsg::instance()->MsgError("The voltage is not fixed anywhere in the problem. Add a fixed voltage boundary, conductor, or nodal property");
+		return false;
+	}
+
+	/* Only the nodes that are part of an element become unknowns. The center of an arc is a
+	 * vertex of the GMSH model but not part of the mesh
+	 */
+	std::vector<bool> isUsed(numberOfUnknowns, false);
+
+	for(auto blockIterator = blocks.begin(); blockIterator != blocks.end(); blockIterator++)
+	{
+		for(auto nodeIterator = blockIterator->nodes.begin(); nodeIterator != blockIterator->nodes.end(); nodeIterator++)
+			isUsed[*nodeIterator] = true;
+	}
+
+	linearSystemCSRIterative<double> system(linearSystemCSRIterative<double>::CG, linearSystemCSRIterative<double>::IC0);
+	dofManager<double> dofs(&system);
+
+	constraints.apply(dofs, isUsed);
+
+	if(dofs.sizeOfR() == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("All of the nodes of the mesh have a fixed voltage. There is nothing to solve");
+		return false;
+	}
+
+	/* Symbolic pass. The elements that have a node tied to another node go through the constraints of the
+	 * dofManager. That is not safe to run from more than one thread so these elements are assembled at the end by one thread
+	 */
+	std::vector<int> blockStart(blocks.size());
+	std::vector<std::pair<int, int>> tiedElements;
+	std::vector<bool> isTiedElement;
+	std::vector<Dof> R;
+
+	for(unsigned int b = 0; b < blocks.size(); b++)
+	{
+		const int n = blocks[b].numberOfNodes;
+		const int numberOfElements = blocks[b].regions.size();
+
+		blockStart[b] = dofs.getNumPatternElements();
+		R.resize(n, Dof(0, 0));
+
+		for(int e = 0; e < numberOfElements; e++)
+		{
+			bool isTied = false;
+
+			for(int i = 0; i < n; i++)
+			{
+				const int node = blocks[b].nodes[e * n + i];
+
+				R[i] = Dof(node, 0);
+				isTied = isTied || constraints.isTied(node);
+			}
+
+			dofs.insertElementInPattern(R);
+			isTiedElement.push_back(isTied);
+
+			if(isTied)
+				tiedElements.push_back(std::make_pair(b, e));
+		}
+	}
+
+	dofs.finalizePattern();
+
+	double patternTime = TimeOfDay();
+
+	/* Numeric pass. The colors are assembled one after the other. No two elements of the same color share a node
+	 * so the threads never add into the same row of the matrix
+	 */
+	for(unsigned int b = 0; b < blocks.size(); b++)
+	{
+		const solverMesh::elementBlock &block = blocks[b];
+		const int n = block.numberOfNodes;
+		const elementKernel kernel(block.type, axisymmetric);
+
+		for(unsigned int color = 0; color + 1 < block.colorOffset.size(); color++)
+		{
+			const int colorStart = block.colorOffset[color];
+			const int colorEnd = block.colorOffset[color + 1];
+			const int numberOfBatches = (colorEnd - colorStart + p_batchSize - 1) / p_batchSize;
+			const bool isParallel = ((int)color != block.serialColor);
+
+#if defined(_OPENMP)
+#pragma omp parallel if(isParallel)
+#endif
+			{
+				std::vector<double> buffer;
+				std::vector<double> matrices(p_batchSize * n * n);
+				std::vector<double> vectors(p_batchSize * n);
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+				for(int batch = 0; batch < numberOfBatches; batch++)
+				{
+					const int first = colorStart + batch * p_batchSize;
+					const int count = std::min(p_batchSize, colorEnd - first);
+
+					computeElements(block, first, count, kernel, regionEpsilonX, regionEpsilonY, regionSource, axisymmetric, buffer, &matrices[0], &vectors[0]);
+
+					for(int e = 0; e < count; e++)
+					{
+						const int patternIndex = blockStart[b] + first + e;
+
+						if(isTiedElement[patternIndex])
+							continue;
+
+						dofs.assembleElement(patternIndex, fullMatrix<double>(&matrices[e * n * n], n, n));
+						dofs.assembleElement(patternIndex, fullVector<double>(&vectors[e * n], n));
+					}
+				}
+			}
+		}
+	}
+
+	if(!tiedElements.empty())
+	{
+		std::vector<double> buffer;
+
+		for(auto elementIterator = tiedElements.begin(); elementIterator != tiedElements.end(); elementIterator++)
+		{
+			const solverMesh::elementBlock &block = blocks[elementIterator->first];
+			const int n = block.numberOfNodes;
+			const elementKernel kernel(block.type, axisymmetric);
+			std::vector<double> matrix(n * n);
+			std::vector<double> vector(n);
+
+			computeElements(block, elementIterator->second, 1, kernel, regionEpsilonX, regionEpsilonY, regionSource, axisymmetric, buffer, &matrix[0], &vector[0]);
+
+			dofs.assembleElement(blockStart[elementIterator->first] + elementIterator->second, fullMatrix<double>(&matrix[0], n, n));
+			dofs.assembleElement(blockStart[elementIterator->first] + elementIterator->second, fullVector<double>(&vector[0], n));
+		}
+	}
+
+	// The sources on the edges, the nodes, and the conductors
+	for(auto chargeIterator = surfaceCharges.begin(); chargeIterator != surfaceCharges.end(); chargeIterator++)
+	{
+		const solverMesh::edgeSegment &edge = *chargeIterator->first;
+		const int n = edge.numberOfNodes;
+		const elementKernel kernel(edge.type, axisymmetric);
+		std::vector<double> lineX(n), lineY(n), vector(n);
+		std::vector<Dof> lineDofs(n, Dof(0, 0));
+
+		for(unsigned int line = 0; line < edge.nodes.size() / n; line++)
+		{
+			for(int i = 0; i < n; i++)
+			{
+				lineX[i] = x[edge.nodes[line * n + i]];
+				lineY[i] = y[edge.nodes[line * n + i]];
+				lineDofs[i] = Dof(edge.nodes[line * n + i], 0);
+			}
+
+			kernel.lineLoad(&lineX[0], &lineY[0], chargeIterator->second, axisymmetric, &vector[0]);
+			dofs.assemble(lineDofs, fullVector<double>(&vector[0], n));
+		}
+	}
+
+	for(auto chargeIterator = pointCharges.begin(); chargeIterator != pointCharges.end(); chargeIterator++)
+		dofs.assemble(Dof(chargeIterator->first, 0), chargeIterator->second);
+
+	/* The total charge of a conductor is in C. For planar problems, this is spread over the depth of the problem. For
+	 * axisymmetric problems, the equation leaves out the factor of 2 pi
+	 */
+	for(unsigned int i = 0; i < p_conductors.size(); i++)
+	{
+		if(conductorUnknown[i] != -1)
+			dofs.assemble(Dof(conductorUnknown[i], 0), p_conductors[i].getValue() / (p_vacuumPermittivity * (axisymmetric ? 2.0 * M_PI : depth)));
+	}
+
+	double assemblyTime = TimeOfDay();
+
+	OmniFEMMsg::instance()->MsgStatus("Solving " + std::to_string(dofs.sizeOfR()) + " unknowns");
+
+	system.setPrec(p_preferences.getPrecision());
+	system.setMaxIterations(std::max(1000, 10 * dofs.sizeOfR()));
+
+	bool converged = (system.systemSolve() == 1);
+
+	double solveTime = TimeOfDay();
+
+	p_potential.resize(numberOfNodes);
+
+	for(int i = 0; i < numberOfNodes; i++)
+	{
+		if(isUsed[i])
+			dofs.getDofValue(Dof(i, 0), p_potential[i]);
+		else
+			p_potential[i] = 0;
+	}
+
+	p_conductorVoltage.assign(p_conductors.size(), 0);
+
+	for(unsigned int i = 0; i < p_conductors.size(); i++)
+	{
+		if(conductorUnknown[i] != -1)
+			dofs.getDofValue(Dof(conductorUnknown[i], 0), p_conductorVoltage[i]);
+		else
+			p_conductorVoltage[i] = p_conductors[i].getValue();
+	}
+
+	std::ostringstream timing;
+
+	timing << std::fixed << std::setprecision(3);
+	timing << "Mesh: " << meshTime - startTime << " s (" << numberOfNodes << " nodes, " << p_mesh->getNumberOfElements() << " elements)\n";
+	timing << "Sparsity pattern: " << patternTime - meshTime << " s\n";
+	timing << "Assembly: " << assemblyTime - patternTime << " s (" << p_mesh->getNumberOfColors() << " colors, " << numberOfThreads << " threads)\n";
+	timing << "Linear solver: " << solveTime - assemblyTime << " s (" << system.getNumIterations() << " iterations, residual " << std::scientific << std::setprecision(2) << system.getResidual() << ")\n";
+	timing << std::fixed << std::setprecision(3) << "Total: " << solveTime - startTime << " s";
+
+	OmniFEMMsg::instance()->MsgInfo(timing.str());
+
+	if(!converged)
+		OmniFEMMsg::instance()->MsgError("The linear solver did not converge to the requested precision");
+	else
+		OmniFEMMsg::instance()->MsgStatus("Solver Finished");
+
+	return converged;
+}
@@ -0,0 +1,269 @@
+#include <Solver/ElementKernels.h>
+
+#include <math.h>
+#include <algorithm>
+
+
+
+elementKernel::elementKernel(int type, bool axisymmetric, bool mass)
+{
+	const nodalBasis *basis = BasisFactory::getNodalBasis(type);
+	const int order = ElementType::OrderFromTag(type);
+	const int extraOrder = axisymmetric ? 1 : 0;
+	IntPt *points = nullptr;
+
+	p_type = type;
+	p_dimension = ElementType::DimensionFromTag(type);
+	p_numberOfNodes = basis->getNumShapeFunctions();
+
+	/* On a straight sided triangle, the product of two gradients is of order 2(p - 1). The quadrilaterals are not affine
+	 * so the product is of order 2p in each direction. The line loads only need the shape function itself. The product
+	 * of two shape functions is of order 2p on all of the elements
+	 */
+	switch(ElementType::ParentTypeFromTag(type))
+	{
+		case TYPE_LIN:
+			p_numberOfPoints = getNGQLPts((mass ? 2 * order : order) + extraOrder);
+			points = getGQLPts((mass ? 2 * order : order) + extraOrder);
+			break;
+		case TYPE_QUA:
+			p_numberOfPoints = getNGQQPts(2 * order + extraOrder);
+			points = getGQQPts(2 * order + extraOrder);
+			break;
+		default:
+			p_numberOfPoints = getNGQTPts((mass ? 2 * order : std::max(2 * order - 2, order)) + extraOrder);
+			points = getGQTPts((mass ? 2 * order : std::max(2 * order - 2, order)) + extraOrder);
+			break;
+	}
+
+	p_weights.resize(p_numberOfPoints);
+	p_shape.resize(p_numberOfPoints * p_numberOfNodes);
+	p_gradientU.resize(p_numberOfPoints * p_numberOfNodes);
+	p_gradientV.resize(p_numberOfPoints * p_numberOfNodes);
+
+	std::vector<double> gradients(3 * p_numberOfNodes);
+
+	for(int q = 0; q < p_numberOfPoints; q++)
+	{
+		p_weights[q] = points[q].weight;
+
+		basis->f(points[q].pt[0], points[q].pt[1], points[q].pt[2], &p_shape[q * p_numberOfNodes]);
+		basis->df(points[q].pt[0], points[q].pt[1], points[q].pt[2], (double (*)[3])gradients.data());
+
+		for(int i = 0; i < p_numberOfNodes; i++)
+		{
+			p_gradientU[q * p_numberOfNodes + i] = gradients[3 * i];
+			p_gradientV[q * p_numberOfNodes + i] = gradients[3 * i + 1];
+		}
+	}
+}
+
+
+
+void elementKernel::diffusion(const double *x, const double *y, double kx, double ky, double source, bool axisymmetric, double *matrix, double *vector) const
+{
+	const int n = p_numberOfNodes;
+	double gradientX[64];
+	double gradientY[64];
+
+	for(int i = 0; i < n * n; i++)
+		matrix[i] = 0;
+
+	if(vector)
+	{
+		for(int i = 0; i < n; i++)
+			vector[i] = 0;
+	}
+
+	for(int q = 0; q < p_numberOfPoints; q++)
+	{
+		const double *N = &p_shape[q * n];
+		const double *dNdu = &p_gradientU[q * n];
+		const double *dNdv = &p_gradientV[q * n];
+		double dxdu = 0, dxdv = 0, dydu = 0, dydv = 0, r = 0;
+
+		for(int i = 0; i < n; i++)
+		{
+			dxdu += x[i] * dNdu[i];
+			dxdv += x[i] * dNdv[i];
+			dydu += y[i] * dNdu[i];
+			dydv += y[i] * dNdv[i];
+			r += x[i] * N[i];
+		}
+
+		const double jacobian = dxdu * dydv - dxdv * dydu;
+		const double inverse = 1.0 / jacobian;
+		const double weight = p_weights[q] * fabs(jacobian) * (axisymmetric ? r : 1.0);
+
+		// The gradients in the reference element are mapped to the real element by the inverse of the transpose of the Jacobian
+		for(int i = 0; i < n; i++)
+		{
+			gradientX[i] = (dydv * dNdu[i] - dydu * dNdv[i]) * inverse;
+			gradientY[i] = (dxdu * dNdv[i] - dxdv * dNdu[i]) * inverse;
+		}
+
+		const double weightX = weight * kx;
+		const double weightY = weight * ky;
+
+		for(int j = 0; j < n; j++)
+		{
+			const double columnX = weightX * gradientX[j];
+			const double columnY = weightY * gradientY[j];
+			double *column = &matrix[j * n];
+
+			for(int i = 0; i < n; i++)
+				column[i] += gradientX[i] * columnX + gradientY[i] * columnY;
+		}
+
+		if(vector && source != 0)
+		{
+			for(int i = 0; i < n; i++)
+				vector[i] += weight * source * N[i];
+		}
+	}
+}
+
+
+
+double elementKernel::mapGradients(int point, const double *x, const double *y, double *gradientX, double *gradientY, double &r) const
+{
+	const int n = p_numberOfNodes;
+	const double *N = &p_shape[point * n];
+	const double *dNdu = &p_gradientU[point * n];
+	const double *dNdv = &p_gradientV[point * n];
+	double dxdu = 0, dxdv = 0, dydu = 0, dydv = 0;
+
+	r = 0;
+
+	for(int i = 0; i < n; i++)
+	{
+		dxdu += x[i] * dNdu[i];
+		dxdv += x[i] * dNdv[i];
+		dydu += y[i] * dNdu[i];
+		dydv += y[i] * dNdv[i];
+		r += x[i] * N[i];
+	}
+
+	const double jacobian = dxdu * dydv - dxdv * dydu;
+	const double inverse = 1.0 / jacobian;
+
+	for(int i = 0; i < n; i++)
+	{
+		gradientX[i] = (dydv * dNdu[i] - dydu * dNdv[i]) * inverse;
+		gradientY[i] = (dxdu * dNdv[i] - dxdv * dNdu[i]) * inverse;
+	}
+
+	return p_weights[point] * fabs(jacobian);
+}
+
+
+
+double elementKernel::mapLine(int point, const double *x, const double *y, double &r) const
+{
+	const int n = p_numberOfNodes;
+	const double *N = &p_shape[point * n];
+	const double *dNdu = &p_gradientU[point * n];
+	double dxdu = 0, dydu = 0;
+
+	r = 0;
+
+	for(int i = 0; i < n; i++)
+	{
+		dxdu += x[i] * dNdu[i];
+		dydu += y[i] * dNdu[i];
+		r += x[i] * N[i];
+	}
+
+	return p_weights[point] * sqrt(dxdu * dxdu + dydu * dydu);
+}
+
+
+
+void elementKernel::lineLoad(const double *x, const double *y, double source, bool axisymmetric, double *vector) const
+{
+	const int n = p_numberOfNodes;
+
+	for(int i = 0; i < n; i++)
+		vector[i] = 0;
+
+	for(int q = 0; q < p_numberOfPoints; q++)
+	{
+		const double *N = &p_shape[q * n];
+		const double *dNdu = &p_gradientU[q * n];
+		double dxdu = 0, dydu = 0, r = 0;
+
+		for(int i = 0; i < n; i++)
+		{
+			dxdu += x[i] * dNdu[i];
+			dydu += y[i] * dNdu[i];
+			r += x[i] * N[i];
+		}
+
+		const double weight = p_weights[q] * sqrt(dxdu * dxdu + dydu * dydu) * (axisymmetric ? r : 1.0) * source;
+
+		for(int i = 0; i < n; i++)
+			vector[i] += weight * N[i];
+	}
+}
+
+
+
+void triangleDiffusionBatch(int count, const double *x, const double *y, const double *kx, const double *ky, const double *source, bool axisymmetric, double *matrix, double *vector)
+{
+	const double *x0 = x, *x1 = x + count, *x2 = x + 2 * count;
+	const double *y0 = y, *y1 = y + count, *y2 = y + 2 * count;
+
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+	for(int e = 0; e < count; e++)
+	{
+		// The gradient of shape function i is (b[i], c[i]) / (2 * area)
+		const double b0 = y1[e] - y2[e];
+		const double b1 = y2[e] - y0[e];
+		const double b2 = y0[e] - y1[e];
+		const double c0 = x2[e] - x1[e];
+		const double c1 = x0[e] - x2[e];
+		const double c2 = x1[e] - x0[e];
+		const double area = 0.5 * fabs(b0 * c1 - b1 * c0);
+		const double rCentroid = (x0[e] + x1[e] + x2[e]) / 3.0;
+		const double factor = (axisymmetric ? rCentroid : 1.0) / (4.0 * area);
+		const double fx = kx[e] * factor;
+		const double fy = ky[e] * factor;
+
+		const double k00 = fx * b0 * b0 + fy * c0 * c0;
+		const double k11 = fx * b1 * b1 + fy * c1 * c1;
+		const double k22 = fx * b2 * b2 + fy * c2 * c2;
+		const double k01 = fx * b0 * b1 + fy * c0 * c1;
+		const double k02 = fx * b0 * b2 + fy * c0 * c2;
+		const double k12 = fx * b1 * b2 + fy * c1 * c2;
+
+		matrix[0 * count + e] = k00;
+		matrix[1 * count + e] = k01;
+		matrix[2 * count + e] = k02;
+		matrix[3 * count + e] = k01;
+		matrix[4 * count + e] = k11;
+		matrix[5 * count + e] = k12;
+		matrix[6 * count + e] = k02;
+		matrix[7 * count + e] = k12;
+		matrix[8 * count + e] = k22;
+
+		// The integral of N_i * r over the triangle is area * (2 r_i + r_j + r_k) / 12
+		if(axisymmetric)
+		{
+			const double s = source[e] * area / 12.0;
+
+			vector[0 * count + e] = s * (2.0 * x0[e] + x1[e] + x2[e]);
+			vector[1 * count + e] = s * (x0[e] + 2.0 * x1[e] + x2[e]);
+			vector[2 * count + e] = s * (x0[e] + x1[e] + 2.0 * x2[e]);
+		}
+		else
+		{
+			const double s = source[e] * area / 3.0;
+
+			vector[0 * count + e] = s;
+			vector[1 * count + e] = s;
+			vector[2 * count + e] = s;
+		}
+	}
+}
@@ -0,0 +1,228 @@
+#include <Solver/ErrorEstimator.h>
+
+#include <algorithm>
+
+
+
+errorEstimator::errorEstimator(solverMesh *mesh, int radialExponent)
+{
+	p_mesh = mesh;
+	p_radialExponent = radialExponent;
+}
+
+
+
+void errorEstimator::estimate(const std::vector<double> &unknown, const std::vector<double> &coefficientX, const std::vector<double> &coefficientY)
+{
+	const int numberOfNodes = p_mesh->getNumberOfNodes();
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+	const bool axisymmetric = (p_radialExponent != 0);
+	const int radialExponent = p_radialExponent;
+	std::vector<solverMesh::elementBlock> &blocks = *p_mesh->getElementBlocks();
+
+	/* The recovered gradient is stored once for each pair of a node and a face that the node is part of. The slots of a node are a linked
+	 * list since a node is part of only a few faces
+	 */
+	std::vector<int> firstSlot(numberOfNodes, -1);
+	std::vector<int> nextSlot;
+	std::vector<int> slotRegion;
+	std::vector<std::vector<int>> elementSlots(blocks.size());
+	std::vector<int> blockStart(blocks.size() + 1, 0);
+
+	for(unsigned int b = 0; b < blocks.size(); b++)
+	{
+		const int n = blocks[b].numberOfNodes;
+		const int numberOfElements = blocks[b].regions.size();
+
+		blockStart[b + 1] = blockStart[b] + numberOfElements;
+		elementSlots[b].resize(blocks[b].nodes.size());
+
+		for(int e = 0; e < numberOfElements; e++)
+		{
+			const int region = blocks[b].regions[e];
+
+			for(int i = 0; i < n; i++)
+			{
+				const int node = blocks[b].nodes[e * n + i];
+				int slot = firstSlot[node];
+
+				while(slot != -1 && slotRegion[slot] != region)
+					slot = nextSlot[slot];
+
+				if(slot == -1)
+				{
+					slot = slotRegion.size();
+					slotRegion.push_back(region);
+					nextSlot.push_back(firstSlot[node]);
+					firstSlot[node] = slot;
+				}
+
+				elementSlots[b][e * n + i] = slot;
+			}
+		}
+	}
+
+	std::vector<double> recoveredX(slotRegion.size(), 0.0);
+	std::vector<double> recoveredY(slotRegion.size(), 0.0);
+	std::vector<double> slotWeight(slotRegion.size(), 0.0);
+
+	p_elementArea.assign(blockStart.back(), 0.0);
+	p_elementError.assign(blockStart.back(), 0.0);
+	p_elementEnergy.assign(blockStart.back(), 0.0);
+
+	/* The gradient of each element is evaluated at its own nodes and added into the slots of the nodes weighted by the area of the element */
+	for(unsigned int b = 0; b < blocks.size(); b++)
+	{
+		const solverMesh::elementBlock &block = blocks[b];
+		const int n = block.numberOfNodes;
+		const elementKernel kernel(block.type, axisymmetric, true);
+		const nodalBasis *basis = BasisFactory::getNodalBasis(block.type);
+		const fullMatrix<double> &referenceNodes = basis->getReferenceNodes();
+		const int *slots = elementSlots[b].data();
+		double *areas = &p_elementArea[blockStart[b]];
+		std::vector<double> nodalGradientU(n * n), nodalGradientV(n * n), gradients(3 * n);
+
+		// The derivative of shape function j at node i is at i * n + j
+		for(int i = 0; i < n; i++)
+		{
+			basis->df(referenceNodes(i, 0), referenceNodes(i, 1), 0.0, (double (*)[3])gradients.data());
+
+			for(int j = 0; j < n; j++)
+			{
+				nodalGradientU[i * n + j] = gradients[3 * j];
+				nodalGradientV[i * n + j] = gradients[3 * j + 1];
+			}
+		}
+
+		for(unsigned int color = 0; color + 1 < block.colorOffset.size(); color++)
+		{
+			const int colorStart = block.colorOffset[color];
+			const int colorEnd = block.colorOffset[color + 1];
+			const bool isParallel = ((int)color != block.serialColor);
+
+#if defined(_OPENMP)
+#pragma omp parallel for if(isParallel) schedule(static)
+#endif
+			for(int e = colorStart; e < colorEnd; e++)
+			{
+				const int *nodes = &block.nodes[e * n];
+				double elementX[64], elementY[64], elementU[64], gradientX[64], gradientY[64];
+				double area = 0;
+				double r;
+
+				for(int i = 0; i < n; i++)
+				{
+					elementX[i] = x[nodes[i]];
+					elementY[i] = y[nodes[i]];
+					elementU[i] = unknown[nodes[i]];
+				}
+
+				for(int q = 0; q < kernel.getNumberOfPoints(); q++)
+					area += kernel.mapGradients(q, elementX, elementY, gradientX, gradientY, r);
+
+				areas[e] = area;
+
+				for(int i = 0; i < n; i++)
+				{
+					const double *dNdu = &nodalGradientU[i * n];
+					const double *dNdv = &nodalGradientV[i * n];
+					double dxdu = 0, dxdv = 0, dydu = 0, dydv = 0, dudu = 0, dudv = 0;
+
+					for(int j = 0; j < n; j++)
+					{
+						dxdu += elementX[j] * dNdu[j];
+						dxdv += elementX[j] * dNdv[j];
+						dydu += elementY[j] * dNdu[j];
+						dydv += elementY[j] * dNdv[j];
+						dudu += elementU[j] * dNdu[j];
+						dudv += elementU[j] * dNdv[j];
+					}
+
+					const double inverse = 1.0 / (dxdu * dydv - dxdv * dydu);
+					const int slot = slots[e * n + i];
+
+					recoveredX[slot] += area * (dydv * dudu - dydu * dudv) * inverse;
+					recoveredY[slot] += area * (dxdu * dudv - dxdv * dudu) * inverse;
+					slotWeight[slot] += area;
+				}
+			}
+		}
+	}
+
+	for(unsigned int s = 0; s < slotWeight.size(); s++)
+	{
+		if(slotWeight[s] > 0)
+		{
+			recoveredX[s] /= slotWeight[s];
+			recoveredY[s] /= slotWeight[s];
+		}
+	}
+
+	/* The difference between the recovered gradient and the gradient of the element is integrated over each element. No element
+	 * writes into the data of another element so all of the elements of a block are split over the threads
+	 */
+	double energy = 0;
+	double error = 0;
+
+	for(unsigned int b = 0; b < blocks.size(); b++)
+	{
+		const solverMesh::elementBlock &block = blocks[b];
+		const int n = block.numberOfNodes;
+		const int numberOfElements = block.regions.size();
+		const elementKernel kernel(block.type, axisymmetric, true);
+		const int *slots = elementSlots[b].data();
+
+#if defined(_OPENMP)
+#pragma omp parallel for reduction(+:energy, error) schedule(static)
+#endif
+		for(int e = 0; e < numberOfElements; e++)
+		{
+			const int *nodes = &block.nodes[e * n];
+			const double kx = coefficientX[blockStart[b] + e];
+			const double ky = coefficientY[blockStart[b] + e];
+			double elementX[64], elementY[64], gradientX[64], gradientY[64];
+			double elementEnergy = 0, elementError = 0;
+			double r;
+
+			for(int i = 0; i < n; i++)
+			{
+				elementX[i] = x[nodes[i]];
+				elementY[i] = y[nodes[i]];
+			}
+
+			for(int q = 0; q < kernel.getNumberOfPoints(); q++)
+			{
+				double weight = kernel.mapGradients(q, elementX, elementY, gradientX, gradientY, r);
+				const double *N = kernel.getShapeFunctions(q);
+				double solutionX = 0, solutionY = 0, smoothX = 0, smoothY = 0;
+
+				if(radialExponent > 0)
+					weight *= r;
+				else if(radialExponent < 0)
+					weight /= std::max(r, 1e-300);
+
+				for(int i = 0; i < n; i++)
+				{
+					const int slot = slots[e * n + i];
+
+					solutionX += unknown[nodes[i]] * gradientX[i];
+					solutionY += unknown[nodes[i]] * gradientY[i];
+					smoothX += N[i] * recoveredX[slot];
+					smoothY += N[i] * recoveredY[slot];
+				}
+
+				elementEnergy += weight * (kx * solutionX * solutionX + ky * solutionY * solutionY);
+				elementError += weight * (kx * (smoothX - solutionX) * (smoothX - solutionX) + ky * (smoothY - solutionY) * (smoothY - solutionY));
+			}
+
+			p_elementEnergy[blockStart[b] + e] = elementEnergy;
+			p_elementError[blockStart[b] + e] = elementError;
+			energy += elementEnergy;
+			error += elementError;
+		}
+	}
+
+	p_energy = energy;
+	p_error = error;
+}
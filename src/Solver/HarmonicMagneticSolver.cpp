@@ -0,0 +1,959 @@
+#include <Solver/HarmonicMagneticSolver.h>
+
+#include <math.h>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+
+const int harmonicMagneticSolver::p_batchSize;
+
+
+
+harmonicMagneticSolver::harmonicMagneticSolver(problemDefinition &definition, GModel *model)
+{
+	p_model = model;
+
+	p_materials = *definition.getMagnetMaterialList();
+	p_boundaries = *definition.getMagneticBoundaryList();
+	p_circuits = *definition.getCircuitList();
+	p_nodalProperties = *definition.getNodalPropertyList();
+	p_preferences = definition.getMagneticPreference();
+}
+
+
+
+std::complex<double> harmonicMagneticSolver::getBesselRatio(std::complex<double> z)
+{
+	if(std::abs(z) < 1e-150)
+		return 0;
+
+	// J(n) / J(n - 1) = 1 / (2 n / z - J(n + 1) / J(n)) starting far enough past |z| that the ratio is negligible
+	const int start = 30 + 2 * (int)std::abs(z);
+	std::complex<double> ratio = 0;
+	std::complex<double> secondRatio = 0;
+
+	for(int n = start; n >= 1; n--)
+	{
+		ratio = 1.0 / (2.0 * n / z - ratio);
+
+		if(n == 2)
+			secondRatio = ratio;
+	}
+
+	// J2 / J0 = (J2 / J1) * (J1 / J0). The product avoids the cancellation of 2 J1 / (z J0) - 1 for a small argument
+	return secondRatio * ratio;
+}
+
+
+
+void harmonicMagneticSolver::createRegionLaws(std::vector<regionLaw> &laws, std::vector<double> &conductorCurrents)
+{
+	std::vector<solverMesh::region> &regions = *p_mesh->getRegions();
+	std::vector<regionLaw> materialLaws(p_materials.size());
+	std::vector<bool> isWire(p_materials.size(), false);
+	bool hasNonlinear = false;
+	bool hasMagnet = false;
+
+	for(unsigned int m = 0; m < p_materials.size(); m++)
+	{
+		magneticMaterial &material = p_materials[m];
+		regionLaw &law = materialLaws[m];
+		const lamWireEnum attribute = material.getSpecialAttribute();
+		const double conductivity = std::max(material.getSigma(), 0.0) * 1e6;
+		const double fillFactor = magneticRegions::getFillFactor(material);
+		double permeabilityX = (material.getMUrX() > 0) ? material.getMUrX() : 1.0;
+		double permeabilityY = (material.getMUrY() > 0) ? material.getMUrY() : 1.0;
+
+		if(!material.getBHState())
+		{
+			jilesAthertonParameters parameters = material.getJilesAtherton();
+			std::vector<double> flux, field;
+
+			if(bhCurve::getAnhystereticCurve(parameters, 1.0, flux, field))
+			{
+				permeabilityX = bhCurve(flux, field).getInitialPermeability();
+				permeabilityY = permeabilityX;
+			}
+
+			hasNonlinear = true;
+		}
+
+		hasMagnet = hasMagnet || (material.getCoercivity() != 0);
+
+		// The hysteresis lag makes the flux density lag behind the field intensity
+		law.permeabilityX = std::polar(permeabilityX, -material.getPhiX() * M_PI / 180.0);
+		law.permeabilityY = std::polar(permeabilityY, -material.getPhiY() * M_PI / 180.0);
+		law.source = p_vacuumPermeability * material.getCurrentDensity() * 1e6;
+		law.materialConductivity = conductivity;
+		law.fillFactor = fillFactor;
+
+		std::complex<double> mixedX = law.permeabilityX;
+		std::complex<double> mixedY = law.permeabilityY;
+
+		magneticRegions::mixLaminations(attribute, fillFactor, mixedX, mixedY);
+
+		switch(attribute)
+		{
+			case LAMINATED_IN_PLANE:
+				// The laminations are stacked along z so no current flows along z. The eddy currents within each lamination depend on the frequency
+				law.thickness = material.getLaminationThickness() * 1e-3;
+
+				if(law.thickness > 0 && conductivity > 0)
+					law.model = frequencyModel::LAMINATION;
+				break;
+			case LAMINATED_PARALLEL_X_OR_R_AXISYMMETRIC:
+			case LAMINATED_PARALLEL_Y_OR_Z_AXISYMMETRIC:
+				law.conductivity = p_vacuumPermeability * fillFactor * conductivity;
+				break;
+			case MAGNET_WIRE:
+			case PLAIN_STRANDED_WIRE:
+			case LITZ_WIRE:
+			case SQUARE_WIRE:
+			case CCA_10:
+			case CCA_15:
+				// The strands are insulated from each other so the current is spread evenly. The fill factor is found once the area is known
+				isWire[m] = true;
+				law.thickness = 0.5 * material.getStrandDiameter() * 1e-3;
+
+				if(law.thickness > 0 && conductivity > 0)
+					law.model = frequencyModel::STRANDS;
+
+				mixedX = 1;
+				mixedY = 1;
+				break;
+			default:
+				law.conductivity = p_vacuumPermeability * conductivity;
+				break;
+		}
+
+		// The x derivative of the potential is the y component of the flux density and the other way around
+		law.reluctivityXX = 1.0 / mixedY;
+		law.reluctivityYY = 1.0 / mixedX;
+	}
+
+	if(hasNonlinear)
+		OmniFEMMsg::instance()->MsgWarning("Time harmonic problems are solved with linear materials. The nonlinear materials use their initial permeability");
+
+	if(hasMagnet)
+		OmniFEMMsg::instance()->MsgWarning("The coercivity of permanent magnets is a constant source and is left out of time harmonic problems");
+
+	magneticRegions regionGroups(p_mesh, p_materials, p_circuits);
+	std::vector<double> areas = p_mesh->getRegionAreas();
+
+	laws.assign(regions.size(), regionLaw());
+	conductorCurrents.clear();
+
+	for(unsigned int r = 0; r < regions.size(); r++)
+	{
+		const int material = regionGroups.getMaterial(r);
+
+		if(material == -1)
+			continue;
+
+		laws[r] = materialLaws[material];
+
+		// The fill factor of a winding is the copper area of all of the strands of all of the turns over the area of the block
+		if(isWire[material])
+		{
+			const double strands = std::max(1u, p_materials[material].getNumberStrands());
+
+			laws[r].fillFactor = (areas[r] > 0) ? fabs(regionGroups.getTurns(r)) * strands * M_PI * laws[r].thickness * laws[r].thickness / areas[r] : 0;
+			laws[r].fillFactor = std::min(laws[r].fillFactor, 1.0);
+		}
+	}
+
+	/* A block of a circuit is a solid conductor if it has one turn and carries eddy currents. Its current is imposed through a voltage
+	 * gradient unknown. The other blocks of a circuit carry a uniform current density
+	 */
+	for(unsigned int c = 0; c < p_circuits.size(); c++)
+	{
+		const double current = p_circuits[c].getCurrent();
+		double totalArea = 0;
+		bool allSolid = true;
+		bool anySolid = false;
+		bool hasRegion = false;
+
+		for(unsigned int r = 0; r < regions.size(); r++)
+		{
+			if(regionGroups.getCircuit(r) != (int)c)
+				continue;
+
+			const bool isSolid = (laws[r].conductivity > 0 && regionGroups.getTurns(r) == 1.0);
+
+			hasRegion = true;
+			totalArea += areas[r];
+			allSolid = allSolid && isSolid;
+			anySolid = anySolid || isSolid;
+		}
+
+		if(!hasRegion)
+			continue;
+
+		if(p_circuits[c].getCircuitSeriesState())
+		{
+			for(unsigned int r = 0; r < regions.size(); r++)
+			{
+				if(regionGroups.getCircuit(r) != (int)c || areas[r] <= 0)
+					continue;
+
+				if(laws[r].conductivity > 0 && regionGroups.getTurns(r) == 1.0)
+				{
+					laws[r].conductor = conductorCurrents.size();
+					conductorCurrents.push_back(current);
+				}
+				else
+				{
+					// The eddy currents within the turns of a winding are not modeled
+					laws[r].conductivity = 0;
+					laws[r].source += p_vacuumPermeability * current * regionGroups.getTurns(r) / areas[r];
+				}
+			}
+		}
+		else if(allSolid)
+		{
+			for(unsigned int r = 0; r < regions.size(); r++)
+			{
+				if(regionGroups.getCircuit(r) == (int)c)
+					laws[r].conductor = conductorCurrents.size();
+			}
+
+			conductorCurrents.push_back(current);
+		}
+		else
+		{
+			if(anySolid)
+				OmniFEMMsg::instance()->MsgWarning("The parallel circuit " + p_circuits[c].getName() + " has blocks that are not solid conductors. The current is spread evenly over all of its blocks");
+
+			for(unsigned int r = 0; r < regions.size(); r++)
+			{
+				if(regionGroups.getCircuit(r) != (int)c || totalArea <= 0)
+					continue;
+
+				laws[r].conductivity = 0;
+				laws[r].source += p_vacuumPermeability * current / totalArea;
+			}
+		}
+	}
+}
+
+
+
+void harmonicMagneticSolver::updateRegionLaws(std::vector<regionLaw> &laws, double frequency)
+{
+	const double angularFrequency = 2 * M_PI * frequency;
+	const std::complex<double> j(0, 1);
+
+	for(auto lawIterator = laws.begin(); lawIterator != laws.end(); lawIterator++)
+	{
+		if(lawIterator->model == frequencyModel::LAMINATION)
+		{
+			// The flux in a lamination of thickness d falls off toward the middle: mu_eff = mu tanh(k d / 2) / (k d / 2) with k^2 = j w mu sigma
+			std::complex<double> permeability[2] = {lawIterator->permeabilityX, lawIterator->permeabilityY};
+
+			for(int direction = 0; direction < 2; direction++)
+			{
+				const std::complex<double> k = std::sqrt(j * angularFrequency * p_vacuumPermeability * permeability[direction] * lawIterator->materialConductivity);
+				const std::complex<double> z = 0.5 * k * lawIterator->thickness;
+
+				if(std::abs(z) > 1e-8)
+					permeability[direction] *= std::tanh(z) / z;
+
+				permeability[direction] = lawIterator->fillFactor * permeability[direction] + (1 - lawIterator->fillFactor);
+			}
+
+			lawIterator->reluctivityXX = 1.0 / permeability[1];
+			lawIterator->reluctivityYY = 1.0 / permeability[0];
+		}
+		else if(lawIterator->model == frequencyModel::STRANDS)
+		{
+			/* A round strand of radius a in a uniform field H is magnetized by its eddy currents: M = 2 J2(ka) / J0(ka) H with k^2 = -j w mu0 sigma.
+			 * The strands are mixed with the space between them with the two dimensional Maxwell Garnett rule
+			 */
+			const std::complex<double> k = std::sqrt(-j * angularFrequency * p_vacuumPermeability * lawIterator->materialConductivity);
+			const std::complex<double> polarizability = 2.0 * getBesselRatio(k * lawIterator->thickness);
+			const std::complex<double> filled = lawIterator->fillFactor * polarizability;
+			const std::complex<double> permeability = 1.0 + filled / (1.0 - 0.5 * filled);
+
+			lawIterator->reluctivityXX = 1.0 / permeability;
+			lawIterator->reluctivityYY = 1.0 / permeability;
+		}
+	}
+}
+
+
+
+void harmonicMagneticSolver::computeElements(const solverMesh::elementBlock &block, int first, int count, const elementKernel &kernel, const elementKernel &massKernel,
+											 const std::vector<regionLaw> &laws, elementPart part, bool axisymmetric, std::vector<double> &buffer,
+											 std::complex<double> *matrices, std::complex<double> *vectors)
+{
+	const int n = block.numberOfNodes;
+	const int stride = n + 1;
+	const int *nodes = &block.nodes[first * n];
+	const int *regions = &block.regions[first];
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+
+	buffer.resize(4 * n);
+
+	double *elementX = &buffer[0];
+	double *elementY = elementX + n;
+	double *gradientX = elementY + n;
+	double *gradientY = gradientX + n;
+
+	for(int e = 0; e < count; e++)
+	{
+		const regionLaw &law = laws[regions[e]];
+		const int size = (law.conductor != -1) ? n + 1 : n;
+		std::complex<double> *matrix = &matrices[e * stride * stride];
+		std::complex<double> *vector = &vectors[e * stride];
+
+		for(int i = 0; i < size * size; i++)
+			matrix[i] = 0;
+
+		for(int i = 0; i < size; i++)
+			vector[i] = 0;
+
+		for(int i = 0; i < n; i++)
+		{
+			elementX[i] = x[nodes[e * n + i]];
+			elementY[i] = y[nodes[e * n + i]];
+		}
+
+		if(part == elementPart::EDDY)
+		{
+			if(law.conductivity == 0)
+				continue;
+
+			/* The eddy current density is j w sigma (U - A) / r where U is the voltage gradient unknown (zero if the region does not have one).
+			 * The matrix is the mass matrix of the shape functions extended by -1 for the voltage gradient
+			 */
+			for(int q = 0; q < massKernel.getNumberOfPoints(); q++)
+			{
+				const double *N = massKernel.getShapeFunctions(q);
+				double r;
+				const double jacobianWeight = massKernel.mapGradients(q, elementX, elementY, gradientX, gradientY, r);
+				const double weight = law.conductivity * jacobianWeight / (axisymmetric ? r : 1.0);
+
+				for(int j = 0; j < n; j++)
+				{
+					const double column = weight * N[j];
+
+					for(int i = 0; i < n; i++)
+						matrix[j * size + i] += N[i] * column;
+				}
+
+				if(size > n)
+				{
+					for(int i = 0; i < n; i++)
+					{
+						matrix[n * size + i] -= weight * N[i];
+						matrix[i * size + n] -= weight * N[i];
+					}
+
+					matrix[n * size + n] += weight;
+				}
+			}
+
+			continue;
+		}
+
+		const bool hasStiffness = (part == elementPart::STATIC) ? (law.model == frequencyModel::NONE) : (law.model != frequencyModel::NONE);
+
+		for(int q = 0; q < kernel.getNumberOfPoints(); q++)
+		{
+			const double *N = kernel.getShapeFunctions(q);
+			double r;
+			const double jacobianWeight = kernel.mapGradients(q, elementX, elementY, gradientX, gradientY, r);
+
+			if(hasStiffness)
+			{
+				const double weight = jacobianWeight / (axisymmetric ? r : 1.0);
+
+				for(int j = 0; j < n; j++)
+				{
+					const std::complex<double> columnX = weight * law.reluctivityXX * gradientX[j];
+					const std::complex<double> columnY = weight * law.reluctivityYY * gradientY[j];
+					std::complex<double> *column = &matrix[j * size];
+
+					for(int i = 0; i < n; i++)
+						column[i] += gradientX[i] * columnX + gradientY[i] * columnY;
+				}
+			}
+
+			if(part == elementPart::STATIC && law.source != 0.0)
+			{
+				for(int i = 0; i < n; i++)
+					vector[i] += jacobianWeight * law.source * N[i];
+			}
+		}
+	}
+}
+
+
+
+void harmonicMagneticSolver::computeResults(const solverMesh::elementBlock &block, const elementKernel &kernel, const std::vector<regionLaw> &laws,
+											const std::vector<std::complex<double>> &solution, const std::vector<std::complex<double>> &voltages, double frequency,
+											bool axisymmetric, std::complex<double> *fluxX, std::complex<double> *fluxY, std::complex<double> *current)
+{
+	const int n = block.numberOfNodes;
+	const int numberOfElements = block.regions.size();
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+	// The flux density is (dA/dy, -dA/dx) for planar problems and (-dA/dz, dA/dr) / r for axisymmetric problems
+	const double orientation = axisymmetric ? -1.0 : 1.0;
+	const std::complex<double> jw(0, 2 * M_PI * frequency);
+
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+	{
+		std::vector<double> elementX(n), elementY(n), gradientX(n), gradientY(n);
+		std::vector<std::complex<double>> elementU(n);
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+		for(int e = 0; e < numberOfElements; e++)
+		{
+			const regionLaw &law = laws[block.regions[e]];
+			const std::complex<double> voltage = (law.conductor != -1) ? voltages[law.conductor] : 0.0;
+			std::complex<double> averageX = 0, averageY = 0, averageCurrent = 0;
+			double area = 0;
+
+			for(int i = 0; i < n; i++)
+			{
+				elementX[i] = x[block.nodes[e * n + i]];
+				elementY[i] = y[block.nodes[e * n + i]];
+				elementU[i] = solution[block.nodes[e * n + i]];
+			}
+
+			for(int q = 0; q < kernel.getNumberOfPoints(); q++)
+			{
+				const double *N = kernel.getShapeFunctions(q);
+				double r;
+				const double jacobianWeight = kernel.mapGradients(q, &elementX[0], &elementY[0], &gradientX[0], &gradientY[0], r);
+				std::complex<double> potential = 0, potentialX = 0, potentialY = 0;
+
+				if(!axisymmetric)
+					r = 1.0;
+
+				for(int i = 0; i < n; i++)
+				{
+					potential += elementU[i] * N[i];
+					potentialX += elementU[i] * gradientX[i];
+					potentialY += elementU[i] * gradientY[i];
+				}
+
+				area += jacobianWeight;
+				averageX += jacobianWeight * orientation * potentialY / r;
+				averageY -= jacobianWeight * orientation * potentialX / r;
+				averageCurrent += jacobianWeight * (law.source + jw * law.conductivity * (voltage - potential) / r);
+			}
+
+			fluxX[e] = averageX / area;
+			fluxY[e] = averageY / area;
+			current[e] = averageCurrent / (area * p_vacuumPermeability);
+		}
+	}
+}
+
+
+
+bool harmonicMagneticSolver::solve(const std::vector<double> &frequencies)
+{
+	typedef std::complex<double> complex;
+
+	const bool axisymmetric = p_preferences.isAxistmmetric();
+	const double scale = solverMesh::getUnitScale(p_preferences.getUnitLength());
+	double precision = p_preferences.getPrecision();
+	double startTime = TimeOfDay();
+	int numberOfThreads = 1;
+
+#if defined(_OPENMP)
+	numberOfThreads = omp_get_max_threads();
+#endif
+
+	if(precision <= 0)
+		precision = 1e-8;
+
+	p_frequencies.clear();
+	p_potential.clear();
+	p_fluxDensityX.clear();
+	p_fluxDensityY.clear();
+	p_currentDensity.clear();
+
+	if(frequencies.empty() || *std::min_element(frequencies.begin(), frequencies.end()) <= 0)
+	{
+		OmniFEMMsg::instance()->MsgError("The frequencies of a time harmonic problem must be larger than zero. Use the magnetostatic solver for a frequency of zero");
+		return false;
+	}
+
+	OmniFEMMsg::instance()->MsgStatus("Reading the mesh");
+
+	delete p_mesh;
+	p_mesh = new solverMesh(p_model, scale);
+
+	const int numberOfNodes = p_mesh->getNumberOfNodes();
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+	std::vector<solverMesh::elementBlock> &blocks = *p_mesh->getElementBlocks();
+
+	if(p_mesh->getNumberOfElements() == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("The mesh does not have any elements. Create the mesh before running the solver");
+		return false;
+	}
+
+	double meshTime = TimeOfDay();
+
+	std::vector<regionLaw> laws;
+	std::vector<double> conductorCurrents;
+
+	createRegionLaws(laws, conductorCurrents);
+
+	const int numberOfConductors = conductorCurrents.size();
+	bool hasDependentRegion = false;
+	bool hasEddyCurrents = false;
+
+	for(auto lawIterator = laws.begin(); lawIterator != laws.end(); lawIterator++)
+	{
+		hasDependentRegion = hasDependentRegion || (lawIterator->model != frequencyModel::NONE);
+		hasEddyCurrents = hasEddyCurrents || (lawIterator->conductivity > 0);
+	}
+
+	double materialTime = TimeOfDay();
+
+	/* The constraints only hold real values. So, the periodic boundaries are tied first, which makes the root of every node final.
+	 * The complex fixed values are then kept by root and given to the dofManager once the constraints have been applied
+	 */
+	potentialConstraints constraints(numberOfNodes);
+	magneticConditions conditions(p_mesh, p_boundaries, p_nodalProperties, axisymmetric, scale);
+	const std::vector<magneticConditions::fixedPotential> &fixedValues = conditions.getFixedValues();
+	std::vector<std::pair<const solverMesh::edgeSegment*, complex>> impedanceEdges;
+
+	if(conditions.hasUnsupportedBoundary())
+		OmniFEMMsg::instance()->MsgWarning("Mixed and strategic dual image boundary conditions are not supported by the time harmonic solver yet. These edges are treated as a zero tangential field");
+
+	for(auto edgeIterator = conditions.getSkinDepthEdges().begin(); edgeIterator != conditions.getSkinDepthEdges().end(); edgeIterator++)
+	{
+		/* Past the edge is a good conductor where the field falls off as e^(-(1 + j) d / delta). The normal derivative of the
+		 * potential on the edge is then -(1 + j) / (mu delta) A. The skin depth goes with 1 / sqrt(w) so the coefficient is
+		 * kept without the square root of the angular frequency
+		 */
+		magneticBoundary boundary = edgeIterator->second;
+		const double permeability = (boundary.getMu() > 0) ? boundary.getMu() : 1.0;
+		const double conductivity = boundary.getSigma() * 1e6;
+
+		if(conductivity > 0)
+			impedanceEdges.push_back(std::make_pair(edgeIterator->first, complex(1, 1) * sqrt(p_vacuumPermeability * conductivity / (2 * permeability))));
+	}
+
+	conditions.tiePeriodicEdges(constraints);
+
+	std::map<int, complex> rootValues;
+	int numberOfConflicts = 0;
+
+	for(auto fixedIterator = fixedValues.begin(); fixedIterator != fixedValues.end(); fixedIterator++)
+	{
+		// A = (A0 + A1 * x + A2 * y) e^(j phi)
+		const complex value = std::polar(1.0, fixedIterator->phase * M_PI / 180.0) * fixedIterator->value;
+		double sign;
+		const int root = constraints.findRoot(fixedIterator->node, sign);
+
+		if(!constraints.isFixed(root))
+			rootValues[root] = sign * value;
+		else if(std::abs(rootValues[root] - sign * value) > 1e-12 * std::abs(value))
+			numberOfConflicts++;
+
+		constraints.fix(fixedIterator->node, 0.0);
+	}
+
+	if(numberOfConflicts > 0)
+		OmniFEMMsg::instance()->MsgWarning(std::to_string(numberOfConflicts) + " node(s) have conflicting potentials. The first potential that was found is used");
+
+	if(!constraints.hasFixedValue() && impedanceEdges.empty())
+	{
+		OmniFEMMsg::instance()->MsgError("The vector potential is not fixed anywhere in the problem. Add a prescribed A boundary, a small skin depth boundary, or a nodal property");
+		return false;
+	}
+
+	// The center of an arc is a vertex of the GMSH model but not part of the mesh
+	const std::vector<bool> isUsed = p_mesh->getUsedNodes();
+
+	linearSystemCSRIterative<complex> system(linearSystemCSRIterative<complex>::CG, linearSystemCSRIterative<complex>::IC0);
+	dofManager<complex> dofs(&system);
+
+	constraints.apply(dofs, isUsed);
+
+	for(int i = 0; i < numberOfNodes; i++)
+	{
+		double sign;
+		const int root = constraints.findRoot(i, sign);
+
+		if(isUsed[i] && constraints.isFixed(i))
+			dofs.fixDof(Dof(i, 0), sign * rootValues[root]);
+	}
+
+	// The voltage gradients are numbered after the nodes
+	for(int k = 0; k < numberOfConductors; k++)
+		dofs.numberDof(Dof(k, 1));
+
+	const int numberOfEquations = dofs.sizeOfR();
+
+	if(numberOfEquations == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("All of the nodes of the mesh have a fixed potential. There is nothing to solve");
+		return false;
+	}
+
+	// Symbolic pass. This is done once for all of the frequencies. The line elements of the small skin depth edges come after the faces
+	coloredAssembly assembly(p_mesh, p_batchSize);
+	std::vector<int> regionConductors;
+	std::vector<elementKernel> kernels, massKernels;
+	std::vector<Dof> R;
+
+	for(auto lawIterator = laws.begin(); lawIterator != laws.end(); lawIterator++)
+		regionConductors.push_back(lawIterator->conductor);
+
+	assembly.createPattern(dofs, constraints, regionConductors);
+
+	for(auto blockIterator = blocks.begin(); blockIterator != blocks.end(); blockIterator++)
+	{
+		kernels.push_back(elementKernel(blockIterator->type, axisymmetric));
+		massKernels.push_back(elementKernel(blockIterator->type, axisymmetric, true));
+	}
+
+	const int lineStart = dofs.getNumPatternElements();
+
+	for(auto edgeIterator = impedanceEdges.begin(); edgeIterator != impedanceEdges.end(); edgeIterator++)
+	{
+		const solverMesh::edgeSegment &edge = *edgeIterator->first;
+
+		for(unsigned int e = 0; e < edge.nodes.size() / edge.numberOfNodes; e++)
+		{
+			R.clear();
+
+			for(int i = 0; i < edge.numberOfNodes; i++)
+				R.push_back(Dof(edge.nodes[e * edge.numberOfNodes + i], 0));
+
+			dofs.insertElementInPattern(R);
+		}
+	}
+
+	dofs.finalizePattern();
+
+	std::vector<int> nodeEquation(numberOfNodes, -1);
+	std::vector<double> nodeSign(numberOfNodes, 1.0);
+	std::vector<complex> fixedSolution(numberOfNodes, 0.0);
+	std::vector<int> conductorEquation(numberOfConductors);
+
+	for(int i = 0; i < numberOfNodes; i++)
+	{
+		if(!isUsed[i])
+			continue;
+
+		const int root = constraints.findRoot(i, nodeSign[i]);
+
+		if(constraints.isFixed(i))
+			dofs.getDofValue(Dof(i, 0), fixedSolution[i]);
+		else
+			nodeEquation[i] = dofs.getDofNumber(Dof(root, 0));
+	}
+
+	for(int k = 0; k < numberOfConductors; k++)
+		conductorEquation[k] = dofs.getDofNumber(Dof(k, 1));
+
+	double patternTime = TimeOfDay();
+
+	/* Numeric pass of one part of the element matrices. The elements of a solid conductor all add into the row of its voltage gradient.
+	 * So, the frequency independent parts are assembled on one thread if the problem has solid conductors. The frequency dependent
+	 * regions never carry a voltage gradient
+	 */
+	auto assemblePart = [&](elementPart part)
+	{
+		assembly.assemble<complex>(1, numberOfConductors == 0 || part == elementPart::DEPENDENT,
+			[&](const solverMesh::elementBlock &block, int blockIndex, int first, int count, std::vector<double> &buffer, complex *matrices, complex *vectors)
+			{
+				computeElements(block, first, count, kernels[blockIndex], massKernels[blockIndex], laws, part, axisymmetric, buffer, matrices, vectors);
+			},
+			[&](const solverMesh::elementBlock &block, int element, int patternIndex, complex *matrix, complex *vector)
+			{
+				const regionLaw &law = laws[block.regions[element]];
+				const int size = (law.conductor != -1) ? block.numberOfNodes + 1 : block.numberOfNodes;
+
+				if(part == elementPart::EDDY && law.conductivity == 0)
+					return;
+
+				if(part == elementPart::DEPENDENT && law.model == frequencyModel::NONE)
+					return;
+
+				dofs.assembleElement(patternIndex, fullMatrix<complex>(matrix, size, size));
+
+				if(part == elementPart::STATIC)
+					dofs.assembleElement(patternIndex, fullVector<complex>(vector, size));
+			});
+	};
+
+	/* The parts that do not change with the frequency are assembled once and kept. The values of the matrix are stored in the order of the
+	 * CSR storage so that a frequency only needs a sum of the parts
+	 */
+	const int numberOfEntries = system.getNNZ();
+	std::vector<complex> staticValues, eddyValues, impedanceValues;
+	std::vector<complex> staticRightHandSide, eddyRightHandSide, impedanceRightHandSide;
+
+	auto keepPart = [&](std::vector<complex> &values, std::vector<complex> &rightHandSide)
+	{
+		const complex *matrixValues = system.getMatrixValues();
+
+		values.assign(matrixValues, matrixValues + numberOfEntries);
+		rightHandSide.resize(numberOfEquations);
+
+		for(int i = 0; i < numberOfEquations; i++)
+			system.getFromRightHandSide(i, rightHandSide[i]);
+
+		system.zeroMatrix();
+		system.zeroRightHandSide();
+	};
+
+	system.zeroMatrix();
+	system.zeroRightHandSide();
+
+	assemblePart(elementPart::STATIC);
+
+	for(auto currentIterator = conditions.getPointCurrents().begin(); currentIterator != conditions.getPointCurrents().end(); currentIterator++)
+		dofs.assemble(Dof(currentIterator->first, 0), complex(p_vacuumPermeability * currentIterator->second));
+
+	// The row of a voltage gradient sets the total current of the conductor: j w mu0 integral(sigma (U - A) / r) = mu0 I
+	for(int k = 0; k < numberOfConductors; k++)
+		dofs.assemble(Dof(k, 1), complex(p_vacuumPermeability * conductorCurrents[k]));
+
+	keepPart(staticValues, staticRightHandSide);
+
+	if(hasEddyCurrents)
+	{
+		assemblePart(elementPart::EDDY);
+		keepPart(eddyValues, eddyRightHandSide);
+	}
+
+	if(!impedanceEdges.empty())
+	{
+		int lineIndex = lineStart;
+
+		for(auto edgeIterator = impedanceEdges.begin(); edgeIterator != impedanceEdges.end(); edgeIterator++)
+		{
+			const solverMesh::edgeSegment &edge = *edgeIterator->first;
+			const int n = edge.numberOfNodes;
+			const elementKernel kernel(edge.type, axisymmetric, true);
+			std::vector<double> lineX(n), lineY(n);
+			std::vector<complex> matrix(n * n);
+
+			for(unsigned int e = 0; e < edge.nodes.size() / n; e++)
+			{
+				std::fill(matrix.begin(), matrix.end(), complex(0));
+
+				for(int i = 0; i < n; i++)
+				{
+					lineX[i] = x[edge.nodes[e * n + i]];
+					lineY[i] = y[edge.nodes[e * n + i]];
+				}
+
+				for(int q = 0; q < kernel.getNumberOfPoints(); q++)
+				{
+					const double *N = kernel.getShapeFunctions(q);
+					double r;
+					const double lengthWeight = kernel.mapLine(q, &lineX[0], &lineY[0], r);
+					const complex weight = edgeIterator->second * lengthWeight / (axisymmetric ? std::max(r, 1e-300) : 1.0);
+
+					for(int j = 0; j < n; j++)
+					{
+						for(int i = 0; i < n; i++)
+							matrix[j * n + i] += weight * N[i] * N[j];
+					}
+				}
+
+				dofs.assembleElement(lineIndex++, fullMatrix<complex>(&matrix[0], n, n));
+			}
+		}
+
+		keepPart(impedanceValues, impedanceRightHandSide);
+	}
+
+	double staticTime = TimeOfDay();
+
+	// The frequency sweep
+	std::vector<complex> solution(numberOfNodes);
+	std::vector<complex> voltages(numberOfConductors);
+	double dependentTime = 0;
+	double solverTime = 0;
+	double resultTime = 0;
+	int numberOfFactorizations = 0;
+	int numberOfLinearIterations = 0;
+	int factorizationIterations = 0;
+	int lastIterations = 0;
+	bool linearFailure = false;
+
+	for(unsigned int f = 0; f < frequencies.size(); f++)
+	{
+		const double frequency = frequencies[f];
+		const double angularFrequency = 2 * M_PI * frequency;
+		const complex jw(0, angularFrequency);
+		const double rootOfFrequency = sqrt(angularFrequency);
+		double frequencyStart = TimeOfDay();
+
+		OmniFEMMsg::instance()->MsgStatus("Solving at " + std::to_string(frequency) + " Hz");
+
+		complex *values = system.getMatrixValues();
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+		for(int k = 0; k < numberOfEntries; k++)
+		{
+			complex value = staticValues[k];
+
+			if(!eddyValues.empty())
+				value += jw * eddyValues[k];
+
+			if(!impedanceValues.empty())
+				value += rootOfFrequency * impedanceValues[k];
+
+			values[k] = value;
+		}
+
+		system.zeroRightHandSide();
+
+		for(int i = 0; i < numberOfEquations; i++)
+		{
+			complex value = staticRightHandSide[i];
+
+			if(!eddyRightHandSide.empty())
+				value += jw * eddyRightHandSide[i];
+
+			if(!impedanceRightHandSide.empty())
+				value += rootOfFrequency * impedanceRightHandSide[i];
+
+			system.addToRightHandSide(i, value);
+		}
+
+		// Only the regions whose permeability depends on the frequency are computed again
+		if(hasDependentRegion)
+		{
+			updateRegionLaws(laws, frequency);
+			assemblePart(elementPart::DEPENDENT);
+		}
+
+		double assemblyEnd = TimeOfDay();
+
+		dependentTime += assemblyEnd - frequencyStart;
+
+		/* The solution of the last frequency is the initial guess. The incomplete factors are kept as long as the conjugate gradient
+		 * converges in about as many iterations as it did right after the last factorization
+		 */
+		system.setPrec(precision);
+		system.setMaxIterations(std::max(1000, 10 * numberOfEquations));
+		system.setReusePreconditioner(numberOfFactorizations > 0 && lastIterations <= 2 * factorizationIterations + 10);
+
+		bool linearConverged = (system.systemSolve() == 1);
+
+		if(!linearConverged && system.getPreconditionerReused())
+		{
+			numberOfLinearIterations += system.getNumIterations();
+			system.setReusePreconditioner(false);
+			linearConverged = (system.systemSolve() == 1);
+		}
+
+		if(!linearConverged)
+		{
+			// The conjugate orthogonal conjugate gradient can stall on a complex symmetric matrix. BiCGStab is slower but more robust
+			numberOfLinearIterations += system.getNumIterations();
+			system.setMethod(linearSystemCSRIterative<complex>::BICGSTAB);
+			system.setPreconditioner(linearSystemCSRIterative<complex>::ILU0);
+			system.setReusePreconditioner(false);
+			system.zeroSolution();
+			linearConverged = (system.systemSolve() == 1);
+		}
+
+		if(!system.getPreconditionerReused())
+		{
+			numberOfFactorizations++;
+			factorizationIterations = system.getNumIterations();
+		}
+
+		lastIterations = system.getNumIterations();
+		numberOfLinearIterations += lastIterations;
+
+		double solveEnd = TimeOfDay();
+
+		solverTime += solveEnd - assemblyEnd;
+
+		for(int i = 0; i < numberOfNodes; i++)
+		{
+			if(nodeEquation[i] != -1)
+			{
+				system.getFromSolution(nodeEquation[i], solution[i]);
+				solution[i] *= nodeSign[i];
+			}
+			else
+				solution[i] = fixedSolution[i];
+		}
+
+		for(int k = 0; k < numberOfConductors; k++)
+			system.getFromSolution(conductorEquation[k], voltages[k]);
+
+		// The potential, the flux density, and the current density of the elements
+		p_frequencies.push_back(frequency);
+		p_potential.push_back(std::vector<complex>(numberOfNodes));
+		p_fluxDensityX.push_back(std::vector<complex>(p_mesh->getNumberOfElements()));
+		p_fluxDensityY.push_back(std::vector<complex>(p_mesh->getNumberOfElements()));
+		p_currentDensity.push_back(std::vector<complex>(p_mesh->getNumberOfElements()));
+
+		for(int i = 0; i < numberOfNodes; i++)
+		{
+			if(axisymmetric)
+				p_potential.back()[i] = (x[i] > 0) ? solution[i] / x[i] : 0.0;
+			else
+				p_potential.back()[i] = solution[i];
+		}
+
+		for(unsigned int b = 0; b < blocks.size(); b++)
+		{
+			computeResults(blocks[b], massKernels[b], laws, solution, voltages, frequency, axisymmetric, &p_fluxDensityX.back()[assembly.getBlockStart(b)],
+						   &p_fluxDensityY.back()[assembly.getBlockStart(b)], &p_currentDensity.back()[assembly.getBlockStart(b)]);
+		}
+
+		resultTime += TimeOfDay() - solveEnd;
+
+		if(!linearConverged)
+		{
+			linearFailure = true;
+			break;
+		}
+	}
+
+	double totalTime = TimeOfDay();
+	std::ostringstream timing;
+
+	timing << std::fixed << std::setprecision(3);
+	timing << "Mesh: " << meshTime - startTime << " s (" << numberOfNodes << " nodes, " << p_mesh->getNumberOfElements() << " elements)\n";
+	timing << "Materials: " << materialTime - meshTime << " s (" << numberOfConductors << " conductors)\n";
+	timing << "Sparsity pattern: " << patternTime - materialTime << " s\n";
+	timing << "Frequency independent assembly: " << staticTime - patternTime << " s (" << p_mesh->getNumberOfColors() << " colors, " << numberOfThreads << " threads)\n";
+	timing << "Frequency dependent assembly: " << dependentTime << " s (" << p_frequencies.size() << " frequencies)\n";
+	timing << "Linear solver: " << solverTime << " s (" << numberOfLinearIterations << " iterations, " << numberOfFactorizations << " factorizations)\n";
+	timing << "Flux density: " << resultTime << " s\n";
+	timing << "Total: " << totalTime - startTime << " s";
+
+	OmniFEMMsg::instance()->MsgInfo(timing.str());
+
+	if(linearFailure)
+		OmniFEMMsg::instance()->MsgError("The linear solver did not converge to the requested precision at " + std::to_string(p_frequencies.back()) + " Hz");
+	else
+		OmniFEMMsg::instance()->MsgStatus("Solver Finished");
+
+	return !linearFailure;
+}
@@ -0,0 +1,149 @@
+#include <Solver/JilesAthertonModel.h>
+
+#include <algorithm>
+
+
+const int jilesAthertonModel::p_numberOfSubsteps;
+
+
+
+jilesAthertonModel::jilesAthertonModel(jilesAthertonParameters &parameters, double fillFactor)
+{
+	p_coupling = parameters.getAlpha();
+	p_domainDensity = parameters.getAParam();
+	p_saturation = parameters.getSaturationMagnetization();
+	p_pinning = parameters.getKParam();
+	p_reversibility = std::min(std::max(parameters.getMagnetizationReversibility(), 0.0), 1.0);
+	p_fillFactor = (fillFactor > 0 && fillFactor <= 1) ? fillFactor : 1.0;
+}
+
+
+
+void jilesAthertonModel::resize(int numberOfPoints)
+{
+	std::vector<double> *arrays[] = {&p_fluxX, &p_fluxY, &p_fieldX, &p_fieldY, &p_magnetizationX, &p_magnetizationY, &p_irreversibleX, &p_irreversibleY,
+									 &p_trialFluxX, &p_trialFluxY, &p_trialFieldX, &p_trialFieldY, &p_trialMagnetizationX, &p_trialMagnetizationY,
+									 &p_trialIrreversibleX, &p_trialIrreversibleY, &p_reluctivityX, &p_reluctivityY};
+
+	for(unsigned int i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++)
+		arrays[i]->assign(numberOfPoints, 0.0);
+}
+
+
+
+void jilesAthertonModel::updateComponent(const double *flux, const double *field, const double *magnetization, const double *irreversible, const double *trialFlux,
+										 double *trialField, double *trialMagnetization, double *trialIrreversible, double *reluctivity)
+{
+	const int numberOfPoints = p_fluxX.size();
+	const double inversePermeability = 1.0 / p_vacuumPermeability;
+	const double inverseDensity = 1.0 / p_domainDensity;
+	const double inversePinning = 1.0 / p_pinning;
+	const double coupling = p_coupling;
+	const double saturation = p_saturation;
+	const double reversibility = p_reversibility;
+	const double fillFactor = p_fillFactor;
+	const double minimumReluctivity = p_minimumReluctivity;
+
+	/* The susceptibility dM/dHe of the effective field He = H + alpha M. The anhysteretic magnetization is Ms L(He / a) where
+	 * L(x) = coth(x) - 1 / x is the Langevin function. coth(|x|) is found from e^(-2 |x|) so that there is one exponential per
+	 * evaluation. The irreversible magnetization moves toward the anhysteretic magnetization at the rate (Man - Mirr) / k and only
+	 * when the field moves toward it. Both branches of the Langevin function are computed and one is picked so that the loop has
+	 * no branches
+	 */
+	auto getSusceptibility = [=](double H, double M, double irreversibleM, double direction, double &irreversibleSusceptibility) -> double
+	{
+		const double x = (H + coupling * M) * inverseDensity;
+		const double absoluteX = fabs(x);
+		const bool isSmall = absoluteX < 1e-2;
+		const double safeX = isSmall ? 1.0 : absoluteX;
+		const double decay = exp(-2.0 * safeX);
+		const double inverseTanh = (1.0 + decay) / (1.0 - decay);
+		const double inverseX = 1.0 / safeX;
+		const double langevin = isSmall ? x / 3.0 - x * x * x / 45.0 : copysign(inverseTanh - inverseX, x);
+		const double slope = isSmall ? 1.0 / 3.0 - x * x / 15.0 : inverseX * inverseX - inverseTanh * inverseTanh + 1.0;
+		const double difference = direction * (saturation * langevin - irreversibleM);
+
+		irreversibleSusceptibility = (difference > 0 ? difference : 0.0) * inversePinning;
+
+		return (1.0 - reversibility) * irreversibleSusceptibility + reversibility * saturation * inverseDensity * slope;
+	};
+
+#if defined(_OPENMP)
+#pragma omp parallel for simd schedule(static)
+#endif
+	for(int i = 0; i < numberOfPoints; i++)
+	{
+		const double step = (trialFlux[i] - flux[i]) / p_numberOfSubsteps;
+		const double direction = (step >= 0) ? 1.0 : -1.0;
+		double B = flux[i];
+		double M = magnetization[i];
+		double irreversibleM = irreversible[i];
+		double H = field[i];
+		double irreversibleSusceptibility;
+
+		/* B = mu0 (H + f M) and He = H + alpha M so dB = mu0 dHe (1 + (f - alpha) dM/dHe). Each sub-step finds the change of
+		 * the effective field from the change of the flux density and moves the magnetization along
+		 */
+		for(int s = 0; s < p_numberOfSubsteps; s++)
+		{
+			const double susceptibility = getSusceptibility(H, M, irreversibleM, direction, irreversibleSusceptibility);
+			const double effectiveStep = step * inversePermeability / std::max(1.0 + (fillFactor - coupling) * susceptibility, 1e-12);
+
+			M += susceptibility * effectiveStep;
+			irreversibleM += irreversibleSusceptibility * effectiveStep;
+			B += step;
+			H = B * inversePermeability - fillFactor * M;
+		}
+
+		// mu0 dH/dB = (1 - alpha dM/dHe) / (1 + (f - alpha) dM/dHe)
+		const double susceptibility = getSusceptibility(H, M, irreversibleM, direction, irreversibleSusceptibility);
+
+		trialField[i] = H;
+		trialMagnetization[i] = M;
+		trialIrreversible[i] = irreversibleM;
+		reluctivity[i] = std::max((1.0 - coupling * susceptibility) / std::max(1.0 + (fillFactor - coupling) * susceptibility, 1e-12), minimumReluctivity);
+	}
+}
+
+
+
+void jilesAthertonModel::update()
+{
+	updateComponent(p_fluxX.data(), p_fieldX.data(), p_magnetizationX.data(), p_irreversibleX.data(), p_trialFluxX.data(),
+					p_trialFieldX.data(), p_trialMagnetizationX.data(), p_trialIrreversibleX.data(), p_reluctivityX.data());
+	updateComponent(p_fluxY.data(), p_fieldY.data(), p_magnetizationY.data(), p_irreversibleY.data(), p_trialFluxY.data(),
+					p_trialFieldY.data(), p_trialMagnetizationY.data(), p_trialIrreversibleY.data(), p_reluctivityY.data());
+}
+
+
+
+void jilesAthertonModel::commit()
+{
+	p_fluxX = p_trialFluxX;
+	p_fluxY = p_trialFluxY;
+	p_fieldX = p_trialFieldX;
+	p_fieldY = p_trialFieldY;
+	p_magnetizationX = p_trialMagnetizationX;
+	p_magnetizationY = p_trialMagnetizationY;
+	p_irreversibleX = p_trialIrreversibleX;
+	p_irreversibleY = p_trialIrreversibleY;
+}
+
+
+
+double jilesAthertonModel::getWork(const double *weights) const
+{
+	const int numberOfPoints = p_fluxX.size();
+	double work = 0;
+
+#if defined(_OPENMP)
+#pragma omp parallel for simd reduction(+:work) schedule(static)
+#endif
+	for(int i = 0; i < numberOfPoints; i++)
+	{
+		work += weights[i] * 0.5 * ((p_fieldX[i] + p_trialFieldX[i]) * (p_trialFluxX[i] - p_fluxX[i])
+									+ (p_fieldY[i] + p_trialFieldY[i]) * (p_trialFluxY[i] - p_fluxY[i]));
+	}
+
+	return work;
+}
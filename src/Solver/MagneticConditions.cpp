@@ -0,0 +1,108 @@
+#include <Solver/MagneticConditions.h>
+
+#include <algorithm>
+
+
+
+magneticConditions::magneticConditions(solverMesh *mesh, std::vector<magneticBoundary> &boundaries, std::vector<nodalProperty> &nodalProperties, bool axisymmetric, double scale)
+{
+	const int numberOfNodes = mesh->getNumberOfNodes();
+	const double *x = mesh->getXCoordinates();
+	const double *y = mesh->getYCoordinates();
+
+	p_mesh = mesh;
+
+	for(auto pointIterator = mesh->getPoints()->begin(); pointIterator != mesh->getPoints()->end(); pointIterator++)
+	{
+		for(auto groupIterator = pointIterator->groups.begin(); groupIterator != pointIterator->groups.end(); groupIterator++)
+		{
+			for(auto nodalIterator = nodalProperties.begin(); nodalIterator != nodalProperties.end(); nodalIterator++)
+			{
+				if(nodalIterator->getName() != *groupIterator)
+					continue;
+
+				// For axisymmetric problems, the unknown is r * A and a point current is a ring of current
+				if(nodalIterator->getState())
+					p_fixedValues.push_back(fixedPotential{pointIterator->node, nodalIterator->getValue() * (axisymmetric ? x[pointIterator->node] : 1.0), 0.0});
+				else
+					p_pointCurrents.push_back(std::make_pair(pointIterator->node, nodalIterator->getValue()));
+			}
+		}
+	}
+
+	for(auto edgeIterator = mesh->getEdges()->begin(); edgeIterator != mesh->getEdges()->end(); edgeIterator++)
+	{
+		for(auto groupIterator = edgeIterator->groups.begin(); groupIterator != edgeIterator->groups.end(); groupIterator++)
+		{
+			for(auto boundaryIterator = boundaries.begin(); boundaryIterator != boundaries.end(); boundaryIterator++)
+			{
+				if(boundaryIterator->getBoundaryName() != *groupIterator)
+					continue;
+
+				switch(boundaryIterator->getBC())
+				{
+					case bcEnumMagnetic::PRESCRIBE_A:
+						// A = A0 + A1 * x + A2 * y where x and y are in the units of the geometry
+						for(auto nodeIterator = edgeIterator->orderedNodes.begin(); nodeIterator != edgeIterator->orderedNodes.end(); nodeIterator++)
+						{
+							const double potential = boundaryIterator->getA0() + boundaryIterator->getA1() * x[*nodeIterator] / scale + boundaryIterator->getA2() * y[*nodeIterator] / scale;
+
+							p_fixedValues.push_back(fixedPotential{*nodeIterator, potential * (axisymmetric ? x[*nodeIterator] : 1.0), boundaryIterator->getPhi()});
+						}
+						break;
+					case bcEnumMagnetic::SMALL_SKIN_DEPTH:
+						p_skinDepthEdges.push_back(std::make_pair(&(*edgeIterator), *boundaryIterator));
+						break;
+					case bcEnumMagnetic::PERIODIC:
+					case bcEnumMagnetic::ANTIPERIODIC:
+						p_periodicEdges[*groupIterator].push_back(&(*edgeIterator));
+						p_periodicSign[*groupIterator] = (boundaryIterator->getBC() == bcEnumMagnetic::PERIODIC) ? 1.0 : -1.0;
+						break;
+					default:
+						p_hasUnsupportedBoundary = true;
+						break;
+				}
+			}
+		}
+	}
+
+	// The flux function r * A is zero on the axis of an axisymmetric problem
+	if(axisymmetric && numberOfNodes > 0)
+	{
+		const double largestRadius = *std::max_element(x, x + numberOfNodes);
+
+		for(int i = 0; i < numberOfNodes; i++)
+		{
+			if(x[i] <= 1e-10 * largestRadius)
+				p_fixedValues.push_back(fixedPotential{i, 0.0, 0.0});
+		}
+	}
+}
+
+
+
+void magneticConditions::fixValues(potentialConstraints &constraints)
+{
+	for(auto fixedIterator = p_fixedValues.begin(); fixedIterator != p_fixedValues.end(); fixedIterator++)
+		constraints.fix(fixedIterator->node, fixedIterator->value);
+}
+
+
+
+void magneticConditions::tiePeriodicEdges(potentialConstraints &constraints)
+{
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+
+	for(auto periodicIterator = p_periodicEdges.begin(); periodicIterator != p_periodicEdges.end(); periodicIterator++)
+	{
+		if(periodicIterator->second.size() != 2)
+		{
+			OmniFEMMsg::instance()->MsgWarning("The periodic boundary " + periodicIterator->first + " must be assigned to exactly two edges. The boundary is skipped");
+			continue;
+		}
+
+		if(!constraints.tieEdges(periodicIterator->second[0]->orderedNodes, periodicIterator->second[1]->orderedNodes, x, y, p_periodicSign[periodicIterator->first]))
+			OmniFEMMsg::instance()->MsgWarning("The two edges of the periodic boundary " + periodicIterator->first + " do not have the same number of nodes. Set the same element size on both edges. The boundary is skipped");
+	}
+}
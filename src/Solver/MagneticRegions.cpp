@@ -0,0 +1,146 @@
+#include <Solver/MagneticRegions.h>
+
+#include <stdlib.h>
+#include <sstream>
+
+#include <Mesh/meshMaker.h>
+
+
+
+magneticRegions::magneticRegions(solverMesh *mesh, std::vector<magneticMaterial> &materials, std::vector<circuitProperty> &circuits)
+{
+	std::vector<solverMesh::region> &regions = *mesh->getRegions();
+	bool missingMaterial = false;
+	bool hasMagnetExpression = false;
+	const std::string circuitPrefix = meshMaker::getCircuitGroupName("");
+	const std::string turnsPrefix = meshMaker::getTurnsGroupName(0).substr(0, meshMaker::getTurnsGroupName(0).find(' ') + 1);
+	const std::string magnetizationPrefix = meshMaker::getMagnetizationGroupName("");
+
+	p_mesh = mesh;
+	p_circuits = circuits;
+	p_material.assign(regions.size(), -1);
+	p_circuit.assign(regions.size(), -1);
+	p_turns.assign(regions.size(), 1.0);
+	p_magnetization.assign(regions.size(), 0.0);
+
+	for(unsigned int r = 0; r < regions.size(); r++)
+	{
+		for(auto groupIterator = regions[r].groups.begin(); groupIterator != regions[r].groups.end(); groupIterator++)
+		{
+			if(groupIterator->compare(0, circuitPrefix.size(), circuitPrefix) == 0)
+			{
+				for(unsigned int c = 0; c < circuits.size(); c++)
+				{
+					if(*groupIterator == meshMaker::getCircuitGroupName(circuits[c].getName()))
+						p_circuit[r] = c;
+				}
+			}
+			else if(groupIterator->compare(0, turnsPrefix.size(), turnsPrefix) == 0)
+				p_turns[r] = atof(groupIterator->c_str() + turnsPrefix.size());
+			else if(groupIterator->compare(0, magnetizationPrefix.size(), magnetizationPrefix) == 0)
+			{
+				// Only a fixed angle is supported. The direction can not be a function of the position yet
+				std::istringstream angle(groupIterator->substr(magnetizationPrefix.size()));
+
+				if(!(angle >> p_magnetization[r]))
+				{
+					hasMagnetExpression = true;
+					p_magnetization[r] = 0;
+				}
+			}
+			else if(p_material[r] == -1)
+			{
+				for(unsigned int m = 0; m < materials.size(); m++)
+				{
+					if(materials[m].getName() == *groupIterator)
+					{
+						p_material[r] = m;
+						break;
+					}
+				}
+			}
+		}
+
+		missingMaterial = missingMaterial || (p_material[r] == -1);
+	}
+
+	if(missingMaterial)
+		OmniFEMMsg::instance()->MsgWarning("At least one face does not have a magnetic material. These faces are solved as air");
+
+	if(hasMagnetExpression)
+		OmniFEMMsg::instance()->MsgWarning("The direction of magnetization can only be a fixed angle. The magnets with an expression are magnetized along x");
+}
+
+
+
+std::vector<double> magneticRegions::getCircuitSources(double factor, const std::vector<double> &conductivity)
+{
+	std::vector<double> sources(p_material.size(), 0.0);
+
+	if(p_circuits.empty())
+		return sources;
+
+	std::vector<double> areas = p_mesh->getRegionAreas();
+
+	for(unsigned int c = 0; c < p_circuits.size(); c++)
+	{
+		double totalArea = 0;
+		double totalConductance = 0;
+		bool hasConductivity = !conductivity.empty();
+
+		for(unsigned int r = 0; r < p_circuit.size(); r++)
+		{
+			if(p_circuit[r] != (int)c)
+				continue;
+
+			totalArea += areas[r];
+
+			if(!conductivity.empty())
+			{
+				totalConductance += conductivity[r] * areas[r];
+				hasConductivity = hasConductivity && (conductivity[r] > 0);
+			}
+		}
+
+		for(unsigned int r = 0; r < p_circuit.size(); r++)
+		{
+			if(p_circuit[r] != (int)c || areas[r] <= 0)
+				continue;
+
+			if(p_circuits[c].getCircuitSeriesState())
+				sources[r] = factor * p_circuits[c].getCurrent() * p_turns[r] / areas[r];
+			else if(hasConductivity)
+				sources[r] = factor * p_circuits[c].getCurrent() * conductivity[r] / totalConductance;
+			else
+				sources[r] = factor * p_circuits[c].getCurrent() / totalArea;
+		}
+	}
+
+	return sources;
+}
+
+
+
+double magneticRegions::getFillFactor(magneticMaterial &material)
+{
+	const double fillFactor = material.getLaminationFillFactor();
+
+	if(!isLaminated(material.getSpecialAttribute()) || fillFactor <= 0 || fillFactor > 1)
+		return 1;
+
+	return fillFactor;
+}
+
+
+
+void magneticRegions::getReluctivity(magneticMaterial &material, double fillFactor, double &reluctivityXX, double &reluctivityYY)
+{
+	double permeabilityX = (material.getMUrX() > 0) ? material.getMUrX() : 1.0;
+	double permeabilityY = (material.getMUrY() > 0) ? material.getMUrY() : 1.0;
+
+	mixLaminations(material.getSpecialAttribute(), fillFactor, permeabilityX, permeabilityY);
+
+	// The x derivative of the potential is the y component of the flux density and the other way around
+	reluctivityXX = 1.0 / permeabilityY;
+	reluctivityYY = 1.0 / permeabilityX;
+}
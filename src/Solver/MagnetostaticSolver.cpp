@@ -0,0 +1,739 @@
+#include <Solver/MagnetostaticSolver.h>
+
+#include <math.h>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+
+const int magnetostaticSolver::p_batchSize;
+const int magnetostaticSolver::p_maximumNewtonIterations;
+const int magnetostaticSolver::p_maximumStepReductions;
+
+
+
+magnetostaticSolver::magnetostaticSolver(problemDefinition &definition, GModel *model)
+{
+	p_model = model;
+
+	p_materials = *definition.getMagnetMaterialList();
+	p_boundaries = *definition.getMagneticBoundaryList();
+	p_circuits = *definition.getCircuitList();
+	p_nodalProperties = *definition.getNodalPropertyList();
+	p_preferences = definition.getMagneticPreference();
+}
+
+
+
+bool magnetostaticSolver::createRegionLaws(std::vector<regionLaw> &laws)
+{
+	std::vector<solverMesh::region> &regions = *p_mesh->getRegions();
+	std::vector<double> materialReluctivityXX(p_materials.size(), 1.0);
+	std::vector<double> materialReluctivityYY(p_materials.size(), 1.0);
+	bool isNonlinear = false;
+	bool hasParallelLaminations = false;
+
+	clearCurves();
+	p_curves.assign(p_materials.size(), nullptr);
+
+	for(unsigned int m = 0; m < p_materials.size(); m++)
+	{
+		magneticMaterial &material = p_materials[m];
+		const lamWireEnum attribute = material.getSpecialAttribute();
+		const double fillFactor = magneticRegions::getFillFactor(material);
+
+		if(!material.getBHState())
+		{
+			jilesAthertonParameters parameters = material.getJilesAtherton();
+			std::vector<double> flux, field;
+
+			if(bhCurve::getAnhystereticCurve(parameters, fillFactor, flux, field))
+			{
+				p_curves[m] = new bhCurve(flux, field);
+				hasParallelLaminations = hasParallelLaminations || (magneticRegions::isLaminated(attribute) && attribute != LAMINATED_IN_PLANE && fillFactor < 1);
+				continue;
+			}
+
+			OmniFEMMsg::instance()->MsgWarning("The material " + material.getName() + " is nonlinear but does not have a saturation magnetization and a domain wall density. The material is solved as linear");
+		}
+
+		magneticRegions::getReluctivity(material, fillFactor, materialReluctivityXX[m], materialReluctivityYY[m]);
+	}
+
+	if(hasParallelLaminations)
+		OmniFEMMsg::instance()->MsgWarning("The laminations of nonlinear materials are treated as laminations in the plane of the problem");
+
+	magneticRegions regionGroups(p_mesh, p_materials, p_circuits);
+	std::vector<double> regionConductivity(regions.size(), 0.0);
+
+	laws.assign(regions.size(), regionLaw());
+
+	for(unsigned int r = 0; r < regions.size(); r++)
+	{
+		const int material = regionGroups.getMaterial(r);
+		const double magnetization = regionGroups.getMagnetization(r);
+
+		if(material == -1)
+			continue;
+
+		laws[r].curve = p_curves[material];
+		laws[r].reluctivityXX = laws[r].curve ? 1.0 / laws[r].curve->getInitialPermeability() : materialReluctivityXX[material];
+		laws[r].reluctivityYY = laws[r].curve ? 1.0 / laws[r].curve->getInitialPermeability() : materialReluctivityYY[material];
+		laws[r].source = p_vacuumPermeability * p_materials[material].getCurrentDensity() * 1e6;
+		laws[r].magnetX = p_vacuumPermeability * p_materials[material].getCoercivity() * cos(magnetization * M_PI / 180.0);
+		laws[r].magnetY = p_vacuumPermeability * p_materials[material].getCoercivity() * sin(magnetization * M_PI / 180.0);
+		regionConductivity[r] = p_materials[material].getSigma();
+		isNonlinear = isNonlinear || (laws[r].curve != nullptr);
+	}
+
+	// At DC, the current density is proportional to the conductivity so the current of a parallel circuit is split by the conductivity
+	std::vector<double> circuitSources = regionGroups.getCircuitSources(p_vacuumPermeability, regionConductivity);
+
+	for(unsigned int r = 0; r < regions.size(); r++)
+		laws[r].source += circuitSources[r];
+
+	return isNonlinear;
+}
+
+
+
+void magnetostaticSolver::computeElements(const solverMesh::elementBlock &block, int first, int count, const elementKernel &kernel, const std::vector<regionLaw> &laws,
+										  const std::vector<double> &solution, bool axisymmetric, std::vector<double> &buffer, double *matrices, double *vectors,
+										  double *fluxX, double *fluxY)
+{
+	const int n = block.numberOfNodes;
+	const int *nodes = &block.nodes[first * n];
+	const int *regions = &block.regions[first];
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+	// The flux density is (dA/dy, -dA/dx) for planar problems and (-dA/dz, dA/dr) / r for axisymmetric problems
+	const double orientation = axisymmetric ? -1.0 : 1.0;
+
+	if(block.type == MSH_TRI_3)
+	{
+		/* The gradient of the potential is constant over a first order triangle so B^2 is looked up once per triangle. The
+		 * geometry and the gradients are computed on all of the triangles of the batch at once. The lookup of the reluctivity
+		 * follows for each triangle and then the matrices are computed on all of the triangles at once
+		 */
+		buffer.resize(count * 38);
+
+		double *batchX = &buffer[0];
+		double *batchY = batchX + 3 * count;
+		double *batchU = batchY + 3 * count;
+		double *gradientX = batchU + 3 * count;
+		double *gradientY = gradientX + 3 * count;
+		double *area = gradientY + 3 * count;
+		double *radius = area + count;
+		double *potentialX = radius + count;
+		double *potentialY = potentialX + count;
+		double *fluxSquared = potentialY + count;
+		double *reluctivityXX = fluxSquared + count;
+		double *reluctivityYY = reluctivityXX + count;
+		double *tangent = reluctivityYY + count;
+		double *source = tangent + count;
+		double *magnetX = source + count;
+		double *magnetY = magnetX + count;
+		double *batchMatrix = magnetY + count;
+		double *batchVector = batchMatrix + 9 * count;
+
+		for(int e = 0; e < count; e++)
+		{
+			for(int i = 0; i < 3; i++)
+			{
+				batchX[i * count + e] = x[nodes[e * 3 + i]];
+				batchY[i * count + e] = y[nodes[e * 3 + i]];
+				batchU[i * count + e] = solution[nodes[e * 3 + i]];
+			}
+		}
+
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+		for(int e = 0; e < count; e++)
+		{
+			const double *x0 = batchX, *x1 = batchX + count, *x2 = batchX + 2 * count;
+			const double *y0 = batchY, *y1 = batchY + count, *y2 = batchY + 2 * count;
+			const double b0 = y1[e] - y2[e];
+			const double b1 = y2[e] - y0[e];
+			const double b2 = y0[e] - y1[e];
+			const double c0 = x2[e] - x1[e];
+			const double c1 = x0[e] - x2[e];
+			const double c2 = x1[e] - x0[e];
+			const double determinant = b0 * c1 - b1 * c0;
+			const double inverse = 1.0 / determinant;
+			const double r = axisymmetric ? (x0[e] + x1[e] + x2[e]) / 3.0 : 1.0;
+
+			gradientX[e] = b0 * inverse;
+			gradientX[count + e] = b1 * inverse;
+			gradientX[2 * count + e] = b2 * inverse;
+			gradientY[e] = c0 * inverse;
+			gradientY[count + e] = c1 * inverse;
+			gradientY[2 * count + e] = c2 * inverse;
+			area[e] = 0.5 * fabs(determinant);
+			radius[e] = r;
+
+			potentialX[e] = batchU[e] * gradientX[e] + batchU[count + e] * gradientX[count + e] + batchU[2 * count + e] * gradientX[2 * count + e];
+			potentialY[e] = batchU[e] * gradientY[e] + batchU[count + e] * gradientY[count + e] + batchU[2 * count + e] * gradientY[2 * count + e];
+			fluxSquared[e] = (potentialX[e] * potentialX[e] + potentialY[e] * potentialY[e]) / (r * r);
+		}
+
+		for(int e = 0; e < count; e++)
+		{
+			const regionLaw &law = laws[regions[e]];
+
+			if(law.curve)
+			{
+				double reluctivity, derivative;
+
+				law.curve->evaluate(fluxSquared[e], reluctivity, derivative);
+				reluctivityXX[e] = reluctivity;
+				reluctivityYY[e] = reluctivity;
+				tangent[e] = 2.0 * derivative / (radius[e] * radius[e]);
+			}
+			else
+			{
+				reluctivityXX[e] = law.reluctivityXX;
+				reluctivityYY[e] = law.reluctivityYY;
+				tangent[e] = 0;
+			}
+
+			source[e] = law.source;
+			magnetX[e] = law.magnetX;
+			magnetY[e] = law.magnetY;
+		}
+
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+		for(int e = 0; e < count; e++)
+		{
+			const double weight = area[e] / radius[e];
+			const double gradientSquared = potentialX[e] * potentialX[e] + potentialY[e] * potentialY[e];
+			double projection[3];
+
+			for(int i = 0; i < 3; i++)
+				projection[i] = potentialX[e] * gradientX[i * count + e] + potentialY[e] * gradientY[i * count + e];
+
+			for(int j = 0; j < 3; j++)
+			{
+				for(int i = 0; i < 3; i++)
+				{
+					batchMatrix[(j * 3 + i) * count + e] = weight * (reluctivityXX[e] * gradientX[i * count + e] * gradientX[j * count + e]
+															+ reluctivityYY[e] * gradientY[i * count + e] * gradientY[j * count + e]
+															+ tangent[e] * projection[i] * projection[j]);
+				}
+			}
+
+			// The Jacobian times the solution minus the residual. Only the part of the Jacobian from the change of the reluctivity is left
+			for(int i = 0; i < 3; i++)
+			{
+				batchVector[i * count + e] = weight * tangent[e] * projection[i] * gradientSquared + source[e] * area[e] / 3.0
+											+ orientation * area[e] * (magnetX[e] * gradientY[i * count + e] - magnetY[e] * gradientX[i * count + e]);
+			}
+		}
+
+		for(int e = 0; e < count; e++)
+		{
+			for(int i = 0; i < 9; i++)
+				matrices[e * 9 + i] = batchMatrix[i * count + e];
+
+			for(int i = 0; i < 3; i++)
+				vectors[e * 3 + i] = batchVector[i * count + e];
+
+			if(fluxX)
+			{
+				fluxX[e] = orientation * potentialY[e] / radius[e];
+				fluxY[e] = -orientation * potentialX[e] / radius[e];
+			}
+		}
+	}
+	else
+	{
+		buffer.resize(5 * n);
+
+		double *elementX = &buffer[0];
+		double *elementY = elementX + n;
+		double *elementU = elementY + n;
+		double *gradientX = elementU + n;
+		double *gradientY = gradientX + n;
+		double projection[64];
+
+		for(int e = 0; e < count; e++)
+		{
+			const regionLaw &law = laws[regions[e]];
+			double *matrix = &matrices[e * n * n];
+			double *vector = &vectors[e * n];
+			double area = 0, averageX = 0, averageY = 0;
+
+			for(int i = 0; i < n; i++)
+			{
+				elementX[i] = x[nodes[e * n + i]];
+				elementY[i] = y[nodes[e * n + i]];
+				elementU[i] = solution[nodes[e * n + i]];
+				vector[i] = 0;
+			}
+
+			for(int i = 0; i < n * n; i++)
+				matrix[i] = 0;
+
+			for(int q = 0; q < kernel.getNumberOfPoints(); q++)
+			{
+				const double *N = kernel.getShapeFunctions(q);
+				double r;
+				const double jacobianWeight = kernel.mapGradients(q, elementX, elementY, gradientX, gradientY, r);
+				double potentialX = 0, potentialY = 0;
+
+				if(!axisymmetric)
+					r = 1.0;
+
+				for(int i = 0; i < n; i++)
+				{
+					potentialX += elementU[i] * gradientX[i];
+					potentialY += elementU[i] * gradientY[i];
+				}
+
+				const double gradientSquared = potentialX * potentialX + potentialY * potentialY;
+				const double weight = jacobianWeight / r;
+				double reluctivityXX = law.reluctivityXX;
+				double reluctivityYY = law.reluctivityYY;
+				double tangent = 0;
+
+				if(law.curve)
+				{
+					double derivative;
+
+					law.curve->evaluate(gradientSquared / (r * r), reluctivityXX, derivative);
+					reluctivityYY = reluctivityXX;
+					tangent = 2.0 * derivative / (r * r);
+				}
+
+				for(int i = 0; i < n; i++)
+					projection[i] = potentialX * gradientX[i] + potentialY * gradientY[i];
+
+				for(int j = 0; j < n; j++)
+				{
+					const double columnX = weight * reluctivityXX * gradientX[j];
+					const double columnY = weight * reluctivityYY * gradientY[j];
+					const double columnTangent = weight * tangent * projection[j];
+					double *column = &matrix[j * n];
+
+					for(int i = 0; i < n; i++)
+						column[i] += gradientX[i] * columnX + gradientY[i] * columnY + projection[i] * columnTangent;
+				}
+
+				for(int i = 0; i < n; i++)
+				{
+					vector[i] += weight * tangent * projection[i] * gradientSquared + jacobianWeight * (law.source * N[i]
+								+ orientation * (law.magnetX * gradientY[i] - law.magnetY * gradientX[i]));
+				}
+
+				area += jacobianWeight;
+				averageX += jacobianWeight * orientation * potentialY / r;
+				averageY -= jacobianWeight * orientation * potentialX / r;
+			}
+
+			if(fluxX)
+			{
+				fluxX[e] = averageX / area;
+				fluxY[e] = averageY / area;
+			}
+		}
+	}
+}
+
+
+
+int magnetostaticSolver::getEnergyNorm(std::vector<double> &unknown, std::vector<double> &coefficientX, std::vector<double> &coefficientY)
+{
+	const bool axisymmetric = p_preferences.isAxistmmetric();
+	const double *x = p_mesh->getXCoordinates();
+	int element = 0;
+
+	unknown = p_potential;
+	coefficientX.clear();
+	coefficientY.clear();
+
+	if(axisymmetric)
+	{
+		for(unsigned int i = 0; i < unknown.size(); i++)
+			unknown[i] *= x[i];
+	}
+
+	for(auto blockIterator = p_mesh->getElementBlocks()->begin(); blockIterator != p_mesh->getElementBlocks()->end(); blockIterator++)
+	{
+		for(auto regionIterator = blockIterator->regions.begin(); regionIterator != blockIterator->regions.end(); regionIterator++, element++)
+		{
+			const regionLaw &law = p_laws[*regionIterator];
+
+			if(law.curve)
+			{
+				double reluctivity, derivative;
+
+				law.curve->evaluate(p_fluxDensityX[element] * p_fluxDensityX[element] + p_fluxDensityY[element] * p_fluxDensityY[element], reluctivity, derivative);
+				coefficientX.push_back(reluctivity);
+				coefficientY.push_back(reluctivity);
+			}
+			else
+			{
+				coefficientX.push_back(law.reluctivityXX);
+				coefficientY.push_back(law.reluctivityYY);
+			}
+		}
+	}
+
+	return axisymmetric ? -1 : 0;
+}
+
+
+
+bool magnetostaticSolver::solve()
+{
+	const bool axisymmetric = p_preferences.isAxistmmetric();
+	const double scale = solverMesh::getUnitScale(p_preferences.getUnitLength());
+	double precision = p_preferences.getPrecision();
+	double startTime = TimeOfDay();
+	int numberOfThreads = 1;
+
+#if defined(_OPENMP)
+	numberOfThreads = omp_get_max_threads();
+#endif
+
+	if(precision <= 0)
+		precision = 1e-8;
+
+	OmniFEMMsg::instance()->MsgStatus("Reading the mesh");
+
+	delete p_mesh;
+	p_mesh = new solverMesh(p_model, scale);
+
+	const int numberOfNodes = p_mesh->getNumberOfNodes();
+	const double *x = p_mesh->getXCoordinates();
+	std::vector<solverMesh::elementBlock> &blocks = *p_mesh->getElementBlocks();
+
+	if(p_mesh->getNumberOfElements() == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("The mesh does not have any elements. Create the mesh before running the solver");
+		return false;
+	}
+
+	double meshTime = TimeOfDay();
+
+	std::vector<regionLaw> laws;
+	const bool isNonlinear = createRegionLaws(laws);
+
+	p_laws = laws;
+
+	double materialTime = TimeOfDay();
+
+	potentialConstraints constraints(numberOfNodes);
+	magneticConditions conditions(p_mesh, p_boundaries, p_nodalProperties, axisymmetric, scale);
+
+	if(conditions.hasUnsupportedBoundary() || !conditions.getSkinDepthEdges().empty())
+		OmniFEMMsg::instance()->MsgWarning("Small skin depth, mixed, and strategic dual image boundary conditions are not supported by the magnetostatic solver yet. These edges are treated as a zero tangential field");
+
+	conditions.fixValues(constraints);
+	conditions.tiePeriodicEdges(constraints);
+
+	if(constraints.getNumberOfConflicts() > 0)
+		OmniFEMMsg::instance()->MsgWarning(std::to_string(constraints.getNumberOfConflicts()) + " node(s) have conflicting potentials. The first potential that was found is used");
+
+	if(!constraints.hasFixedValue())
+	{
+		OmniFEMMsg::instance()->MsgError("The vector potential is not fixed anywhere in the problem. Add a prescribed A boundary or nodal property");
+		return false;
+	}
+
+	// The center of an arc is a vertex of the GMSH model but not part of the mesh
+	const std::vector<bool> isUsed = p_mesh->getUsedNodes();
+
+	linearSystemCSRIterative<double> system(linearSystemCSRIterative<double>::CG, linearSystemCSRIterative<double>::IC0);
+	dofManager<double> dofs(&system);
+
+	constraints.apply(dofs, isUsed);
+
+	const int numberOfEquations = dofs.sizeOfR();
+
+	if(numberOfEquations == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("All of the nodes of the mesh have a fixed potential. There is nothing to solve");
+		return false;
+	}
+
+	// Symbolic pass. This is done once and the pattern is reused by every Newton-Raphson iteration
+	coloredAssembly assembly(p_mesh, p_batchSize);
+	std::vector<elementKernel> kernels;
+
+	assembly.createPattern(dofs, constraints);
+
+	for(auto blockIterator = blocks.begin(); blockIterator != blocks.end(); blockIterator++)
+		kernels.push_back(elementKernel(blockIterator->type, axisymmetric));
+
+	dofs.finalizePattern();
+
+	/* The value of each node is either sign * (an equation of the system) or a fixed value. This is found once so that the
+	 * solution can be gathered after each iteration without going through the Dof maps
+	 */
+	std::vector<int> nodeEquation(numberOfNodes, -1);
+	std::vector<double> nodeSign(numberOfNodes, 1.0);
+	std::vector<double> solution(numberOfNodes, 0.0);
+
+	for(int i = 0; i < numberOfNodes; i++)
+	{
+		if(!isUsed[i])
+			continue;
+
+		const int root = constraints.findRoot(i, nodeSign[i]);
+
+		if(constraints.isFixed(i))
+			dofs.getDofValue(Dof(i, 0), solution[i]);
+		else
+			nodeEquation[i] = dofs.getDofNumber(Dof(root, 0));
+	}
+
+	double patternTime = TimeOfDay();
+
+	std::vector<double> currentValues(numberOfEquations, 0.0);
+	std::vector<double> previousValues(numberOfEquations, 0.0);
+	const double newtonTolerance = std::max(100.0 * precision, 1e-10);
+	double initialResidual = 0;
+	double previousResidual = 0;
+	double relativeResidual = 0;
+	double assemblyTime = 0;
+	double solverTime = 0;
+	int numberOfAssemblies = 0;
+	int numberOfFactorizations = 0;
+	int numberOfLinearIterations = 0;
+	int factorizationIterations = 0;
+	int lastIterations = 0;
+	int numberOfReductions = 0;
+	double stepLength = 1;
+	bool converged = false;
+	bool linearFailure = false;
+
+	p_numberOfNewtonIterations = 0;
+
+	for(int iteration = 0; iteration < p_maximumNewtonIterations; iteration++)
+	{
+		double iterationStart = TimeOfDay();
+
+		system.zeroMatrix();
+		system.zeroRightHandSide();
+
+		// Numeric pass
+		assembly.assemble<double>(0, true,
+			[&](const solverMesh::elementBlock &block, int blockIndex, int first, int count, std::vector<double> &buffer, double *matrices, double *vectors)
+			{
+				computeElements(block, first, count, kernels[blockIndex], laws, solution, axisymmetric, buffer, matrices, vectors, nullptr, nullptr);
+			},
+			[&](const solverMesh::elementBlock &block, int element, int patternIndex, double *matrix, double *vector)
+			{
+				const int n = block.numberOfNodes;
+
+				dofs.assembleElement(patternIndex, fullMatrix<double>(matrix, n, n));
+				dofs.assembleElement(patternIndex, fullVector<double>(vector, n));
+			});
+
+		for(auto currentIterator = conditions.getPointCurrents().begin(); currentIterator != conditions.getPointCurrents().end(); currentIterator++)
+			dofs.assemble(Dof(currentIterator->first, 0), p_vacuumPermeability * currentIterator->second);
+
+		double iterationAssembly = TimeOfDay();
+
+		assemblyTime += iterationAssembly - iterationStart;
+		numberOfAssemblies++;
+
+		if(isNonlinear)
+		{
+			// The solution of the system is still the current solution so b - A x is the residual of the nonlinear problem
+			const double residual = system.normResidual();
+
+			if(iteration == 0)
+				initialResidual = residual;
+
+			relativeResidual = (initialResidual > 0) ? residual / initialResidual : 0;
+
+			OmniFEMMsg::instance()->MsgStatus("Newton-Raphson iteration " + std::to_string(iteration) + ": relative residual " + std::to_string(relativeResidual));
+
+			if(relativeResidual <= newtonTolerance)
+			{
+				converged = true;
+				break;
+			}
+
+			/* Shorten the step if the residual went up. The new length is the minimum of the quadratic that matches the squared residual
+			 * at the start of the step, its slope along the Newton direction, and the squared residual at the end of the step
+			 */
+			if(iteration > 0 && residual > previousResidual && numberOfReductions < p_maximumStepReductions)
+			{
+				const double startSquared = previousResidual * previousResidual;
+				const double endSquared = residual * residual;
+				double newLength = stepLength * stepLength * startSquared / (endSquared - startSquared + 2.0 * startSquared * stepLength);
+
+				newLength = std::min(std::max(newLength, 0.1 * stepLength), 0.5 * stepLength);
+				numberOfReductions++;
+				system.zeroSolution();
+
+				for(int i = 0; i < numberOfEquations; i++)
+				{
+					currentValues[i] = previousValues[i] + (newLength / stepLength) * (currentValues[i] - previousValues[i]);
+					system.addToSolution(i, currentValues[i]);
+				}
+
+				stepLength = newLength;
+
+				for(int i = 0; i < numberOfNodes; i++)
+				{
+					if(nodeEquation[i] != -1)
+						solution[i] = nodeSign[i] * currentValues[nodeEquation[i]];
+				}
+
+				continue;
+			}
+
+			// After a short step, the next step starts at twice its length
+			stepLength = std::min(1.0, 2.0 * stepLength);
+			numberOfReductions = 0;
+			previousResidual = residual;
+			previousValues = currentValues;
+
+			// The linear system only needs to be solved a bit more accurately than the residual of the Newton-Raphson method
+			system.setPrec(std::max(precision, 0.01 * residual / std::max(system.norm2RightHandSide(), 1e-300)));
+		}
+		else
+			system.setPrec(precision);
+
+		/* The incomplete factors are kept as long as the conjugate gradient converges in about as many iterations as it
+		 * did right after the last factorization
+		 */
+		system.setMaxIterations(std::max(1000, 10 * numberOfEquations));
+		system.setReusePreconditioner(numberOfFactorizations > 0 && lastIterations <= 2 * factorizationIterations + 10);
+
+		bool linearConverged = (system.systemSolve() == 1);
+
+		if(!linearConverged && system.getPreconditionerReused())
+		{
+			numberOfLinearIterations += system.getNumIterations();
+			system.setReusePreconditioner(false);
+			linearConverged = (system.systemSolve() == 1);
+		}
+
+		if(!system.getPreconditionerReused())
+		{
+			numberOfFactorizations++;
+			factorizationIterations = system.getNumIterations();
+		}
+
+		lastIterations = system.getNumIterations();
+		numberOfLinearIterations += lastIterations;
+		solverTime += TimeOfDay() - iterationAssembly;
+		p_numberOfNewtonIterations = iteration + 1;
+
+		for(int i = 0; i < numberOfEquations; i++)
+			system.getFromSolution(i, currentValues[i]);
+
+		if(isNonlinear && stepLength < 1)
+		{
+			system.zeroSolution();
+
+			for(int i = 0; i < numberOfEquations; i++)
+			{
+				currentValues[i] = previousValues[i] + stepLength * (currentValues[i] - previousValues[i]);
+				system.addToSolution(i, currentValues[i]);
+			}
+		}
+
+		for(int i = 0; i < numberOfNodes; i++)
+		{
+			if(nodeEquation[i] != -1)
+				solution[i] = nodeSign[i] * currentValues[nodeEquation[i]];
+		}
+
+		if(!linearConverged)
+		{
+			linearFailure = true;
+			break;
+		}
+
+		if(!isNonlinear)
+		{
+			converged = true;
+			break;
+		}
+	}
+
+	double iterationTime = TimeOfDay();
+
+	// The potential and the flux density of the elements
+	p_potential.resize(numberOfNodes);
+
+	for(int i = 0; i < numberOfNodes; i++)
+	{
+		if(axisymmetric)
+			p_potential[i] = (x[i] > 0) ? solution[i] / x[i] : 0;
+		else
+			p_potential[i] = solution[i];
+	}
+
+	p_fluxDensityX.resize(p_mesh->getNumberOfElements());
+	p_fluxDensityY.resize(p_mesh->getNumberOfElements());
+
+	for(unsigned int b = 0; b < blocks.size(); b++)
+	{
+		const solverMesh::elementBlock &block = blocks[b];
+		const int n = block.numberOfNodes;
+		const int numberOfElements = block.regions.size();
+		const int numberOfBatches = (numberOfElements + p_batchSize - 1) / p_batchSize;
+		const elementKernel &kernel = kernels[b];
+
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+		{
+			std::vector<double> buffer;
+			std::vector<double> matrices(p_batchSize * n * n);
+			std::vector<double> vectors(p_batchSize * n);
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+			for(int batch = 0; batch < numberOfBatches; batch++)
+			{
+				const int first = batch * p_batchSize;
+				const int count = std::min(p_batchSize, numberOfElements - first);
+
+				computeElements(block, first, count, kernel, laws, solution, axisymmetric, buffer, &matrices[0], &vectors[0],
+								&p_fluxDensityX[assembly.getBlockStart(b) + first], &p_fluxDensityY[assembly.getBlockStart(b) + first]);
+			}
+		}
+	}
+
+	double totalTime = TimeOfDay();
+	std::ostringstream timing;
+
+	timing << std::fixed << std::setprecision(3);
+	timing << "Mesh: " << meshTime - startTime << " s (" << numberOfNodes << " nodes, " << p_mesh->getNumberOfElements() << " elements)\n";
+	timing << "Materials: " << materialTime - meshTime << " s\n";
+	timing << "Sparsity pattern: " << patternTime - materialTime << " s\n";
+	timing << "Assembly: " << assemblyTime << " s (" << numberOfAssemblies << " assemblies, " << p_mesh->getNumberOfColors() << " colors, " << numberOfThreads << " threads)\n";
+	timing << "Linear solver: " << solverTime << " s (" << numberOfLinearIterations << " iterations, " << numberOfFactorizations << " factorizations)\n";
+
+	if(isNonlinear)
+		timing << "Newton-Raphson: " << p_numberOfNewtonIterations << " iterations, relative residual " << std::scientific << std::setprecision(2) << relativeResidual << "\n" << std::fixed << std::setprecision(3);
+
+	timing << "Flux density: " << totalTime - iterationTime << " s\n";
+	timing << "Total: " << totalTime - startTime << " s";
+
+	OmniFEMMsg::instance()->MsgInfo(timing.str());
+
+	if(linearFailure)
+		OmniFEMMsg::instance()->MsgError("The linear solver did not converge to the requested precision");
+	else if(!converged)
+		OmniFEMMsg::instance()->MsgError("The Newton-Raphson iterations did not converge in " + std::to_string(p_maximumNewtonIterations) + " iterations");
+	else
+		OmniFEMMsg::instance()->MsgStatus("Solver Finished");
+
+	return converged && !linearFailure;
+}
@@ -0,0 +1,60 @@
+#include <Solver/PVDWriter.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+
+
+std::string pvdWriter::getStepPath(std::string basePath, unsigned int index)
+{
+	std::ostringstream stepPath;
+
+	stepPath << basePath << "_" << std::setw(5) << std::setfill('0') << index << ".vtu";
+
+	return stepPath.str();
+}
+
+
+
+bool pvdWriter::addStep(double time, std::string vtuFilePath)
+{
+	size_t folderEnd = p_filePath.find_last_of("/\\");
+	step newStep;
+
+	// ParaView looks for the files relative to the collection
+	if(folderEnd != std::string::npos && vtuFilePath.compare(0, folderEnd + 1, p_filePath, 0, folderEnd + 1) == 0)
+		vtuFilePath.erase(0, folderEnd + 1);
+
+	newStep.time = time;
+	newStep.filePath = vtuFilePath;
+	p_steps.push_back(newStep);
+
+	return write();
+}
+
+
+
+bool pvdWriter::write()
+{
+	std::ofstream collectionFile(p_filePath);
+
+	if(!collectionFile.is_open())
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to write " + p_filePath);
+		return false;
+	}
+
+	collectionFile << std::setprecision(17);
+	collectionFile << "<?xml version=\"1.0\"?>\n";
+	collectionFile << "<VTKFile type=\"Collection\" version=\"0.1\">\n";
+	collectionFile << "  <Collection>\n";
+
+	for(auto stepIterator = p_steps.begin(); stepIterator != p_steps.end(); stepIterator++)
+		collectionFile << "    <DataSet timestep=\"" << stepIterator->time << "\" group=\"\" part=\"0\" file=\"" << stepIterator->filePath << "\"/>\n";
+
+	collectionFile << "  </Collection>\n";
+	collectionFile << "</VTKFile>\n";
+
+	return collectionFile.good();
+}
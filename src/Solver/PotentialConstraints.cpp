@@ -0,0 +1,135 @@
+#include <Solver/PotentialConstraints.h>
+
+#include <math.h>
+#include <algorithm>
+
+
+
+int potentialConstraints::findRoot(int unknown, double &sign)
+{
+	int root = unknown;
+
+	sign = 1.0;
+
+	while(p_parent[root] != root)
+	{
+		sign *= p_sign[root];
+		root = p_parent[root];
+	}
+
+	// Each unknown along the chain is pointed straight to the root so that the next search is short
+	int current = unknown;
+	double currentSign = sign;
+
+	while(p_parent[current] != root && current != root)
+	{
+		int next = p_parent[current];
+		double nextSign = currentSign * p_sign[current];
+
+		p_parent[current] = root;
+		p_sign[current] = currentSign;
+		current = next;
+		currentSign = nextSign;
+	}
+
+	return root;
+}
+
+
+
+void potentialConstraints::fix(int unknown, double value)
+{
+	double sign;
+	int root = findRoot(unknown, sign);
+	double rootValue = sign * value;
+
+	if(p_isFixed[root])
+	{
+		if(fabs(p_value[root] - rootValue) > 1e-12 * (fabs(p_value[root]) + fabs(rootValue)))
+			p_numberOfConflicts++;
+
+		return;
+	}
+
+	p_isFixed[root] = true;
+	p_value[root] = rootValue;
+}
+
+
+
+void potentialConstraints::tie(int slave, int master, double sign)
+{
+	double slaveSign, masterSign;
+	int slaveRoot = findRoot(slave, slaveSign);
+	int masterRoot = findRoot(master, masterSign);
+
+	// u_slaveRoot = rootSign * u_masterRoot
+	double rootSign = slaveSign * sign * masterSign;
+
+	if(slaveRoot == masterRoot)
+	{
+		if(rootSign != 1.0)
+			p_numberOfConflicts++;
+
+		return;
+	}
+
+	p_parent[slaveRoot] = masterRoot;
+	p_sign[slaveRoot] = rootSign;
+
+	if(p_isFixed[slaveRoot])
+	{
+		p_isFixed[slaveRoot] = false;
+		fix(slaveRoot, p_value[slaveRoot]);
+	}
+}
+
+
+
+bool potentialConstraints::tieEdges(const std::vector<int> &firstEdge, const std::vector<int> &secondEdge, const double *x, const double *y, double sign)
+{
+	const int numberOfNodes = firstEdge.size();
+	double bestSpread = -1;
+	bool bestReversed = false;
+
+	if(firstEdge.size() != secondEdge.size() || firstEdge.empty())
+		return false;
+
+	for(int direction = 0; direction < 2; direction++)
+	{
+		const bool reversed = (direction == 1);
+		double translationSpread = 0;
+		double rotationSpread = 0;
+		double shiftX = 0, shiftY = 0;
+
+		for(int k = 0; k < numberOfNodes; k++)
+		{
+			const int a = firstEdge[k];
+			const int b = secondEdge[reversed ? numberOfNodes - 1 - k : k];
+			const double dx = x[b] - x[a];
+			const double dy = y[b] - y[a];
+
+			if(k == 0)
+			{
+				shiftX = dx;
+				shiftY = dy;
+			}
+
+			translationSpread += (dx - shiftX) * (dx - shiftX) + (dy - shiftY) * (dy - shiftY);
+			rotationSpread += pow(sqrt(x[b] * x[b] + y[b] * y[b]) - sqrt(x[a] * x[a] + y[a] * y[a]), 2);
+		}
+
+		const double spread = std::min(translationSpread, rotationSpread);
+
+		if(bestSpread < 0 || spread < bestSpread)
+		{
+			bestSpread = spread;
+			bestReversed = reversed;
+		}
+	}
+
+	for(int k = 0; k < numberOfNodes; k++)
+		tie(secondEdge[bestReversed ? numberOfNodes - 1 - k : k], firstEdge[k], sign);
+
+	return true;
+}
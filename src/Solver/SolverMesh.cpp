@@ -0,0 +1,286 @@
+#include <Solver/SolverMesh.h>
+#include <Solver/ElementKernels.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+
+
+solverMesh::solverMesh(GModel *model, double scale)
+{
+	std::vector<GEntity*> entities;
+	std::vector<int> vertexToNode;
+
+	model->getEntities(entities);
+
+	/* The numbers of the GMSH vertices are not guaranteed to be contiguous. So, a lookup table
+	 * from the number of the vertex to the index of the node is used
+	 */
+	int maxNumber = 0;
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		for(auto vertexIterator = (*entityIterator)->mesh_vertices.begin(); vertexIterator != (*entityIterator)->mesh_vertices.end(); vertexIterator++)
+			maxNumber = std::max(maxNumber, (*vertexIterator)->getNum());
+	}
+
+	vertexToNode.assign(maxNumber + 1, -1);
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		for(auto vertexIterator = (*entityIterator)->mesh_vertices.begin(); vertexIterator != (*entityIterator)->mesh_vertices.end(); vertexIterator++)
+		{
+			if(vertexToNode[(*vertexIterator)->getNum()] != -1)
+				continue;
+
+			vertexToNode[(*vertexIterator)->getNum()] = p_x.size();
+			p_x.push_back((*vertexIterator)->x() * scale);
+			p_y.push_back((*vertexIterator)->y() * scale);
+		}
+	}
+
+	for(GModel::fiter faceIterator = model->firstFace(); faceIterator != model->lastFace(); faceIterator++)
+	{
+		const int regionIndex = p_regions.size();
+		region faceRegion;
+
+		faceRegion.groups = getGroupNames(model, *faceIterator);
+		p_regions.push_back(faceRegion);
+
+		for(unsigned int i = 0; i < (*faceIterator)->getNumMeshElements(); i++)
+		{
+			MElement *element = (*faceIterator)->getMeshElement(i);
+			elementBlock *block = nullptr;
+
+			for(auto blockIterator = p_blocks.begin(); blockIterator != p_blocks.end(); blockIterator++)
+			{
+				if(blockIterator->type == element->getTypeForMSH())
+				{
+					block = &(*blockIterator);
+					break;
+				}
+			}
+
+			if(!block)
+			{
+				elementBlock newBlock;
+
+				newBlock.type = element->getTypeForMSH();
+				newBlock.order = element->getPolynomialOrder();
+				newBlock.numberOfNodes = element->getNumVertices();
+				p_blocks.push_back(newBlock);
+				block = &p_blocks.back();
+			}
+
+			for(int j = 0; j < block->numberOfNodes; j++)
+				block->nodes.push_back(vertexToNode[element->getVertex(j)->getNum()]);
+
+			block->regions.push_back(regionIndex);
+		}
+	}
+
+	for(auto blockIterator = p_blocks.begin(); blockIterator != p_blocks.end(); blockIterator++)
+		colorBlock(*blockIterator);
+
+	for(GModel::eiter edgeIterator = model->firstEdge(); edgeIterator != model->lastEdge(); edgeIterator++)
+	{
+		edgeSegment segment;
+
+		segment.groups = getGroupNames(model, *edgeIterator);
+
+		if(segment.groups.empty() || (*edgeIterator)->lines.empty())
+			continue;
+
+		segment.type = (*edgeIterator)->lines[0]->getTypeForMSH();
+		segment.numberOfNodes = (*edgeIterator)->lines[0]->getNumVertices();
+
+		/* The line elements are stored from the start of the edge to the end of the edge. The high order nodes of a line
+		 * come after the two end nodes of the line
+		 */
+		for(auto lineIterator = (*edgeIterator)->lines.begin(); lineIterator != (*edgeIterator)->lines.end(); lineIterator++)
+		{
+			for(int j = 0; j < segment.numberOfNodes; j++)
+				segment.nodes.push_back(vertexToNode[(*lineIterator)->getVertex(j)->getNum()]);
+
+			segment.orderedNodes.push_back(vertexToNode[(*lineIterator)->getVertex(0)->getNum()]);
+
+			for(int j = 2; j < segment.numberOfNodes; j++)
+				segment.orderedNodes.push_back(vertexToNode[(*lineIterator)->getVertex(j)->getNum()]);
+		}
+
+		segment.orderedNodes.push_back(vertexToNode[(*edgeIterator)->lines.back()->getVertex(1)->getNum()]);
+
+		p_edges.push_back(segment);
+	}
+
+	for(GModel::viter vertexIterator = model->firstVertex(); vertexIterator != model->lastVertex(); vertexIterator++)
+	{
+		pointNode point;
+
+		point.groups = getGroupNames(model, *vertexIterator);
+
+		if(point.groups.empty() || (*vertexIterator)->mesh_vertices.empty())
+			continue;
+
+		point.node = vertexToNode[(*vertexIterator)->mesh_vertices[0]->getNum()];
+		p_points.push_back(point);
+	}
+}
+
+
+
+void solverMesh::colorBlock(elementBlock &block)
+{
+	const int numberOfElements = block.regions.size();
+	const int maxColors = 64;
+	std::vector<uint64_t> nodeColors(p_x.size(), 0);
+	std::vector<int> elementColor(numberOfElements);
+	std::vector<int> colorCount(maxColors + 1, 0);
+	int numberOfColors = 0;
+
+	for(int i = 0; i < numberOfElements; i++)
+	{
+		const int *elementNodes = &block.nodes[i * block.numberOfNodes];
+		uint64_t usedColors = 0;
+		int color = 0;
+
+		for(int j = 0; j < block.numberOfNodes; j++)
+			usedColors |= nodeColors[elementNodes[j]];
+
+		// The first free color is the lowest bit that is not set. If all of the colors are used, the element is left for the serial color
+		while(color < maxColors && (usedColors & ((uint64_t)1 << color)))
+			color++;
+
+		if(color < maxColors)
+		{
+			for(int j = 0; j < block.numberOfNodes; j++)
+				nodeColors[elementNodes[j]] |= ((uint64_t)1 << color);
+
+			numberOfColors = std::max(numberOfColors, color + 1);
+		}
+		else
+			block.serialColor = maxColors;
+
+		elementColor[i] = color;
+		colorCount[color]++;
+	}
+
+	if(block.serialColor != -1)
+	{
+		// The serial color is moved to right after the last real color
+		colorCount[numberOfColors] = colorCount[maxColors];
+		for(int i = 0; i < numberOfElements; i++)
+		{
+			if(elementColor[i] == maxColors)
+				elementColor[i] = numberOfColors;
+		}
+
+		block.serialColor = numberOfColors;
+		numberOfColors++;
+	}
+
+	block.colorOffset.assign(numberOfColors + 1, 0);
+
+	for(int i = 0; i < numberOfColors; i++)
+		block.colorOffset[i + 1] = block.colorOffset[i] + colorCount[i];
+
+	// Counting sort of the elements by their color
+	std::vector<int> position(block.colorOffset.begin(), block.colorOffset.end() - 1);
+	std::vector<int> sortedNodes(block.nodes.size());
+	std::vector<int> sortedRegions(numberOfElements);
+
+	for(int i = 0; i < numberOfElements; i++)
+	{
+		const int newIndex = position[elementColor[i]]++;
+
+		std::copy(block.nodes.begin() + i * block.numberOfNodes, block.nodes.begin() + (i + 1) * block.numberOfNodes, sortedNodes.begin() + newIndex * block.numberOfNodes);
+		sortedRegions[newIndex] = block.regions[i];
+	}
+
+	block.nodes.swap(sortedNodes);
+	block.regions.swap(sortedRegions);
+}
+
+
+
+std::vector<std::string> solverMesh::getGroupNames(GModel *model, GEntity *entity)
+{
+	std::vector<std::string> names;
+
+	for(auto physicalIterator = entity->physicals.begin(); physicalIterator != entity->physicals.end(); physicalIterator++)
+	{
+		std::string name = model->getPhysicalName(entity->dim(), std::abs(*physicalIterator));
+
+		if(name != "")
+			names.push_back(name);
+	}
+
+	return names;
+}
+
+
+
+int solverMesh::getNumberOfElements() const
+{
+	int numberOfElements = 0;
+
+	for(auto blockIterator = p_blocks.begin(); blockIterator != p_blocks.end(); blockIterator++)
+		numberOfElements += blockIterator->regions.size();
+
+	return numberOfElements;
+}
+
+
+
+int solverMesh::getNumberOfColors() const
+{
+	int numberOfColors = 0;
+
+	for(auto blockIterator = p_blocks.begin(); blockIterator != p_blocks.end(); blockIterator++)
+		numberOfColors = std::max(numberOfColors, (int)blockIterator->colorOffset.size() - 1);
+
+	return numberOfColors;
+}
+
+
+
+std::vector<double> solverMesh::getRegionAreas() const
+{
+	std::vector<double> areas(p_regions.size(), 0.0);
+
+	for(auto blockIterator = p_blocks.begin(); blockIterator != p_blocks.end(); blockIterator++)
+	{
+		const int n = blockIterator->numberOfNodes;
+		const elementKernel kernel(blockIterator->type, false);
+		std::vector<double> elementX(n), elementY(n), gradientX(n), gradientY(n);
+		double r;
+
+		for(unsigned int e = 0; e < blockIterator->regions.size(); e++)
+		{
+			for(int i = 0; i < n; i++)
+			{
+				elementX[i] = p_x[blockIterator->nodes[e * n + i]];
+				elementY[i] = p_y[blockIterator->nodes[e * n + i]];
+			}
+
+			for(int q = 0; q < kernel.getNumberOfPoints(); q++)
+				areas[blockIterator->regions[e]] += kernel.mapGradients(q, &elementX[0], &elementY[0], &gradientX[0], &gradientY[0], r);
+		}
+	}
+
+	return areas;
+}
+
+
+
+std::vector<bool> solverMesh::getUsedNodes() const
+{
+	std::vector<bool> isUsed(p_x.size(), false);
+
+	for(auto blockIterator = p_blocks.begin(); blockIterator != p_blocks.end(); blockIterator++)
+	{
+		for(auto nodeIterator = blockIterator->nodes.begin(); nodeIterator != blockIterator->nodes.end(); nodeIterator++)
+			isUsed[*nodeIterator] = true;
+	}
+
+	return isUsed;
+}
@@ -0,0 +1,1088 @@
+#include <Solver/TransientMagneticSolver.h>
+
+#include <math.h>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+
+const int transientMagneticSolver::p_batchSize;
+const int transientMagneticSolver::p_maximumNewtonIterations;
+const int transientMagneticSolver::p_maximumStepReductions;
+const int transientMagneticSolver::p_maximumTimeSteps;
+
+
+
+transientMagneticSolver::transientMagneticSolver(problemDefinition &definition, GModel *model)
+{
+	p_model = model;
+
+	p_materials = *definition.getMagnetMaterialList();
+	p_boundaries = *definition.getMagneticBoundaryList();
+	p_circuits = *definition.getCircuitList();
+	p_nodalProperties = *definition.getNodalPropertyList();
+	p_preferences = definition.getMagneticPreference();
+}
+
+
+
+void transientMagneticSolver::createRegionLaws(std::vector<regionLaw> &laws)
+{
+	std::vector<solverMesh::region> &regions = *p_mesh->getRegions();
+	std::vector<regionLaw> materialLaws(p_materials.size());
+	bool hasParallelLaminations = false;
+	bool hasAnisotropy = false;
+
+	clearModels();
+	p_hysteresisModels.assign(p_materials.size(), nullptr);
+
+	for(unsigned int m = 0; m < p_materials.size(); m++)
+	{
+		magneticMaterial &material = p_materials[m];
+		regionLaw &law = materialLaws[m];
+		const lamWireEnum attribute = material.getSpecialAttribute();
+		const double conductivity = std::max(material.getSigma(), 0.0) * 1e6;
+		const double fillFactor = magneticRegions::getFillFactor(material);
+
+		// No current flows along z in laminations in the plane or in the strands of a wire. Across the laminations, the current flows in the iron
+		switch(attribute)
+		{
+			case LAMINATED_IN_PLANE:
+			case MAGNET_WIRE:
+			case PLAIN_STRANDED_WIRE:
+			case LITZ_WIRE:
+			case SQUARE_WIRE:
+			case CCA_10:
+			case CCA_15:
+				break;
+			default:
+				law.materialConductivity = fillFactor * conductivity;
+				law.conductivity = p_vacuumPermeability * law.materialConductivity;
+				break;
+		}
+
+		law.source = p_vacuumPermeability * material.getCurrentDensity() * 1e6;
+
+		if(!material.getBHState())
+		{
+			jilesAthertonParameters parameters = material.getJilesAtherton();
+
+			if(jilesAthertonModel::isValid(parameters))
+			{
+				p_hysteresisModels[m] = new jilesAthertonModel(parameters, fillFactor);
+				law.model = p_hysteresisModels[m];
+				hasParallelLaminations = hasParallelLaminations || (magneticRegions::isLaminated(attribute) && attribute != LAMINATED_IN_PLANE && fillFactor < 1);
+				hasAnisotropy = hasAnisotropy || parameters.getIsAnisotropyMaterial();
+				continue;
+			}
+
+			OmniFEMMsg::instance()->MsgWarning("The material " + material.getName() + " is nonlinear but does not have a saturation magnetization, a domain wall density, and a pinning energy. The material is solved as linear");
+		}
+
+		magneticRegions::getReluctivity(material, fillFactor, law.reluctivityXX, law.reluctivityYY);
+	}
+
+	if(hasParallelLaminations)
+		OmniFEMMsg::instance()->MsgWarning("The laminations of hysteretic materials are treated as laminations in the plane of the problem");
+
+	if(hasAnisotropy)
+		OmniFEMMsg::instance()->MsgWarning("The Y parameters (anisotropy) of the Jiles-Atherton model are ignored. The materials are solved as isotropic with the X parameters");
+
+	magneticRegions regionGroups(p_mesh, p_materials, p_circuits);
+
+	laws.assign(regions.size(), regionLaw());
+
+	for(unsigned int r = 0; r < regions.size(); r++)
+	{
+		const int material = regionGroups.getMaterial(r);
+		const double magnetization = regionGroups.getMagnetization(r);
+
+		if(material == -1)
+			continue;
+
+		laws[r] = materialLaws[material];
+		laws[r].magnetX = p_vacuumPermeability * p_materials[material].getCoercivity() * cos(magnetization * M_PI / 180.0);
+		laws[r].magnetY = p_vacuumPermeability * p_materials[material].getCoercivity() * sin(magnetization * M_PI / 180.0);
+	}
+
+	/* The current of a parallel circuit is spread evenly over its blocks. The current of a circuit is imposed so the blocks of a circuit
+	 * do not carry eddy currents
+	 */
+	std::vector<double> circuitSources = regionGroups.getCircuitSources(p_vacuumPermeability);
+
+	for(unsigned int r = 0; r < regions.size(); r++)
+	{
+		if(regionGroups.getCircuit(r) == -1)
+			continue;
+
+		laws[r].source += circuitSources[r];
+		laws[r].conductivity = 0;
+		laws[r].materialConductivity = 0;
+	}
+}
+
+
+
+void transientMagneticSolver::createQuadraturePoints(const std::vector<regionLaw> &laws, bool axisymmetric)
+{
+	std::vector<solverMesh::elementBlock> &blocks = *p_mesh->getElementBlocks();
+	std::map<jilesAthertonModel*, int> numberOfPoints;
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+
+	p_elementPoint.assign(p_mesh->getNumberOfElements(), -1);
+
+	// The points of the elements of a material are numbered in the order of the elements so that neighboring elements are close together in the arrays
+	for(unsigned int b = 0, blockStart = 0; b < blocks.size(); blockStart += blocks[b].regions.size(), b++)
+	{
+		const elementKernel kernel(blocks[b].type, axisymmetric);
+
+		for(unsigned int e = 0; e < blocks[b].regions.size(); e++)
+		{
+			jilesAthertonModel *model = laws[blocks[b].regions[e]].model;
+
+			if(model)
+			{
+				p_elementPoint[blockStart + e] = numberOfPoints[model];
+				numberOfPoints[model] += kernel.getNumberOfPoints();
+			}
+		}
+	}
+
+	p_pointWeights.assign(p_hysteresisModels.size(), std::vector<double>());
+
+	for(unsigned int m = 0; m < p_hysteresisModels.size(); m++)
+	{
+		if(p_hysteresisModels[m])
+		{
+			p_hysteresisModels[m]->resize(numberOfPoints[p_hysteresisModels[m]]);
+			p_pointWeights[m].resize(numberOfPoints[p_hysteresisModels[m]]);
+		}
+	}
+
+	for(unsigned int b = 0, blockStart = 0; b < blocks.size(); blockStart += blocks[b].regions.size(), b++)
+	{
+		const int n = blocks[b].numberOfNodes;
+		const elementKernel kernel(blocks[b].type, axisymmetric);
+		std::vector<double> elementX(n), elementY(n), gradientX(n), gradientY(n);
+
+		for(unsigned int e = 0; e < blocks[b].regions.size(); e++)
+		{
+			jilesAthertonModel *model = laws[blocks[b].regions[e]].model;
+
+			if(!model)
+				continue;
+
+			const int material = std::find(p_hysteresisModels.begin(), p_hysteresisModels.end(), model) - p_hysteresisModels.begin();
+
+			for(int i = 0; i < n; i++)
+			{
+				elementX[i] = x[blocks[b].nodes[e * n + i]];
+				elementY[i] = y[blocks[b].nodes[e * n + i]];
+			}
+
+			for(int q = 0; q < kernel.getNumberOfPoints(); q++)
+			{
+				double r;
+				const double jacobianWeight = kernel.mapGradients(q, &elementX[0], &elementY[0], &gradientX[0], &gradientY[0], r);
+
+				p_pointWeights[material][p_elementPoint[blockStart + e] + q] = jacobianWeight * (axisymmetric ? 2 * M_PI * r : 1.0);
+			}
+		}
+	}
+}
+
+
+
+void transientMagneticSolver::computeTrialFlux(const solverMesh::elementBlock &block, int blockStart, const elementKernel &kernel, const std::vector<regionLaw> &laws,
+											   const std::vector<double> &solution, bool axisymmetric)
+{
+	const int n = block.numberOfNodes;
+	const int numberOfElements = block.regions.size();
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+	const double orientation = axisymmetric ? -1.0 : 1.0;
+
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+	{
+		std::vector<double> elementX(n), elementY(n), elementU(n), gradientX(n), gradientY(n);
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+		for(int e = 0; e < numberOfElements; e++)
+		{
+			const int point = p_elementPoint[blockStart + e];
+
+			if(point == -1)
+				continue;
+
+			jilesAthertonModel *model = laws[block.regions[e]].model;
+			double *fluxX = model->getTrialFluxX() + point;
+			double *fluxY = model->getTrialFluxY() + point;
+
+			for(int i = 0; i < n; i++)
+			{
+				elementX[i] = x[block.nodes[e * n + i]];
+				elementY[i] = y[block.nodes[e * n + i]];
+				elementU[i] = solution[block.nodes[e * n + i]];
+			}
+
+			for(int q = 0; q < kernel.getNumberOfPoints(); q++)
+			{
+				double r;
+				double potentialX = 0, potentialY = 0;
+
+				kernel.mapGradients(q, &elementX[0], &elementY[0], &gradientX[0], &gradientY[0], r);
+
+				if(!axisymmetric)
+					r = 1.0;
+
+				for(int i = 0; i < n; i++)
+				{
+					potentialX += elementU[i] * gradientX[i];
+					potentialY += elementU[i] * gradientY[i];
+				}
+
+				fluxX[q] = orientation * potentialY / r;
+				fluxY[q] = -orientation * potentialX / r;
+			}
+		}
+	}
+}
+
+
+
+void transientMagneticSolver::computeElements(const solverMesh::elementBlock &block, int blockStart, int first, int count, const elementKernel &kernel,
+											  const elementKernel &massKernel, const std::vector<regionLaw> &laws, const std::vector<double> &solution,
+											  const std::vector<double> &previousSolution, double inverseStep, double waveform, bool axisymmetric,
+											  std::vector<double> &buffer, double *matrices, double *vectors)
+{
+	const int n = block.numberOfNodes;
+	const int *nodes = &block.nodes[first * n];
+	const int *regions = &block.regions[first];
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+	// The flux density is (dA/dy, -dA/dx) for planar problems and (-dA/dz, dA/dr) / r for axisymmetric problems
+	const double orientation = axisymmetric ? -1.0 : 1.0;
+
+	buffer.resize(6 * n);
+
+	double *elementX = &buffer[0];
+	double *elementY = elementX + n;
+	double *elementU = elementY + n;
+	double *elementPrevious = elementU + n;
+	double *gradientX = elementPrevious + n;
+	double *gradientY = gradientX + n;
+
+	for(int e = 0; e < count; e++)
+	{
+		const regionLaw &law = laws[regions[e]];
+		const int point = p_elementPoint[blockStart + first + e];
+		double *matrix = &matrices[e * n * n];
+		double *vector = &vectors[e * n];
+
+		for(int i = 0; i < n; i++)
+		{
+			elementX[i] = x[nodes[e * n + i]];
+			elementY[i] = y[nodes[e * n + i]];
+			elementU[i] = solution[nodes[e * n + i]];
+			elementPrevious[i] = previousSolution[nodes[e * n + i]];
+			vector[i] = 0;
+		}
+
+		for(int i = 0; i < n * n; i++)
+			matrix[i] = 0;
+
+		for(int q = 0; q < kernel.getNumberOfPoints(); q++)
+		{
+			const double *N = kernel.getShapeFunctions(q);
+			double r;
+			const double jacobianWeight = kernel.mapGradients(q, elementX, elementY, gradientX, gradientY, r);
+			const double weight = jacobianWeight / (axisymmetric ? r : 1.0);
+
+			if(law.model)
+			{
+				/* The residual is the integral of mu0 H . dB/du and the matrix uses the differential reluctivity mu0 dH/dB of the model. The
+				 * vector is the matrix times the current solution minus the residual
+				 */
+				const double reluctivityXX = law.model->getReluctivityY()[point + q];
+				const double reluctivityYY = law.model->getReluctivityX()[point + q];
+				const double fieldX = p_vacuumPermeability * law.model->getTrialFieldX()[point + q];
+				const double fieldY = p_vacuumPermeability * law.model->getTrialFieldY()[point + q];
+				double potentialX = 0, potentialY = 0;
+
+				for(int i = 0; i < n; i++)
+				{
+					potentialX += elementU[i] * gradientX[i];
+					potentialY += elementU[i] * gradientY[i];
+				}
+
+				for(int j = 0; j < n; j++)
+				{
+					const double columnX = weight * reluctivityXX * gradientX[j];
+					const double columnY = weight * reluctivityYY * gradientY[j];
+					double *column = &matrix[j * n];
+
+					for(int i = 0; i < n; i++)
+						column[i] += gradientX[i] * columnX + gradientY[i] * columnY;
+				}
+
+				for(int i = 0; i < n; i++)
+				{
+					vector[i] += weight * (reluctivityXX * potentialX * gradientX[i] + reluctivityYY * potentialY * gradientY[i])
+								- jacobianWeight * orientation * (fieldX * gradientY[i] - fieldY * gradientX[i]);
+				}
+			}
+			else
+			{
+				for(int j = 0; j < n; j++)
+				{
+					const double columnX = weight * law.reluctivityXX * gradientX[j];
+					const double columnY = weight * law.reluctivityYY * gradientY[j];
+					double *column = &matrix[j * n];
+
+					for(int i = 0; i < n; i++)
+						column[i] += gradientX[i] * columnX + gradientY[i] * columnY;
+				}
+
+				for(int i = 0; i < n; i++)
+					vector[i] += jacobianWeight * orientation * (law.magnetX * gradientY[i] - law.magnetY * gradientX[i]);
+			}
+
+			for(int i = 0; i < n; i++)
+				vector[i] += jacobianWeight * law.source * waveform * N[i];
+		}
+
+		if(law.conductivity == 0)
+			continue;
+
+		// The eddy current density is -sigma dA/dt. With the backward Euler method, this adds sigma / dt times the mass matrix
+		for(int q = 0; q < massKernel.getNumberOfPoints(); q++)
+		{
+			const double *N = massKernel.getShapeFunctions(q);
+			double r;
+			const double jacobianWeight = massKernel.mapGradients(q, elementX, elementY, gradientX, gradientY, r);
+			const double weight = law.conductivity * inverseStep * jacobianWeight / (axisymmetric ? r : 1.0);
+			double previous = 0;
+
+			for(int i = 0; i < n; i++)
+				previous += elementPrevious[i] * N[i];
+
+			for(int j = 0; j < n; j++)
+			{
+				const double column = weight * N[j];
+
+				for(int i = 0; i < n; i++)
+					matrix[j * n + i] += N[i] * column;
+			}
+
+			for(int i = 0; i < n; i++)
+				vector[i] += weight * previous * N[i];
+		}
+	}
+}
+
+
+
+double transientMagneticSolver::getEddyCurrentEnergy(const std::vector<regionLaw> &laws, const std::vector<double> &solution, const std::vector<double> &previousSolution,
+													 double step, bool axisymmetric)
+{
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+	double energy = 0;
+
+	// The loss density is sigma (dA/dt)^2. For axisymmetric problems, A = psi / r and the volume is 2 pi r dr dz
+	for(auto blockIterator = p_mesh->getElementBlocks()->begin(); blockIterator != p_mesh->getElementBlocks()->end(); blockIterator++)
+	{
+		const solverMesh::elementBlock &block = *blockIterator;
+		const int n = block.numberOfNodes;
+		const int numberOfElements = block.regions.size();
+		const elementKernel massKernel(block.type, axisymmetric, true);
+
+#if defined(_OPENMP)
+#pragma omp parallel reduction(+:energy)
+#endif
+		{
+			std::vector<double> elementX(n), elementY(n), gradientX(n), gradientY(n);
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+			for(int e = 0; e < numberOfElements; e++)
+			{
+				const regionLaw &law = laws[block.regions[e]];
+
+				if(law.materialConductivity == 0)
+					continue;
+
+				for(int i = 0; i < n; i++)
+				{
+					elementX[i] = x[block.nodes[e * n + i]];
+					elementY[i] = y[block.nodes[e * n + i]];
+				}
+
+				for(int q = 0; q < massKernel.getNumberOfPoints(); q++)
+				{
+					const double *N = massKernel.getShapeFunctions(q);
+					double r;
+					const double jacobianWeight = massKernel.mapGradients(q, &elementX[0], &elementY[0], &gradientX[0], &gradientY[0], r);
+					double change = 0;
+
+					for(int i = 0; i < n; i++)
+						change += (solution[block.nodes[e * n + i]] - previousSolution[block.nodes[e * n + i]]) * N[i];
+
+					energy += law.materialConductivity * change * change * jacobianWeight * (axisymmetric ? 2 * M_PI / r : 1.0) / step;
+				}
+			}
+		}
+	}
+
+	return energy;
+}
+
+
+
+double transientMagneticSolver::getAveragePower(const std::vector<double> &energy)
+{
+	const double frequency = p_preferences.getFrequency();
+
+	if(p_times.size() < 2 || energy.size() != p_times.size() || frequency <= 0)
+		return 0;
+
+	// The energy at one period before the end is interpolated between the accepted steps
+	const double start = std::max(p_times.back() - 1.0 / frequency, 0.0);
+	const int index = std::max(int(std::upper_bound(p_times.begin(), p_times.end(), start) - p_times.begin()) - 1, 0);
+	const int next = std::min(index + 1, (int)p_times.size() - 1);
+	const double fraction = (next > index) ? (start - p_times[index]) / (p_times[next] - p_times[index]) : 0;
+	const double startEnergy = energy[index] + fraction * (energy[next] - energy[index]);
+
+	return (energy.back() - startEnergy) / (p_times.back() - start);
+}
+
+
+
+bool transientMagneticSolver::solve(int numberOfPeriods, int stepsPerPeriod, double tolerance)
+{
+	const bool axisymmetric = p_preferences.isAxistmmetric();
+	const double scale = solverMesh::getUnitScale(p_preferences.getUnitLength());
+	const double frequency = p_preferences.getFrequency();
+	double precision = p_preferences.getPrecision();
+	double startTime = TimeOfDay();
+	int numberOfThreads = 1;
+
+#if defined(_OPENMP)
+	numberOfThreads = omp_get_max_threads();
+#endif
+
+	if(precision <= 0)
+		precision = 1e-8;
+
+	p_times.clear();
+	p_hysteresisEnergy.clear();
+	p_eddyCurrentEnergy.clear();
+	p_numberOfRejectedSteps = 0;
+
+	if(frequency <= 0 || numberOfPeriods <= 0 || stepsPerPeriod <= 0 || tolerance <= 0)
+	{
+		OmniFEMMsg::instance()->MsgError("The transient solver needs the frequency of the excitation, a number of periods, and a number of steps per period that are larger than zero");
+		return false;
+	}
+
+	OmniFEMMsg::instance()->MsgStatus("Reading the mesh");
+
+	delete p_mesh;
+	p_mesh = new solverMesh(p_model, scale);
+
+	const int numberOfNodes = p_mesh->getNumberOfNodes();
+	const double *x = p_mesh->getXCoordinates();
+	std::vector<solverMesh::elementBlock> &blocks = *p_mesh->getElementBlocks();
+
+	if(p_mesh->getNumberOfElements() == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("The mesh does not have any elements. Create the mesh before running the solver");
+		return false;
+	}
+
+	double meshTime = TimeOfDay();
+
+	std::vector<regionLaw> laws;
+
+	createRegionLaws(laws);
+	createQuadraturePoints(laws, axisymmetric);
+
+	bool isNonlinear = false;
+	int numberOfHysteresisPoints = 0;
+
+	for(auto modelIterator = p_hysteresisModels.begin(); modelIterator != p_hysteresisModels.end(); modelIterator++)
+	{
+		if(*modelIterator)
+		{
+			isNonlinear = true;
+			numberOfHysteresisPoints += (*modelIterator)->getNumberOfPoints();
+		}
+	}
+
+	double materialTime = TimeOfDay();
+
+	// The constraints hold the amplitude of the prescribed potentials. These follow the waveform of the sources
+	potentialConstraints constraints(numberOfNodes);
+	magneticConditions conditions(p_mesh, p_boundaries, p_nodalProperties, axisymmetric, scale);
+
+	if(conditions.hasUnsupportedBoundary() || !conditions.getSkinDepthEdges().empty())
+		OmniFEMMsg::instance()->MsgWarning("Small skin depth, mixed, and strategic dual image boundary conditions are not supported by the transient solver yet. These edges are treated as a zero tangential field");
+
+	conditions.fixValues(constraints);
+	conditions.tiePeriodicEdges(constraints);
+
+	if(constraints.getNumberOfConflicts() > 0)
+		OmniFEMMsg::instance()->MsgWarning(std::to_string(constraints.getNumberOfConflicts()) + " node(s) have conflicting potentials. The first potential that was found is used");
+
+	if(!constraints.hasFixedValue())
+	{
+		OmniFEMMsg::instance()->MsgError("The vector potential is not fixed anywhere in the problem. Add a prescribed A boundary or nodal property");
+		return false;
+	}
+
+	// The center of an arc is a vertex of the GMSH model but not part of the mesh
+	const std::vector<bool> isUsed = p_mesh->getUsedNodes();
+
+	linearSystemCSRIterative<double> system(linearSystemCSRIterative<double>::CG, linearSystemCSRIterative<double>::IC0);
+	dofManager<double> dofs(&system);
+
+	constraints.apply(dofs, isUsed);
+
+	const int numberOfEquations = dofs.sizeOfR();
+
+	if(numberOfEquations == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("All of the nodes of the mesh have a fixed potential. There is nothing to solve");
+		return false;
+	}
+
+	// Symbolic pass. This is done once for all of the time steps
+	coloredAssembly assembly(p_mesh, p_batchSize);
+	std::vector<elementKernel> kernels, massKernels;
+
+	assembly.createPattern(dofs, constraints);
+
+	for(auto blockIterator = blocks.begin(); blockIterator != blocks.end(); blockIterator++)
+	{
+		kernels.push_back(elementKernel(blockIterator->type, axisymmetric));
+		massKernels.push_back(elementKernel(blockIterator->type, axisymmetric, true));
+	}
+
+	dofs.finalizePattern();
+
+	std::vector<int> nodeEquation(numberOfNodes, -1);
+	std::vector<double> nodeSign(numberOfNodes, 1.0);
+	std::vector<double> fixedAmplitude(numberOfNodes, 0.0);
+	std::vector<int> fixedNodes;
+
+	for(int i = 0; i < numberOfNodes; i++)
+	{
+		if(!isUsed[i])
+			continue;
+
+		const int root = constraints.findRoot(i, nodeSign[i]);
+
+		if(constraints.isFixed(i))
+		{
+			dofs.getDofValue(Dof(i, 0), fixedAmplitude[i]);
+			fixedNodes.push_back(i);
+		}
+		else
+			nodeEquation[i] = dofs.getDofNumber(Dof(root, 0));
+	}
+
+	double patternTime = TimeOfDay();
+
+	// The time stepping. The run starts demagnetized with all of the sources at zero
+	const double period = 1.0 / frequency;
+	const double endTime = numberOfPeriods * period;
+	const double largestStep = period / stepsPerPeriod;
+	const double smallestStep = 1e-6 * largestStep;
+	const double newtonTolerance = std::max(100.0 * precision, 1e-10);
+	std::vector<double> solution(numberOfNodes, 0.0);
+	std::vector<double> previousSolution(numberOfNodes, 0.0);
+	std::vector<double> olderSolution(numberOfNodes, 0.0);
+	std::vector<double> predictor(numberOfNodes, 0.0);
+	std::vector<double> currentValues(numberOfEquations, 0.0);
+	std::vector<double> previousValues(numberOfEquations, 0.0);
+	double time = 0;
+	double step = largestStep;
+	double previousStep = 0;
+	double residualScale = 0;
+	double hysteresisEnergy = 0;
+	double eddyCurrentEnergy = 0;
+	double assemblyTime = 0;
+	double modelTime = 0;
+	double solverTime = 0;
+	int numberOfAssemblies = 0;
+	int numberOfFactorizations = 0;
+	int numberOfLinearIterations = 0;
+	int numberOfNewtonIterations = 0;
+	int factorizationIterations = 0;
+	int lastIterations = 0;
+	int numberOfSteps = 0;
+	bool failed = false;
+	double outputTime = 0;
+	pvdWriter collection(p_seriesPath + ".pvd");
+
+	p_times.push_back(0);
+	p_hysteresisEnergy.push_back(0);
+	p_eddyCurrentEnergy.push_back(0);
+
+	if(!p_seriesPath.empty())
+	{
+		double outputStartTime = TimeOfDay();
+
+		writeStep(collection, previousSolution, axisymmetric);
+		outputTime += TimeOfDay() - outputStartTime;
+	}
+
+	while(time < endTime * (1 - 1e-12) && numberOfSteps < p_maximumTimeSteps)
+	{
+		// The last two steps share what is left so that the run does not end with a sliver of a step
+		if(step >= endTime - time)
+			step = endTime - time;
+		else if(2 * step > endTime - time)
+			step = 0.5 * (endTime - time);
+
+		const double nextTime = time + step;
+		const double waveform = sin(2 * M_PI * frequency * nextTime);
+		const double inverseStep = 1.0 / step;
+
+		OmniFEMMsg::instance()->MsgStatus("Time step " + std::to_string(numberOfSteps + 1) + ": t = " + std::to_string(nextTime) + " s");
+
+		for(auto nodeIterator = fixedNodes.begin(); nodeIterator != fixedNodes.end(); nodeIterator++)
+		{
+			dofs.fixDof(Dof(*nodeIterator, 0), waveform * fixedAmplitude[*nodeIterator]);
+			solution[*nodeIterator] = waveform * fixedAmplitude[*nodeIterator];
+		}
+
+		/* The initial guess and the predictor of the error estimate extrapolate the last two steps. The first step starts from the
+		 * last solution
+		 */
+		system.zeroSolution();
+
+		for(int i = 0; i < numberOfNodes; i++)
+		{
+			if(nodeEquation[i] == -1)
+				continue;
+
+			predictor[i] = previousSolution[i];
+
+			if(previousStep > 0)
+				predictor[i] += (step / previousStep) * (previousSolution[i] - olderSolution[i]);
+
+			solution[i] = predictor[i];
+		}
+
+		for(int i = 0; i < numberOfNodes; i++)
+		{
+			if(nodeEquation[i] != -1)
+				currentValues[nodeEquation[i]] = nodeSign[i] * solution[i];
+		}
+
+		for(int i = 0; i < numberOfEquations; i++)
+			system.addToSolution(i, currentValues[i]);
+
+		double previousResidual = 0;
+		double stepLength = 1;
+		int numberOfReductions = 0;
+		bool converged = false;
+		bool linearFailure = false;
+
+		previousValues = currentValues;
+
+		for(int iteration = 0; iteration < p_maximumNewtonIterations; iteration++)
+		{
+			double iterationStart = TimeOfDay();
+
+			// The hysteresis models are integrated from the state of the last accepted step to the flux density of the current solution
+			if(isNonlinear)
+			{
+				for(unsigned int b = 0; b < blocks.size(); b++)
+					computeTrialFlux(blocks[b], assembly.getBlockStart(b), kernels[b], laws, solution, axisymmetric);
+
+				for(auto modelIterator = p_hysteresisModels.begin(); modelIterator != p_hysteresisModels.end(); modelIterator++)
+				{
+					if(*modelIterator)
+						(*modelIterator)->update();
+				}
+			}
+
+			double modelEnd = TimeOfDay();
+
+			modelTime += modelEnd - iterationStart;
+
+			system.zeroMatrix();
+			system.zeroRightHandSide();
+
+			// Numeric pass
+			assembly.assemble<double>(0, true,
+				[&](const solverMesh::elementBlock &block, int blockIndex, int first, int count, std::vector<double> &buffer, double *matrices, double *vectors)
+				{
+					computeElements(block, assembly.getBlockStart(blockIndex), first, count, kernels[blockIndex], massKernels[blockIndex], laws, solution,
+									previousSolution, inverseStep, waveform, axisymmetric, buffer, matrices, vectors);
+				},
+				[&](const solverMesh::elementBlock &block, int element, int patternIndex, double *matrix, double *vector)
+				{
+					const int n = block.numberOfNodes;
+
+					dofs.assembleElement(patternIndex, fullMatrix<double>(matrix, n, n));
+					dofs.assembleElement(patternIndex, fullVector<double>(vector, n));
+				});
+
+			for(auto currentIterator = conditions.getPointCurrents().begin(); currentIterator != conditions.getPointCurrents().end(); currentIterator++)
+				dofs.assemble(Dof(currentIterator->first, 0), waveform * (p_vacuumPermeability * currentIterator->second));
+
+			double iterationAssembly = TimeOfDay();
+
+			assemblyTime += iterationAssembly - modelEnd;
+			numberOfAssemblies++;
+
+			if(isNonlinear)
+			{
+				/* The predictor can already be close so the residual is measured against the size of the right hand side. The sources
+				 * pass through zero twice per period so the largest right hand side of the run is used
+				 */
+				const double residual = system.normResidual();
+
+				residualScale = std::max(residualScale, system.norm2RightHandSide());
+
+				const double reference = std::max(residualScale, 1e-300);
+
+				if(residual <= newtonTolerance * reference)
+				{
+					converged = true;
+					break;
+				}
+
+				if(iteration > 0 && residual > previousResidual && numberOfReductions < p_maximumStepReductions)
+				{
+					const double startSquared = previousResidual * previousResidual;
+					const double endSquared = residual * residual;
+					double newLength = stepLength * stepLength * startSquared / (endSquared - startSquared + 2.0 * startSquared * stepLength);
+
+					newLength = std::min(std::max(newLength, 0.1 * stepLength), 0.5 * stepLength);
+					numberOfReductions++;
+					system.zeroSolution();
+
+					for(int i = 0; i < numberOfEquations; i++)
+					{
+						currentValues[i] = previousValues[i] + (newLength / stepLength) * (currentValues[i] - previousValues[i]);
+						system.addToSolution(i, currentValues[i]);
+					}
+
+					stepLength = newLength;
+
+					for(int i = 0; i < numberOfNodes; i++)
+					{
+						if(nodeEquation[i] != -1)
+							solution[i] = nodeSign[i] * currentValues[nodeEquation[i]];
+					}
+
+					continue;
+				}
+
+				stepLength = std::min(1.0, 2.0 * stepLength);
+				numberOfReductions = 0;
+				previousResidual = residual;
+				previousValues = currentValues;
+
+				system.setPrec(std::max(precision, 0.01 * residual / reference));
+			}
+			else
+				system.setPrec(precision);
+
+			system.setMaxIterations(std::max(1000, 10 * numberOfEquations));
+			system.setReusePreconditioner(numberOfFactorizations > 0 && lastIterations <= 2 * factorizationIterations + 10);
+
+			bool linearConverged = (system.systemSolve() == 1);
+
+			if(!linearConverged && system.getPreconditionerReused())
+			{
+				numberOfLinearIterations += system.getNumIterations();
+				system.setReusePreconditioner(false);
+				linearConverged = (system.systemSolve() == 1);
+			}
+
+			if(!system.getPreconditionerReused())
+			{
+				numberOfFactorizations++;
+				factorizationIterations = system.getNumIterations();
+			}
+
+			lastIterations = system.getNumIterations();
+			numberOfLinearIterations += lastIterations;
+			numberOfNewtonIterations++;
+			solverTime += TimeOfDay() - iterationAssembly;
+
+			for(int i = 0; i < numberOfEquations; i++)
+				system.getFromSolution(i, currentValues[i]);
+
+			if(isNonlinear && stepLength < 1)
+			{
+				system.zeroSolution();
+
+				for(int i = 0; i < numberOfEquations; i++)
+				{
+					currentValues[i] = previousValues[i] + stepLength * (currentValues[i] - previousValues[i]);
+					system.addToSolution(i, currentValues[i]);
+				}
+			}
+
+			for(int i = 0; i < numberOfNodes; i++)
+			{
+				if(nodeEquation[i] != -1)
+					solution[i] = nodeSign[i] * currentValues[nodeEquation[i]];
+			}
+
+			if(!linearConverged)
+			{
+				linearFailure = true;
+				break;
+			}
+
+			if(!isNonlinear)
+			{
+				converged = true;
+				break;
+			}
+		}
+
+		/* The local error of the backward Euler method is about dt / (dt + the last dt) times the distance between the solution and the
+		 * linear extrapolation of the last two steps. The error is measured against the largest potential
+		 */
+		double error = 0;
+
+		if(converged && previousStep > 0)
+		{
+			double difference = 0;
+			double largest = 0;
+
+			for(int i = 0; i < numberOfNodes; i++)
+			{
+				if(nodeEquation[i] == -1)
+					continue;
+
+				difference = std::max(difference, fabs(solution[i] - predictor[i]));
+				largest = std::max(largest, fabs(solution[i]));
+			}
+
+			for(auto nodeIterator = fixedNodes.begin(); nodeIterator != fixedNodes.end(); nodeIterator++)
+				largest = std::max(largest, fabs(fixedAmplitude[*nodeIterator]));
+
+			error = (largest > 0) ? step / (step + previousStep) * difference / largest : 0;
+		}
+
+		if(!converged || error > tolerance)
+		{
+			p_numberOfRejectedSteps++;
+
+			if(linearFailure || step <= smallestStep)
+			{
+				failed = true;
+				break;
+			}
+
+			step = std::max(smallestStep, converged ? step * std::max(0.2, 0.9 * sqrt(tolerance / error)) : 0.25 * step);
+
+			for(int i = 0; i < numberOfNodes; i++)
+			{
+				if(nodeEquation[i] != -1)
+					solution[i] = previousSolution[i];
+			}
+
+			continue;
+		}
+
+		// The step is accepted. The losses of the step are added and the trial state of the hysteresis models becomes the committed state
+		for(unsigned int m = 0; m < p_hysteresisModels.size(); m++)
+		{
+			if(p_hysteresisModels[m])
+			{
+				hysteresisEnergy += p_hysteresisModels[m]->getWork(p_pointWeights[m].data());
+				p_hysteresisModels[m]->commit();
+			}
+		}
+
+		eddyCurrentEnergy += getEddyCurrentEnergy(laws, solution, previousSolution, step, axisymmetric);
+
+		olderSolution = previousSolution;
+		previousSolution = solution;
+		previousStep = step;
+		time = nextTime;
+		numberOfSteps++;
+
+		p_times.push_back(time);
+		p_hysteresisEnergy.push_back(hysteresisEnergy);
+		p_eddyCurrentEnergy.push_back(eddyCurrentEnergy);
+
+		if(!p_seriesPath.empty())
+		{
+			double outputStartTime = TimeOfDay();
+
+			// A series that can not be written does not stop the solver. The rest of the steps are not written
+			if(!writeStep(collection, solution, axisymmetric))
+			{
+				OmniFEMMsg::instance()->MsgError("Unable to write the time step " + std::to_string(p_times.size() - 1) + " of " + p_seriesPath + ".pvd");
+				p_seriesPath.clear();
+			}
+
+			outputTime += TimeOfDay() - outputStartTime;
+		}
+
+		step = std::min(largestStep, (error > 0) ? step * std::min(2.0, std::max(0.5, 0.9 * sqrt(tolerance / error))) : 2.0 * step);
+	}
+
+	double steppingTime = TimeOfDay();
+
+	// The potential and the flux density of the elements at the last accepted step
+	p_potential.resize(numberOfNodes);
+
+	for(int i = 0; i < numberOfNodes; i++)
+	{
+		if(axisymmetric)
+			p_potential[i] = (x[i] > 0) ? previousSolution[i] / x[i] : 0;
+		else
+			p_potential[i] = previousSolution[i];
+	}
+
+	computeFluxDensity(previousSolution, axisymmetric);
+
+	double totalTime = TimeOfDay();
+	std::ostringstream timing;
+
+	timing << std::fixed << std::setprecision(3);
+	timing << "Mesh: " << meshTime - startTime << " s (" << numberOfNodes << " nodes, " << p_mesh->getNumberOfElements() << " elements)\n";
+	timing << "Materials: " << materialTime - meshTime << " s (" << numberOfHysteresisPoints << " hysteresis points)\n";
+	timing << "Sparsity pattern: " << patternTime - materialTime << " s\n";
+	timing << "Hysteresis model: " << modelTime << " s\n";
+	timing << "Assembly: " << assemblyTime << " s (" << numberOfAssemblies << " assemblies, " << p_mesh->getNumberOfColors() << " colors, " << numberOfThreads << " threads)\n";
+	timing << "Linear solver: " << solverTime << " s (" << numberOfLinearIterations << " iterations, " << numberOfFactorizations << " factorizations)\n";
+	timing << "Time steps: " << numberOfSteps << " accepted, " << p_numberOfRejectedSteps << " rejected, " << numberOfNewtonIterations << " Newton-Raphson iterations\n";
+	timing << "Losses over the last period: hysteresis " << std::scientific << std::setprecision(4) << getHysteresisLoss() << " W, eddy currents "
+		   << getEddyCurrentLoss() << " W" << (axisymmetric ? "" : " per meter of depth") << "\n" << std::fixed << std::setprecision(3);
+	timing << "Flux density: " << totalTime - steppingTime << " s\n";
+
+	if(!p_seriesPath.empty())
+		timing << "Writing the steps: " << outputTime << " s (" << p_seriesPath << ".pvd)\n";
+
+	timing << "Total: " << totalTime - startTime << " s";
+
+	OmniFEMMsg::instance()->MsgInfo(timing.str());
+
+	if(failed)
+		OmniFEMMsg::instance()->MsgError("The time step could not be solved at t = " + std::to_string(time) + " s. The step became too small or the linear solver did not converge");
+	else if(time < endTime * (1 - 1e-12))
+		OmniFEMMsg::instance()->MsgError("The solver stopped after " + std::to_string(p_maximumTimeSteps) + " time steps at t = " + std::to_string(time) + " s");
+	else
+		OmniFEMMsg::instance()->MsgStatus("Solver Finished");
+
+	return !failed && time >= endTime * (1 - 1e-12);
+}
+
+
+
+void transientMagneticSolver::computeFluxDensity(const std::vector<double> &solution, bool axisymmetric)
+{
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+	std::vector<solverMesh::elementBlock> &blocks = *p_mesh->getElementBlocks();
+
+	p_fluxDensityX.resize(p_mesh->getNumberOfElements());
+	p_fluxDensityY.resize(p_mesh->getNumberOfElements());
+
+	for(unsigned int b = 0, blockStart = 0; b < blocks.size(); blockStart += blocks[b].regions.size(), b++)
+	{
+		const solverMesh::elementBlock &block = blocks[b];
+		const int n = block.numberOfNodes;
+		const int numberOfElements = block.regions.size();
+		const elementKernel kernel(block.type, axisymmetric);
+		const double orientation = axisymmetric ? -1.0 : 1.0;
+
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+		{
+			std::vector<double> elementX(n), elementY(n), elementU(n), gradientX(n), gradientY(n);
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+			for(int e = 0; e < numberOfElements; e++)
+			{
+				double area = 0, averageX = 0, averageY = 0;
+
+				for(int i = 0; i < n; i++)
+				{
+					elementX[i] = x[block.nodes[e * n + i]];
+					elementY[i] = y[block.nodes[e * n + i]];
+					elementU[i] = solution[block.nodes[e * n + i]];
+				}
+
+				for(int q = 0; q < kernel.getNumberOfPoints(); q++)
+				{
+					double r;
+					const double jacobianWeight = kernel.mapGradients(q, &elementX[0], &elementY[0], &gradientX[0], &gradientY[0], r);
+					double potentialX = 0, potentialY = 0;
+
+					if(!axisymmetric)
+						r = 1.0;
+
+					for(int i = 0; i < n; i++)
+					{
+						potentialX += elementU[i] * gradientX[i];
+						potentialY += elementU[i] * gradientY[i];
+					}
+
+					area += jacobianWeight;
+					averageX += jacobianWeight * orientation * potentialY / r;
+					averageY -= jacobianWeight * orientation * potentialX / r;
+				}
+
+				p_fluxDensityX[blockStart + e] = averageX / area;
+				p_fluxDensityY[blockStart + e] = averageY / area;
+			}
+		}
+	}
+}
+
+
+
+bool transientMagneticSolver::writeStep(pvdWriter &collection, const std::vector<double> &solution, bool axisymmetric)
+{
+	const int numberOfNodes = p_mesh->getNumberOfNodes();
+	const double *x = p_mesh->getXCoordinates();
+	const std::string filePath = pvdWriter::getStepPath(p_seriesPath, p_times.size() - 1);
+	std::vector<double> potential(numberOfNodes);
+	vtuWriter writer(p_mesh, false, p_isSeriesCompressed);
+
+	// The unknown of the axisymmetric problems is r times the potential
+	for(int i = 0; i < numberOfNodes; i++)
+	{
+		if(axisymmetric)
+			potential[i] = (x[i] > 0) ? solution[i] / x[i] : 0;
+		else
+			potential[i] = solution[i];
+	}
+
+	computeFluxDensity(solution, axisymmetric);
+
+	writer.addPointData("A", potential.data());
+	writer.addCellVector("B", p_fluxDensityX.data(), p_fluxDensityY.data());
+
+	if(!writer.write(filePath))
+		return false;
+
+	return collection.addStep(p_times.back(), filePath);
+}
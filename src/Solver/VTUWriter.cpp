@@ -0,0 +1,681 @@
+#include <Solver/VTUWriter.h>
+
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
+
+const size_t vtuWriter::p_chunkSize;
+
+
+
+vtuWriter::vtuWriter(solverMesh *mesh, bool base64, bool compress)
+{
+	p_mesh = mesh;
+	p_isBase64 = base64;
+	p_isCompressed = compress && canCompress();
+
+	if(compress && !p_isCompressed)
+		OmniFEMMsg::instance()->MsgWarning("Omni-FEM was built without zlib. The VTU file is written without compression");
+}
+
+
+
+bool vtuWriter::canCompress()
+{
+#if defined(HAVE_LIBZ)
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+
+int vtuWriter::getVTKType(int mshType)
+{
+	/* The quadratic elements and the complete triangles have the nodes in the same order in GMSH and in VTK. The higher order
+	 * triangles are the Lagrange triangles of VTK. The higher order quadrilaterals number the edges differently and are left out
+	 */
+	switch(mshType)
+	{
+		case MSH_TRI_3:
+			return 5;
+		case MSH_QUA_4:
+			return 9;
+		case MSH_TRI_6:
+			return 22;
+		case MSH_QUA_8:
+			return 23;
+		case MSH_QUA_9:
+			return 28;
+		case MSH_TRI_10:
+		case MSH_TRI_15:
+		case MSH_TRI_21:
+			return 69;
+		default:
+			return 0;
+	}
+}
+
+
+
+void vtuWriter::addPointData(std::string name, const double *values, int stride)
+{
+	field newField;
+
+	newField.name = name;
+	newField.components.push_back({values, stride});
+	newField.numberOfComponents = 1;
+
+	p_pointData.push_back(newField);
+}
+
+
+
+void vtuWriter::addPointVector(std::string name, const double *valuesX, const double *valuesY, int stride)
+{
+	field newField;
+
+	newField.name = name;
+	newField.components.push_back({valuesX, stride});
+	newField.components.push_back({valuesY, stride});
+	newField.numberOfComponents = 3;
+
+	p_pointData.push_back(newField);
+}
+
+
+
+void vtuWriter::addCellData(std::string name, const double *values, int stride)
+{
+	field newField;
+
+	newField.name = name;
+	newField.components.push_back({values, stride});
+	newField.numberOfComponents = 1;
+
+	p_cellData.push_back(newField);
+}
+
+
+
+void vtuWriter::addCellVector(std::string name, const double *valuesX, const double *valuesY, int stride)
+{
+	field newField;
+
+	newField.name = name;
+	newField.components.push_back({valuesX, stride});
+	newField.components.push_back({valuesY, stride});
+	newField.numberOfComponents = 3;
+
+	p_cellData.push_back(newField);
+}
+
+
+
+void vtuWriter::addPointData(std::string name, const std::vector<std::complex<double>> &values)
+{
+	// The real and the imaginary parts of a complex number are stored one after another
+	const double *parts = reinterpret_cast<const double*>(values.data());
+
+	addPointData(name + "_real", parts, 2);
+	addPointData(name + "_imaginary", parts + 1, 2);
+}
+
+
+
+void vtuWriter::addCellData(std::string name, const std::vector<std::complex<double>> &values)
+{
+	const double *parts = reinterpret_cast<const double*>(values.data());
+
+	addCellData(name + "_real", parts, 2);
+	addCellData(name + "_imaginary", parts + 1, 2);
+}
+
+
+
+void vtuWriter::encodeBase64(const unsigned char *data, size_t size, std::string &output)
+{
+	static const char characters[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	size_t position = output.size();
+
+	output.resize(position + 4 * ((size + 2) / 3));
+
+	char *encoded = &output[position];
+	size_t i = 0;
+
+	for(; i + 2 < size; i += 3)
+	{
+		const unsigned int triple = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+
+		*encoded++ = characters[(triple >> 18) & 0x3F];
+		*encoded++ = characters[(triple >> 12) & 0x3F];
+		*encoded++ = characters[(triple >> 6) & 0x3F];
+		*encoded++ = characters[triple & 0x3F];
+	}
+
+	if(i < size)
+	{
+		const unsigned int triple = (data[i] << 16) | ((i + 1 < size) ? (data[i + 1] << 8) : 0);
+
+		*encoded++ = characters[(triple >> 18) & 0x3F];
+		*encoded++ = characters[(triple >> 12) & 0x3F];
+		*encoded++ = (i + 1 < size) ? characters[(triple >> 6) & 0x3F] : '=';
+		*encoded++ = '=';
+	}
+}
+
+
+
+void vtuWriter::compressArray(dataArray &array)
+{
+#if defined(HAVE_LIBZ)
+	const size_t numberOfBlocks = (array.numberOfValues + p_chunkSize - 1) / p_chunkSize;
+	const size_t blockSize = p_chunkSize * array.valueSize;
+	const size_t lastBlockSize = (array.numberOfValues % p_chunkSize) * array.valueSize;
+
+	array.compressedBlocks.assign(numberOfBlocks, std::string());
+
+	// The fastest level is used. Most of a solution is doubles, which hardly compress any further at the higher levels
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+	{
+		std::vector<char> buffer(blockSize);
+
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic, 1)
+#endif
+		for(long long b = 0; b < (long long)numberOfBlocks; b++)
+		{
+			const size_t first = b * p_chunkSize;
+			const size_t count = std::min(p_chunkSize, array.numberOfValues - first);
+			std::string &block = array.compressedBlocks[b];
+			uLongf compressedSize = compressBound(count * array.valueSize);
+
+			array.fill(first, count, buffer.data());
+			block.resize(compressedSize);
+			compress2(reinterpret_cast<Bytef*>(&block[0]), &compressedSize, reinterpret_cast<const Bytef*>(buffer.data()), count * array.valueSize, Z_BEST_SPEED);
+			block.resize(compressedSize);
+		}
+	}
+
+	array.compressedHeader.clear();
+	array.compressedHeader.push_back(numberOfBlocks);
+	array.compressedHeader.push_back(blockSize);
+	array.compressedHeader.push_back(lastBlockSize);
+
+	for(auto blockIterator = array.compressedBlocks.begin(); blockIterator != array.compressedBlocks.end(); blockIterator++)
+		array.compressedHeader.push_back(blockIterator->size());
+#endif
+}
+
+
+
+uint64_t vtuWriter::getStoredSize(const dataArray &array) const
+{
+	uint64_t headerSize = sizeof(uint64_t);
+	uint64_t dataSize = array.numberOfValues * array.valueSize;
+
+	if(p_isCompressed)
+	{
+		headerSize = array.compressedHeader.size() * sizeof(uint64_t);
+		dataSize = 0;
+
+		for(auto blockIterator = array.compressedBlocks.begin(); blockIterator != array.compressedBlocks.end(); blockIterator++)
+			dataSize += blockIterator->size();
+	}
+
+	// The header and the data are encoded on their own
+	if(p_isBase64)
+		return 4 * ((headerSize + 2) / 3) + 4 * ((dataSize + 2) / 3);
+	else
+		return headerSize + dataSize;
+}
+
+
+
+bool vtuWriter::writeArray(FILE *file, dataArray &array)
+{
+	std::string encoded;
+
+	if(p_isCompressed)
+	{
+		const unsigned char *header = reinterpret_cast<const unsigned char*>(array.compressedHeader.data());
+		const size_t headerSize = array.compressedHeader.size() * sizeof(uint64_t);
+
+		if(!p_isBase64)
+		{
+			fwrite(header, 1, headerSize, file);
+
+			for(auto blockIterator = array.compressedBlocks.begin(); blockIterator != array.compressedBlocks.end(); blockIterator++)
+				fwrite(blockIterator->data(), 1, blockIterator->size(), file);
+		}
+		else
+		{
+			encodeBase64(header, headerSize, encoded);
+			fwrite(encoded.data(), 1, encoded.size(), file);
+
+			// The blocks are encoded as one stream, so the bytes that do not fill a group of 3 are carried over to the next block
+			std::string remainder;
+
+			for(auto blockIterator = array.compressedBlocks.begin(); blockIterator != array.compressedBlocks.end(); blockIterator++)
+			{
+				remainder.append(*blockIterator);
+
+				const size_t encodedSize = remainder.size() - remainder.size() % 3;
+
+				encoded.clear();
+				encodeBase64(reinterpret_cast<const unsigned char*>(remainder.data()), encodedSize, encoded);
+				fwrite(encoded.data(), 1, encoded.size(), file);
+				remainder.erase(0, encodedSize);
+			}
+
+			encoded.clear();
+			encodeBase64(reinterpret_cast<const unsigned char*>(remainder.data()), remainder.size(), encoded);
+			fwrite(encoded.data(), 1, encoded.size(), file);
+		}
+
+		// The compressed blocks are no longer needed
+		std::vector<std::string>().swap(array.compressedBlocks);
+
+		return !ferror(file);
+	}
+
+	const uint64_t numberOfBytes = array.numberOfValues * array.valueSize;
+
+	if(p_isBase64)
+	{
+		encodeBase64(reinterpret_cast<const unsigned char*>(&numberOfBytes), sizeof(uint64_t), encoded);
+		fwrite(encoded.data(), 1, encoded.size(), file);
+	}
+	else
+		fwrite(&numberOfBytes, sizeof(uint64_t), 1, file);
+
+	const size_t numberOfChunks = (array.numberOfValues + p_chunkSize - 1) / p_chunkSize;
+	int numberOfThreads = 1;
+
+#if defined(_OPENMP)
+	numberOfThreads = omp_get_max_threads();
+#endif
+
+	// A few chunks are prepared by the threads at once and then written in order
+	std::vector<std::string> chunks(2 * numberOfThreads);
+
+	for(size_t firstChunk = 0; firstChunk < numberOfChunks; firstChunk += chunks.size())
+	{
+		const int count = std::min(chunks.size(), numberOfChunks - firstChunk);
+
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+		{
+			std::vector<char> buffer;
+
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic, 1)
+#endif
+			for(int c = 0; c < count; c++)
+			{
+				const size_t first = (firstChunk + c) * p_chunkSize;
+				const size_t numberOfValues = std::min(p_chunkSize, array.numberOfValues - first);
+				std::string &chunk = chunks[c];
+
+				chunk.clear();
+
+				if(p_isBase64)
+				{
+					buffer.resize(numberOfValues * array.valueSize);
+					array.fill(first, numberOfValues, buffer.data());
+					encodeBase64(reinterpret_cast<const unsigned char*>(buffer.data()), buffer.size(), chunk);
+				}
+				else
+				{
+					chunk.resize(numberOfValues * array.valueSize);
+					array.fill(first, numberOfValues, &chunk[0]);
+				}
+			}
+		}
+
+		for(int c = 0; c < count; c++)
+			fwrite(chunks[c].data(), 1, chunks[c].size(), file);
+	}
+
+	return !ferror(file);
+}
+
+
+
+vtuWriter::dataArray vtuWriter::getFieldArray(const field &data, size_t numberOfTuples, std::function<size_t(size_t)> tupleMap)
+{
+	dataArray array;
+	const std::vector<fieldComponent> components = data.components;
+	const int numberOfComponents = data.numberOfComponents;
+
+	array.name = data.name;
+	array.type = "Float64";
+	array.valueSize = sizeof(double);
+	array.numberOfComponents = numberOfComponents;
+	array.numberOfValues = numberOfTuples * numberOfComponents;
+	array.fill = [=](size_t first, size_t count, char *buffer)
+	{
+		double *values = reinterpret_cast<double*>(buffer);
+
+		for(size_t i = 0; i < count; i++)
+		{
+			const size_t tuple = tupleMap((first + i) / numberOfComponents);
+			const size_t component = (first + i) % numberOfComponents;
+
+			if(component < components.size())
+				values[i] = components[component].values[tuple * components[component].stride];
+			else
+				values[i] = 0;
+		}
+	};
+
+	return array;
+}
+
+
+
+bool vtuWriter::write(std::string filePath)
+{
+	// A run of elements of one block that is written
+	struct cellSegment
+	{
+		// The block of the solver mesh
+		const solverMesh::elementBlock *block;
+
+		// The VTK type of the elements
+		unsigned char type;
+
+		// The index of the first element of the block among all of the elements of the solver mesh
+		size_t firstElement;
+
+		// The index of the first cell of the block in the file
+		size_t firstCell;
+
+		// The position of the first node of the block in the connectivity of the file
+		size_t firstConnectivity;
+	};
+
+	std::vector<solverMesh::elementBlock> &blocks = *p_mesh->getElementBlocks();
+	std::vector<cellSegment> segments;
+	size_t numberOfElements = 0, numberOfCells = 0, numberOfConnectivity = 0;
+
+	for(auto blockIterator = blocks.begin(); blockIterator != blocks.end(); blockIterator++)
+	{
+		const size_t blockElements = blockIterator->regions.size();
+		const int type = getVTKType(blockIterator->type);
+
+		if(type == 0)
+		{
+			OmniFEMMsg::instance()->MsgWarning("The elements of GMSH type " + std::to_string(blockIterator->type) + " can not be written to a VTU file and are left out");
+		}
+		else if(blockElements > 0)
+		{
+			segments.push_back({&(*blockIterator), (unsigned char)type, numberOfElements, numberOfCells, numberOfConnectivity});
+			numberOfCells += blockElements;
+			numberOfConnectivity += blockIterator->nodes.size();
+		}
+
+		numberOfElements += blockElements;
+	}
+
+	// Finds the segment that holds a cell or a position in the connectivity
+	auto findCellSegment = [segments](size_t cell) -> const cellSegment&
+	{
+		size_t s = segments.size() - 1;
+
+		while(s > 0 && segments[s].firstCell > cell)
+			s--;
+
+		return segments[s];
+	};
+
+	auto findConnectivitySegment = [segments](size_t position) -> const cellSegment&
+	{
+		size_t s = segments.size() - 1;
+
+		while(s > 0 && segments[s].firstConnectivity > position)
+			s--;
+
+		return segments[s];
+	};
+
+	const size_t numberOfNodes = p_mesh->getNumberOfNodes();
+	const double *x = p_mesh->getXCoordinates();
+	const double *y = p_mesh->getYCoordinates();
+	std::vector<dataArray> pointArrays, cellArrays, pointsArray, cellsArrays;
+
+	for(auto fieldIterator = p_pointData.begin(); fieldIterator != p_pointData.end(); fieldIterator++)
+		pointArrays.push_back(getFieldArray(*fieldIterator, numberOfNodes, [](size_t tuple){ return tuple; }));
+
+	dataArray regionArray;
+
+	regionArray.name = "region";
+	regionArray.type = "Int32";
+	regionArray.valueSize = sizeof(int32_t);
+	regionArray.numberOfComponents = 1;
+	regionArray.numberOfValues = numberOfCells;
+	regionArray.fill = [=](size_t first, size_t count, char *buffer)
+	{
+		int32_t *values = reinterpret_cast<int32_t*>(buffer);
+
+		for(size_t i = 0; i < count; i++)
+		{
+			const cellSegment &segment = findCellSegment(first + i);
+
+			values[i] = segment.block->regions[first + i - segment.firstCell];
+		}
+	};
+
+	cellArrays.push_back(regionArray);
+
+	for(auto fieldIterator = p_cellData.begin(); fieldIterator != p_cellData.end(); fieldIterator++)
+	{
+		cellArrays.push_back(getFieldArray(*fieldIterator, numberOfCells, [=](size_t cell)
+		{
+			const cellSegment &segment = findCellSegment(cell);
+
+			return segment.firstElement + cell - segment.firstCell;
+		}));
+	}
+
+	dataArray coordinateArray;
+
+	coordinateArray.type = "Float64";
+	coordinateArray.valueSize = sizeof(double);
+	coordinateArray.numberOfComponents = 3;
+	coordinateArray.numberOfValues = 3 * numberOfNodes;
+	coordinateArray.fill = [=](size_t first, size_t count, char *buffer)
+	{
+		double *values = reinterpret_cast<double*>(buffer);
+
+		for(size_t i = 0; i < count; i++)
+		{
+			const size_t node = (first + i) / 3;
+
+			switch((first + i) % 3)
+			{
+				case 0:
+					values[i] = x[node];
+					break;
+				case 1:
+					values[i] = y[node];
+					break;
+				default:
+					values[i] = 0;
+			}
+		}
+	};
+
+	pointsArray.push_back(coordinateArray);
+
+	// The nodes of the elements are copied straight out of the blocks
+	dataArray connectivityArray;
+
+	connectivityArray.name = "connectivity";
+	connectivityArray.type = "Int32";
+	connectivityArray.valueSize = sizeof(int32_t);
+	connectivityArray.numberOfComponents = 1;
+	connectivityArray.numberOfValues = numberOfConnectivity;
+	connectivityArray.fill = [=](size_t first, size_t count, char *buffer)
+	{
+		int32_t *values = reinterpret_cast<int32_t*>(buffer);
+
+		while(count > 0)
+		{
+			const cellSegment &segment = findConnectivitySegment(first);
+			const size_t start = first - segment.firstConnectivity;
+			const size_t length = std::min(count, segment.block->nodes.size() - start);
+
+			std::copy(segment.block->nodes.begin() + start, segment.block->nodes.begin() + start + length, values);
+			values += length;
+			first += length;
+			count -= length;
+		}
+	};
+
+	cellsArrays.push_back(connectivityArray);
+
+	// The offsets are where the nodes of each element end in the connectivity
+	dataArray offsetArray;
+
+	offsetArray.name = "offsets";
+	offsetArray.type = "Int64";
+	offsetArray.valueSize = sizeof(int64_t);
+	offsetArray.numberOfComponents = 1;
+	offsetArray.numberOfValues = numberOfCells;
+	offsetArray.fill = [=](size_t first, size_t count, char *buffer)
+	{
+		int64_t *values = reinterpret_cast<int64_t*>(buffer);
+
+		for(size_t i = 0; i < count; i++)
+		{
+			const cellSegment &segment = findCellSegment(first + i);
+
+			values[i] = segment.firstConnectivity + (first + i - segment.firstCell + 1) * segment.block->numberOfNodes;
+		}
+	};
+
+	cellsArrays.push_back(offsetArray);
+
+	dataArray typeArray;
+
+	typeArray.name = "types";
+	typeArray.type = "UInt8";
+	typeArray.valueSize = sizeof(uint8_t);
+	typeArray.numberOfComponents = 1;
+	typeArray.numberOfValues = numberOfCells;
+	typeArray.fill = [=](size_t first, size_t count, char *buffer)
+	{
+		for(size_t i = 0; i < count; i++)
+			buffer[i] = findCellSegment(first + i).type;
+	};
+
+	cellsArrays.push_back(typeArray);
+
+	if(numberOfCells == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("The mesh does not have any elements that can be written to " + filePath);
+		return false;
+	}
+
+	FILE *file = fopen(filePath.c_str(), "wb");
+
+	if(!file)
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to write " + filePath);
+		return false;
+	}
+
+	// The size of the compressed arrays is needed for the offsets in the header of the file
+	std::vector<std::vector<dataArray>*> sections = {&pointArrays, &cellArrays, &pointsArray, &cellsArrays};
+	uint64_t offset = 0;
+
+	for(auto sectionIterator = sections.begin(); sectionIterator != sections.end(); sectionIterator++)
+	{
+		for(auto arrayIterator = (*sectionIterator)->begin(); arrayIterator != (*sectionIterator)->end(); arrayIterator++)
+		{
+			if(p_isCompressed)
+				compressArray(*arrayIterator);
+
+			arrayIterator->offset = offset;
+			offset += getStoredSize(*arrayIterator);
+		}
+	}
+
+	const uint32_t byteOrderTest = 1;
+	const bool isLittleEndian = (*reinterpret_cast<const unsigned char*>(&byteOrderTest) == 1);
+	std::ostringstream header;
+
+	auto writeArrayHeaders = [&header](const std::vector<dataArray> &arrays)
+	{
+		for(auto arrayIterator = arrays.begin(); arrayIterator != arrays.end(); arrayIterator++)
+		{
+			header << "        <DataArray type=\"" << arrayIterator->type << "\"";
+
+			if(!arrayIterator->name.empty())
+				header << " Name=\"" << arrayIterator->name << "\"";
+
+			header << " NumberOfComponents=\"" << arrayIterator->numberOfComponents << "\" format=\"appended\" offset=\"" << arrayIterator->offset << "\"/>\n";
+		}
+	};
+
+	header << "<?xml version=\"1.0\"?>\n";
+	header << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"" << (isLittleEndian ? "LittleEndian" : "BigEndian") << "\" header_type=\"UInt64\"";
+
+	if(p_isCompressed)
+		header << " compressor=\"vtkZLibDataCompressor\"";
+
+	header << ">\n";
+	header << "  <UnstructuredGrid>\n";
+	header << "    <Piece NumberOfPoints=\"" << numberOfNodes << "\" NumberOfCells=\"" << numberOfCells << "\">\n";
+	header << "      <PointData>\n";
+	writeArrayHeaders(pointArrays);
+	header << "      </PointData>\n";
+	header << "      <CellData>\n";
+	writeArrayHeaders(cellArrays);
+	header << "      </CellData>\n";
+	header << "      <Points>\n";
+	writeArrayHeaders(pointsArray);
+	header << "      </Points>\n";
+	header << "      <Cells>\n";
+	writeArrayHeaders(cellsArrays);
+	header << "      </Cells>\n";
+	header << "    </Piece>\n";
+	header << "  </UnstructuredGrid>\n";
+	header << "  <AppendedData encoding=\"" << (p_isBase64 ? "base64" : "raw") << "\">\n";
+	header << "   _";
+
+	const std::string headerText = header.str();
+	bool isWritten = (fwrite(headerText.data(), 1, headerText.size(), file) == headerText.size());
+
+	for(auto sectionIterator = sections.begin(); sectionIterator != sections.end() && isWritten; sectionIterator++)
+	{
+		for(auto arrayIterator = (*sectionIterator)->begin(); arrayIterator != (*sectionIterator)->end() && isWritten; arrayIterator++)
+			isWritten = writeArray(file, *arrayIterator);
+	}
+
+	fprintf(file, "\n  </AppendedData>\n</VTKFile>\n");
+
+	isWritten = !ferror(file) && isWritten;
+
+	if(fclose(file) != 0)
+		isWritten = false;
+
+	if(!isWritten)
+		OmniFEMMsg::instance()->MsgError("Unable to write " + filePath);
+
+	return isWritten;
+}
@@ -1,16 +1,24 @@
 #include <UI/GeometryEditor2D.h>
 #include <string>
+#include <algorithm>
 
 
 bool geometryEditor2D::addNode(double xPoint, double yPoint, double distanceNode)// Could distance be the 1/mag which is the zoom factor
 {
     /* This function was ported from the BOOL CFemmeDoc::AddNode(double x, double y, double d) located in FemmeDoc.cpp */
 	node newNode;
+    std::vector<node*> nearbyNodes;
+    std::vector<blockLabel*> nearbyLabels;
+    std::vector<edgeLineShape*> nearbyLines;
+    std::vector<arcShape*> nearbyArcs;
+    
+    ensureSpatialIndex();
     
     /* This section will make sure that two nodes are not drawn on top of each other */
-	for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
+    p_nodeGrid.query(xPoint, yPoint, distanceNode, nearbyNodes);
+	for(std::vector<node*>::iterator nodeIterator = nearbyNodes.begin(); nodeIterator != nearbyNodes.end(); ++nodeIterator)
 	{
-		if(nodeIterator->getDistance(xPoint, yPoint) < distanceNode)// This will compare against 1/mag where mag is the scaling function for zooming. However, it is currently being hardcoded to 0.01
+		if((*nodeIterator)->getDistance(xPoint, yPoint) < distanceNode)// This will compare against 1/mag where mag is the scaling function for zooming. However, it is currently being hardcoded to 0.01
         {
             /*
              * Bug Fix:
@@ -31,9 +39,10 @@ bool geometryEditor2D::addNode(double xPoint, double yPoint, double distanceNode
 	}
     
     /* This section will make sure that a node is not drawn on top of a block label */
-	for(plf::colony<blockLabel>::iterator blockIterator = _blockLabelList.begin(); blockIterator != _blockLabelList.end(); ++blockIterator)
+    p_blockLabelGrid.query(xPoint, yPoint, distanceNode, nearbyLabels);
+	for(std::vector<blockLabel*>::iterator blockIterator = nearbyLabels.begin(); blockIterator != nearbyLabels.end(); ++blockIterator)
 	{
-		if(blockIterator->getDistance(xPoint, yPoint) < distanceNode)
+		if((*blockIterator)->getDistance(xPoint, yPoint) < distanceNode)
 		{
             _lastNodeAdded = _nodeList.begin();
             return false;
@@ -43,64 +52,25 @@ bool geometryEditor2D::addNode(double xPoint, double yPoint, double distanceNode
     newNode.setCenter(xPoint, yPoint);
 	newNode.setNodeID(++_nodeNumber);
 	_lastNodeAdded = _nodeList.insert(newNode);
+    indexNode(*_lastNodeAdded);
     
     /* If the node is in between a line, then break the line into 2 lines */
-	for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)
+    p_lineGrid.query(xPoint, yPoint, distanceNode, nearbyLines);
+	for(std::vector<edgeLineShape*>::iterator lineIterator = nearbyLines.begin(); lineIterator != nearbyLines.end(); ++lineIterator)
 	{
-		if((fabs(calculateShortestDistance(newNode, *lineIterator)) < distanceNode) && (newNode != *lineIterator->getFirstNode() && newNode != *lineIterator->getSecondNode()))
-		{
-            /* If the node is on the line (determined by the calculateShortestDistance function) a new line will be created (This will be called line 1)
-             * Line1 will be set equal to the original line (line0).
-             * For the sake of explanation, the left most node will be considered as node 1 and the right most node will be considered node 2.
-             * So, node 2 of line1 will then be switched to the newly created node and the first node of line0 will be set to the new node 
-             * also. This effectively breaks the line into 2 shorter lines
-             */ 
-            edgeLineShape edgeLine = *lineIterator;
-            lineIterator->setSecondNode(*_lastNodeAdded);// This will set the recently created node to be the second node of the shortend line
-			lineIterator->calculateDistance();
-			
-            edgeLine.setFirstNode(*_lastNodeAdded);// This will set the recently created node to be the first node of the new line
-			edgeLine.calculateDistance();
-			_lastLineAdded = _lineList.insert(edgeLine);// Add the new line to the array
-            continue;
-		}
+		if((fabs(calculateShortestDistance(newNode, **lineIterator)) < distanceNode) && (newNode != *(*lineIterator)->getFirstNode() && newNode != *(*lineIterator)->getSecondNode()))
+            splitLineAtNode(**lineIterator, *_lastNodeAdded);
 	} 
     
     /* If the node is in between an arc, then break the arc into 2 */
-	for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+    p_arcGrid.query(xPoint, yPoint, distanceNode, nearbyArcs);
+	for(std::vector<arcShape*>::iterator arcIterator = nearbyArcs.begin(); arcIterator != nearbyArcs.end(); ++arcIterator)
 	{
         Vector nodeVector;
         nodeVector.Set(xPoint, yPoint);
         /* Pretty much, this portion of the code is doing the exact same thing as the code above but instead of straight lines, we are working with arcs */
-		if((fabs(shortestDistanceFromArc(nodeVector, *arcIterator)) < distanceNode) && (newNode != *arcIterator->getFirstNode() && newNode != *arcIterator->getSecondNode())) // this needs t be looked into more
-		{
-            Vector firstNode, secondNode, thirdNode, center;
-            arcShape arcSegment = *arcIterator;
-            double radius;
-            
-            firstNode.Set(arcIterator->getFirstNode()->getCenterXCoordinate(), arcIterator->getFirstNode()->getCenterYCoordinate());
-			secondNode.Set(arcIterator->getSecondNode()->getCenterXCoordinate(), arcIterator->getSecondNode()->getCenterYCoordinate());
-			thirdNode.Set(xPoint, yPoint);
-			
-            center.Set(arcIterator->getCenterXCoordinate(), arcIterator->getCenterYCoordinate());
-            radius = arcIterator->getRadius();
-			
-            arcIterator->setSecondNode(*_lastNodeAdded);
-            
-            double angle = Varg((thirdNode - center) / (firstNode - center)) * (180.0 / PI);
-			arcIterator->setArcAngle(angle);
-            arcIterator->calculate();
-			
-            arcSegment.setFirstNode(*_lastNodeAdded);
-            angle = Varg((secondNode - center) / (thirdNode - center)) * (180.0 / PI);
-			arcSegment.setArcAngle(angle);
-            arcSegment.setNumSegments(20);
-			arcSegment.calculate();
-			arcSegment.setArcID(++p_arcNumber);
-            
-            _lastArcAdded = _arcList.insert(arcSegment);
-            break;
-		}
+		if((fabs(shortestDistanceFromArc(nodeVector, **arcIterator)) < distanceNode) && (newNode != *(*arcIterator)->getFirstNode() && newNode != *(*arcIterator)->getSecondNode())) // this needs t be looked into more
+            splitArcAtNode(**arcIterator, *_lastNodeAdded);
 	}
     
     return true;
@@ -113,11 +83,22 @@ bool geometryEditor2D::addBlockLabel(double xPoint, double yPoint, double tolera
     /* This code was adapted from the FEMM project. THe code came from FemmeDoc.cpp line 576 */
     blockLabel newLabel;
     Vector blockVector = Vector(xPoint, yPoint);
+    std::vector<blockLabel*> nearbyLabels;
+    std::vector<node*> nearbyNodes;
+    std::vector<edgeLineShape*> nearbyLines;
+    std::vector<arcShape*> nearbyArcs;
+    
+    /* The center needs to be set before the distance to the lines is checked */
+    newLabel.setCenterXCoordinate(xPoint);
+    newLabel.setCenterYCoordiante(yPoint);
+    
+    ensureSpatialIndex();
     
     // Make sure that teh block labe is not placed ontop of an existing block label
-    for(plf::colony<blockLabel>::iterator blockIterator = _blockLabelList.begin(); blockIterator != _blockLabelList.end(); ++blockIterator)
+    p_blockLabelGrid.query(xPoint, yPoint, tolerance, nearbyLabels);
+    for(std::vector<blockLabel*>::iterator blockIterator = nearbyLabels.begin(); blockIterator != nearbyLabels.end(); ++blockIterator)
     {
-        if(blockIterator->getDistance(xPoint, yPoint) < tolerance)
+        if((*blockIterator)->getDistance(xPoint, yPoint) < tolerance)
         {
             _lastBlockLabelAdded = _blockLabelList.begin();
             return false;
@@ -125,10 +106,11 @@ bool geometryEditor2D::addBlockLabel(double xPoint, double yPoint, double tolera
     }
     
     // MAke sure that the block label is not placed on top of an existing node
-    for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
+    p_nodeGrid.query(xPoint, yPoint, tolerance, nearbyNodes);
+    for(std::vector<node*>::iterator nodeIterator = nearbyNodes.begin(); nodeIterator != nearbyNodes.end(); ++nodeIterator)
 	{
         // The program FEMM would start the zoom factor at 100. We are starting at 1. The process by which FEMM creates the nodes is very good. Therefor, we multiply our results by 100
-		if(nodeIterator->getDistance(xPoint, yPoint) < tolerance)// This will compare against 1/mag where mag is the scaling function for zooming. However, it is currently being hardcoded to 0.01
+		if((*nodeIterator)->getDistance(xPoint, yPoint) < tolerance)// This will compare against 1/mag where mag is the scaling function for zooming. However, it is currently being hardcoded to 0.01
 		{
             _lastBlockLabelAdded = _blockLabelList.begin();
             return false;
@@ -136,10 +118,10 @@ bool geometryEditor2D::addBlockLabel(double xPoint, double yPoint, double tolera
 	}
     
     // Make sure that the block label is not placed ontop of a line
-    for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)
+    p_lineGrid.query(xPoint, yPoint, tolerance, nearbyLines);
+    for(std::vector<edgeLineShape*>::iterator lineIterator = nearbyLines.begin(); lineIterator != nearbyLines.end(); ++lineIterator)
 	{
-		double temp = calculateShortestDistance(newLabel, *lineIterator);
-		if(fabs(calculateShortestDistance(newLabel, *lineIterator)) < tolerance)
+		if(fabs(calculateShortestDistance(newLabel, **lineIterator)) < tolerance)
         {
             _lastBlockLabelAdded = _blockLabelList.begin();
             return false;
@@ -147,20 +129,18 @@ bool geometryEditor2D::addBlockLabel(double xPoint, double yPoint, double tolera
     }
     
     // Make sure that the label is not placed ontop of an arc. If it is, don't bother creating the label
-    for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+    p_arcGrid.query(xPoint, yPoint, tolerance, nearbyArcs);
+    for(std::vector<arcShape*>::iterator arcIterator = nearbyArcs.begin(); arcIterator != nearbyArcs.end(); ++arcIterator)
     {
-        if(fabs(shortestDistanceFromArc(blockVector, *arcIterator)) < tolerance)
+        if(fabs(shortestDistanceFromArc(blockVector, **arcIterator)) < tolerance)
         {
             _lastBlockLabelAdded = _blockLabelList.begin();
             return false;
         }
     }
             
-    /* Later, add in check to make sure that a block node will not be placed on top of a arc */
-    newLabel.setCenterXCoordinate(xPoint);
-    newLabel.setCenterYCoordiante(yPoint);
-   
     _lastBlockLabelAdded = _blockLabelList.insert(newLabel);
+    indexBlockLabel(*_lastBlockLabelAdded);
 
     return true;
 }
@@ -172,6 +152,9 @@ bool geometryEditor2D::addLine(node *firstNode, node *secondNode, double toleran
     /* This code was adapted from the FEMM project. See line 263 in FemmeDoc.cpp */
     edgeLineShape newLine;
     double tempTolerance;
+    std::vector<edgeLineShape*> nearbyLines;
+    std::vector<arcShape*> nearbyArcs;
+    std::vector<node*> nearbyNodes;
     node *tempNodeOne;// temp node is either the index stored in the class or the nodes that were passed to the function.
     node *tempNodeTwo;// These will serve as a temporary variable in order to not effect the values of hte one global to the class
 
@@ -200,10 +183,14 @@ bool geometryEditor2D::addLine(node *firstNode, node *secondNode, double toleran
         
 	
 /* Check to see if the line has already been created */	
-
-	for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)
+    
+    ensureSpatialIndex();
+    
+    /* Any line that shares both endpoints with the new line will be found within the box around the first endpoint */
+    p_lineGrid.query(tempNodeOne->getCenterXCoordinate(), tempNodeOne->getCenterYCoordinate(), 0, nearbyLines);
+	for(std::vector<edgeLineShape*>::iterator lineIterator = nearbyLines.begin(); lineIterator != nearbyLines.end(); ++lineIterator)
 	{
-		if((*lineIterator->getFirstNode() == *tempNodeOne && *lineIterator->getSecondNode() == *tempNodeTwo) || (*lineIterator->getFirstNode() == *tempNodeTwo && *lineIterator->getSecondNode() == *tempNodeOne))
+		if((*(*lineIterator)->getFirstNode() == *tempNodeOne && *(*lineIterator)->getSecondNode() == *tempNodeTwo) || (*(*lineIterator)->getFirstNode() == *tempNodeTwo && *(*lineIterator)->getSecondNode() == *tempNodeOne))
         {
             resetIndexs();
             return false;
@@ -214,46 +201,25 @@ bool geometryEditor2D::addLine(node *firstNode, node *secondNode, double toleran
     newLine.setSecondNode(*tempNodeTwo);
     
     if(tolerance == 0)
-    {
-        if(_nodeList.size() < 2)
-            tempTolerance = 1.0e-08;
-        else
-        {
-            Vector tempVecOne, tempVecTwo;
-            tempVecOne.Set(_nodeList.begin()->getCenterXCoordinate(), _nodeList.begin()->getCenterYCoordinate());
-            tempVecTwo = tempVecOne;
-            for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
-            {
-                if(nodeIterator->getCenterXCoordinate() < tempVecOne.getXComponent())
-                    tempVecOne.Set(nodeIterator->getCenterXCoordinate(), tempVecOne.getYComponent());
-                    
-                if(nodeIterator->getCenterXCoordinate() > tempVecTwo.getXComponent())
-                    tempVecTwo.Set(nodeIterator->getCenterXCoordinate(), tempVecTwo.getYComponent());
-                
-                if(nodeIterator->getCenterYCoordinate() < tempVecOne.getYComponent())
-                    tempVecOne.Set(tempVecOne.getXComponent(), nodeIterator->getCenterYCoordinate());
-                    
-                if(nodeIterator->getCenterYCoordinate() > tempVecTwo.getYComponent())
-                    tempVecTwo.Set(tempVecTwo.getXComponent(), nodeIterator->getCenterYCoordinate());
-            }
-            
-            tempTolerance = Vabs(tempVecTwo - tempVecOne) * 1.0e-06;
-        }
-    }
+        tempTolerance = getDefaultTolerance();
     else
         tempTolerance = tolerance;
     
     /* This section will check to see if there are any intersections with other segments. If so, create a node at the intersection */
-    for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)
+    nearbyLines.clear();
+    p_lineGrid.query(getBoundingBox(newLine), nearbyLines);
+    for(std::vector<edgeLineShape*>::iterator lineIterator = nearbyLines.begin(); lineIterator != nearbyLines.end(); ++lineIterator)
     {
         double tempX, tempY;
-        if(getIntersection(newLine, *lineIterator, tempX, tempY) && !lineIterator->getSegmentProperty()->getHiddenState())
+        if(getIntersection(newLine, **lineIterator, tempX, tempY) && !(*lineIterator)->getSegmentProperty()->getHiddenState())
             addNode(tempX, tempY, tempTolerance);
     }
     
     /* This section will check to see if there are any intersections with arcs. If so, create a node at the intersection */
-    for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+    p_arcGrid.query(getBoundingBox(newLine), nearbyArcs);
+    for(std::vector<arcShape*>::iterator arcPointer = nearbyArcs.begin(); arcPointer != nearbyArcs.end(); ++arcPointer)
     {
+        arcShape *arcIterator = *arcPointer;
         Vector newNodesPoints[2];
         int j = getLineToArcIntersection(newLine, *arcIterator, newNodesPoints);
         if(j > 0 && !arcIterator->getSegmentProperty()->getHiddenState())
@@ -272,6 +238,7 @@ bool geometryEditor2D::addLine(node *firstNode, node *secondNode, double toleran
      */ 
 	newLine.calculateDistance(); // Calculates the distance of the line
     _lastLineAdded = _lineList.insert(newLine);// Add the line to the list
+    indexLine(*_lastLineAdded);
     
     double shortDistance, dmin;
     Vector node0Vec, node1Vec, nodeiVec;
@@ -286,8 +253,14 @@ bool geometryEditor2D::addLine(node *firstNode, node *secondNode, double toleran
     else
         dmin = tolerance;
     
-    for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
+    boundingBox searchBox = getBoundingBox(newLine);
+    searchBox.addPoint(wxRealPoint(searchBox.getMinBounds().x - dmin, searchBox.getMinBounds().y - dmin));
+    searchBox.addPoint(wxRealPoint(searchBox.getMaxBounds().x + dmin, searchBox.getMaxBounds().y + dmin));
+    p_nodeGrid.query(searchBox, nearbyNodes);
+    
+    for(std::vector<node*>::iterator nodePointer = nearbyNodes.begin(); nodePointer != nearbyNodes.end(); ++nodePointer)
     {
+        node *nodeIterator = *nodePointer;
         if((*nodeIterator != *tempNodeOne) && (*nodeIterator != *tempNodeTwo))
         {
             nodeiVec.Set(nodeIterator->getCenterXCoordinate(), nodeIterator->getCenterYCoordinate());
@@ -296,10 +269,11 @@ bool geometryEditor2D::addLine(node *firstNode, node *secondNode, double toleran
                 shortDistance = 2.0 * dmin;
             if(shortDistance < dmin)// This is the case for if the node is in fact ontop of a line
             {
+                p_lineGrid.remove(&(*_lastLineAdded));
                 _lineList.erase(_lastLineAdded);
                 _lastLineAdded = _lineList.begin();// Make sure that the last line added in always pointing to something
-                addLine(tempNodeOne, &(*nodeIterator), dmin);
-                addLine(&(*nodeIterator), tempNodeTwo, dmin);
+                addLine(tempNodeOne, nodeIterator, dmin);
+                addLine(nodeIterator, tempNodeTwo, dmin);
              //   nodeIterator = _nodeList.back();
                 break;
             }
@@ -317,6 +291,9 @@ bool geometryEditor2D::addArc(arcShape &arcSeg, double tolerance, bool nodesAreS
 	Vector intersectingNodes[2];
 	Vector centerPoint;
 	double distanceTolerance, radius, minDistance, shortDistanceFromArc;
+    std::vector<arcShape*> nearbyArcs;
+    std::vector<edgeLineShape*> nearbyLines;
+    std::vector<node*> nearbyNodes;
     
     if((_nodeInterator1 == nullptr || _nodeInterator2 == nullptr) && nodesAreSelected)
     {
@@ -348,9 +325,13 @@ bool geometryEditor2D::addArc(arcShape &arcSeg, double tolerance, bool nodesAreS
         arcSeg.calculate();
     }
 		
-	for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+	ensureSpatialIndex();
+	
+	/* Any arc that has the same endpoints will be found within the box around the first endpoint */
+	p_arcGrid.query(arcSeg.getFirstNode()->getCenterXCoordinate(), arcSeg.getFirstNode()->getCenterYCoordinate(), 0, nearbyArcs);
+	for(std::vector<arcShape*>::iterator arcIterator = nearbyArcs.begin(); arcIterator != nearbyArcs.end(); ++arcIterator)
 	{
-		if((arcIterator->getFirstNode() == arcSeg.getFirstNode()) && (arcIterator->getSecondNode() == arcSeg.getSecondNode()) && (fabs(arcIterator->getArcAngle() - arcSeg.getArcAngle()) < 1.0e-02))
+		if(((*arcIterator)->getFirstNode() == arcSeg.getFirstNode()) && ((*arcIterator)->getSecondNode() == arcSeg.getSecondNode()) && (fabs((*arcIterator)->getArcAngle() - arcSeg.getArcAngle()) < 1.0e-02))
         {
             resetIndexs();
             return false;
@@ -358,41 +339,17 @@ bool geometryEditor2D::addArc(arcShape &arcSeg, double tolerance, bool nodesAreS
 	}
 	
 	if(tolerance == 0)
-	{
-		if(_nodeList.size() < 2)
-			distanceTolerance = 1.0e-08;
-		else
-		{
-			Vector vec1, vec2;
-			vec1.Set(_nodeList.begin()->getCenterXCoordinate(), _nodeList.begin()->getCenterYCoordinate());
-			vec2 = vec1;
-			for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
-			{
-				if(nodeIterator->getCenterXCoordinate() < vec1.getXComponent())
-					vec1.Set(nodeIterator->getCenterXCoordinate(), vec1.getYComponent());
-				
-				if(nodeIterator->getCenterXCoordinate() > vec2.getXComponent())
-					vec2.Set(nodeIterator->getCenterXCoordinate(), vec2.getYComponent());
-				
-				if(nodeIterator->getCenterYCoordinate() < vec1.getYComponent())
-					vec1.Set(vec1.getXComponent(), nodeIterator->getCenterYCoordinate());
-					
-				if(nodeIterator->getCenterYCoordinate() > vec2.getYComponent())
-					vec2.Set(vec2.getXComponent(), nodeIterator->getCenterYCoordinate());
-			}
-			
-			distanceTolerance = Vabs(vec1 - vec2) * 1.0e-06;
-		}
-	}
+		distanceTolerance = getDefaultTolerance();
 	else
 		distanceTolerance = tolerance;
 	
 	/* This section will check for any intesections with lines and arcs and if so, place a node there */
-	for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)// This will check how many times the existing arc intercests the proposed arc.
+	p_lineGrid.query(getBoundingBox(arcSeg), nearbyLines);
+	for(std::vector<edgeLineShape*>::iterator lineIterator = nearbyLines.begin(); lineIterator != nearbyLines.end(); ++lineIterator)// This will check how many times the existing arc intercests the proposed arc.
 	{
-		int j = getLineToArcIntersection(*lineIterator, arcSeg, intersectingNodes); // Place the function for intersecting here This will be for an arc intersecting a line
+		int j = getLineToArcIntersection(**lineIterator, arcSeg, intersectingNodes); // Place the function for intersecting here This will be for an arc intersecting a line
 		
-		if(j > 0 && !lineIterator->getSegmentProperty()->getHiddenState())
+		if(j > 0 && !(*lineIterator)->getSegmentProperty()->getHiddenState())
 		{
 			for(int k = 0; k < j; k++)
 			{
@@ -402,13 +359,15 @@ bool geometryEditor2D::addArc(arcShape &arcSeg, double tolerance, bool nodesAreS
 	}
 	
 	/* This section is for the proposed arc intersecting another arc */
-	for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+	nearbyArcs.clear();
+	p_arcGrid.query(getBoundingBox(arcSeg), nearbyArcs);
+	for(std::vector<arcShape*>::iterator arcIterator = nearbyArcs.begin(); arcIterator != nearbyArcs.end(); ++arcIterator)
 	{
         // THis finds the number of points where intercetion occurs.
         // The point values are stored in the variable intersectiongNodes.
-		int j = getArcToArcIntersection(*arcIterator, arcSeg,  intersectingNodes); // This will be for an arc intersecting an arc
+		int j = getArcToArcIntersection(**arcIterator, arcSeg,  intersectingNodes); // This will be for an arc intersecting an arc
 		
-		if(j > 0 && !arcIterator->getSegmentProperty()->getHiddenState())
+		if(j > 0 && !(*arcIterator)->getSegmentProperty()->getHiddenState())
 		{
 			for(int k = 0; k < j; k++)
 			{
@@ -419,6 +378,7 @@ bool geometryEditor2D::addArc(arcShape &arcSeg, double tolerance, bool nodesAreS
 	
 	arcSeg.setArcID(++p_arcNumber);
 	_lastArcAdded = _arcList.insert(arcSeg);
+	indexArc(*_lastArcAdded);
 	
     centerPoint.Set(arcSeg.getCenterXCoordinate(), arcSeg.getCenterYCoordinate());
     radius = arcSeg.getRadius();
@@ -428,8 +388,14 @@ bool geometryEditor2D::addArc(arcShape &arcSeg, double tolerance, bool nodesAreS
 	else
 		minDistance = tolerance;
 	
-	for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
+	boundingBox searchBox = getBoundingBox(arcSeg);
+	searchBox.addPoint(wxRealPoint(searchBox.getMinBounds().x - minDistance, searchBox.getMinBounds().y - minDistance));
+	searchBox.addPoint(wxRealPoint(searchBox.getMaxBounds().x + minDistance, searchBox.getMaxBounds().y + minDistance));
+	p_nodeGrid.query(searchBox, nearbyNodes);
+	
+	for(std::vector<node*>::iterator nodePointer = nearbyNodes.begin(); nodePointer != nearbyNodes.end(); ++nodePointer)
 	{
+		node *nodeIterator = *nodePointer;
 		if((*nodeIterator != *arcSeg.getFirstNode()) && (*nodeIterator != *arcSeg.getSecondNode()))
 		{
 			shortDistanceFromArc = shortestDistanceFromArc(Vector(nodeIterator->getCenterXCoordinate(), nodeIterator->getCenterYCoordinate()), *_lastArcAdded);
@@ -440,6 +406,7 @@ bool geometryEditor2D::addArc(arcShape &arcSeg, double tolerance, bool nodesAreS
 				vec2.Set(arcSeg.getSecondNode()->getCenterXCoordinate(), arcSeg.getSecondNode()->getCenterYCoordinate());
 				vec3.Set(nodeIterator->getCenterXCoordinate(), nodeIterator->getCenterYCoordinate());
 				
+				p_arcGrid.remove(&(*_lastArcAdded));
 				_arcList.erase(_lastArcAdded);
 				
 				newArc = arcSeg;
@@ -463,108 +430,145 @@ bool geometryEditor2D::addArc(arcShape &arcSeg, double tolerance, bool nodesAreS
 
 
 
+/**
+ * @brief Sorts the list by address and removes the duplicates so that the list can be searched with std::binary_search
+ * @param candidates The list of geometry pieces
+ */
+template<class T>
+static void sortCandidates(std::vector<T*> &candidates)
+{
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+
+
+/**
+ * @brief Grows the box by the distance in every direction
+ * @param box The box that is grown
+ * @param distance The distance to grow the box by
+ * @return Returns the larger box
+ */
+static boundingBox growBox(boundingBox box, double distance)
+{
+    boundingBox grownBox(wxRealPoint(box.getMinBounds().x - distance, box.getMinBounds().y - distance));
+    grownBox.addPoint(wxRealPoint(box.getMaxBounds().x + distance, box.getMaxBounds().y + distance));
+    
+    return grownBox;
+}
+
+
+
 bool geometryEditor2D::checkIntersections(EditGeometry editedGeometry, double tolerance)
 {
     bool labelsViolated = false;
+    std::vector<Vector> intersectionPoints;
+    std::vector<edgeLineShape*> lineCandidates;
+    
+    /* If the geometry was moved through moveNode and moveBlockLabel then the spatial index is up to date and only the
+     * moved geometry needs to be checked. If the index is out of date, something was changed that was not recorded
+     * so all of the geometry is checked. The other modes are used after the properties of a line or arc are changed 
+     * which is not recorded either */
+    bool checkAll = (editedGeometry != EditGeometry::EDIT_ALL) || !spatialIndexIsCurrent() || (p_movedNodes.empty() && p_movedLabels.empty() && p_movedLines.empty() && p_movedArcs.empty());
+    
+    ensureSpatialIndex();
     
     if(editedGeometry == EditGeometry::EDIT_NODES || editedGeometry == EditGeometry::EDIT_ALL)
     {
-        for(plf::colony<node>::iterator nodeIterator1 = _nodeList.begin(); nodeIterator1 != _nodeList.end(); ++nodeIterator1)
+        std::vector<node*> nodeCandidates;
+        
+        if(checkAll)
+        {
+            for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
+                nodeCandidates.push_back(&(*nodeIterator));
+        }
+        else
+        {
+            // A moved line or arc can now be on top of a node that did not move
+            nodeCandidates = p_movedNodes;
+            findNodesNear(p_movedLines, p_movedArcs, tolerance, nodeCandidates);
+            sortCandidates(nodeCandidates);
+        }
+        
+        for(std::vector<node*>::iterator candidateIterator = nodeCandidates.begin(); candidateIterator != nodeCandidates.end(); ++candidateIterator)
         {
+            node *nodeIterator1 = *candidateIterator;
             bool nodeIsConfigured = false;
-            plf::colony<node>::iterator tempNodeIterator = nodeIterator1;
-            /* Iterate through all of the nodes to see if a node is on top of another node and if so, move all of the lines/arcs to one of the nodes */
-            for(plf::colony<node>::iterator nodeIterator2 = ++tempNodeIterator; nodeIterator2 != _nodeList.end(); ++nodeIterator2)
+            std::vector<node*> nearbyNodes;
+            std::vector<edgeLineShape*> nearbyLines;
+            std::vector<arcShape*> nearbyArcs;
+            
+            // The node could have been merged into another node
+            if(!p_nodeGrid.contains(nodeIterator1))
+                continue;
+            
+            /* Check to see if a node is on top of another node and if so, move all of the lines/arcs to this node */
+            p_nodeGrid.query(nodeIterator1->getCenterXCoordinate(), nodeIterator1->getCenterYCoordinate(), 0, nearbyNodes);
+            for(std::vector<node*>::iterator nodePointer = nearbyNodes.begin(); nodePointer != nearbyNodes.end(); ++nodePointer)
             {
-                if(nodeIterator2 == _nodeList.end())
-                    break;
-                   
+                node *nodeIterator2 = *nodePointer;
+                
                 /*  TODO: During mesh testing, determine if this if statment should be the distance between the two nodes.
                     THis will determine if there is a min. distance required before we get convergence issues
                      */ 
-                if(*nodeIterator1 == *nodeIterator2)
+                if(nodeIterator2 != nodeIterator1 && *nodeIterator1 == *nodeIterator2)
                 {
-                    for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)
+                    // Every line/arc that is connected to the node will have a bounding box that contains the node
+                    p_lineGrid.query(nodeIterator2->getCenterXCoordinate(), nodeIterator2->getCenterYCoordinate(), 0, nearbyLines);
+                    for(std::vector<edgeLineShape*>::iterator lineIterator = nearbyLines.begin(); lineIterator != nearbyLines.end(); ++lineIterator)
                     {
-                        if(*lineIterator->getFirstNode() == *nodeIterator2)
-                            lineIterator->setFirstNode(*nodeIterator1);
-                        else if(*lineIterator->getSecondNode() == *nodeIterator2)
-                            lineIterator->setSecondNode(*nodeIterator1);
+                        if((*lineIterator)->getFirstNode() == nodeIterator2)
+                            (*lineIterator)->setFirstNode(*nodeIterator1);
+                        else if((*lineIterator)->getSecondNode() == nodeIterator2)
+                            (*lineIterator)->setSecondNode(*nodeIterator1);
                     }
                     
-                    for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+                    p_arcGrid.query(nodeIterator2->getCenterXCoordinate(), nodeIterator2->getCenterYCoordinate(), 0, nearbyArcs);
+                    for(std::vector<arcShape*>::iterator arcIterator = nearbyArcs.begin(); arcIterator != nearbyArcs.end(); ++arcIterator)
                     {
-                        if(*arcIterator->getFirstNode() == *nodeIterator2)
-                            arcIterator->setFirstNode(*nodeIterator1);
-                        else if(*arcIterator->getSecondNode() == *nodeIterator2)
-                            arcIterator->setSecondNode(*nodeIterator1);
+                        if((*arcIterator)->getFirstNode() == nodeIterator2)
+                            (*arcIterator)->setFirstNode(*nodeIterator1);
+                        else if((*arcIterator)->getSecondNode() == nodeIterator2)
+                            (*arcIterator)->setSecondNode(*nodeIterator1);
                     }
                     
                     if(*_lastNodeAdded == *nodeIterator2)
                         _lastNodeAdded = _nodeList.begin();
                         
-                    _nodeList.erase(nodeIterator2);
-                    nodeIsConfigured = true;// A node being ontop of another node will only happen once and it will not be ontop of a line or an arc
-                    break;
+                    p_nodeGrid.remove(nodeIterator2);
+                    _nodeList.erase(_nodeList.get_iterator_from_pointer(nodeIterator2));
+                    nodeIsConfigured = true;// A node that is ontop of another node will not be ontop of a line or an arc
+                    // Several nodes can be moved onto the same point so all of them are merged here
                 }
             }
             
             // If the node is not ontop of another node, then check to see if the node is on top of a line or arc. If so, break the line/arc into 2
             if(!nodeIsConfigured)
             {
-                for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)
+                Vector nodeVector;
+                nodeVector.Set(nodeIterator1->getCenterXCoordinate(), nodeIterator1->getCenterYCoordinate());
+                
+                p_lineGrid.query(nodeIterator1->getCenterXCoordinate(), nodeIterator1->getCenterYCoordinate(), tolerance, nearbyLines);
+                for(std::vector<edgeLineShape*>::iterator lineIterator = nearbyLines.begin(); lineIterator != nearbyLines.end(); ++lineIterator)
                 {
-                    if((fabs(calculateShortestDistance(*nodeIterator1, *lineIterator)) < tolerance) && (*nodeIterator1 != *lineIterator->getFirstNode() && *nodeIterator1 != *lineIterator->getSecondNode()) && !lineIterator->getSegmentProperty()->getHiddenState())
+                    if((fabs(calculateShortestDistance(*nodeIterator1, **lineIterator)) < tolerance) && (*nodeIterator1 != *(*lineIterator)->getFirstNode() && *nodeIterator1 != *(*lineIterator)->getSecondNode()) && !(*lineIterator)->getSegmentProperty()->getHiddenState())
                     {
-                        /* If the node is on the line (determined by the calculateShortestDistance function) a new line will be created (This will be called line 1)
-                         * Line1 will be set equal to the original line (line0).
-                         * For the sake of explanation, the left most node will be considered as node 1 and the right most node will be considered node 2.
-                         * So, node 2 of line1 will then be switched to the newly created node and the first node of line0 will be set to the new node 
-                         * also. This effectively breaks the line into 2 shorter lines
-                         */ 
-                        edgeLineShape edgeLine = *lineIterator;
-                        lineIterator->setSecondNode(*nodeIterator1);
-                        
-                        edgeLine.setFirstNode(*nodeIterator1);
-                        _lastLineAdded = _lineList.insert(edgeLine);// Add the new line to the array
-                        nodeIsConfigured = true;
+                        splitLineAtNode(**lineIterator, *nodeIterator1);
+                        p_movedLines.push_back(&(*_lastLineAdded));// The new half of the line still needs to be checked against the other lines
                         break;
                     }
                 }
                 
-                for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+                p_arcGrid.query(nodeIterator1->getCenterXCoordinate(), nodeIterator1->getCenterYCoordinate(), tolerance, nearbyArcs);
+                for(std::vector<arcShape*>::iterator arcIterator = nearbyArcs.begin(); arcIterator != nearbyArcs.end(); ++arcIterator)
                 {
-                    Vector nodeVector;
-                    nodeVector.Set(nodeIterator1->getCenterXCoordinate(), nodeIterator1->getCenterYCoordinate());
                     /* Pretty much, this portion of the code is doing the exact same thing as the code above but instead of straight lines, we are working with arcs */
-                    double dis = fabs(shortestDistanceFromArc(nodeVector, *arcIterator));
+                    double dis = fabs(shortestDistanceFromArc(nodeVector, **arcIterator));
                     
-                    if(dis < tolerance && !arcIterator->getSegmentProperty()->getHiddenState() && (*nodeIterator1 != *arcIterator->getFirstNode() && *nodeIterator1 != *arcIterator->getSecondNode())) // this needs t be looked into more
+                    if(dis < tolerance && !(*arcIterator)->getSegmentProperty()->getHiddenState() && (*nodeIterator1 != *(*arcIterator)->getFirstNode() && *nodeIterator1 != *(*arcIterator)->getSecondNode())) // this needs t be looked into more
                     {
-                        Vector firstNode, secondNode, thirdNode, center;
-                        arcShape arcSegment = *arcIterator;
-                        double radius;
-                        
-                        firstNode.Set(arcIterator->getFirstNode()->getCenterXCoordinate(), arcIterator->getFirstNode()->getCenterYCoordinate());
-                        secondNode.Set(arcIterator->getSecondNode()->getCenterXCoordinate(), arcIterator->getSecondNode()->getCenterYCoordinate());
-                        thirdNode.Set(nodeIterator1->getCenterXCoordinate(), nodeIterator1->getCenterYCoordinate());
-                        
-                        center.Set(arcIterator->getCenterXCoordinate(), arcIterator->getCenterYCoordinate());
-                        radius = arcIterator->getRadius();
-                        
-                        arcIterator->setSecondNode(*nodeIterator1);
-                        
-                        double angle = Varg((thirdNode - center) / (firstNode - center)) * (180.0 / PI);
-                        arcIterator->setArcAngle(angle);
-                        arcIterator->calculate();
-                        
-                        arcSegment.setFirstNode(*nodeIterator1);
-                        angle = Varg((secondNode - center) / (thirdNode - center)) * (180.0 / PI);
-                        arcSegment.setArcAngle(angle);
-                        arcSegment.setNumSegments(20);
-                        arcSegment.calculate();
-                        
-                        _lastArcAdded = _arcList.insert(arcSegment);
+                        splitArcAtNode(**arcIterator, *nodeIterator1);
+                        p_movedArcs.push_back(&(*_lastArcAdded));
                         break;
                     }
                 }
@@ -574,223 +578,296 @@ bool geometryEditor2D::checkIntersections(EditGeometry editedGeometry, double to
     
     if(editedGeometry == EditGeometry::EDIT_LINES || editedGeometry == EditGeometry::EDIT_ALL)
     {
-        for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)
+        if(checkAll)
         {
-            // If the line is to be ignored by the postprocessor, go ahead and ignore it in any intercetion calculation
-            if(lineIterator->getSegmentProperty()->getHiddenState())
-                continue;
-                
-            plf::colony<edgeLineShape>::iterator tempLineIterator = lineIterator;
-            
-            //TODO: Check if there is ever a case where one line iterator can intesect a node/line/arc
-            if(editedGeometry == EditGeometry::EDIT_LINES)
+            for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)
+                lineCandidates.push_back(&(*lineIterator));
+        }
+        else
+        {
+            lineCandidates = p_movedLines;
+            sortCandidates(lineCandidates);
+        }
+        
+        //TODO: Check if there is ever a case where one line iterator can intesect a node/line/arc
+        if(editedGeometry == EditGeometry::EDIT_LINES)
+        {
+            /* First we check if there is any intercetion with just nodes */
+            for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
             {
-                /* First we check if there is any intercetion with just nodes */
-                for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
+                std::vector<edgeLineShape*> nearbyLines;
+                
+                p_lineGrid.query(nodeIterator->getCenterXCoordinate(), nodeIterator->getCenterYCoordinate(), tolerance, nearbyLines);
+                for(std::vector<edgeLineShape*>::iterator lineIterator = nearbyLines.begin(); lineIterator != nearbyLines.end(); ++lineIterator)
                 {
-                    if(fabs(calculateShortestDistance(*nodeIterator, *lineIterator)) < tolerance && (*nodeIterator != *lineIterator->getFirstNode() && *nodeIterator != *lineIterator->getSecondNode()))
-                    {
-                        /* If the node is on the line (determined by the calculateShortestDistance function) a new line will be created (This will be called line 1)
-                         * Line1 will be set equal to the original line (line0).
-                         * For the sake of explanation, the left most node will be considered as node 1 and the right most node will be considered node 2.
-                         * So, node 2 of line1 will then be switched to the newly created node and the first node of line0 will be set to the new node 
-                         * also. This effectively breaks the line into 2 shorter lines
-                         */ 
-                        edgeLineShape edgeLine = *lineIterator;
-                        lineIterator->setSecondNode(*nodeIterator);
+                    if((*lineIterator)->getSegmentProperty()->getHiddenState())
+                        continue;
                         
-                        edgeLine.setFirstNode(*nodeIterator);
-                        _lastLineAdded = _lineList.insert(edgeLine);// Add the new line to the array
+                    if(fabs(calculateShortestDistance(*nodeIterator, **lineIterator)) < tolerance && (*nodeIterator != *(*lineIterator)->getFirstNode() && *nodeIterator != *(*lineIterator)->getSecondNode()))
+                    {
+                        splitLineAtNode(**lineIterator, *nodeIterator);
+                        lineCandidates.push_back(&(*_lastLineAdded));
+                        break;
                     }
                 }
             }
+        }
+        
+        for(std::vector<edgeLineShape*>::iterator candidateIterator = lineCandidates.begin(); candidateIterator != lineCandidates.end(); ++candidateIterator)
+        {
+            edgeLineShape *lineIterator = *candidateIterator;
+            std::vector<edgeLineShape*> nearbyLines;
+            std::vector<arcShape*> nearbyArcs;
+            
+            // The line could have been removed for being on top of another line
+            if(!p_lineGrid.contains(lineIterator))
+                continue;
+            
+            // If the line is to be ignored by the postprocessor, go ahead and ignore it in any intercetion calculation
+            if(lineIterator->getSegmentProperty()->getHiddenState())
+                continue;
+                
+            boundingBox lineBox = getBoundingBox(*lineIterator);
             
             // Next, we need to check if there are any intercetions with the lines. That is, if a line is placed on top of a line or if a line crosses another line
-            for(plf::colony<edgeLineShape>::iterator lineIterator2 = ++tempLineIterator; lineIterator2 != _lineList.end();)
+            p_lineGrid.query(lineBox, nearbyLines);
+            for(std::vector<edgeLineShape*>::iterator linePointer = nearbyLines.begin(); linePointer != nearbyLines.end(); ++linePointer)
             {
+                edgeLineShape *lineIterator2 = *linePointer;
                 double tempX, tempY;
                 
-                if(lineIterator2 == _lineList.end())
-                    break;
+                // Each pair of lines only needs to be tested once. A line that is not being checked is tested from this side
+                if(lineIterator2 == lineIterator || lineIterator2->getSegmentProperty()->getHiddenState())
+                    continue;
+                else if(lineIterator2 < lineIterator && (checkAll || std::binary_search(lineCandidates.begin(), lineCandidates.end(), lineIterator2)))
+                    continue;
                     
-                // If a line is placed on top of another line, then we will have to transfer any lines/arcs connecting to the nodes of the line to the other line 
-                if(((*lineIterator->getFirstNode() == *lineIterator2->getFirstNode() && *lineIterator->getSecondNode() == *lineIterator2->getSecondNode()) || (*lineIterator->getFirstNode() == *lineIterator2->getSecondNode() && *lineIterator->getSecondNode() == *lineIterator2->getFirstNode())) && (lineIterator != lineIterator2))
+                // If a line is placed on top of another line, then the second line is removed. Both lines already share the same nodes
+                if((*lineIterator->getFirstNode() == *lineIterator2->getFirstNode() && *lineIterator->getSecondNode() == *lineIterator2->getSecondNode()) || (*lineIterator->getFirstNode() == *lineIterator2->getSecondNode() && *lineIterator->getSecondNode() == *lineIterator2->getFirstNode()))
                 {
-                    for(plf::colony<edgeLineShape>::iterator lineIterator3 = _lineList.begin(); lineIterator3 != _lineList.end(); ++lineIterator3)
-                    {
-                        if(*lineIterator3->getFirstNode() == *lineIterator->getFirstNode())
-                            lineIterator3->setFirstNode(*lineIterator->getFirstNode());
-                        else if(*lineIterator3->getFirstNode() == *lineIterator->getSecondNode())
-                            lineIterator3->setSecondNode(*lineIterator->getSecondNode());
-                    }
-                    
-                    for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
-                    {
-                        if(*arcIterator->getFirstNode() == *lineIterator->getFirstNode())
-                            arcIterator->setFirstNode(*lineIterator->getFirstNode());
-                        else if(*arcIterator->getFirstNode() == *lineIterator->getSecondNode())
-                            arcIterator->setSecondNode(*lineIterator->getSecondNode());
-                    }
-                    
-                    // As the last item, we need to delete the two nodes and the line from the list
-                    for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end();)
-                    {
-                        if(*nodeIterator == *lineIterator2->getFirstNode() || *nodeIterator == *lineIterator2->getSecondNode())
-                            _nodeList.erase(nodeIterator++);
-                        else
-                             nodeIterator++;   
-                    }
-                    
-                    _lineList.erase(lineIterator2++);
+                    if(&(*_lastLineAdded) == lineIterator2)
+                        _lastLineAdded = _lineList.begin();
+                        
+                    p_lineGrid.remove(lineIterator2);
+                    _lineList.erase(_lineList.get_iterator_from_pointer(lineIterator2));
                 }    
-                else if(getIntersection(*lineIterator2, *lineIterator, tempX, tempY) && !lineIterator2->getSegmentProperty()->getHiddenState())
+                else if(getIntersection(*lineIterator2, *lineIterator, tempX, tempY))
                 {
                     // If the line intersectes with another line, then go ahead and place a node at the intercetion point
-                    addNode(tempX, tempY, tolerance);
-                    lineIterator2++;
+                    intersectionPoints.push_back(Vector(tempX, tempY));
                 }
-                else
-                    lineIterator2++;
             }
             
-            for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+            p_arcGrid.query(lineBox, nearbyArcs);
+            for(std::vector<arcShape*>::iterator arcIterator = nearbyArcs.begin(); arcIterator != nearbyArcs.end(); ++arcIterator)
             {
                 Vector newNodesPoints[2];
-                int j = getLineToArcIntersection(*lineIterator, *arcIterator, newNodesPoints);
-                if(j > 0 && !arcIterator->getSegmentProperty()->getHiddenState())
-                {
-                    for(int k = 0; k < j; k++)
-                    {
-                        addNode(newNodesPoints[k].getXComponent(), newNodesPoints[k].getYComponent(), tolerance);
-                    }
-                }
+                
+                if((*arcIterator)->getSegmentProperty()->getHiddenState())
+                    continue;
+                    
+                int j = getLineToArcIntersection(*lineIterator, **arcIterator, newNodesPoints);
+                for(int k = 0; k < j; k++)
+                    intersectionPoints.push_back(newNodesPoints[k]);
             }
         }
     }
     
     if(editedGeometry == EditGeometry::EDIT_ARCS || editedGeometry == EditGeometry::EDIT_ALL)
     {
-        for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+        std::vector<arcShape*> arcCandidates;
+        
+        if(checkAll)
+        {
+            for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+                arcCandidates.push_back(&(*arcIterator));
+        }
+        else
+        {
+            arcCandidates = p_movedArcs;
+            sortCandidates(arcCandidates);
+        }
+        
+        if(editedGeometry == EditGeometry::EDIT_ARCS)
         {
-            if(editedGeometry == EditGeometry::EDIT_ARCS)
+            for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
             {
-                for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
+                std::vector<arcShape*> nearbyArcs;
+                Vector nodeVector;
+                nodeVector.Set(nodeIterator->getCenterXCoordinate(), nodeIterator->getCenterYCoordinate());
+                
+                p_arcGrid.query(nodeIterator->getCenterXCoordinate(), nodeIterator->getCenterYCoordinate(), tolerance, nearbyArcs);
+                for(std::vector<arcShape*>::iterator arcIterator = nearbyArcs.begin(); arcIterator != nearbyArcs.end(); ++arcIterator)
                 {
-                    Vector nodeVector;
-                    nodeVector.Set(nodeIterator->getCenterXCoordinate(), nodeIterator->getCenterYCoordinate());
                     /* Pretty much, this portion of the code is doing the exact same thing as the code above but instead of straight lines, we are working with arcs */
-                    double dis = fabs(shortestDistanceFromArc(nodeVector, *arcIterator));
+                    double dis = fabs(shortestDistanceFromArc(nodeVector, **arcIterator));
                     
-                    if(dis < tolerance && !arcIterator->getSegmentProperty()->getHiddenState() && (*nodeIterator != *arcIterator->getFirstNode() && *nodeIterator != *arcIterator->getSecondNode())) // this needs t be looked into more
+                    if(dis < tolerance && !(*arcIterator)->getSegmentProperty()->getHiddenState() && (*nodeIterator != *(*arcIterator)->getFirstNode() && *nodeIterator != *(*arcIterator)->getSecondNode())) // this needs t be looked into more
                     {
-                        Vector firstNode, secondNode, thirdNode, center;
-                        arcShape arcSegment = *arcIterator;
-                        double radius;
-                        
-                        firstNode.Set(arcIterator->getFirstNode()->getCenterXCoordinate(), arcIterator->getFirstNode()->getCenterYCoordinate());
-                        secondNode.Set(arcIterator->getSecondNode()->getCenterXCoordinate(), arcIterator->getSecondNode()->getCenterYCoordinate());
-                        thirdNode.Set(nodeIterator->getCenterXCoordinate(), nodeIterator->getCenterYCoordinate());
-                        
-                        center.Set(arcIterator->getCenterXCoordinate(), arcIterator->getCenterYCoordinate());
-                        radius = arcIterator->getRadius();
-                        
-                        arcIterator->setSecondNode(*nodeIterator);
-                        
-                        double angle = Varg((thirdNode - center) / (firstNode - center)) * (180.0 / PI);
-                        arcIterator->setArcAngle(angle);
-                        arcIterator->calculate();
-                        
-                        arcSegment.setFirstNode(*nodeIterator);
-                        angle = Varg((secondNode - center) / (thirdNode - center)) * (180.0 / PI);
-                        arcSegment.setArcAngle(angle);
-                        arcSegment.setNumSegments(20);
-                        arcSegment.calculate();
-                        
-                        _lastArcAdded = _arcList.insert(arcSegment);
+                        splitArcAtNode(**arcIterator, *nodeIterator);
+                        arcCandidates.push_back(&(*_lastArcAdded));
                         break;
                     }
                 }
-                
-                for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)
+            }
+        }
+        
+        for(std::vector<arcShape*>::iterator candidateIterator = arcCandidates.begin(); candidateIterator != arcCandidates.end(); ++candidateIterator)
+        {
+            arcShape *arcIterator = *candidateIterator;
+            std::vector<edgeLineShape*> nearbyLines;
+            std::vector<arcShape*> nearbyArcs;
+            
+            if(!p_arcGrid.contains(arcIterator) || arcIterator->getSegmentProperty()->getHiddenState())
+                continue;
+            
+            boundingBox arcBox = getBoundingBox(*arcIterator);
+            
+            // The line to arc intersections have already been found for the lines that were checked
+            if(editedGeometry == EditGeometry::EDIT_ARCS || !checkAll)
+            {
+                p_lineGrid.query(arcBox, nearbyLines);
+                for(std::vector<edgeLineShape*>::iterator lineIterator = nearbyLines.begin(); lineIterator != nearbyLines.end(); ++lineIterator)
                 {
                     Vector newNodesPoints[2];
-                    int j = getLineToArcIntersection(*lineIterator, *arcIterator, newNodesPoints);
-                    if(j > 0 && !lineIterator->getSegmentProperty()->getHiddenState())
-                    {
-                        for(int k = 0; k < j; k++)
-                        {
-                            addNode(newNodesPoints[k].getXComponent(), newNodesPoints[k].getYComponent(), tolerance);
-                        }
-                    }
+                    
+                    if((*lineIterator)->getSegmentProperty()->getHiddenState())
+                        continue;
+                    else if(!checkAll && std::binary_search(lineCandidates.begin(), lineCandidates.end(), *lineIterator))
+                        continue;
+                        
+                    int j = getLineToArcIntersection(**lineIterator, *arcIterator, newNodesPoints);
+                    for(int k = 0; k < j; k++)
+                        intersectionPoints.push_back(newNodesPoints[k]);
                 }
             }
-            plf::colony<arcShape>::iterator tempArcIterator = arcIterator;
-            for(plf::colony<arcShape>::iterator arcIterator2 = ++tempArcIterator; arcIterator2 != _arcList.end(); ++arcIterator2)
+            
+            p_arcGrid.query(arcBox, nearbyArcs);
+            for(std::vector<arcShape*>::iterator arcPointer = nearbyArcs.begin(); arcPointer != nearbyArcs.end(); ++arcPointer)
             {
+                arcShape *arcIterator2 = *arcPointer;
                 Vector intersectingNodes[2];
+                
+                // Each pair of arcs only needs to be tested once
+                if(arcIterator2 == arcIterator || arcIterator2->getSegmentProperty()->getHiddenState())
+                    continue;
+                else if(arcIterator2 < arcIterator && (checkAll || std::binary_search(arcCandidates.begin(), arcCandidates.end(), arcIterator2)))
+                    continue;
+                    
                 int j = getArcToArcIntersection(*arcIterator, *arcIterator2,  intersectingNodes); // This will be for an arc intersecting an arc
-		
-                if(j > 0 && !arcIterator2->getSegmentProperty()->getHiddenState())
-                {
-                    for(int k = 0; k < j; k++)
-                    {
-                        addNode(intersectingNodes[k].getXComponent(), intersectingNodes[k].getYComponent(), tolerance);
-                    }
-                }
+                for(int k = 0; k < j; k++)
+                    intersectionPoints.push_back(intersectingNodes[k]);
             }
         }
     }
     
+    /* The nodes are placed after all of the intersections have been found since placing a node will break up the lines and arcs */
+    for(std::vector<Vector>::iterator pointIterator = intersectionPoints.begin(); pointIterator != intersectionPoints.end(); ++pointIterator)
+        addNode(pointIterator->getXComponent(), pointIterator->getYComponent(), tolerance);
+    
     // Here we will not delete the block labels but rather we willl flag them so that the user can deal with them apprioately
     if(editedGeometry == EditGeometry::EDIT_LABELS || editedGeometry == EditGeometry::EDIT_ALL)
     {
+        std::vector<blockLabel*> labelCandidates;
+        
+        ensureSpatialIndex();
         
-        for(plf::colony<blockLabel>::iterator blockIterator = _blockLabelList.begin(); blockIterator != _blockLabelList.end(); ++blockIterator)
+        if(checkAll)
         {
-            for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+            for(plf::colony<blockLabel>::iterator blockIterator = _blockLabelList.begin(); blockIterator != _blockLabelList.end(); ++blockIterator)
+                labelCandidates.push_back(&(*blockIterator));
+        }
+        else
+        {
+            // Only the labels that are close to something that moved (or to one of the new nodes) can now be violated
+            for(std::vector<blockLabel*>::iterator labelIterator = p_movedLabels.begin(); labelIterator != p_movedLabels.end(); ++labelIterator)
             {
-                Vector blockLabelVector = Vector(blockIterator->getCenterXCoordinate(), blockIterator->getCenterYCoordinate());
-                if(shortestDistanceFromArc(blockLabelVector, *arcIterator) < tolerance)
+                if(p_blockLabelGrid.contains(*labelIterator))
+                    p_blockLabelGrid.query((*labelIterator)->getCenterXCoordinate(), (*labelIterator)->getCenterYCoordinate(), tolerance, labelCandidates);
+            }
+            
+            for(std::vector<node*>::iterator nodeIterator = p_movedNodes.begin(); nodeIterator != p_movedNodes.end(); ++nodeIterator)
+            {
+                if(p_nodeGrid.contains(*nodeIterator))
+                    p_blockLabelGrid.query((*nodeIterator)->getCenterXCoordinate(), (*nodeIterator)->getCenterYCoordinate(), tolerance, labelCandidates);
+            }
+            
+            for(std::vector<edgeLineShape*>::iterator lineIterator = p_movedLines.begin(); lineIterator != p_movedLines.end(); ++lineIterator)
+            {
+                if(p_lineGrid.contains(*lineIterator))
+                    p_blockLabelGrid.query(growBox(getBoundingBox(**lineIterator), tolerance), labelCandidates);
+            }
+            
+            for(std::vector<arcShape*>::iterator arcIterator = p_movedArcs.begin(); arcIterator != p_movedArcs.end(); ++arcIterator)
+            {
+                if(p_arcGrid.contains(*arcIterator))
+                    p_blockLabelGrid.query(growBox(getBoundingBox(**arcIterator), tolerance), labelCandidates);
+            }
+            
+            for(std::vector<Vector>::iterator pointIterator = intersectionPoints.begin(); pointIterator != intersectionPoints.end(); ++pointIterator)
+                p_blockLabelGrid.query(pointIterator->getXComponent(), pointIterator->getYComponent(), tolerance, labelCandidates);
+            
+            sortCandidates(labelCandidates);
+        }
+        
+        for(std::vector<blockLabel*>::iterator candidateIterator = labelCandidates.begin(); candidateIterator != labelCandidates.end(); ++candidateIterator)
+        {
+            blockLabel *blockIterator = *candidateIterator;
+            double xPoint = blockIterator->getCenterXCoordinate();
+            double yPoint = blockIterator->getCenterYCoordinate();
+            Vector blockLabelVector = Vector(xPoint, yPoint);
+            std::vector<arcShape*> nearbyArcs;
+            std::vector<edgeLineShape*> nearbyLines;
+            std::vector<node*> nearbyNodes;
+            std::vector<blockLabel*> nearbyLabels;
+            
+            p_arcGrid.query(xPoint, yPoint, tolerance, nearbyArcs);
+            for(std::vector<arcShape*>::iterator arcIterator = nearbyArcs.begin(); arcIterator != nearbyArcs.end(); ++arcIterator)
+            {
+                if(shortestDistanceFromArc(blockLabelVector, **arcIterator) < tolerance)
                 {
                     labelsViolated = true;
                     blockIterator->setSelectState(true);// Flag the block label if it violates tolerances so that the user can deal with it.
                 }
-                    
             }
             
-            for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)
+            p_lineGrid.query(xPoint, yPoint, tolerance, nearbyLines);
+            for(std::vector<edgeLineShape*>::iterator lineIterator = nearbyLines.begin(); lineIterator != nearbyLines.end(); ++lineIterator)
             {
-                if(calculateShortestDistance(*blockIterator, *lineIterator) < tolerance)
+                if(calculateShortestDistance(*blockIterator, **lineIterator) < tolerance)
                 {
                     labelsViolated = true;
                     blockIterator->setSelectState(true);
                 }
-                    
             }
             
-            for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
+            p_nodeGrid.query(xPoint, yPoint, tolerance, nearbyNodes);
+            for(std::vector<node*>::iterator nodeIterator = nearbyNodes.begin(); nodeIterator != nearbyNodes.end(); ++nodeIterator)
             {
-                if(nodeIterator->getDistance(blockIterator->getCenterXCoordinate(), blockIterator->getCenterYCoordinate()) < tolerance)
+                if((*nodeIterator)->getDistance(xPoint, yPoint) < tolerance)
                 {
                     labelsViolated = true;
                     blockIterator->setSelectState(true);
                 }
-                    
             }
             
-            plf::colony<blockLabel>::iterator tempIterator = blockIterator;
-            for(plf::colony<blockLabel>::iterator blockIterator2 = ++tempIterator; blockIterator2 != _blockLabelList.end(); ++blockIterator2)
+            p_blockLabelGrid.query(xPoint, yPoint, tolerance, nearbyLabels);
+            for(std::vector<blockLabel*>::iterator blockIterator2 = nearbyLabels.begin(); blockIterator2 != nearbyLabels.end(); ++blockIterator2)
             {
-                if(blockIterator2->getDistance(blockIterator->getCenterXCoordinate(), blockIterator->getCenterYCoordinate()) < tolerance)
+                if(*blockIterator2 != blockIterator && (*blockIterator2)->getDistance(xPoint, yPoint) < tolerance)
                 {
                     labelsViolated = true;
                     blockIterator->setSelectState(true);
                 }
-                    
             }
         }
     }
     
+    p_movedNodes.clear();
+    p_movedLabels.clear();
+    p_movedLines.clear();
+    p_movedArcs.clear();
+    
     return labelsViolated;
 }
 
@@ -955,6 +1032,7 @@ bool geometryEditor2D::createFillet(double radius)
                     {
                         if((*lineIterator->getFirstNode() == *nodeIterator || *lineIterator->getSecondNode() == *nodeIterator) && !lineIterator->getSegmentProperty()->getHiddenState())
                         {
+                            p_lineGrid.remove(&(*lineIterator));
                             _lineList.erase(lineIterator);
                             break;
                         }
@@ -966,6 +1044,7 @@ bool geometryEditor2D::createFillet(double radius)
                     {
                         if((*arcIterator->getFirstNode() == *nodeIterator || *arcIterator->getSecondNode() == *nodeIterator) && !arcIterator->getSegmentProperty()->getHiddenState())
                         {
+                            p_arcGrid.remove(&(*arcIterator));
                             _arcList.erase(arcIterator);
                             break;
                         }
@@ -987,7 +1066,10 @@ bool geometryEditor2D::createFillet(double radius)
                         willReturn = true;
                         
                     if(!isConnectedToHiddenSegment)
+                    {
+                        p_nodeGrid.remove(&(*nodeIterator));
                         _nodeList.erase(nodeIterator++);
+                    }
                     else
                         nodeIterator++;
                 }
@@ -1089,11 +1171,15 @@ bool geometryEditor2D::createFillet(double radius)
                         {
                             if(lineIterator == _lineList.back())
                             {
+                                p_lineGrid.remove(&(*lineIterator));
                                 _lineList.erase(lineIterator);
                                 break;
                             }
                             else
+                            {
+                                p_lineGrid.remove(&(*lineIterator));
                                 _lineList.erase(lineIterator++);
+                            }
                         }
                         else if(lineIterator->getSegmentProperty()->getHiddenState())
                         {
@@ -1127,7 +1213,10 @@ bool geometryEditor2D::createFillet(double radius)
                         willReturn = true;
                         
                     if(!isConnectedToHiddenLine)
+                    {
+                        p_nodeGrid.remove(&(*nodeIterator));
                         _nodeList.erase(nodeIterator++); /// TODO: Check here for issues with iterators
+                    }
                     else
                         nodeIterator++;
                 }
@@ -1265,11 +1354,15 @@ bool geometryEditor2D::createFillet(double radius)
                         {
                             if(arcIterator == _arcList.back())
                             {
+                                p_arcGrid.remove(&(*arcIterator));
                                 _arcList.erase(arcIterator);
                                 break;
                             }
                             else
+                            {
+                                p_arcGrid.remove(&(*arcIterator));
                                 _arcList.erase(arcIterator++);
+                            }
                         }
                         else if(arcIterator->getSegmentProperty()->getHiddenState())
                         {
@@ -1308,7 +1401,10 @@ bool geometryEditor2D::createFillet(double radius)
                         willReturn = true;
                         
                     if(!isConnectedToHiddenSegment)
+                    {
+                        p_nodeGrid.remove(&(*nodeIterator));
                         _nodeList.erase(nodeIterator++);
+                    }
                     else
                         nodeIterator++;
                 }
@@ -1603,4 +1699,195 @@ double geometryEditor2D::calculateShortestDistance(wxRealPoint selectedPoint, ed
 	y[2] = y[0] + t * (y[1] - y[0]);
     
 	return sqrt((selectedPoint.x - x[2]) * (selectedPoint.x - x[2]) + (selectedPoint.y - y[2]) * (selectedPoint.y - y[2]));    
-}
\ No newline at end of file
+}
+
+
+boundingBox geometryEditor2D::getBoundingBox(edgeLineShape &lineSegment)
+{
+    boundingBox lineBox(lineSegment.getFirstNode()->getCenter());
+    lineBox.addPoint(lineSegment.getSecondNode()->getCenter());
+    
+    return lineBox;
+}
+
+
+
+boundingBox geometryEditor2D::getBoundingBox(arcShape &arcSegment)
+{
+    double radius = fabs(arcSegment.getRadius());
+    
+    // The endpoints are also added in case the arc has not yet been calculated
+    boundingBox arcBox(arcSegment.getFirstNode()->getCenter());
+    arcBox.addPoint(arcSegment.getSecondNode()->getCenter());
+    arcBox.addPoint(wxRealPoint(arcSegment.getCenterXCoordinate() - radius, arcSegment.getCenterYCoordinate() - radius));
+    arcBox.addPoint(wxRealPoint(arcSegment.getCenterXCoordinate() + radius, arcSegment.getCenterYCoordinate() + radius));
+    
+    return arcBox;
+}
+
+
+
+void geometryEditor2D::splitLineAtNode(edgeLineShape &lineSegment, node &splitNode)
+{
+    /* If the node is on the line (determined by the calculateShortestDistance function) a new line will be created (This will be called line 1)
+     * Line1 will be set equal to the original line (line0).
+     * For the sake of explanation, the left most node will be considered as node 1 and the right most node will be considered node 2.
+     * So, node 2 of line1 will then be switched to the newly created node and the first node of line0 will be set to the new node
+     * also. This effectively breaks the line into 2 shorter lines
+     */
+    edgeLineShape edgeLine = lineSegment;
+    lineSegment.setSecondNode(splitNode);// This will set the node to be the second node of the shortend line
+    lineSegment.calculateDistance();
+    indexLine(lineSegment);
+
+    edgeLine.setFirstNode(splitNode);// This will set the node to be the first node of the new line
+    edgeLine.calculateDistance();
+    _lastLineAdded = _lineList.insert(edgeLine);// Add the new line to the array
+    indexLine(*_lastLineAdded);
+}
+
+
+
+void geometryEditor2D::splitArcAtNode(arcShape &arcSegment, node &splitNode)
+{
+    Vector firstNode, secondNode, thirdNode, center;
+    arcShape newArcSegment = arcSegment;
+
+    firstNode.Set(arcSegment.getFirstNode()->getCenterXCoordinate(), arcSegment.getFirstNode()->getCenterYCoordinate());
+    secondNode.Set(arcSegment.getSecondNode()->getCenterXCoordinate(), arcSegment.getSecondNode()->getCenterYCoordinate());
+    thirdNode.Set(splitNode.getCenterXCoordinate(), splitNode.getCenterYCoordinate());
+
+    center.Set(arcSegment.getCenterXCoordinate(), arcSegment.getCenterYCoordinate());
+
+    arcSegment.setSecondNode(splitNode);
+
+    double angle = Varg((thirdNode - center) / (firstNode - center)) * (180.0 / PI);
+    arcSegment.setArcAngle(angle);
+    arcSegment.calculate();
+    indexArc(arcSegment);
+
+    newArcSegment.setFirstNode(splitNode);
+    angle = Varg((secondNode - center) / (thirdNode - center)) * (180.0 / PI);
+    newArcSegment.setArcAngle(angle);
+    newArcSegment.setNumSegments(20);
+    newArcSegment.calculate();
+    newArcSegment.setArcID(++p_arcNumber);
+
+    _lastArcAdded = _arcList.insert(newArcSegment);
+    indexArc(*_lastArcAdded);
+}
+
+
+
+void geometryEditor2D::ensureSpatialIndex()
+{
+    size_t totalSize = _nodeList.size() + _blockLabelList.size() + _lineList.size() + _arcList.size();
+    
+    if(!spatialIndexIsCurrent())
+        rebuildSpatialIndex();
+    else if(totalSize > 2 * p_spatialIndexSizeAtRebuild + 64)
+        rebuildSpatialIndex();
+}
+
+
+
+void geometryEditor2D::rebuildSpatialIndex()
+{
+    double cellSize = 1.0;
+    size_t numberOfPoints = _nodeList.size() + _blockLabelList.size();
+    
+    if(_nodeList.size() > 0)
+        p_nodeExtent = boundingBox(_nodeList.begin()->getCenter());
+    else
+        p_nodeExtent = boundingBox(wxRealPoint(0, 0));
+    
+    for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
+        p_nodeExtent.addPoint(nodeIterator->getCenter());
+    
+    /* The size of the cell is choosen so that on average, there are a few points per cell. The block labels
+     * are normally placed inside of the geometry so the box around the nodes is good enough
+     */ 
+    if(numberOfPoints > 0)
+    {
+        double width = p_nodeExtent.getMaxBounds().x - p_nodeExtent.getMinBounds().x;
+        double height = p_nodeExtent.getMaxBounds().y - p_nodeExtent.getMinBounds().y;
+        double largestSide = std::max(width, height);
+        
+        if(largestSide > 0)
+            cellSize = 2.0 * largestSide / sqrt((double)numberOfPoints);
+    }
+    
+    p_nodeGrid.reset(cellSize);
+    p_blockLabelGrid.reset(cellSize);
+    p_lineGrid.reset(cellSize);
+    p_arcGrid.reset(cellSize);
+    
+    for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); ++nodeIterator)
+        p_nodeGrid.insert(&(*nodeIterator), boundingBox(nodeIterator->getCenter()));
+        
+    for(plf::colony<blockLabel>::iterator blockIterator = _blockLabelList.begin(); blockIterator != _blockLabelList.end(); ++blockIterator)
+        p_blockLabelGrid.insert(&(*blockIterator), boundingBox(blockIterator->getCenter()));
+        
+    for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); ++lineIterator)
+        p_lineGrid.insert(&(*lineIterator), getBoundingBox(*lineIterator));
+        
+    for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); ++arcIterator)
+        p_arcGrid.insert(&(*arcIterator), getBoundingBox(*arcIterator));
+        
+    p_spatialIndexSizeAtRebuild = _nodeList.size() + _blockLabelList.size() + _lineList.size() + _arcList.size();
+}
+
+
+
+void geometryEditor2D::findNodesNear(std::vector<edgeLineShape*> &lines, std::vector<arcShape*> &arcs, double tolerance, std::vector<node*> &foundNodes)
+{
+    for(std::vector<edgeLineShape*>::iterator lineIterator = lines.begin(); lineIterator != lines.end(); ++lineIterator)
+    {
+        if(p_lineGrid.contains(*lineIterator))
+            p_nodeGrid.query(growBox(getBoundingBox(**lineIterator), tolerance), foundNodes);
+    }
+    
+    for(std::vector<arcShape*>::iterator arcIterator = arcs.begin(); arcIterator != arcs.end(); ++arcIterator)
+    {
+        if(p_arcGrid.contains(*arcIterator))
+            p_nodeGrid.query(growBox(getBoundingBox(**arcIterator), tolerance), foundNodes);
+    }
+}
+
+
+
+void geometryEditor2D::moveNode(node &movedNode, double xPoint, double yPoint)
+{
+    std::vector<edgeLineShape*> nearbyLines;
+    std::vector<arcShape*> nearbyArcs;
+    
+    ensureSpatialIndex();
+    
+    // The box of every line and arc that is connected to the node contains the old position of the node
+    p_lineGrid.query(movedNode.getCenterXCoordinate(), movedNode.getCenterYCoordinate(), 0, nearbyLines);
+    p_arcGrid.query(movedNode.getCenterXCoordinate(), movedNode.getCenterYCoordinate(), 0, nearbyArcs);
+    
+    movedNode.setCenter(xPoint, yPoint);
+    indexNode(movedNode);
+    p_movedNodes.push_back(&movedNode);
+    
+    for(std::vector<edgeLineShape*>::iterator lineIterator = nearbyLines.begin(); lineIterator != nearbyLines.end(); ++lineIterator)
+    {
+        if((*lineIterator)->getFirstNode() == &movedNode || (*lineIterator)->getSecondNode() == &movedNode)
+        {
+            (*lineIterator)->calculateDistance();
+            indexLine(**lineIterator);
+            p_movedLines.push_back(*lineIterator);
+        }
+    }
+    
+    for(std::vector<arcShape*>::iterator arcIterator = nearbyArcs.begin(); arcIterator != nearbyArcs.end(); ++arcIterator)
+    {
+        if((*arcIterator)->getFirstNode() == &movedNode || (*arcIterator)->getSecondNode() == &movedNode)
+        {
+            (*arcIterator)->calculate(); // The center and radius of the arc will need to be recalculated after one of the nodes has moved
+            indexArc(**arcIterator);
+            p_movedArcs.push_back(*arcIterator);
+        }
+    }
+}
@@ -0,0 +1,485 @@
+#include <UI/ModelDefinition/GeometryRenderer.h>
+#include <cstddef>
+
+
+void vertexBatch::upload(bool useBuffers)
+{
+    if(useBuffers && p_vertices.size() > 0)
+    {
+        if(p_bufferID == 0)
+            glGenBuffers(1, &p_bufferID);
+
+        glBindBuffer(GL_ARRAY_BUFFER, p_bufferID);
+
+        if(p_vertices.size() > p_bufferCapacity)
+        {
+            // Leave some room to grow so that adding geometry does not cause the buffer to be created every frame
+            p_bufferCapacity = p_vertices.size() + p_vertices.size() / 2;
+            glBufferData(GL_ARRAY_BUFFER, p_bufferCapacity * sizeof(renderVertex), NULL, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, p_vertices.size() * sizeof(renderVertex), &p_vertices[0]);
+        }
+        else
+        {
+            if(p_dirtyEnd > p_vertices.size())
+                p_dirtyEnd = p_vertices.size();
+
+            if(p_dirtyEnd > p_dirtyBegin)
+                glBufferSubData(GL_ARRAY_BUFFER, p_dirtyBegin * sizeof(renderVertex), (p_dirtyEnd - p_dirtyBegin) * sizeof(renderVertex), &p_vertices[p_dirtyBegin]);
+        }
+    }
+
+    p_dirtyBegin = 0;
+    p_dirtyEnd = 0;
+}
+
+
+
+void vertexBatch::bind(bool useBuffers, bool useColors)
+{
+    const GLubyte *basePointer;
+
+    if(useBuffers)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, p_bufferID);
+        basePointer = NULL;// When a buffer is bound, the pointer is the offset into the buffer
+    }
+    else
+        basePointer = (const GLubyte *)&p_vertices[0];
+
+    glVertexPointer(2, GL_FLOAT, sizeof(renderVertex), basePointer + offsetof(renderVertex, x));
+
+    if(useColors)
+    {
+        glEnableClientState(GL_COLOR_ARRAY);
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(renderVertex), basePointer + offsetof(renderVertex, color));
+    }
+    else
+        glDisableClientState(GL_COLOR_ARRAY);
+}
+
+
+
+void vertexBatch::releaseBuffer()
+{
+    if(p_bufferID != 0)
+        glDeleteBuffers(1, &p_bufferID);
+
+    p_bufferID = 0;
+    p_bufferCapacity = 0;
+    markDirty(0, p_vertices.size());
+}
+
+
+
+void geometryRenderer::fillRecord(edgeLineShape &edge, edgeRecord &record)
+{
+    record.coordinates[0] = edge.getFirstNode()->getCenterXCoordinate();
+    record.coordinates[1] = edge.getFirstNode()->getCenterYCoordinate();
+    record.coordinates[2] = edge.getSecondNode()->getCenterXCoordinate();
+    record.coordinates[3] = edge.getSecondNode()->getCenterYCoordinate();
+    record.coordinates[4] = edge.getCenterXCoordinate();
+    record.coordinates[5] = edge.getCenterYCoordinate();
+    record.arcAngle = 0;
+    record.numSegments = 1;
+    record.isSelected = edge.getIsSelectedState();
+    record.isHidden = edge.getSegmentProperty()->getHiddenState();
+    record.offset = 0;
+    record.capacity = 0;
+}
+
+
+
+bool geometryRenderer::isSameRecord(const edgeRecord &first, const edgeRecord &second)
+{
+    for(int i = 0; i < 6; i++)
+    {
+        if(first.coordinates[i] != second.coordinates[i])
+            return false;
+    }
+
+    return (first.arcAngle == second.arcAngle && first.numSegments == second.numSegments && first.isSelected == second.isSelected && first.isHidden == second.isHidden);
+}
+
+
+
+unsigned int geometryRenderer::getNumberOfArcSegments(double radius, double arcAngle)
+{
+    double tolerance = 0.5 * p_pixelSize;
+    unsigned int numSegments = 1;
+
+    radius = fabs(radius);
+
+    if(!(tolerance > 0) || !(radius > 0))
+        return 1;
+
+    if(tolerance < radius)
+    {
+        /* The largest distance between a chord and the arc is r * (1 - cos(theta / 2)) where theta is the
+         * angle of the segment. Solving for theta gives the largest segment angle that is within the tolerance
+         */
+        double segmentAngle = 2.0 * acos(1.0 - tolerance / radius);
+        double segments = ceil((fabs(arcAngle) * PI / 180.0) / segmentAngle);
+
+        while(numSegments < segments && numSegments < p_maxArcSegments)
+            numSegments *= 2;
+    }
+
+    return numSegments;
+}
+
+
+
+template<class pointType>
+void geometryRenderer::updatePoints(std::vector<pointType*> &pointList, boundingBox &viewBox, std::unordered_map<pointType*, size_t> &slots, vertexBatch &batch, std::vector<GLuint> &indices, const GLubyte defaultColor[4])
+{
+    const GLubyte selectedColor[4] = {255, 0, 0, 255};
+    double clusterSize = p_pointSize * p_pixelSize;
+    double viewWidth = viewBox.getMaxBounds().x - viewBox.getMinBounds().x;
+    double viewHeight = viewBox.getMaxBounds().y - viewBox.getMinBounds().y;
+    bool useClusters = false;
+
+    indices.clear();
+    p_clusterMap.clear();
+
+    /* The points are only collapsed when there are enough points in the view that they start to
+     * fall on top of each other. Otherwise, every point is drawn as is.
+     */
+    if(clusterSize > 0)
+        useClusters = ((double)pointList.size() * 4.0 > (viewWidth / clusterSize) * (viewHeight / clusterSize));
+
+    for(typename std::vector<pointType*>::iterator pointIterator = pointList.begin(); pointIterator != pointList.end(); ++pointIterator)
+    {
+        pointType *point = *pointIterator;
+        double xPoint = point->getCenterXCoordinate();
+        double yPoint = point->getCenterYCoordinate();
+        bool isSelected = point->getIsSelectedState();
+
+        // The grid only returns candidates so the point itself still needs to be checked
+        if(xPoint < viewBox.getMinBounds().x || xPoint > viewBox.getMaxBounds().x || yPoint < viewBox.getMinBounds().y || yPoint > viewBox.getMaxBounds().y)
+            continue;
+
+        typename std::unordered_map<pointType*, size_t>::iterator slotIterator = slots.find(point);
+        size_t slot;
+
+        if(slotIterator == slots.end())
+        {
+            slot = batch.size();
+            batch.resize(slot + 1);
+            slots[point] = slot;
+        }
+        else
+            slot = slotIterator->second;
+
+        batch.setVertex(slot, xPoint, yPoint, isSelected ? selectedColor : defaultColor);
+
+        if(useClusters)
+        {
+            long long key = ((long long)floor(xPoint / clusterSize) << 32) ^ ((long long)floor(yPoint / clusterSize) & 0xFFFFFFFFLL);
+            std::unordered_map<long long, size_t>::iterator clusterIterator = p_clusterMap.find(key);
+
+            if(clusterIterator == p_clusterMap.end())
+            {
+                p_clusterMap[key] = indices.size();
+                indices.push_back((GLuint)slot);
+            }
+            else if(isSelected)
+                indices[clusterIterator->second] = (GLuint)slot;// A selected point always takes over the cluster so that the selection can be seen
+        }
+        else
+            indices.push_back((GLuint)slot);
+    }
+}
+
+
+
+void geometryRenderer::updateLines(boundingBox &viewBox)
+{
+    const GLubyte selectedColor[4] = {255, 0, 0, 255};
+    const GLubyte defaultColor[4] = {0, 0, 0, 255};
+
+    p_solidLineIndices.clear();
+    p_hiddenLineIndices.clear();
+
+    for(std::vector<edgeLineShape*>::iterator lineIterator = p_linesInView.begin(); lineIterator != p_linesInView.end(); ++lineIterator)
+    {
+        edgeRecord record;
+
+        fillRecord(**lineIterator, record);
+
+        boundingBox lineBox(wxRealPoint(record.coordinates[0], record.coordinates[1]));
+        lineBox.addPoint(wxRealPoint(record.coordinates[2], record.coordinates[3]));
+
+        if(!lineBox.intersects(viewBox))
+            continue;
+
+        std::unordered_map<edgeLineShape*, edgeRecord>::iterator recordIterator = p_lineRecords.find(*lineIterator);
+
+        if(recordIterator == p_lineRecords.end())
+        {
+            record.offset = p_lineBatch.size();
+            record.capacity = 2;
+            p_lineBatch.resize(record.offset + 2);
+            recordIterator = p_lineRecords.insert(std::make_pair(*lineIterator, record)).first;
+        }
+        else
+        {
+            record.offset = recordIterator->second.offset;
+            record.capacity = recordIterator->second.capacity;
+            recordIterator->second = record;
+        }
+
+        p_lineBatch.setVertex(record.offset, record.coordinates[0], record.coordinates[1], record.isSelected ? selectedColor : defaultColor);
+        p_lineBatch.setVertex(record.offset + 1, record.coordinates[2], record.coordinates[3], record.isSelected ? selectedColor : defaultColor);
+
+        std::vector<GLuint> &indices = record.isHidden ? p_hiddenLineIndices : p_solidLineIndices;
+        indices.push_back((GLuint)record.offset);
+        indices.push_back((GLuint)record.offset + 1);
+    }
+}
+
+
+
+void geometryRenderer::updateArcs(boundingBox &viewBox)
+{
+    const GLubyte selectedColor[4] = {255, 0, 0, 255};
+    const GLubyte defaultColor[4] = {0, 0, 0, 255};
+
+    p_solidArcIndices.clear();
+    p_hiddenArcIndices.clear();
+
+    for(std::vector<arcShape*>::iterator arcPointer = p_arcsInView.begin(); arcPointer != p_arcsInView.end(); ++arcPointer)
+    {
+        arcShape *arcIterator = *arcPointer;
+        edgeRecord record;
+
+        fillRecord(*arcIterator, record);
+        record.arcAngle = arcIterator->getArcAngle();
+        record.numSegments = getNumberOfArcSegments(arcIterator->getRadius(), record.arcAngle);
+
+        size_t numberOfVertices = 2 * record.numSegments;
+        std::unordered_map<arcShape*, edgeRecord>::iterator recordIterator = p_arcRecords.find(arcIterator);
+        bool needsTessellation = true;
+
+        if(recordIterator == p_arcRecords.end())
+        {
+            record.offset = p_arcBatch.size();
+            record.capacity = numberOfVertices;
+            p_arcBatch.resize(record.offset + numberOfVertices);
+        }
+        else
+        {
+            needsTessellation = !isSameRecord(record, recordIterator->second);
+            record.offset = recordIterator->second.offset;
+            record.capacity = recordIterator->second.capacity;
+
+            // If the arc now needs more segments then the slot can hold, a new slot is placed at the end of the batch
+            if(numberOfVertices > record.capacity)
+            {
+                record.offset = p_arcBatch.size();
+                record.capacity = numberOfVertices;
+                p_arcBatch.resize(record.offset + numberOfVertices);
+            }
+        }
+
+        if(needsTessellation)
+        {
+            /* The arc is drawn starting at the first node and rotating counter-clockwise about the center by the arc angle.
+             * Instead of computing a cos/sin for every segment, the rotation for one segment is computed once and
+             * applied to the previous point. The angle of a segment is negative but the rotation below is by its
+             * opposite, which is counter-clockwise
+             */
+            const GLubyte *color = record.isSelected ? selectedColor : defaultColor;
+            double angle = -(fabs(record.arcAngle) / (double)record.numSegments) * PI / 180.0;
+            double cosAngle = cos(angle);
+            double sinAngle = sin(angle);
+            double xDistance = record.coordinates[0] - record.coordinates[4];
+            double yDistance = record.coordinates[1] - record.coordinates[5];
+            double previousX = record.coordinates[0];
+            double previousY = record.coordinates[1];
+
+            for(unsigned int i = 1; i <= record.numSegments; i++)
+            {
+                double xPoint, yPoint;
+
+                if(i == record.numSegments)
+                {
+                    xPoint = record.coordinates[2];
+                    yPoint = record.coordinates[3];
+                }
+                else
+                {
+                    double tempDistance = xDistance * cosAngle + yDistance * sinAngle;
+                    yDistance = -xDistance * sinAngle + yDistance * cosAngle;
+                    xDistance = tempDistance;
+                    xPoint = xDistance + record.coordinates[4];
+                    yPoint = yDistance + record.coordinates[5];
+                }
+
+                p_arcBatch.setVertex(record.offset + 2 * (i - 1), previousX, previousY, color);
+                p_arcBatch.setVertex(record.offset + 2 * (i - 1) + 1, xPoint, yPoint, color);
+
+                previousX = xPoint;
+                previousY = yPoint;
+            }
+        }
+
+        p_arcRecords[arcIterator] = record;
+
+        std::vector<GLuint> &indices = record.isHidden ? p_hiddenArcIndices : p_solidArcIndices;
+        for(size_t i = 0; i < numberOfVertices; i++)
+            indices.push_back((GLuint)(record.offset + i));
+    }
+}
+
+
+
+void geometryRenderer::compactSlots(geometryEditor2D &editor)
+{
+    /* Slots of geometry that was deleted are never reused unless the colony places a new object at the same
+     * address. So, once there are a lot more slots then geometry, everything is cleared and the slots are
+     * handed out again as the geometry comes into view
+     */
+    if(p_nodeSlots.size() > 2 * editor.getNodeList()->size() + 1024)
+    {
+        p_nodeSlots.clear();
+        p_nodeBatch.resize(0);
+    }
+
+    if(p_blockLabelSlots.size() > 2 * editor.getBlockLabelList()->size() + 1024)
+    {
+        p_blockLabelSlots.clear();
+        p_blockLabelBatch.resize(0);
+    }
+
+    if(p_lineRecords.size() > 2 * editor.getLineList()->size() + 1024)
+    {
+        p_lineRecords.clear();
+        p_lineBatch.resize(0);
+    }
+
+    if(p_arcRecords.size() > 2 * editor.getArcList()->size() + 1024 || p_arcBatch.size() > 4 * p_maxArcSegments * (editor.getArcList()->size() + 16))
+    {
+        p_arcRecords.clear();
+        p_arcBatch.resize(0);
+    }
+}
+
+
+
+void geometryRenderer::drawPoints(vertexBatch &batch, std::vector<GLuint> &indices)
+{
+    if(indices.size() == 0)
+        return;
+
+    batch.upload(p_useBuffers);
+
+    glPointSize(6.0);
+    batch.bind(p_useBuffers, true);
+    glDrawElements(GL_POINTS, (GLsizei)indices.size(), GL_UNSIGNED_INT, &indices[0]);
+
+    glColor3d(1.0, 1.0, 1.0);
+    glPointSize(4.25);
+    batch.bind(p_useBuffers, false);
+    glDrawElements(GL_POINTS, (GLsizei)indices.size(), GL_UNSIGNED_INT, &indices[0]);
+}
+
+
+
+void geometryRenderer::drawEdges(vertexBatch &batch, std::vector<GLuint> &solidIndices, std::vector<GLuint> &hiddenIndices)
+{
+    if(solidIndices.size() == 0 && hiddenIndices.size() == 0)
+        return;
+
+    batch.upload(p_useBuffers);
+    batch.bind(p_useBuffers, true);
+
+    if(solidIndices.size() > 0)
+        glDrawElements(GL_LINES, (GLsizei)solidIndices.size(), GL_UNSIGNED_INT, &solidIndices[0]);
+
+    if(hiddenIndices.size() > 0)
+    {
+        glEnable(GL_LINE_STIPPLE);
+        glLineStipple(1, 0b0001100011000110);
+        glDrawElements(GL_LINES, (GLsizei)hiddenIndices.size(), GL_UNSIGNED_INT, &hiddenIndices[0]);
+        glDisable(GL_LINE_STIPPLE);
+    }
+}
+
+
+
+void geometryRenderer::draw(geometryEditor2D &editor, boundingBox viewBox, double pixelSize)
+{
+    const GLubyte nodeColor[4] = {0, 0, 0, 255};
+    const GLubyte blockLabelColor[4] = {0, 0, 255, 255};
+
+    // If the buffers are not supported, the client side arrays are used
+    p_useBuffers = vertexBatch::isBufferSupported();
+
+    // The arcs need to be tessellated again if the zoom changes enough to change the number of segments
+    p_pixelSize = pixelSize;
+
+    // The view is grown by the size of a point so that a node on the edge of the screen is still drawn
+    viewBox.addPoint(wxRealPoint(viewBox.getMinBounds().x - p_pointSize * pixelSize, viewBox.getMinBounds().y - p_pointSize * pixelSize));
+    viewBox.addPoint(wxRealPoint(viewBox.getMaxBounds().x + p_pointSize * pixelSize, viewBox.getMaxBounds().y + p_pointSize * pixelSize));
+
+    compactSlots(editor);
+
+    p_linesInView.clear();
+    p_arcsInView.clear();
+    p_nodesInView.clear();
+    p_blockLabelsInView.clear();
+
+    editor.queryLines(viewBox, p_linesInView);
+    editor.queryArcs(viewBox, p_arcsInView);
+    editor.queryNodes(viewBox, p_nodesInView);
+    editor.queryBlockLabels(viewBox, p_blockLabelsInView);
+
+    updateLines(viewBox);
+    updateArcs(viewBox);
+    updatePoints(p_nodesInView, viewBox, p_nodeSlots, p_nodeBatch, p_nodeIndices, nodeColor);
+    updatePoints(p_blockLabelsInView, viewBox, p_blockLabelSlots, p_blockLabelBatch, p_blockLabelIndices, blockLabelColor);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+
+    glLineWidth(2.0);
+    drawEdges(p_lineBatch, p_solidLineIndices, p_hiddenLineIndices);
+    glLineWidth(0.5);
+
+    drawEdges(p_arcBatch, p_solidArcIndices, p_hiddenArcIndices);
+
+    drawPoints(p_nodeBatch, p_nodeIndices);
+    drawPoints(p_blockLabelBatch, p_blockLabelIndices);
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    if(p_useBuffers)
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glColor3d(0.0, 0.0, 0.0);
+}
+
+
+
+void geometryRenderer::invalidate()
+{
+    p_nodeSlots.clear();
+    p_blockLabelSlots.clear();
+    p_lineRecords.clear();
+    p_arcRecords.clear();
+
+    p_nodeBatch.resize(0);
+    p_blockLabelBatch.resize(0);
+    p_lineBatch.resize(0);
+    p_arcBatch.resize(0);
+}
+
+
+
+void geometryRenderer::releaseBuffers()
+{
+    p_nodeBatch.releaseBuffer();
+    p_blockLabelBatch.releaseBuffer();
+    p_lineBatch.releaseBuffer();
+    p_arcBatch.releaseBuffer();
+}
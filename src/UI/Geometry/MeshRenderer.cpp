@@ -0,0 +1,153 @@
+#include <UI/ModelDefinition/MeshRenderer.h>
+#include <unordered_map>
+#include <algorithm>
+
+
+void meshRenderer::build(GModel *mesh)
+{
+    const GLubyte meshColor[4] = {0, 255, 0, 255};
+    std::vector<GEntity*> entityList;
+    std::unordered_map<MVertex*, GLuint> vertexIndex;
+    std::vector<unsigned long long> edgeKeys;
+    size_t numberOfVertices = 0;
+
+    p_vertexBatch.resize(0);
+    p_edgeIndices.clear();
+
+    vertexIndex.reserve(mesh->getNumMeshVertices());
+    mesh->getEntities(entityList, 4);
+
+    for(unsigned int i = 0; i < entityList.size(); i++)
+    {
+        for(unsigned int j = 0; j < entityList[i]->getNumMeshElements(); j++)
+        {
+            MElement *element = entityList[i]->getMeshElement(j);
+            int numberOfCorners = element->getNumPrimaryVertices();
+            GLuint cornerIndex[8];
+
+            // Points do not have any edges. Only the corners are needed for the edges of the higher order elements
+            if(numberOfCorners < 2 || numberOfCorners > 8)
+                continue;
+
+            for(int k = 0; k < numberOfCorners; k++)
+            {
+                MVertex *vertex = element->getVertex(k);
+                std::unordered_map<MVertex*, GLuint>::iterator foundVertex = vertexIndex.find(vertex);
+
+                if(foundVertex == vertexIndex.end())
+                {
+                    p_vertexBatch.resize(numberOfVertices + 1);
+                    p_vertexBatch.setVertex(numberOfVertices, vertex->x(), vertex->y(), meshColor);
+                    vertexIndex[vertex] = (GLuint)numberOfVertices;
+                    cornerIndex[k] = (GLuint)numberOfVertices;
+                    numberOfVertices++;
+                }
+                else
+                    cornerIndex[k] = foundVertex->second;
+            }
+
+            // A line element has one edge. Every other element is a loop through the corners
+            int numberOfEdges = (numberOfCorners == 2) ? 1 : numberOfCorners;
+            for(int k = 0; k < numberOfEdges; k++)
+            {
+                GLuint firstIndex = cornerIndex[k];
+                GLuint secondIndex = cornerIndex[(k + 1) % numberOfCorners];
+
+                if(firstIndex > secondIndex)
+                    std::swap(firstIndex, secondIndex);
+
+                edgeKeys.push_back(((unsigned long long)firstIndex << 32) | (unsigned long long)secondIndex);
+            }
+        }
+    }
+
+    // An edge that is shared by two elements (or by an element and a boundary line) is only drawn once
+    std::sort(edgeKeys.begin(), edgeKeys.end());
+    edgeKeys.erase(std::unique(edgeKeys.begin(), edgeKeys.end()), edgeKeys.end());
+
+    p_edgeIndices.reserve(2 * edgeKeys.size());
+    for(std::vector<unsigned long long>::iterator keyIterator = edgeKeys.begin(); keyIterator != edgeKeys.end(); ++keyIterator)
+    {
+        p_edgeIndices.push_back((GLuint)(*keyIterator >> 32));
+        p_edgeIndices.push_back((GLuint)(*keyIterator & 0xFFFFFFFFULL));
+    }
+
+    p_mesh = mesh;
+    p_isValid = true;
+    p_indicesNeedUpload = true;
+}
+
+
+
+void meshRenderer::setEdges(GModel *mesh, const double *xCoordinates, const double *yCoordinates, size_t numberOfVertices, const GLuint *edgeIndices, size_t numberOfEdges)
+{
+    const GLubyte meshColor[4] = {0, 255, 0, 255};
+
+    p_vertexBatch.resize(numberOfVertices);
+
+    for(size_t i = 0; i < numberOfVertices; i++)
+        p_vertexBatch.setVertex(i, xCoordinates[i], yCoordinates[i], meshColor);
+
+    p_edgeIndices.assign(edgeIndices, edgeIndices + 2 * numberOfEdges);
+
+    p_mesh = mesh;
+    p_isValid = true;
+    p_indicesNeedUpload = true;
+}
+
+
+
+void meshRenderer::draw(GModel *mesh)
+{
+    if(!mesh)
+        return;
+
+    if(!p_isValid || mesh != p_mesh)
+        build(mesh);
+
+    if(p_edgeIndices.size() == 0)
+        return;
+
+    bool useBuffers = vertexBatch::isBufferSupported();
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+
+    p_vertexBatch.upload(useBuffers);
+    p_vertexBatch.bind(useBuffers, false);
+
+    if(useBuffers)
+    {
+        if(p_indexBufferID == 0)
+            glGenBuffers(1, &p_indexBufferID);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, p_indexBufferID);
+
+        if(p_indicesNeedUpload)
+        {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, p_edgeIndices.size() * sizeof(GLuint), &p_edgeIndices[0], GL_STATIC_DRAW);
+            p_indicesNeedUpload = false;
+        }
+
+        glDrawElements(GL_LINES, (GLsizei)p_edgeIndices.size(), GL_UNSIGNED_INT, NULL);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else
+        glDrawElements(GL_LINES, (GLsizei)p_edgeIndices.size(), GL_UNSIGNED_INT, &p_edgeIndices[0]);
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+
+
+void meshRenderer::releaseBuffers()
+{
+    p_vertexBatch.releaseBuffer();
+
+    if(p_indexBufferID != 0)
+        glDeleteBuffers(1, &p_indexBufferID);
+
+    p_indexBufferID = 0;
+    p_indicesNeedUpload = true;
+}
@@ -33,7 +33,7 @@ modelDefinition::modelDefinition(wxWindow *par, const wxPoint &point, const wxSi
     
     glMatrixMode(GL_MODELVIEW);
         
-    _fontRender = new OGLFT::Grayscale("/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf", 8);
+    _fontRender = new OGLFT::GlyphAtlas("/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf", 8);
 }
 
 
@@ -68,7 +68,7 @@ void modelDefinition::deleteSelection()
             
             if(nodeIterator == _editor.getNodeList()->back())
             {
-                _editor.getNodeList()->erase(nodeIterator);
+                _editor.eraseNode(nodeIterator);
                 break;
             }
             else
@@ -81,7 +81,7 @@ void modelDefinition::deleteSelection()
                 * The fix is to have the nodeIterator be incremented first and then pass in the value of nodeIterator before the increment.
                 * This way the nodeIterator will never be pointing to an invalidated element.
                 */ 
-                _editor.getNodeList()->erase(nodeIterator++);
+                _editor.eraseNode(nodeIterator++);
             }
 
             if(_editor.getNodeList()->size() == 0)
@@ -105,12 +105,12 @@ void modelDefinition::deleteSelection()
 			
             if(arcIterator == _editor.getArcList()->back())
             {
-                _editor.getArcList()->erase(arcIterator);
+                _editor.eraseArc(arcIterator);
 				
                 break;
             }
             else
-                _editor.getArcList()->erase(arcIterator++);
+                _editor.eraseArc(arcIterator++);
             
             if(_editor.getArcList()->size() == 0)
                 break;
@@ -138,11 +138,11 @@ void modelDefinition::deleteSelection()
              */ 
             if(lineIterator == _editor.getLineList()->back())
             {
-                _editor.getLineList()->erase(lineIterator);
+                _editor.eraseLine(lineIterator);
                 break;
             }
             else
-                _editor.getLineList()->erase(lineIterator++);
+                _editor.eraseLine(lineIterator++);
 			
             if(_editor.getLineList()->size() == 0)
                 break;
@@ -164,11 +164,11 @@ void modelDefinition::deleteSelection()
 			
             if(blockIterator == _editor.getBlockLabelList()->back())
             {
-                _editor.getBlockLabelList()->erase(blockIterator);
+                _editor.eraseBlockLabel(blockIterator);
                 break;
             }
             else
-                _editor.getBlockLabelList()->erase(blockIterator++);
+                _editor.eraseBlockLabel(blockIterator++);
 			
             if(_editor.getBlockLabelList()->size() == 0)
                 break;
@@ -797,17 +797,16 @@ void modelDefinition::moveTranslateSelection(double horizontalShift, double vert
             {
                 if(arcIterator->getFirstNode()->getIsSelectedState())
                 {
-                    arcIterator->getFirstNode()->moveCenter(horizontalShift, verticalShift);
+                    _editor.moveNode(*arcIterator->getFirstNode(), arcIterator->getFirstNode()->getCenterXCoordinate() + horizontalShift, arcIterator->getFirstNode()->getCenterYCoordinate() + verticalShift);
                     arcIterator->getFirstNode()->setSelectState(false);
                 }
                 
                 if(arcIterator->getSecondNode()->getIsSelectedState())
                 {
-                    arcIterator->getSecondNode()->moveCenter(horizontalShift, verticalShift);
+                    _editor.moveNode(*arcIterator->getSecondNode(), arcIterator->getSecondNode()->getCenterXCoordinate() + horizontalShift, arcIterator->getSecondNode()->getCenterYCoordinate() + verticalShift);
                     arcIterator->getSecondNode()->setSelectState(false);
                 }
                 arcIterator->setSelectState(false);
-                arcIterator->calculate(); // The center and radius of the arc will need to be recalculated after it is moved
             }
         }
         
@@ -819,13 +818,13 @@ void modelDefinition::moveTranslateSelection(double horizontalShift, double vert
             {
                 if(lineIterator->getFirstNode()->getIsSelectedState())
                 {
-                    lineIterator->getFirstNode()->moveCenter(horizontalShift, verticalShift);
+                    _editor.moveNode(*lineIterator->getFirstNode(), lineIterator->getFirstNode()->getCenterXCoordinate() + horizontalShift, lineIterator->getFirstNode()->getCenterYCoordinate() + verticalShift);
                     lineIterator->getFirstNode()->setSelectState(false);
                 }
                 
                 if(lineIterator->getSecondNode()->getIsSelectedState())
                 {
-                    lineIterator->getSecondNode()->moveCenter(horizontalShift, verticalShift);
+                    _editor.moveNode(*lineIterator->getSecondNode(), lineIterator->getSecondNode()->getCenterXCoordinate() + horizontalShift, lineIterator->getSecondNode()->getCenterYCoordinate() + verticalShift);
                     lineIterator->getSecondNode()->setSelectState(false);
                 }
                 lineIterator->setSelectState(false);
@@ -839,7 +838,7 @@ void modelDefinition::moveTranslateSelection(double horizontalShift, double vert
         {
             if(blockIterator->getIsSelectedState())
             {
-                blockIterator->moveCenter(horizontalShift, verticalShift);
+                _editor.moveBlockLabel(*blockIterator, blockIterator->getCenterXCoordinate() + horizontalShift, blockIterator->getCenterYCoordinate() + verticalShift);
                 blockIterator->setSelectState(false);
             }
         }
@@ -853,18 +852,9 @@ void modelDefinition::moveTranslateSelection(double horizontalShift, double vert
         if(nodeIterator->getIsSelectedState())
         {
             // Update the node with the translated coordinates
-            nodeIterator->moveCenter(horizontalShift, verticalShift);
+            _editor.moveNode(*nodeIterator, nodeIterator->getCenterXCoordinate() + horizontalShift, nodeIterator->getCenterYCoordinate() + verticalShift);
             nodeIterator->setSelectState(false);
         }
-        
-        // After moving the nodes, we need to then make sure all of the arcs have been updated with the new node positions
-        for(plf::colony<arcShape>::iterator arcIterator = _editor.getArcList()->begin(); arcIterator != _editor.getArcList()->end(); ++arcIterator)
-        {
-            if(*arcIterator->getFirstNode() == *nodeIterator || *arcIterator->getSecondNode() == *nodeIterator)
-            {
-                arcIterator->calculate(); // The center and radius of the arc will need to be recalculated after one of the nodes has moved
-            }
-        }
     }
     
     _labelsAreSelected = _editor.checkIntersections(EditGeometry::EDIT_ALL, getTolerance());
@@ -933,16 +923,15 @@ void modelDefinition::moveRotateSelection(double angularShift, wxRealPoint about
                 
                 if(arcIterator->getFirstNode()->getIsSelectedState())
                 {
-                    arcIterator->getFirstNode()->setCenter(horizontalShift1, verticalShift1);
+                    _editor.moveNode(*arcIterator->getFirstNode(), horizontalShift1, verticalShift1);
                     arcIterator->getFirstNode()->setSelectState(false);
                 }
                 
                 if(arcIterator->getSecondNode()->getIsSelectedState())
                 {
-                    arcIterator->getSecondNode()->setCenter(horizontalShift2, verticalShift2);
+                    _editor.moveNode(*arcIterator->getSecondNode(), horizontalShift2, verticalShift2);
                     arcIterator->getSecondNode()->setSelectState(false);
                 }
-                arcIterator->calculate();
                 arcIterator->setSelectState(false);
             }
         }
@@ -960,13 +949,13 @@ void modelDefinition::moveRotateSelection(double angularShift, wxRealPoint about
                 
                 if(lineIterator->getFirstNode()->getIsSelectedState())
                 {
-                    lineIterator->getFirstNode()->setCenter(horizontalShift1, verticalShift1);
+                    _editor.moveNode(*lineIterator->getFirstNode(), horizontalShift1, verticalShift1);
                     lineIterator->getFirstNode()->setSelectState(false);
                 }
                 
                 if(lineIterator->getSecondNode()->getIsSelectedState())
                 {
-                    lineIterator->getSecondNode()->setCenter(horizontalShift2, verticalShift2);
+                    _editor.moveNode(*lineIterator->getSecondNode(), horizontalShift2, verticalShift2);
                     lineIterator->getSecondNode()->setSelectState(false);
                 }
                 
@@ -984,7 +973,7 @@ void modelDefinition::moveRotateSelection(double angularShift, wxRealPoint about
                 double horizontalShift = (blockIterator->getCenterXCoordinate() - aboutPoint.x) * cos(-angularShift * PI / 180.0) + (blockIterator->getCenterYCoordinate() - aboutPoint.y) * sin(-angularShift * PI / 180.0) + aboutPoint.x;
                 double verticalShift = -(blockIterator->getCenterXCoordinate() - aboutPoint.x) * sin(-angularShift * PI / 180.0) + (blockIterator->getCenterYCoordinate() - aboutPoint.y) * cos(-angularShift * PI / 180.0) + aboutPoint.y;
             
-                blockIterator->setCenter(horizontalShift, verticalShift);
+                _editor.moveBlockLabel(*blockIterator, horizontalShift, verticalShift);
                 blockIterator->setSelectState(false);
             }   
         }
@@ -1001,18 +990,9 @@ void modelDefinition::moveRotateSelection(double angularShift, wxRealPoint about
             double verticalShift = -(nodeIterator->getCenterXCoordinate() - aboutPoint.x) * sin(-angularShift * PI / 180.0) + (nodeIterator->getCenterYCoordinate() - aboutPoint.y) * cos(-angularShift * PI / 180.0) + aboutPoint.y;
             
             // Update the node with the translated coordinates
-            nodeIterator->setCenter(horizontalShift, verticalShift);
+            _editor.moveNode(*nodeIterator, horizontalShift, verticalShift);
             nodeIterator->setSelectState(false);
         }
-        
-        // After moving the nodes, we need to then make sure all of the arcs have been updated with the new node positions
-        for(plf::colony<arcShape>::iterator arcIterator = _editor.getArcList()->begin(); arcIterator != _editor.getArcList()->end(); ++arcIterator)
-        {
-            if(*arcIterator->getFirstNode() == *nodeIterator || *arcIterator->getSecondNode() == *nodeIterator)
-            {
-                arcIterator->calculate(); // The center and radius of the arc will need to be recalculated after one of the nodes has moved
-            }
-        }
     }
     
     _labelsAreSelected = _editor.checkIntersections(EditGeometry::EDIT_ALL, getTolerance());
@@ -1041,22 +1021,13 @@ void modelDefinition::scaleSelection(double scalingFactor, wxRealPoint basePoint
         {
             if(nodeIterator->getIsSelectedState())
             {
-                nodeIterator->setCenter(basePoint.x + scalingFactor * (nodeIterator->getCenterXCoordinate() - basePoint.x), basePoint.y + scalingFactor * (nodeIterator->getCenterYCoordinate() - basePoint.y));
+                _editor.moveNode(*nodeIterator, basePoint.x + scalingFactor * (nodeIterator->getCenterXCoordinate() - basePoint.x), basePoint.y + scalingFactor * (nodeIterator->getCenterYCoordinate() - basePoint.y));
                 nodeIterator->setSelectState(false);
             }
         }
         
         _nodesAreSelected = false;
         
-        if(_arcsAreSelected)
-        {
-            // After moving the nodes, we need to then make sure all of the arcs have been updated with the new node positions
-            for(plf::colony<arcShape>::iterator arcIterator = _editor.getArcList()->begin(); arcIterator != _editor.getArcList()->end(); ++arcIterator)
-            {
-                arcIterator->calculate(); // The center and radius of the arc will need to be recalculated after one of the nodes has moved
-            } 
-        }
-        
         // TODO: insert a function to check for any intersections and valid points here
         
         this->Refresh();
@@ -1068,7 +1039,7 @@ void modelDefinition::scaleSelection(double scalingFactor, wxRealPoint basePoint
         {
             if(blockIterator->getIsSelectedState())
             {
-                blockIterator->setCenter(basePoint.x + scalingFactor * (blockIterator->getCenterXCoordinate() - basePoint.x), basePoint.y + scalingFactor * (blockIterator->getCenterYCoordinate() - basePoint.y));
+                _editor.moveBlockLabel(*blockIterator, basePoint.x + scalingFactor * (blockIterator->getCenterXCoordinate() - basePoint.x), basePoint.y + scalingFactor * (blockIterator->getCenterYCoordinate() - basePoint.y));
                 blockIterator->setSelectState(false);
             }
         }
@@ -2708,63 +2679,35 @@ void modelDefinition::onPaintCanvas(wxPaintEvent &event)
 		glPointSize(1.5); // Set the point size first
 		glLineWidth(1.0);
 
-		std::vector<GEntity*> entityList;
-		p_modelMesh->getEntities(entityList, 4);
-		
-		glBegin(GL_LINES);
-			int numOfElements = 0;
-			for(unsigned int i = 0; i < entityList.size(); i++)
-			{
-				for(unsigned int j = 0; j < entityList[i]->getNumMeshElements(); j++)
-				{
-					numOfElements++;
-					unsigned int loopCount = 0;
-					int verticeCount = entityList[i]->getMeshElement(j)->getNumVertices();
-					
-					if(verticeCount == 2 || verticeCount == 3)
-						loopCount = 1;
-					else if(verticeCount == 4 || verticeCount == 9)
-						loopCount = 3;
-						
-					for(unsigned int k = 0; k < loopCount; k++)
-					{
-						glVertex2d(entityList[i]->getMeshElement(j)->getVertex(k)->x(), entityList[i]->getMeshElement(j)->getVertex(k)->y());
-						glVertex2d(entityList[i]->getMeshElement(j)->getVertex(k + 1)->x(), entityList[i]->getMeshElement(j)->getVertex(k + 1)->y());
-					}
-					
-					glVertex2d(entityList[i]->getMeshElement(j)->getVertex(0)->x(), entityList[i]->getMeshElement(j)->getVertex(0)->y());
-					glVertex2d(entityList[i]->getMeshElement(j)->getVertex(loopCount)->x(), entityList[i]->getMeshElement(j)->getVertex(loopCount)->y());
-				}
-			}
-
-        glEnd();
+		// The edges of the mesh are only collected again when the mesh changes
+		p_meshRenderer.draw(p_modelMesh);
 	}
     
-    for(plf::colony<edgeLineShape>::iterator lineIterator = _editor.getLineList()->begin(); lineIterator != _editor.getLineList()->end(); ++lineIterator)
-    {
-        lineIterator->draw();
-    }
+    /* The lines, arcs, nodes, and block labels are drawn from vertex buffers. Only the geometry that is within the
+     * view is updated and drawn. The size of a pixel is used to determine how many segments an arc needs
+     */
+    boundingBox viewBox(wxRealPoint(convertToXCoordinate(0), convertToYCoordinate(0)));
+    viewBox.addPoint(wxRealPoint(convertToXCoordinate(this->GetSize().GetWidth()), convertToYCoordinate(this->GetSize().GetHeight())));
     
-    for(plf::colony<arcShape>::iterator arcIterator = _editor.getArcList()->begin(); arcIterator != _editor.getArcList()->end(); ++arcIterator)
-    {
-        arcIterator->draw();
-    }
+    p_geometryRenderer.draw(_editor, viewBox, (2.0 * _zoomY) / (double)this->GetSize().GetHeight());
     
-    for(plf::colony<node>::iterator nodeIterator = _editor.getNodeList()->begin(); nodeIterator != _editor.getNodeList()->end(); ++nodeIterator)
-    {
-        nodeIterator->draw();
-    }
+    // The material is written above and to the right of the block label and the circuit below and to the right
+    const double textOffset = 0.02 * (_zoomX + _zoomY) / 2.0;
     
-    for(plf::colony<blockLabel>::iterator blockIterator = _editor.getBlockLabelList()->begin(); blockIterator != _editor.getBlockLabelList()->end(); ++blockIterator)
+    for(std::vector<blockLabel*>::iterator blockIterator = p_geometryRenderer.getBlockLabelsInView()->begin(); blockIterator != p_geometryRenderer.getBlockLabelsInView()->end(); ++blockIterator)
     {
-        blockIterator->draw();
-        if(_preferences.getShowBlockNameState() && !blockIterator->getDraggingState())
+        if(_preferences.getShowBlockNameState() && !(*blockIterator)->getDraggingState())
         {
-            blockIterator->drawBlockName(_fontRender, (_zoomX + _zoomY) / 2.0);
-            if(_localDefinition->getPhysicsProblem() == physicProblems::PROB_MAGNETICS)
-                blockIterator->drawCircuitName(_fontRender, (_zoomX + _zoomY) / 2.0);
+            blockProperty *property = (*blockIterator)->getProperty();
+            
+            _fontRender->add((*blockIterator)->getCenterXCoordinate() + textOffset, (*blockIterator)->getCenterYCoordinate() + textOffset, property->getMaterialName().c_str());
+            if(_localDefinition->getPhysicsProblem() == physicProblems::PROB_MAGNETICS && property->getCircuitName() != "None")
+                _fontRender->add((*blockIterator)->getCenterXCoordinate() + textOffset, (*blockIterator)->getCenterYCoordinate() - textOffset, property->getCircuitName().c_str());
         }
     }
+    
+    // All of the names are drawn from the glyph atlas with one call
+    _fontRender->draw();
 
     if(_doZoomWindow || _doSelectionWindow)// We are going to be drawing the same thing for this one
     {
@@ -2945,6 +2888,7 @@ void modelDefinition::onMouseMove(wxMouseEvent &event)
                     if(_preferences.getSnapGridState())
                         roundToNearestGrid(tempX, tempY);
                     _editor.getLastNodeAdd()->setCenter(tempX, tempY);
+                    _editor.updateSpatialIndex(*_editor.getLastNodeAdd());
                 }
             }
             else if(!_createNodes)
@@ -2956,6 +2900,7 @@ void modelDefinition::onMouseMove(wxMouseEvent &event)
                     if(_preferences.getSnapGridState())
                         roundToNearestGrid(tempX, tempY);
                     _editor.getLastBlockLabelAdded()->setCenter(tempX, tempY);
+                    _editor.updateSpatialIndex(*_editor.getLastBlockLabelAdded());
                 }
             }
         }
@@ -3156,7 +3101,7 @@ void modelDefinition::onMouseLeftUp(wxMouseEvent &event)
                 if(_preferences.getSnapGridState())
                     roundToNearestGrid(tempX, tempY);
                     
-                _editor.getNodeList()->erase(_editor.getLastNodeAdd());
+                _editor.eraseNode(_editor.getLastNodeAdd());
                 _editor.addNode(tempX, tempY, getTolerance() / 8.0);
 				
 				deleteMesh();
@@ -3174,7 +3119,7 @@ void modelDefinition::onMouseLeftUp(wxMouseEvent &event)
 
                 if(_editor.getLastBlockLabelAdded()->getDraggingState())
                 {
-                    _editor.getBlockLabelList()->erase(_editor.getLastBlockLabelAdded()); 
+                    _editor.eraseBlockLabel(_editor.getLastBlockLabelAdded());
                     _editor.addBlockLabel(tempX, tempY, getTolerance() / 10);
                 }
                 
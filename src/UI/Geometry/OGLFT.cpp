@@ -3858,4 +3858,332 @@ namespace OGLFT {
     delete[] inverted_pixmap;
   }
 
+
+  // The glyph atlas keeps every glyph that has been seen in one alpha texture
+  // and draws all of the queued strings as textured quads in one call.
+
+  GlyphAtlas::GlyphAtlas ( const char* filename, float point_size,
+			   FT_UInt resolution )
+    : face_( 0 ), valid_( true ), atlas_width_( 256 ), atlas_height_( 256 ),
+      shelf_x_( 0 ), shelf_y_( 0 ), shelf_height_( 0 ), texture_( 0 ),
+      texture_dirty_( true )
+  {
+    FT_Error error = FT_New_Face( Library::instance(), filename, 0, &face_ );
+
+    if ( error != 0 ) {
+      face_ = 0;
+      valid_ = false;
+      return;
+    }
+
+    if ( face_->charmap == 0 && face_->num_charmaps > 0 )
+      FT_Select_Charmap( face_, face_->charmaps[0]->encoding );
+
+    init( point_size, resolution );
+  }
+
+  GlyphAtlas::~GlyphAtlas ( void )
+  {
+    if ( face_ != 0 )
+      FT_Done_Face( face_ );
+  }
+
+  void GlyphAtlas::init ( float point_size, FT_UInt resolution )
+  {
+    for ( int i = 0; i < 256; i++ )
+      glyphs_[i].cached_ = false;
+
+    foreground_color_[R] = 0.;
+    foreground_color_[G] = 0.;
+    foreground_color_[B] = 0.;
+    foreground_color_[A] = 1.;
+
+    pixels_.assign( atlas_width_ * atlas_height_, 0 );
+
+    FT_Error error = FT_Set_Char_Size( face_,
+				       (FT_F26Dot6)( point_size * 64 ),
+				       (FT_F26Dot6)( point_size * 64 ),
+				       resolution, resolution );
+    if ( error != 0 )
+      valid_ = false;
+  }
+
+  void GlyphAtlas::setForegroundColor ( GLfloat red, GLfloat green,
+					GLfloat blue, GLfloat alpha )
+  {
+    foreground_color_[R] = red;
+    foreground_color_[G] = green;
+    foreground_color_[B] = blue;
+    foreground_color_[A] = alpha;
+  }
+
+  // Rasterize a character and pack it onto the current shelf of the atlas.
+  // When the shelf is full, a new shelf is started below it and when the
+  // atlas is full, it is doubled in height. Since the width never changes,
+  // growing the atlas does not move any of the glyphs already in it.
+
+  bool GlyphAtlas::cacheGlyph ( unsigned char c )
+  {
+    GlyphData& glyph = glyphs_[c];
+
+    if ( glyph.cached_ )
+      return true;
+
+    FT_UInt glyph_index = FT_Get_Char_Index( face_, c );
+
+    FT_Error error = FT_Load_Glyph( face_, glyph_index, FT_LOAD_RENDER );
+
+    if ( error != 0 )
+      return false;
+
+    FT_GlyphSlot slot = face_->glyph;
+    const FT_Bitmap& bitmap = slot->bitmap;
+
+    glyph.width_ = bitmap.width;
+    glyph.rows_ = bitmap.rows;
+    glyph.left_ = slot->bitmap_left;
+    glyph.top_ = slot->bitmap_top;
+    glyph.advance_ = slot->advance.x / 64;
+    glyph.x_ = 0;
+    glyph.y_ = 0;
+
+    // A space does not have an image so only the advance is needed
+    if ( glyph.width_ > 0 && glyph.rows_ > 0 && glyph.width_ + 1 <= atlas_width_ ) {
+      if ( shelf_x_ + glyph.width_ + 1 > atlas_width_ ) {
+	shelf_x_ = 0;
+	shelf_y_ += shelf_height_;
+	shelf_height_ = 0;
+      }
+
+      while ( shelf_y_ + glyph.rows_ + 1 > atlas_height_ )
+	growAtlas();
+
+      glyph.x_ = shelf_x_;
+      glyph.y_ = shelf_y_;
+
+      for ( int r = 0; r < glyph.rows_; r++ ) {
+	const unsigned char* source = &bitmap.buffer[bitmap.pitch * r];
+	GLubyte* destination = &pixels_[( glyph.y_ + r ) * atlas_width_ + glyph.x_];
+
+	for ( int p = 0; p < glyph.width_; p++ )
+	  destination[p] = source[p];
+      }
+
+      // Leave a one pixel gap so that neighboring glyphs do not bleed
+      shelf_x_ += glyph.width_ + 1;
+
+      if ( glyph.rows_ + 1 > shelf_height_ )
+	shelf_height_ = glyph.rows_ + 1;
+
+      texture_dirty_ = true;
+    }
+    else {
+      glyph.width_ = 0;
+      glyph.rows_ = 0;
+    }
+
+    glyph.cached_ = true;
+
+    return true;
+  }
+
+  void GlyphAtlas::growAtlas ( void )
+  {
+    atlas_height_ *= 2;
+    pixels_.resize( atlas_width_ * atlas_height_, 0 );
+    texture_dirty_ = true;
+  }
+
+  void GlyphAtlas::uploadTexture ( void )
+  {
+    if ( texture_ == 0 ) {
+      glGenTextures( 1, &texture_ );
+      texture_dirty_ = true;
+    }
+
+    glBindTexture( GL_TEXTURE_2D, texture_ );
+
+    if ( texture_dirty_ ) {
+      glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+      glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP );
+
+      glTexImage2D( GL_TEXTURE_2D, 0, GL_ALPHA, atlas_width_, atlas_height_,
+		    0, GL_ALPHA, GL_UNSIGNED_BYTE, &pixels_[0] );
+
+      texture_dirty_ = false;
+    }
+  }
+
+  void GlyphAtlas::add ( GLdouble x, GLdouble y, const char* s, GLfloat dx,
+			 GLfloat dy )
+  {
+    if ( !valid_ || s == 0 || *s == '\0' )
+      return;
+
+    StringData string;
+
+    string.x_ = x;
+    string.y_ = y;
+    string.dx_ = dx;
+    string.dy_ = dy;
+    string.begin_ = text_.size();
+
+    for ( const char* c = s; *c != '\0'; c++ ) {
+      unsigned char character = (unsigned char)*c;
+
+      if ( cacheGlyph( character ) )
+	text_.push_back( character );
+    }
+
+    string.end_ = text_.size();
+
+    if ( string.end_ > string.begin_ )
+      strings_.push_back( string );
+  }
+
+  void GlyphAtlas::draw ( void )
+  {
+    if ( strings_.empty() ) {
+      text_.clear();
+      return;
+    }
+
+    GLint viewport[4];
+    GLdouble modelview[16], projection[16];
+
+    glGetIntegerv( GL_VIEWPORT, viewport );
+    glGetDoublev( GL_MODELVIEW_MATRIX, modelview );
+    glGetDoublev( GL_PROJECTION_MATRIX, projection );
+
+    // The anchors are projected to the window once here instead of using
+    // gluProject for every string.
+
+    GLdouble transform[16];
+
+    for ( int i = 0; i < 4; i++ )
+      for ( int j = 0; j < 4; j++ )
+	transform[j * 4 + i] = projection[i] * modelview[j * 4]
+	  + projection[4 + i] * modelview[j * 4 + 1]
+	  + projection[8 + i] * modelview[j * 4 + 2]
+	  + projection[12 + i] * modelview[j * 4 + 3];
+
+    GLfloat line_height = face_->size->metrics.height / 64.f;
+    GLfloat s_scale = 1.f / atlas_width_;
+    GLfloat t_scale = 1.f / atlas_height_;
+
+    vertices_.clear();
+    vertices_.reserve( 16 * text_.size() );
+
+    for ( std::vector<StringData>::const_iterator string = strings_.begin();
+	  string != strings_.end(); ++string ) {
+      GLdouble clip_x = transform[0] * string->x_ + transform[4] * string->y_ + transform[12];
+      GLdouble clip_y = transform[1] * string->x_ + transform[5] * string->y_ + transform[13];
+      GLdouble clip_w = transform[3] * string->x_ + transform[7] * string->y_ + transform[15];
+
+      if ( clip_w == 0. )
+	continue;
+
+      // Snap the origin of the string to a pixel so that the glyphs are
+      // drawn exactly as they were rasterized.
+
+      GLfloat pen_x = std::floor( viewport[0] + ( clip_x / clip_w + 1. ) * viewport[2] / 2.
+				  + string->dx_ + 0.5 );
+      GLfloat pen_y = std::floor( viewport[1] + ( clip_y / clip_w + 1. ) * viewport[3] / 2.
+				  + string->dy_ + 0.5 );
+
+      // Strings that start above, below, or right of the window cannot
+      // be seen.
+      if ( pen_x > viewport[0] + viewport[2] || pen_y < viewport[1] - line_height
+	   || pen_y > viewport[1] + viewport[3] + line_height )
+	continue;
+
+      for ( size_t c = string->begin_; c < string->end_; c++ ) {
+	const GlyphData& glyph = glyphs_[text_[c]];
+
+	if ( glyph.width_ > 0 ) {
+	  GLfloat x0 = pen_x + glyph.left_;
+	  GLfloat x1 = x0 + glyph.width_;
+	  GLfloat y1 = pen_y + glyph.top_;
+	  GLfloat y0 = y1 - glyph.rows_;
+	  GLfloat s0 = glyph.x_ * s_scale;
+	  GLfloat s1 = ( glyph.x_ + glyph.width_ ) * s_scale;
+	  GLfloat t0 = glyph.y_ * t_scale;
+	  GLfloat t1 = ( glyph.y_ + glyph.rows_ ) * t_scale;
+
+	  GLfloat quad[16] = { x0, y0, s0, t1,
+			       x1, y0, s1, t1,
+			       x1, y1, s1, t0,
+			       x0, y1, s0, t0 };
+
+	  vertices_.insert( vertices_.end(), quad, quad + 16 );
+	}
+
+	pen_x += glyph.advance_;
+      }
+    }
+
+    strings_.clear();
+    text_.clear();
+
+    if ( vertices_.empty() )
+      return;
+
+    glPushAttrib( GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TEXTURE_BIT
+		  | GL_CURRENT_BIT );
+    glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT | GL_CLIENT_PIXEL_STORE_BIT );
+
+    glEnable( GL_TEXTURE_2D );
+    uploadTexture();
+    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+
+    glEnable( GL_BLEND );
+    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+
+    glColor4f( foreground_color_[R], foreground_color_[G], foreground_color_[B],
+	       foreground_color_[A] );
+
+    // The quads are in window pixels
+
+    glMatrixMode( GL_PROJECTION );
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho( viewport[0], viewport[0] + viewport[2],
+	     viewport[1], viewport[1] + viewport[3], -1., 1. );
+
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix();
+    glLoadIdentity();
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    glDisableClientState( GL_COLOR_ARRAY );
+
+    glVertexPointer( 2, GL_FLOAT, 4 * sizeof(GLfloat), &vertices_[0] );
+    glTexCoordPointer( 2, GL_FLOAT, 4 * sizeof(GLfloat), &vertices_[2] );
+
+    glDrawArrays( GL_QUADS, 0, (GLsizei)( vertices_.size() / 4 ) );
+
+    glPopMatrix();
+    glMatrixMode( GL_PROJECTION );
+    glPopMatrix();
+    glMatrixMode( GL_MODELVIEW );
+
+    glPopClientAttrib();
+    glPopAttrib();
+  }
+
+  void GlyphAtlas::releaseTexture ( void )
+  {
+    if ( texture_ != 0 )
+      glDeleteTextures( 1, &texture_ );
+
+    texture_ = 0;
+    texture_dirty_ = true;
+  }
+
 } // close OGLFT namespace
@@ -1,4 +1,5 @@
 #include "UI/OmniFEMFrame.h"
+#include "Mesh/meshMaker.h"
 
 
 void OmniFEMMainFrame::onViewResults(wxCommandEvent &event)
@@ -10,5 +11,127 @@ void OmniFEMMainFrame::onViewResults(wxCommandEvent &event)
 
 void OmniFEMMainFrame::onAnalyze(wxCommandEvent &event)
 {
-    
+	if(_model->getMeshModel()->getNumMeshVertices() == 0)
+	{
+		wxMessageBox("The geometry must be meshed before it can be analyzed", "Warning", wxICON_EXCLAMATION | wxOK);
+		return;
+	}
+	
+	OmniFEMMsg::instance()->displayWindow(Status_Windows::SOLVER_STATUS_WINDOW);
+	
+	// The adaptive refinement remeshes the geometry until the estimated error of the solution is below the tolerance of the mesh settings
+	const bool isAdaptive = _problemDefinition.getMeshSettingsPointer()->getAdaptiveRefinementState();
+	
+	// A mesh that was read from the mesh cache has no geometry to refine, so the geometry is meshed again first
+	if(isAdaptive && _model->isMeshRestored())
+	{
+		_model->deleteMesh();
+		meshMaker mesher(_problemDefinition, *_model->getGeometryEditor(), _model->getMeshModel());
+		mesher.mesh();
+		
+		if(!_model->checkModelIsValid())
+		{
+			wxMessageBox("The geometry could not be meshed again for the adaptive refinement", "Warning", wxICON_EXCLAMATION | wxOK);
+			return;
+		}
+	}
+	
+	if(_problemDefinition.getPhysicsProblem() == physicProblems::PROB_ELECTROSTATIC)
+	{
+		delete _electrostaticSolver;
+		
+		if(isAdaptive)
+		{
+			adaptiveRefinement refinement(_problemDefinition, _model->getMeshModel());
+			_electrostaticSolver = refinement.solveElectrostatic();
+		}
+		else
+		{
+			_electrostaticSolver = new electrostaticSolver(_problemDefinition, _model->getMeshModel());
+			
+			if(!_electrostaticSolver->solve())
+			{
+				delete _electrostaticSolver;
+				_electrostaticSolver = nullptr;
+			}
+		}
+	}
+	else if(_problemDefinition.getMagneticPreference().isTransient())
+	{
+		magneticPreference preferences = _problemDefinition.getMagneticPreference();
+		
+		// The sources of the transient problem follow sin(2 * pi * f * t) so there is nothing to step without a frequency
+		if(preferences.getFrequency() <= 0)
+		{
+			wxMessageBox("A transient problem needs a frequency greater than 0. Set it in the problem preferences", "Warning", wxICON_EXCLAMATION | wxOK);
+			return;
+		}
+		
+		if(isAdaptive)
+			OmniFEMMsg::instance()->MsgWarning("The adaptive refinement is only available for static problems. The problem is solved on the current mesh");
+		
+		delete _transientMagneticSolver;
+		_transientMagneticSolver = new transientMagneticSolver(_problemDefinition, _model->getMeshModel());
+		
+		// Every step is written next to a saved project as a .pvd collection so that the time series can be opened in ParaView
+		if(_saveFilePath != "")
+		{
+			std::string seriesPath = _saveFilePath;
+			
+			if(seriesPath.size() > 8 && seriesPath.substr(seriesPath.size() - 8) == ".omniFEM")
+				seriesPath = seriesPath.substr(0, seriesPath.size() - 8);
+				
+			_transientMagneticSolver->setSeriesOutput(seriesPath + "_transient", vtuWriter::canCompress());
+		}
+		
+		if(_transientMagneticSolver->solve(preferences.getTransientPeriods(), preferences.getTransientStepsPerPeriod()))
+		{
+			std::string unit = preferences.isAxistmmetric() ? " W" : " W/m";
+			OmniFEMMsg::instance()->MsgStatus("Hysteresis loss: " + std::to_string(_transientMagneticSolver->getHysteresisLoss()) + unit);
+			OmniFEMMsg::instance()->MsgStatus("Eddy current loss: " + std::to_string(_transientMagneticSolver->getEddyCurrentLoss()) + unit);
+		}
+		else
+		{
+			delete _transientMagneticSolver;
+			_transientMagneticSolver = nullptr;
+		}
+	}
+	else if(_problemDefinition.getMagneticPreference().getFrequency() != 0)
+	{
+		if(isAdaptive)
+			OmniFEMMsg::instance()->MsgWarning("The adaptive refinement is only available for static problems. The problem is solved on the current mesh");
+		
+		delete _harmonicMagneticSolver;
+		_harmonicMagneticSolver = new harmonicMagneticSolver(_problemDefinition, _model->getMeshModel());
+		
+		if(!_harmonicMagneticSolver->solve())
+		{
+			delete _harmonicMagneticSolver;
+			_harmonicMagneticSolver = nullptr;
+		}
+	}
+	else
+	{
+		delete _magnetostaticSolver;
+		
+		if(isAdaptive)
+		{
+			adaptiveRefinement refinement(_problemDefinition, _model->getMeshModel());
+			_magnetostaticSolver = refinement.solveMagnetostatic();
+		}
+		else
+		{
+			_magnetostaticSolver = new magnetostaticSolver(_problemDefinition, _model->getMeshModel());
+			
+			if(!_magnetostaticSolver->solve())
+			{
+				delete _magnetostaticSolver;
+				_magnetostaticSolver = nullptr;
+			}
+		}
+	}
+	
+	// The refinement replaced the mesh that is drawn
+	if(isAdaptive && _model->checkModelIsValid())
+		_model->Refresh();
 }
\ No newline at end of file
@@ -29,6 +29,7 @@
 
 
 #include <common/GridPreferences.h>
+#include <common/ProjectFile.h>
 #include <UI/GeometryEditor2D.h>
 
 
@@ -65,6 +66,14 @@ void OmniFEMMainFrame::onOpenFile(wxCommandEvent &event)
 		}
 		
 		_model->deleteMesh();	
+		delete _electrostaticSolver;
+		_electrostaticSolver = nullptr;
+		delete _magnetostaticSolver;
+		_magnetostaticSolver = nullptr;
+		delete _harmonicMagneticSolver;
+		_harmonicMagneticSolver = nullptr;
+		delete _transientMagneticSolver;
+		_transientMagneticSolver = nullptr;
 		_model->SetSize(this->GetClientSize() - wxSize(12, 12));
 		
 		wxString appendedTitle = "Omni-FEM - ";
@@ -151,55 +160,59 @@ void OmniFEMMainFrame::onSaveAs(wxCommandEvent &event)
 void OmniFEMMainFrame::save(string filePath)
 {
 	wxString pathName(filePath);
+	gridPreferences tempPreferences;
+	std::vector<double> tempSomething;
 	
 	if(!pathName.Contains(wxString(".omniFEM")))
 		pathName += wxString(".omniFEM");
 	
-	std::ofstream ofs(pathName.ToStdString());
+	// The geometry is written straight from the editor of the model so that it is not copied first
+	_model->getParameters(tempPreferences, tempSomething);
 	
-	if(ofs.is_open())// TODO: Check to see if is_open will return true if another program has the filde already opened
+	if(projectFile::write(pathName.ToStdString(), _problemDefinition, tempPreferences, *_model->getGeometryEditor(), tempSomething))
 	{
-		boost::archive::text_oarchive oa(ofs);
-		oa << _problemDefinition;
-		gridPreferences tempPreferences;
-		geometryEditor2D tempEditor;
-		std::vector<double> tempSomething;
-		_model->getParameters(tempPreferences, tempEditor, tempSomething);
-		//oa << _model;
-		oa << tempPreferences;
-		oa << tempEditor;
-		oa << tempSomething;
+		// The mesh is kept next to the project so that the project does not need to be meshed again when it is opened
+		if(_model->getMeshModel()->getNumMeshVertices() > 0)
+			meshCache::write(meshCache::getCachePath(pathName.ToStdString()), _model->getMeshModel(), _model->getMeshGeometryHash());
 	}
 	else
 	{
 		wxMessageBox("Please close all instances of the file before saving");
 	}
-	
-	ofs.close();
 }
 
 
 
 void OmniFEMMainFrame::load(string filePath)
 {
-	std::ifstream loadFile(filePath);
+	gridPreferences tempPreferences;
+	std::vector<double> tempSomething;
+	
+	// The geometry is read straight into the editor of the model so that it is not copied and rebuilt a second time
+	_model->getGeometryEditor()->clear();
 	
-	if(loadFile.is_open())
+	// Projects that were saved as a text archive are still read. They are written in the binary format the next time they are saved
+	if(projectFile::read(filePath, _problemDefinition, tempPreferences, *_model->getGeometryEditor(), tempSomething))
 	{
-		//modelDefinition temp(this, wxPoint(6, 6), this->GetClientSize(), _problemDefinition, this->GetStatusBar());
-		//modelDefinition tempDefintion = (*_model);
-		boost::archive::text_iarchive ia(loadFile);
-		gridPreferences tempPreferences;
-		geometryEditor2D tempEditor;
-		std::vector<double> tempSomething;
+		_model->setParameters(tempPreferences, tempSomething);
 		
-		ia >> _problemDefinition;
-		ia >> tempPreferences;
-		ia >> tempEditor;
-		ia >> tempSomething;
+		// The cached mesh is only used if it was made from the geometry that was just loaded
+		meshCache cache;
 		
-		_model->setParameters(tempPreferences, tempEditor, tempSomething);
+		if(cache.open(meshCache::getCachePath(filePath)))
+		{
+			if(cache.getGeometryHash() != meshCache::computeGeometryHash(*_model->getGeometryEditor()))
+				OmniFEMMsg::instance()->MsgStatus("The mesh cache is out of date. The geometry needs to be meshed again");
+			else if(_model->setAndDrawMesh(cache))
+				OmniFEMMsg::instance()->MsgStatus("Mesh loaded from the mesh cache: " + std::to_string(cache.getNumberOfNodes()) + " nodes, " + std::to_string(cache.getNumberOfElements()) + " elements");
+		}
 		
 		_model->Refresh();
 	}
+	else
+	{
+		// A project that failed part way through leaves geometry whose lines may not point to their nodes
+		_model->getGeometryEditor()->clear();
+		_model->Refresh();
+	}
 }
\ No newline at end of file
@@ -15,12 +15,27 @@ void OmniFEMMainFrame::onCreateMesh(wxCommandEvent &event)
 			{
 				if(_model->displayDanglingNodes() == 0)
 				{
+					// The results point into the old mesh
+					delete _electrostaticSolver;
+					_electrostaticSolver = nullptr;
+					delete _magnetostaticSolver;
+					_magnetostaticSolver = nullptr;
+					delete _harmonicMagneticSolver;
+					_harmonicMagneticSolver = nullptr;
+					delete _transientMagneticSolver;
+					_transientMagneticSolver = nullptr;
+					
 					_model->deleteMesh();
-					meshMaker mesher(_problemDefinition, _model);
+					meshMaker mesher(_problemDefinition, *_model->getGeometryEditor(), _model->getMeshModel());
 					OmniFEMMsg::instance()->displayWindow(Status_Windows::MESH_STATUS_WINDOW);
 					mesher.mesh();
 					if(_model->checkModelIsValid())
+					{
+						if(_saveFilePath != "")
+							meshCache::write(meshCache::getCachePath(_saveFilePath), _model->getMeshModel(), _model->getMeshGeometryHash());
+						
 						_model->Refresh();
+					}
 				}
 				else
 					wxMessageBox("Open boudnaries exist. Simulation must contain only closed boundaries", "Warning", wxICON_EXCLAMATION | wxOK);
@@ -49,6 +49,7 @@ jilesAthertonParameterDialog::jilesAthertonParameterDialog(wxWindow *par) : wxDi
     _isAnisotropyCheckBox->Create(this, generalFrameButton::ID_CHECKBOX1, "Anisotropy Material", wxPoint(47, 19), wxSize(135, 17));
     _isAnisotropyCheckBox->SetFont(*font);
     _isAnisotropyCheckBox->SetValue(false);
+    _isAnisotropyCheckBox->SetToolTip("The transient solver only uses the X parameters. The Y parameters are ignored and the material is solved as isotropic");
     
     headerSizer->Add(_isAnisotropyCheckBox, 0, wxALL, 6);
     
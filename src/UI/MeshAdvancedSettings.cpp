@@ -11,6 +11,9 @@ meshAdvanced::meshAdvanced(wxWindow *par, meshSettings &settings) : wxDialog(par
 	wxBoxSizer *multiplePassesSizer = new wxBoxSizer(wxHORIZONTAL);
 	wxBoxSizer *smoothingSizer = new wxBoxSizer(wxHORIZONTAL);
 	wxBoxSizer *meshFactorSizer = new wxBoxSizer(wxHORIZONTAL);
+	wxStaticBoxSizer *adaptiveSizer = new wxStaticBoxSizer(wxVERTICAL, this, "Adaptive Refinement");
+	wxBoxSizer *adaptiveToleranceSizer = new wxBoxSizer(wxHORIZONTAL);
+	wxBoxSizer *adaptivePassesSizer = new wxBoxSizer(wxHORIZONTAL);
 	wxStaticBoxSizer *meshFormatsSizer = new wxStaticBoxSizer(wxVERTICAL, this, "Mesh File Save Formats");
 	wxBoxSizer *meshDirSelectionSizer = new wxBoxSizer(wxHORIZONTAL);
 	wxBoxSizer *intermediateSizer = new wxBoxSizer(wxHORIZONTAL);
@@ -64,6 +67,37 @@ meshAdvanced::meshAdvanced(wxWindow *par, meshSettings &settings) : wxDialog(par
 	meshFactorSizer->Add(54, 0, 0);
 	meshFactorSizer->Add(p_factorTextCtrl, 0, wxCENTER | wxBOTTOM | wxRIGHT, 6);
 	
+	adaptiveSizer->GetStaticBox()->SetFont(font);
+	
+	p_adaptiveCheckBox->Create(adaptiveSizer->GetStaticBox(), wxID_ANY, "Refine the mesh from the error of the solution");
+	p_adaptiveCheckBox->SetFont(font);
+	p_adaptiveCheckBox->SetValue(p_meshSettings->getAdaptiveRefinementState());
+	
+	wxStaticText *adaptiveToleranceText = new wxStaticText(adaptiveSizer->GetStaticBox(), wxID_ANY, "Relative Energy Error: ");
+	adaptiveToleranceText->SetFont(font);
+	
+	p_adaptiveToleranceTextCtrl->Create(adaptiveSizer->GetStaticBox(), wxID_ANY, std::to_string(p_meshSettings->getAdaptiveTolerance()), wxDefaultPosition, wxDefaultSize, 0, doubleGreaterThenZeroVal);
+	p_adaptiveToleranceTextCtrl->SetValue(std::to_string(p_meshSettings->getAdaptiveTolerance()));
+	p_adaptiveToleranceTextCtrl->SetFont(font);
+	
+	adaptiveToleranceSizer->Add(adaptiveToleranceText, 0, wxCENTER | wxLEFT | wxRIGHT | wxBOTTOM, 6);
+	adaptiveToleranceSizer->Add(22, 0, 0);
+	adaptiveToleranceSizer->Add(p_adaptiveToleranceTextCtrl, 0, wxCENTER | wxBOTTOM | wxRIGHT, 6);
+	
+	wxStaticText *adaptivePassesText = new wxStaticText(adaptiveSizer->GetStaticBox(), wxID_ANY, "Maximum Solves: ");
+	adaptivePassesText->SetFont(font);
+	
+	p_adaptivePassesTextCtrl->Create(adaptiveSizer->GetStaticBox(), wxID_ANY, std::to_string(p_meshSettings->getAdaptivePasses()), wxDefaultPosition, wxDefaultSize, 0, greaterThenZeroVal);
+	p_adaptivePassesTextCtrl->SetFont(font);
+	
+	adaptivePassesSizer->Add(adaptivePassesText, 0, wxCENTER | wxLEFT | wxRIGHT | wxBOTTOM, 6);
+	adaptivePassesSizer->Add(51, 0, 0);
+	adaptivePassesSizer->Add(p_adaptivePassesTextCtrl, 0, wxCENTER | wxBOTTOM | wxRIGHT, 6);
+	
+	adaptiveSizer->Add(p_adaptiveCheckBox, 0, wxALL, 6);
+	adaptiveSizer->Add(adaptiveToleranceSizer);
+	adaptiveSizer->Add(adaptivePassesSizer);
+	
 	p_meshFileDirectory->Create(meshFormatsSizer->GetStaticBox(), wxID_APPLY, p_meshSettings->getDirString(), wxDefaultPosition, wxSize(275, 23), wxTE_PROCESS_ENTER);
 	p_meshFileDirectory->SetFont(font);
 	
@@ -189,6 +223,7 @@ meshAdvanced::meshAdvanced(wxWindow *par, meshSettings &settings) : wxDialog(par
 	topSizer->Add(multiplePassesSizer);
 	topSizer->Add(smoothingSizer);
 	topSizer->Add(meshFactorSizer);
+	topSizer->Add(adaptiveSizer, 0, wxLEFT | wxRIGHT | wxBOTTOM | wxEXPAND, 6);
 	topSizer->Add(meshFormatsSizer, 0, wxLEFT | wxRIGHT | wxBOTTOM, 6);
 	topSizer->Add(footerSizer, 0, wxALIGN_RIGHT);
 	
@@ -211,6 +246,14 @@ void meshAdvanced::setSettings()
 	p_factorTextCtrl->GetValue().ToDouble(&doubleValue);
 	p_meshSettings->setElementSizeFactor(doubleValue);
 	
+	p_meshSettings->setAdaptiveRefinementState(p_adaptiveCheckBox->GetValue());
+	
+	p_adaptiveToleranceTextCtrl->GetValue().ToDouble(&doubleValue);
+	p_meshSettings->setAdaptiveTolerance(doubleValue);
+	
+	p_adaptivePassesTextCtrl->GetValue().ToLong(&longValue);
+	p_meshSettings->setAdaptivePasses((unsigned int)longValue);
+	
 	p_meshSettings->setSaveVTKState(p_saveAsVTK->GetValue());
 	p_meshSettings->setSaveBDFState(p_saveAsBDF->GetValue());
 	p_meshSettings->setSaveCELUMState(p_saveAsCELUM->GetValue());
@@ -2,32 +2,74 @@
 
 OmniFEMMsg *OmniFEMMsg::p_instance = 0;
 
-void OmniFEMMsg::MsgFatal(std::string message)
+void OmniFEMMsg::displayMessage(wxString message)
 {
+#ifdef OMNIFEM_HEADLESS
+	// The messages of all of the threads go to the standard output. The lock keeps the lines of two threads apart
+	std::lock_guard<std::mutex> lock(p_queueMutex);
+	
+	std::cout << message.ToStdString() << std::endl;
+#else
+	if(!wxIsMainThread())
+	{
+		std::lock_guard<std::mutex> lock(p_queueMutex);
+		p_queuedMessages.push_back(message);
+		return;
+	}
+	
+	// Any messages from the other threads were sent before this one
+	flushMessages();
+	
 	for(int i = 0; i < instance()->getStatusWindows().size(); i++)
 	{
 		statusWindow *test = instance()->getStatusWindows()[i];
 		if(test->getDisplayState())
 		{
-			test->outputMessage(wxString("Fatal Error: ") + wxString(message));
+			test->outputMessage(message);
 		}
 	}
-	
-	// Then log the message if needed
+#endif
 }
 
 
 
-void OmniFEMMsg::wxMsgFatal(wxString message)
+void OmniFEMMsg::flushMessages()
 {
-	for(int i = 0; i < instance()->getStatusWindows().size(); i++)
+#ifndef OMNIFEM_HEADLESS
+	std::vector<wxString> queuedMessages;
+	
 	{
-		statusWindow *test = instance()->getStatusWindows()[i];
-		if(test->getDisplayState())
+		std::lock_guard<std::mutex> lock(p_queueMutex);
+		queuedMessages.swap(p_queuedMessages);
+	}
+	
+	for(std::vector<wxString>::iterator messageIterator = queuedMessages.begin(); messageIterator != queuedMessages.end(); ++messageIterator)
+	{
+		for(int i = 0; i < instance()->getStatusWindows().size(); i++)
 		{
-			test->outputMessage(wxString("Fatal Error: ") + message);
+			statusWindow *test = instance()->getStatusWindows()[i];
+			if(test->getDisplayState())
+			{
+				test->outputMessage(*messageIterator);
+			}
 		}
 	}
+#endif
+}
+
+
+void OmniFEMMsg::MsgFatal(std::string message)
+{
+	displayMessage(wxString("Fatal Error: ") + wxString(message));
+	
+	// Then log the message if needed
+}
+
+
+
+void OmniFEMMsg::wxMsgFatal(wxString message)
+{
+	displayMessage(wxString("Fatal Error: ") + message);
 	
 	// Then log the message if needed
 }
@@ -36,14 +78,7 @@ void OmniFEMMsg::wxMsgFatal(wxString message)
 
 void OmniFEMMsg::MsgError(std::string message)
 {
-	for(int i = 0; i < instance()->getStatusWindows().size(); i++)
-	{
-		statusWindow *test = instance()->getStatusWindows()[i];
-		if(test->getDisplayState())
-		{
-			test->outputMessage(wxString("Error: ") + wxString(message));
-		}
-	}
+	displayMessage(wxString("Error: ") + wxString(message));
 	
 	// Then log the message if needed
 }
@@ -53,14 +88,7 @@ void OmniFEMMsg::MsgError(std::string message)
 
 void OmniFEMMsg::wxMsgError(wxString message)
 {
-	for(int i = 0; i < instance()->getStatusWindows().size(); i++)
-	{
-		statusWindow *test = instance()->getStatusWindows()[i];
-		if(test->getDisplayState())
-		{
-			test->outputMessage(wxString("Error: ") + message);
-		}
-	}
+	displayMessage(wxString("Error: ") + message);
 	
 	// Then log the message if needed
 }
@@ -69,14 +97,7 @@ void OmniFEMMsg::wxMsgError(wxString message)
 
 void OmniFEMMsg::MsgWarning(std::string message)
 {
-	for(int i = 0; i < instance()->getStatusWindows().size(); i++)
-	{
-		statusWindow *test = instance()->getStatusWindows()[i];
-		if(test->getDisplayState())
-		{
-			test->outputMessage(wxString("Warning: ") + wxString(message));
-		}
-	}
+	displayMessage(wxString("Warning: ") + wxString(message));
 	
 	// Then log the message if needed
 }
@@ -85,14 +106,7 @@ void OmniFEMMsg::MsgWarning(std::string message)
 
 void OmniFEMMsg::wxMsgWarning(wxString message)
 {
-	for(int i = 0; i < instance()->getStatusWindows().size(); i++)
-	{
-		statusWindow *test = instance()->getStatusWindows()[i];
-		if(test->getDisplayState())
-		{
-			test->outputMessage(wxString("Warning: ") + message);
-		}
-	}
+	displayMessage(wxString("Warning: ") + message);
 	
 	// Then log the message if needed
 }
@@ -101,14 +115,7 @@ void OmniFEMMsg::wxMsgWarning(wxString message)
 
 void OmniFEMMsg::MsgInfo(std::string message)
 {
-	for(int i = 0; i < instance()->getStatusWindows().size(); i++)
-	{
-		statusWindow *test = instance()->getStatusWindows()[i];
-		if(test->getDisplayState())
-		{
-			test->outputMessage(wxString("Info: ") + wxString(message));
-		}
-	}
+	displayMessage(wxString("Info: ") + wxString(message));
 	
 	// Then log the message if needed
 }
@@ -117,14 +124,7 @@ void OmniFEMMsg::MsgInfo(std::string message)
 
 void OmniFEMMsg::wxMsgInfo(wxString message)
 {
-	for(int i = 0; i < instance()->getStatusWindows().size(); i++)
-	{
-		statusWindow *test = instance()->getStatusWindows()[i];
-		if(test->getDisplayState())
-		{
-			test->outputMessage(wxString("Info: ") + message);
-		}
-	}
+	displayMessage(wxString("Info: ") + message);
 	
 	// Then log the message if needed
 }
@@ -134,14 +134,8 @@ void OmniFEMMsg::wxMsgInfo(wxString message)
 void OmniFEMMsg::MsgStatus(std::string message)
 {
 	wxString finalMessage = wxString("Status: ") + wxString(message);
-	for(int i = 0; i < instance()->getStatusWindows().size(); i++)
-	{
-		statusWindow *test = instance()->getStatusWindows()[i];
-		if(test->getDisplayState())
-		{
-			test->outputMessage(finalMessage);
-		}
-	}
+	
+	displayMessage(finalMessage);
 	
 	if(getLoggedState())
 	{
@@ -155,14 +149,7 @@ void OmniFEMMsg::MsgStatus(std::string message)
 
 void OmniFEMMsg::wxMsgStatus(wxString message)
 {
-	for(int i = 0; i < instance()->getStatusWindows().size(); i++)
-	{
-		statusWindow *test = instance()->getStatusWindows()[i];
-		if(test->getDisplayState())
-		{
-			test->outputMessage(wxString("Status: ") + message);
-		}
-	}
+	displayMessage(wxString("Status: ") + message);
 	
 	// Then log the message if needed
 }
\ No newline at end of file
@@ -39,6 +39,9 @@ void preferencesDialog::createDialog()
     wxBoxSizer *solverPreSizer = new wxBoxSizer(wxHORIZONTAL);
     wxBoxSizer *minAngleSizer = new wxBoxSizer(wxHORIZONTAL);
     wxBoxSizer *acSolverSizer = new wxBoxSizer(wxHORIZONTAL);
+    wxBoxSizer *transientPeriodsSizer = new wxBoxSizer(wxHORIZONTAL);
+    wxBoxSizer *transientStepsSizer = new wxBoxSizer(wxHORIZONTAL);
+    wxStaticBoxSizer *transientSizer = NULL;
     wxBoxSizer *topSizer = new wxBoxSizer(wxVERTICAL);
     wxBoxSizer *footerSizer = new wxBoxSizer(wxHORIZONTAL);
     
@@ -96,6 +99,48 @@ void preferencesDialog::createDialog()
         freqSizer->Add(freqText, 0, wxCENTER | wxBOTTOM | wxLEFT, 6);
         freqSizer->Add(11, 0, 0);
         freqSizer->Add(_frequencyTextCtrl, 0, wxCENTER | wxBOTTOM | wxRIGHT, 6);
+        
+        wxIntegerValidator<unsigned int> transientValidator;
+        transientValidator.SetMin(1);
+        
+        transientSizer = new wxStaticBoxSizer(wxVERTICAL, this, "Transient");
+        transientSizer->GetStaticBox()->SetFont(*font);
+        
+        _transientCheckBox->Create(transientSizer->GetStaticBox(), generalFrameButton::ID_CHECKBOX1, "Hysteresis (Jiles-Atherton)");
+        _transientCheckBox->SetFont(*font);
+        _transientCheckBox->SetValue(_magPreference.isTransient());
+        
+        wxStaticText *periodsText = new wxStaticText(transientSizer->GetStaticBox(), wxID_ANY, "Periods:");
+        periodsText->SetFont(*font);
+        _transientPeriodsTextCtrl->Create(transientSizer->GetStaticBox(), wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize(80, 20), 0, transientValidator);
+        _transientPeriodsTextCtrl->SetFont(*font);
+        std::ostream periodsStream(_transientPeriodsTextCtrl);
+        periodsStream << _magPreference.getTransientPeriods();
+        transientPeriodsSizer->Add(periodsText, 0, wxCENTER | wxBOTTOM | wxLEFT, 6);
+        transientPeriodsSizer->Add(54, 0, 0);
+        transientPeriodsSizer->Add(_transientPeriodsTextCtrl, 0, wxCENTER | wxBOTTOM | wxRIGHT, 6);
+        
+        wxStaticText *stepsText = new wxStaticText(transientSizer->GetStaticBox(), wxID_ANY, "Steps per Period:");
+        stepsText->SetFont(*font);
+        _transientStepsTextCtrl->Create(transientSizer->GetStaticBox(), wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize(80, 20), 0, transientValidator);
+        _transientStepsTextCtrl->SetFont(*font);
+        std::ostream stepsStream(_transientStepsTextCtrl);
+        stepsStream << _magPreference.getTransientStepsPerPeriod();
+        transientStepsSizer->Add(stepsText, 0, wxCENTER | wxBOTTOM | wxLEFT, 6);
+        transientStepsSizer->Add(6, 0, 0);
+        transientStepsSizer->Add(_transientStepsTextCtrl, 0, wxCENTER | wxBOTTOM | wxRIGHT, 6);
+        
+        // The transient solver only reads the X-axis parameters of the Jiles-Atherton model
+        wxStaticText *isotropicText = new wxStaticText(transientSizer->GetStaticBox(), wxID_ANY, "The Y-axis Jiles-Atherton parameters are\nignored. Materials are solved as isotropic.");
+        isotropicText->SetFont(*font);
+        
+        transientSizer->Add(_transientCheckBox, 0, wxALL, 6);
+        transientSizer->Add(transientPeriodsSizer);
+        transientSizer->Add(transientStepsSizer);
+        transientSizer->Add(isotropicText, 0, wxLEFT | wxRIGHT | wxBOTTOM, 6);
+        
+        _transientPeriodsTextCtrl->Enable(_magPreference.isTransient());
+        _transientStepsTextCtrl->Enable(_magPreference.isTransient());
     }
    
     wxStaticText *depthText = new wxStaticText(this, wxID_ANY, "Depth:");
@@ -148,6 +193,7 @@ void preferencesDialog::createDialog()
     {
         topSizer->Add(acSolverSizer);
         topSizer->Add(freqSizer);
+        topSizer->Add(transientSizer, 0, wxLEFT | wxRIGHT | wxBOTTOM, 6);
     }
     
     topSizer->Add(depthSizer);
@@ -201,6 +247,13 @@ void preferencesDialog::onComboBox(wxCommandEvent &event)
 }
 
 
+void preferencesDialog::onTransientCheck(wxCommandEvent &event)
+{
+    _transientPeriodsTextCtrl->Enable(_transientCheckBox->GetValue());
+    _transientStepsTextCtrl->Enable(_transientCheckBox->GetValue());
+}
+
+
 void preferencesDialog::getPreferences(magneticPreference &settings)
 {
     double value;
@@ -212,6 +265,16 @@ void preferencesDialog::getPreferences(magneticPreference &settings)
     _frequencyTextCtrl->GetValue().ToDouble(&value);
     settings.setFrequency(value);
     
+    unsigned long steps;
+    
+    settings.setTransient(_transientCheckBox->GetValue());
+    
+    if(_transientPeriodsTextCtrl->GetValue().ToULong(&steps) && steps > 0)
+        settings.setTransientPeriods((unsigned int)steps);
+        
+    if(_transientStepsTextCtrl->GetValue().ToULong(&steps) && steps > 0)
+        settings.setTransientStepsPerPeriod((unsigned int)steps);
+    
     _depthTextCtrl->GetValue().ToDouble(&value);
     settings.setDepth(value);
     
@@ -255,4 +318,5 @@ preferencesDialog::~preferencesDialog()
 
 wxBEGIN_EVENT_TABLE(preferencesDialog, wxDialog)
     EVT_COMBOBOX(generalFrameButton::ID_ComboBox1, preferencesDialog::onComboBox)
+    EVT_CHECKBOX(generalFrameButton::ID_CHECKBOX1, preferencesDialog::onTransientCheck)
 wxEND_EVENT_TABLE()
\ No newline at end of file
@@ -8,6 +8,8 @@
 
 // these are available on all OSes
 #include <string>
+#include <map>
+#include <mutex>
 #include <stdlib.h>
 #include <stdio.h>
 #include <sys/types.h>
@@ -284,6 +286,51 @@ FILE *Fopen(const char *f, const char *mode)
 #endif
 }
 
+// The mesh writers format one number at a time, so the files that they write
+// get a buffer that is large enough to only hit the disk every few hundred
+// lines. The buffers are kept until the file is closed with Fclose
+static const size_t writeBufferSize = 1 << 20;
+static std::map<FILE*, char*> writeBuffers;
+static std::mutex writeBuffersMutex;
+
+FILE *FopenBuffered(const char *f, const char *mode)
+{
+  FILE *fp = Fopen(f, mode);
+  if(!fp || mode[0] == 'r') return fp;
+
+  char *buffer = (char*)malloc(writeBufferSize);
+  if(!buffer) return fp;
+
+  if(setvbuf(fp, buffer, _IOFBF, writeBufferSize)){
+    free(buffer);
+    return fp;
+  }
+
+  std::lock_guard<std::mutex> lock(writeBuffersMutex);
+  writeBuffers[fp] = buffer;
+  return fp;
+}
+
+int Fclose(FILE *fp)
+{
+  char *buffer = 0;
+
+  // The entry is removed while the file is still open since the same pointer
+  // can be handed out again as soon as the file is closed
+  {
+    std::lock_guard<std::mutex> lock(writeBuffersMutex);
+    std::map<FILE*, char*>::iterator it = writeBuffers.find(fp);
+    if(it != writeBuffers.end()){
+      buffer = it->second;
+      writeBuffers.erase(it);
+    }
+  }
+
+  int status = fclose(fp);
+  free(buffer);
+  return status;
+}
+
 void SetEnvironmentVar(const char *var, const char *val)
 {
 	/*
@@ -0,0 +1,776 @@
+#include <common/ProjectFile.h>
+
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <cstring>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/serialization/vector.hpp>
+
+
+//! The version of the layout that is written
+static const uint32_t projectVersion = 1;
+
+//! The version of the columns of the chunks that are written
+static const uint32_t chunkVersion = 1;
+
+//! The alignment of the chunks and of the columns in the file
+static const uint64_t projectAlignment = 64;
+
+//! The number of values of a column that are collected before they are written
+static const size_t columnBufferSize = 4096;
+
+//! The number of chunks that are written
+static const uint64_t numberOfChunks = 6;
+
+//! The size of one value of each column
+static const size_t nodeColumnSize[NUMBER_OF_NODE_COLUMNS] = {
+	sizeof(double), sizeof(double), sizeof(uint64_t), sizeof(int32_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t)
+};
+
+//! The lines use the first NUMBER_OF_EDGE_COLUMNS sizes
+static const size_t arcColumnSize[NUMBER_OF_ARC_COLUMNS] = {
+	sizeof(double), sizeof(double), sizeof(double), sizeof(double), sizeof(double), sizeof(uint64_t), sizeof(uint64_t),
+	sizeof(int32_t), sizeof(uint32_t), sizeof(uint8_t), sizeof(double), sizeof(uint32_t), sizeof(uint8_t), sizeof(uint32_t),
+	sizeof(uint32_t), sizeof(double), sizeof(double), sizeof(uint8_t), sizeof(uint64_t)
+};
+
+static const size_t labelColumnSize[NUMBER_OF_LABEL_COLUMNS] = {
+	sizeof(double), sizeof(double), sizeof(int32_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(uint8_t), sizeof(double),
+	sizeof(uint32_t), sizeof(uint32_t), sizeof(uint8_t), sizeof(uint8_t), sizeof(double)
+};
+
+
+
+//! The names that the shapes refer to. Each name is stored once
+struct projectStringTable
+{
+	std::unordered_map<std::string, uint32_t> index;
+
+	//! Where each name starts in the characters. This has one more entry than there are names
+	std::vector<uint64_t> offsets = std::vector<uint64_t>(1, 0);
+
+	std::string characters;
+
+	void add(const std::string &name)
+	{
+		if(index.find(name) != index.end())
+			return;
+
+		index[name] = offsets.size() - 1;
+		characters += name;
+		offsets.push_back(characters.size());
+	}
+
+	uint32_t find(const std::string &name) const
+	{
+		return index.find(name)->second;
+	}
+};
+
+
+
+//! Unmaps the project file when the reader returns
+struct projectMapping
+{
+	void *data = nullptr;
+
+	size_t size = 0;
+
+	~projectMapping()
+	{
+		if(data)
+			munmap(data, size);
+	}
+};
+
+
+
+static uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + projectAlignment - 1) / projectAlignment * projectAlignment;
+}
+
+
+
+/**
+ * @brief Finds where the columns of a chunk start. The columns follow one another and each one starts on a 64 byte boundary
+ * @param chunkOffset The offset of the chunk from the start of the file. This needs to be aligned
+ * @param count The number of entries in the chunk
+ * @param columnSize The size of one value of each column
+ * @param numberOfColumns The number of columns
+ * @param columnOffsets Stores the offset of each column from the start of the file
+ * @return Returns the size of the chunk
+ */
+static uint64_t getColumnOffsets(uint64_t chunkOffset, uint64_t count, const size_t *columnSize, int numberOfColumns, std::vector<uint64_t> &columnOffsets)
+{
+	uint64_t offset = chunkOffset;
+
+	columnOffsets.resize(numberOfColumns);
+
+	for(int i = 0; i < numberOfColumns; i++)
+	{
+		columnOffsets[i] = offset;
+		offset = alignOffset(offset + count * columnSize[i]);
+	}
+
+	return offset - chunkOffset;
+}
+
+
+
+//! Fills the file with zeros up to the offset
+static void writePadding(std::ofstream &projectStream, uint64_t offset)
+{
+	const char padding[projectAlignment] = {0};
+	uint64_t position = projectStream.tellp();
+
+	while(position < offset)
+	{
+		const uint64_t size = std::min(offset - position, projectAlignment);
+
+		projectStream.write(padding, size);
+		position += size;
+	}
+}
+
+
+
+/**
+ * @brief Writes one column of a chunk straight from the shapes of a colony
+ * @param projectStream The file that is written
+ * @param offset The offset of the column from the start of the file
+ * @param shapeList The shapes of the chunk
+ * @param getValue Returns the value of the column for a shape
+ */
+template<class T, class shapeType, class valueFunction>
+static void writeColumn(std::ofstream &projectStream, uint64_t offset, plf::colony<shapeType> &shapeList, valueFunction getValue)
+{
+	T buffer[columnBufferSize];
+	size_t numberOfValues = 0;
+
+	writePadding(projectStream, offset);
+
+	for(typename plf::colony<shapeType>::iterator shapeIterator = shapeList.begin(); shapeIterator != shapeList.end(); shapeIterator++)
+	{
+		buffer[numberOfValues++] = (T)getValue(*shapeIterator);
+
+		if(numberOfValues == columnBufferSize)
+		{
+			projectStream.write(reinterpret_cast<const char*>(buffer), numberOfValues * sizeof(T));
+			numberOfValues = 0;
+		}
+	}
+
+	if(numberOfValues > 0)
+		projectStream.write(reinterpret_cast<const char*>(buffer), numberOfValues * sizeof(T));
+}
+
+
+
+//! Writes the columns that the lines and the arcs have in common
+template<class shapeType>
+static void writeEdgeColumns(std::ofstream &projectStream, const std::vector<uint64_t> &columnOffsets, plf::colony<shapeType> &edgeList, const projectStringTable &names)
+{
+	writeColumn<double>(projectStream, columnOffsets[EDGE_X], edgeList, [](edgeLineShape &edge) { return edge.getCenterXCoordinate(); });
+	writeColumn<double>(projectStream, columnOffsets[EDGE_Y], edgeList, [](edgeLineShape &edge) { return edge.getCenterYCoordinate(); });
+	writeColumn<double>(projectStream, columnOffsets[EDGE_DISTANCE], edgeList, [](edgeLineShape &edge) { return edge.getDistance(); });
+	writeColumn<double>(projectStream, columnOffsets[EDGE_X_MID], edgeList, [](edgeLineShape &edge) { return edge.getMidPoint().x; });
+	writeColumn<double>(projectStream, columnOffsets[EDGE_Y_MID], edgeList, [](edgeLineShape &edge) { return edge.getMidPoint().y; });
+	writeColumn<uint64_t>(projectStream, columnOffsets[EDGE_FIRST_NODE], edgeList, [](edgeLineShape &edge) { return edge.getFirstNodeID(); });
+	writeColumn<uint64_t>(projectStream, columnOffsets[EDGE_SECOND_NODE], edgeList, [](edgeLineShape &edge) { return edge.getSecondNodeID(); });
+	writeColumn<int32_t>(projectStream, columnOffsets[EDGE_PROBLEM], edgeList, [](edgeLineShape &edge) { return (int32_t)edge.getSegmentProperty()->getPhysicsProblem(); });
+	writeColumn<uint32_t>(projectStream, columnOffsets[EDGE_BOUNDARY], edgeList, [&names](edgeLineShape &edge) { return names.find(edge.getSegmentProperty()->getBoundaryName()); });
+	writeColumn<uint8_t>(projectStream, columnOffsets[EDGE_MESH_AUTO], edgeList, [](edgeLineShape &edge) { return edge.getSegmentProperty()->getMeshAutoState(); });
+	writeColumn<double>(projectStream, columnOffsets[EDGE_ELEMENT_SIZE], edgeList, [](edgeLineShape &edge) { return edge.getSegmentProperty()->getElementSizeAlongLine(); });
+	writeColumn<uint32_t>(projectStream, columnOffsets[EDGE_CONDUCTOR], edgeList, [&names](edgeLineShape &edge) { return names.find(edge.getSegmentProperty()->getConductorName()); });
+	writeColumn<uint8_t>(projectStream, columnOffsets[EDGE_HIDDEN], edgeList, [](edgeLineShape &edge) { return edge.getSegmentProperty()->getHiddenState(); });
+	writeColumn<uint32_t>(projectStream, columnOffsets[EDGE_GROUP], edgeList, [](edgeLineShape &edge) { return edge.getSegmentProperty()->getGroupNumber(); });
+}
+
+
+
+/**
+ * @brief Checks that a chunk of the mapped file holds all of the known columns
+ * @param chunk The entry of the chunk in the table
+ * @param columnSize The size of one value of each known column
+ * @param numberOfColumns The number of known columns
+ * @param columnOffsets Stores the offset of each column from the start of the file
+ * @return Returns true if the columns are inside of the chunk
+ */
+static bool getChunkColumns(const projectFileChunk &chunk, const size_t *columnSize, int numberOfColumns, std::vector<uint64_t> &columnOffsets)
+{
+	// The count is limited so that the size of the columns can not overflow
+	if(chunk.count > UINT32_MAX)
+		return false;
+
+	return getColumnOffsets(chunk.offset, chunk.count, columnSize, numberOfColumns, columnOffsets) <= chunk.size;
+}
+
+
+
+template<class T>
+static const T *getColumn(const projectMapping &mapping, const std::vector<uint64_t> &columnOffsets, int column)
+{
+	return reinterpret_cast<const T*>(static_cast<const char*>(mapping.data) + columnOffsets[column]);
+}
+
+
+
+bool projectFile::isBinary(std::string filePath)
+{
+	std::ifstream projectStream(filePath, std::ios::binary);
+	char magic[8];
+
+	if(!projectStream.read(magic, sizeof(magic)))
+		return false;
+
+	return memcmp(magic, "OFEMPROJ", 8) == 0;
+}
+
+
+
+bool projectFile::write(std::string filePath, problemDefinition &definition, gridPreferences &preferences, geometryEditor2D &editor, std::vector<double> &view)
+{
+	std::ostringstream settingsStream;
+	projectStringTable names;
+	projectFileHeader header;
+	projectFileChunk chunks[numberOfChunks];
+	std::vector<uint64_t> nodeOffsets, lineOffsets, arcOffsets, labelOffsets;
+	uint64_t stringCharactersOffset = 0;
+
+	{
+		boost::archive::text_oarchive oa(settingsStream);
+		oa << definition;
+		oa << preferences;
+		oa << view;
+	}
+
+	const std::string settings = settingsStream.str();
+
+	for(plf::colony<node>::iterator nodeIterator = editor._nodeList.begin(); nodeIterator != editor._nodeList.end(); nodeIterator++)
+	{
+		names.add(nodeIterator->getNodeSetting()->getNodalPropertyName());
+		names.add(nodeIterator->getNodeSetting()->getConductorPropertyName());
+	}
+
+	for(plf::colony<edgeLineShape>::iterator lineIterator = editor._lineList.begin(); lineIterator != editor._lineList.end(); lineIterator++)
+	{
+		names.add(lineIterator->getSegmentProperty()->getBoundaryName());
+		names.add(lineIterator->getSegmentProperty()->getConductorName());
+	}
+
+	for(plf::colony<arcShape>::iterator arcIterator = editor._arcList.begin(); arcIterator != editor._arcList.end(); arcIterator++)
+	{
+		names.add(arcIterator->getSegmentProperty()->getBoundaryName());
+		names.add(arcIterator->getSegmentProperty()->getConductorName());
+	}
+
+	for(plf::colony<blockLabel>::iterator labelIterator = editor._blockLabelList.begin(); labelIterator != editor._blockLabelList.end(); labelIterator++)
+	{
+		names.add(labelIterator->getProperty()->getMaterialName());
+		names.add(labelIterator->getProperty()->getCircuitName());
+		names.add(labelIterator->getProperty()->getMagnetization().ToStdString());
+	}
+
+	memset(&header, 0, sizeof(header));
+	memset(chunks, 0, sizeof(chunks));
+	memcpy(header.magic, "OFEMPROJ", 8);
+	header.version = projectVersion;
+	header.byteOrder = 0x01020304;
+	header.numberOfChunks = numberOfChunks;
+
+	const uint32_t chunkType[numberOfChunks] = {CHUNK_SETTINGS, CHUNK_STRINGS, CHUNK_NODES, CHUNK_LINES, CHUNK_ARCS, CHUNK_LABELS};
+	const uint64_t chunkCount[numberOfChunks] = {settings.size(), names.offsets.size() - 1, editor._nodeList.size(), editor._lineList.size(), editor._arcList.size(), editor._blockLabelList.size()};
+	uint64_t offset = alignOffset(sizeof(header) + sizeof(chunks));
+
+	for(uint64_t i = 0; i < numberOfChunks; i++)
+	{
+		chunks[i].type = chunkType[i];
+		chunks[i].version = chunkVersion;
+		chunks[i].count = chunkCount[i];
+		chunks[i].offset = offset;
+
+		switch(chunkType[i])
+		{
+			case CHUNK_SETTINGS:
+				chunks[i].size = settings.size();
+				break;
+			case CHUNK_STRINGS:
+				stringCharactersOffset = alignOffset(offset + names.offsets.size() * sizeof(uint64_t));
+				chunks[i].size = stringCharactersOffset + names.characters.size() - offset;
+				break;
+			case CHUNK_NODES:
+				chunks[i].size = getColumnOffsets(offset, chunkCount[i], nodeColumnSize, NUMBER_OF_NODE_COLUMNS, nodeOffsets);
+				break;
+			case CHUNK_LINES:
+				chunks[i].size = getColumnOffsets(offset, chunkCount[i], arcColumnSize, NUMBER_OF_EDGE_COLUMNS, lineOffsets);
+				break;
+			case CHUNK_ARCS:
+				chunks[i].size = getColumnOffsets(offset, chunkCount[i], arcColumnSize, NUMBER_OF_ARC_COLUMNS, arcOffsets);
+				break;
+			case CHUNK_LABELS:
+				chunks[i].size = getColumnOffsets(offset, chunkCount[i], labelColumnSize, NUMBER_OF_LABEL_COLUMNS, labelOffsets);
+				break;
+		}
+
+		offset = alignOffset(offset + chunks[i].size);
+	}
+
+	// The project is written under a different name so that the old project is kept if the new one can not be written
+	const std::string temporaryPath = filePath + ".tmp";
+	std::ofstream projectStream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+	if(!projectStream.is_open())
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to write the project " + filePath);
+		return false;
+	}
+
+	projectStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	projectStream.write(reinterpret_cast<const char*>(chunks), sizeof(chunks));
+
+	writePadding(projectStream, chunks[0].offset);
+	projectStream.write(settings.data(), settings.size());
+
+	writePadding(projectStream, chunks[1].offset);
+	projectStream.write(reinterpret_cast<const char*>(&names.offsets[0]), names.offsets.size() * sizeof(uint64_t));
+	writePadding(projectStream, stringCharactersOffset);
+	projectStream.write(names.characters.data(), names.characters.size());
+
+	writeColumn<double>(projectStream, nodeOffsets[NODE_X], editor._nodeList, [](node &shape) { return shape.getCenterXCoordinate(); });
+	writeColumn<double>(projectStream, nodeOffsets[NODE_Y], editor._nodeList, [](node &shape) { return shape.getCenterYCoordinate(); });
+	writeColumn<uint64_t>(projectStream, nodeOffsets[NODE_ID], editor._nodeList, [](node &shape) { return shape.getNodeID(); });
+	writeColumn<int32_t>(projectStream, nodeOffsets[NODE_PROBLEM], editor._nodeList, [](node &shape) { return (int32_t)shape.getNodeSetting()->getPhysicsProblem(); });
+	writeColumn<uint32_t>(projectStream, nodeOffsets[NODE_NODAL_PROPERTY], editor._nodeList, [&names](node &shape) { return names.find(shape.getNodeSetting()->getNodalPropertyName()); });
+	writeColumn<uint32_t>(projectStream, nodeOffsets[NODE_CONDUCTOR], editor._nodeList, [&names](node &shape) { return names.find(shape.getNodeSetting()->getConductorPropertyName()); });
+	writeColumn<uint32_t>(projectStream, nodeOffsets[NODE_GROUP], editor._nodeList, [](node &shape) { return shape.getNodeSetting()->getGroupNumber(); });
+
+	writeEdgeColumns(projectStream, lineOffsets, editor._lineList, names);
+
+	writeEdgeColumns(projectStream, arcOffsets, editor._arcList, names);
+	writeColumn<uint32_t>(projectStream, arcOffsets[ARC_NUMBER_OF_SEGMENTS], editor._arcList, [](arcShape &arc) { return arc._numSegments; });
+	writeColumn<double>(projectStream, arcOffsets[ARC_ANGLE], editor._arcList, [](arcShape &arc) { return arc._arcAngle; });
+	writeColumn<double>(projectStream, arcOffsets[ARC_RADIUS], editor._arcList, [](arcShape &arc) { return arc._radius; });
+	writeColumn<uint8_t>(projectStream, arcOffsets[ARC_COUNTER_CLOCKWISE], editor._arcList, [](arcShape &arc) { return arc._isCounterClockWise; });
+	writeColumn<uint64_t>(projectStream, arcOffsets[ARC_ID], editor._arcList, [](arcShape &arc) { return arc.p_arcID; });
+
+	writeColumn<double>(projectStream, labelOffsets[LABEL_X], editor._blockLabelList, [](blockLabel &label) { return label.getCenterXCoordinate(); });
+	writeColumn<double>(projectStream, labelOffsets[LABEL_Y], editor._blockLabelList, [](blockLabel &label) { return label.getCenterYCoordinate(); });
+	writeColumn<int32_t>(projectStream, labelOffsets[LABEL_MESH_SIZE_TYPE], editor._blockLabelList, [](blockLabel &label) { return (int32_t)label.getProperty()->getMeshsizeType(); });
+	writeColumn<uint32_t>(projectStream, labelOffsets[LABEL_MATERIAL], editor._blockLabelList, [&names](blockLabel &label) { return names.find(label.getProperty()->getMaterialName()); });
+	writeColumn<uint32_t>(projectStream, labelOffsets[LABEL_CIRCUIT], editor._blockLabelList, [&names](blockLabel &label) { return names.find(label.getProperty()->getCircuitName()); });
+	writeColumn<uint8_t>(projectStream, labelOffsets[LABEL_MESH_AUTO], editor._blockLabelList, [](blockLabel &label) { return label.getProperty()->getAutoMeshState(); });
+	writeColumn<double>(projectStream, labelOffsets[LABEL_TURNS], editor._blockLabelList, [](blockLabel &label) { return label.getProperty()->getNumberOfTurns(); });
+	writeColumn<uint32_t>(projectStream, labelOffsets[LABEL_MAGNETIZATION], editor._blockLabelList, [&names](blockLabel &label) { return names.find(label.getProperty()->getMagnetization().ToStdString()); });
+	writeColumn<uint32_t>(projectStream, labelOffsets[LABEL_GROUP], editor._blockLabelList, [](blockLabel &label) { return label.getProperty()->getGroupNumber(); });
+	writeColumn<uint8_t>(projectStream, labelOffsets[LABEL_EXTERNAL], editor._blockLabelList, [](blockLabel &label) { return label.getProperty()->getIsExternalState(); });
+	writeColumn<uint8_t>(projectStream, labelOffsets[LABEL_DEFAULT], editor._blockLabelList, [](blockLabel &label) { return label.getProperty()->getDefaultState(); });
+	writeColumn<double>(projectStream, labelOffsets[LABEL_MESH_SIZE], editor._blockLabelList, [](blockLabel &label) { return label.getProperty()->getMeshSize(); });
+
+	// The file is padded to the end of the last chunk so that every column is inside of the file
+	writePadding(projectStream, offset);
+	projectStream.close();
+
+	if(!projectStream || std::rename(temporaryPath.c_str(), filePath.c_str()) != 0)
+	{
+		std::remove(temporaryPath.c_str());
+		OmniFEMMsg::instance()->MsgError("Unable to write the project " + filePath);
+		return false;
+	}
+
+	return true;
+}
+
+
+
+bool projectFile::readTextArchive(std::string filePath, problemDefinition &definition, gridPreferences &preferences, geometryEditor2D &editor, std::vector<double> &view)
+{
+	std::ifstream projectStream(filePath);
+
+	if(!projectStream.is_open())
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to open " + filePath);
+		return false;
+	}
+
+	try
+	{
+		boost::archive::text_iarchive ia(projectStream);
+
+		ia >> definition;
+		ia >> preferences;
+		ia >> editor;
+		ia >> view;
+	}
+	catch(std::exception &error)
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to read " + filePath + ": " + error.what());
+		return false;
+	}
+
+	editor.rebuildDataStructure();
+
+	return true;
+}
+
+
+
+bool projectFile::readBinary(std::string filePath, problemDefinition &definition, gridPreferences &preferences, geometryEditor2D &editor, std::vector<double> &view)
+{
+	projectMapping mapping;
+	struct stat fileStatus;
+	int fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+
+	if(fileDescriptor < 0)
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to open " + filePath);
+		return false;
+	}
+
+	if(fstat(fileDescriptor, &fileStatus) != 0 || (size_t)fileStatus.st_size < sizeof(projectFileHeader))
+	{
+		::close(fileDescriptor);
+		OmniFEMMsg::instance()->MsgError(filePath + " is not a valid project");
+		return false;
+	}
+
+	void *data = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+	// The mapping stays valid after the file is closed
+	::close(fileDescriptor);
+
+	if(data == MAP_FAILED)
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to map " + filePath);
+		return false;
+	}
+
+	mapping.data = data;
+	mapping.size = fileStatus.st_size;
+
+	const char *fileStart = static_cast<const char*>(mapping.data);
+	const projectFileHeader *header = reinterpret_cast<const projectFileHeader*>(fileStart);
+
+	if(memcmp(header->magic, "OFEMPROJ", 8) != 0 || header->byteOrder != 0x01020304)
+	{
+		OmniFEMMsg::instance()->MsgError(filePath + " is not a valid project or was written on a machine with a different byte order");
+		return false;
+	}
+
+	if(header->version > projectVersion)
+	{
+		OmniFEMMsg::instance()->MsgError(filePath + " was saved by a newer version of Omni-FEM");
+		return false;
+	}
+
+	if(header->numberOfChunks > (mapping.size - sizeof(projectFileHeader)) / sizeof(projectFileChunk))
+	{
+		OmniFEMMsg::instance()->MsgError(filePath + " is not a valid project");
+		return false;
+	}
+
+	const projectFileChunk *chunks = reinterpret_cast<const projectFileChunk*>(fileStart + sizeof(projectFileHeader));
+	const projectFileChunk *knownChunks[CHUNK_LABELS + 1] = {nullptr};
+	std::vector<uint64_t> stringOffsets, nodeOffsets, lineOffsets, arcOffsets, labelOffsets;
+	std::vector<std::string> names;
+	bool isValid = true;
+
+	for(uint64_t i = 0; i < header->numberOfChunks; i++)
+	{
+		if(chunks[i].offset % projectAlignment != 0 || chunks[i].offset > mapping.size || chunks[i].size > mapping.size - chunks[i].offset)
+			isValid = false;
+		else if(chunks[i].type >= CHUNK_SETTINGS && chunks[i].type <= CHUNK_LABELS)
+			knownChunks[chunks[i].type] = &chunks[i];
+	}
+
+	// The chunks of the geometry may be missing if they are empty but the settings are always there
+	if(!isValid || !knownChunks[CHUNK_SETTINGS] || knownChunks[CHUNK_SETTINGS]->count > knownChunks[CHUNK_SETTINGS]->size)
+	{
+		OmniFEMMsg::instance()->MsgError(filePath + " is not a valid project");
+		return false;
+	}
+
+	if(knownChunks[CHUNK_STRINGS])
+	{
+		const projectFileChunk &chunk = *knownChunks[CHUNK_STRINGS];
+		const size_t offsetSize = sizeof(uint64_t);
+
+		if(chunk.count > UINT32_MAX || alignOffset((chunk.count + 1) * offsetSize) > chunk.size)
+			isValid = false;
+		else
+		{
+			const uint64_t *characterOffsets = reinterpret_cast<const uint64_t*>(fileStart + chunk.offset);
+			const uint64_t charactersStart = chunk.offset + alignOffset((chunk.count + 1) * offsetSize);
+			const uint64_t numberOfCharacters = chunk.offset + chunk.size - charactersStart;
+
+			names.reserve(chunk.count);
+
+			for(uint64_t i = 0; i < chunk.count && isValid; i++)
+			{
+				if(characterOffsets[i] > characterOffsets[i + 1] || characterOffsets[i + 1] > numberOfCharacters)
+					isValid = false;
+				else
+					names.push_back(std::string(fileStart + charactersStart + characterOffsets[i], characterOffsets[i + 1] - characterOffsets[i]));
+			}
+		}
+	}
+
+	if(knownChunks[CHUNK_NODES] && !getChunkColumns(*knownChunks[CHUNK_NODES], nodeColumnSize, NUMBER_OF_NODE_COLUMNS, nodeOffsets))
+		isValid = false;
+
+	if(knownChunks[CHUNK_LINES] && !getChunkColumns(*knownChunks[CHUNK_LINES], arcColumnSize, NUMBER_OF_EDGE_COLUMNS, lineOffsets))
+		isValid = false;
+
+	if(knownChunks[CHUNK_ARCS] && !getChunkColumns(*knownChunks[CHUNK_ARCS], arcColumnSize, NUMBER_OF_ARC_COLUMNS, arcOffsets))
+		isValid = false;
+
+	if(knownChunks[CHUNK_LABELS] && !getChunkColumns(*knownChunks[CHUNK_LABELS], labelColumnSize, NUMBER_OF_LABEL_COLUMNS, labelOffsets))
+		isValid = false;
+
+	if(!isValid)
+	{
+		OmniFEMMsg::instance()->MsgError(filePath + " is not a valid project");
+		return false;
+	}
+
+	try
+	{
+		std::istringstream settingsStream(std::string(fileStart + knownChunks[CHUNK_SETTINGS]->offset, knownChunks[CHUNK_SETTINGS]->count));
+		boost::archive::text_iarchive ia(settingsStream);
+
+		ia >> definition;
+		ia >> preferences;
+		ia >> view;
+	}
+	catch(std::exception &error)
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to read the settings of " + filePath + ": " + error.what());
+		return false;
+	}
+
+	// The names are looked up through this so that an index outside of the table is found before a shape is added
+	const size_t numberOfNames = names.size();
+	std::unordered_map<unsigned long, node*> nodeTable;
+
+	if(knownChunks[CHUNK_NODES])
+	{
+		const uint64_t numberOfNodes = knownChunks[CHUNK_NODES]->count;
+		const double *x = getColumn<double>(mapping, nodeOffsets, NODE_X);
+		const double *y = getColumn<double>(mapping, nodeOffsets, NODE_Y);
+		const uint64_t *id = getColumn<uint64_t>(mapping, nodeOffsets, NODE_ID);
+		const int32_t *problem = getColumn<int32_t>(mapping, nodeOffsets, NODE_PROBLEM);
+		const uint32_t *nodalProperty = getColumn<uint32_t>(mapping, nodeOffsets, NODE_NODAL_PROPERTY);
+		const uint32_t *conductor = getColumn<uint32_t>(mapping, nodeOffsets, NODE_CONDUCTOR);
+		const uint32_t *group = getColumn<uint32_t>(mapping, nodeOffsets, NODE_GROUP);
+
+		nodeTable.reserve(numberOfNodes);
+
+		for(uint64_t i = 0; i < numberOfNodes; i++)
+		{
+			node newNode(x[i], y[i]);
+			nodeSetting setting;
+
+			if(nodalProperty[i] >= numberOfNames || conductor[i] >= numberOfNames)
+			{
+				isValid = false;
+				break;
+			}
+
+			setting.setPhysicsProblem((physicProblems)problem[i]);
+			setting.setNodalPropertyName(names[nodalProperty[i]]);
+			setting.setConductorPropertyName(names[conductor[i]]);
+			setting.setGroupNumber(group[i]);
+
+			newNode.setNodeID(id[i]);
+			newNode.setNodeSettings(setting);
+
+			nodeTable[id[i]] = &(*editor._nodeList.insert(newNode));
+
+			if(id[i] > editor._nodeNumber)
+				editor._nodeNumber = id[i];
+		}
+	}
+
+	if(isValid && knownChunks[CHUNK_LINES])
+	{
+		std::vector<const char*> columns(NUMBER_OF_EDGE_COLUMNS);
+
+		for(int i = 0; i < NUMBER_OF_EDGE_COLUMNS; i++)
+			columns[i] = fileStart + lineOffsets[i];
+
+		for(uint64_t i = 0; i < knownChunks[CHUNK_LINES]->count && isValid; i++)
+		{
+			edgeLineShape newLine;
+
+			isValid = setEdgeFields(newLine, columns, i, names, nodeTable);
+
+			if(isValid)
+				editor._lineList.insert(newLine);
+		}
+	}
+
+	if(isValid && knownChunks[CHUNK_ARCS])
+	{
+		std::vector<const char*> columns(NUMBER_OF_ARC_COLUMNS);
+
+		for(int i = 0; i < NUMBER_OF_ARC_COLUMNS; i++)
+			columns[i] = fileStart + arcOffsets[i];
+
+		const uint32_t *numberOfSegments = reinterpret_cast<const uint32_t*>(columns[ARC_NUMBER_OF_SEGMENTS]);
+		const double *angle = reinterpret_cast<const double*>(columns[ARC_ANGLE]);
+		const double *radius = reinterpret_cast<const double*>(columns[ARC_RADIUS]);
+		const uint8_t *isCounterClockWise = reinterpret_cast<const uint8_t*>(columns[ARC_COUNTER_CLOCKWISE]);
+		const uint64_t *arcID = reinterpret_cast<const uint64_t*>(columns[ARC_ID]);
+
+		for(uint64_t i = 0; i < knownChunks[CHUNK_ARCS]->count && isValid; i++)
+		{
+			arcShape newArc;
+
+			isValid = setEdgeFields(newArc, columns, i, names, nodeTable);
+
+			if(isValid)
+			{
+				newArc._numSegments = numberOfSegments[i];
+				newArc._arcAngle = angle[i];
+				newArc._radius = radius[i];
+				newArc._isCounterClockWise = (isCounterClockWise[i] != 0);
+				newArc.p_arcID = arcID[i];
+
+				editor._arcList.insert(newArc);
+
+				if(arcID[i] > editor.p_arcNumber)
+					editor.p_arcNumber = arcID[i];
+			}
+		}
+	}
+
+	if(isValid && knownChunks[CHUNK_LABELS])
+	{
+		const double *x = getColumn<double>(mapping, labelOffsets, LABEL_X);
+		const double *y = getColumn<double>(mapping, labelOffsets, LABEL_Y);
+		const int32_t *meshSizeType = getColumn<int32_t>(mapping, labelOffsets, LABEL_MESH_SIZE_TYPE);
+		const uint32_t *material = getColumn<uint32_t>(mapping, labelOffsets, LABEL_MATERIAL);
+		const uint32_t *circuit = getColumn<uint32_t>(mapping, labelOffsets, LABEL_CIRCUIT);
+		const uint8_t *meshAuto = getColumn<uint8_t>(mapping, labelOffsets, LABEL_MESH_AUTO);
+		const double *turns = getColumn<double>(mapping, labelOffsets, LABEL_TURNS);
+		const uint32_t *magnetization = getColumn<uint32_t>(mapping, labelOffsets, LABEL_MAGNETIZATION);
+		const uint32_t *group = getColumn<uint32_t>(mapping, labelOffsets, LABEL_GROUP);
+		const uint8_t *isExternal = getColumn<uint8_t>(mapping, labelOffsets, LABEL_EXTERNAL);
+		const uint8_t *isDefault = getColumn<uint8_t>(mapping, labelOffsets, LABEL_DEFAULT);
+		const double *labelMeshSize = getColumn<double>(mapping, labelOffsets, LABEL_MESH_SIZE);
+
+		for(uint64_t i = 0; i < knownChunks[CHUNK_LABELS]->count; i++)
+		{
+			blockLabel newLabel;
+			blockProperty property;
+
+			if(material[i] >= numberOfNames || circuit[i] >= numberOfNames || magnetization[i] >= numberOfNames)
+			{
+				isValid = false;
+				break;
+			}
+
+			property.setMeshSizeType((meshSize)meshSizeType[i]);
+			property.setMaterialName(names[material[i]]);
+			property.setCircuitName(names[circuit[i]]);
+			property.setAutoMeshState(meshAuto[i] != 0);
+			property.setNumberOfTurns(turns[i]);
+			property.setMagnetization(wxString(names[magnetization[i]]));
+			property.setGroupNumber(group[i]);
+			property.setIsExternalState(isExternal[i] != 0);
+			property.setDefaultState(isDefault[i] != 0);
+			property.setMeshSize(labelMeshSize[i]);
+
+			newLabel.setCenter(x[i], y[i]);
+			newLabel.setPorperty(property);
+
+			editor._blockLabelList.insert(newLabel);
+		}
+	}
+
+	if(!isValid)
+	{
+		OmniFEMMsg::instance()->MsgError(filePath + " refers to a name or a node that does not exist");
+		return false;
+	}
+
+	editor._lastArcAdded = editor._arcList.begin();
+	editor._lastBlockLabelAdded = editor._blockLabelList.begin();
+	editor._lastLineAdded = editor._lineList.begin();
+	editor._lastNodeAdded = editor._nodeList.begin();
+	editor.invalidateSpatialIndex();
+
+	return true;
+}
+
+
+
+bool projectFile::setEdgeFields(edgeLineShape &edge, const std::vector<const char*> &columns, uint64_t index, const std::vector<std::string> &names, const std::unordered_map<unsigned long, node*> &nodeTable)
+{
+	const uint64_t firstNodeID = reinterpret_cast<const uint64_t*>(columns[EDGE_FIRST_NODE])[index];
+	const uint64_t secondNodeID = reinterpret_cast<const uint64_t*>(columns[EDGE_SECOND_NODE])[index];
+	const uint32_t boundary = reinterpret_cast<const uint32_t*>(columns[EDGE_BOUNDARY])[index];
+	const uint32_t conductor = reinterpret_cast<const uint32_t*>(columns[EDGE_CONDUCTOR])[index];
+	std::unordered_map<unsigned long, node*>::const_iterator firstNode = nodeTable.find(firstNodeID);
+	std::unordered_map<unsigned long, node*>::const_iterator secondNode = nodeTable.find(secondNodeID);
+	segmentProperty property;
+
+	if(firstNode == nodeTable.end() || secondNode == nodeTable.end() || boundary >= names.size() || conductor >= names.size())
+		return false;
+
+	property.setPhysicsProblem((physicProblems)reinterpret_cast<const int32_t*>(columns[EDGE_PROBLEM])[index]);
+	property.setBoundaryName(names[boundary]);
+	property.setMeshAutoState(reinterpret_cast<const uint8_t*>(columns[EDGE_MESH_AUTO])[index] != 0);
+	property.setElementSizeAlongLine(reinterpret_cast<const double*>(columns[EDGE_ELEMENT_SIZE])[index]);
+	property.setConductorName(names[conductor]);
+	property.setHiddenState(reinterpret_cast<const uint8_t*>(columns[EDGE_HIDDEN])[index] != 0);
+	property.setGroupNumber(reinterpret_cast<const uint32_t*>(columns[EDGE_GROUP])[index]);
+
+	edge.setCenterXCoordinate(reinterpret_cast<const double*>(columns[EDGE_X])[index]);
+	edge.setCenterYCoordiante(reinterpret_cast<const double*>(columns[EDGE_Y])[index]);
+	edge.setSegmentProperty(property);
+	edge.setFirstNode(*firstNode->second);
+	edge.setSecondNode(*secondNode->second);
+	edge.p_distance = reinterpret_cast<const double*>(columns[EDGE_DISTANCE])[index];
+	edge.p_xMid = reinterpret_cast<const double*>(columns[EDGE_X_MID])[index];
+	edge.p_yMid = reinterpret_cast<const double*>(columns[EDGE_Y_MID])[index];
+
+	return true;
+}
+
+
+
+bool projectFile::read(std::string filePath, problemDefinition &definition, gridPreferences &preferences, geometryEditor2D &editor, std::vector<double> &view)
+{
+	if(isBinary(filePath))
+		return readBinary(filePath, definition, preferences, editor, view);
+
+	return readTextArchive(filePath, definition, preferences, editor, view);
+}
+
+
+
+bool projectFile::convert(std::string filePath)
+{
+	problemDefinition definition;
+	gridPreferences preferences;
+	geometryEditor2D editor;
+	std::vector<double> view;
+
+	if(isBinary(filePath))
+		return true;
+
+	if(!readTextArchive(filePath, definition, preferences, editor, view))
+		return false;
+
+	return write(filePath, definition, preferences, editor, view);
+}